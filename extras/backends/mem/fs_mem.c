@@ -29,6 +29,25 @@
 #define FS_MEM_MIN(x, y)                (((x) < (y)) ? (x) : (y))
 #define FS_MEM_OFFSET_PTR(p, offset)    (((fs_uint8*)(p)) + (offset))
 
+/* The number of nodes allocated at a time. */
+#ifndef FS_MEM_NODES_PER_SLAB
+#define FS_MEM_NODES_PER_SLAB           256
+#endif
+
+/* The size of each block that names are allocated from. */
+#ifndef FS_MEM_NAME_BLOCK_SIZE
+#define FS_MEM_NAME_BLOCK_SIZE          65536
+#endif
+
+/* Names are allocated in multiples of this. Names longer than FS_MEM_NAME_CLASS_COUNT times this are allocated on the heap. */
+#define FS_MEM_NAME_GRANULARITY         16
+#define FS_MEM_NAME_CLASS_COUNT         16
+
+/* Directories with more children than this get a hash table for looking up children by name. Smaller directories are searched linearly. */
+#ifndef FS_MEM_CHILD_TABLE_THRESHOLD
+#define FS_MEM_CHILD_TABLE_THRESHOLD    16
+#endif
+
 
 typedef enum fs_mem_node_type
 {
@@ -41,11 +60,16 @@ typedef struct fs_mem_node fs_mem_node;
 
 typedef struct fs_mem_file_data
 {
-    void* pData;                    /* File content. */
+    void* pData;                    /* File content. Only used when chunkSize is 0. */
     size_t size;                    /* Current file size. */
-    size_t capacity;                /* Allocated capacity. */
+    size_t capacity;                /* Allocated capacity. Only used when chunkSize is 0. */
+    void** ppChunks;                /* The chunk table when chunkSize is not 0. NULL chunks have never been written to and read as zeros. */
+    size_t chunkCount;              /* The number of entries in the chunk table. Entries past the end of the file are NULL. */
+    size_t chunkSize;               /* The size of each chunk, or 0 to store the content in pData. */
     time_t creationTime;            /* File creation time. */
     time_t modificationTime;        /* Last modification time. */
+    fs_rwlock lock;                 /* Guards the content while the tree is only locked for reading. */
+    fs_bool32 isContentShared;      /* Set when the buffers may be shared with a snapshot and need to be checked before being modified. */
 } fs_mem_file_data;
 
 typedef struct fs_mem_directory_data
@@ -53,6 +77,8 @@ typedef struct fs_mem_directory_data
     fs_mem_node** ppChildren;       /* Array of child nodes. */
     size_t childCount;              /* Number of children. */
     size_t childCapacity;           /* Capacity of children array. */
+    fs_mem_node** ppChildTable;     /* Hash table of the children keyed by name. NULL until the directory has more than FS_MEM_CHILD_TABLE_THRESHOLD children. */
+    size_t childTableCapacity;      /* Capacity of the hash table. Always a power of two. */
     time_t creationTime;            /* Directory creation time. */
     time_t modificationTime;        /* Last modification time. */
 } fs_mem_directory_data;
@@ -61,8 +87,12 @@ struct fs_mem_node
 {
     char* pName;                    /* Node name (null-terminated). */
     size_t nameLen;                 /* Length of name. */
+    fs_uint32 nameHash;             /* Hash of the name for the child table of the parent. */
     fs_mem_node_type type;          /* Node type (file or directory). */
-    fs_mem_node* pParent;           /* Parent directory. */
+    fs_mem_node* pParent;           /* Parent directory in the writable tree. */
+    size_t iChild;                  /* Index of this node in the children array of pParent. */
+    fs_uint32 refCount;             /* The number of directories, trees and iterators referencing this node. */
+    fs_uint32 generation;           /* The generation of the tree when this node was created. Only nodes of the current generation can be modified in place. */
     union
     {
         fs_mem_file_data file;      /* File-specific data. */
@@ -71,18 +101,80 @@ struct fs_mem_node
 };
 
 
+/*
+Locking is done in two levels. The tree lock is held for reading by anything that only needs the
+structure of the tree to stay put, which includes reading and writing the content of files. It's
+held for writing by anything that changes the structure of the tree, such as creating, removing or
+renaming a node. The content of each file then has its own lock which is held for reading or writing
+while the tree is locked for reading. This allows reads to run in parallel with each other and with
+writes to other files. The tree lock is always taken before the lock of a file.
+*/
+/*
+Nodes and names are allocated from slabs rather than individually from the heap. Nodes come from
+slabs of FS_MEM_NODES_PER_SLAB. Names are bumped out of larger blocks in multiples of
+FS_MEM_NAME_GRANULARITY bytes, with a free list for each size. Freed nodes and names go onto the
+free lists for reuse, and the slabs themselves are only freed when the store they belong to is
+freed.
+*/
+typedef struct fs_mem_node_slab fs_mem_node_slab;
+struct fs_mem_node_slab
+{
+    fs_mem_node_slab* pNext;
+    fs_mem_node nodes[1];           /* There are FS_MEM_NODES_PER_SLAB of these. */
+};
+
+typedef struct fs_mem_name_block fs_mem_name_block;
+struct fs_mem_name_block
+{
+    fs_mem_name_block* pNext;
+    char data[1];                   /* There are FS_MEM_NAME_BLOCK_SIZE bytes of this. */
+};
+
+typedef struct fs_mem_allocator
+{
+    fs_mem_node_slab* pNodeSlabs;   /* The slab at the head of the list is the one being allocated from. */
+    size_t nodeSlabCursor;          /* The number of nodes that have been handed out from the head slab. */
+    fs_mem_node* pFreeNodes;        /* Linked through pParent. */
+    fs_mem_name_block* pNameBlocks; /* The block at the head of the list is the one being allocated from. */
+    size_t nameBlockCursor;         /* The number of bytes that have been handed out from the head block. */
+    char* pFreeNames[FS_MEM_NAME_CLASS_COUNT];  /* Linked through a pointer stored at the start of each name. */
+} fs_mem_allocator;
+
+/*
+Snapshots share nodes and file content with the tree they were taken from. Everything that can be
+shared lives in a store which is reference counted by each fs_mem object using it. The store lock
+guards the allocator and the reference counts of nodes and buffers. It's held along with the tree
+lock whenever the tree is locked for writing, and is always taken after the tree lock.
+*/
+typedef struct fs_mem_store
+{
+    fs_mtx lock;                    /* The store lock. */
+    fs_uint32 refCount;             /* The number of fs_mem objects using this store. */
+    fs_mem_allocator allocator;     /* Where nodes and names are allocated from. */
+} fs_mem_store;
+
+typedef struct fs_file_mem fs_file_mem;
+
 typedef struct fs_mem
 {
     fs_mem_node* pRoot;             /* Root directory node. */
-    fs_mtx lock;
+    fs_rwlock lock;                 /* The tree lock. */
+    size_t chunkSize;               /* From the config. Applied to new files. */
+    fs_mem_store* pStore;           /* Shared with snapshots. */
+    fs_uint32 generation;           /* Incremented by each snapshot so that every existing node needs to be copied before being modified. */
+    fs_bool32 isSnapshot;           /* Snapshots are read-only. */
+    fs_mtx fileLock;                /* Guards the list of open files. */
+    fs_file_mem* pFirstFile;        /* Open files. Needed for pointing them at the copy of a node. */
 } fs_mem;
 
-typedef struct fs_file_mem
+struct fs_file_mem
 {
     fs_mem_node* pNode;             /* Associated file node. */
     fs_uint64 cursor;               /* Current file position. */
     int openMode;                   /* File open mode. */
-} fs_file_mem;
+    fs_file_mem* pPrevFile;         /* Previous open file of the same fs_mem object. */
+    fs_file_mem* pNextFile;         /* Next open file of the same fs_mem object. */
+};
 
 typedef struct fs_iterator_mem
 {
@@ -93,16 +185,181 @@ typedef struct fs_iterator_mem
 
 
 
-static void fs_mem_lock(fs_mem* pMem)
+FS_API fs_mem_config fs_mem_config_init(void)
+{
+    fs_mem_config config;
+
+    FS_MEM_ZERO_OBJECT(&config);
+
+    return config;
+}
+
+
+static void fs_mem_lock_read(fs_mem* pMem)
+{
+    FS_MEM_ASSERT(pMem != NULL);
+    fs_rwlock_lock_read(&pMem->lock);
+}
+
+static void fs_mem_unlock_read(fs_mem* pMem)
+{
+    FS_MEM_ASSERT(pMem != NULL);
+    fs_rwlock_unlock_read(&pMem->lock);
+}
+
+static void fs_mem_lock_write(fs_mem* pMem)
 {
     FS_MEM_ASSERT(pMem != NULL);
-    fs_mtx_lock(&pMem->lock);
+    fs_rwlock_lock_write(&pMem->lock);
+    fs_mtx_lock(&pMem->pStore->lock);
 }
 
-static void fs_mem_unlock(fs_mem* pMem)
+static void fs_mem_unlock_write(fs_mem* pMem)
 {
     FS_MEM_ASSERT(pMem != NULL);
-    fs_mtx_unlock(&pMem->lock);
+    fs_mtx_unlock(&pMem->pStore->lock);
+    fs_rwlock_unlock_write(&pMem->lock);
+}
+
+static void fs_mem_file_lock_read(fs_mem_node* pNode)
+{
+    FS_MEM_ASSERT(pNode != NULL);
+    FS_MEM_ASSERT(pNode->type == FS_MEM_NODE_TYPE_FILE);
+    fs_rwlock_lock_read(&pNode->data.file.lock);
+}
+
+static void fs_mem_file_unlock_read(fs_mem_node* pNode)
+{
+    FS_MEM_ASSERT(pNode != NULL);
+    FS_MEM_ASSERT(pNode->type == FS_MEM_NODE_TYPE_FILE);
+    fs_rwlock_unlock_read(&pNode->data.file.lock);
+}
+
+static void fs_mem_file_lock_write(fs_mem_node* pNode)
+{
+    FS_MEM_ASSERT(pNode != NULL);
+    FS_MEM_ASSERT(pNode->type == FS_MEM_NODE_TYPE_FILE);
+    fs_rwlock_lock_write(&pNode->data.file.lock);
+}
+
+static void fs_mem_file_unlock_write(fs_mem_node* pNode)
+{
+    FS_MEM_ASSERT(pNode != NULL);
+    FS_MEM_ASSERT(pNode->type == FS_MEM_NODE_TYPE_FILE);
+    fs_rwlock_unlock_write(&pNode->data.file.lock);
+}
+
+
+static fs_mem_node* fs_mem_alloc_node(fs_mem_allocator* pAllocator, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_mem_node* pNode;
+
+    if (pAllocator->pFreeNodes != NULL) {
+        pNode = pAllocator->pFreeNodes;
+        pAllocator->pFreeNodes = pNode->pParent;
+        return pNode;
+    }
+
+    if (pAllocator->pNodeSlabs == NULL || pAllocator->nodeSlabCursor == FS_MEM_NODES_PER_SLAB) {
+        fs_mem_node_slab* pSlab = (fs_mem_node_slab*)fs_malloc(sizeof(fs_mem_node_slab) + (FS_MEM_NODES_PER_SLAB - 1) * sizeof(fs_mem_node), pAllocationCallbacks);
+        if (pSlab == NULL) {
+            return NULL;
+        }
+
+        pSlab->pNext = pAllocator->pNodeSlabs;
+        pAllocator->pNodeSlabs = pSlab;
+        pAllocator->nodeSlabCursor = 0;
+    }
+
+    pNode = &pAllocator->pNodeSlabs->nodes[pAllocator->nodeSlabCursor];
+    pAllocator->nodeSlabCursor += 1;
+
+    return pNode;
+}
+
+static void fs_mem_free_node(fs_mem_allocator* pAllocator, fs_mem_node* pNode)
+{
+    pNode->pParent = pAllocator->pFreeNodes;
+    pAllocator->pFreeNodes = pNode;
+}
+
+static size_t fs_mem_name_class(size_t nameLen)
+{
+    /* Includes the null terminator. Returns FS_MEM_NAME_CLASS_COUNT or more for names that go on the heap. */
+    return nameLen / FS_MEM_NAME_GRANULARITY;
+}
+
+static char* fs_mem_alloc_name(fs_mem_allocator* pAllocator, const char* pName, size_t nameLen, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    char* pNewName;
+    size_t nameClass;
+
+    if (nameLen == FS_NULL_TERMINATED) {
+        nameLen = strlen(pName);
+    }
+
+    nameClass = fs_mem_name_class(nameLen);
+
+    if (nameClass >= FS_MEM_NAME_CLASS_COUNT) {
+        pNewName = (char*)fs_malloc(nameLen + 1, pAllocationCallbacks);
+        if (pNewName == NULL) {
+            return NULL;
+        }
+    } else if (pAllocator->pFreeNames[nameClass] != NULL) {
+        pNewName = pAllocator->pFreeNames[nameClass];
+        FS_MEM_COPY_MEMORY(&pAllocator->pFreeNames[nameClass], pNewName, sizeof(char*));
+    } else {
+        size_t allocSize = (nameClass + 1) * FS_MEM_NAME_GRANULARITY;
+
+        if (pAllocator->pNameBlocks == NULL || FS_MEM_NAME_BLOCK_SIZE - pAllocator->nameBlockCursor < allocSize) {
+            fs_mem_name_block* pBlock = (fs_mem_name_block*)fs_malloc(sizeof(fs_mem_name_block) + FS_MEM_NAME_BLOCK_SIZE - 1, pAllocationCallbacks);
+            if (pBlock == NULL) {
+                return NULL;
+            }
+
+            pBlock->pNext = pAllocator->pNameBlocks;
+            pAllocator->pNameBlocks = pBlock;
+            pAllocator->nameBlockCursor = 0;
+        }
+
+        pNewName = pAllocator->pNameBlocks->data + pAllocator->nameBlockCursor;
+        pAllocator->nameBlockCursor += allocSize;
+    }
+
+    FS_MEM_COPY_MEMORY(pNewName, pName, nameLen);
+    pNewName[nameLen] = '\0';
+
+    return pNewName;
+}
+
+static void fs_mem_free_name(fs_mem_allocator* pAllocator, char* pName, size_t nameLen, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    size_t nameClass = fs_mem_name_class(nameLen);
+
+    if (nameClass >= FS_MEM_NAME_CLASS_COUNT) {
+        fs_free(pName, pAllocationCallbacks);
+    } else {
+        /* Every name has room for at least FS_MEM_NAME_GRANULARITY bytes so there's always room for the link. */
+        FS_MEM_COPY_MEMORY(pName, &pAllocator->pFreeNames[nameClass], sizeof(char*));
+        pAllocator->pFreeNames[nameClass] = pName;
+    }
+}
+
+static void fs_mem_allocator_uninit(fs_mem_allocator* pAllocator, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    while (pAllocator->pNodeSlabs != NULL) {
+        fs_mem_node_slab* pNext = pAllocator->pNodeSlabs->pNext;
+        fs_free(pAllocator->pNodeSlabs, pAllocationCallbacks);
+        pAllocator->pNodeSlabs = pNext;
+    }
+
+    while (pAllocator->pNameBlocks != NULL) {
+        fs_mem_name_block* pNext = pAllocator->pNameBlocks->pNext;
+        fs_free(pAllocator->pNameBlocks, pAllocationCallbacks);
+        pAllocator->pNameBlocks = pNext;
+    }
+
+    FS_MEM_ZERO_OBJECT(pAllocator);
 }
 
 
@@ -125,21 +382,123 @@ static char* fs_mem_strdup(const char* pStr, size_t len, const fs_allocation_cal
     return pDuplicate;
 }
 
-static fs_mem_node* fs_mem_node_create(const char* pName, size_t nameLen, fs_mem_node_type type, const fs_allocation_callbacks* pAllocationCallbacks)
+#define FS_MEM_NAME_HASH_BASIS  2166136261U
+#define FS_MEM_NAME_HASH_PRIME  16777619U
+
+static fs_uint32 fs_mem_hash_name(const char* pName, size_t nameLen)
+{
+    fs_uint32 hash = FS_MEM_NAME_HASH_BASIS;
+    size_t i;
+
+    for (i = 0; i < nameLen; i += 1) {
+        hash ^= (fs_uint8)pName[i];
+        hash *= FS_MEM_NAME_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+/*
+File content is allocated with a header holding a reference count so it can be shared between a
+tree and its snapshots. A buffer is only modified while its reference count is 1. Otherwise it's
+copied first. Reference counts are only changed with the store locked.
+*/
+#define FS_MEM_BUFFER_HEADER_SIZE   16
+
+static fs_uint32* fs_mem_buffer_refcount(void* pData)
+{
+    return (fs_uint32*)(((fs_uint8*)pData) - FS_MEM_BUFFER_HEADER_SIZE);
+}
+
+static void* fs_mem_buffer_realloc(void* pData, size_t size, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    void* pNewBuffer;
+
+    if (size > FS_SIZE_MAX - FS_MEM_BUFFER_HEADER_SIZE) {
+        return NULL;
+    }
+
+    FS_MEM_ASSERT(pData == NULL || *fs_mem_buffer_refcount(pData) == 1);
+
+    pNewBuffer = fs_realloc((pData != NULL) ? fs_mem_buffer_refcount(pData) : NULL, FS_MEM_BUFFER_HEADER_SIZE + size, pAllocationCallbacks);
+    if (pNewBuffer == NULL) {
+        return NULL;
+    }
+
+    *(fs_uint32*)pNewBuffer = 1;
+
+    return FS_MEM_OFFSET_PTR(pNewBuffer, FS_MEM_BUFFER_HEADER_SIZE);
+}
+
+static void* fs_mem_buffer_alloc_zeroed(size_t size, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    void* pNewBuffer;
+
+    if (size > FS_SIZE_MAX - FS_MEM_BUFFER_HEADER_SIZE) {
+        return NULL;
+    }
+
+    pNewBuffer = fs_calloc(FS_MEM_BUFFER_HEADER_SIZE + size, pAllocationCallbacks);
+    if (pNewBuffer == NULL) {
+        return NULL;
+    }
+
+    *(fs_uint32*)pNewBuffer = 1;
+
+    return FS_MEM_OFFSET_PTR(pNewBuffer, FS_MEM_BUFFER_HEADER_SIZE);
+}
+
+static void fs_mem_buffer_release(void* pData, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    if (pData == NULL) {
+        return;
+    }
+
+    FS_MEM_ASSERT(*fs_mem_buffer_refcount(pData) > 0);
+
+    *fs_mem_buffer_refcount(pData) -= 1;
+    if (*fs_mem_buffer_refcount(pData) == 0) {
+        fs_free(fs_mem_buffer_refcount(pData), pAllocationCallbacks);
+    }
+}
+
+static fs_result fs_mem_buffer_unshare(void** ppData, size_t size, size_t dataSize, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    void* pNewData;
+
+    if (*ppData == NULL || *fs_mem_buffer_refcount(*ppData) == 1) {
+        return FS_SUCCESS;
+    }
+
+    pNewData = fs_mem_buffer_alloc_zeroed(size, pAllocationCallbacks);
+    if (pNewData == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    FS_MEM_COPY_MEMORY(pNewData, *ppData, dataSize);
+
+    fs_mem_buffer_release(*ppData, pAllocationCallbacks);    /* Never the last reference. */
+    *ppData = pNewData;
+
+    return FS_SUCCESS;
+}
+
+
+static fs_mem_node* fs_mem_node_create(fs_mem* pMem, const char* pName, size_t nameLen, fs_mem_node_type type, const fs_allocation_callbacks* pAllocationCallbacks)
 {
     fs_mem_node* pNode;
     time_t currentTime;
     
-    pNode = (fs_mem_node*)fs_malloc(sizeof(fs_mem_node), pAllocationCallbacks);
+    pNode = fs_mem_alloc_node(&pMem->pStore->allocator, pAllocationCallbacks);
     if (pNode == NULL) {
         return NULL;
     }
     
     FS_MEM_ZERO_OBJECT(pNode);
     
-    pNode->pName = fs_mem_strdup(pName, nameLen, pAllocationCallbacks);
+    pNode->pName = fs_mem_alloc_name(&pMem->pStore->allocator, pName, nameLen, pAllocationCallbacks);
     if (pNode->pName == NULL) {
-        fs_free(pNode, pAllocationCallbacks);
+        fs_mem_free_node(&pMem->pStore->allocator, pNode);
         return NULL;
     }
     
@@ -148,7 +507,10 @@ static fs_mem_node* fs_mem_node_create(const char* pName, size_t nameLen, fs_mem
     }
     
     pNode->nameLen = nameLen;
+    pNode->nameHash = fs_mem_hash_name(pNode->pName, nameLen);
     pNode->type = type;
+    pNode->refCount = 1;
+    pNode->generation = pMem->generation;
     
     currentTime = time(NULL);
     
@@ -156,12 +518,24 @@ static fs_mem_node* fs_mem_node_create(const char* pName, size_t nameLen, fs_mem
         pNode->data.file.pData            = NULL;
         pNode->data.file.size             = 0;
         pNode->data.file.capacity         = 0;
+        pNode->data.file.ppChunks         = NULL;
+        pNode->data.file.chunkCount       = 0;
+        pNode->data.file.chunkSize        = 0;
         pNode->data.file.creationTime     = currentTime;
         pNode->data.file.modificationTime = currentTime;
+        pNode->data.file.isContentShared  = FS_FALSE;
+
+        if (fs_rwlock_init(&pNode->data.file.lock) != FS_SUCCESS) {
+            fs_mem_free_name(&pMem->pStore->allocator, pNode->pName, pNode->nameLen, pAllocationCallbacks);
+            fs_mem_free_node(&pMem->pStore->allocator, pNode);
+            return NULL;
+        }
     } else {
         pNode->data.dir.ppChildren        = NULL;
         pNode->data.dir.childCount        = 0;
         pNode->data.dir.childCapacity     = 0;
+        pNode->data.dir.ppChildTable      = NULL;
+        pNode->data.dir.childTableCapacity = 0;
         pNode->data.dir.creationTime      = currentTime;
         pNode->data.dir.modificationTime  = currentTime;
     }
@@ -169,37 +543,236 @@ static fs_mem_node* fs_mem_node_create(const char* pName, size_t nameLen, fs_mem
     return pNode;
 }
 
-static void fs_mem_node_destroy(fs_mem_node* pNode, const fs_allocation_callbacks* pAllocationCallbacks)
+static void fs_mem_node_release(fs_mem_store* pStore, fs_mem_node* pNode, const fs_allocation_callbacks* pAllocationCallbacks)
 {
     if (pNode == NULL) {
         return;
     }
+
+    FS_MEM_ASSERT(pNode->refCount > 0);
+
+    pNode->refCount -= 1;
+    if (pNode->refCount > 0) {
+        return; /* Still referenced by a snapshot or iterator. */
+    }
     
     if (pNode->type == FS_MEM_NODE_TYPE_FILE) {
-        if (pNode->data.file.pData != NULL) {
-            fs_free(pNode->data.file.pData, pAllocationCallbacks);
+        size_t iChunk;
+
+        fs_mem_buffer_release(pNode->data.file.pData, pAllocationCallbacks);
+
+        for (iChunk = 0; iChunk < pNode->data.file.chunkCount; iChunk += 1) {
+            fs_mem_buffer_release(pNode->data.file.ppChunks[iChunk], pAllocationCallbacks);
         }
+
+        fs_free(pNode->data.file.ppChunks, pAllocationCallbacks);
+
+        fs_rwlock_destroy(&pNode->data.file.lock);
     } else {
-        /* Destroy all children first. */
+        /* Release all children first. */
         size_t i;
         for (i = 0; i < pNode->data.dir.childCount; i += 1) {
-            fs_mem_node_destroy(pNode->data.dir.ppChildren[i], pAllocationCallbacks);
+            fs_mem_node_release(pStore, pNode->data.dir.ppChildren[i], pAllocationCallbacks);
         }
         
         if (pNode->data.dir.ppChildren != NULL) {
             fs_free(pNode->data.dir.ppChildren, pAllocationCallbacks);
         }
+
+        if (pNode->data.dir.ppChildTable != NULL) {
+            fs_free(pNode->data.dir.ppChildTable, pAllocationCallbacks);
+        }
     }
     
     if (pNode->pName != NULL) {
-        fs_free(pNode->pName, pAllocationCallbacks);
+        fs_mem_free_name(&pStore->allocator, pNode->pName, pNode->nameLen, pAllocationCallbacks);
     }
     
-    fs_free(pNode, pAllocationCallbacks);
+    fs_mem_free_node(&pStore->allocator, pNode);
+}
+
+static fs_mem_node* fs_mem_node_copy(fs_mem* pMem, fs_mem_node* pNode, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_mem_node* pCopy;
+    size_t i;
+
+    pCopy = fs_mem_node_create(pMem, pNode->pName, pNode->nameLen, pNode->type, pAllocationCallbacks);
+    if (pCopy == NULL) {
+        return NULL;
+    }
+
+    /* Everything that can fail is done before taking any references so the copy can just be released on failure. */
+    if (pNode->type == FS_MEM_NODE_TYPE_FILE) {
+        if (pNode->data.file.chunkCount > 0) {
+            pCopy->data.file.ppChunks = (void**)fs_malloc(pNode->data.file.chunkCount * sizeof(void*), pAllocationCallbacks);
+            if (pCopy->data.file.ppChunks == NULL) {
+                fs_mem_node_release(pMem->pStore, pCopy, pAllocationCallbacks);
+                return NULL;
+            }
+
+            FS_MEM_COPY_MEMORY(pCopy->data.file.ppChunks, pNode->data.file.ppChunks, pNode->data.file.chunkCount * sizeof(void*));
+            pCopy->data.file.chunkCount = pNode->data.file.chunkCount;
+
+            for (i = 0; i < pCopy->data.file.chunkCount; i += 1) {
+                if (pCopy->data.file.ppChunks[i] != NULL) {
+                    *fs_mem_buffer_refcount(pCopy->data.file.ppChunks[i]) += 1;
+                }
+            }
+        }
+
+        if (pNode->data.file.pData != NULL) {
+            pCopy->data.file.pData = pNode->data.file.pData;
+            *fs_mem_buffer_refcount(pCopy->data.file.pData) += 1;
+        }
+
+        pCopy->data.file.size             = pNode->data.file.size;
+        pCopy->data.file.capacity         = pNode->data.file.capacity;
+        pCopy->data.file.chunkSize        = pNode->data.file.chunkSize;
+        pCopy->data.file.creationTime     = pNode->data.file.creationTime;
+        pCopy->data.file.modificationTime = pNode->data.file.modificationTime;
+        pCopy->data.file.isContentShared  = FS_TRUE;
+    } else {
+        if (pNode->data.dir.childCount > 0) {
+            pCopy->data.dir.ppChildren = (fs_mem_node**)fs_malloc(pNode->data.dir.childCount * sizeof(fs_mem_node*), pAllocationCallbacks);
+            if (pCopy->data.dir.ppChildren == NULL) {
+                fs_mem_node_release(pMem->pStore, pCopy, pAllocationCallbacks);
+                return NULL;
+            }
+
+            pCopy->data.dir.childCapacity = pNode->data.dir.childCount;
+        }
+
+        if (pNode->data.dir.ppChildTable != NULL) {
+            pCopy->data.dir.ppChildTable = (fs_mem_node**)fs_malloc(pNode->data.dir.childTableCapacity * sizeof(fs_mem_node*), pAllocationCallbacks);
+            if (pCopy->data.dir.ppChildTable == NULL) {
+                fs_mem_node_release(pMem->pStore, pCopy, pAllocationCallbacks);
+                return NULL;
+            }
+
+            FS_MEM_COPY_MEMORY(pCopy->data.dir.ppChildTable, pNode->data.dir.ppChildTable, pNode->data.dir.childTableCapacity * sizeof(fs_mem_node*));
+            pCopy->data.dir.childTableCapacity = pNode->data.dir.childTableCapacity;
+        }
+
+        /* The children are shared rather than copied. They now belong to the copy as far as the writable tree is concerned. */
+        for (i = 0; i < pNode->data.dir.childCount; i += 1) {
+            fs_mem_node* pChild = pNode->data.dir.ppChildren[i];
+
+            pChild->refCount += 1;
+            pChild->pParent   = pCopy;
+
+            pCopy->data.dir.ppChildren[i] = pChild;
+        }
+
+        pCopy->data.dir.childCount       = pNode->data.dir.childCount;
+        pCopy->data.dir.creationTime     = pNode->data.dir.creationTime;
+        pCopy->data.dir.modificationTime = pNode->data.dir.modificationTime;
+    }
+
+    return pCopy;
+}
+
+/*
+The child table is an open addressing hash table with linear probing. Each slot points straight at
+the child so no indexes need fixing up when the children array is shifted on removal. The table is
+kept under 75% full.
+*/
+static void fs_mem_directory_table_insert(fs_mem_node* pDirectory, fs_mem_node* pChild)
+{
+    size_t mask = pDirectory->data.dir.childTableCapacity - 1;
+    size_t iSlot;
+
+    iSlot = pChild->nameHash & mask;
+    while (pDirectory->data.dir.ppChildTable[iSlot] != NULL) {
+        iSlot = (iSlot + 1) & mask;
+    }
+
+    pDirectory->data.dir.ppChildTable[iSlot] = pChild;
+}
+
+static void fs_mem_directory_table_remove(fs_mem_node* pDirectory, fs_mem_node* pChild)
+{
+    fs_mem_node** ppTable = pDirectory->data.dir.ppChildTable;
+    size_t mask = pDirectory->data.dir.childTableCapacity - 1;
+    size_t iSlot;
+    size_t iNext;
+
+    iSlot = pChild->nameHash & mask;
+    while (ppTable[iSlot] != pChild) {
+        FS_MEM_ASSERT(ppTable[iSlot] != NULL);
+        iSlot = (iSlot + 1) & mask;
+    }
+
+    /*
+    Rather than leaving a tombstone, shift back any later entries of the probe sequence that would
+    otherwise become unreachable. An entry can fill the hole unless its home slot lies cyclically
+    between the hole and where the entry currently is.
+    */
+    iNext = iSlot;
+    for (;;) {
+        size_t iHome;
+
+        iNext = (iNext + 1) & mask;
+        if (ppTable[iNext] == NULL) {
+            break;
+        }
+
+        iHome = ppTable[iNext]->nameHash & mask;
+        if (iSlot <= iNext) {
+            if (iSlot < iHome && iHome <= iNext) {
+                continue;
+            }
+        } else {
+            if (iSlot < iHome || iHome <= iNext) {
+                continue;
+            }
+        }
+
+        ppTable[iSlot] = ppTable[iNext];
+        iSlot = iNext;
+    }
+
+    ppTable[iSlot] = NULL;
+}
+
+static fs_result fs_mem_directory_table_reserve(fs_mem_node* pDirectory, size_t childCount, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_mem_node** ppNewTable;
+    size_t newCapacity;
+    size_t i;
+
+    if (childCount <= FS_MEM_CHILD_TABLE_THRESHOLD) {
+        return FS_SUCCESS;  /* Small enough for a linear search. */
+    }
+
+    if (childCount <= pDirectory->data.dir.childTableCapacity - (pDirectory->data.dir.childTableCapacity / 4)) {
+        return FS_SUCCESS;  /* Already big enough. */
+    }
+
+    newCapacity = FS_MEM_MAX(pDirectory->data.dir.childTableCapacity, 32);
+    while (childCount > newCapacity - (newCapacity / 4)) {
+        newCapacity *= 2;
+    }
+
+    ppNewTable = (fs_mem_node**)fs_calloc(newCapacity * sizeof(fs_mem_node*), pAllocationCallbacks);
+    if (ppNewTable == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    fs_free(pDirectory->data.dir.ppChildTable, pAllocationCallbacks);
+    pDirectory->data.dir.ppChildTable = ppNewTable;
+    pDirectory->data.dir.childTableCapacity = newCapacity;
+
+    for (i = 0; i < pDirectory->data.dir.childCount; i += 1) {
+        fs_mem_directory_table_insert(pDirectory, pDirectory->data.dir.ppChildren[i]);
+    }
+
+    return FS_SUCCESS;
 }
 
 static fs_result fs_mem_directory_add_child(fs_mem_node* pDirectory, fs_mem_node* pChild, const fs_allocation_callbacks* pAllocationCallbacks)
 {
+    fs_result result;
+
     FS_MEM_ASSERT(pDirectory != NULL);
     FS_MEM_ASSERT(pDirectory->type == FS_MEM_NODE_TYPE_DIRECTORY);
     FS_MEM_ASSERT(pChild != NULL);
@@ -215,11 +788,23 @@ static fs_result fs_mem_directory_add_child(fs_mem_node* pDirectory, fs_mem_node
         pDirectory->data.dir.ppChildren = ppNewChildren;
         pDirectory->data.dir.childCapacity = newCapacity;
     }
+
+    /* The table only holds the existing children after this so nothing needs to be undone if it fails. */
+    result = fs_mem_directory_table_reserve(pDirectory, pDirectory->data.dir.childCount + 1, pAllocationCallbacks);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
     
+    pChild->iChild = pDirectory->data.dir.childCount;
+
     pDirectory->data.dir.ppChildren[pDirectory->data.dir.childCount] = pChild;
     pDirectory->data.dir.childCount += 1;
     pDirectory->data.dir.modificationTime = time(NULL);
 
+    if (pDirectory->data.dir.ppChildTable != NULL) {
+        fs_mem_directory_table_insert(pDirectory, pChild);
+    }
+
     pChild->pParent = pDirectory;
     
     return FS_SUCCESS;
@@ -235,25 +820,52 @@ static fs_result fs_mem_directory_remove_child(fs_mem_node* pDirectory, fs_mem_n
     
     (void)pAllocationCallbacks; /* Not used in this function. */
     
-    /* Find the child. */
-    for (i = 0; i < pDirectory->data.dir.childCount; i += 1) {
-        if (pDirectory->data.dir.ppChildren[i] == pChild) {
-            /* Found. Move remaining children down to overwrite the removed child. */
-            size_t j;
-            for (j = i + 1; j < pDirectory->data.dir.childCount; j += 1) {
-                pDirectory->data.dir.ppChildren[j - 1] = pDirectory->data.dir.ppChildren[j];
-            }
+    i = pChild->iChild;
+    if (i >= pDirectory->data.dir.childCount || pDirectory->data.dir.ppChildren[i] != pChild) {
+        return FS_DOES_NOT_EXIST;
+    }
 
-            pChild->pParent = NULL;
-            
-            pDirectory->data.dir.childCount -= 1;
-            pDirectory->data.dir.modificationTime = time(NULL);
-            
-            return FS_SUCCESS;
-        }
+    /* Move remaining children down to overwrite the removed child. The order is kept for iteration. */
+    FS_MEM_MOVE_MEMORY(pDirectory->data.dir.ppChildren + i, pDirectory->data.dir.ppChildren + i + 1, (pDirectory->data.dir.childCount - i - 1) * sizeof(fs_mem_node*));
+
+    if (pDirectory->data.dir.ppChildTable != NULL) {
+        fs_mem_directory_table_remove(pDirectory, pChild);
+    }
+
+    pChild->pParent = NULL;
+    
+    pDirectory->data.dir.childCount -= 1;
+    pDirectory->data.dir.modificationTime = time(NULL);
+
+    for (; i < pDirectory->data.dir.childCount; i += 1) {
+        pDirectory->data.dir.ppChildren[i]->iChild = i;
     }
     
-    return FS_DOES_NOT_EXIST;
+    return FS_SUCCESS;
+}
+
+static void fs_mem_directory_replace_child(fs_mem_node* pDirectory, fs_mem_node* pOldChild, fs_mem_node* pNewChild)
+{
+    FS_MEM_ASSERT(pDirectory->data.dir.ppChildren[pOldChild->iChild] == pOldChild);
+    FS_MEM_ASSERT(pOldChild->nameHash == pNewChild->nameHash);
+
+    pDirectory->data.dir.ppChildren[pOldChild->iChild] = pNewChild;
+
+    if (pDirectory->data.dir.ppChildTable != NULL) {
+        size_t mask = pDirectory->data.dir.childTableCapacity - 1;
+        size_t iSlot;
+
+        iSlot = pOldChild->nameHash & mask;
+        while (pDirectory->data.dir.ppChildTable[iSlot] != pOldChild) {
+            FS_MEM_ASSERT(pDirectory->data.dir.ppChildTable[iSlot] != NULL);
+            iSlot = (iSlot + 1) & mask;
+        }
+
+        pDirectory->data.dir.ppChildTable[iSlot] = pNewChild;
+    }
+
+    pNewChild->pParent = pDirectory;
+    pNewChild->iChild  = pOldChild->iChild;
 }
 
 static fs_mem_node* fs_mem_directory_find_child(fs_mem_node* pDirectory, const char* pName, size_t nameLen)
@@ -266,6 +878,21 @@ static fs_mem_node* fs_mem_directory_find_child(fs_mem_node* pDirectory, const c
     if (nameLen == FS_NULL_TERMINATED) {
         nameLen = strlen(pName);
     }
+
+    if (pDirectory->data.dir.ppChildTable != NULL) {
+        fs_uint32 hash = fs_mem_hash_name(pName, nameLen);
+        size_t mask = pDirectory->data.dir.childTableCapacity - 1;
+
+        for (i = hash & mask; pDirectory->data.dir.ppChildTable[i] != NULL; i = (i + 1) & mask) {
+            fs_mem_node* pChild = pDirectory->data.dir.ppChildTable[i];
+
+            if (pChild->nameHash == hash && pChild->nameLen == nameLen && memcmp(pChild->pName, pName, nameLen) == 0) {
+                return pChild;
+            }
+        }
+
+        return NULL;
+    }
     
     for (i = 0; i < pDirectory->data.dir.childCount; i += 1) {
         fs_mem_node* pChild = pDirectory->data.dir.ppChildren[i];
@@ -279,6 +906,108 @@ static fs_mem_node* fs_mem_directory_find_child(fs_mem_node* pDirectory, const c
     return NULL;
 }
 
+static void fs_mem_add_file(fs_mem* pMem, fs_file_mem* pFileMem)
+{
+    fs_mtx_lock(&pMem->fileLock);
+    {
+        pFileMem->pPrevFile = NULL;
+        pFileMem->pNextFile = pMem->pFirstFile;
+
+        if (pMem->pFirstFile != NULL) {
+            pMem->pFirstFile->pPrevFile = pFileMem;
+        }
+
+        pMem->pFirstFile = pFileMem;
+    }
+    fs_mtx_unlock(&pMem->fileLock);
+}
+
+static void fs_mem_remove_file(fs_mem* pMem, fs_file_mem* pFileMem)
+{
+    fs_mtx_lock(&pMem->fileLock);
+    {
+        if (pFileMem->pPrevFile != NULL) {
+            pFileMem->pPrevFile->pNextFile = pFileMem->pNextFile;
+        } else {
+            pMem->pFirstFile = pFileMem->pNextFile;
+        }
+
+        if (pFileMem->pNextFile != NULL) {
+            pFileMem->pNextFile->pPrevFile = pFileMem->pPrevFile;
+        }
+    }
+    fs_mtx_unlock(&pMem->fileLock);
+}
+
+/*
+A snapshot shares the whole tree, so before anything can be modified it needs to be copied along
+with every directory above it, up to and including the root. Each node only needs to be copied once
+per snapshot since the copy belongs to the current generation. Nodes that are no longer shared,
+because the snapshot has been uninitialized, are just taken over rather than copied.
+
+The tree needs to be locked for writing. The node must be reachable from the root of this tree.
+*/
+static fs_result fs_mem_node_make_writable(fs_mem* pMem, fs_mem_node* pNode, fs_mem_node** ppWritableNode, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_mem_node* pParent = NULL;
+    fs_mem_node* pCopy;
+    fs_result result;
+
+    FS_MEM_ASSERT(pMem->isSnapshot == FS_FALSE);
+
+    *ppWritableNode = pNode;
+
+    if (pNode->generation == pMem->generation) {
+        return FS_SUCCESS;
+    }
+
+    if (pNode->pParent != NULL) {
+        result = fs_mem_node_make_writable(pMem, pNode->pParent, &pParent, pAllocationCallbacks);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+    } else {
+        FS_MEM_ASSERT(pNode == pMem->pRoot);
+    }
+
+    /* With a writable parent, a reference count of 1 means nothing else can see this node. */
+    if (pNode->refCount == 1) {
+        pNode->generation = pMem->generation;
+        return FS_SUCCESS;
+    }
+
+    pCopy = fs_mem_node_copy(pMem, pNode, pAllocationCallbacks);
+    if (pCopy == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    if (pParent != NULL) {
+        fs_mem_directory_replace_child(pParent, pNode, pCopy);
+    } else {
+        pMem->pRoot = pCopy;
+    }
+
+    /* Open files need to see their own changes so they're moved over to the copy. */
+    if (pNode->type == FS_MEM_NODE_TYPE_FILE) {
+        fs_file_mem* pFileMem;
+
+        fs_mtx_lock(&pMem->fileLock);
+        {
+            for (pFileMem = pMem->pFirstFile; pFileMem != NULL; pFileMem = pFileMem->pNextFile) {
+                if (pFileMem->pNode == pNode) {
+                    pFileMem->pNode = pCopy;
+                }
+            }
+        }
+        fs_mtx_unlock(&pMem->fileLock);
+    }
+
+    fs_mem_node_release(pMem->pStore, pNode, pAllocationCallbacks);   /* Never the last reference. */
+
+    *ppWritableNode = pCopy;
+    return FS_SUCCESS;
+}
+
 static fs_result fs_mem_resolve_path(fs* pFS, const char* pPath, size_t pathLen, fs_mem_node** ppNode, fs_mem_node** ppParent, char** ppLastSegment)
 {
     fs_result result;
@@ -447,38 +1176,95 @@ static fs_result fs_init_mem(fs* pFS, const void* pBackendConfig, fs_stream* pSt
     
     /* Stream is not used for in-memory backend. */
     (void)pStream;
-    (void)pBackendConfig; /* Config not used yet. */
     
     pMem = (fs_mem*)fs_get_backend_data(pFS);
     FS_MEM_ASSERT(pMem != NULL);
     
     FS_MEM_ZERO_OBJECT(pMem);
+
+    if (pBackendConfig != NULL) {
+        const fs_mem_config* pMemConfig = (const fs_mem_config*)pBackendConfig;
+        pMem->chunkSize = pMemConfig->chunkSize;
+    }
     
-    fs_mtx_init(&pMem->lock, fs_mtx_recursive);
+    pMem->pStore = (fs_mem_store*)fs_malloc(sizeof(fs_mem_store), fs_get_allocation_callbacks(pFS));
+    if (pMem->pStore == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    FS_MEM_ZERO_OBJECT(pMem->pStore);
+    pMem->pStore->refCount = 1;
+
+    if (fs_mtx_init(&pMem->pStore->lock, fs_mtx_plain) != FS_SUCCESS) {
+        fs_free(pMem->pStore, fs_get_allocation_callbacks(pFS));
+        return FS_ERROR;
+    }
+    
+    if (fs_rwlock_init(&pMem->lock) != FS_SUCCESS) {
+        fs_mtx_destroy(&pMem->pStore->lock);
+        fs_free(pMem->pStore, fs_get_allocation_callbacks(pFS));
+        return FS_ERROR;
+    }
+
+    if (fs_mtx_init(&pMem->fileLock, fs_mtx_plain) != FS_SUCCESS) {
+        fs_rwlock_destroy(&pMem->lock);
+        fs_mtx_destroy(&pMem->pStore->lock);
+        fs_free(pMem->pStore, fs_get_allocation_callbacks(pFS));
+        return FS_ERROR;
+    }
     
     /* Create root directory. */
-    pMem->pRoot = fs_mem_node_create("", 0, FS_MEM_NODE_TYPE_DIRECTORY, fs_get_allocation_callbacks(pFS));
+    pMem->pRoot = fs_mem_node_create(pMem, "", 0, FS_MEM_NODE_TYPE_DIRECTORY, fs_get_allocation_callbacks(pFS));
     if (pMem->pRoot == NULL) {
+        fs_mtx_destroy(&pMem->fileLock);
+        fs_rwlock_destroy(&pMem->lock);
+        fs_mem_allocator_uninit(&pMem->pStore->allocator, fs_get_allocation_callbacks(pFS));
+        fs_mtx_destroy(&pMem->pStore->lock);
+        fs_free(pMem->pStore, fs_get_allocation_callbacks(pFS));
         return FS_OUT_OF_MEMORY;
     }
     
     return FS_SUCCESS;
 }
 
+static void fs_mem_release_tree(fs_mem* pMem, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_mem_store* pStore = pMem->pStore;
+    fs_bool32 isLastReference;
+
+    fs_mtx_lock(&pStore->lock);
+    {
+        fs_mem_node_release(pStore, pMem->pRoot, pAllocationCallbacks);
+
+        pStore->refCount -= 1;
+        isLastReference = (pStore->refCount == 0);
+    }
+    fs_mtx_unlock(&pStore->lock);
+
+    if (isLastReference) {
+        fs_mem_allocator_uninit(&pStore->allocator, pAllocationCallbacks);
+        fs_mtx_destroy(&pStore->lock);
+        fs_free(pStore, pAllocationCallbacks);
+    }
+
+    pMem->pRoot  = NULL;
+    pMem->pStore = NULL;
+}
+
 static void fs_uninit_mem(fs* pFS)
 {
     fs_mem* pMem = (fs_mem*)fs_get_backend_data(pFS);
     FS_MEM_ASSERT(pMem != NULL);
     
-    if (pMem->pRoot != NULL) {
-        fs_mem_node_destroy(pMem->pRoot, fs_get_allocation_callbacks(pFS));
-    }
+    fs_mem_release_tree(pMem, fs_get_allocation_callbacks(pFS));
     
-    fs_mtx_destroy(&pMem->lock);
+    fs_mtx_destroy(&pMem->fileLock);
+    fs_rwlock_destroy(&pMem->lock);
 }
 
 static fs_result fs_remove_mem_nolock(fs* pFS, const char* pFilePath)
 {
+    fs_mem* pMem = (fs_mem*)fs_get_backend_data(pFS);
     fs_mem_node* pNode;
     fs_mem_node* pParent;
     fs_result result;
@@ -501,6 +1287,12 @@ static fs_result fs_remove_mem_nolock(fs* pFS, const char* pFilePath)
     if (pNode->type == FS_MEM_NODE_TYPE_DIRECTORY && pNode->data.dir.childCount > 0) {
         return FS_DIRECTORY_NOT_EMPTY;
     }
+
+    /* Only the parent is changed. The node itself may live on in a snapshot. */
+    result = fs_mem_node_make_writable(pMem, pParent, &pParent, fs_get_allocation_callbacks(pFS));
+    if (result != FS_SUCCESS) {
+        return result;
+    }
     
     /* Remove from parent. */
     result = fs_mem_directory_remove_child(pParent, pNode, fs_get_allocation_callbacks(pFS));
@@ -508,8 +1300,8 @@ static fs_result fs_remove_mem_nolock(fs* pFS, const char* pFilePath)
         return result;
     }
     
-    /* Destroy the node. */
-    fs_mem_node_destroy(pNode, fs_get_allocation_callbacks(pFS));
+    /* Release the parent's reference to the node. */
+    fs_mem_node_release(pMem->pStore, pNode, fs_get_allocation_callbacks(pFS));
     
     return FS_SUCCESS;
 }
@@ -521,23 +1313,33 @@ static fs_result fs_remove_mem(fs* pFS, const char* pFilePath)
     
     pMem = (fs_mem*)fs_get_backend_data(pFS);
     FS_MEM_ASSERT(pMem != NULL);
+
+    if (pMem->isSnapshot) {
+        return FS_ACCESS_DENIED;
+    }
     
-    fs_mem_lock(pMem);
+    fs_mem_lock_write(pMem);
     {
         result = fs_remove_mem_nolock(pFS, pFilePath);
     }
-    fs_mem_unlock(pMem);
+    fs_mem_unlock_write(pMem);
     
     return result;
 }
 
 static fs_result fs_rename_mem_nolock(fs* pFS, const char* pOldPath, const char* pNewPath)
 {
+    fs_mem* pMem = (fs_mem*)fs_get_backend_data(pFS);
     fs_mem_node* pOldNode;
     fs_mem_node* pOldParent;
     fs_mem_node* pNewParent;
     fs_mem_node* pExistingNode;
-    char* pNewName = NULL;
+    char* pNewSegment = NULL;
+    char* pNewName;
+    size_t newNameLen;
+    char* pOldName;
+    size_t oldNameLen;
+    fs_uint32 oldNameHash;
     fs_result result;
     
     /* Find the old node. */
@@ -552,7 +1354,7 @@ static fs_result fs_rename_mem_nolock(fs* pFS, const char* pOldPath, const char*
     }
     
     /* Find the new parent and name. */
-    result = fs_mem_resolve_path(pFS, pNewPath, FS_NULL_TERMINATED, &pExistingNode, &pNewParent, &pNewName);
+    result = fs_mem_resolve_path(pFS, pNewPath, FS_NULL_TERMINATED, &pExistingNode, &pNewParent, &pNewSegment);
     if (result != FS_SUCCESS && result != FS_DOES_NOT_EXIST) {
         return result;
     }
@@ -563,32 +1365,75 @@ static fs_result fs_rename_mem_nolock(fs* pFS, const char* pOldPath, const char*
     
     /* Check if target already exists. */
     if (pExistingNode != NULL) {
-        fs_free(pNewName, fs_get_allocation_callbacks(pFS));
+        fs_free(pNewSegment, fs_get_allocation_callbacks(pFS));
         return FS_ALREADY_EXISTS;
     }
 
-    FS_MEM_ASSERT(pNewName != NULL);
+    FS_MEM_ASSERT(pNewSegment != NULL);
+
+    /* The segment is on the heap. The node's name needs to come from the name allocator. */
+    newNameLen = strlen(pNewSegment);
+    pNewName = fs_mem_alloc_name(&pMem->pStore->allocator, pNewSegment, newNameLen, fs_get_allocation_callbacks(pFS));
+    fs_free(pNewSegment, fs_get_allocation_callbacks(pFS));
+
+    if (pNewName == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    /*
+    The name of the node is changed so the node itself needs to be writable, along with both parents.
+    Making the node writable can replace the new parent with a copy, in which case it needs to be
+    looked up again.
+    */
+    result = fs_mem_node_make_writable(pMem, pOldNode, &pOldNode, fs_get_allocation_callbacks(pFS));
+    if (result != FS_SUCCESS) {
+        fs_mem_free_name(&pMem->pStore->allocator, pNewName, newNameLen, fs_get_allocation_callbacks(pFS));
+        return result;
+    }
+
+    pOldParent = pOldNode->pParent;
+
+    if (pNewParent->generation != pMem->generation) {
+        fs_mem_resolve_path(pFS, pNewPath, FS_NULL_TERMINATED, &pExistingNode, &pNewParent, NULL);
+        FS_MEM_ASSERT(pExistingNode == NULL && pNewParent != NULL);
+
+        result = fs_mem_node_make_writable(pMem, pNewParent, &pNewParent, fs_get_allocation_callbacks(pFS));
+        if (result != FS_SUCCESS) {
+            fs_mem_free_name(&pMem->pStore->allocator, pNewName, newNameLen, fs_get_allocation_callbacks(pFS));
+            return result;
+        }
+    }
     
     /* Remove from old parent. */
     result = fs_mem_directory_remove_child(pOldParent, pOldNode, fs_get_allocation_callbacks(pFS));
     if (result != FS_SUCCESS) {
-        fs_free(pNewName, fs_get_allocation_callbacks(pFS));
+        fs_mem_free_name(&pMem->pStore->allocator, pNewName, newNameLen, fs_get_allocation_callbacks(pFS));
         return result;
     }
     
+    /* The name needs to be updated before adding to the new parent so it's hashed into the right slot. */
+    pOldName    = pOldNode->pName;
+    oldNameLen  = pOldNode->nameLen;
+    oldNameHash = pOldNode->nameHash;
+
+    pOldNode->pName    = pNewName;
+    pOldNode->nameLen  = newNameLen;
+    pOldNode->nameHash = fs_mem_hash_name(pOldNode->pName, pOldNode->nameLen);
+
     /* Add to new parent. */
     result = fs_mem_directory_add_child(pNewParent, pOldNode, fs_get_allocation_callbacks(pFS));
     if (result != FS_SUCCESS) {
         /* Failed. Try to re-add to old parent to avoid losing the node. */
+        pOldNode->pName    = pOldName;
+        pOldNode->nameLen  = oldNameLen;
+        pOldNode->nameHash = oldNameHash;
+
         fs_mem_directory_add_child(pOldParent, pOldNode, fs_get_allocation_callbacks(pFS));
-        fs_free(pNewName, fs_get_allocation_callbacks(pFS));
+        fs_mem_free_name(&pMem->pStore->allocator, pNewName, newNameLen, fs_get_allocation_callbacks(pFS));
         return result;
     }
 
-    /* Update the node's name. */
-    fs_free(pOldNode->pName, fs_get_allocation_callbacks(pFS));
-    pOldNode->pName = pNewName;
-    pOldNode->nameLen = strlen(pNewName);
+    fs_mem_free_name(&pMem->pStore->allocator, pOldName, oldNameLen, fs_get_allocation_callbacks(pFS));
     
     return FS_SUCCESS;
 }
@@ -601,17 +1446,22 @@ static fs_result fs_rename_mem(fs* pFS, const char* pOldPath, const char* pNewPa
     pMem = (fs_mem*)fs_get_backend_data(pFS);
     FS_MEM_ASSERT(pMem != NULL);
 
-    fs_mem_lock(pMem);
+    if (pMem->isSnapshot) {
+        return FS_ACCESS_DENIED;
+    }
+
+    fs_mem_lock_write(pMem);
     {
         result = fs_rename_mem_nolock(pFS, pOldPath, pNewPath);
     }
-    fs_mem_unlock(pMem);
+    fs_mem_unlock_write(pMem);
     
     return result;
 }
 
 static fs_result fs_mkdir_mem_nolock(fs* pFS, const char* pPath)
 {
+    fs_mem* pMem = (fs_mem*)fs_get_backend_data(pFS);
     fs_mem_node* pNode;
     fs_mem_node* pParent;
     fs_mem_node* pNewDir;
@@ -631,8 +1481,14 @@ static fs_result fs_mkdir_mem_nolock(fs* pFS, const char* pPath)
     }
     
     FS_MEM_ASSERT(pName != NULL);
+
+    result = fs_mem_node_make_writable(pMem, pParent, &pParent, fs_get_allocation_callbacks(pFS));
+    if (result != FS_SUCCESS) {
+        fs_free(pName, fs_get_allocation_callbacks(pFS));
+        return result;
+    }
     
-    pNewDir = fs_mem_node_create(pName, FS_NULL_TERMINATED, FS_MEM_NODE_TYPE_DIRECTORY, fs_get_allocation_callbacks(pFS));
+    pNewDir = fs_mem_node_create(pMem, pName, FS_NULL_TERMINATED, FS_MEM_NODE_TYPE_DIRECTORY, fs_get_allocation_callbacks(pFS));
     if (pNewDir == NULL) {
         fs_free(pName, fs_get_allocation_callbacks(pFS));
         return FS_OUT_OF_MEMORY;
@@ -640,78 +1496,242 @@ static fs_result fs_mkdir_mem_nolock(fs* pFS, const char* pPath)
     
     result = fs_mem_directory_add_child(pParent, pNewDir, fs_get_allocation_callbacks(pFS));
     if (result != FS_SUCCESS) {
-        fs_mem_node_destroy(pNewDir, fs_get_allocation_callbacks(pFS));
+        fs_mem_node_release(pMem->pStore, pNewDir, fs_get_allocation_callbacks(pFS));
         fs_free(pName, fs_get_allocation_callbacks(pFS));
         return result;
     }
-    
-    fs_free(pName, fs_get_allocation_callbacks(pFS));
+    
+    fs_free(pName, fs_get_allocation_callbacks(pFS));
+    return FS_SUCCESS;
+}
+
+static fs_result fs_mkdir_mem(fs* pFS, const char* pPath)
+{
+    fs_mem* pMem;
+    fs_result result;
+    
+    pMem = (fs_mem*)fs_get_backend_data(pFS);
+    FS_MEM_ASSERT(pMem != NULL);
+
+    if (pMem->isSnapshot) {
+        return FS_ACCESS_DENIED;
+    }
+    
+    fs_mem_lock_write(pMem);
+    {
+        result = fs_mkdir_mem_nolock(pFS, pPath);
+    }
+    fs_mem_unlock_write(pMem);
+    
+    return result;
+}
+
+static fs_result fs_info_mem_nolock(fs* pFS, const char* pPath, int openMode, fs_file_info* pInfo)
+{
+    fs_mem_node* pNode;
+    fs_result result;
+    
+    (void)openMode;
+    
+    if (pInfo == NULL) {
+        return FS_INVALID_ARGS;
+    }
+    
+    result = fs_mem_resolve_path(pFS, pPath, FS_NULL_TERMINATED, &pNode, NULL, NULL);
+    if (result != FS_SUCCESS || pNode == NULL) {
+        return FS_DOES_NOT_EXIST;
+    }
+    
+    FS_MEM_ZERO_OBJECT(pInfo);
+    
+    if (pNode->type == FS_MEM_NODE_TYPE_FILE) {
+        fs_mem_file_lock_read(pNode);
+        {
+            pInfo->size = pNode->data.file.size;
+        }
+        fs_mem_file_unlock_read(pNode);
+
+        pInfo->directory = 0;
+    } else {
+        pInfo->size = 0;
+        pInfo->directory = 1;
+    }
+    
+    pInfo->symlink = 0;
+    
+    return FS_SUCCESS;
+}
+
+static fs_result fs_info_mem(fs* pFS, const char* pPath, int openMode, fs_file_info* pInfo)
+{
+    fs_mem* pMem;
+    fs_result result;
+    
+    pMem = (fs_mem*)fs_get_backend_data(pFS);
+    FS_MEM_ASSERT(pMem != NULL);
+    
+    fs_mem_lock_read(pMem);
+    {
+        result = fs_info_mem_nolock(pFS, pPath, openMode, pInfo);
+    }
+    fs_mem_unlock_read(pMem);
+    
+    return result;
+}
+
+
+/*
+The parts of chunks past the end of a chunked file are always kept zeroed. That way a file can grow
+by just changing its size, without needing to clear whatever was left behind by an earlier truncate.
+*/
+static fs_result fs_mem_file_reserve_chunk_table(fs_mem_node* pNode, size_t chunkCount, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    void** ppNewChunks;
+    size_t newChunkCount;
+
+    if (chunkCount <= pNode->data.file.chunkCount) {
+        return FS_SUCCESS;
+    }
+
+    /* Only the table is reallocated. The chunks themselves never move. */
+    newChunkCount = FS_MEM_MAX(chunkCount, pNode->data.file.chunkCount * 2);
+    if (newChunkCount > FS_SIZE_MAX / sizeof(void*)) {
+        return FS_TOO_BIG;
+    }
+
+    ppNewChunks = (void**)fs_realloc(pNode->data.file.ppChunks, newChunkCount * sizeof(void*), pAllocationCallbacks);
+    if (ppNewChunks == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    FS_MEM_ZERO_MEMORY(ppNewChunks + pNode->data.file.chunkCount, (newChunkCount - pNode->data.file.chunkCount) * sizeof(void*));
+
+    pNode->data.file.ppChunks   = ppNewChunks;
+    pNode->data.file.chunkCount = newChunkCount;
+
+    return FS_SUCCESS;
+}
+
+static void fs_mem_file_read_chunks(fs_mem_node* pNode, size_t offset, void* pDst, size_t bytesToRead)
+{
+    size_t chunkSize = pNode->data.file.chunkSize;
+
+    while (bytesToRead > 0) {
+        size_t iChunk = offset / chunkSize;
+        size_t offsetInChunk = offset % chunkSize;
+        size_t bytesToReadFromChunk = FS_MEM_MIN(chunkSize - offsetInChunk, bytesToRead);
+
+        if (iChunk < pNode->data.file.chunkCount && pNode->data.file.ppChunks[iChunk] != NULL) {
+            FS_MEM_COPY_MEMORY(pDst, FS_MEM_OFFSET_PTR(pNode->data.file.ppChunks[iChunk], offsetInChunk), bytesToReadFromChunk);
+        } else {
+            FS_MEM_ZERO_MEMORY(pDst, bytesToReadFromChunk);
+        }
+
+        pDst = FS_MEM_OFFSET_PTR(pDst, bytesToReadFromChunk);
+        offset      += bytesToReadFromChunk;
+        bytesToRead -= bytesToReadFromChunk;
+    }
+}
+
+static fs_result fs_mem_file_write_chunks(fs_mem_node* pNode, size_t offset, const void* pSrc, size_t bytesToWrite, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_result result;
+    size_t chunkSize = pNode->data.file.chunkSize;
+    size_t iFirstChunk;
+    size_t iLastChunk;
+    size_t iChunk;
+
+    FS_MEM_ASSERT(bytesToWrite > 0);
+
+    iFirstChunk = offset / chunkSize;
+    iLastChunk  = (offset + bytesToWrite - 1) / chunkSize;
+
+    result = fs_mem_file_reserve_chunk_table(pNode, iLastChunk + 1, pAllocationCallbacks);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    /* Allocate every chunk before copying anything so that running out of memory leaves the content untouched. */
+    for (iChunk = iFirstChunk; iChunk <= iLastChunk; iChunk += 1) {
+        if (pNode->data.file.ppChunks[iChunk] == NULL) {
+            pNode->data.file.ppChunks[iChunk] = fs_mem_buffer_alloc_zeroed(chunkSize, pAllocationCallbacks);
+            if (pNode->data.file.ppChunks[iChunk] == NULL) {
+                return FS_OUT_OF_MEMORY;    /* Any chunks allocated so far are zeroed so they can be left in the table. */
+            }
+        }
+    }
+
+    while (bytesToWrite > 0) {
+        size_t offsetInChunk = offset % chunkSize;
+        size_t bytesToWriteToChunk = FS_MEM_MIN(chunkSize - offsetInChunk, bytesToWrite);
+
+        FS_MEM_COPY_MEMORY(FS_MEM_OFFSET_PTR(pNode->data.file.ppChunks[offset / chunkSize], offsetInChunk), pSrc, bytesToWriteToChunk);
+
+        pSrc = FS_MEM_OFFSET_PTR(pSrc, bytesToWriteToChunk);
+        offset       += bytesToWriteToChunk;
+        bytesToWrite -= bytesToWriteToChunk;
+    }
+
     return FS_SUCCESS;
 }
 
-static fs_result fs_mkdir_mem(fs* pFS, const char* pPath)
+static void fs_mem_file_shrink_chunks(fs_mem_node* pNode, size_t newSize, const fs_allocation_callbacks* pAllocationCallbacks)
 {
-    fs_mem* pMem;
-    fs_result result;
-    
-    pMem = (fs_mem*)fs_get_backend_data(pFS);
-    FS_MEM_ASSERT(pMem != NULL);
-    
-    fs_mem_lock(pMem);
-    {
-        result = fs_mkdir_mem_nolock(pFS, pPath);
+    size_t chunkSize = pNode->data.file.chunkSize;
+    size_t iChunk;
+
+    FS_MEM_ASSERT(newSize <= pNode->data.file.size);
+
+    /* Chunks entirely past the new end are freed. */
+    for (iChunk = (newSize + chunkSize - 1) / chunkSize; iChunk < pNode->data.file.chunkCount; iChunk += 1) {
+        fs_mem_buffer_release(pNode->data.file.ppChunks[iChunk], pAllocationCallbacks);
+        pNode->data.file.ppChunks[iChunk] = NULL;
     }
-    fs_mem_unlock(pMem);
-    
-    return result;
+
+    /* The rest of the last chunk needs to be cleared. */
+    if ((newSize % chunkSize) != 0) {
+        iChunk = newSize / chunkSize;
+
+        if (iChunk < pNode->data.file.chunkCount && pNode->data.file.ppChunks[iChunk] != NULL) {
+            FS_MEM_ZERO_MEMORY(FS_MEM_OFFSET_PTR(pNode->data.file.ppChunks[iChunk], newSize % chunkSize), FS_MEM_MIN(chunkSize, pNode->data.file.size - (iChunk * chunkSize)) - (newSize % chunkSize));
+        }
+    }
+
+    pNode->data.file.size = newSize;
 }
 
-static fs_result fs_info_mem_nolock(fs* pFS, const char* pPath, int openMode, fs_file_info* pInfo)
+/*
+Makes sure the content overlapping the given range isn't shared with a snapshot so it can be
+modified. Single buffers are always unshared as a whole. The store needs to be locked if the
+content may be shared.
+*/
+static fs_result fs_mem_file_unshare(fs_mem_node* pNode, size_t offset, size_t length, const fs_allocation_callbacks* pAllocationCallbacks)
 {
-    fs_mem_node* pNode;
     fs_result result;
-    
-    (void)openMode;
-    
-    if (pInfo == NULL) {
-        return FS_INVALID_ARGS;
+    size_t chunkSize = pNode->data.file.chunkSize;
+    size_t iChunk;
+
+    if (!pNode->data.file.isContentShared) {
+        return FS_SUCCESS;
     }
-    
-    result = fs_mem_resolve_path(pFS, pPath, FS_NULL_TERMINATED, &pNode, NULL, NULL);
-    if (result != FS_SUCCESS || pNode == NULL) {
-        return FS_DOES_NOT_EXIST;
+
+    if (chunkSize == 0) {
+        return fs_mem_buffer_unshare(&pNode->data.file.pData, pNode->data.file.capacity, pNode->data.file.size, pAllocationCallbacks);
     }
-    
-    FS_MEM_ZERO_OBJECT(pInfo);
-    
-    if (pNode->type == FS_MEM_NODE_TYPE_FILE) {
-        pInfo->size = pNode->data.file.size;
-        pInfo->directory = 0;
-    } else {
-        pInfo->size = 0;
-        pInfo->directory = 1;
+
+    if (length == 0) {
+        return FS_SUCCESS;
     }
-    
-    pInfo->symlink = 0;
-    
-    return FS_SUCCESS;
-}
 
-static fs_result fs_info_mem(fs* pFS, const char* pPath, int openMode, fs_file_info* pInfo)
-{
-    fs_mem* pMem;
-    fs_result result;
-    
-    pMem = (fs_mem*)fs_get_backend_data(pFS);
-    FS_MEM_ASSERT(pMem != NULL);
-    
-    fs_mem_lock(pMem);
-    {
-        result = fs_info_mem_nolock(pFS, pPath, openMode, pInfo);
+    /* The whole chunk is copied to keep whatever is past the end of the file zeroed. */
+    for (iChunk = offset / chunkSize; iChunk <= (offset + length - 1) / chunkSize && iChunk < pNode->data.file.chunkCount; iChunk += 1) {
+        result = fs_mem_buffer_unshare(&pNode->data.file.ppChunks[iChunk], chunkSize, chunkSize, pAllocationCallbacks);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
     }
-    fs_mem_unlock(pMem);
-    
-    return result;
+
+    return FS_SUCCESS;
 }
 
 
@@ -723,6 +1743,7 @@ static size_t fs_file_alloc_size_mem(fs* pFS)
 
 static fs_result fs_file_open_mem_nolock(fs* pFS, const char* pFilePath, int openMode, fs_file_mem* pFileMem)
 {
+    fs_mem* pMem = (fs_mem*)fs_get_backend_data(pFS);
     fs_result result;
     fs_mem_node* pNode;
     fs_mem_node* pParent;
@@ -743,6 +1764,14 @@ static fs_result fs_file_open_mem_nolock(fs* pFS, const char* pFilePath, int ope
         if ((openMode & FS_EXCLUSIVE) != 0) {
             return FS_ALREADY_EXISTS;
         }
+
+        /* Truncating modifies the file straight away. Otherwise a file shared with a snapshot is copied on the first write. */
+        if ((openMode & FS_TRUNCATE) != 0) {
+            result = fs_mem_node_make_writable(pMem, pNode, &pNode, fs_get_allocation_callbacks(pFS));
+            if (result != FS_SUCCESS) {
+                return result;
+            }
+        }
         
         pFileMem->pNode = pNode;
         pFileMem->openMode = openMode;
@@ -756,6 +1785,10 @@ static fs_result fs_file_open_mem_nolock(fs* pFS, const char* pFilePath, int ope
         
         /* Truncate if requested. */
         if (openMode & FS_TRUNCATE) {
+            if (pNode->data.file.chunkSize != 0) {
+                fs_mem_file_shrink_chunks(pNode, 0, fs_get_allocation_callbacks(pFS));
+            }
+
             pNode->data.file.size = 0;
             pNode->data.file.modificationTime = time(NULL);
             pFileMem->cursor = 0;
@@ -784,18 +1817,26 @@ static fs_result fs_file_open_mem_nolock(fs* pFS, const char* pFilePath, int ope
     }
     
     FS_MEM_ASSERT(pName != NULL);
+
+    result = fs_mem_node_make_writable(pMem, pParent, &pParent, fs_get_allocation_callbacks(pFS));
+    if (result != FS_SUCCESS) {
+        fs_free(pName, fs_get_allocation_callbacks(pFS));
+        return result;
+    }
     
     /* Create new file node. */
-    pNode = fs_mem_node_create(pName, FS_NULL_TERMINATED, FS_MEM_NODE_TYPE_FILE, fs_get_allocation_callbacks(pFS));
+    pNode = fs_mem_node_create(pMem, pName, FS_NULL_TERMINATED, FS_MEM_NODE_TYPE_FILE, fs_get_allocation_callbacks(pFS));
     if (pNode == NULL) {
         fs_free(pName, fs_get_allocation_callbacks(pFS));
         return FS_OUT_OF_MEMORY;
     }
     
+    pNode->data.file.chunkSize = pMem->chunkSize;
+    
     /* Add to parent directory. */
     result = fs_mem_directory_add_child(pParent, pNode, fs_get_allocation_callbacks(pFS));
     if (result != FS_SUCCESS) {
-        fs_mem_node_destroy(pNode, fs_get_allocation_callbacks(pFS));
+        fs_mem_node_release(pMem->pStore, pNode, fs_get_allocation_callbacks(pFS));
         fs_free(pName, fs_get_allocation_callbacks(pFS));
         return result;
     }
@@ -826,12 +1867,34 @@ static fs_result fs_file_open_mem(fs* pFS, fs_stream* pStream, const char* pFile
     FS_MEM_ASSERT(pFileMem != NULL);
     
     FS_MEM_ZERO_OBJECT(pFileMem);
-    
-    fs_mem_lock(pMem);
-    {
-        result = fs_file_open_mem_nolock(pFS, pFilePath, openMode, pFileMem);
+
+    /*
+    Opening for writing can create or truncate the file. Otherwise nothing is changed. The file is
+    added to the list of open files before unlocking so it can't miss its node being copied.
+    */
+    if ((openMode & FS_WRITE) != 0) {
+        if (pMem->isSnapshot) {
+            return FS_ACCESS_DENIED;
+        }
+
+        fs_mem_lock_write(pMem);
+        {
+            result = fs_file_open_mem_nolock(pFS, pFilePath, openMode, pFileMem);
+            if (result == FS_SUCCESS) {
+                fs_mem_add_file(pMem, pFileMem);
+            }
+        }
+        fs_mem_unlock_write(pMem);
+    } else {
+        fs_mem_lock_read(pMem);
+        {
+            result = fs_file_open_mem_nolock(pFS, pFilePath, openMode, pFileMem);
+            if (result == FS_SUCCESS) {
+                fs_mem_add_file(pMem, pFileMem);
+            }
+        }
+        fs_mem_unlock_read(pMem);
     }
-    fs_mem_unlock(pMem);
     
     return result;
 }
@@ -841,7 +1904,8 @@ static void fs_file_close_mem(fs_file* pFile)
     fs_file_mem* pFileMem = (fs_file_mem*)fs_file_get_backend_data(pFile);
     FS_MEM_ASSERT(pFileMem != NULL);
     
-    /* Nothing special needed for cleanup. */
+    fs_mem_remove_file((fs_mem*)fs_get_backend_data(fs_file_get_fs(pFile)), pFileMem);
+
     FS_MEM_ZERO_OBJECT(pFileMem);
 }
 
@@ -874,7 +1938,9 @@ static fs_result fs_file_read_mem_nolock(fs_file_mem* pFileMem, void* pDst, size
     }
     
     /* Copy the data. */
-    if (bytesToRead > 0 && pNode->data.file.pData != NULL) {
+    if (pNode->data.file.chunkSize != 0) {
+        fs_mem_file_read_chunks(pNode, (size_t)pFileMem->cursor, pDst, bytesToRead);
+    } else if (bytesToRead > 0 && pNode->data.file.pData != NULL) {
         FS_MEM_COPY_MEMORY(pDst, FS_MEM_OFFSET_PTR(pNode->data.file.pData, pFileMem->cursor), bytesToRead);
     }
     
@@ -895,17 +1961,72 @@ static fs_result fs_file_read_mem(fs_file* pFile, void* pDst, size_t bytesToRead
     
     pMem = (fs_mem*)fs_get_backend_data(fs_file_get_fs(pFile));
     
-    fs_mem_lock(pMem);
+    fs_mem_lock_read(pMem);
+    fs_mem_file_lock_read(pFileMem->pNode);
     {
         result = fs_file_read_mem_nolock(pFileMem, pDst, bytesToRead, pBytesRead);
     }
-    fs_mem_unlock(pMem);
+    fs_mem_file_unlock_read(pFileMem->pNode);
+    fs_mem_unlock_read(pMem);
     
     return result;
 }
 
+/*
+Locks a file for modifying its content. Normally this only needs the tree locked for reading, but
+when the file is shared with a snapshot it needs to be copied first, which needs the tree locked
+for writing. The store is locked while the content may be shared.
+*/
+static fs_result fs_mem_begin_file_write(fs_mem* pMem, fs_file_mem* pFileMem, fs_bool32* pIsTreeLockedForWriting, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_result result;
+    fs_mem_node* pNode;
+
+    fs_mem_lock_read(pMem);
+
+    if (pFileMem->pNode->generation == pMem->generation) {
+        fs_mem_file_lock_write(pFileMem->pNode);
+
+        if (pFileMem->pNode->data.file.isContentShared) {
+            fs_mtx_lock(&pMem->pStore->lock);
+        }
+
+        *pIsTreeLockedForWriting = FS_FALSE;
+        return FS_SUCCESS;
+    }
+
+    fs_mem_unlock_read(pMem);
+    fs_mem_lock_write(pMem);
+
+    /* This will point the file at the copy. */
+    result = fs_mem_node_make_writable(pMem, pFileMem->pNode, &pNode, pAllocationCallbacks);
+    if (result != FS_SUCCESS) {
+        fs_mem_unlock_write(pMem);
+        return result;
+    }
+
+    *pIsTreeLockedForWriting = FS_TRUE;
+    return FS_SUCCESS;
+}
+
+static void fs_mem_end_file_write(fs_mem* pMem, fs_file_mem* pFileMem, fs_bool32 isTreeLockedForWriting)
+{
+    if (isTreeLockedForWriting) {
+        fs_mem_unlock_write(pMem);
+        return;
+    }
+
+    if (pFileMem->pNode->data.file.isContentShared) {
+        fs_mtx_unlock(&pMem->pStore->lock);
+    }
+
+    fs_mem_file_unlock_write(pFileMem->pNode);
+    fs_mem_unlock_read(pMem);
+}
+
 static fs_result fs_file_write_mem_nolock(fs_file_mem* pFileMem, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten, const fs_allocation_callbacks* pAllocationCallbacks)
 {
+    fs_result result;
     fs_mem_node* pNode;
     size_t cursor;
     size_t writeEndPosition;
@@ -945,6 +2066,27 @@ static fs_result fs_file_write_mem_nolock(fs_file_mem* pFileMem, const void* pSr
 
     /* Calculate the new file size after writing. */
     newSize = FS_MEM_MAX(pNode->data.file.size, writeEndPosition);
+
+    result = fs_mem_file_unshare(pNode, cursor, bytesToWrite, pAllocationCallbacks);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    if (pNode->data.file.chunkSize != 0) {
+
+        /* Any gap between the old size and the cursor is already zero. */
+        result = fs_mem_file_write_chunks(pNode, cursor, pSrc, bytesToWrite, pAllocationCallbacks);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        pNode->data.file.size = newSize;
+        pNode->data.file.modificationTime = time(NULL);
+        pFileMem->cursor = writeEndPosition;
+
+        *pBytesWritten = bytesToWrite;
+        return FS_SUCCESS;
+    }
     
     /* Check if we need to expand the buffer. */
     if (newSize > pNode->data.file.capacity) {
@@ -961,7 +2103,7 @@ static fs_result fs_file_write_mem_nolock(fs_file_mem* pFileMem, const void* pSr
             newCapacity = newSize;
         }
         
-        pNewData = fs_realloc(pNode->data.file.pData, newCapacity, pAllocationCallbacks);
+        pNewData = fs_mem_buffer_realloc(pNode->data.file.pData, newCapacity, pAllocationCallbacks);
         if (pNewData == NULL) {
             return FS_OUT_OF_MEMORY;
         }
@@ -995,6 +2137,7 @@ static fs_result fs_file_write_mem(fs_file* pFile, const void* pSrc, size_t byte
     fs_file_mem* pFileMem;
     fs_mem* pMem;
     fs_result result;
+    fs_bool32 isTreeLockedForWriting;
     
     pFileMem = (fs_file_mem*)fs_file_get_backend_data(pFile);
     FS_MEM_ASSERT(pFileMem != NULL);
@@ -1002,11 +2145,19 @@ static fs_result fs_file_write_mem(fs_file* pFile, const void* pSrc, size_t byte
     pMem = (fs_mem*)fs_get_backend_data(fs_file_get_fs(pFile));
     FS_MEM_ASSERT(pMem != NULL);
     
-    fs_mem_lock(pMem);
+    /* Checked up front so read-only files never cause a copy. */
+    if ((pFileMem->openMode & FS_WRITE) == 0) {
+        return FS_ACCESS_DENIED;
+    }
+
+    result = fs_mem_begin_file_write(pMem, pFileMem, &isTreeLockedForWriting, fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
+    if (result != FS_SUCCESS) {
+        return result;
+    }
     {
         result = fs_file_write_mem_nolock(pFileMem, pSrc, bytesToWrite, pBytesWritten, fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
     }
-    fs_mem_unlock(pMem);
+    fs_mem_end_file_write(pMem, pFileMem, isTreeLockedForWriting);
     
     return result;
 }
@@ -1060,11 +2211,13 @@ static fs_result fs_file_seek_mem(fs_file* pFile, fs_int64 offset, fs_seek_origi
     pMem = (fs_mem*)fs_get_backend_data(fs_file_get_fs(pFile));
     FS_MEM_ASSERT(pMem != NULL);
     
-    fs_mem_lock(pMem);
+    fs_mem_lock_read(pMem);
+    fs_mem_file_lock_read(pFileMem->pNode);
     {
         result = fs_file_seek_mem_nolock(pFileMem, offset, origin);
     }
-    fs_mem_unlock(pMem);
+    fs_mem_file_unlock_read(pFileMem->pNode);
+    fs_mem_unlock_read(pMem);
     
     return result;
 }
@@ -1112,10 +2265,35 @@ static fs_result fs_file_truncate_mem_nolock(fs_file_mem* pFileMem, const fs_all
 
     newSize = (size_t)pFileMem->cursor;
 
+    if (pNode->data.file.chunkSize != 0) {
+        /* Growing doesn't need to touch the chunks because anything past the end is already zero. */
+        if (newSize < pNode->data.file.size) {
+            /* Only the chunk the file now ends in is modified. Chunks past it are just released. */
+            fs_result result = fs_mem_file_unshare(pNode, newSize, ((newSize % pNode->data.file.chunkSize) != 0) ? 1 : 0, pAllocationCallbacks);
+            if (result != FS_SUCCESS) {
+                return result;
+            }
+
+            fs_mem_file_shrink_chunks(pNode, newSize, pAllocationCallbacks);
+        }
+
+        pNode->data.file.size = newSize;
+        pNode->data.file.modificationTime = time(NULL);
+
+        return FS_SUCCESS;
+    }
+
+    if (newSize > pNode->data.file.size) {
+        fs_result result = fs_mem_file_unshare(pNode, 0, newSize, pAllocationCallbacks);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+    }
+
     if (newSize > pNode->data.file.capacity) {
         void* pNewData;
 
-        pNewData = fs_realloc(pNode->data.file.pData, newSize, pAllocationCallbacks);
+        pNewData = fs_mem_buffer_realloc(pNode->data.file.pData, newSize, pAllocationCallbacks);
         if (pNewData == NULL) {
             return FS_OUT_OF_MEMORY;
         }
@@ -1140,6 +2318,7 @@ static fs_result fs_file_truncate_mem(fs_file* pFile)
     fs_file_mem* pFileMem;
     fs_mem* pMem;
     fs_result result;
+    fs_bool32 isTreeLockedForWriting;
     
     pFileMem = (fs_file_mem*)fs_file_get_backend_data(pFile);
     FS_MEM_ASSERT(pFileMem != NULL);
@@ -1147,11 +2326,19 @@ static fs_result fs_file_truncate_mem(fs_file* pFile)
     pMem = (fs_mem*)fs_get_backend_data(fs_file_get_fs(pFile));
     FS_MEM_ASSERT(pMem != NULL);
     
-    fs_mem_lock(pMem);
+    /* Checked up front so read-only files never cause a copy. */
+    if ((pFileMem->openMode & FS_WRITE) == 0) {
+        return FS_ACCESS_DENIED;
+    }
+
+    result = fs_mem_begin_file_write(pMem, pFileMem, &isTreeLockedForWriting, fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
+    if (result != FS_SUCCESS) {
+        return result;
+    }
     {
         result = fs_file_truncate_mem_nolock(pFileMem, fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
     }
-    fs_mem_unlock(pMem);
+    fs_mem_end_file_write(pMem, pFileMem, isTreeLockedForWriting);
     
     return result;
 }
@@ -1159,6 +2346,7 @@ static fs_result fs_file_truncate_mem(fs_file* pFile)
 static fs_result fs_file_info_mem(fs_file* pFile, fs_file_info* pInfo)
 {
     fs_file_mem* pFileMem;
+    fs_mem* pMem;
     fs_mem_node* pNode;
     
     if (pInfo == NULL) {
@@ -1172,27 +2360,98 @@ static fs_result fs_file_info_mem(fs_file* pFile, fs_file_info* pInfo)
     FS_MEM_ASSERT(pNode != NULL);
     FS_MEM_ASSERT(pNode->type == FS_MEM_NODE_TYPE_FILE);
     
+    pMem = (fs_mem*)fs_get_backend_data(fs_file_get_fs(pFile));
+    FS_MEM_ASSERT(pMem != NULL);
+    
     FS_MEM_ZERO_OBJECT(pInfo);
-    pInfo->size = pNode->data.file.size;
+
+    fs_mem_lock_read(pMem);
+    fs_mem_file_lock_read(pNode);
+    {
+        pInfo->size = pNode->data.file.size;
+    }
+    fs_mem_file_unlock_read(pNode);
+    fs_mem_unlock_read(pMem);
+
     pInfo->directory = 0;
     pInfo->symlink = 0;
     
     return FS_SUCCESS;
 }
 
+static fs_result fs_file_map_mem(fs_file* pFile, const void** ppData, size_t* pDataSize)
+{
+    fs_file_mem* pFileMem;
+    fs_mem* pMem;
+    fs_mem_node* pNode;
+    fs_result result = FS_SUCCESS;
+
+    pFileMem = (fs_file_mem*)fs_file_get_backend_data(pFile);
+    FS_MEM_ASSERT(pFileMem != NULL);
+
+    pMem = (fs_mem*)fs_get_backend_data(fs_file_get_fs(pFile));
+    FS_MEM_ASSERT(pMem != NULL);
+
+    pNode = pFileMem->pNode;
+    FS_MEM_ASSERT(pNode != NULL);
+
+    /*
+    The content is already in memory so we can just hand out a pointer to it, as long as it's all in
+    one place. The pointer is invalidated by anything that causes the content to be reallocated, just
+    like a real mapping when the underlying file is truncated.
+    */
+    fs_mem_lock_read(pMem);
+    fs_mem_file_lock_read(pNode);
+    {
+        if (pNode->data.file.size == 0) {
+            *ppData    = NULL;
+            *pDataSize = 0;
+        } else if (pNode->data.file.chunkSize == 0) {
+            *ppData    = pNode->data.file.pData;
+            *pDataSize = pNode->data.file.size;
+        } else if (pNode->data.file.size <= pNode->data.file.chunkSize && pNode->data.file.chunkCount > 0 && pNode->data.file.ppChunks[0] != NULL) {
+            *ppData    = pNode->data.file.ppChunks[0];
+            *pDataSize = pNode->data.file.size;
+        } else {
+            result = FS_NOT_IMPLEMENTED;    /* Spread across chunks. Let the core library read it into memory. */
+        }
+    }
+    fs_mem_file_unlock_read(pNode);
+    fs_mem_unlock_read(pMem);
+
+    return result;
+}
+
+static void fs_file_unmap_mem(fs_file* pFile, const void* pData, size_t dataSize)
+{
+    /* Nothing to do. The mapping points straight at the content. */
+    (void)pFile;
+    (void)pData;
+    (void)dataSize;
+}
+
 static fs_result fs_file_duplicate_mem(fs_file* pFile, fs_file* pDuplicate)
 {
     fs_file_mem* pFileMem;
     fs_file_mem* pDuplicateMem;
+    fs_mem* pMem;
     
     pFileMem = (fs_file_mem*)fs_file_get_backend_data(pFile);
     FS_MEM_ASSERT(pFileMem != NULL);
     
     pDuplicateMem = (fs_file_mem*)fs_file_get_backend_data(pDuplicate);
     FS_MEM_ASSERT(pDuplicateMem != NULL);
+
+    pMem = (fs_mem*)fs_get_backend_data(fs_file_get_fs(pFile));
+    FS_MEM_ASSERT(pMem != NULL);
     
-    /* Copy the file handle data. */
-    *pDuplicateMem = *pFileMem;
+    /* Copy the file handle data. The node can't be swapped for a copy while the tree is locked. */
+    fs_mem_lock_read(pMem);
+    {
+        *pDuplicateMem = *pFileMem;
+        fs_mem_add_file(pMem, pDuplicateMem);
+    }
+    fs_mem_unlock_read(pMem);
     
     return FS_SUCCESS;
 }
@@ -1200,6 +2459,7 @@ static fs_result fs_file_duplicate_mem(fs_file* pFile, fs_file* pDuplicate)
 
 static fs_iterator* fs_first_mem_nolock(fs* pFS, const char* pDirectoryPath, size_t pathLen)
 {
+    fs_mem* pMem = (fs_mem*)fs_get_backend_data(pFS);
     fs_mem_node* pDirectory;
     fs_iterator_mem* pIterator;
     fs_result result;
@@ -1232,6 +2492,13 @@ static fs_iterator* fs_first_mem_nolock(fs* pFS, const char* pDirectoryPath, siz
         pIterator->base.pFS = pFS;
         pIterator->pDirectory = pDirectory;
         pIterator->currentIndex = 0;
+
+        /* The directory could be replaced by a copy while iterating. The reference keeps this one alive. */
+        fs_mtx_lock(&pMem->pStore->lock);
+        {
+            pDirectory->refCount += 1;
+        }
+        fs_mtx_unlock(&pMem->pStore->lock);
         
         /* Copy name to the end of the structure. */
         FS_MEM_COPY_MEMORY((char*)pIterator + sizeof(fs_iterator_mem), pChild->pName, nameLen);
@@ -1243,7 +2510,12 @@ static fs_iterator* fs_first_mem_nolock(fs* pFS, const char* pDirectoryPath, siz
         
         /* Fill in file info. */
         if (pChild->type == FS_MEM_NODE_TYPE_FILE) {
-            pIterator->base.info.size = pChild->data.file.size;
+            fs_mem_file_lock_read(pChild);
+            {
+                pIterator->base.info.size = pChild->data.file.size;
+            }
+            fs_mem_file_unlock_read(pChild);
+
             pIterator->base.info.directory = 0;
         } else {
             pIterator->base.info.size = 0;
@@ -1261,16 +2533,25 @@ static fs_iterator* fs_first_mem(fs* pFS, const char* pDirectoryPath, size_t dir
     
     pMem = (fs_mem*)fs_get_backend_data(pFS);
 
-    fs_mem_lock(pMem);
+    fs_mem_lock_read(pMem);
     {
         pIterator = fs_first_mem_nolock(pFS, pDirectoryPath, directoryPathLen);
     }
-    fs_mem_unlock(pMem);
+    fs_mem_unlock_read(pMem);
     
     return pIterator;
 }
 
-static fs_iterator* fs_next_mem_nolock(fs_iterator_mem* pIteratorMem, const fs_allocation_callbacks* pAllocationCallbacks)
+static void fs_mem_iterator_release_directory(fs_mem* pMem, fs_iterator_mem* pIteratorMem, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_mtx_lock(&pMem->pStore->lock);
+    {
+        fs_mem_node_release(pMem->pStore, pIteratorMem->pDirectory, pAllocationCallbacks);
+    }
+    fs_mtx_unlock(&pMem->pStore->lock);
+}
+
+static fs_iterator* fs_next_mem_nolock(fs_mem* pMem, fs_iterator_mem* pIteratorMem, const fs_allocation_callbacks* pAllocationCallbacks)
 {
     fs_mem_node* pChild;
     fs_iterator_mem* pNewIterator;
@@ -1281,6 +2562,7 @@ static fs_iterator* fs_next_mem_nolock(fs_iterator_mem* pIteratorMem, const fs_a
     
     /* Check if we've reached the end. */
     if (pIteratorMem->currentIndex >= pIteratorMem->pDirectory->data.dir.childCount) {
+        fs_mem_iterator_release_directory(pMem, pIteratorMem, pAllocationCallbacks);
         fs_free(pIteratorMem, pAllocationCallbacks);
         return NULL;
     }
@@ -1292,6 +2574,7 @@ static fs_iterator* fs_next_mem_nolock(fs_iterator_mem* pIteratorMem, const fs_a
     /* Reallocate iterator with space for the new name. */
     pNewIterator = (fs_iterator_mem*)fs_realloc(pIteratorMem, sizeof(fs_iterator_mem) + nameLen + 1, pAllocationCallbacks);
     if (pNewIterator == NULL) {
+        fs_mem_iterator_release_directory(pMem, pIteratorMem, pAllocationCallbacks);
         fs_free(pIteratorMem, pAllocationCallbacks);
         return NULL;
     }
@@ -1306,7 +2589,12 @@ static fs_iterator* fs_next_mem_nolock(fs_iterator_mem* pIteratorMem, const fs_a
     
     /* Fill in file info. */
     if (pChild->type == FS_MEM_NODE_TYPE_FILE) {
-        pNewIterator->base.info.size      = pChild->data.file.size;
+        fs_mem_file_lock_read(pChild);
+        {
+            pNewIterator->base.info.size  = pChild->data.file.size;
+        }
+        fs_mem_file_unlock_read(pChild);
+
         pNewIterator->base.info.directory = 0;
     } else {
         pNewIterator->base.info.size      = 0;
@@ -1331,11 +2619,11 @@ static fs_iterator* fs_next_mem(fs_iterator* pIterator)
     pMem = (fs_mem*)fs_get_backend_data(pIterator->pFS);
     FS_MEM_ASSERT(pMem != NULL);
     
-    fs_mem_lock(pMem);
+    fs_mem_lock_read(pMem);
     {
-        pResult = fs_next_mem_nolock(pIteratorMem, fs_get_allocation_callbacks(pIterator->pFS));
+        pResult = fs_next_mem_nolock(pMem, pIteratorMem, fs_get_allocation_callbacks(pIterator->pFS));
     }
-    fs_mem_unlock(pMem);
+    fs_mem_unlock_read(pMem);
     
     return pResult;
 }
@@ -1349,6 +2637,8 @@ static void fs_free_iterator_mem(fs_iterator* pIterator)
     }
     
     pIteratorMem = (fs_iterator_mem*)pIterator;
+
+    fs_mem_iterator_release_directory((fs_mem*)fs_get_backend_data(pIterator->pFS), pIteratorMem, fs_get_allocation_callbacks(pIterator->pFS));
     
     /* Name is allocated as part of the iterator, so no separate free needed. */
     fs_free(pIteratorMem, fs_get_allocation_callbacks(pIterator->pFS));
@@ -1377,8 +2667,72 @@ static fs_backend fs_mem_backend =
     fs_file_duplicate_mem,
     fs_first_mem,
     fs_next_mem,
-    fs_free_iterator_mem
+    fs_free_iterator_mem,
+    NULL,   /* file_read_at */
+    NULL,   /* file_write_at */
+    fs_file_map_mem,
+    fs_file_unmap_mem,
+    NULL    /* first_ex */
 };
 const fs_backend* FS_MEM = &fs_mem_backend;
 
+
+FS_API fs_result fs_mem_snapshot(fs* pFS, fs** ppSnapshot)
+{
+    fs_result result;
+    fs_mem* pMem;
+    fs_mem* pSnapshotMem;
+    fs* pSnapshot;
+    fs_mem_config memConfig;
+    fs_config fsConfig;
+
+    if (ppSnapshot == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    *ppSnapshot = NULL;
+
+    if (pFS == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    pMem = (fs_mem*)fs_get_backend_data(pFS);
+    FS_MEM_ASSERT(pMem != NULL);
+
+    /* Content is freed by whichever of the two is uninitialized last so they need the same allocation callbacks. */
+    memConfig = fs_mem_config_init();
+    memConfig.chunkSize = pMem->chunkSize;
+
+    fsConfig = fs_config_init(FS_MEM, &memConfig, NULL);
+    fsConfig.pAllocationCallbacks = fs_get_allocation_callbacks(pFS);
+
+    result = fs_init(&fsConfig, &pSnapshot);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    pSnapshotMem = (fs_mem*)fs_get_backend_data(pSnapshot);
+    FS_MEM_ASSERT(pSnapshotMem != NULL);
+
+    /* The snapshot starts out with an empty tree of its own which is replaced with the one being snapshotted. */
+    fs_mem_release_tree(pSnapshotMem, fs_get_allocation_callbacks(pSnapshot));
+
+    fs_mem_lock_write(pMem);
+    {
+        pMem->pRoot->refCount  += 1;
+        pMem->pStore->refCount += 1;
+
+        pSnapshotMem->pRoot      = pMem->pRoot;
+        pSnapshotMem->pStore     = pMem->pStore;
+        pSnapshotMem->isSnapshot = FS_TRUE;
+
+        /* Everything that exists now is shared with the snapshot and needs to be copied before being modified. */
+        pMem->generation += 1;
+    }
+    fs_mem_unlock_write(pMem);
+
+    *ppSnapshot = pSnapshot;
+    return FS_SUCCESS;
+}
+
 #endif  /* fs_mem_c. */
@@ -5,6 +5,41 @@ This backend stores all files and directories in memory. This is useful for temp
 operations, testing, or when you need a virtual file system that doesn't persist to disk.
 
 This supports both reading and writing.
+
+You can pass in NULL for the backend config in fs_init(). Otherwise you can pass in a pointer to a
+fs_mem_config object:
+
+    fs_mem_config memConfig = fs_mem_config_init();
+    memConfig.chunkSize = 65536;
+
+    fs_config fsConfig = fs_config_init(FS_MEM, &memConfig, NULL);
+
+By default the content of each file is stored in a single buffer which is reallocated as the file
+grows. For large files this means copying the whole file every time the buffer needs to grow, and
+needing memory for both the old and new buffer while it does. Setting chunkSize stores files as a
+table of fixed size chunks instead. Growing a file only allocates new chunks and never moves the
+existing data, and writing to the middle of a file only touches the chunks it overlaps. Chunks
+that have never been written to are not allocated and read as zeros.
+
+fs_file_map() returns a pointer straight to the content of a file without copying it when the file
+is stored in a single buffer, or when the whole file fits in the first chunk. Larger chunked files
+fall back to being read into memory.
+
+A read-only snapshot of the whole file system can be taken with fs_mem_snapshot():
+
+    fs* pSnapshot;
+    fs_mem_snapshot(pFS, &pSnapshot);
+
+    ... read from pSnapshot while pFS continues to be modified ...
+
+    fs_uninit(pSnapshot);
+
+Taking a snapshot doesn't copy anything. The snapshot shares its files and directories with the
+original, and things are only copied when the original modifies them for the first time after the
+snapshot was taken. A modified file is copied as a whole when it's stored in a single buffer, but
+only the chunks that are written to are copied when it's stored in chunks. Snapshots can be
+uninitialized before or after the original. Anything that would modify a snapshot fails with
+FS_ACCESS_DENIED.
 */
 #ifndef fs_mem_h
 #define fs_mem_h
@@ -14,6 +49,19 @@ extern "C" {
 #endif
 
 /* BEG fs_mem.h */
+typedef struct fs_mem_config
+{
+    size_t chunkSize;   /* The size of each chunk when storing files as chunks. Set to 0 to store each file in a single buffer. */
+} fs_mem_config;
+
+FS_API fs_mem_config fs_mem_config_init(void);
+
+/*
+Creates a read-only snapshot of an FS_MEM file system. pFS must have been initialized with FS_MEM.
+Uninitialize the snapshot with fs_uninit() like any other file system.
+*/
+FS_API fs_result fs_mem_snapshot(fs* pFS, fs** ppSnapshot);
+
 extern const fs_backend* FS_MEM;
 /* END fs_mem.h */
 
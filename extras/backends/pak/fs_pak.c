@@ -635,7 +635,12 @@ fs_backend fs_pak_backend =
     fs_file_duplicate_pak,
     fs_first_pak,
     fs_next_pak,
-    fs_free_iterator_pak
+    fs_free_iterator_pak,
+    NULL,   /* file_read_at */
+    NULL,   /* file_write_at */
+    NULL,   /* file_map */
+    NULL,   /* file_unmap */
+    NULL    /* first_ex */
 };
 const fs_backend* FS_PAK = &fs_pak_backend;
 /* END fs_pak.c */
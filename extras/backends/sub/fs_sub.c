@@ -319,6 +319,41 @@ static fs_result fs_file_read_sub(fs_file* pFile, void* pDst, size_t bytesToRead
     return fs_file_read(pSubFSFile->pActualFile, pDst, bytesToRead, pBytesRead);
 }
 
+static fs_result fs_file_read_at_sub(fs_file* pFile, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    fs_file_sub* pSubFSFile = (fs_file_sub*)fs_file_get_backend_data(pFile);
+    FS_SUB_ASSERT(pSubFSFile != NULL);
+
+    return fs_stream_read_at(fs_file_get_stream(pSubFSFile->pActualFile), offset, pDst, bytesToRead, pBytesRead);
+}
+
+static fs_result fs_file_write_at_sub(fs_file* pFile, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    fs_file_sub* pSubFSFile = (fs_file_sub*)fs_file_get_backend_data(pFile);
+    FS_SUB_ASSERT(pSubFSFile != NULL);
+
+    return fs_stream_write_at(fs_file_get_stream(pSubFSFile->pActualFile), offset, pSrc, bytesToWrite, pBytesWritten);
+}
+
+static fs_result fs_file_map_sub(fs_file* pFile, const void** ppData, size_t* pDataSize)
+{
+    fs_file_sub* pSubFSFile = (fs_file_sub*)fs_file_get_backend_data(pFile);
+    FS_SUB_ASSERT(pSubFSFile != NULL);
+
+    return fs_file_map(pSubFSFile->pActualFile, ppData, pDataSize);
+}
+
+static void fs_file_unmap_sub(fs_file* pFile, const void* pData, size_t dataSize)
+{
+    fs_file_sub* pSubFSFile = (fs_file_sub*)fs_file_get_backend_data(pFile);
+    FS_SUB_ASSERT(pSubFSFile != NULL);
+
+    (void)pData;
+    (void)dataSize;
+
+    fs_file_unmap(pSubFSFile->pActualFile);
+}
+
 static fs_result fs_file_write_sub(fs_file* pFile, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
 {
     fs_file_sub* pSubFSFile = (fs_file_sub*)fs_file_get_backend_data(pFile);
@@ -381,7 +416,7 @@ static fs_result fs_file_duplicate_sub(fs_file* pFile, fs_file* pDuplicatedFile)
     return fs_file_duplicate(pSubFSFile->pActualFile, &pSubFSFileDuplicated->pActualFile);
 }
 
-static fs_iterator* fs_first_sub(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen)
+static fs_iterator* fs_first_ex_sub(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen, int mode)
 {
     fs_result result;
     fs_sub* pSubFS;
@@ -396,12 +431,17 @@ static fs_iterator* fs_first_sub(fs* pFS, const char* pDirectoryPath, size_t dir
         return NULL;
     }
 
-    pIterator = fs_first_ex(pSubFS->pOwnerFS, subPath.pFullPath, subPath.fullPathLen, 0);   /* TODO: Should we make the mode configurable somehow? Maybe an option in fs_sub_config? */
+    pIterator = fs_first_ex(pSubFS->pOwnerFS, subPath.pFullPath, subPath.fullPathLen, mode & FS_NAMES_ONLY);   /* TODO: Should we make the rest of the mode configurable somehow? Maybe an option in fs_sub_config? */
     fs_sub_path_uninit(&subPath, fs_get_allocation_callbacks(pFS));
 
     return pIterator;
 }
 
+static fs_iterator* fs_first_sub(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen)
+{
+    return fs_first_ex_sub(pFS, pDirectoryPath, directoryPathLen, 0);
+}
+
 static fs_iterator* fs_next_sub(fs_iterator* pIterator)
 {
     fs* pSubFSObject;
@@ -464,7 +504,12 @@ fs_backend fs_sub_backend =
     fs_file_duplicate_sub,
     fs_first_sub,
     fs_next_sub,
-    fs_free_iterator_sub
+    fs_free_iterator_sub,
+    fs_file_read_at_sub,
+    fs_file_write_at_sub,
+    fs_file_map_sub,
+    fs_file_unmap_sub,
+    fs_first_ex_sub
 };
 const fs_backend* FS_SUB = &fs_sub_backend;
 /* END fs_sub.c */
@@ -9,6 +9,30 @@
 #include <stdlib.h>
 #include <string.h>
 
+/*
+CRC-32 verification can use PCLMULQDQ on x64. Support is checked at run time so this only needs the
+compiler to be able to target it. Define FS_ZIP_NO_SIMD to disable this.
+*/
+#if !defined(FS_ZIP_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define FS_ZIP_SUPPORTS_PCLMUL
+        #define FS_ZIP_PCLMUL_TARGET
+    #elif defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+        #define FS_ZIP_SUPPORTS_PCLMUL
+        #define FS_ZIP_PCLMUL_TARGET __attribute__((target("sse2,pclmul")))
+    #endif
+#endif
+
+#if defined(FS_ZIP_SUPPORTS_PCLMUL)
+    #include <emmintrin.h>
+    #include <wmmintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
 static void fs_zip_zero_memory_default(void* p, size_t sz)
 {
     if (sz > 0) {
@@ -96,7 +120,11 @@ enum
     FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1 = 32,
     FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_2 = 19,
     FS_ZIP_DEFLATE_FAST_LOOKUP_BITS   = 10,
-    FS_ZIP_DEFLATE_FAST_LOOKUP_SIZE   = 1 << FS_ZIP_DEFLATE_FAST_LOOKUP_BITS
+    FS_ZIP_DEFLATE_FAST_LOOKUP_SIZE   = 1 << FS_ZIP_DEFLATE_FAST_LOOKUP_BITS,
+    FS_ZIP_DEFLATE_FAST_LITLEN_BITS   = 11,
+    FS_ZIP_DEFLATE_FAST_LITLEN_SIZE   = 1 << FS_ZIP_DEFLATE_FAST_LITLEN_BITS,
+    FS_ZIP_DEFLATE_FAST_DIST_BITS     = 8,
+    FS_ZIP_DEFLATE_FAST_DIST_SIZE     = 1 << FS_ZIP_DEFLATE_FAST_DIST_BITS
 };
 
 typedef struct
@@ -131,10 +159,57 @@ typedef struct fs_zip_deflate_decompressor
     fs_zip_deflate_huff_table tables[FS_ZIP_DEFLATE_MAX_HUFF_TABLES];
     fs_uint8 rawHeader[4];
     fs_uint8 lenCodes[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0 + FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1 + 137];
+#ifdef FS_64BIT
+    fs_uint32 fastLitLen[FS_ZIP_DEFLATE_FAST_LITLEN_SIZE];  /* Used by the fast path. See fs_zip_deflate_build_fast_tables(). */
+    fs_uint32 fastDist[FS_ZIP_DEFLATE_FAST_DIST_SIZE];
+#endif
 } fs_zip_deflate_decompressor;
 
 FS_API fs_result fs_zip_deflate_decompressor_init(fs_zip_deflate_decompressor* pDecompressor);
 FS_API fs_result fs_zip_deflate_decompress(fs_zip_deflate_decompressor* pDecompressor, const fs_uint8* pInputBuffer, size_t* pInputBufferSize, fs_uint8* pOutputBufferStart, fs_uint8* pOutputBufferNext, size_t* pOutputBufferSize, fs_uint32 flags);
+
+
+enum
+{
+    FS_ZIP_DEFLATE_MAX_LEVEL          = 9,
+    FS_ZIP_DEFLATE_WINDOW_SIZE        = 32768,
+    FS_ZIP_DEFLATE_HASH_BITS          = 15,
+    FS_ZIP_DEFLATE_HASH_SIZE          = 1 << FS_ZIP_DEFLATE_HASH_BITS,
+    FS_ZIP_DEFLATE_BLOCK_SYMBOL_COUNT = 16384,
+    FS_ZIP_DEFLATE_MAX_INPUT_SIZE     = 0x40000000
+};
+
+typedef struct fs_zip_deflate_compressor
+{
+    fs_uint32 hashHead[FS_ZIP_DEFLATE_HASH_SIZE];    /* The most recent position of each hash. Positions below positionBase are from an earlier call and are ignored. */
+    fs_uint32 hashPrev[FS_ZIP_DEFLATE_WINDOW_SIZE];  /* The previous position with the same hash, indexed by the position modulo the window size. */
+    fs_uint32 positionBase;
+    fs_uint16 symbolLitLen[FS_ZIP_DEFLATE_BLOCK_SYMBOL_COUNT];  /* Literals are 0-255. Matches are 256 plus the length minus 3. */
+    fs_uint16 symbolDist[FS_ZIP_DEFLATE_BLOCK_SYMBOL_COUNT];    /* The distance minus 1 of matches. */
+    fs_uint32 symbolCount;
+    size_t blockInputSize;      /* The number of input bytes covered by the symbols of the current block. */
+    fs_uint32 litLenFreq[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0];
+    fs_uint32 distFreq[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1];
+    fs_uint8 litLenCodeSize[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0];
+    fs_uint16 litLenCode[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0];
+    fs_uint8 distCodeSize[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1];
+    fs_uint16 distCode[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1];
+    fs_uint8 fixedLitLenCodeSize[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0];
+    fs_uint16 fixedLitLenCode[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0];
+    fs_uint8 fixedDistCodeSize[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1];
+    fs_uint16 fixedDistCode[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1];
+    fs_uint8 lengthSymbol[256];     /* Maps a length minus 3 to its length code minus 257. */
+    fs_uint8 distSymbol[512];       /* Maps a distance minus 1 to its distance code. Distances above 256 are looked up in the upper half by dividing by 128. */
+    fs_uint32 bitBuffer;
+    fs_uint32 bitCount;
+    fs_uint8* pOutput;
+    size_t outputSize;
+    size_t outputCap;
+} fs_zip_deflate_compressor;
+
+FS_API fs_result fs_zip_deflate_compressor_init(fs_zip_deflate_compressor* pCompressor);
+FS_API size_t fs_zip_deflate_compress_bound(size_t inputSize);
+FS_API fs_result fs_zip_deflate_compress(fs_zip_deflate_compressor* pCompressor, int level, const fs_uint8* pInput, size_t dictionarySize, size_t inputSize, fs_bool32 isFinal, fs_uint8* pOutput, size_t outputCap, size_t* pOutputSize);
 /* END fs_zip_deflate.h */
 
 
@@ -237,6 +312,436 @@ The slow path is only executed at the very end of the input buffer.
     } sym = temp; bitBuffer >>= codeLen; bitCount -= codeLen; } FS_ZIP_DEFLATE_MACRO_END
 
 
+/*
+On 64-bit builds there is a fast path which is used for the bulk of each Huffman block. It only runs
+while there is plenty of input and output space available, and it never returns to the caller part
+way through a symbol. Anything unusual (the end of the block, an invalid code, running low on space)
+is left for the slow path by rewinding to the start of the symbol and returning. Everything near the
+end of the buffers is therefore handled by the bounds checked slow path which is unchanged.
+
+The bit buffer is refilled a whole word at a time without branching. The refill loads an entire word
+from the input but only advances the input pointer by the number of whole bytes that fit. The bits of
+the partially consumed byte end up in the bit buffer above bitCount, but they will be identical to the
+bits that get loaded by the next refill so it doesn't matter.
+
+Each entry in the fast literal/length and distance tables is laid out like this:
+
+    bits 0-7    The total number of bits to consume. This includes the extra bits of length and
+                distance codes, and both codes when the entry holds two literals.
+    bits 8-11   The length of the Huffman code. This is where the extra bits start.
+    bit  12     The code is too long for the table and needs to be decoded with the regular tree.
+    bit  13     A length or a distance.
+    bit  14     There is a second literal.
+    bit  15     A literal.
+    bits 16-31  The base length or distance, or the literals with the first one in bits 16-23.
+
+An entry of zero means the slow path needs to be used.
+*/
+#ifdef FS_64BIT
+#define FS_ZIP_DEFLATE_FAST_FLAG_LONG       0x1000
+#define FS_ZIP_DEFLATE_FAST_FLAG_MATCH      0x2000
+#define FS_ZIP_DEFLATE_FAST_FLAG_LITERAL2   0x4000
+#define FS_ZIP_DEFLATE_FAST_FLAG_LITERAL    0x8000
+
+#define FS_ZIP_DEFLATE_FAST_ENTRY(bits, codeLen, flags, value)  ((fs_uint32)(bits) | ((fs_uint32)(codeLen) << 8) | (fs_uint32)(flags) | ((fs_uint32)(value) << 16))
+#define FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry)                   ((entry) & 0xFF)
+#define FS_ZIP_DEFLATE_FAST_ENTRY_CODE_LEN(entry)               (((entry) >> 8) & 0xF)
+#define FS_ZIP_DEFLATE_FAST_ENTRY_VALUE(entry)                  ((entry) >> 16)
+
+/* Decodes a length or distance entry. The bit buffer needs to be the one from before the entry was consumed. */
+#define FS_ZIP_DEFLATE_FAST_ENTRY_DECODE(entry, bitBuffer)      (FS_ZIP_DEFLATE_FAST_ENTRY_VALUE(entry) + (fs_uint32)(((bitBuffer) & ((((fs_zip_deflate_bitbuf)1) << FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry)) - 1)) >> FS_ZIP_DEFLATE_FAST_ENTRY_CODE_LEN(entry)))
+
+/*
+One iteration of the fast path consumes at most 60 bits, and each refill loads a whole word. Matches
+can be written up to FS_ZIP_DEFLATE_FAST_OVERRUN bytes past their end.
+*/
+#define FS_ZIP_DEFLATE_FAST_OVERRUN         16
+#define FS_ZIP_DEFLATE_FAST_INPUT_MARGIN    32
+#define FS_ZIP_DEFLATE_FAST_OUTPUT_MARGIN   (258 + FS_ZIP_DEFLATE_FAST_OVERRUN)
+
+#define FS_ZIP_DEFLATE_FAST_REFILL() do { \
+    bitBuffer |= FS_ZIP_READ_LE64(pInputBufferCurrent) << bitCount; \
+    pInputBufferCurrent += (63 - bitCount) >> 3; \
+    bitCount |= 56; \
+} FS_ZIP_DEFLATE_MACRO_END
+
+static void fs_zip_deflate_build_fast_table(fs_uint32* pTable, unsigned int tableBits, const fs_uint8* pCodeSizes, unsigned int symbolCount, const fs_uint32* pSymbolEntries)
+{
+    unsigned int totalSyms[16];
+    unsigned int nextCode[17];
+    unsigned int total;
+    unsigned int i;
+    unsigned int symIndex;
+    unsigned int tableSize = 1U << tableBits;
+
+    FS_ZIP_ZERO_MEMORY(pTable, sizeof(*pTable) * tableSize);
+    FS_ZIP_ZERO_MEMORY(totalSyms, sizeof(totalSyms));
+
+    for (i = 0; i < symbolCount; ++i) {
+        totalSyms[pCodeSizes[i]]++;
+    }
+
+    total = 0;
+    nextCode[0] = nextCode[1] = 0;
+    for (i = 1; i <= 15; ++i) {
+        nextCode[i + 1] = (total = ((total + totalSyms[i]) << 1));
+    }
+
+    for (symIndex = 0; symIndex < symbolCount; ++symIndex) {
+        unsigned int codeSize = pCodeSizes[symIndex];
+        unsigned int curCode;
+        unsigned int revCode = 0;
+        unsigned int l;
+
+        if (codeSize == 0) {
+            continue;
+        }
+
+        curCode = nextCode[codeSize]++;
+        for (l = codeSize; l > 0; l--, curCode >>= 1) {
+            revCode = (revCode << 1) | (curCode & 1);
+        }
+
+        if (codeSize <= tableBits) {
+            /* The symbol entry has the number of extra bits in the bit count. The code length gets added to it. */
+            fs_uint32 entry = (pSymbolEntries[symIndex] != 0) ? (pSymbolEntries[symIndex] + codeSize + (codeSize << 8)) : 0;
+
+            while (revCode < tableSize) {
+                pTable[revCode] = entry;
+                revCode += (1U << codeSize);
+            }
+        } else {
+            pTable[revCode & (tableSize - 1)] = FS_ZIP_DEFLATE_FAST_FLAG_LONG;
+        }
+    }
+}
+
+static void fs_zip_deflate_build_fast_tables(fs_zip_deflate_decompressor* pDecompressor, const int* pLengthBase, const int* pLengthExtra, const int* pDistBase, const int* pDistExtra)
+{
+    fs_uint32 symbolEntries[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0];
+    unsigned int i;
+
+    /* Literals and lengths. The end of block code and invalid codes are left for the slow path. */
+    for (i = 0; i < 256; ++i) {
+        symbolEntries[i] = FS_ZIP_DEFLATE_FAST_ENTRY(0, 0, FS_ZIP_DEFLATE_FAST_FLAG_LITERAL, i);
+    }
+
+    symbolEntries[256] = 0;
+
+    for (i = 257; i < FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0; ++i) {
+        if (pLengthBase[i - 257] != 0) {
+            symbolEntries[i] = FS_ZIP_DEFLATE_FAST_ENTRY(pLengthExtra[i - 257], 0, FS_ZIP_DEFLATE_FAST_FLAG_MATCH, pLengthBase[i - 257]);
+        } else {
+            symbolEntries[i] = 0;
+        }
+    }
+
+    fs_zip_deflate_build_fast_table(pDecompressor->fastLitLen, FS_ZIP_DEFLATE_FAST_LITLEN_BITS, pDecompressor->tables[0].codeSize, pDecompressor->tableSizes[0], symbolEntries);
+
+    /*
+    Pair up literals. If the bits remaining in the index after the first literal are enough to fully
+    decode a second literal, both can be output with a single lookup. This is done in reverse so the
+    entry for the second literal is always read before it has been changed.
+    */
+    for (i = FS_ZIP_DEFLATE_FAST_LITLEN_SIZE; i > 0; --i) {
+        fs_uint32 entry = pDecompressor->fastLitLen[i - 1];
+        fs_uint32 nextEntry;
+        unsigned int bits;
+
+        if ((entry & FS_ZIP_DEFLATE_FAST_FLAG_LITERAL) == 0) {
+            continue;
+        }
+
+        bits = FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry);
+        nextEntry = pDecompressor->fastLitLen[(i - 1) >> bits];
+
+        if ((nextEntry & FS_ZIP_DEFLATE_FAST_FLAG_LITERAL) != 0 && (bits + FS_ZIP_DEFLATE_FAST_ENTRY_BITS(nextEntry)) <= FS_ZIP_DEFLATE_FAST_LITLEN_BITS) {
+            pDecompressor->fastLitLen[i - 1] = FS_ZIP_DEFLATE_FAST_ENTRY(bits + FS_ZIP_DEFLATE_FAST_ENTRY_BITS(nextEntry), 0, FS_ZIP_DEFLATE_FAST_FLAG_LITERAL | FS_ZIP_DEFLATE_FAST_FLAG_LITERAL2, (FS_ZIP_DEFLATE_FAST_ENTRY_VALUE(entry) & 0xFF) | ((FS_ZIP_DEFLATE_FAST_ENTRY_VALUE(nextEntry) & 0xFF) << 8));
+        }
+    }
+
+    /* Distances. */
+    for (i = 0; i < FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1; ++i) {
+        if (pDistBase[i] != 0) {
+            symbolEntries[i] = FS_ZIP_DEFLATE_FAST_ENTRY(pDistExtra[i], 0, FS_ZIP_DEFLATE_FAST_FLAG_MATCH, pDistBase[i]);
+        } else {
+            symbolEntries[i] = 0;
+        }
+    }
+
+    fs_zip_deflate_build_fast_table(pDecompressor->fastDist, FS_ZIP_DEFLATE_FAST_DIST_BITS, pDecompressor->tables[1].codeSize, pDecompressor->tableSizes[1], symbolEntries);
+}
+
+/* Decodes a code that is too long for the fast table. The bit buffer must have at least 15 bits. */
+static unsigned int fs_zip_deflate_decode_long(const fs_zip_deflate_huff_table* pHuff, fs_zip_deflate_bitbuf bitBuffer, unsigned int* pCodeLen)
+{
+    int temp;
+    unsigned int codeLen;
+
+    if ((temp = pHuff->lookup[bitBuffer & (FS_ZIP_DEFLATE_FAST_LOOKUP_SIZE - 1)]) >= 0) {
+        codeLen = temp >> 9;
+        temp &= 511;
+    } else {
+        codeLen = FS_ZIP_DEFLATE_FAST_LOOKUP_BITS;
+
+        do {
+            temp = pHuff->tree[~temp + ((bitBuffer >> codeLen++) & 1)];
+        } while (temp < 0);
+    }
+
+    *pCodeLen = codeLen;
+    return (unsigned int)temp;
+}
+
+/*
+Copies a match where the source and destination are `gap` bytes apart. The source can be either side
+of the destination. When the source is behind and overlaps with the destination, the bytes being read
+were output earlier in the same match, which is how runs are encoded. This never writes past the end
+of the match.
+*/
+static FS_INLINE void fs_zip_deflate_copy_match(fs_uint8* pDst, const fs_uint8* pSrc, fs_uint32 length, size_t gap)
+{
+    if (gap >= 8 && length >= 8) {
+        fs_uint64 word;
+        fs_uint32 i;
+
+        /* The last word is aligned to the end of the match and overlaps with the previous one. */
+        for (i = 0; i + 8 <= length; i += 8) {
+            FS_ZIP_COPY_MEMORY(&word, pSrc + i, 8);
+            FS_ZIP_COPY_MEMORY(pDst + i, &word, 8);
+        }
+
+        if (i < length) {
+            FS_ZIP_COPY_MEMORY(&word, pSrc + length - 8, 8);
+            FS_ZIP_COPY_MEMORY(pDst + length - 8, &word, 8);
+        }
+    } else if (pSrc + 1 == pDst) {
+        memset(pDst, pSrc[0], length);
+    } else {
+        fs_uint32 i;
+
+        for (i = 0; i < length; i += 1) {
+            pDst[i] = pSrc[i];
+        }
+    }
+}
+
+/*
+The same as fs_zip_deflate_copy_match(), except it can write up to FS_ZIP_DEFLATE_FAST_OVERRUN bytes past
+the end of the match which means short matches don't need to look at the length.
+*/
+static FS_INLINE void fs_zip_deflate_copy_match_overrun(fs_uint8* pDst, const fs_uint8* pSrc, fs_uint32 length, size_t gap)
+{
+    fs_uint64 word;
+    fs_uint32 i;
+
+    if (gap >= 8) {
+        FS_ZIP_COPY_MEMORY(&word, pSrc + 0, 8);
+        FS_ZIP_COPY_MEMORY(pDst + 0, &word, 8);
+        FS_ZIP_COPY_MEMORY(&word, pSrc + 8, 8);
+        FS_ZIP_COPY_MEMORY(pDst + 8, &word, 8);
+
+        for (i = 16; i < length; i += 8) {
+            FS_ZIP_COPY_MEMORY(&word, pSrc + i, 8);
+            FS_ZIP_COPY_MEMORY(pDst + i, &word, 8);
+        }
+    } else if (gap == 1) {
+        word  = pSrc[0];
+        word |= word << 8;
+        word |= word << 16;
+        word |= word << 32;
+
+        for (i = 0; i < length; i += 8) {
+            FS_ZIP_COPY_MEMORY(pDst + i, &word, 8);
+        }
+    } else {
+        for (i = 0; i < length; i += 1) {
+            pDst[i] = pSrc[i];
+        }
+    }
+}
+
+static void fs_zip_deflate_decompress_fast(fs_zip_deflate_decompressor* pDecompressor, const fs_uint8** ppInputBufferCurrent, const fs_uint8* pInputBufferEnd, fs_uint8* pOutputBufferStart, fs_uint8** ppOutputBufferCurrent, fs_uint8* pOutputBufferEnd, size_t outputBufferSizeMask, fs_uint32 flags, fs_zip_deflate_bitbuf* pBitBuffer, fs_uint32* pBitCount, const int* pLengthBase, const int* pLengthExtra, const int* pDistBase, const int* pDistExtra)
+{
+    const fs_uint8* pInputBufferCurrent = *ppInputBufferCurrent;
+    fs_uint8* pOutputBufferCurrent = *ppOutputBufferCurrent;
+    fs_zip_deflate_bitbuf bitBuffer = *pBitBuffer;
+    fs_uint32 bitCount = *pBitCount;
+    fs_bool32 canOverrun;
+
+    /*
+    Writing past the end of a match is fine when the output buffer isn't wrapping because everything
+    after the output pointer is free space. With a wrapping buffer, what comes after the output pointer
+    is the oldest part of the window, which can only be overwritten if the buffer is bigger than the
+    largest possible distance.
+    */
+    if (flags & FS_ZIP_DEFLATE_FLAG_USING_NON_WRAPPING_OUTPUT_BUF) {
+        canOverrun = FS_TRUE;
+    } else {
+        canOverrun = (outputBufferSizeMask + 1) >= (size_t)(((flags & FS_ZIP_DEFLATE_FLAG_DEFLATE64) ? 65536 : 32768) + FS_ZIP_DEFLATE_FAST_OVERRUN);
+    }
+
+    while ((pInputBufferEnd - pInputBufferCurrent) >= FS_ZIP_DEFLATE_FAST_INPUT_MARGIN && (pOutputBufferEnd - pOutputBufferCurrent) >= FS_ZIP_DEFLATE_FAST_OUTPUT_MARGIN) {
+        const fs_uint8* pSymbolInput = pInputBufferCurrent;
+        fs_zip_deflate_bitbuf symbolBitBuffer = bitBuffer;
+        fs_uint32 symbolBitCount = bitCount;
+        fs_zip_deflate_bitbuf savedBitBuffer;
+        fs_uint32 entry;
+        fs_uint32 length;
+        fs_uint32 dist;
+        size_t distFromOutBufStart;
+        unsigned int codeLen;
+        unsigned int sym;
+
+        FS_ZIP_DEFLATE_FAST_REFILL();
+        entry = pDecompressor->fastLitLen[bitBuffer & (FS_ZIP_DEFLATE_FAST_LITLEN_SIZE - 1)];
+
+        if (entry & FS_ZIP_DEFLATE_FAST_FLAG_LITERAL) {
+            /* A refill always has enough bits for four entries so keep going for as long as there are literals. */
+            int literalCount = 0;
+
+            do {
+                bitBuffer >>= FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry);
+                bitCount  -= FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry);
+
+                pOutputBufferCurrent[0] = (fs_uint8)(entry >> 16);
+                if (canOverrun) {
+                    pOutputBufferCurrent[1] = (fs_uint8)(entry >> 24);
+                    pOutputBufferCurrent += 1 + ((entry & FS_ZIP_DEFLATE_FAST_FLAG_LITERAL2) != 0);
+                } else if (entry & FS_ZIP_DEFLATE_FAST_FLAG_LITERAL2) {
+                    pOutputBufferCurrent[1] = (fs_uint8)(entry >> 24);
+                    pOutputBufferCurrent += 2;
+                } else {
+                    pOutputBufferCurrent += 1;
+                }
+
+                entry = pDecompressor->fastLitLen[bitBuffer & (FS_ZIP_DEFLATE_FAST_LITLEN_SIZE - 1)];
+            } while ((entry & FS_ZIP_DEFLATE_FAST_FLAG_LITERAL) != 0 && ++literalCount < 4);
+
+            continue;
+        }
+
+        /* Length. */
+        savedBitBuffer = bitBuffer;
+
+        if (entry & FS_ZIP_DEFLATE_FAST_FLAG_MATCH) {
+            bitBuffer >>= FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry);
+            bitCount  -= FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry);
+            length = FS_ZIP_DEFLATE_FAST_ENTRY_DECODE(entry, savedBitBuffer);
+        } else if (entry & FS_ZIP_DEFLATE_FAST_FLAG_LONG) {
+            sym = fs_zip_deflate_decode_long(&pDecompressor->tables[0], bitBuffer, &codeLen);
+            bitBuffer >>= codeLen;
+            bitCount  -= codeLen;
+
+            if (sym < 256) {
+                *pOutputBufferCurrent++ = (fs_uint8)sym;
+                continue;
+            }
+
+            if (sym == 256 || sym >= 286 || pLengthBase[sym - 257] == 0) {
+                goto rewind;
+            }
+
+            length = pLengthBase[sym - 257] + (fs_uint32)(bitBuffer & ((((fs_zip_deflate_bitbuf)1) << pLengthExtra[sym - 257]) - 1));
+            bitBuffer >>= pLengthExtra[sym - 257];
+            bitCount  -= pLengthExtra[sym - 257];
+        } else {
+            goto rewind;    /* End of block or an invalid code. */
+        }
+
+        /*
+        The output margin only covers the longest DEFLATE match. Length symbol 285 in DEFLATE64 has 16
+        extra bits which allows matches of up to 65538 bytes. Those are left to the slow path.
+        */
+        if (length > 258 || (size_t)(pOutputBufferEnd - pOutputBufferCurrent) < length + FS_ZIP_DEFLATE_FAST_OVERRUN) {
+            goto rewind;
+        }
+
+        /* Distance. This can need up to 15 bits for the code and 14 extra bits. */
+        if (bitCount < 29) {
+            FS_ZIP_DEFLATE_FAST_REFILL();
+        }
+
+        entry = pDecompressor->fastDist[bitBuffer & (FS_ZIP_DEFLATE_FAST_DIST_SIZE - 1)];
+        savedBitBuffer = bitBuffer;
+
+        if (entry & FS_ZIP_DEFLATE_FAST_FLAG_MATCH) {
+            bitBuffer >>= FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry);
+            bitCount  -= FS_ZIP_DEFLATE_FAST_ENTRY_BITS(entry);
+            dist = FS_ZIP_DEFLATE_FAST_ENTRY_DECODE(entry, savedBitBuffer);
+        } else if (entry & FS_ZIP_DEFLATE_FAST_FLAG_LONG) {
+            sym = fs_zip_deflate_decode_long(&pDecompressor->tables[1], bitBuffer, &codeLen);
+            bitBuffer >>= codeLen;
+            bitCount  -= codeLen;
+
+            if (sym >= FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1 || pDistBase[sym] == 0) {
+                goto rewind;
+            }
+
+            dist = pDistBase[sym] + (fs_uint32)(bitBuffer & ((((fs_zip_deflate_bitbuf)1) << pDistExtra[sym]) - 1));
+            bitBuffer >>= pDistExtra[sym];
+            bitCount  -= pDistExtra[sym];
+        } else {
+            goto rewind;
+        }
+
+        /* Copy the match. */
+        distFromOutBufStart = (size_t)(pOutputBufferCurrent - pOutputBufferStart);
+
+        if (dist <= distFromOutBufStart) {
+            if (canOverrun) {
+                fs_zip_deflate_copy_match_overrun(pOutputBufferCurrent, pOutputBufferCurrent - dist, length, dist);
+            } else {
+                fs_zip_deflate_copy_match(pOutputBufferCurrent, pOutputBufferCurrent - dist, length, dist);
+            }
+        } else {
+            /*
+            The source is on the other side of the wrapping point of the output buffer, which puts it
+            ahead of the output pointer. The output buffer always finishes at the end of the window so
+            the match needs to be split if the source wraps back around to the start.
+            */
+            const fs_uint8* pSrc;
+            size_t bytesBeforeWrap;
+
+            if (flags & FS_ZIP_DEFLATE_FLAG_USING_NON_WRAPPING_OUTPUT_BUF) {
+                goto rewind;
+            }
+
+            pSrc = pOutputBufferStart + ((distFromOutBufStart - dist) & outputBufferSizeMask);
+            bytesBeforeWrap = (size_t)((pOutputBufferStart + outputBufferSizeMask + 1) - pSrc);
+
+            if (canOverrun && bytesBeforeWrap >= length + FS_ZIP_DEFLATE_FAST_OVERRUN) {
+                fs_zip_deflate_copy_match_overrun(pOutputBufferCurrent, pSrc, length, (size_t)(pSrc - pOutputBufferCurrent));
+            } else if (bytesBeforeWrap >= length) {
+                fs_zip_deflate_copy_match(pOutputBufferCurrent, pSrc, length, (size_t)(pSrc - pOutputBufferCurrent));
+            } else {
+                fs_zip_deflate_copy_match(pOutputBufferCurrent, pSrc, (fs_uint32)bytesBeforeWrap, (size_t)(pSrc - pOutputBufferCurrent));
+                fs_zip_deflate_copy_match(pOutputBufferCurrent + bytesBeforeWrap, pOutputBufferStart, length - (fs_uint32)bytesBeforeWrap, dist);
+            }
+        }
+
+        pOutputBufferCurrent += length;
+        continue;
+
+    rewind:
+        pInputBufferCurrent = pSymbolInput;
+        bitBuffer = symbolBitBuffer;
+        bitCount  = symbolBitCount;
+        break;
+    }
+
+    /* Anything above bitCount is from a partially consumed byte and needs to be cleared for the slow path. */
+    if (bitCount < 64) {
+        bitBuffer &= (((fs_zip_deflate_bitbuf)1) << bitCount) - 1;
+    }
+
+    *ppInputBufferCurrent  = pInputBufferCurrent;
+    *ppOutputBufferCurrent = pOutputBufferCurrent;
+    *pBitBuffer = bitBuffer;
+    *pBitCount  = bitCount;
+}
+#endif  /* FS_64BIT */
+
 #define fs_zip_deflate_init(r) do { (r)->state = 0; } FS_ZIP_DEFLATE_MACRO_END
 #define fs_zip_deflate_get_adler32(r) (r)->checkAdler32
 
@@ -557,9 +1062,33 @@ FS_API fs_result fs_zip_deflate_decompress(fs_zip_deflate_decompressor* pDecompr
                     FS_ZIP_COPY_MEMORY(pDecompressor->tables[0].codeSize, pDecompressor->lenCodes, pDecompressor->tableSizes[0]); FS_ZIP_COPY_MEMORY(pDecompressor->tables[1].codeSize, pDecompressor->lenCodes + pDecompressor->tableSizes[0], pDecompressor->tableSizes[1]);
                 }
             }
+
+#ifdef FS_64BIT
+            if (flags & FS_ZIP_DEFLATE_FLAG_DEFLATE64) {
+                fs_zip_deflate_build_fast_tables(pDecompressor, sLengthBase64, sLengthExtra64, sDistBase64, sDistExtra64);
+            } else {
+                fs_zip_deflate_build_fast_tables(pDecompressor, sLengthBase, sLengthExtra, sDistBase, sDistExtra);
+            }
+#endif
+
             for (;;) {
                 fs_uint8 *pSrc;
+
                 for (;;) {
+#ifdef FS_64BIT
+                    /*
+                    The fast path does the bulk of the work. It'll stop when it gets close to the end of either buffer or at the end of the
+                    block. This is checked on every symbol so we can get back into the fast path as soon as more input has been supplied.
+                    */
+                    if ((pInputBufferEnd - pInputBufferCurrent) >= FS_ZIP_DEFLATE_FAST_INPUT_MARGIN && (pOutputBufferEnd - pOutputBufferCurrent) >= FS_ZIP_DEFLATE_FAST_OUTPUT_MARGIN) {
+                        if (flags & FS_ZIP_DEFLATE_FLAG_DEFLATE64) {
+                            fs_zip_deflate_decompress_fast(pDecompressor, &pInputBufferCurrent, pInputBufferEnd, pOutputBufferStart, &pOutputBufferCurrent, pOutputBufferEnd, outputBufferSizeMask, flags, &bitBuffer, &bitCount, sLengthBase64, sLengthExtra64, sDistBase64, sDistExtra64);
+                        } else {
+                            fs_zip_deflate_decompress_fast(pDecompressor, &pInputBufferCurrent, pInputBufferEnd, pOutputBufferStart, &pOutputBufferCurrent, pOutputBufferEnd, outputBufferSizeMask, flags, &bitBuffer, &bitCount, sLengthBase, sLengthExtra, sDistBase, sDistExtra);
+                        }
+                    }
+#endif
+
                     if (((pInputBufferEnd - pInputBufferCurrent) < 4) || ((pOutputBufferEnd - pOutputBufferCurrent) < 2)) {
                         FS_ZIP_DEFLATE_HUFF_DECODE(23, counter, &pDecompressor->tables[0]);
                         
@@ -685,7 +1214,13 @@ FS_API fs_result fs_zip_deflate_decompress(fs_zip_deflate_decompressor* pDecompr
                             FS_ZIP_DEFLATE_CR_RETURN(53, FS_HAS_MORE_OUTPUT);
                         }
                         
-                        *pOutputBufferCurrent++ = pOutputBufferStart[(distFromOutBufStart++ - dist) & outputBufferSizeMask];
+                        /*
+                        The source position is worked out from the output pointer rather than a running offset
+                        because the output buffer can change between calls when decompressing straight into the
+                        caller's buffer.
+                        */
+                        *pOutputBufferCurrent = pOutputBufferStart[((size_t)(pOutputBufferCurrent - pOutputBufferStart) - dist) & outputBufferSizeMask];
+                        pOutputBufferCurrent += 1;
                     }
                 
                     continue;
@@ -775,477 +1310,3615 @@ common_exit:
 
     return status;
 }
-/* END fs_zip_deflate.c */
-
-
-/* BEG fs_zip.c */
-#ifndef FS_ZIP_DEFLATE32_UNCOMPRESSED_CACHE_SIZE_IN_BYTES
-#define FS_ZIP_DEFLATE32_UNCOMPRESSED_CACHE_SIZE_IN_BYTES   32768
-#endif
-
-#ifndef FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES
-#define FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES   65536
-#endif
-
-#ifndef FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES
-#define FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES               4096
-#endif
 
-#define FS_ZIP_EOCD_SIGNATURE                               0x06054b50
-#define FS_ZIP_EOCD64_SIGNATURE                             0x06064b50
-#define FS_ZIP_EOCD64_LOCATOR_SIGNATURE                     0x07064b50
-#define FS_ZIP_CD_FILE_HEADER_SIGNATURE                     0x02014b50
+/*
+The compressor is a hash chain LZ77 matcher followed by Huffman coding. Each block is written with
+whichever of dynamic codes, fixed codes or no compression at all ends up being the smallest.
 
-#define FS_ZIP_COMPRESSION_METHOD_STORE                     0
-#define FS_ZIP_COMPRESSION_METHOD_DEFLATE                   8
-#define FS_ZIP_COMPRESSION_METHOD_DEFLATE64                 9
+Each call compresses a single chunk of input on its own. The bytes sitting just before the input are
+used as a dictionary so matches can reach back into the previous chunk. Unless the chunk is the final
+one, the output is padded to a byte boundary with an empty stored block. This means the output of
+consecutive chunks can simply be concatenated, which is what allows chunks to be compressed in
+parallel like pigz.
 
+The level settings are the same as zlib's. Levels 1 to 3 use greedy matching, and levels 4 to 9 use
+lazy matching where a match is only taken if the match at the next byte isn't longer.
+*/
+typedef struct
+{
+    fs_uint16 goodLength;   /* Shorten the search when the previous match is at least this long. */
+    fs_uint16 maxLazy;      /* Lazy matching: Don't search when the previous match is at least this long. Greedy matching: The longest match whose positions are all added to the hash chains. */
+    fs_uint16 niceLength;   /* Stop searching when a match of this length is found. */
+    fs_uint16 maxChain;     /* The maximum number of positions to check. */
+} fs_zip_deflate_level_config;
 
-typedef struct fs_zip_cd_node fs_zip_cd_node;
-struct fs_zip_cd_node
+static const fs_zip_deflate_level_config fs_zip_deflate_level_configs[FS_ZIP_DEFLATE_MAX_LEVEL + 1] =
 {
-    size_t iFile;                   /* Will be undefined for non leaf nodes. */
-    const char* pName;
-    size_t nameLen;
-    size_t childCount;
-    fs_zip_cd_node* pChildren;
-    size_t _descendantRangeBeg;     /* Only used for building the CD node graph. */
-    size_t _descendantRangeEnd;     /* Only used for building the CD node graph. */
-    size_t _descendantPrefixLen;    /* Only used for building the CD node graph. */
+    {0,  0,   0,   0   },
+    {4,  4,   8,   4   },
+    {4,  5,   16,  8   },
+    {4,  6,   32,  32  },
+    {4,  4,   16,  16  },
+    {8,  16,  32,  32  },
+    {8,  16,  128, 128 },
+    {8,  32,  128, 256 },
+    {32, 128, 258, 1024},
+    {32, 258, 258, 4096}
 };
 
-typedef struct fs_zip_index
+static const fs_uint16 fs_zip_deflate_length_base[29] =
 {
-    size_t offsetInBytes;           /* The offset in bytes of the item relative to the start of the central directory. */
-} fs_zip_index;
-
-typedef struct fs_zip
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23,  27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const fs_uint8 fs_zip_deflate_length_extra[29] =
 {
-    size_t fileCount;               /* Total number of records in the central directory. */
-    size_t centralDirectorySize;    /* Size in bytes of the central directory. */
-    void* pCentralDirectory;        /* Offset of pHeap. */
-    fs_zip_index* pIndex;           /* Offset of pHeap. There will be fileCount items in this array, and each item is sorted by the file path of each item. */
-    fs_zip_cd_node* pCDRootNode;    /* The root node of our accelerated central directory data structure. */
-    void* pHeap;                    /* A single heap allocation for storing the central directory and index. */
-} fs_zip;
-
-typedef struct fs_zip_file_info
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const fs_uint16 fs_zip_deflate_dist_base[30] =
 {
-    const char* pPath;
-    size_t pathLen;
-    fs_uint16 compressionMethod;
-    fs_uint64 compressedSize;
-    fs_uint64 uncompressedSize;
-    fs_uint64 fileOffset;            /* The offset in bytes from the start of the archive file. */
-    fs_bool32 directory;
-} fs_zip_file_info;
-
-static size_t fs_alloc_size_zip(const void* pBackendConfig)
+    1,   2,   3,   4,   5,    7,    9,    13,   17,   25,   33,   49,    65,    97,    129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const fs_uint8 fs_zip_deflate_dist_extra[30] =
 {
-    (void)pBackendConfig;
-
-    return sizeof(fs_zip);
-}
+    0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const fs_uint8 fs_zip_deflate_code_size_order[19] =
+{
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
 
+#define FS_ZIP_DEFLATE_MIN_MATCH        3
+#define FS_ZIP_DEFLATE_MAX_MATCH        258
+#define FS_ZIP_DEFLATE_TOO_FAR          4096    /* Matches of the minimum length further back than this cost more than the literals. */
+#define FS_ZIP_DEFLATE_HASH(p)          ((fs_uint32)((((fs_uint32)(p)[0] << 16) | ((fs_uint32)(p)[1] << 8) | (fs_uint32)(p)[2]) * 2654435761U) >> (32 - FS_ZIP_DEFLATE_HASH_BITS))
+#define FS_ZIP_DEFLATE_DIST_SYMBOL(pCompressor, dist0)  (((dist0) < 256) ? (pCompressor)->distSymbol[(dist0)] : (pCompressor)->distSymbol[256 + ((dist0) >> 7)])
 
-typedef struct fs_zip_refstring
+static void fs_zip_deflate_build_codes(const fs_uint8* pCodeSizes, unsigned int symbolCount, fs_uint16* pCodes)
 {
-    const char* str;
-    size_t len;
-} fs_zip_refstring;
+    unsigned int sizeCounts[16];
+    unsigned int nextCode[16];
+    unsigned int code;
+    unsigned int i;
+
+    FS_ZIP_ZERO_MEMORY(sizeCounts, sizeof(sizeCounts));
+    for (i = 0; i < symbolCount; i += 1) {
+        sizeCounts[pCodeSizes[i]] += 1;
+    }
 
-static int fs_zip_binary_search_zip_cd_node_compare(void* pUserData, const void* pKey, const void* pVal)
-{
-    const fs_zip_refstring* pRefString = (const fs_zip_refstring*)pKey;
-    const fs_zip_cd_node* pNode = (const fs_zip_cd_node*)pVal;
-    int compareResult;
+    sizeCounts[0] = 0;
+    code = 0;
+    for (i = 1; i < 16; i += 1) {
+        code = (code + sizeCounts[i - 1]) << 1;
+        nextCode[i] = code;
+    }
 
-    (void)pUserData;
+    /* The codes are stored with their bits reversed because deflate writes Huffman codes starting from the most significant bit. */
+    for (i = 0; i < symbolCount; i += 1) {
+        unsigned int codeSize = pCodeSizes[i];
+        unsigned int reversed = 0;
+        unsigned int j;
 
-    compareResult = strncmp(pRefString->str, pNode->pName, FS_ZIP_MIN(pRefString->len, pNode->nameLen));
-    if (compareResult == 0 && pRefString->len != pNode->nameLen) {
-        compareResult = (pRefString->len < pNode->nameLen) ? -1 : 1;
+        if (codeSize == 0) {
+            pCodes[i] = 0;
+            continue;
+        }
+
+        code = nextCode[codeSize]++;
+        for (j = 0; j < codeSize; j += 1) {
+            reversed = (reversed << 1) | (code & 1);
+            code >>= 1;
+        }
+
+        pCodes[i] = (fs_uint16)reversed;
+    }
+}
+
+/*
+This is the in-place minimum redundancy algorithm by Moffat and Katajainen. The input is the
+frequencies sorted from lowest to highest and the output is the code size of each one.
+*/
+static void fs_zip_deflate_calculate_code_sizes(fs_uint32* pA, int n)
+{
+    int root;
+    int leaf;
+    int next;
+    int avbl;
+    int used;
+    int dpth;
+
+    if (n == 0) {
+        return;
+    }
+
+    if (n == 1) {
+        pA[0] = 1;
+        return;
+    }
+
+    pA[0] += pA[1];
+    root = 0;
+    leaf = 2;
+
+    for (next = 1; next < n - 1; next += 1) {
+        if (leaf >= n || pA[root] < pA[leaf]) {
+            pA[next] = pA[root];
+            pA[root++] = (fs_uint32)next;
+        } else {
+            pA[next] = pA[leaf++];
+        }
+
+        if (leaf >= n || (root < next && pA[root] < pA[leaf])) {
+            pA[next] += pA[root];
+            pA[root++] = (fs_uint32)next;
+        } else {
+            pA[next] += pA[leaf++];
+        }
+    }
+
+    pA[n - 2] = 0;
+    for (next = n - 3; next >= 0; next -= 1) {
+        pA[next] = pA[pA[next]] + 1;
+    }
+
+    avbl = 1;
+    used = 0;
+    dpth = 0;
+    root = n - 2;
+    next = n - 1;
+
+    while (avbl > 0) {
+        while (root >= 0 && (int)pA[root] == dpth) {
+            used += 1;
+            root -= 1;
+        }
+
+        while (avbl > used) {
+            pA[next--] = (fs_uint32)dpth;
+            avbl -= 1;
+        }
+
+        avbl = 2 * used;
+        dpth += 1;
+        used = 0;
+    }
+}
+
+/*
+Builds length limited code sizes from symbol frequencies. There's always at least two codes, even if
+fewer symbols are used, so that the code is complete which some decompressors insist on.
+*/
+static void fs_zip_deflate_build_code_sizes(const fs_uint32* pFreq, unsigned int symbolCount, unsigned int maxCodeSize, fs_uint8* pCodeSizes)
+{
+    fs_uint32 keys[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0];
+    fs_uint16 symbols[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0];
+    unsigned int sizeCounts[33];
+    unsigned int usedCount = 0;
+    unsigned int dummyCount = 2;
+    unsigned int total;
+    unsigned int i;
+    unsigned int j;
+
+    FS_ZIP_ASSERT(symbolCount <= FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0);
+
+    FS_ZIP_ZERO_MEMORY(pCodeSizes, symbolCount);
+
+    for (i = 0; i < symbolCount && dummyCount > 0; i += 1) {
+        if (pFreq[i] > 0) {
+            dummyCount -= 1;
+        }
+    }
+
+    for (i = 0; i < symbolCount; i += 1) {
+        fs_uint32 freq = pFreq[i];
+
+        if (freq == 0 && dummyCount > 0) {
+            freq = 1;
+            dummyCount -= 1;
+        }
+
+        if (freq > 0) {
+            /* Insertion sort by frequency. Ties are kept in symbol order so the output is deterministic. */
+            j = usedCount;
+            while (j > 0 && keys[j - 1] > freq) {
+                keys[j]    = keys[j - 1];
+                symbols[j] = symbols[j - 1];
+                j -= 1;
+            }
+
+            keys[j]    = freq;
+            symbols[j] = (fs_uint16)i;
+            usedCount += 1;
+        }
+    }
+
+    fs_zip_deflate_calculate_code_sizes(keys, (int)usedCount);
+
+    FS_ZIP_ZERO_MEMORY(sizeCounts, sizeof(sizeCounts));
+    for (i = 0; i < usedCount; i += 1) {
+        sizeCounts[FS_ZIP_MIN(keys[i], 32)] += 1;
+    }
+
+    /* Codes that are too long are shortened, and then codes are lengthened until the code is complete again. */
+    for (i = maxCodeSize + 1; i <= 32; i += 1) {
+        sizeCounts[maxCodeSize] += sizeCounts[i];
+    }
+
+    total = 0;
+    for (i = maxCodeSize; i > 0; i -= 1) {
+        total += sizeCounts[i] << (maxCodeSize - i);
+    }
+
+    while (total != (1U << maxCodeSize)) {
+        sizeCounts[maxCodeSize] -= 1;
+
+        for (i = maxCodeSize - 1; i > 0; i -= 1) {
+            if (sizeCounts[i] > 0) {
+                sizeCounts[i]     -= 1;
+                sizeCounts[i + 1] += 2;
+                break;
+            }
+        }
+
+        total -= 1;
+    }
+
+    /* The most frequent symbols are at the end and get the shortest codes. */
+    j = usedCount;
+    for (i = 1; i <= maxCodeSize; i += 1) {
+        unsigned int count;
+        for (count = sizeCounts[i]; count > 0; count -= 1) {
+            pCodeSizes[symbols[--j]] = (fs_uint8)i;
+        }
+    }
+}
+
+static FS_INLINE void fs_zip_deflate_put_bits(fs_zip_deflate_compressor* pCompressor, fs_uint32 bits, fs_uint32 bitCount)
+{
+    FS_ZIP_ASSERT(bitCount <= 16);
+
+    pCompressor->bitBuffer |= bits << pCompressor->bitCount;
+    pCompressor->bitCount  += bitCount;
+
+    while (pCompressor->bitCount >= 8) {
+        /* The output is sized so this can never overflow. The check is just to be safe. */
+        if (pCompressor->outputSize < pCompressor->outputCap) {
+            pCompressor->pOutput[pCompressor->outputSize] = (fs_uint8)pCompressor->bitBuffer;
+        }
+
+        pCompressor->outputSize += 1;
+        pCompressor->bitBuffer >>= 8;
+        pCompressor->bitCount   -= 8;
+    }
+}
+
+static void fs_zip_deflate_align_to_byte(fs_zip_deflate_compressor* pCompressor)
+{
+    if (pCompressor->bitCount > 0) {
+        fs_zip_deflate_put_bits(pCompressor, 0, 8 - pCompressor->bitCount);
+    }
+}
+
+static void fs_zip_deflate_write_stored_blocks(fs_zip_deflate_compressor* pCompressor, const fs_uint8* pData, size_t dataSize, fs_bool32 isFinal)
+{
+    do {
+        size_t blockSize = FS_ZIP_MIN(dataSize, 65535);
+        fs_bool32 isLastBlock = (blockSize == dataSize);
+
+        fs_zip_deflate_put_bits(pCompressor, (isFinal && isLastBlock) ? 1 : 0, 3);
+        fs_zip_deflate_align_to_byte(pCompressor);
+        fs_zip_deflate_put_bits(pCompressor, (fs_uint32)blockSize, 16);
+        fs_zip_deflate_put_bits(pCompressor, (fs_uint32)blockSize ^ 0xFFFF, 16);
+
+        if (blockSize > 0 && pCompressor->outputSize + blockSize <= pCompressor->outputCap) {
+            FS_ZIP_COPY_MEMORY(pCompressor->pOutput + pCompressor->outputSize, pData, blockSize);
+        }
+
+        pCompressor->outputSize += blockSize;
+        pData    += blockSize;
+        dataSize -= blockSize;
+    } while (dataSize > 0);
+}
+
+static void fs_zip_deflate_write_symbols(fs_zip_deflate_compressor* pCompressor, const fs_uint8* pLitLenCodeSize, const fs_uint16* pLitLenCode, const fs_uint8* pDistCodeSize, const fs_uint16* pDistCode)
+{
+    fs_uint32 iSymbol;
+
+    for (iSymbol = 0; iSymbol < pCompressor->symbolCount; iSymbol += 1) {
+        fs_uint32 litLen = pCompressor->symbolLitLen[iSymbol];
+
+        if (litLen < 256) {
+            fs_zip_deflate_put_bits(pCompressor, pLitLenCode[litLen], pLitLenCodeSize[litLen]);
+        } else {
+            fs_uint32 length0 = litLen - 256;
+            fs_uint32 dist0   = pCompressor->symbolDist[iSymbol];
+            fs_uint32 lengthSymbol = pCompressor->lengthSymbol[length0];
+            fs_uint32 distSymbol   = FS_ZIP_DEFLATE_DIST_SYMBOL(pCompressor, dist0);
+
+            fs_zip_deflate_put_bits(pCompressor, pLitLenCode[257 + lengthSymbol], pLitLenCodeSize[257 + lengthSymbol]);
+            fs_zip_deflate_put_bits(pCompressor, length0 + FS_ZIP_DEFLATE_MIN_MATCH - fs_zip_deflate_length_base[lengthSymbol], fs_zip_deflate_length_extra[lengthSymbol]);
+            fs_zip_deflate_put_bits(pCompressor, pDistCode[distSymbol], pDistCodeSize[distSymbol]);
+            fs_zip_deflate_put_bits(pCompressor, dist0 + 1 - fs_zip_deflate_dist_base[distSymbol], fs_zip_deflate_dist_extra[distSymbol]);
+        }
+    }
+
+    fs_zip_deflate_put_bits(pCompressor, pLitLenCode[256], pLitLenCodeSize[256]);
+}
+
+/*
+Writes out the symbols that have been collected so far as a single block. The block is written in
+whichever form is smallest. The size of the stored form includes the worst case padding so that the
+output can never be larger than what fs_zip_deflate_compress_bound() allows for.
+*/
+static void fs_zip_deflate_write_block(fs_zip_deflate_compressor* pCompressor, const fs_uint8* pBlockInput, fs_bool32 isFinal)
+{
+    fs_uint8 codeLengths[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0 + FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1];
+    fs_uint8 rleSymbols[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0 + FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1];
+    fs_uint8 rleExtra[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0 + FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1];
+    fs_uint32 codeSizeFreq[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_2];
+    fs_uint8 codeSizeCodeSize[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_2];
+    fs_uint16 codeSizeCode[FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_2];
+    unsigned int litLenCount;
+    unsigned int distCount;
+    unsigned int codeSizeCount;
+    unsigned int rleCount;
+    unsigned int i;
+    fs_uint64 extraBits;
+    fs_uint64 dynamicBits;
+    fs_uint64 fixedBits;
+    fs_uint64 storedBits;
+
+    pCompressor->litLenFreq[256] = 1;  /* End of block. */
+
+    fs_zip_deflate_build_code_sizes(pCompressor->litLenFreq, 286, 15, pCompressor->litLenCodeSize);
+    fs_zip_deflate_build_code_sizes(pCompressor->distFreq,   30,  15, pCompressor->distCodeSize);
+
+    /* The extra bits of lengths and distances are the same regardless of the codes. */
+    extraBits = 0;
+    for (i = 0; i < 29; i += 1) {
+        extraBits += (fs_uint64)pCompressor->litLenFreq[257 + i] * fs_zip_deflate_length_extra[i];
+    }
+    for (i = 0; i < 30; i += 1) {
+        extraBits += (fs_uint64)pCompressor->distFreq[i] * fs_zip_deflate_dist_extra[i];
+    }
+
+    /* Run length encode the code sizes. The literal/length and distance code sizes are encoded as a single sequence. */
+    litLenCount = 286;
+    while (litLenCount > 257 && pCompressor->litLenCodeSize[litLenCount - 1] == 0) {
+        litLenCount -= 1;
+    }
+
+    distCount = 30;
+    while (distCount > 1 && pCompressor->distCodeSize[distCount - 1] == 0) {
+        distCount -= 1;
+    }
+
+    FS_ZIP_COPY_MEMORY(codeLengths, pCompressor->litLenCodeSize, litLenCount);
+    FS_ZIP_COPY_MEMORY(codeLengths + litLenCount, pCompressor->distCodeSize, distCount);
+    FS_ZIP_ZERO_MEMORY(codeSizeFreq, sizeof(codeSizeFreq));
+
+    rleCount = 0;
+    for (i = 0; i < litLenCount + distCount; ) {
+        fs_uint8 codeSize = codeLengths[i];
+        unsigned int runLength = 1;
+        unsigned int remaining;
+
+        while (i + runLength < litLenCount + distCount && codeLengths[i + runLength] == codeSize) {
+            runLength += 1;
+        }
+
+        i += runLength;
+        remaining = runLength;
+
+        if (codeSize == 0) {
+            while (remaining >= 11) {
+                unsigned int count = FS_ZIP_MIN(remaining, 138);
+                rleSymbols[rleCount] = 18;
+                rleExtra[rleCount]   = (fs_uint8)(count - 11);
+                rleCount += 1;
+                remaining -= count;
+            }
+
+            if (remaining >= 3) {
+                rleSymbols[rleCount] = 17;
+                rleExtra[rleCount]   = (fs_uint8)(remaining - 3);
+                rleCount += 1;
+                remaining = 0;
+            }
+        } else {
+            rleSymbols[rleCount] = codeSize;
+            rleExtra[rleCount]   = 0;
+            rleCount += 1;
+            remaining -= 1;
+
+            while (remaining >= 3) {
+                unsigned int count = FS_ZIP_MIN(remaining, 6);
+                rleSymbols[rleCount] = 16;
+                rleExtra[rleCount]   = (fs_uint8)(count - 3);
+                rleCount += 1;
+                remaining -= count;
+            }
+        }
+
+        while (remaining > 0) {
+            rleSymbols[rleCount] = codeSize;
+            rleExtra[rleCount]   = 0;
+            rleCount += 1;
+            remaining -= 1;
+        }
+    }
+
+    for (i = 0; i < rleCount; i += 1) {
+        codeSizeFreq[rleSymbols[i]] += 1;
+    }
+
+    fs_zip_deflate_build_code_sizes(codeSizeFreq, FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_2, 7, codeSizeCodeSize);
+    fs_zip_deflate_build_codes(codeSizeCodeSize, FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_2, codeSizeCode);
+
+    codeSizeCount = FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_2;
+    while (codeSizeCount > 4 && codeSizeCodeSize[fs_zip_deflate_code_size_order[codeSizeCount - 1]] == 0) {
+        codeSizeCount -= 1;
+    }
+
+    /* Now work out the size of each type of block. */
+    dynamicBits = 3 + 5 + 5 + 4 + (3 * codeSizeCount) + extraBits;
+    fixedBits   = 3 + extraBits;
+
+    for (i = 0; i < FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_2; i += 1) {
+        dynamicBits += (fs_uint64)codeSizeFreq[i] * codeSizeCodeSize[i];
+    }
+    dynamicBits += (fs_uint64)codeSizeFreq[16] * 2 + (fs_uint64)codeSizeFreq[17] * 3 + (fs_uint64)codeSizeFreq[18] * 7;
+
+    for (i = 0; i < 286; i += 1) {
+        dynamicBits += (fs_uint64)pCompressor->litLenFreq[i] * pCompressor->litLenCodeSize[i];
+        fixedBits   += (fs_uint64)pCompressor->litLenFreq[i] * pCompressor->fixedLitLenCodeSize[i];
+    }
+    for (i = 0; i < 30; i += 1) {
+        dynamicBits += (fs_uint64)pCompressor->distFreq[i] * pCompressor->distCodeSize[i];
+        fixedBits   += (fs_uint64)pCompressor->distFreq[i] * pCompressor->fixedDistCodeSize[i];
+    }
+
+    storedBits = (fs_uint64)((pCompressor->blockInputSize / 65535) + 1) * (3 + 7 + 32) + ((fs_uint64)pCompressor->blockInputSize * 8);
+
+    if (storedBits < dynamicBits && storedBits < fixedBits) {
+        fs_zip_deflate_write_stored_blocks(pCompressor, pBlockInput, pCompressor->blockInputSize, isFinal);
+    } else if (fixedBits <= dynamicBits) {
+        fs_zip_deflate_put_bits(pCompressor, (isFinal ? 1 : 0) | (1 << 1), 3);
+        fs_zip_deflate_write_symbols(pCompressor, pCompressor->fixedLitLenCodeSize, pCompressor->fixedLitLenCode, pCompressor->fixedDistCodeSize, pCompressor->fixedDistCode);
+    } else {
+        fs_zip_deflate_build_codes(pCompressor->litLenCodeSize, 286, pCompressor->litLenCode);
+        fs_zip_deflate_build_codes(pCompressor->distCodeSize,   30,  pCompressor->distCode);
+
+        fs_zip_deflate_put_bits(pCompressor, (isFinal ? 1 : 0) | (2 << 1), 3);
+        fs_zip_deflate_put_bits(pCompressor, litLenCount - 257, 5);
+        fs_zip_deflate_put_bits(pCompressor, distCount - 1, 5);
+        fs_zip_deflate_put_bits(pCompressor, codeSizeCount - 4, 4);
+
+        for (i = 0; i < codeSizeCount; i += 1) {
+            fs_zip_deflate_put_bits(pCompressor, codeSizeCodeSize[fs_zip_deflate_code_size_order[i]], 3);
+        }
+
+        for (i = 0; i < rleCount; i += 1) {
+            fs_zip_deflate_put_bits(pCompressor, codeSizeCode[rleSymbols[i]], codeSizeCodeSize[rleSymbols[i]]);
+
+            if (rleSymbols[i] == 16) {
+                fs_zip_deflate_put_bits(pCompressor, rleExtra[i], 2);
+            } else if (rleSymbols[i] == 17) {
+                fs_zip_deflate_put_bits(pCompressor, rleExtra[i], 3);
+            } else if (rleSymbols[i] == 18) {
+                fs_zip_deflate_put_bits(pCompressor, rleExtra[i], 7);
+            }
+        }
+
+        fs_zip_deflate_write_symbols(pCompressor, pCompressor->litLenCodeSize, pCompressor->litLenCode, pCompressor->distCodeSize, pCompressor->distCode);
+    }
+
+    pCompressor->symbolCount    = 0;
+    pCompressor->blockInputSize = 0;
+    FS_ZIP_ZERO_MEMORY(pCompressor->litLenFreq, sizeof(pCompressor->litLenFreq));
+    FS_ZIP_ZERO_MEMORY(pCompressor->distFreq,   sizeof(pCompressor->distFreq));
+}
+
+static FS_INLINE void fs_zip_deflate_record_literal(fs_zip_deflate_compressor* pCompressor, fs_uint8 literal)
+{
+    pCompressor->symbolLitLen[pCompressor->symbolCount] = literal;
+    pCompressor->symbolCount    += 1;
+    pCompressor->blockInputSize += 1;
+    pCompressor->litLenFreq[literal] += 1;
+}
+
+static FS_INLINE void fs_zip_deflate_record_match(fs_zip_deflate_compressor* pCompressor, fs_uint32 length, fs_uint32 dist)
+{
+    fs_uint32 length0 = length - FS_ZIP_DEFLATE_MIN_MATCH;
+    fs_uint32 dist0   = dist - 1;
+
+    pCompressor->symbolLitLen[pCompressor->symbolCount] = (fs_uint16)(256 + length0);
+    pCompressor->symbolDist[pCompressor->symbolCount]   = (fs_uint16)dist0;
+    pCompressor->symbolCount    += 1;
+    pCompressor->blockInputSize += length;
+    pCompressor->litLenFreq[257 + pCompressor->lengthSymbol[length0]] += 1;
+    pCompressor->distFreq[FS_ZIP_DEFLATE_DIST_SYMBOL(pCompressor, dist0)] += 1;
+}
+
+static FS_INLINE void fs_zip_deflate_insert_hash(fs_zip_deflate_compressor* pCompressor, const fs_uint8* pWindow, fs_uint32 pos)
+{
+    fs_uint32 hash = FS_ZIP_DEFLATE_HASH(pWindow + pos);
+    fs_uint32 absolutePos = pCompressor->positionBase + pos;
+
+    pCompressor->hashPrev[absolutePos & (FS_ZIP_DEFLATE_WINDOW_SIZE - 1)] = pCompressor->hashHead[hash];
+    pCompressor->hashHead[hash] = absolutePos;
+}
+
+/*
+Returns the length of the longest match at pos that is longer than bestLength, or 0 if there isn't
+one. The candidate is the absolute position of the most recent earlier position with the same hash.
+*/
+static fs_uint32 fs_zip_deflate_find_match(const fs_zip_deflate_compressor* pCompressor, const fs_uint8* pWindow, fs_uint32 pos, fs_uint32 end, fs_uint32 candidate, fs_uint32 bestLength, fs_uint32 maxChain, fs_uint32 niceLength, fs_uint32* pDist)
+{
+    const fs_uint8* pCurrent = pWindow + pos;
+    fs_uint32 absolutePos = pCompressor->positionBase + pos;
+    fs_uint32 maxLength = FS_ZIP_MIN(end - pos, FS_ZIP_DEFLATE_MAX_MATCH);
+    fs_uint32 foundLength = 0;
+
+    if (bestLength >= maxLength) {
+        return 0;
+    }
+
+    if (niceLength > maxLength) {
+        niceLength = maxLength;
+    }
+
+    while (maxChain > 0 && candidate >= pCompressor->positionBase && candidate < absolutePos && (absolutePos - candidate) <= FS_ZIP_DEFLATE_WINDOW_SIZE) {
+        const fs_uint8* pCandidate = pWindow + (candidate - pCompressor->positionBase);
+        fs_uint32 next;
+
+        /* Checking the byte that would make the match longer first rules out most candidates straight away. */
+        if (pCandidate[bestLength] == pCurrent[bestLength] && pCandidate[0] == pCurrent[0] && pCandidate[1] == pCurrent[1]) {
+            fs_uint32 length = 2;
+            while (length < maxLength && pCandidate[length] == pCurrent[length]) {
+                length += 1;
+            }
+
+            if (length > bestLength) {
+                bestLength  = length;
+                foundLength = length;
+                *pDist      = absolutePos - candidate;
+
+                if (length >= niceLength) {
+                    break;
+                }
+            }
+        }
+
+        /* Slots in hashPrev get reused once they're a window behind. That's detected by the chain going forward. */
+        next = pCompressor->hashPrev[candidate & (FS_ZIP_DEFLATE_WINDOW_SIZE - 1)];
+        if (next >= candidate) {
+            break;
+        }
+
+        candidate = next;
+        maxChain -= 1;
+    }
+
+    return foundLength;
+}
+
+FS_API fs_result fs_zip_deflate_compressor_init(fs_zip_deflate_compressor* pCompressor)
+{
+    unsigned int i;
+    unsigned int j;
+
+    if (pCompressor == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    FS_ZIP_ZERO_OBJECT(pCompressor);
+
+    /* Positions start at 1 so the zeroed hash table doesn't point anywhere. */
+    pCompressor->positionBase = 1;
+
+    for (i = 0; i < 28; i += 1) {
+        for (j = 0; j < (1U << fs_zip_deflate_length_extra[i]); j += 1) {
+            pCompressor->lengthSymbol[fs_zip_deflate_length_base[i] - FS_ZIP_DEFLATE_MIN_MATCH + j] = (fs_uint8)i;
+        }
+    }
+    pCompressor->lengthSymbol[FS_ZIP_DEFLATE_MAX_MATCH - FS_ZIP_DEFLATE_MIN_MATCH] = 28;
+
+    for (i = 0; i < 30; i += 1) {
+        for (j = 0; j < (1U << fs_zip_deflate_dist_extra[i]); j += 1) {
+            fs_uint32 dist0 = fs_zip_deflate_dist_base[i] - 1 + j;
+            if (dist0 < 256) {
+                pCompressor->distSymbol[dist0] = (fs_uint8)i;
+            } else {
+                pCompressor->distSymbol[256 + (dist0 >> 7)] = (fs_uint8)i;
+            }
+        }
+    }
+
+    for (i = 0; i < FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0; i += 1) {
+        if (i < 144) {
+            pCompressor->fixedLitLenCodeSize[i] = 8;
+        } else if (i < 256) {
+            pCompressor->fixedLitLenCodeSize[i] = 9;
+        } else if (i < 280) {
+            pCompressor->fixedLitLenCodeSize[i] = 7;
+        } else {
+            pCompressor->fixedLitLenCodeSize[i] = 8;
+        }
+    }
+
+    for (i = 0; i < FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1; i += 1) {
+        pCompressor->fixedDistCodeSize[i] = 5;
+    }
+
+    fs_zip_deflate_build_codes(pCompressor->fixedLitLenCodeSize, FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_0, pCompressor->fixedLitLenCode);
+    fs_zip_deflate_build_codes(pCompressor->fixedDistCodeSize,   FS_ZIP_DEFLATE_MAX_HUFF_SYMBOLS_1, pCompressor->fixedDistCode);
+
+    return FS_SUCCESS;
+}
+
+FS_API size_t fs_zip_deflate_compress_bound(size_t inputSize)
+{
+    /*
+    Every block is at least FS_ZIP_DEFLATE_BLOCK_SYMBOL_COUNT bytes apart from the last one, and a block
+    is never bigger than storing it, which costs 5 bytes for every 65535 bytes plus a byte of padding.
+    On top of that there's the empty stored block at the end of non-final chunks.
+    */
+    return inputSize + ((inputSize / FS_ZIP_DEFLATE_BLOCK_SYMBOL_COUNT) + (inputSize / 65535) + 2) * 6 + 16;
+}
+
+FS_API fs_result fs_zip_deflate_compress(fs_zip_deflate_compressor* pCompressor, int level, const fs_uint8* pInput, size_t dictionarySize, size_t inputSize, fs_bool32 isFinal, fs_uint8* pOutput, size_t outputCap, size_t* pOutputSize)
+{
+    const fs_zip_deflate_level_config* pConfig;
+    const fs_uint8* pWindow;
+    fs_uint32 pos;
+    fs_uint32 end;
+    fs_uint32 blockStart;
+
+    if (pOutputSize != NULL) {
+        *pOutputSize = 0;
+    }
+
+    if (pCompressor == NULL || (pInput == NULL && inputSize > 0) || pOutput == NULL || pOutputSize == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    if (inputSize > FS_ZIP_DEFLATE_MAX_INPUT_SIZE) {
+        return FS_TOO_BIG;
+    }
+
+    if (outputCap < fs_zip_deflate_compress_bound(inputSize)) {
+        return FS_INVALID_ARGS;
+    }
+
+    if (level < 1) {
+        level = 1;
+    }
+    if (level > FS_ZIP_DEFLATE_MAX_LEVEL) {
+        level = FS_ZIP_DEFLATE_MAX_LEVEL;
+    }
+
+    pConfig = &fs_zip_deflate_level_configs[level];
+
+    /* Only the last window of the dictionary can be referenced. */
+    if (dictionarySize > FS_ZIP_DEFLATE_WINDOW_SIZE) {
+        dictionarySize = FS_ZIP_DEFLATE_WINDOW_SIZE;
+    }
+
+    pWindow = pInput - dictionarySize;
+    end     = (fs_uint32)(dictionarySize + inputSize);
+
+    /* Positions are absolute across calls so the hash table doesn't need to be cleared each time, unless they're about to wrap. */
+    if (pCompressor->positionBase > 0xFFFFFFFF - FS_ZIP_DEFLATE_MAX_INPUT_SIZE - FS_ZIP_DEFLATE_WINDOW_SIZE * 2) {
+        FS_ZIP_ZERO_MEMORY(pCompressor->hashHead, sizeof(pCompressor->hashHead));
+        pCompressor->positionBase = 1;
+    }
+
+    pCompressor->pOutput        = pOutput;
+    pCompressor->outputSize     = 0;
+    pCompressor->outputCap      = outputCap;
+    pCompressor->bitBuffer      = 0;
+    pCompressor->bitCount       = 0;
+    pCompressor->symbolCount    = 0;
+    pCompressor->blockInputSize = 0;
+    FS_ZIP_ZERO_MEMORY(pCompressor->litLenFreq, sizeof(pCompressor->litLenFreq));
+    FS_ZIP_ZERO_MEMORY(pCompressor->distFreq,   sizeof(pCompressor->distFreq));
+
+    for (pos = 0; pos + FS_ZIP_DEFLATE_MIN_MATCH <= end && pos < (fs_uint32)dictionarySize; pos += 1) {
+        fs_zip_deflate_insert_hash(pCompressor, pWindow, pos);
+    }
+
+    pos = (fs_uint32)dictionarySize;
+    blockStart = pos;
+
+    if (level <= 3) {
+        while (pos < end) {
+            fs_uint32 matchLength = 0;
+            fs_uint32 matchDist = 0;
+
+            if (end - pos >= FS_ZIP_DEFLATE_MIN_MATCH) {
+                fs_uint32 candidate = pCompressor->hashHead[FS_ZIP_DEFLATE_HASH(pWindow + pos)];
+
+                fs_zip_deflate_insert_hash(pCompressor, pWindow, pos);
+
+                matchLength = fs_zip_deflate_find_match(pCompressor, pWindow, pos, end, candidate, FS_ZIP_DEFLATE_MIN_MATCH - 1, pConfig->maxChain, pConfig->niceLength, &matchDist);
+                if (matchLength == FS_ZIP_DEFLATE_MIN_MATCH && matchDist > FS_ZIP_DEFLATE_TOO_FAR) {
+                    matchLength = 0;
+                }
+            }
+
+            if (matchLength > 0) {
+                fs_uint32 i;
+
+                fs_zip_deflate_record_match(pCompressor, matchLength, matchDist);
+
+                /* Long matches are skipped over without being added to the hash chains to save time. */
+                if (matchLength <= pConfig->maxLazy) {
+                    for (i = pos + 1; i < pos + matchLength && i + FS_ZIP_DEFLATE_MIN_MATCH <= end; i += 1) {
+                        fs_zip_deflate_insert_hash(pCompressor, pWindow, i);
+                    }
+                }
+
+                pos += matchLength;
+            } else {
+                fs_zip_deflate_record_literal(pCompressor, pWindow[pos]);
+                pos += 1;
+            }
+
+            if (pCompressor->symbolCount == FS_ZIP_DEFLATE_BLOCK_SYMBOL_COUNT) {
+                fs_uint32 blockInputSize = (fs_uint32)pCompressor->blockInputSize;
+                fs_zip_deflate_write_block(pCompressor, pWindow + blockStart, FS_FALSE);
+                blockStart += blockInputSize;
+            }
+        }
+    } else {
+        fs_uint32 prevLength = 0;
+        fs_uint32 prevDist = 0;
+        fs_bool32 hasPrevByte = FS_FALSE;   /* Whether or not the byte before pos is waiting to be output as either a literal or the start of a match. */
+
+        while (pos < end) {
+            fs_uint32 matchLength = 0;
+            fs_uint32 matchDist = 0;
+
+            if (end - pos >= FS_ZIP_DEFLATE_MIN_MATCH) {
+                fs_uint32 candidate = pCompressor->hashHead[FS_ZIP_DEFLATE_HASH(pWindow + pos)];
+
+                fs_zip_deflate_insert_hash(pCompressor, pWindow, pos);
+
+                if (prevLength < pConfig->maxLazy) {
+                    fs_uint32 maxChain = pConfig->maxChain;
+                    if (prevLength >= pConfig->goodLength) {
+                        maxChain >>= 2;
+                    }
+
+                    matchLength = fs_zip_deflate_find_match(pCompressor, pWindow, pos, end, candidate, FS_ZIP_MAX(prevLength, FS_ZIP_DEFLATE_MIN_MATCH - 1), maxChain, pConfig->niceLength, &matchDist);
+                    if (matchLength == FS_ZIP_DEFLATE_MIN_MATCH && matchDist > FS_ZIP_DEFLATE_TOO_FAR) {
+                        matchLength = 0;
+                    }
+                }
+            }
+
+            if (prevLength >= FS_ZIP_DEFLATE_MIN_MATCH && matchLength == 0) {
+                /* The previous match is better. The positions up to and including pos are already in the hash chains. */
+                fs_uint32 i;
+
+                fs_zip_deflate_record_match(pCompressor, prevLength, prevDist);
+
+                for (i = pos + 1; i < pos - 1 + prevLength && i + FS_ZIP_DEFLATE_MIN_MATCH <= end; i += 1) {
+                    fs_zip_deflate_insert_hash(pCompressor, pWindow, i);
+                }
+
+                pos = pos - 1 + prevLength;
+                prevLength  = 0;
+                hasPrevByte = FS_FALSE;
+            } else {
+                if (hasPrevByte) {
+                    fs_zip_deflate_record_literal(pCompressor, pWindow[pos - 1]);
+                }
+
+                prevLength  = matchLength;
+                prevDist    = matchDist;
+                hasPrevByte = FS_TRUE;
+                pos += 1;
+            }
+
+            if (pCompressor->symbolCount == FS_ZIP_DEFLATE_BLOCK_SYMBOL_COUNT) {
+                fs_uint32 blockInputSize = (fs_uint32)pCompressor->blockInputSize;
+                fs_zip_deflate_write_block(pCompressor, pWindow + blockStart, FS_FALSE);
+                blockStart += blockInputSize;
+            }
+        }
+
+        if (hasPrevByte) {
+            fs_zip_deflate_record_literal(pCompressor, pWindow[pos - 1]);
+        }
+    }
+
+    if (pCompressor->symbolCount > 0 || isFinal) {
+        fs_zip_deflate_write_block(pCompressor, pWindow + blockStart, isFinal);
+    }
+
+    /* An empty stored block gets the output to a byte boundary so the next chunk can be appended to it. */
+    if (!isFinal) {
+        fs_zip_deflate_write_stored_blocks(pCompressor, NULL, 0, FS_FALSE);
+    }
+
+    fs_zip_deflate_align_to_byte(pCompressor);
+
+    pCompressor->positionBase += end;
+
+    if (pCompressor->outputSize > outputCap) {
+        return FS_ERROR;    /* Should never happen. */
+    }
+
+    *pOutputSize = pCompressor->outputSize;
+    return FS_SUCCESS;
+}
+/* END fs_zip_deflate.c */
+
+
+/* BEG fs_zip.c */
+/*
+DEFLATE only needs a 32KB window, but a 64KB cache lets the fast path of the decompressor write past
+the end of matches without clobbering any of the window. See fs_zip_deflate_decompress_fast().
+*/
+#ifndef FS_ZIP_DEFLATE32_UNCOMPRESSED_CACHE_SIZE_IN_BYTES
+#define FS_ZIP_DEFLATE32_UNCOMPRESSED_CACHE_SIZE_IN_BYTES   65536
+#endif
+
+#ifndef FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES
+#define FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES   65536
+#endif
+
+#ifndef FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES
+#define FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES               4096
+#endif
+
+/* When writing compressed files, the data is split into chunks of this size which are compressed in parallel. */
+#ifndef FS_ZIP_COMPRESS_CHUNK_SIZE_IN_BYTES
+#define FS_ZIP_COMPRESS_CHUNK_SIZE_IN_BYTES                 131072
+#endif
+
+#define FS_ZIP_EOCD_SIGNATURE                               0x06054b50
+#define FS_ZIP_EOCD64_SIGNATURE                             0x06064b50
+#define FS_ZIP_EOCD64_LOCATOR_SIGNATURE                     0x07064b50
+#define FS_ZIP_CD_FILE_HEADER_SIGNATURE                     0x02014b50
+#define FS_ZIP_LOCAL_FILE_HEADER_SIGNATURE                  0x04034b50
+#define FS_ZIP_DATA_DESCRIPTOR_SIGNATURE                    0x08074b50
+
+#define FS_ZIP_FLAG_DATA_DESCRIPTOR                         0x0008  /* The CRC and sizes come after the data rather than in the local header. */
+#define FS_ZIP_FLAG_UTF8                                    0x0800  /* The file name is UTF-8. */
+
+#define FS_ZIP_VERSION_DEFAULT                              20      /* The version needed to extract a file using DEFLATE and directories. */
+#define FS_ZIP_VERSION_ZIP64                                45      /* The version needed to extract a file using ZIP64 extensions. */
+
+#define FS_ZIP_COMPRESSION_METHOD_STORE                     0
+#define FS_ZIP_COMPRESSION_METHOD_DEFLATE                   8
+#define FS_ZIP_COMPRESSION_METHOD_DEFLATE64                 9
+
+
+FS_API fs_zip_config fs_zip_config_init(void)
+{
+    fs_zip_config config;
+
+    FS_ZIP_ZERO_OBJECT(&config);
+
+    return config;
+}
+
+
+typedef struct fs_zip_cd_node fs_zip_cd_node;
+struct fs_zip_cd_node
+{
+    size_t iFile;                   /* Will be undefined for non leaf nodes. */
+    const char* pName;
+    size_t nameLen;
+    size_t childCount;
+    fs_zip_cd_node* pChildren;
+    size_t _descendantRangeBeg;     /* Only used for building the CD node graph. */
+    size_t _descendantRangeEnd;     /* Only used for building the CD node graph. */
+    size_t _descendantPrefixLen;    /* Only used for building the CD node graph. */
+};
+
+typedef struct fs_zip_index
+{
+    size_t offsetInBytes;           /* The offset in bytes of the item relative to the start of the central directory. */
+} fs_zip_index;
+
+typedef struct fs_zip_path_hash_node
+{
+    fs_uint32 hash;     /* The hash of the full path of the node. */
+    fs_uint32 iParent;  /* The index of the parent node. The root node is its own parent. */
+} fs_zip_path_hash_node;
+
+typedef struct fs_zip_path_hash_slot
+{
+    fs_uint32 hash;     /* A copy of the hash so that most mismatches can be rejected without touching the node. */
+    fs_uint32 iNode;    /* The index of the node. Set to 0 for an empty slot. */
+} fs_zip_path_hash_slot;
+
+/*
+An entry of an archive that is being written. These are kept in memory until the archive is
+uninitialized at which point they're used to write the central directory.
+*/
+typedef struct fs_zip_write_entry
+{
+    char* pPath;                    /* Stored at the end of the struct. Directories have a trailing slash. Null terminated. */
+    size_t pathLen;                 /* Does not include the trailing slash of directories. */
+    fs_uint32 hash;                 /* The hash of the path, not including the trailing slash of directories. */
+    fs_bool32 directory;
+    fs_uint16 compressionMethod;
+    fs_uint32 crc32;
+    fs_uint64 compressedSize;
+    fs_uint64 uncompressedSize;
+    fs_uint64 localHeaderOffset;    /* Relative to where the stream was when the archive was initialized. */
+} fs_zip_write_entry;
+
+/*
+When compressing, the data of files is gathered into a batch and split into chunks. Once the batch
+is full the chunks are compressed in parallel and written out in order. Anything that would normally
+be written straight to the stream while there are chunks waiting, such as the local header of the
+next file, is queued as an item so that everything ends up in the right order.
+*/
+typedef enum fs_zip_write_item_type
+{
+    FS_ZIP_WRITE_ITEM_LOCAL_HEADER,
+    FS_ZIP_WRITE_ITEM_CHUNK,
+    FS_ZIP_WRITE_ITEM_DATA_DESCRIPTOR
+} fs_zip_write_item_type;
+
+typedef struct fs_zip_write_item
+{
+    fs_zip_write_item_type type;
+    fs_zip_write_entry* pEntry;
+    size_t iChunk;                  /* Only used by chunk items. */
+} fs_zip_write_item;
+
+typedef struct fs_zip_write_chunk
+{
+    size_t inputOffset;             /* The offset of the uncompressed data in the batch. */
+    size_t inputSize;
+    size_t dictionarySize;          /* The number of bytes just before the data that belong to the same file, up to the size of the window. */
+    fs_bool32 isFinal;              /* Set for the last chunk of a file. */
+    size_t outputOffset;            /* The offset of the compressed data in the output buffer of the batch. */
+    size_t outputSize;
+    fs_result result;
+} fs_zip_write_chunk;
+
+/*
+A seek point is a snapshot of the decompressor which allows decompression of a file to resume from
+somewhere other than the start. Seek points are always taken just before the uncompressed cache is
+refilled. At that point the uncompressed cache holds the window the decompressor needs for back
+references, and the uncompressed cursor lines up exactly with the decompressor's output.
+*/
+typedef struct fs_zip_seek_point
+{
+    fs_uint64 uncompressedOffset;               /* The position in the uncompressed data. */
+    fs_uint64 compressedOffset;                 /* The position in the compressed data that the decompressor will continue from. */
+    fs_zip_deflate_decompressor decompressor;   /* The state of the decompressor. */
+    /* A copy of the uncompressed cache is stored at the end of the struct. */
+} fs_zip_seek_point;
+
+typedef struct fs_zip_seek_index fs_zip_seek_index;
+struct fs_zip_seek_index
+{
+    fs_zip_seek_index* pNext;       /* Used for the list of seek indexes of closed files on the fs_zip object. */
+    fs_uint64 localHeaderOffset;    /* Identifies the file the seek index belongs to. */
+    size_t windowSize;              /* The size of the uncompressed cache that was copied for each seek point. */
+    size_t count;
+    size_t cap;
+    fs_zip_seek_point** ppPoints;   /* Sorted by uncompressed offset. */
+};
+
+static void fs_zip_seek_index_free(fs_zip_seek_index* pSeekIndex, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    size_t iPoint;
+
+    if (pSeekIndex == NULL) {
+        return;
+    }
+
+    for (iPoint = 0; iPoint < pSeekIndex->count; iPoint += 1) {
+        fs_free(pSeekIndex->ppPoints[iPoint], pAllocationCallbacks);
+    }
+
+    fs_free(pSeekIndex->ppPoints, pAllocationCallbacks);
+    fs_free(pSeekIndex, pAllocationCallbacks);
+}
+
+typedef struct fs_zip
+{
+    size_t fileCount;               /* Total number of records in the central directory. */
+    size_t centralDirectorySize;    /* Size in bytes of the central directory. */
+    void* pCentralDirectory;        /* Offset of pHeap. */
+    fs_zip_index* pIndex;           /* Offset of pHeap. There will be fileCount items in this array, and each item is sorted by the file path of each item. */
+    fs_zip_cd_node* pCDRootNode;    /* The root node of our accelerated central directory data structure. */
+    size_t nodeCount;               /* The number of nodes in the node graph, including the root node. */
+    void* pPathHashHeap;            /* A single heap allocation for the path hash table. Null if the path hash table is disabled. */
+    fs_zip_path_hash_node* pPathHashNodes;  /* Offset of pPathHashHeap. There will be nodeCount items in this array. */
+    fs_zip_path_hash_slot* pPathHashTable;  /* Offset of pPathHashHeap. An iNode of 0 means the slot is empty. */
+    size_t pathHashTableCap;        /* Always a power of two. */
+    fs_uint64 seekPointInterval;    /* The minimum number of uncompressed bytes between seek points. Zero when seek points are disabled. */
+    fs_mtx seekIndexLock;           /* Protects pSeekIndexes. Only initialized when seek points are enabled. */
+    fs_zip_seek_index* pSeekIndexes;    /* Seek indexes of files that have been closed. These are picked up again when the file is reopened. */
+    fs_bool32 verifyChecksums;      /* When set, the CRC-32 of each file is checked once it has been read to the end. */
+    size_t uncompressedCacheSize;   /* The size of the uncompressed cache of compressed files. Always a power of two. Zero to use the defaults. */
+    size_t compressedCacheSize;     /* The size of the compressed cache. Any space left over from the uncompressed cache is added to this. */
+    fs_bool32 adaptiveReadSize;     /* When set, reads of compressed data start small and grow while the file is being read sequentially. */
+    fs_uint32 (* crc32Proc)(fs_uint32 crc, const void* pData, size_t dataSize);    /* The fastest CRC-32 implementation supported by the CPU. */
+    void* pHeap;                    /* A single heap allocation for storing the central directory and index. */
+    const fs_uint8* pArchiveData;   /* A direct pointer to the entire archive if the stream supports mapping. Used for zero-copy access to stored files. Can be null. */
+    size_t archiveDataSize;
+    fs_mtx archiveDataLock;         /* Protects the mapping of the archive which isn't done until a stored file is mapped. Only initialized when isArchiveDataLockInitialized is set. */
+    fs_bool32 isArchiveDataLockInitialized;
+    fs_bool32 hasTriedMappingArchive;   /* Mapping is only attempted once. If it fails, stored files will be read into memory instead. */
+    fs_bool32 isWriting;            /* Set when a new archive is being written rather than an existing one being read. None of the reading state is used in this case. */
+    fs_zip_write_entry** ppWriteEntries;    /* In the order they were written to the stream. */
+    size_t writeEntryCount;
+    size_t writeEntryCap;
+    fs_zip_path_hash_slot* pWriteEntryTable;    /* Maps a path to an entry. The iNode member is the index of the entry plus one so that 0 can mark an empty slot. */
+    size_t writeEntryTableCap;      /* Always a power of two. */
+    fs_uint64 writeCursor;          /* The number of bytes that have been written to the stream. */
+    fs_bool32 isWritingFile;        /* Only one file can be written at a time since its data goes straight to the stream. */
+    fs_result writeResult;          /* The first error that came back from the stream, or from queuing data for compression. Once set, nothing more is written. */
+    fs_uint16 writeDosTime;         /* The modified time given to each entry. */
+    fs_uint16 writeDosDate;
+    int compressionLevel;           /* Files are stored without compression when this is 0, in which case none of the batch state is used. */
+    size_t compressThreadCount;
+    fs_zip_deflate_compressor* pCompressors;    /* One for each thread. */
+    fs_uint8* pBatchInput;          /* The uncompressed data of the batch. */
+    size_t batchInputSize;
+    size_t batchInputCap;
+    size_t batchFileOffset;         /* Where the data of the file being written starts in the batch. This includes any dictionary carried over from the previous batch. */
+    size_t batchChunkOffset;        /* The start of the data of the file being written that hasn't been put into a chunk yet. */
+    fs_uint8* pBatchOutput;
+    size_t batchOutputCap;
+    fs_zip_write_chunk* pBatchChunks;
+    size_t batchChunkCount;
+    size_t batchChunkCap;
+    fs_zip_write_item* pBatchItems;
+    size_t batchItemCount;
+    size_t batchItemCap;
+} fs_zip;
+
+typedef struct fs_zip_file_info
+{
+    const char* pPath;
+    size_t pathLen;
+    fs_uint16 compressionMethod;
+    fs_uint64 compressedSize;
+    fs_uint64 uncompressedSize;
+    fs_uint64 fileOffset;            /* The offset in bytes from the start of the archive file. */
+    fs_uint32 crc32;                 /* The CRC-32 of the uncompressed data. */
+    fs_bool32 directory;
+} fs_zip_file_info;
+
+static size_t fs_alloc_size_zip(const void* pBackendConfig)
+{
+    (void)pBackendConfig;
+
+    return sizeof(fs_zip);
+}
+
+
+typedef struct fs_zip_refstring
+{
+    const char* str;
+    size_t len;
+} fs_zip_refstring;
+
+static int fs_zip_binary_search_zip_cd_node_compare(void* pUserData, const void* pKey, const void* pVal)
+{
+    const fs_zip_refstring* pRefString = (const fs_zip_refstring*)pKey;
+    const fs_zip_cd_node* pNode = (const fs_zip_cd_node*)pVal;
+    int compareResult;
+
+    (void)pUserData;
+
+    compareResult = strncmp(pRefString->str, pNode->pName, FS_ZIP_MIN(pRefString->len, pNode->nameLen));
+    if (compareResult == 0 && pRefString->len != pNode->nameLen) {
+        compareResult = (pRefString->len < pNode->nameLen) ? -1 : 1;
+    }
+
+    return compareResult;
+}
+
+static fs_zip_cd_node* fs_zip_cd_node_find_child(fs_zip_cd_node* pParent, const char* pChildName, size_t childNameLen)
+{
+    fs_zip_refstring str;
+    str.str = pChildName;
+    str.len = childNameLen;
+
+    return (fs_zip_cd_node*)fs_sorted_search(&str, pParent->pChildren, pParent->childCount, sizeof(*pParent->pChildren), fs_zip_binary_search_zip_cd_node_compare, NULL);
+}
+
+/*
+The path hash table is an optional acceleration structure which allows a path to be resolved with a
+single lookup rather than a binary search at each level of the node graph. Each node is hashed by the
+names of each node on the path from the root. We keep track of each node's parent so that a match can
+be verified exactly by walking back up to the root.
+*/
+#define FS_ZIP_PATH_HASH_BASIS  2166136261U
+#define FS_ZIP_PATH_HASH_PRIME  16777619U
+
+static fs_uint32 fs_zip_path_hash_segment(fs_uint32 hash, const char* pSegment, size_t segmentLen)
+{
+    size_t i;
+
+    /* The separator is hashed as well so that "ab/c" and "a/bc" produce different hashes. */
+    hash ^= (fs_uint8)'/';
+    hash *= FS_ZIP_PATH_HASH_PRIME;
+
+    for (i = 0; i < segmentLen; i += 1) {
+        hash ^= (fs_uint8)pSegment[i];
+        hash *= FS_ZIP_PATH_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+static fs_result fs_zip_build_path_hash_table(fs_zip* pZip, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    size_t iNode;
+    size_t iChild;
+    size_t cap;
+    size_t mask;
+
+    FS_ZIP_ASSERT(pZip != NULL);
+    FS_ZIP_ASSERT(pZip->nodeCount > 0);
+
+    /* Node indexes are stored as 32-bit to keep the table small. */
+    if (pZip->nodeCount > 0x7FFFFFFF) {
+        return FS_TOO_BIG;
+    }
+
+    /* Keep the load factor under 0.75 so probe sequences stay short. */
+    cap = 16;
+    while (cap < pZip->nodeCount + (pZip->nodeCount / 3) + 1) {
+        cap *= 2;
+    }
+
+    pZip->pPathHashHeap = fs_malloc((sizeof(*pZip->pPathHashNodes) * pZip->nodeCount) + (sizeof(*pZip->pPathHashTable) * cap), pAllocationCallbacks);
+    if (pZip->pPathHashHeap == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    pZip->pPathHashNodes   = (fs_zip_path_hash_node*)pZip->pPathHashHeap;
+    pZip->pPathHashTable   = (fs_zip_path_hash_slot*)FS_ZIP_OFFSET_PTR(pZip->pPathHashHeap, sizeof(*pZip->pPathHashNodes) * pZip->nodeCount);
+    pZip->pathHashTableCap = cap;
+    mask = cap - 1;
+
+    FS_ZIP_ZERO_MEMORY(pZip->pPathHashTable, sizeof(*pZip->pPathHashTable) * cap);
+
+    pZip->pPathHashNodes[0].hash    = FS_ZIP_PATH_HASH_BASIS;
+    pZip->pPathHashNodes[0].iParent = 0;
+
+    /*
+    Children are always stored after their parent in the node array which means a single linear pass
+    will always see a parent's hash before any of its children.
+    */
+    for (iNode = 0; iNode < pZip->nodeCount; iNode += 1) {
+        const fs_zip_cd_node* pNode = &pZip->pCDRootNode[iNode];
+
+        for (iChild = 0; iChild < pNode->childCount; iChild += 1) {
+            const fs_zip_cd_node* pChild = &pNode->pChildren[iChild];
+            size_t iChildNode = (size_t)(pChild - pZip->pCDRootNode);
+            fs_uint32 hash;
+            size_t iSlot;
+
+            FS_ZIP_ASSERT(iChildNode > iNode && iChildNode < pZip->nodeCount);
+
+            hash = fs_zip_path_hash_segment(pZip->pPathHashNodes[iNode].hash, pChild->pName, pChild->nameLen);
+
+            pZip->pPathHashNodes[iChildNode].hash    = hash;
+            pZip->pPathHashNodes[iChildNode].iParent = (fs_uint32)iNode;
+
+            /* The root node is never inserted which means we can use 0 to mark an empty slot. */
+            iSlot = hash & mask;
+            while (pZip->pPathHashTable[iSlot].iNode != 0) {
+                iSlot = (iSlot + 1) & mask;
+            }
+
+            pZip->pPathHashTable[iSlot].hash  = hash;
+            pZip->pPathHashTable[iSlot].iNode = (fs_uint32)iChildNode;
+        }
+    }
+
+    return FS_SUCCESS;
+}
+
+static fs_bool32 fs_zip_path_hash_node_matches(const fs_zip* pZip, size_t iNode, const char* pPath, size_t pathLen)
+{
+    fs_path_iterator pathIterator;
+
+    if (fs_path_last(pPath, pathLen, &pathIterator) != FS_SUCCESS) {
+        return FS_FALSE;
+    }
+
+    /* Walk back up to the root, comparing each segment as we go. */
+    for (;;) {
+        const fs_zip_cd_node* pNode = &pZip->pCDRootNode[iNode];
+
+        if (pNode->nameLen != pathIterator.segmentLength || strncmp(pNode->pName, pathIterator.pFullPath + pathIterator.segmentOffset, pNode->nameLen) != 0) {
+            return FS_FALSE;
+        }
+
+        iNode = pZip->pPathHashNodes[iNode].iParent;
+
+        if (fs_path_prev(&pathIterator) != FS_SUCCESS) {
+            return iNode == 0;  /* We've run out of segments. It's only a match if we've also reached the root. */
+        }
+
+        if (iNode == 0) {
+            return FS_FALSE;    /* Reached the root, but there are still segments remaining. */
+        }
+    }
+}
+
+static fs_zip_cd_node* fs_zip_find_node_by_path_hash(const fs_zip* pZip, const char* pPath, size_t pathLen)
+{
+    fs_path_iterator pathIterator;
+    fs_uint32 hash;
+    size_t mask;
+    size_t iSlot;
+
+    FS_ZIP_ASSERT(pZip->pPathHashTable != NULL);
+
+    if (fs_path_first(pPath, pathLen, &pathIterator) != FS_SUCCESS) {
+        return NULL;
+    }
+
+    hash = FS_ZIP_PATH_HASH_BASIS;
+    do {
+        hash = fs_zip_path_hash_segment(hash, pathIterator.pFullPath + pathIterator.segmentOffset, pathIterator.segmentLength);
+    } while (fs_path_next(&pathIterator) == FS_SUCCESS);
+
+    mask  = pZip->pathHashTableCap - 1;
+    iSlot = hash & mask;
+
+    while (pZip->pPathHashTable[iSlot].iNode != 0) {
+        if (pZip->pPathHashTable[iSlot].hash == hash && fs_zip_path_hash_node_matches(pZip, pZip->pPathHashTable[iSlot].iNode, pPath, pathLen)) {
+            return &pZip->pCDRootNode[pZip->pPathHashTable[iSlot].iNode];
+        }
+
+        iSlot = (iSlot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+
+static fs_result fs_zip_get_file_info_by_record_offset(fs_zip* pZip, size_t offset, fs_zip_file_info* pInfo)
+{
+    fs_uint16 filePathLen;
+    const unsigned char* pCentralDirectoryRecord;
+
+    FS_ZIP_ASSERT(pZip  != NULL);
+    FS_ZIP_ASSERT(pInfo != NULL);
+
+    FS_ZIP_ZERO_OBJECT(pInfo);
+
+    pCentralDirectoryRecord = (const unsigned char*)FS_ZIP_OFFSET_PTR(pZip->pCentralDirectory, offset);
+
+    /* Check that we're not going to overflow the central directory. */
+    if (offset + 46 > pZip->centralDirectorySize) {   /* 46 is the offset of the file path. */
+        return FS_INVALID_FILE;  /* Look like an invalid central directory. */
+    }
+
+    /* Grab the length of the file path. */
+    filePathLen = ((fs_uint16)pCentralDirectoryRecord[29] << 8) | pCentralDirectoryRecord[28];
+
+    /* Now we can move to the file path, again making sure we have enough room for the file path. */
+    if (offset + 46 + filePathLen > pZip->centralDirectorySize) {
+        return FS_INVALID_FILE;  /* Looks like an invalid central directory. */
+    }
+
+    pInfo->pPath   = (const char*)(pCentralDirectoryRecord + 46);
+    pInfo->pathLen = filePathLen;
+
+    /* We can determine if the entry is a directory by checking if the path ends in a slash. */
+    if (pInfo->pathLen > 0 && (pInfo->pPath[pInfo->pathLen-1] == '/' || pInfo->pPath[pInfo->pathLen-1] == '\\')) {
+        pInfo->directory = FS_TRUE;
+    }
+
+    /* Compression method. */
+    pInfo->compressionMethod = ((fs_uint16)pCentralDirectoryRecord[11] << 8) | pCentralDirectoryRecord[10];
+
+    /* CRC-32 of the uncompressed data. This is always set in the central directory, even when the local header defers it to a data descriptor. */
+    pInfo->crc32 = ((fs_uint32)pCentralDirectoryRecord[19] << 24) | ((fs_uint32)pCentralDirectoryRecord[18] << 16) | ((fs_uint32)pCentralDirectoryRecord[17] << 8) | (fs_uint32)pCentralDirectoryRecord[16];
+
+    /* Get the size of the file. */
+    pInfo->compressedSize   = ((fs_uint32)pCentralDirectoryRecord[23] << 24) | ((fs_uint32)pCentralDirectoryRecord[22] << 16) | ((fs_uint32)pCentralDirectoryRecord[21] << 8) | (fs_uint32)pCentralDirectoryRecord[20];
+    pInfo->uncompressedSize = ((fs_uint32)pCentralDirectoryRecord[27] << 24) | ((fs_uint32)pCentralDirectoryRecord[26] << 16) | ((fs_uint32)pCentralDirectoryRecord[25] << 8) | (fs_uint32)pCentralDirectoryRecord[24];
+
+    /* File offset. */
+    pInfo->fileOffset = ((fs_uint32)pCentralDirectoryRecord[45] << 24) | ((fs_uint32)pCentralDirectoryRecord[44] << 16) | ((fs_uint32)pCentralDirectoryRecord[43] << 8) | pCentralDirectoryRecord[42];
+
+
+    /*
+    Load Zip64 data if necessary. It's in the extra data. The extra data is made up of a
+    number of blocks. Each block has a 2 byte ID and a 2 byte size. When reading from
+    each block, we need to make sure we don't try reading beyond the reported size of
+    the extra data.
+    
+    The Zip64 data will be stored in a block with the ID of 0x0001. The presence of each
+    member inside this block is conditional to whether or not it's set to 0xFFFFFFFF in
+    the main part of the central directory record.
+    */
+    if (pInfo->compressedSize == 0xFFFFFFFF || pInfo->uncompressedSize == 0xFFFFFFFF || pInfo->fileOffset == 0xFFFFFFFF) {
+        fs_uint16 extraDataSize   = ((fs_uint16)pCentralDirectoryRecord[31] << 8) | pCentralDirectoryRecord[30];
+        fs_uint16 extraDataOffset = 0;
+
+        const unsigned char* pExtraData = (const unsigned char*)(pCentralDirectoryRecord + 46 + filePathLen);
+
+        /* For each chunk in the extra data. */
+        for (;;) {
+            fs_uint16 chunkID;
+            fs_uint16 chunkSize;
+
+            if (extraDataOffset == extraDataSize) {
+                break;  /* We're done. */
+            }
+
+            if (extraDataOffset > extraDataSize) {
+                return FS_INVALID_FILE;  /* We've somehow read past the extra data. Abort. */
+            }
+
+            if ((extraDataSize - extraDataOffset) < 4) {
+                return FS_INVALID_FILE;  /* Not enough data in the extra data to read the chunk header. */
+            }
+
+            chunkID   = ((fs_uint16)pExtraData[extraDataOffset+1] << 8) | pExtraData[extraDataOffset+0];
+            chunkSize = ((fs_uint16)pExtraData[extraDataOffset+3] << 8) | pExtraData[extraDataOffset+2];
+
+            /* Increment the offset to make it easy to parse the data in the next section. */
+            extraDataOffset += 4;
+
+            if ((extraDataSize - extraDataOffset) < chunkSize) {
+                return FS_INVALID_FILE;  /* Not enough data in the extra data to read the chunk. */
+            }
+
+            if (chunkID == 0x0001) {
+                /* Zip64 data. */
+                fs_uint32 chunkLocalOffset = 0;
+
+                if (pInfo->uncompressedSize == 0xFFFFFFFF) {
+                    if (chunkLocalOffset + 8 > chunkSize) {
+                        return FS_INVALID_FILE;  /* Not enough data in the chunk. */
+                    }
+
+                    pInfo->uncompressedSize = ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+7] << 56) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+6] << 48) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+5] << 40) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+4] << 32) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+3] << 24) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+2] << 16) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+1] << 8) | (fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+0];
+                    chunkLocalOffset += 8;
+                }
+
+                if (pInfo->compressedSize == 0xFFFFFFFF) {
+                    if (chunkLocalOffset + 8 > chunkSize) {
+                        return FS_INVALID_FILE;  /* Not enough data in the chunk. */
+                    }
+
+                    pInfo->compressedSize = ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+7] << 56) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+6] << 48) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+5] << 40) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+4] << 32) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+3] << 24) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+2] << 16) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+1] << 8) | (fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+0];
+                    chunkLocalOffset += 8;
+                }
+
+                if (pInfo->fileOffset == 0xFFFFFFFF) {
+                    if (chunkLocalOffset + 8 > chunkSize) {
+                        return FS_INVALID_FILE;  /* Not enough data in the chunk. */
+                    }
+
+                    pInfo->fileOffset = ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+7] << 56) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+6] << 48) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+5] << 40) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+4] << 32) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+3] << 24) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+2] << 16) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+1] << 8) | (fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+0];
+                    chunkLocalOffset += 8; (void)chunkLocalOffset;
+                }
+            }
+
+            extraDataOffset += chunkSize;
+        }
+    }
+
+    return FS_SUCCESS;
+}
+
+static const char* fs_zip_get_file_path_by_record_offset(fs_zip* pZip, size_t offset, size_t* pLength)
+{
+    fs_uint16 length;
+    const char* pCentralDirectoryRecord;
+
+    FS_ZIP_ASSERT(pLength != NULL);
+
+    *pLength = 0;
+
+    pCentralDirectoryRecord = (const char*)FS_ZIP_OFFSET_PTR(pZip->pCentralDirectory, offset);
+
+    /* Check that we're not going to overflow the central directory. */
+    if (offset + 46 > pZip->centralDirectorySize) {   /* 46 is the offset of the file path. */
+        return NULL;    /* Look like an invalid central directory. */
+    }
+
+    /* Grab the length of the file. */
+    length = ((fs_uint16)pCentralDirectoryRecord[29] << 8) | pCentralDirectoryRecord[28];
+
+    /* Now we can move to the file path, again making sure we have enough room for the file path. */
+    if (offset + 46 + length > pZip->centralDirectorySize) {
+        return NULL;    /* Looks like an invalid central directory. */
+    }
+
+    /* We now how enough information to get the file path. */
+    *pLength = length;
+    return pCentralDirectoryRecord + 46;
+}
+
+static fs_result fs_zip_find_file_by_path(fs_zip* pZip, const fs_allocation_callbacks* pAllocationCallbacks, const char* pFilePath, size_t filePathLen, size_t* pFileIndex)
+{
+    fs_result result;
+    fs_path_iterator pathIterator;
+    fs_zip_cd_node* pCurrentNode;
+    char  pFilePathCleanStack[1024];
+    char* pFilePathCleanHeap = NULL;
+    char* pFilePathClean;
+    int filePathCleanLen;
+
+    FS_ZIP_ASSERT(pZip       != NULL);
+    FS_ZIP_ASSERT(pFilePath  != NULL);
+    FS_ZIP_ASSERT(pFileIndex != NULL);
+
+    if (filePathLen == 0) {
+        return FS_INVALID_ARGS; /* The path is empty. */
+    }
+
+    /* Skip past the root item if any. */
+    if (pFilePath[0] == '/' || pFilePath[0] == '\\') {
+        pFilePath += 1;
+        if (filePathLen > 0 && filePathLen != FS_NULL_TERMINATED) {
+            filePathLen -= 1;
+        }
+    }
+
+    /* The path must be clean of any special directories. We'll have to clean the path with fs_path_normalize(). */
+    filePathCleanLen = fs_path_normalize(pFilePathCleanStack, sizeof(pFilePathCleanStack), pFilePath, filePathLen, FS_NO_ABOVE_ROOT_NAVIGATION);
+    if (filePathCleanLen < 0) {
+        return FS_DOES_NOT_EXIST;
+    }
+
+    if (filePathCleanLen > (int)sizeof(pFilePathCleanStack)) {
+        pFilePathCleanHeap = (char*)fs_malloc(filePathCleanLen + 1, pAllocationCallbacks);
+        if (pFilePathCleanHeap == NULL) {
+            return FS_OUT_OF_MEMORY;
+        }
+
+        fs_path_normalize(pFilePathCleanHeap, filePathCleanLen + 1, pFilePath, filePathLen, FS_NO_ABOVE_ROOT_NAVIGATION); /* <-- This should never fail. */
+        pFilePathClean = pFilePathCleanHeap;
+    } else {
+        pFilePathClean = pFilePathCleanStack;
+    }
+
+    /* If we have a hash table we can skip the walk down the node graph. */
+    if (pZip->pPathHashTable != NULL) {
+        pCurrentNode = fs_zip_find_node_by_path_hash(pZip, pFilePathClean, (size_t)filePathCleanLen);
+        if (pCurrentNode != NULL) {
+            *pFileIndex = pCurrentNode->iFile;
+            result = FS_SUCCESS;
+        } else {
+            result = FS_DOES_NOT_EXIST;
+        }
+
+        fs_free(pFilePathCleanHeap, pAllocationCallbacks);
+        return result;
+    }
+
+    /* Start at the root node. */
+    pCurrentNode = pZip->pCDRootNode;
+
+    result = fs_result_from_errno(fs_path_first(pFilePathClean, (size_t)filePathCleanLen, &pathIterator));
+    if (result == FS_SUCCESS) {
+        /* Reset the error code for safety. The loop below will be setting it to a proper value. */
+        for (;;) {
+            fs_zip_cd_node* pChildNode;
+            
+            pChildNode = fs_zip_cd_node_find_child(pCurrentNode, pathIterator.pFullPath + pathIterator.segmentOffset, pathIterator.segmentLength);
+            if (pChildNode == NULL) {
+                result = FS_DOES_NOT_EXIST;
+                break;
+            }
+
+            pCurrentNode = pChildNode;
+
+            result = fs_result_from_errno(fs_path_next(&pathIterator));
+            if (result != FS_SUCCESS) {
+                /* We've reached the end. The file we're on must be the file index. */
+                *pFileIndex = pCurrentNode->iFile;
+
+                result = FS_SUCCESS;
+                break;
+            }
+        }
+    } else {
+        result = FS_DOES_NOT_EXIST;
+    }
+
+    fs_free(pFilePathCleanHeap, pAllocationCallbacks);
+    return result;
+}
+
+static fs_result fs_zip_get_file_info_by_path(fs_zip* pZip, const fs_allocation_callbacks* pAllocationCallbacks, const char* pFilePath, size_t filePathLen, fs_zip_file_info* pInfo)
+{
+    fs_result result;
+    size_t iFile;
+
+    FS_ZIP_ASSERT(pZip      != NULL);
+    FS_ZIP_ASSERT(pFilePath != NULL);
+    FS_ZIP_ASSERT(pInfo     != NULL);
+
+    result = fs_zip_find_file_by_path(pZip, pAllocationCallbacks, pFilePath, filePathLen, &iFile);
+    if (result != FS_SUCCESS) {
+        return result;  /* Most likely the file could not be found. */
+    }
+
+    return fs_zip_get_file_info_by_record_offset(pZip, pZip->pIndex[iFile].offsetInBytes, pInfo);
+}
+
+static int fs_zip_qsort_compare(void* pUserData, const void* a, const void* b)
+{
+    fs_zip* pZip = (fs_zip*)pUserData;
+    const fs_zip_index* pZipIndex0 = (const fs_zip_index*)a;
+    const fs_zip_index* pZipIndex1 = (const fs_zip_index*)b;
+    size_t fileNameLen0;
+    const char* pFileName0;
+    size_t fileNameLen1;
+    const char* pFileName1;
+    int compareResult;
+
+    FS_ZIP_ASSERT(pZip != NULL);
+
+    pFileName0 = fs_zip_get_file_path_by_record_offset(pZip, pZipIndex0->offsetInBytes, &fileNameLen0);
+    if (pFileName0 == NULL) {
+        pFileName0 = "";    /* File couldn't be found. Just treat it as an empty string. */
+    }
+
+    pFileName1 = fs_zip_get_file_path_by_record_offset(pZip, pZipIndex1->offsetInBytes, &fileNameLen1);
+    if (pFileName1 == NULL) {
+        pFileName1 = "";    /* File couldn't be found. Just treat it as an empty string. */
+    }
+
+    compareResult = strncmp(pFileName0, pFileName1, FS_ZIP_MIN(fileNameLen0, fileNameLen1));
+    if (compareResult == 0 && fileNameLen0 != fileNameLen1) {
+        /* The strings are the same up to the length of the shorter string. The shorter string is considered to be less than the longer string. */
+        compareResult = (fileNameLen0 < fileNameLen1) ? -1 : 1;
+    }
+
+    return compareResult;
+}
+
+static void fs_zip_cd_node_build(fs_zip* pZip, fs_zip_cd_node** ppRunningChildrenPointer, fs_zip_cd_node* pNode)
+{
+    size_t iFile;
+    size_t iChild;
+
+    FS_ZIP_ASSERT(pZip  != NULL);
+    FS_ZIP_ASSERT(pNode != NULL);
+    FS_ZIP_ASSERT(pNode->_descendantRangeEnd <= pZip->fileCount);
+    FS_ZIP_ASSERT(ppRunningChildrenPointer != NULL);
+
+    pNode->childCount = 0;
+    pNode->pChildren  = *ppRunningChildrenPointer;
+
+    /*
+    We need to loop through our file range and add any direct children first. Then once that's
+    done, we iterate over each child node and fill them out recursively.
+    */
+    for (iFile = pNode->_descendantRangeBeg; iFile < pNode->_descendantRangeEnd; iFile += 1) {
+        const char* pFullFilePath;
+        size_t fullFilePathLen;
+        const char* pShortFilePath;
+        size_t shortFilePathLen;
+        fs_path_iterator shortFilePathIterator;
+
+        pFullFilePath = fs_zip_get_file_path_by_record_offset(pZip, pZip->pIndex[iFile].offsetInBytes, &fullFilePathLen);
+        if (pFullFilePath == NULL) {
+            continue;   /* Should never happen. Just ignore the file if we couldn't find it by the given offset. */
+        }
+
+        /* If the full file path length is equal to the descendant prefix length, it means it's a leaf node. */
+        FS_ZIP_ASSERT(fullFilePathLen >= pNode->_descendantPrefixLen);
+        if (fullFilePathLen == pNode->_descendantPrefixLen) {
+            continue;
+        }
+
+        /* The short file path is simply the full file path without the descendant prefix. */
+        pShortFilePath   = pFullFilePath   + pNode->_descendantPrefixLen;
+        shortFilePathLen = fullFilePathLen - pNode->_descendantPrefixLen;
+
+        /* Make sure we're not sitting on a path separator. */
+        if (pShortFilePath[0] == '\\' || pShortFilePath[0] == '/') {
+            pShortFilePath   += 1;
+            shortFilePathLen -= 1;
+        }
+
+        /*
+        Now we need to check if we need to add a child. Because this main file listing is sorted,
+        we need only check the last child item. If it's not equal, we have a new child item.
+        */
+        if (fs_path_first(pShortFilePath, shortFilePathLen, &shortFilePathIterator) == FS_SUCCESS) {
+            if (pNode->childCount == 0 || pNode->pChildren[pNode->childCount-1].nameLen != shortFilePathIterator.segmentLength || strncmp(pNode->pChildren[pNode->childCount-1].pName, shortFilePathIterator.pFullPath + shortFilePathIterator.segmentOffset, FS_ZIP_MIN(pNode->pChildren[pNode->childCount-1].nameLen, shortFilePathIterator.segmentLength)) != 0) {
+                /* Child doesn't exist. Need to add it to the list. */
+                pNode->pChildren[pNode->childCount].iFile                = iFile;
+                pNode->pChildren[pNode->childCount].pName                = shortFilePathIterator.pFullPath + shortFilePathIterator.segmentOffset;
+                pNode->pChildren[pNode->childCount].nameLen              = shortFilePathIterator.segmentLength;
+                pNode->pChildren[pNode->childCount]._descendantRangeBeg  = iFile;
+                pNode->pChildren[pNode->childCount]._descendantRangeEnd  = pNode->_descendantRangeEnd;
+                pNode->pChildren[pNode->childCount]._descendantPrefixLen = (fullFilePathLen - shortFilePathLen) + shortFilePathIterator.segmentLength;
+
+                /* Update the end range for the previous child if we have one. */
+                if (pNode->childCount > 0) {
+                    pNode->pChildren[pNode->childCount-1]._descendantRangeEnd = iFile;
+                }
+
+                pNode->childCount         += 1;
+                *ppRunningChildrenPointer += 1;
+            }
+        } else {
+            /*
+            Couldn't get the first segment. This probably means we found an explicit directory
+            listing. We just ignore it.
+            */
+            if (pNode->childCount > 0) {
+                pNode->pChildren[pNode->childCount-1]._descendantRangeEnd = iFile;
+            }
+        }
+    }
+
+    /* We've initialized each of the child nodes. We now need to recursively process them. */
+    for (iChild = 0; iChild < pNode->childCount; iChild += 1) {
+        fs_zip_cd_node_build(pZip, ppRunningChildrenPointer, &pNode->pChildren[iChild]);
+    }
+}
+
+
+/*
+The index is built in three stages. The records are scanned, the index is sorted, and then the
+nodes are counted. Scanning needs to be done sequentially because the position of each record
+depends on the size of the previous one. The sort and the count can be split across threads.
+
+The sort works by sorting equally sized runs on their own thread, and then merging pairs of runs
+together in passes until there is only a single run left. The merge takes from the left run when
+items compare equal so the end result is exactly the same as a single-threaded stable sort.
+*/
+#define FS_ZIP_MAX_THREAD_COUNT         64
+#define FS_ZIP_MIN_FILES_PER_THREAD     16384
+
+typedef struct
+{
+    fs_zip* pZip;
+    const fs_zip_index* pSrc;
+    fs_zip_index* pDst;
+    size_t iBeg;
+    size_t iMid;
+    size_t iEnd;
+    size_t nodeCount;
+    const fs_allocation_callbacks* pAllocationCallbacks;
+} fs_zip_index_job;
+
+static size_t fs_zip_count_nodes(fs_zip* pZip, size_t iBeg, size_t iEnd)
+{
+    const char* pPrevPath;
+    size_t prevPathLen;
+    size_t nodeCount = 0;
+    size_t iFile;
+
+    /*
+    The count for each item is based on the previous item. When we're not starting from the first
+    item we need to use the item sitting just before the range. If that fails we just fall back to
+    the root which will result in a higher count for the first item, but since this is only an
+    upper bound that's fine.
+    */
+    pPrevPath = NULL;
+    prevPathLen = 0;
+
+    if (iBeg > 0) {
+        pPrevPath = fs_zip_get_file_path_by_record_offset(pZip, pZip->pIndex[iBeg - 1].offsetInBytes, &prevPathLen);
+    }
+
+    if (pPrevPath == NULL) {
+        /* Consider the root directory to be the previous path. */
+        pPrevPath = "";
+        prevPathLen = 0;
+    }
+
+    for (iFile = iBeg; iFile < iEnd; iFile += 1) {
+        const char* pFilePath;
+        size_t filePathLen;
+
+        pFilePath = fs_zip_get_file_path_by_record_offset(pZip, pZip->pIndex[iFile].offsetInBytes, &filePathLen);
+        if (pFilePath == NULL) {
+            continue;   /* Just skip the file if we can't get the name. Should never happen. */
+        }
+
+        /*
+        Now that we have the file path all we need to do is compare is to the previous path
+        and increment the counter for every segment in the current path that is different
+        to the previous path. We'll need to use a path iterator for each of these.
+        */
+        {
+            fs_path_iterator nextIterator;
+            fs_path_iterator prevIterator;
+
+            fs_path_first(pFilePath, filePathLen, &nextIterator);   /* <-- This should never fail. */
+
+            if (fs_path_first(pPrevPath, prevPathLen, &prevIterator) == FS_SUCCESS) {
+                /*
+                First just move the next iterator forward until we reach the end of the previous
+                iterator, or if the segments differ between the two.
+                */
+                for (;;) {
+                    if (fs_path_iterators_compare(&nextIterator, &prevIterator) != 0) {
+                        break;  /* Iterators don't match. */
+                    }
+
+                    /* Getting here means the segments match. We need to move to the next one. */
+                    if (fs_path_next(&nextIterator) != FS_SUCCESS) {
+                        break;  /* We reached the end of the next iterator before the previous. The only difference will be the file name. */
+                    }
+
+                    if (fs_path_next(&prevIterator) != FS_SUCCESS) {
+                        break;  /* We reached the end of the prev iterator. Get out of the loop. */
+                    }
+                }
+            }
+
+            /* Increment the counter to account for the segment that the next iterator is currently sitting on. */
+            nodeCount += 1;
+
+            /* Now we need to increment the counter for every new segment. */
+            while (fs_path_next(&nextIterator) == FS_SUCCESS) {
+                nodeCount += 1;
+            }
+        }
+
+        /* Getting here means we're done with the count for this item. Move to the next one. */
+        pPrevPath = pFilePath;
+        prevPathLen = filePathLen;
+    }
+
+    return nodeCount;
+}
+
+static int fs_zip_index_job_sort(void* pUserData)
+{
+    fs_zip_index_job* pJob = (fs_zip_index_job*)pUserData;
+
+    fs_sort_ex(pJob->pZip->pIndex + pJob->iBeg, pJob->iEnd - pJob->iBeg, sizeof(fs_zip_index), fs_zip_qsort_compare, pJob->pZip, pJob->pAllocationCallbacks);
+
+    return 0;
+}
+
+static int fs_zip_index_job_merge(void* pUserData)
+{
+    fs_zip_index_job* pJob = (fs_zip_index_job*)pUserData;
+    size_t iLeft  = pJob->iBeg;
+    size_t iRight = pJob->iMid;
+    size_t iDst   = pJob->iBeg;
+
+    /* Skip the merge entirely if the two runs are already in order. */
+    if (iLeft < pJob->iMid && iRight < pJob->iEnd && fs_zip_qsort_compare(pJob->pZip, &pJob->pSrc[iRight - 1], &pJob->pSrc[iRight]) > 0) {
+        while (iLeft < pJob->iMid && iRight < pJob->iEnd) {
+            /* Take from the left on ties to keep the sort stable. */
+            if (fs_zip_qsort_compare(pJob->pZip, &pJob->pSrc[iLeft], &pJob->pSrc[iRight]) <= 0) {
+                pJob->pDst[iDst++] = pJob->pSrc[iLeft++];
+            } else {
+                pJob->pDst[iDst++] = pJob->pSrc[iRight++];
+            }
+        }
+    }
+
+    FS_ZIP_COPY_MEMORY(pJob->pDst + iDst, pJob->pSrc + iLeft, (pJob->iMid - iLeft) * sizeof(fs_zip_index));
+    iDst += pJob->iMid - iLeft;
+
+    FS_ZIP_COPY_MEMORY(pJob->pDst + iDst, pJob->pSrc + iRight, (pJob->iEnd - iRight) * sizeof(fs_zip_index));
+
+    return 0;
+}
+
+static int fs_zip_index_job_count(void* pUserData)
+{
+    fs_zip_index_job* pJob = (fs_zip_index_job*)pUserData;
+
+    pJob->nodeCount = fs_zip_count_nodes(pJob->pZip, pJob->iBeg, pJob->iEnd);
+
+    return 0;
+}
+
+static void fs_zip_run_jobs(fs_thrd_start_t proc, void* pJobs, size_t jobSize, size_t jobCount, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_thrd threads[FS_ZIP_MAX_THREAD_COUNT];
+    fs_bool32 isThreadRunning[FS_ZIP_MAX_THREAD_COUNT];
+    size_t iJob;
+
+    FS_ZIP_ASSERT(jobCount > 0);
+    FS_ZIP_ASSERT(jobCount <= FS_ZIP_MAX_THREAD_COUNT);
+
+    /* The first job is run on the calling thread. */
+    for (iJob = 1; iJob < jobCount; iJob += 1) {
+        isThreadRunning[iJob] = (fs_thrd_create(&threads[iJob], proc, FS_ZIP_OFFSET_PTR(pJobs, jobSize * iJob), pAllocationCallbacks) == FS_SUCCESS);
+    }
+
+    proc(pJobs);
+
+    for (iJob = 1; iJob < jobCount; iJob += 1) {
+        if (isThreadRunning[iJob]) {
+            fs_thrd_join(threads[iJob], NULL);
+        } else {
+            proc(FS_ZIP_OFFSET_PTR(pJobs, jobSize * iJob));     /* Failed to create the thread. Just run it on this thread. */
+        }
+    }
+}
+
+static size_t fs_zip_calculate_index_thread_count(const fs_zip* pZip, int threadCount)
+{
+    size_t maxThreadCount;
+
+    if (threadCount <= 1) {
+        return 1;
+    }
+
+    /* Don't bother with threading unless each thread has a decent amount of work to do. */
+    maxThreadCount = pZip->fileCount / FS_ZIP_MIN_FILES_PER_THREAD;
+    if (maxThreadCount > FS_ZIP_MAX_THREAD_COUNT) {
+        maxThreadCount = FS_ZIP_MAX_THREAD_COUNT;
+    }
+
+    if ((size_t)threadCount < maxThreadCount) {
+        return (size_t)threadCount;
+    }
+
+    if (maxThreadCount == 0) {
+        return 1;
+    }
+
+    return maxThreadCount;
+}
+
+static void fs_zip_sort_index(fs_zip* pZip, size_t threadCount, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_zip_index_job jobs[FS_ZIP_MAX_THREAD_COUNT];
+    size_t runBounds[FS_ZIP_MAX_THREAD_COUNT + 1];
+    size_t runCount;
+    size_t iRun;
+    fs_zip_index* pTemp;
+    fs_zip_index* pSrc;
+    fs_zip_index* pDst;
+
+    /*
+    Archivers tend to write the central directory in an order that is already mostly sorted. The
+    sort is a merge sort that skips merging runs that are already in order so that case is cheap.
+    */
+    if (threadCount <= 1) {
+        fs_sort_ex(pZip->pIndex, pZip->fileCount, sizeof(fs_zip_index), fs_zip_qsort_compare, pZip, pAllocationCallbacks);
+        return;
+    }
+
+    pTemp = (fs_zip_index*)fs_malloc(sizeof(fs_zip_index) * pZip->fileCount, pAllocationCallbacks);
+    if (pTemp == NULL) {
+        /* Not enough memory to do the merge. Just fall back to a single-threaded sort. */
+        fs_sort_ex(pZip->pIndex, pZip->fileCount, sizeof(fs_zip_index), fs_zip_qsort_compare, pZip, pAllocationCallbacks);
+        return;
+    }
+
+    /* Sort each run on it's own thread. */
+    runCount = threadCount;
+    for (iRun = 0; iRun <= runCount; iRun += 1) {
+        runBounds[iRun] = (pZip->fileCount / runCount) * iRun;
+    }
+    runBounds[runCount] = pZip->fileCount;
+
+    for (iRun = 0; iRun < runCount; iRun += 1) {
+        jobs[iRun].pZip = pZip;
+        jobs[iRun].iBeg = runBounds[iRun];
+        jobs[iRun].iEnd = runBounds[iRun + 1];
+        jobs[iRun].pAllocationCallbacks = pAllocationCallbacks;
+    }
+
+    fs_zip_run_jobs(fs_zip_index_job_sort, jobs, sizeof(jobs[0]), runCount, pAllocationCallbacks);
+
+    /* Now merge pairs of runs until we have only one left, ping-ponging between the two buffers. */
+    pSrc = pZip->pIndex;
+    pDst = pTemp;
+
+    while (runCount > 1) {
+        size_t jobCount = (runCount + 1) / 2;
+        fs_zip_index* pSwap;
+
+        for (iRun = 0; iRun < jobCount; iRun += 1) {
+            jobs[iRun].pZip = pZip;
+            jobs[iRun].pSrc = pSrc;
+            jobs[iRun].pDst = pDst;
+            jobs[iRun].iBeg = runBounds[iRun*2];
+
+            if (iRun*2 + 1 < runCount) {
+                jobs[iRun].iMid = runBounds[iRun*2 + 1];
+                jobs[iRun].iEnd = runBounds[iRun*2 + 2];
+            } else {
+                /* Odd one out. There's nothing to merge with so it'll just be copied over. */
+                jobs[iRun].iMid = runBounds[iRun*2 + 1];
+                jobs[iRun].iEnd = runBounds[iRun*2 + 1];
+            }
+        }
+
+        fs_zip_run_jobs(fs_zip_index_job_merge, jobs, sizeof(jobs[0]), jobCount, pAllocationCallbacks);
+
+        for (iRun = 0; iRun < jobCount; iRun += 1) {
+            runBounds[iRun] = jobs[iRun].iBeg;
+        }
+        runBounds[jobCount] = pZip->fileCount;
+        runCount = jobCount;
+
+        pSwap = pSrc;
+        pSrc  = pDst;
+        pDst  = pSwap;
+    }
+
+    /* The result needs to end up in the index. */
+    if (pSrc != pZip->pIndex) {
+        FS_ZIP_COPY_MEMORY(pZip->pIndex, pSrc, sizeof(fs_zip_index) * pZip->fileCount);
+    }
+
+    fs_free(pTemp, pAllocationCallbacks);
+}
+
+static size_t fs_zip_count_nodes_upper_bound(fs_zip* pZip, size_t threadCount, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_zip_index_job jobs[FS_ZIP_MAX_THREAD_COUNT];
+    size_t iJob;
+    size_t nodeCount;
+
+    if (threadCount <= 1) {
+        jobs[0].pZip = pZip;
+        jobs[0].iBeg = 0;
+        jobs[0].iEnd = pZip->fileCount;
+        fs_zip_index_job_count(&jobs[0]);
+    } else {
+        for (iJob = 0; iJob < threadCount; iJob += 1) {
+            jobs[iJob].pZip = pZip;
+            jobs[iJob].iBeg = (pZip->fileCount / threadCount) * iJob;
+            jobs[iJob].iEnd = (iJob + 1 < threadCount) ? (pZip->fileCount / threadCount) * (iJob + 1) : pZip->fileCount;
+        }
+
+        fs_zip_run_jobs(fs_zip_index_job_count, jobs, sizeof(jobs[0]), threadCount, pAllocationCallbacks);
+    }
+
+    /* Start the count at 1 to account for the root node. */
+    nodeCount = 1;
+    for (iJob = 0; iJob < FS_ZIP_MAX(threadCount, 1); iJob += 1) {
+        nodeCount += jobs[iJob].nodeCount;
+    }
+
+    return nodeCount;
+}
+
+/*
+Builds the sorted index and the node graph from the central directory. The central directory must
+have already been loaded into the heap, and the heap must have room for the index.
+*/
+static fs_result fs_zip_build_index(fs_zip* pZip, int threadCount, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_result result;
+    fs_memory_stream cdStream;
+    size_t iFile;
+    size_t nodeUpperBoundCount;
+    size_t indexThreadCount;
+
+    result = fs_memory_stream_init_readonly(pZip->pCentralDirectory, pZip->centralDirectorySize, &cdStream);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    for (iFile = 0; iFile < pZip->fileCount; iFile += 1) {
+        size_t fileOffset;
+        fs_uint16 fileNameLen;
+        fs_uint16 extraLen;
+        fs_uint16 commentLen;
+
+        result = fs_memory_stream_tell(&cdStream, &fileOffset);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        pZip->pIndex[iFile].offsetInBytes = fileOffset;
+
+
+        /*
+        We need to seek to the next item. To do this we need to retrieve the lengths of the
+        variable-length fields. These start from offset 28.
+        */
+        result = fs_memory_stream_seek(&cdStream, 28, FS_SEEK_CUR);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        result = fs_memory_stream_read(&cdStream, &fileNameLen, 2, NULL);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        result = fs_memory_stream_read(&cdStream, &extraLen, 2, NULL);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        result = fs_memory_stream_read(&cdStream, &commentLen, 2, NULL);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        /* We have the necessary information we need to move past this record. */
+        result = fs_memory_stream_seek(&cdStream, fileOffset + 46 + fileNameLen + extraLen + commentLen, FS_SEEK_SET);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+    }
+
+    /* The sort and node count can be spread across multiple threads for large archives. */
+    indexThreadCount = fs_zip_calculate_index_thread_count(pZip, threadCount);
+
+    fs_zip_sort_index(pZip, indexThreadCount, pAllocationCallbacks);
+
+    /* Testing. */
+    #if 0
+    {
+        size_t i;
+        for (i = 0; i < pZip->fileCount; i += 1) {
+            size_t nameLen;
+            const char* pName = fs_zip_get_file_path_by_record_offset(pZip, pZip->pIndex[i].offsetInBytes, &nameLen);
+
+            printf("File name = %.*s\n", (int)nameLen, pName);
+        }
+    }
+    #endif
+
+    /*
+    We're going to build an accelerated data structure for the central directory. Nothing over
+    the top - just a simple tree based on directory names.
+
+    It's just a graph. Each node in the graph is either a directory or a file. Leaf nodes can
+    possibly be files or an empty directory which means a flag is required to indicate whether
+    or not the node is a directory. Sub-folders and files are just child nodes. Children are
+    sorted by name to allow for fast lookups.
+
+    The items in the central directory has already been sorted thanks to the index that we
+    constructed above. If we just iterate linearly based on that index everything should be
+    sorted naturally.
+
+    The graph is constructed in two passes. The first pass simply counts the number of nodes so
+    we can allocate a single block of memory. The second pass fills the data.
+    */
+
+    /*
+    The first pass is just to count the number of nodes so we can allocate some memory in one
+    chunk. We start the count at one to accommodate for the root node. This pass is not
+    necessarily calculating an exact count, but instead it calculates an upper bound count. The
+    reason for this is how directories are handled. Sometimes they are listed explicitly, but I
+    have seen cases where they're not. If we could guarantee all folders were explicitly listed
+    we would be able to avoid this pass.
+
+    We can take advantage of the fact that the file listing has been sorted. For each entry we
+    just compare the path with the previous one, and for every segment in the new path that's
+    different we increment the counter (it should always be at least one since the file name
+    itself should always be different).
+    */
+    nodeUpperBoundCount = fs_zip_count_nodes_upper_bound(pZip, indexThreadCount, pAllocationCallbacks);
+
+    /*
+    Now that we've got the count we can go ahead and resize our heap allocation. It's important
+    to remember to update our pointers here.
+    */
+    {
+        void* pNewHeap = fs_realloc(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR) + (sizeof(*pZip->pIndex) * pZip->fileCount) + (sizeof(*pZip->pCDRootNode) * nodeUpperBoundCount), pAllocationCallbacks);
+        if (pNewHeap == NULL) {
+            return FS_OUT_OF_MEMORY;
+        }
+
+        pZip->pHeap = pNewHeap;
+        pZip->pCentralDirectory =                  FS_ZIP_OFFSET_PTR(pZip->pHeap, 0);
+        pZip->pIndex            = (fs_zip_index*  )FS_ZIP_OFFSET_PTR(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR));
+        pZip->pCDRootNode       = (fs_zip_cd_node*)FS_ZIP_OFFSET_PTR(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR) + (sizeof(*pZip->pIndex) * pZip->fileCount));
+    }
+
+    /*
+    Memory has been allocated so we can now fill it out. This is slightly tricky because we want
+    to do it in a single pass with a single memory allocation. Each node will hold a pointer to
+    an array which will contain their children. The size of this array is unknown at this point
+    so we need to come up with a system that allows us to fill each node in order.
+
+    Fortunately our file listing is sorted which gives us a good start. We want to fill out
+    higher level nodes first and then move down to leaf nodes. We're going to run through the
+    file listing in sorted order. For the current file path, we need to look at it's directory
+    structure. For each segment of the directory there will be a node. For each of these
+    segments we'll run an inner loop that adds child nodes for each file that shares the same
+    prefix.
+
+    To put simply, for each node, we need to attach all of it's children before the child nodes
+    themselves have been filled with their children. We can do this recursively. The first node
+    we're filling is the root node.
+    */
+    {
+        fs_zip_cd_node* pRunningChildrenPointer = &pZip->pCDRootNode[1];
+
+        /* The root node needs to be set up first. */
+        pZip->pCDRootNode->iFile                = 0;
+        pZip->pCDRootNode->pName                = "";
+        pZip->pCDRootNode->nameLen              = 0;
+        pZip->pCDRootNode->_descendantRangeBeg  = 0;
+        pZip->pCDRootNode->_descendantRangeEnd  = pZip->fileCount;
+        pZip->pCDRootNode->_descendantPrefixLen = 0;
+
+        fs_zip_cd_node_build(pZip, &pRunningChildrenPointer, pZip->pCDRootNode);
+
+        pZip->nodeCount = (size_t)(pRunningChildrenPointer - pZip->pCDRootNode);
+    }
+
+    return FS_SUCCESS;
+}
+
+
+/*
+The index file is a sidecar which stores the sorted index and the node graph so that they don't need
+to be rebuilt every time the archive is opened. Everything is little-endian. The layout is:
+
+    Header (64 bytes)
+        u32 signature ("FSZI")
+        u32 version
+        u64 archive size
+        u64 archive modified time
+        u64 central directory offset
+        u64 central directory size
+        u32 central directory CRC-32
+        u32 reserved
+        u64 file count
+        u64 node count
+    Index (4 bytes per file)
+        u32 record offset, relative to the start of the central directory
+    Nodes (20 bytes per node, with the root node first)
+        u32 file index
+        u32 name offset, relative to the start of the central directory
+        u16 name length
+        u16 reserved
+        u32 child count
+        u32 index of the first child
+
+The nodes store indexes instead of pointers so when the file is loaded the node graph needs to be
+fixed up. This is a single linear pass which is much quicker than the sort and the graph build.
+*/
+#define FS_ZIP_INDEX_FILE_SIGNATURE                         0x495A5346  /* "FSZI" */
+#define FS_ZIP_INDEX_FILE_VERSION                           1
+#define FS_ZIP_INDEX_FILE_HEADER_SIZE                       64
+#define FS_ZIP_INDEX_FILE_INDEX_ITEM_SIZE                   4
+#define FS_ZIP_INDEX_FILE_NODE_SIZE                         20
+
+typedef struct
+{
+    fs_uint64 archiveSize;
+    fs_uint64 archiveModifiedTime;
+    fs_uint64 centralDirectoryOffset;
+    fs_uint64 centralDirectorySize;
+    fs_uint32 centralDirectoryCRC;
+    fs_uint64 fileCount;
+} fs_zip_index_file_key;
+
+/*
+Tables for slice-by-8 CRC-32. The first table is the standard byte-at-a-time table. Each subsequent
+table is the CRC of the previous table shifted by another zero byte, which allows 8 bytes to be
+processed with 8 independent lookups rather than a chain of 8 dependent ones.
+*/
+static const fs_uint32 fs_zip_crc32_table[8][256] =
+{
+    {
+        0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+        0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+        0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+        0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+        0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+        0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+        0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+        0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+        0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+        0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+        0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+        0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+        0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+        0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+        0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+        0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+        0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+        0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+        0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+        0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+        0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+        0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+        0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+        0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+        0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+        0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+        0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+        0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+        0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+        0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+        0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+        0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+    },
+    {
+        0x00000000, 0x191B3141, 0x32366282, 0x2B2D53C3, 0x646CC504, 0x7D77F445, 0x565AA786, 0x4F4196C7,
+        0xC8D98A08, 0xD1C2BB49, 0xFAEFE88A, 0xE3F4D9CB, 0xACB54F0C, 0xB5AE7E4D, 0x9E832D8E, 0x87981CCF,
+        0x4AC21251, 0x53D92310, 0x78F470D3, 0x61EF4192, 0x2EAED755, 0x37B5E614, 0x1C98B5D7, 0x05838496,
+        0x821B9859, 0x9B00A918, 0xB02DFADB, 0xA936CB9A, 0xE6775D5D, 0xFF6C6C1C, 0xD4413FDF, 0xCD5A0E9E,
+        0x958424A2, 0x8C9F15E3, 0xA7B24620, 0xBEA97761, 0xF1E8E1A6, 0xE8F3D0E7, 0xC3DE8324, 0xDAC5B265,
+        0x5D5DAEAA, 0x44469FEB, 0x6F6BCC28, 0x7670FD69, 0x39316BAE, 0x202A5AEF, 0x0B07092C, 0x121C386D,
+        0xDF4636F3, 0xC65D07B2, 0xED705471, 0xF46B6530, 0xBB2AF3F7, 0xA231C2B6, 0x891C9175, 0x9007A034,
+        0x179FBCFB, 0x0E848DBA, 0x25A9DE79, 0x3CB2EF38, 0x73F379FF, 0x6AE848BE, 0x41C51B7D, 0x58DE2A3C,
+        0xF0794F05, 0xE9627E44, 0xC24F2D87, 0xDB541CC6, 0x94158A01, 0x8D0EBB40, 0xA623E883, 0xBF38D9C2,
+        0x38A0C50D, 0x21BBF44C, 0x0A96A78F, 0x138D96CE, 0x5CCC0009, 0x45D73148, 0x6EFA628B, 0x77E153CA,
+        0xBABB5D54, 0xA3A06C15, 0x888D3FD6, 0x91960E97, 0xDED79850, 0xC7CCA911, 0xECE1FAD2, 0xF5FACB93,
+        0x7262D75C, 0x6B79E61D, 0x4054B5DE, 0x594F849F, 0x160E1258, 0x0F152319, 0x243870DA, 0x3D23419B,
+        0x65FD6BA7, 0x7CE65AE6, 0x57CB0925, 0x4ED03864, 0x0191AEA3, 0x188A9FE2, 0x33A7CC21, 0x2ABCFD60,
+        0xAD24E1AF, 0xB43FD0EE, 0x9F12832D, 0x8609B26C, 0xC94824AB, 0xD05315EA, 0xFB7E4629, 0xE2657768,
+        0x2F3F79F6, 0x362448B7, 0x1D091B74, 0x04122A35, 0x4B53BCF2, 0x52488DB3, 0x7965DE70, 0x607EEF31,
+        0xE7E6F3FE, 0xFEFDC2BF, 0xD5D0917C, 0xCCCBA03D, 0x838A36FA, 0x9A9107BB, 0xB1BC5478, 0xA8A76539,
+        0x3B83984B, 0x2298A90A, 0x09B5FAC9, 0x10AECB88, 0x5FEF5D4F, 0x46F46C0E, 0x6DD93FCD, 0x74C20E8C,
+        0xF35A1243, 0xEA412302, 0xC16C70C1, 0xD8774180, 0x9736D747, 0x8E2DE606, 0xA500B5C5, 0xBC1B8484,
+        0x71418A1A, 0x685ABB5B, 0x4377E898, 0x5A6CD9D9, 0x152D4F1E, 0x0C367E5F, 0x271B2D9C, 0x3E001CDD,
+        0xB9980012, 0xA0833153, 0x8BAE6290, 0x92B553D1, 0xDDF4C516, 0xC4EFF457, 0xEFC2A794, 0xF6D996D5,
+        0xAE07BCE9, 0xB71C8DA8, 0x9C31DE6B, 0x852AEF2A, 0xCA6B79ED, 0xD37048AC, 0xF85D1B6F, 0xE1462A2E,
+        0x66DE36E1, 0x7FC507A0, 0x54E85463, 0x4DF36522, 0x02B2F3E5, 0x1BA9C2A4, 0x30849167, 0x299FA026,
+        0xE4C5AEB8, 0xFDDE9FF9, 0xD6F3CC3A, 0xCFE8FD7B, 0x80A96BBC, 0x99B25AFD, 0xB29F093E, 0xAB84387F,
+        0x2C1C24B0, 0x350715F1, 0x1E2A4632, 0x07317773, 0x4870E1B4, 0x516BD0F5, 0x7A468336, 0x635DB277,
+        0xCBFAD74E, 0xD2E1E60F, 0xF9CCB5CC, 0xE0D7848D, 0xAF96124A, 0xB68D230B, 0x9DA070C8, 0x84BB4189,
+        0x03235D46, 0x1A386C07, 0x31153FC4, 0x280E0E85, 0x674F9842, 0x7E54A903, 0x5579FAC0, 0x4C62CB81,
+        0x8138C51F, 0x9823F45E, 0xB30EA79D, 0xAA1596DC, 0xE554001B, 0xFC4F315A, 0xD7626299, 0xCE7953D8,
+        0x49E14F17, 0x50FA7E56, 0x7BD72D95, 0x62CC1CD4, 0x2D8D8A13, 0x3496BB52, 0x1FBBE891, 0x06A0D9D0,
+        0x5E7EF3EC, 0x4765C2AD, 0x6C48916E, 0x7553A02F, 0x3A1236E8, 0x230907A9, 0x0824546A, 0x113F652B,
+        0x96A779E4, 0x8FBC48A5, 0xA4911B66, 0xBD8A2A27, 0xF2CBBCE0, 0xEBD08DA1, 0xC0FDDE62, 0xD9E6EF23,
+        0x14BCE1BD, 0x0DA7D0FC, 0x268A833F, 0x3F91B27E, 0x70D024B9, 0x69CB15F8, 0x42E6463B, 0x5BFD777A,
+        0xDC656BB5, 0xC57E5AF4, 0xEE530937, 0xF7483876, 0xB809AEB1, 0xA1129FF0, 0x8A3FCC33, 0x9324FD72
+    },
+    {
+        0x00000000, 0x01C26A37, 0x0384D46E, 0x0246BE59, 0x0709A8DC, 0x06CBC2EB, 0x048D7CB2, 0x054F1685,
+        0x0E1351B8, 0x0FD13B8F, 0x0D9785D6, 0x0C55EFE1, 0x091AF964, 0x08D89353, 0x0A9E2D0A, 0x0B5C473D,
+        0x1C26A370, 0x1DE4C947, 0x1FA2771E, 0x1E601D29, 0x1B2F0BAC, 0x1AED619B, 0x18ABDFC2, 0x1969B5F5,
+        0x1235F2C8, 0x13F798FF, 0x11B126A6, 0x10734C91, 0x153C5A14, 0x14FE3023, 0x16B88E7A, 0x177AE44D,
+        0x384D46E0, 0x398F2CD7, 0x3BC9928E, 0x3A0BF8B9, 0x3F44EE3C, 0x3E86840B, 0x3CC03A52, 0x3D025065,
+        0x365E1758, 0x379C7D6F, 0x35DAC336, 0x3418A901, 0x3157BF84, 0x3095D5B3, 0x32D36BEA, 0x331101DD,
+        0x246BE590, 0x25A98FA7, 0x27EF31FE, 0x262D5BC9, 0x23624D4C, 0x22A0277B, 0x20E69922, 0x2124F315,
+        0x2A78B428, 0x2BBADE1F, 0x29FC6046, 0x283E0A71, 0x2D711CF4, 0x2CB376C3, 0x2EF5C89A, 0x2F37A2AD,
+        0x709A8DC0, 0x7158E7F7, 0x731E59AE, 0x72DC3399, 0x7793251C, 0x76514F2B, 0x7417F172, 0x75D59B45,
+        0x7E89DC78, 0x7F4BB64F, 0x7D0D0816, 0x7CCF6221, 0x798074A4, 0x78421E93, 0x7A04A0CA, 0x7BC6CAFD,
+        0x6CBC2EB0, 0x6D7E4487, 0x6F38FADE, 0x6EFA90E9, 0x6BB5866C, 0x6A77EC5B, 0x68315202, 0x69F33835,
+        0x62AF7F08, 0x636D153F, 0x612BAB66, 0x60E9C151, 0x65A6D7D4, 0x6464BDE3, 0x662203BA, 0x67E0698D,
+        0x48D7CB20, 0x4915A117, 0x4B531F4E, 0x4A917579, 0x4FDE63FC, 0x4E1C09CB, 0x4C5AB792, 0x4D98DDA5,
+        0x46C49A98, 0x4706F0AF, 0x45404EF6, 0x448224C1, 0x41CD3244, 0x400F5873, 0x4249E62A, 0x438B8C1D,
+        0x54F16850, 0x55330267, 0x5775BC3E, 0x56B7D609, 0x53F8C08C, 0x523AAABB, 0x507C14E2, 0x51BE7ED5,
+        0x5AE239E8, 0x5B2053DF, 0x5966ED86, 0x58A487B1, 0x5DEB9134, 0x5C29FB03, 0x5E6F455A, 0x5FAD2F6D,
+        0xE1351B80, 0xE0F771B7, 0xE2B1CFEE, 0xE373A5D9, 0xE63CB35C, 0xE7FED96B, 0xE5B86732, 0xE47A0D05,
+        0xEF264A38, 0xEEE4200F, 0xECA29E56, 0xED60F461, 0xE82FE2E4, 0xE9ED88D3, 0xEBAB368A, 0xEA695CBD,
+        0xFD13B8F0, 0xFCD1D2C7, 0xFE976C9E, 0xFF5506A9, 0xFA1A102C, 0xFBD87A1B, 0xF99EC442, 0xF85CAE75,
+        0xF300E948, 0xF2C2837F, 0xF0843D26, 0xF1465711, 0xF4094194, 0xF5CB2BA3, 0xF78D95FA, 0xF64FFFCD,
+        0xD9785D60, 0xD8BA3757, 0xDAFC890E, 0xDB3EE339, 0xDE71F5BC, 0xDFB39F8B, 0xDDF521D2, 0xDC374BE5,
+        0xD76B0CD8, 0xD6A966EF, 0xD4EFD8B6, 0xD52DB281, 0xD062A404, 0xD1A0CE33, 0xD3E6706A, 0xD2241A5D,
+        0xC55EFE10, 0xC49C9427, 0xC6DA2A7E, 0xC7184049, 0xC25756CC, 0xC3953CFB, 0xC1D382A2, 0xC011E895,
+        0xCB4DAFA8, 0xCA8FC59F, 0xC8C97BC6, 0xC90B11F1, 0xCC440774, 0xCD866D43, 0xCFC0D31A, 0xCE02B92D,
+        0x91AF9640, 0x906DFC77, 0x922B422E, 0x93E92819, 0x96A63E9C, 0x976454AB, 0x9522EAF2, 0x94E080C5,
+        0x9FBCC7F8, 0x9E7EADCF, 0x9C381396, 0x9DFA79A1, 0x98B56F24, 0x99770513, 0x9B31BB4A, 0x9AF3D17D,
+        0x8D893530, 0x8C4B5F07, 0x8E0DE15E, 0x8FCF8B69, 0x8A809DEC, 0x8B42F7DB, 0x89044982, 0x88C623B5,
+        0x839A6488, 0x82580EBF, 0x801EB0E6, 0x81DCDAD1, 0x8493CC54, 0x8551A663, 0x8717183A, 0x86D5720D,
+        0xA9E2D0A0, 0xA820BA97, 0xAA6604CE, 0xABA46EF9, 0xAEEB787C, 0xAF29124B, 0xAD6FAC12, 0xACADC625,
+        0xA7F18118, 0xA633EB2F, 0xA4755576, 0xA5B73F41, 0xA0F829C4, 0xA13A43F3, 0xA37CFDAA, 0xA2BE979D,
+        0xB5C473D0, 0xB40619E7, 0xB640A7BE, 0xB782CD89, 0xB2CDDB0C, 0xB30FB13B, 0xB1490F62, 0xB08B6555,
+        0xBBD72268, 0xBA15485F, 0xB853F606, 0xB9919C31, 0xBCDE8AB4, 0xBD1CE083, 0xBF5A5EDA, 0xBE9834ED
+    },
+    {
+        0x00000000, 0xB8BC6765, 0xAA09C88B, 0x12B5AFEE, 0x8F629757, 0x37DEF032, 0x256B5FDC, 0x9DD738B9,
+        0xC5B428EF, 0x7D084F8A, 0x6FBDE064, 0xD7018701, 0x4AD6BFB8, 0xF26AD8DD, 0xE0DF7733, 0x58631056,
+        0x5019579F, 0xE8A530FA, 0xFA109F14, 0x42ACF871, 0xDF7BC0C8, 0x67C7A7AD, 0x75720843, 0xCDCE6F26,
+        0x95AD7F70, 0x2D111815, 0x3FA4B7FB, 0x8718D09E, 0x1ACFE827, 0xA2738F42, 0xB0C620AC, 0x087A47C9,
+        0xA032AF3E, 0x188EC85B, 0x0A3B67B5, 0xB28700D0, 0x2F503869, 0x97EC5F0C, 0x8559F0E2, 0x3DE59787,
+        0x658687D1, 0xDD3AE0B4, 0xCF8F4F5A, 0x7733283F, 0xEAE41086, 0x525877E3, 0x40EDD80D, 0xF851BF68,
+        0xF02BF8A1, 0x48979FC4, 0x5A22302A, 0xE29E574F, 0x7F496FF6, 0xC7F50893, 0xD540A77D, 0x6DFCC018,
+        0x359FD04E, 0x8D23B72B, 0x9F9618C5, 0x272A7FA0, 0xBAFD4719, 0x0241207C, 0x10F48F92, 0xA848E8F7,
+        0x9B14583D, 0x23A83F58, 0x311D90B6, 0x89A1F7D3, 0x1476CF6A, 0xACCAA80F, 0xBE7F07E1, 0x06C36084,
+        0x5EA070D2, 0xE61C17B7, 0xF4A9B859, 0x4C15DF3C, 0xD1C2E785, 0x697E80E0, 0x7BCB2F0E, 0xC377486B,
+        0xCB0D0FA2, 0x73B168C7, 0x6104C729, 0xD9B8A04C, 0x446F98F5, 0xFCD3FF90, 0xEE66507E, 0x56DA371B,
+        0x0EB9274D, 0xB6054028, 0xA4B0EFC6, 0x1C0C88A3, 0x81DBB01A, 0x3967D77F, 0x2BD27891, 0x936E1FF4,
+        0x3B26F703, 0x839A9066, 0x912F3F88, 0x299358ED, 0xB4446054, 0x0CF80731, 0x1E4DA8DF, 0xA6F1CFBA,
+        0xFE92DFEC, 0x462EB889, 0x549B1767, 0xEC277002, 0x71F048BB, 0xC94C2FDE, 0xDBF98030, 0x6345E755,
+        0x6B3FA09C, 0xD383C7F9, 0xC1366817, 0x798A0F72, 0xE45D37CB, 0x5CE150AE, 0x4E54FF40, 0xF6E89825,
+        0xAE8B8873, 0x1637EF16, 0x048240F8, 0xBC3E279D, 0x21E91F24, 0x99557841, 0x8BE0D7AF, 0x335CB0CA,
+        0xED59B63B, 0x55E5D15E, 0x47507EB0, 0xFFEC19D5, 0x623B216C, 0xDA874609, 0xC832E9E7, 0x708E8E82,
+        0x28ED9ED4, 0x9051F9B1, 0x82E4565F, 0x3A58313A, 0xA78F0983, 0x1F336EE6, 0x0D86C108, 0xB53AA66D,
+        0xBD40E1A4, 0x05FC86C1, 0x1749292F, 0xAFF54E4A, 0x322276F3, 0x8A9E1196, 0x982BBE78, 0x2097D91D,
+        0x78F4C94B, 0xC048AE2E, 0xD2FD01C0, 0x6A4166A5, 0xF7965E1C, 0x4F2A3979, 0x5D9F9697, 0xE523F1F2,
+        0x4D6B1905, 0xF5D77E60, 0xE762D18E, 0x5FDEB6EB, 0xC2098E52, 0x7AB5E937, 0x680046D9, 0xD0BC21BC,
+        0x88DF31EA, 0x3063568F, 0x22D6F961, 0x9A6A9E04, 0x07BDA6BD, 0xBF01C1D8, 0xADB46E36, 0x15080953,
+        0x1D724E9A, 0xA5CE29FF, 0xB77B8611, 0x0FC7E174, 0x9210D9CD, 0x2AACBEA8, 0x38191146, 0x80A57623,
+        0xD8C66675, 0x607A0110, 0x72CFAEFE, 0xCA73C99B, 0x57A4F122, 0xEF189647, 0xFDAD39A9, 0x45115ECC,
+        0x764DEE06, 0xCEF18963, 0xDC44268D, 0x64F841E8, 0xF92F7951, 0x41931E34, 0x5326B1DA, 0xEB9AD6BF,
+        0xB3F9C6E9, 0x0B45A18C, 0x19F00E62, 0xA14C6907, 0x3C9B51BE, 0x842736DB, 0x96929935, 0x2E2EFE50,
+        0x2654B999, 0x9EE8DEFC, 0x8C5D7112, 0x34E11677, 0xA9362ECE, 0x118A49AB, 0x033FE645, 0xBB838120,
+        0xE3E09176, 0x5B5CF613, 0x49E959FD, 0xF1553E98, 0x6C820621, 0xD43E6144, 0xC68BCEAA, 0x7E37A9CF,
+        0xD67F4138, 0x6EC3265D, 0x7C7689B3, 0xC4CAEED6, 0x591DD66F, 0xE1A1B10A, 0xF3141EE4, 0x4BA87981,
+        0x13CB69D7, 0xAB770EB2, 0xB9C2A15C, 0x017EC639, 0x9CA9FE80, 0x241599E5, 0x36A0360B, 0x8E1C516E,
+        0x866616A7, 0x3EDA71C2, 0x2C6FDE2C, 0x94D3B949, 0x090481F0, 0xB1B8E695, 0xA30D497B, 0x1BB12E1E,
+        0x43D23E48, 0xFB6E592D, 0xE9DBF6C3, 0x516791A6, 0xCCB0A91F, 0x740CCE7A, 0x66B96194, 0xDE0506F1
+    },
+    {
+        0x00000000, 0x3D6029B0, 0x7AC05360, 0x47A07AD0, 0xF580A6C0, 0xC8E08F70, 0x8F40F5A0, 0xB220DC10,
+        0x30704BC1, 0x0D106271, 0x4AB018A1, 0x77D03111, 0xC5F0ED01, 0xF890C4B1, 0xBF30BE61, 0x825097D1,
+        0x60E09782, 0x5D80BE32, 0x1A20C4E2, 0x2740ED52, 0x95603142, 0xA80018F2, 0xEFA06222, 0xD2C04B92,
+        0x5090DC43, 0x6DF0F5F3, 0x2A508F23, 0x1730A693, 0xA5107A83, 0x98705333, 0xDFD029E3, 0xE2B00053,
+        0xC1C12F04, 0xFCA106B4, 0xBB017C64, 0x866155D4, 0x344189C4, 0x0921A074, 0x4E81DAA4, 0x73E1F314,
+        0xF1B164C5, 0xCCD14D75, 0x8B7137A5, 0xB6111E15, 0x0431C205, 0x3951EBB5, 0x7EF19165, 0x4391B8D5,
+        0xA121B886, 0x9C419136, 0xDBE1EBE6, 0xE681C256, 0x54A11E46, 0x69C137F6, 0x2E614D26, 0x13016496,
+        0x9151F347, 0xAC31DAF7, 0xEB91A027, 0xD6F18997, 0x64D15587, 0x59B17C37, 0x1E1106E7, 0x23712F57,
+        0x58F35849, 0x659371F9, 0x22330B29, 0x1F532299, 0xAD73FE89, 0x9013D739, 0xD7B3ADE9, 0xEAD38459,
+        0x68831388, 0x55E33A38, 0x124340E8, 0x2F236958, 0x9D03B548, 0xA0639CF8, 0xE7C3E628, 0xDAA3CF98,
+        0x3813CFCB, 0x0573E67B, 0x42D39CAB, 0x7FB3B51B, 0xCD93690B, 0xF0F340BB, 0xB7533A6B, 0x8A3313DB,
+        0x0863840A, 0x3503ADBA, 0x72A3D76A, 0x4FC3FEDA, 0xFDE322CA, 0xC0830B7A, 0x872371AA, 0xBA43581A,
+        0x9932774D, 0xA4525EFD, 0xE3F2242D, 0xDE920D9D, 0x6CB2D18D, 0x51D2F83D, 0x167282ED, 0x2B12AB5D,
+        0xA9423C8C, 0x9422153C, 0xD3826FEC, 0xEEE2465C, 0x5CC29A4C, 0x61A2B3FC, 0x2602C92C, 0x1B62E09C,
+        0xF9D2E0CF, 0xC4B2C97F, 0x8312B3AF, 0xBE729A1F, 0x0C52460F, 0x31326FBF, 0x7692156F, 0x4BF23CDF,
+        0xC9A2AB0E, 0xF4C282BE, 0xB362F86E, 0x8E02D1DE, 0x3C220DCE, 0x0142247E, 0x46E25EAE, 0x7B82771E,
+        0xB1E6B092, 0x8C869922, 0xCB26E3F2, 0xF646CA42, 0x44661652, 0x79063FE2, 0x3EA64532, 0x03C66C82,
+        0x8196FB53, 0xBCF6D2E3, 0xFB56A833, 0xC6368183, 0x74165D93, 0x49767423, 0x0ED60EF3, 0x33B62743,
+        0xD1062710, 0xEC660EA0, 0xABC67470, 0x96A65DC0, 0x248681D0, 0x19E6A860, 0x5E46D2B0, 0x6326FB00,
+        0xE1766CD1, 0xDC164561, 0x9BB63FB1, 0xA6D61601, 0x14F6CA11, 0x2996E3A1, 0x6E369971, 0x5356B0C1,
+        0x70279F96, 0x4D47B626, 0x0AE7CCF6, 0x3787E546, 0x85A73956, 0xB8C710E6, 0xFF676A36, 0xC2074386,
+        0x4057D457, 0x7D37FDE7, 0x3A978737, 0x07F7AE87, 0xB5D77297, 0x88B75B27, 0xCF1721F7, 0xF2770847,
+        0x10C70814, 0x2DA721A4, 0x6A075B74, 0x576772C4, 0xE547AED4, 0xD8278764, 0x9F87FDB4, 0xA2E7D404,
+        0x20B743D5, 0x1DD76A65, 0x5A7710B5, 0x67173905, 0xD537E515, 0xE857CCA5, 0xAFF7B675, 0x92979FC5,
+        0xE915E8DB, 0xD475C16B, 0x93D5BBBB, 0xAEB5920B, 0x1C954E1B, 0x21F567AB, 0x66551D7B, 0x5B3534CB,
+        0xD965A31A, 0xE4058AAA, 0xA3A5F07A, 0x9EC5D9CA, 0x2CE505DA, 0x11852C6A, 0x562556BA, 0x6B457F0A,
+        0x89F57F59, 0xB49556E9, 0xF3352C39, 0xCE550589, 0x7C75D999, 0x4115F029, 0x06B58AF9, 0x3BD5A349,
+        0xB9853498, 0x84E51D28, 0xC34567F8, 0xFE254E48, 0x4C059258, 0x7165BBE8, 0x36C5C138, 0x0BA5E888,
+        0x28D4C7DF, 0x15B4EE6F, 0x521494BF, 0x6F74BD0F, 0xDD54611F, 0xE03448AF, 0xA794327F, 0x9AF41BCF,
+        0x18A48C1E, 0x25C4A5AE, 0x6264DF7E, 0x5F04F6CE, 0xED242ADE, 0xD044036E, 0x97E479BE, 0xAA84500E,
+        0x4834505D, 0x755479ED, 0x32F4033D, 0x0F942A8D, 0xBDB4F69D, 0x80D4DF2D, 0xC774A5FD, 0xFA148C4D,
+        0x78441B9C, 0x4524322C, 0x028448FC, 0x3FE4614C, 0x8DC4BD5C, 0xB0A494EC, 0xF704EE3C, 0xCA64C78C
+    },
+    {
+        0x00000000, 0xCB5CD3A5, 0x4DC8A10B, 0x869472AE, 0x9B914216, 0x50CD91B3, 0xD659E31D, 0x1D0530B8,
+        0xEC53826D, 0x270F51C8, 0xA19B2366, 0x6AC7F0C3, 0x77C2C07B, 0xBC9E13DE, 0x3A0A6170, 0xF156B2D5,
+        0x03D6029B, 0xC88AD13E, 0x4E1EA390, 0x85427035, 0x9847408D, 0x531B9328, 0xD58FE186, 0x1ED33223,
+        0xEF8580F6, 0x24D95353, 0xA24D21FD, 0x6911F258, 0x7414C2E0, 0xBF481145, 0x39DC63EB, 0xF280B04E,
+        0x07AC0536, 0xCCF0D693, 0x4A64A43D, 0x81387798, 0x9C3D4720, 0x57619485, 0xD1F5E62B, 0x1AA9358E,
+        0xEBFF875B, 0x20A354FE, 0xA6372650, 0x6D6BF5F5, 0x706EC54D, 0xBB3216E8, 0x3DA66446, 0xF6FAB7E3,
+        0x047A07AD, 0xCF26D408, 0x49B2A6A6, 0x82EE7503, 0x9FEB45BB, 0x54B7961E, 0xD223E4B0, 0x197F3715,
+        0xE82985C0, 0x23755665, 0xA5E124CB, 0x6EBDF76E, 0x73B8C7D6, 0xB8E41473, 0x3E7066DD, 0xF52CB578,
+        0x0F580A6C, 0xC404D9C9, 0x4290AB67, 0x89CC78C2, 0x94C9487A, 0x5F959BDF, 0xD901E971, 0x125D3AD4,
+        0xE30B8801, 0x28575BA4, 0xAEC3290A, 0x659FFAAF, 0x789ACA17, 0xB3C619B2, 0x35526B1C, 0xFE0EB8B9,
+        0x0C8E08F7, 0xC7D2DB52, 0x4146A9FC, 0x8A1A7A59, 0x971F4AE1, 0x5C439944, 0xDAD7EBEA, 0x118B384F,
+        0xE0DD8A9A, 0x2B81593F, 0xAD152B91, 0x6649F834, 0x7B4CC88C, 0xB0101B29, 0x36846987, 0xFDD8BA22,
+        0x08F40F5A, 0xC3A8DCFF, 0x453CAE51, 0x8E607DF4, 0x93654D4C, 0x58399EE9, 0xDEADEC47, 0x15F13FE2,
+        0xE4A78D37, 0x2FFB5E92, 0xA96F2C3C, 0x6233FF99, 0x7F36CF21, 0xB46A1C84, 0x32FE6E2A, 0xF9A2BD8F,
+        0x0B220DC1, 0xC07EDE64, 0x46EAACCA, 0x8DB67F6F, 0x90B34FD7, 0x5BEF9C72, 0xDD7BEEDC, 0x16273D79,
+        0xE7718FAC, 0x2C2D5C09, 0xAAB92EA7, 0x61E5FD02, 0x7CE0CDBA, 0xB7BC1E1F, 0x31286CB1, 0xFA74BF14,
+        0x1EB014D8, 0xD5ECC77D, 0x5378B5D3, 0x98246676, 0x852156CE, 0x4E7D856B, 0xC8E9F7C5, 0x03B52460,
+        0xF2E396B5, 0x39BF4510, 0xBF2B37BE, 0x7477E41B, 0x6972D4A3, 0xA22E0706, 0x24BA75A8, 0xEFE6A60D,
+        0x1D661643, 0xD63AC5E6, 0x50AEB748, 0x9BF264ED, 0x86F75455, 0x4DAB87F0, 0xCB3FF55E, 0x006326FB,
+        0xF135942E, 0x3A69478B, 0xBCFD3525, 0x77A1E680, 0x6AA4D638, 0xA1F8059D, 0x276C7733, 0xEC30A496,
+        0x191C11EE, 0xD240C24B, 0x54D4B0E5, 0x9F886340, 0x828D53F8, 0x49D1805D, 0xCF45F2F3, 0x04192156,
+        0xF54F9383, 0x3E134026, 0xB8873288, 0x73DBE12D, 0x6EDED195, 0xA5820230, 0x2316709E, 0xE84AA33B,
+        0x1ACA1375, 0xD196C0D0, 0x5702B27E, 0x9C5E61DB, 0x815B5163, 0x4A0782C6, 0xCC93F068, 0x07CF23CD,
+        0xF6999118, 0x3DC542BD, 0xBB513013, 0x700DE3B6, 0x6D08D30E, 0xA65400AB, 0x20C07205, 0xEB9CA1A0,
+        0x11E81EB4, 0xDAB4CD11, 0x5C20BFBF, 0x977C6C1A, 0x8A795CA2, 0x41258F07, 0xC7B1FDA9, 0x0CED2E0C,
+        0xFDBB9CD9, 0x36E74F7C, 0xB0733DD2, 0x7B2FEE77, 0x662ADECF, 0xAD760D6A, 0x2BE27FC4, 0xE0BEAC61,
+        0x123E1C2F, 0xD962CF8A, 0x5FF6BD24, 0x94AA6E81, 0x89AF5E39, 0x42F38D9C, 0xC467FF32, 0x0F3B2C97,
+        0xFE6D9E42, 0x35314DE7, 0xB3A53F49, 0x78F9ECEC, 0x65FCDC54, 0xAEA00FF1, 0x28347D5F, 0xE368AEFA,
+        0x16441B82, 0xDD18C827, 0x5B8CBA89, 0x90D0692C, 0x8DD55994, 0x46898A31, 0xC01DF89F, 0x0B412B3A,
+        0xFA1799EF, 0x314B4A4A, 0xB7DF38E4, 0x7C83EB41, 0x6186DBF9, 0xAADA085C, 0x2C4E7AF2, 0xE712A957,
+        0x15921919, 0xDECECABC, 0x585AB812, 0x93066BB7, 0x8E035B0F, 0x455F88AA, 0xC3CBFA04, 0x089729A1,
+        0xF9C19B74, 0x329D48D1, 0xB4093A7F, 0x7F55E9DA, 0x6250D962, 0xA90C0AC7, 0x2F987869, 0xE4C4ABCC
+    },
+    {
+        0x00000000, 0xA6770BB4, 0x979F1129, 0x31E81A9D, 0xF44F2413, 0x52382FA7, 0x63D0353A, 0xC5A73E8E,
+        0x33EF4E67, 0x959845D3, 0xA4705F4E, 0x020754FA, 0xC7A06A74, 0x61D761C0, 0x503F7B5D, 0xF64870E9,
+        0x67DE9CCE, 0xC1A9977A, 0xF0418DE7, 0x56368653, 0x9391B8DD, 0x35E6B369, 0x040EA9F4, 0xA279A240,
+        0x5431D2A9, 0xF246D91D, 0xC3AEC380, 0x65D9C834, 0xA07EF6BA, 0x0609FD0E, 0x37E1E793, 0x9196EC27,
+        0xCFBD399C, 0x69CA3228, 0x582228B5, 0xFE552301, 0x3BF21D8F, 0x9D85163B, 0xAC6D0CA6, 0x0A1A0712,
+        0xFC5277FB, 0x5A257C4F, 0x6BCD66D2, 0xCDBA6D66, 0x081D53E8, 0xAE6A585C, 0x9F8242C1, 0x39F54975,
+        0xA863A552, 0x0E14AEE6, 0x3FFCB47B, 0x998BBFCF, 0x5C2C8141, 0xFA5B8AF5, 0xCBB39068, 0x6DC49BDC,
+        0x9B8CEB35, 0x3DFBE081, 0x0C13FA1C, 0xAA64F1A8, 0x6FC3CF26, 0xC9B4C492, 0xF85CDE0F, 0x5E2BD5BB,
+        0x440B7579, 0xE27C7ECD, 0xD3946450, 0x75E36FE4, 0xB044516A, 0x16335ADE, 0x27DB4043, 0x81AC4BF7,
+        0x77E43B1E, 0xD19330AA, 0xE07B2A37, 0x460C2183, 0x83AB1F0D, 0x25DC14B9, 0x14340E24, 0xB2430590,
+        0x23D5E9B7, 0x85A2E203, 0xB44AF89E, 0x123DF32A, 0xD79ACDA4, 0x71EDC610, 0x4005DC8D, 0xE672D739,
+        0x103AA7D0, 0xB64DAC64, 0x87A5B6F9, 0x21D2BD4D, 0xE47583C3, 0x42028877, 0x73EA92EA, 0xD59D995E,
+        0x8BB64CE5, 0x2DC14751, 0x1C295DCC, 0xBA5E5678, 0x7FF968F6, 0xD98E6342, 0xE86679DF, 0x4E11726B,
+        0xB8590282, 0x1E2E0936, 0x2FC613AB, 0x89B1181F, 0x4C162691, 0xEA612D25, 0xDB8937B8, 0x7DFE3C0C,
+        0xEC68D02B, 0x4A1FDB9F, 0x7BF7C102, 0xDD80CAB6, 0x1827F438, 0xBE50FF8C, 0x8FB8E511, 0x29CFEEA5,
+        0xDF879E4C, 0x79F095F8, 0x48188F65, 0xEE6F84D1, 0x2BC8BA5F, 0x8DBFB1EB, 0xBC57AB76, 0x1A20A0C2,
+        0x8816EAF2, 0x2E61E146, 0x1F89FBDB, 0xB9FEF06F, 0x7C59CEE1, 0xDA2EC555, 0xEBC6DFC8, 0x4DB1D47C,
+        0xBBF9A495, 0x1D8EAF21, 0x2C66B5BC, 0x8A11BE08, 0x4FB68086, 0xE9C18B32, 0xD82991AF, 0x7E5E9A1B,
+        0xEFC8763C, 0x49BF7D88, 0x78576715, 0xDE206CA1, 0x1B87522F, 0xBDF0599B, 0x8C184306, 0x2A6F48B2,
+        0xDC27385B, 0x7A5033EF, 0x4BB82972, 0xEDCF22C6, 0x28681C48, 0x8E1F17FC, 0xBFF70D61, 0x198006D5,
+        0x47ABD36E, 0xE1DCD8DA, 0xD034C247, 0x7643C9F3, 0xB3E4F77D, 0x1593FCC9, 0x247BE654, 0x820CEDE0,
+        0x74449D09, 0xD23396BD, 0xE3DB8C20, 0x45AC8794, 0x800BB91A, 0x267CB2AE, 0x1794A833, 0xB1E3A387,
+        0x20754FA0, 0x86024414, 0xB7EA5E89, 0x119D553D, 0xD43A6BB3, 0x724D6007, 0x43A57A9A, 0xE5D2712E,
+        0x139A01C7, 0xB5ED0A73, 0x840510EE, 0x22721B5A, 0xE7D525D4, 0x41A22E60, 0x704A34FD, 0xD63D3F49,
+        0xCC1D9F8B, 0x6A6A943F, 0x5B828EA2, 0xFDF58516, 0x3852BB98, 0x9E25B02C, 0xAFCDAAB1, 0x09BAA105,
+        0xFFF2D1EC, 0x5985DA58, 0x686DC0C5, 0xCE1ACB71, 0x0BBDF5FF, 0xADCAFE4B, 0x9C22E4D6, 0x3A55EF62,
+        0xABC30345, 0x0DB408F1, 0x3C5C126C, 0x9A2B19D8, 0x5F8C2756, 0xF9FB2CE2, 0xC813367F, 0x6E643DCB,
+        0x982C4D22, 0x3E5B4696, 0x0FB35C0B, 0xA9C457BF, 0x6C636931, 0xCA146285, 0xFBFC7818, 0x5D8B73AC,
+        0x03A0A617, 0xA5D7ADA3, 0x943FB73E, 0x3248BC8A, 0xF7EF8204, 0x519889B0, 0x6070932D, 0xC6079899,
+        0x304FE870, 0x9638E3C4, 0xA7D0F959, 0x01A7F2ED, 0xC400CC63, 0x6277C7D7, 0x539FDD4A, 0xF5E8D6FE,
+        0x647E3AD9, 0xC209316D, 0xF3E12BF0, 0x55962044, 0x90311ECA, 0x3646157E, 0x07AE0FE3, 0xA1D90457,
+        0x579174BE, 0xF1E67F0A, 0xC00E6597, 0x66796E23, 0xA3DE50AD, 0x05A95B19, 0x34414184, 0x92364A30
+    },
+    {
+        0x00000000, 0xCCAA009E, 0x4225077D, 0x8E8F07E3, 0x844A0EFA, 0x48E00E64, 0xC66F0987, 0x0AC50919,
+        0xD3E51BB5, 0x1F4F1B2B, 0x91C01CC8, 0x5D6A1C56, 0x57AF154F, 0x9B0515D1, 0x158A1232, 0xD92012AC,
+        0x7CBB312B, 0xB01131B5, 0x3E9E3656, 0xF23436C8, 0xF8F13FD1, 0x345B3F4F, 0xBAD438AC, 0x767E3832,
+        0xAF5E2A9E, 0x63F42A00, 0xED7B2DE3, 0x21D12D7D, 0x2B142464, 0xE7BE24FA, 0x69312319, 0xA59B2387,
+        0xF9766256, 0x35DC62C8, 0xBB53652B, 0x77F965B5, 0x7D3C6CAC, 0xB1966C32, 0x3F196BD1, 0xF3B36B4F,
+        0x2A9379E3, 0xE639797D, 0x68B67E9E, 0xA41C7E00, 0xAED97719, 0x62737787, 0xECFC7064, 0x205670FA,
+        0x85CD537D, 0x496753E3, 0xC7E85400, 0x0B42549E, 0x01875D87, 0xCD2D5D19, 0x43A25AFA, 0x8F085A64,
+        0x562848C8, 0x9A824856, 0x140D4FB5, 0xD8A74F2B, 0xD2624632, 0x1EC846AC, 0x9047414F, 0x5CED41D1,
+        0x299DC2ED, 0xE537C273, 0x6BB8C590, 0xA712C50E, 0xADD7CC17, 0x617DCC89, 0xEFF2CB6A, 0x2358CBF4,
+        0xFA78D958, 0x36D2D9C6, 0xB85DDE25, 0x74F7DEBB, 0x7E32D7A2, 0xB298D73C, 0x3C17D0DF, 0xF0BDD041,
+        0x5526F3C6, 0x998CF358, 0x1703F4BB, 0xDBA9F425, 0xD16CFD3C, 0x1DC6FDA2, 0x9349FA41, 0x5FE3FADF,
+        0x86C3E873, 0x4A69E8ED, 0xC4E6EF0E, 0x084CEF90, 0x0289E689, 0xCE23E617, 0x40ACE1F4, 0x8C06E16A,
+        0xD0EBA0BB, 0x1C41A025, 0x92CEA7C6, 0x5E64A758, 0x54A1AE41, 0x980BAEDF, 0x1684A93C, 0xDA2EA9A2,
+        0x030EBB0E, 0xCFA4BB90, 0x412BBC73, 0x8D81BCED, 0x8744B5F4, 0x4BEEB56A, 0xC561B289, 0x09CBB217,
+        0xAC509190, 0x60FA910E, 0xEE7596ED, 0x22DF9673, 0x281A9F6A, 0xE4B09FF4, 0x6A3F9817, 0xA6959889,
+        0x7FB58A25, 0xB31F8ABB, 0x3D908D58, 0xF13A8DC6, 0xFBFF84DF, 0x37558441, 0xB9DA83A2, 0x7570833C,
+        0x533B85DA, 0x9F918544, 0x111E82A7, 0xDDB48239, 0xD7718B20, 0x1BDB8BBE, 0x95548C5D, 0x59FE8CC3,
+        0x80DE9E6F, 0x4C749EF1, 0xC2FB9912, 0x0E51998C, 0x04949095, 0xC83E900B, 0x46B197E8, 0x8A1B9776,
+        0x2F80B4F1, 0xE32AB46F, 0x6DA5B38C, 0xA10FB312, 0xABCABA0B, 0x6760BA95, 0xE9EFBD76, 0x2545BDE8,
+        0xFC65AF44, 0x30CFAFDA, 0xBE40A839, 0x72EAA8A7, 0x782FA1BE, 0xB485A120, 0x3A0AA6C3, 0xF6A0A65D,
+        0xAA4DE78C, 0x66E7E712, 0xE868E0F1, 0x24C2E06F, 0x2E07E976, 0xE2ADE9E8, 0x6C22EE0B, 0xA088EE95,
+        0x79A8FC39, 0xB502FCA7, 0x3B8DFB44, 0xF727FBDA, 0xFDE2F2C3, 0x3148F25D, 0xBFC7F5BE, 0x736DF520,
+        0xD6F6D6A7, 0x1A5CD639, 0x94D3D1DA, 0x5879D144, 0x52BCD85D, 0x9E16D8C3, 0x1099DF20, 0xDC33DFBE,
+        0x0513CD12, 0xC9B9CD8C, 0x4736CA6F, 0x8B9CCAF1, 0x8159C3E8, 0x4DF3C376, 0xC37CC495, 0x0FD6C40B,
+        0x7AA64737, 0xB60C47A9, 0x3883404A, 0xF42940D4, 0xFEEC49CD, 0x32464953, 0xBCC94EB0, 0x70634E2E,
+        0xA9435C82, 0x65E95C1C, 0xEB665BFF, 0x27CC5B61, 0x2D095278, 0xE1A352E6, 0x6F2C5505, 0xA386559B,
+        0x061D761C, 0xCAB77682, 0x44387161, 0x889271FF, 0x825778E6, 0x4EFD7878, 0xC0727F9B, 0x0CD87F05,
+        0xD5F86DA9, 0x19526D37, 0x97DD6AD4, 0x5B776A4A, 0x51B26353, 0x9D1863CD, 0x1397642E, 0xDF3D64B0,
+        0x83D02561, 0x4F7A25FF, 0xC1F5221C, 0x0D5F2282, 0x079A2B9B, 0xCB302B05, 0x45BF2CE6, 0x89152C78,
+        0x50353ED4, 0x9C9F3E4A, 0x121039A9, 0xDEBA3937, 0xD47F302E, 0x18D530B0, 0x965A3753, 0x5AF037CD,
+        0xFF6B144A, 0x33C114D4, 0xBD4E1337, 0x71E413A9, 0x7B211AB0, 0xB78B1A2E, 0x39041DCD, 0xF5AE1D53,
+        0x2C8E0FFF, 0xE0240F61, 0x6EAB0882, 0xA201081C, 0xA8C40105, 0x646E019B, 0xEAE10678, 0x264B06E6
+    }
+};
+
+static fs_uint32 fs_zip_crc32(fs_uint32 crc, const void* pData, size_t dataSize)
+{
+    const fs_uint8* pBytes = (const fs_uint8*)pData;
+
+    crc = ~crc;
+
+    while (dataSize >= 8) {
+        fs_uint32 lo = crc ^ FS_ZIP_READ_LE32(pBytes + 0);
+        fs_uint32 hi =       FS_ZIP_READ_LE32(pBytes + 4);
+
+        crc =
+            fs_zip_crc32_table[7][(lo >>  0) & 0xFF] ^
+            fs_zip_crc32_table[6][(lo >>  8) & 0xFF] ^
+            fs_zip_crc32_table[5][(lo >> 16) & 0xFF] ^
+            fs_zip_crc32_table[4][(lo >> 24)       ] ^
+            fs_zip_crc32_table[3][(hi >>  0) & 0xFF] ^
+            fs_zip_crc32_table[2][(hi >>  8) & 0xFF] ^
+            fs_zip_crc32_table[1][(hi >> 16) & 0xFF] ^
+            fs_zip_crc32_table[0][(hi >> 24)       ];
+
+        pBytes   += 8;
+        dataSize -= 8;
+    }
+
+    while (dataSize > 0) {
+        crc = fs_zip_crc32_table[0][(crc ^ *pBytes) & 0xFF] ^ (crc >> 8);
+
+        pBytes   += 1;
+        dataSize -= 1;
+    }
+
+    return ~crc;
+}
+
+#if defined(FS_ZIP_SUPPORTS_PCLMUL)
+static fs_bool32 fs_zip_has_pclmul(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return FS_FALSE;
+    }
+
+    return (ecx & (1 << 1)) != 0;
+#endif
+}
+
+/*
+CRC-32 using carry-less multiplication. This is the folding approach from Intel's "Fast CRC
+Computation for Generic Polynomials Using PCLMULQDQ Instruction" paper. Four 128-bit accumulators are
+folded forward 64 bytes at a time, then folded down to a single 128-bit value, and then reduced to 32
+bits with a Barrett reduction. Anything that doesn't make up a whole 16 byte block is done with the
+table based version.
+*/
+static FS_ZIP_PCLMUL_TARGET fs_uint32 fs_zip_crc32_pclmul(fs_uint32 crc, const void* pData, size_t dataSize)
+{
+    const fs_uint8* pBytes = (const fs_uint8*)pData;
+    __m128i k1k2;
+    __m128i k3k4;
+    __m128i k5k0;
+    __m128i poly;
+    __m128i mask32;
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    if (dataSize < 64) {
+        return fs_zip_crc32(crc, pData, dataSize);
+    }
+
+    /* The constants are all 33 bits which is why they're being set in 32-bit halves. */
+    k1k2   = _mm_set_epi32(0x00000001, (int)0xC6E41596, 0x00000001, (int)0x54442BD4);
+    k3k4   = _mm_set_epi32(0x00000000, (int)0xCCAA009E, 0x00000001, (int)0x751997D0);
+    k5k0   = _mm_set_epi32(0x00000000, 0x00000000, 0x00000001, (int)0x63CD6124);
+    poly   = _mm_set_epi32(0x00000001, (int)0xF7011641, 0x00000001, (int)0xDB710641);
+    mask32 = _mm_set_epi32(0, -1, 0, -1);
+
+    x1 = _mm_loadu_si128((const __m128i*)(pBytes + 0x00));
+    x2 = _mm_loadu_si128((const __m128i*)(pBytes + 0x10));
+    x3 = _mm_loadu_si128((const __m128i*)(pBytes + 0x20));
+    x4 = _mm_loadu_si128((const __m128i*)(pBytes + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)~crc));
+
+    pBytes   += 64;
+    dataSize -= 64;
+
+    /* Fold 64 bytes at a time. */
+    while (dataSize >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(pBytes + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(pBytes + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(pBytes + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(pBytes + 0x30)));
+
+        pBytes   += 64;
+        dataSize -= 64;
+    }
+
+    /* Fold the four accumulators into one. */
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    /* Fold 16 bytes at a time. */
+    while (dataSize >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)pBytes)), x5);
+
+        pBytes   += 16;
+        dataSize -= 16;
+    }
+
+    /* Fold 128 bits down to 64 bits. */
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction down to 32 bits. */
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0  = _mm_srli_si128(x1, 4);
+    crc = ~(fs_uint32)_mm_cvtsi128_si32(x0);
+
+    /* The remaining bytes. */
+    return fs_zip_crc32(crc, pBytes, dataSize);
+}
+#endif
+
+static void fs_zip_write_le16(fs_uint8* pDst, fs_uint16 value)
+{
+    pDst[0] = (fs_uint8)((value >> 0) & 0xFF);
+    pDst[1] = (fs_uint8)((value >> 8) & 0xFF);
+}
+
+static void fs_zip_write_le32(fs_uint8* pDst, fs_uint32 value)
+{
+    pDst[0] = (fs_uint8)((value >>  0) & 0xFF);
+    pDst[1] = (fs_uint8)((value >>  8) & 0xFF);
+    pDst[2] = (fs_uint8)((value >> 16) & 0xFF);
+    pDst[3] = (fs_uint8)((value >> 24) & 0xFF);
+}
+
+static void fs_zip_write_le64(fs_uint8* pDst, fs_uint64 value)
+{
+    fs_zip_write_le32(pDst + 0, (fs_uint32)((value >>  0) & 0xFFFFFFFF));
+    fs_zip_write_le32(pDst + 4, (fs_uint32)((value >> 32) & 0xFFFFFFFF));
+}
+
+static fs_result fs_zip_load_index_file_data(fs_zip* pZip, const fs_uint8* pData, size_t dataSize, const fs_zip_index_file_key* pKey, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_uint64 nodeCount;
+    size_t iFile;
+    size_t iNode;
+    const fs_uint8* pIndexData;
+    const fs_uint8* pNodeData;
+
+    if (dataSize < FS_ZIP_INDEX_FILE_HEADER_SIZE) {
+        return FS_INVALID_FILE;
+    }
+
+    if (FS_ZIP_READ_LE32(pData +  0) != FS_ZIP_INDEX_FILE_SIGNATURE ||
+        FS_ZIP_READ_LE32(pData +  4) != FS_ZIP_INDEX_FILE_VERSION   ||
+        FS_ZIP_READ_LE64(pData +  8) != pKey->archiveSize            ||
+        FS_ZIP_READ_LE64(pData + 16) != pKey->archiveModifiedTime    ||
+        FS_ZIP_READ_LE64(pData + 24) != pKey->centralDirectoryOffset ||
+        FS_ZIP_READ_LE64(pData + 32) != pKey->centralDirectorySize   ||
+        FS_ZIP_READ_LE32(pData + 40) != pKey->centralDirectoryCRC    ||
+        FS_ZIP_READ_LE64(pData + 48) != pKey->fileCount) {
+        return FS_INVALID_FILE; /* The index file is for a different archive, or the archive has changed. */
+    }
+
+    nodeCount = FS_ZIP_READ_LE64(pData + 56);
+    if (nodeCount == 0 || nodeCount > 0xFFFFFFFF) {
+        return FS_INVALID_FILE; /* There must always be a root node. */
+    }
+
+    if ((fs_uint64)dataSize != FS_ZIP_INDEX_FILE_HEADER_SIZE + (pKey->fileCount * FS_ZIP_INDEX_FILE_INDEX_ITEM_SIZE) + (nodeCount * FS_ZIP_INDEX_FILE_NODE_SIZE)) {
+        return FS_INVALID_FILE; /* Truncated, or has trailing data. */
+    }
+
+    /* The heap needs to be resized to make room for the nodes. */
+    {
+        void* pNewHeap = fs_realloc(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR) + (sizeof(*pZip->pIndex) * pZip->fileCount) + (sizeof(*pZip->pCDRootNode) * (size_t)nodeCount), pAllocationCallbacks);
+        if (pNewHeap == NULL) {
+            return FS_OUT_OF_MEMORY;
+        }
+
+        pZip->pHeap = pNewHeap;
+        pZip->pCentralDirectory =                  FS_ZIP_OFFSET_PTR(pZip->pHeap, 0);
+        pZip->pIndex            = (fs_zip_index*  )FS_ZIP_OFFSET_PTR(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR));
+        pZip->pCDRootNode       = (fs_zip_cd_node*)FS_ZIP_OFFSET_PTR(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR) + (sizeof(*pZip->pIndex) * pZip->fileCount));
+    }
+
+    pIndexData = pData + FS_ZIP_INDEX_FILE_HEADER_SIZE;
+    pNodeData  = pIndexData + (pZip->fileCount * FS_ZIP_INDEX_FILE_INDEX_ITEM_SIZE);
+
+    for (iFile = 0; iFile < pZip->fileCount; iFile += 1) {
+        fs_uint32 offsetInBytes = FS_ZIP_READ_LE32(pIndexData + (iFile * FS_ZIP_INDEX_FILE_INDEX_ITEM_SIZE));
+        if (offsetInBytes >= pZip->centralDirectorySize) {
+            return FS_INVALID_FILE;
+        }
+
+        pZip->pIndex[iFile].offsetInBytes = offsetInBytes;
+    }
+
+    /*
+    Everything in the node graph is validated so that a corrupt index file can never result in an
+    out of bounds access. Children are always stored after their parent which we check explicitly so
+    we don't end up with any cycles.
+    */
+    for (iNode = 0; iNode < (size_t)nodeCount; iNode += 1) {
+        const fs_uint8* pNode = pNodeData + (iNode * FS_ZIP_INDEX_FILE_NODE_SIZE);
+        fs_uint32 iNodeFile    = FS_ZIP_READ_LE32(pNode +  0);
+        fs_uint32 nameOffset   = FS_ZIP_READ_LE32(pNode +  4);
+        fs_uint32 nameLen      = FS_ZIP_READ_LE16(pNode +  8);
+        fs_uint32 childCount   = FS_ZIP_READ_LE32(pNode + 12);
+        fs_uint32 iFirstChild  = FS_ZIP_READ_LE32(pNode + 16);
+
+        if ((fs_uint64)nameOffset + nameLen > pZip->centralDirectorySize) {
+            return FS_INVALID_FILE;
+        }
+
+        /* Every node except the root refers to a file, including directories since paths are resolved through them. */
+        if (iNode > 0 && iNodeFile >= pZip->fileCount) {
+            return FS_INVALID_FILE;
+        }
+
+        if (childCount > 0) {
+            if (iFirstChild <= iNode || (fs_uint64)iFirstChild + childCount > nodeCount) {
+                return FS_INVALID_FILE;
+            }
+        }
+
+        pZip->pCDRootNode[iNode].iFile                = iNodeFile;
+        pZip->pCDRootNode[iNode].pName                = (nameLen > 0) ? (const char*)FS_ZIP_OFFSET_PTR(pZip->pCentralDirectory, nameOffset) : "";
+        pZip->pCDRootNode[iNode].nameLen              = nameLen;
+        pZip->pCDRootNode[iNode].childCount           = childCount;
+        pZip->pCDRootNode[iNode].pChildren            = &pZip->pCDRootNode[(childCount > 0) ? iFirstChild : 0];
+        pZip->pCDRootNode[iNode]._descendantRangeBeg  = 0;
+        pZip->pCDRootNode[iNode]._descendantRangeEnd  = 0;
+        pZip->pCDRootNode[iNode]._descendantPrefixLen = 0;
+    }
+
+    pZip->nodeCount = (size_t)nodeCount;
+
+    return FS_SUCCESS;
+}
+
+static fs_result fs_zip_load_index_file(fs_zip* pZip, fs* pIndexFS, const char* pIndexFilePath, const fs_zip_index_file_key* pKey, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_result result;
+    fs_file* pIndexFile;
+    const void* pData;
+    size_t dataSize;
+
+    result = fs_file_open(pIndexFS, pIndexFilePath, FS_READ, &pIndexFile);
+    if (result != FS_SUCCESS) {
+        return result;  /* Most likely the index file hasn't been created yet. */
+    }
+
+    result = fs_file_map(pIndexFile, &pData, &dataSize);
+    if (result != FS_SUCCESS) {
+        fs_file_close(pIndexFile);
+        return result;
+    }
+
+    result = fs_zip_load_index_file_data(pZip, (const fs_uint8*)pData, dataSize, pKey, pAllocationCallbacks);
+
+    fs_file_unmap(pIndexFile);
+    fs_file_close(pIndexFile);
+
+    return result;
+}
+
+static fs_result fs_zip_save_index_file(const fs_zip* pZip, fs* pIndexFS, const char* pIndexFilePath, const fs_zip_index_file_key* pKey, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_result result;
+    fs_file* pIndexFile;
+    fs_uint8* pData;
+    size_t dataSize;
+    size_t iFile;
+    size_t iNode;
+    fs_uint8* pIndexData;
+    fs_uint8* pNodeData;
+
+    /* Everything is stored as 32-bit in the index file to keep it compact. Huge archives will just not use an index file. */
+    if (pZip->fileCount > 0xFFFFFFFF || pZip->nodeCount > 0xFFFFFFFF || pZip->centralDirectorySize > 0xFFFFFFFF) {
+        return FS_TOO_BIG;
+    }
+
+    if (((fs_uint64)FS_ZIP_INDEX_FILE_HEADER_SIZE + ((fs_uint64)pZip->fileCount * FS_ZIP_INDEX_FILE_INDEX_ITEM_SIZE) + ((fs_uint64)pZip->nodeCount * FS_ZIP_INDEX_FILE_NODE_SIZE)) > FS_SIZE_MAX) {
+        return FS_TOO_BIG;
+    }
+
+    dataSize = FS_ZIP_INDEX_FILE_HEADER_SIZE + (pZip->fileCount * FS_ZIP_INDEX_FILE_INDEX_ITEM_SIZE) + (pZip->nodeCount * FS_ZIP_INDEX_FILE_NODE_SIZE);
+
+    pData = (fs_uint8*)fs_malloc(dataSize, pAllocationCallbacks);
+    if (pData == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    fs_zip_write_le32(pData +  0, FS_ZIP_INDEX_FILE_SIGNATURE);
+    fs_zip_write_le32(pData +  4, FS_ZIP_INDEX_FILE_VERSION);
+    fs_zip_write_le64(pData +  8, pKey->archiveSize);
+    fs_zip_write_le64(pData + 16, pKey->archiveModifiedTime);
+    fs_zip_write_le64(pData + 24, pKey->centralDirectoryOffset);
+    fs_zip_write_le64(pData + 32, pKey->centralDirectorySize);
+    fs_zip_write_le32(pData + 40, pKey->centralDirectoryCRC);
+    fs_zip_write_le32(pData + 44, 0);
+    fs_zip_write_le64(pData + 48, pKey->fileCount);
+    fs_zip_write_le64(pData + 56, pZip->nodeCount);
+
+    pIndexData = pData + FS_ZIP_INDEX_FILE_HEADER_SIZE;
+    pNodeData  = pIndexData + (pZip->fileCount * FS_ZIP_INDEX_FILE_INDEX_ITEM_SIZE);
+
+    for (iFile = 0; iFile < pZip->fileCount; iFile += 1) {
+        fs_zip_write_le32(pIndexData + (iFile * FS_ZIP_INDEX_FILE_INDEX_ITEM_SIZE), (fs_uint32)pZip->pIndex[iFile].offsetInBytes);
+    }
+
+    for (iNode = 0; iNode < pZip->nodeCount; iNode += 1) {
+        const fs_zip_cd_node* pNode = &pZip->pCDRootNode[iNode];
+        fs_uint8* pDst = pNodeData + (iNode * FS_ZIP_INDEX_FILE_NODE_SIZE);
+        size_t nameOffset = 0;
+        size_t iFirstChild = 0;
+
+        /* The root node's name does not point into the central directory. */
+        if (pNode->nameLen > 0) {
+            nameOffset = (size_t)(pNode->pName - (const char*)pZip->pCentralDirectory);
+        }
+
+        if (pNode->childCount > 0) {
+            iFirstChild = (size_t)(pNode->pChildren - pZip->pCDRootNode);
+        }
+
+        fs_zip_write_le32(pDst +  0, (fs_uint32)pNode->iFile);
+        fs_zip_write_le32(pDst +  4, (fs_uint32)nameOffset);
+        fs_zip_write_le32(pDst +  8, (fs_uint32)(pNode->nameLen & 0xFFFF));    /* Name length and the reserved field. */
+        fs_zip_write_le32(pDst + 12, (fs_uint32)pNode->childCount);
+        fs_zip_write_le32(pDst + 16, (fs_uint32)iFirstChild);
+    }
+
+    result = fs_file_open(pIndexFS, pIndexFilePath, FS_WRITE | FS_TRUNCATE, &pIndexFile);
+    if (result == FS_SUCCESS) {
+        result = fs_file_write(pIndexFile, pData, dataSize, NULL);
+        fs_file_close(pIndexFile);
+    }
+
+    fs_free(pData, pAllocationCallbacks);
+
+    return result;
+}
+
+/*
+Archive writing. When the archive is initialized with the write option, files opened with FS_WRITE
+stream their data straight to the archive's stream. Since the stream is never seeked, the CRC and sizes
+can't be filled in to the local header once the data has been written. Instead they go into a data
+descriptor after the data and the local header is left with zeroes. Each entry is remembered in memory
+and the central directory is written out when the archive is uninitialized.
+*/
+static void fs_zip_dos_date_time_from_unix_time(fs_uint64 unixTime, fs_uint16* pDosTime, fs_uint16* pDosDate)
+{
+    fs_uint64 days;
+    fs_uint32 secondsOfDay;
+    fs_uint64 era;
+    fs_uint32 dayOfEra;
+    fs_uint32 yearOfEra;
+    fs_uint32 dayOfYear;
+    fs_uint32 monthIndex;
+    fs_uint64 year;
+    fs_uint32 month;
+    fs_uint32 day;
+
+    /* This is the standard conversion from days since 1970-01-01 to a civil date. Months are counted from March so that leap days come last. */
+    days         = unixTime / 86400;
+    secondsOfDay = (fs_uint32)(unixTime % 86400);
+    era          = (days + 719468) / 146097;
+    dayOfEra     = (fs_uint32)((days + 719468) - (era * 146097));
+    yearOfEra    = (dayOfEra - dayOfEra/1460 + dayOfEra/36524 - dayOfEra/146096) / 365;
+    dayOfYear    = dayOfEra - (365*yearOfEra + yearOfEra/4 - yearOfEra/100);
+    monthIndex   = (5*dayOfYear + 2) / 153;
+    day          = dayOfYear - (153*monthIndex + 2)/5 + 1;
+    month        = (monthIndex < 10) ? (monthIndex + 3) : (monthIndex - 9);
+    year         = (yearOfEra + era*400) + ((month <= 2) ? 1 : 0);
+
+    /* DOS dates can only represent 1980 to 2107. */
+    if (year < 1980) {
+        *pDosTime = 0;
+        *pDosDate = (1 << 5) | 1;
+        return;
+    }
+
+    if (year > 2107) {
+        *pDosTime = (23 << 11) | (59 << 5) | 29;
+        *pDosDate = (fs_uint16)(((2107 - 1980) << 9) | (12 << 5) | 31);
+        return;
+    }
+
+    *pDosTime = (fs_uint16)(((secondsOfDay / 3600) << 11) | (((secondsOfDay / 60) % 60) << 5) | ((secondsOfDay % 60) / 2));
+    *pDosDate = (fs_uint16)((((fs_uint32)year - 1980) << 9) | (month << 5) | day);
+}
+
+static fs_zip_write_entry* fs_zip_writer_find_entry(fs_zip* pZip, const char* pPath, size_t pathLen)
+{
+    fs_uint32 hash;
+    size_t mask;
+    size_t iSlot;
+
+    if (pZip->writeEntryTableCap == 0) {
+        return NULL;
+    }
+
+    hash  = fs_zip_path_hash_segment(FS_ZIP_PATH_HASH_BASIS, pPath, pathLen);
+    mask  = pZip->writeEntryTableCap - 1;
+    iSlot = hash & mask;
+
+    while (pZip->pWriteEntryTable[iSlot].iNode != 0) {
+        if (pZip->pWriteEntryTable[iSlot].hash == hash) {
+            fs_zip_write_entry* pEntry = pZip->ppWriteEntries[pZip->pWriteEntryTable[iSlot].iNode - 1];
+            if (pEntry->pathLen == pathLen && strncmp(pEntry->pPath, pPath, pathLen) == 0) {
+                return pEntry;
+            }
+        }
+
+        iSlot = (iSlot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+static void fs_zip_writer_insert_entry_into_table(fs_zip* pZip, size_t iEntry)
+{
+    fs_uint32 hash = pZip->ppWriteEntries[iEntry]->hash;
+    size_t mask = pZip->writeEntryTableCap - 1;
+    size_t iSlot = hash & mask;
+
+    while (pZip->pWriteEntryTable[iSlot].iNode != 0) {
+        iSlot = (iSlot + 1) & mask;
+    }
+
+    pZip->pWriteEntryTable[iSlot].hash  = hash;
+    pZip->pWriteEntryTable[iSlot].iNode = (fs_uint32)(iEntry + 1);
+}
+
+static fs_result fs_zip_writer_add_entry(fs_zip* pZip, const char* pPath, size_t pathLen, fs_bool32 directory, fs_uint16 compressionMethod, const fs_allocation_callbacks* pAllocationCallbacks, fs_zip_write_entry** ppEntry)
+{
+    fs_zip_write_entry* pEntry;
+    size_t iEntry;
+
+    /* Entry indexes are stored as 32-bit in the table, with 0 reserved for empty slots. */
+    if (pZip->writeEntryCount >= 0x7FFFFFFF) {
+        return FS_TOO_BIG;
+    }
+
+    if (pZip->writeEntryCount == pZip->writeEntryCap) {
+        size_t newCap = (pZip->writeEntryCap == 0) ? 64 : (pZip->writeEntryCap * 2);
+        fs_zip_write_entry** ppNewEntries;
+
+        ppNewEntries = (fs_zip_write_entry**)fs_realloc(pZip->ppWriteEntries, sizeof(*pZip->ppWriteEntries) * newCap, pAllocationCallbacks);
+        if (ppNewEntries == NULL) {
+            return FS_OUT_OF_MEMORY;
+        }
+
+        pZip->ppWriteEntries = ppNewEntries;
+        pZip->writeEntryCap  = newCap;
+    }
+
+    /* Keep the load factor of the table under 0.75 so probe sequences stay short. */
+    if (pZip->writeEntryTableCap < (pZip->writeEntryCount + 1) + ((pZip->writeEntryCount + 1) / 3) + 1) {
+        size_t newCap = (pZip->writeEntryTableCap == 0) ? 128 : (pZip->writeEntryTableCap * 2);
+        fs_zip_path_hash_slot* pNewTable;
+
+        pNewTable = (fs_zip_path_hash_slot*)fs_calloc(sizeof(*pNewTable) * newCap, pAllocationCallbacks);
+        if (pNewTable == NULL) {
+            return FS_OUT_OF_MEMORY;
+        }
+
+        fs_free(pZip->pWriteEntryTable, pAllocationCallbacks);
+        pZip->pWriteEntryTable   = pNewTable;
+        pZip->writeEntryTableCap = newCap;
+
+        for (iEntry = 0; iEntry < pZip->writeEntryCount; iEntry += 1) {
+            fs_zip_writer_insert_entry_into_table(pZip, iEntry);
+        }
     }
 
-    return compareResult;
+    /* Room for a trailing slash and a null terminator. */
+    pEntry = (fs_zip_write_entry*)fs_malloc(sizeof(*pEntry) + pathLen + 2, pAllocationCallbacks);
+    if (pEntry == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    pEntry->pPath = (char*)FS_ZIP_OFFSET_PTR(pEntry, sizeof(*pEntry));
+    FS_ZIP_COPY_MEMORY(pEntry->pPath, pPath, pathLen);
+    if (directory) {
+        pEntry->pPath[pathLen] = '/';
+        pEntry->pPath[pathLen + 1] = '\0';
+    } else {
+        pEntry->pPath[pathLen] = '\0';
+    }
+
+    pEntry->pathLen           = pathLen;
+    pEntry->hash              = fs_zip_path_hash_segment(FS_ZIP_PATH_HASH_BASIS, pPath, pathLen);
+    pEntry->directory         = directory;
+    pEntry->compressionMethod = compressionMethod;
+    pEntry->crc32             = 0;
+    pEntry->compressedSize    = 0;
+    pEntry->uncompressedSize  = 0;
+    pEntry->localHeaderOffset = pZip->writeCursor;
+
+    iEntry = pZip->writeEntryCount;
+    pZip->ppWriteEntries[iEntry] = pEntry;
+    pZip->writeEntryCount += 1;
+
+    fs_zip_writer_insert_entry_into_table(pZip, iEntry);
+
+    *ppEntry = pEntry;
+    return FS_SUCCESS;
 }
 
-static fs_zip_cd_node* fs_zip_cd_node_find_child(fs_zip_cd_node* pParent, const char* pChildName, size_t childNameLen)
+/*
+All writes to the stream go through this. The first error is remembered and everything after that
+fails with the same error since the archive will be corrupt by that point anyway.
+*/
+static fs_result fs_zip_writer_write(fs_zip* pZip, fs_stream* pStream, const void* pData, size_t dataSize)
 {
-    fs_zip_refstring str;
-    str.str = pChildName;
-    str.len = childNameLen;
+    fs_result result;
 
-    return (fs_zip_cd_node*)fs_sorted_search(&str, pParent->pChildren, pParent->childCount, sizeof(*pParent->pChildren), fs_zip_binary_search_zip_cd_node_compare, NULL);
+    if (pZip->writeResult != FS_SUCCESS) {
+        return pZip->writeResult;
+    }
+
+    result = fs_stream_write(pStream, pData, dataSize, NULL);
+    if (result != FS_SUCCESS) {
+        pZip->writeResult = result;
+        return result;
+    }
+
+    pZip->writeCursor += dataSize;
+    return FS_SUCCESS;
 }
 
+static fs_result fs_zip_writer_write_local_header(fs_zip* pZip, fs_stream* pStream, const fs_zip_write_entry* pEntry)
+{
+    fs_result result;
+    fs_uint8 header[30];
+    size_t pathLen = pEntry->pathLen + (pEntry->directory ? 1 : 0);
+
+    /* Directories have no data so everything is known up front and they don't need a data descriptor. */
+    fs_zip_write_le32(header +  0, FS_ZIP_LOCAL_FILE_HEADER_SIGNATURE);
+    fs_zip_write_le16(header +  4, FS_ZIP_VERSION_DEFAULT);
+    fs_zip_write_le16(header +  6, (fs_uint16)(FS_ZIP_FLAG_UTF8 | (pEntry->directory ? 0 : FS_ZIP_FLAG_DATA_DESCRIPTOR)));
+    fs_zip_write_le16(header +  8, pEntry->compressionMethod);
+    fs_zip_write_le16(header + 10, pZip->writeDosTime);
+    fs_zip_write_le16(header + 12, pZip->writeDosDate);
+    fs_zip_write_le32(header + 14, 0);  /* CRC-32. */
+    fs_zip_write_le32(header + 18, 0);  /* Compressed size. */
+    fs_zip_write_le32(header + 22, 0);  /* Uncompressed size. */
+    fs_zip_write_le16(header + 26, (fs_uint16)pathLen);
+    fs_zip_write_le16(header + 28, 0);  /* Extra field length. */
+
+    result = fs_zip_writer_write(pZip, pStream, header, sizeof(header));
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    return fs_zip_writer_write(pZip, pStream, pEntry->pPath, pathLen);
+}
 
-static fs_result fs_zip_get_file_info_by_record_offset(fs_zip* pZip, size_t offset, fs_zip_file_info* pInfo)
+/*
+The data descriptor uses 64-bit sizes if either size doesn't fit in 32 bits. Readers are supposed to
+know which it is from the ZIP64 extra field in the local header, but we can't know whether or not a
+file will need it until it's been written. Readers generally use the central directory instead.
+*/
+static fs_result fs_zip_writer_write_data_descriptor(fs_zip* pZip, fs_stream* pStream, const fs_zip_write_entry* pEntry)
 {
-    fs_uint16 filePathLen;
-    const unsigned char* pCentralDirectoryRecord;
+    fs_uint8 descriptor[24];
 
-    FS_ZIP_ASSERT(pZip  != NULL);
-    FS_ZIP_ASSERT(pInfo != NULL);
+    fs_zip_write_le32(descriptor + 0, FS_ZIP_DATA_DESCRIPTOR_SIGNATURE);
+    fs_zip_write_le32(descriptor + 4, pEntry->crc32);
 
-    FS_ZIP_ZERO_OBJECT(pInfo);
+    if (pEntry->compressedSize >= 0xFFFFFFFF || pEntry->uncompressedSize >= 0xFFFFFFFF) {
+        fs_zip_write_le64(descriptor +  8, pEntry->compressedSize);
+        fs_zip_write_le64(descriptor + 16, pEntry->uncompressedSize);
+        return fs_zip_writer_write(pZip, pStream, descriptor, 24);
+    } else {
+        fs_zip_write_le32(descriptor +  8, (fs_uint32)pEntry->compressedSize);
+        fs_zip_write_le32(descriptor + 12, (fs_uint32)pEntry->uncompressedSize);
+        return fs_zip_writer_write(pZip, pStream, descriptor, 16);
+    }
+}
 
-    pCentralDirectoryRecord = (const unsigned char*)FS_ZIP_OFFSET_PTR(pZip->pCentralDirectory, offset);
+static fs_result fs_zip_writer_queue_item(fs_zip* pZip, fs_zip_write_item_type type, fs_zip_write_entry* pEntry, size_t iChunk, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    if (pZip->writeResult != FS_SUCCESS) {
+        return pZip->writeResult;
+    }
 
-    /* Check that we're not going to overflow the central directory. */
-    if (offset + 46 > pZip->centralDirectorySize) {   /* 46 is the offset of the file path. */
-        return FS_INVALID_FILE;  /* Look like an invalid central directory. */
+    if (pZip->batchItemCount == pZip->batchItemCap) {
+        size_t newCap = (pZip->batchItemCap == 0) ? 64 : (pZip->batchItemCap * 2);
+        fs_zip_write_item* pNewItems;
+
+        pNewItems = (fs_zip_write_item*)fs_realloc(pZip->pBatchItems, sizeof(*pZip->pBatchItems) * newCap, pAllocationCallbacks);
+        if (pNewItems == NULL) {
+            pZip->writeResult = FS_OUT_OF_MEMORY;  /* Dropping an item would leave the archive corrupt. */
+            return FS_OUT_OF_MEMORY;
+        }
+
+        pZip->pBatchItems  = pNewItems;
+        pZip->batchItemCap = newCap;
     }
 
-    /* Grab the length of the file path. */
-    filePathLen = ((fs_uint16)pCentralDirectoryRecord[29] << 8) | pCentralDirectoryRecord[28];
+    pZip->pBatchItems[pZip->batchItemCount].type   = type;
+    pZip->pBatchItems[pZip->batchItemCount].pEntry = pEntry;
+    pZip->pBatchItems[pZip->batchItemCount].iChunk = iChunk;
+    pZip->batchItemCount += 1;
 
-    /* Now we can move to the file path, again making sure we have enough room for the file path. */
-    if (offset + 46 + filePathLen > pZip->centralDirectorySize) {
-        return FS_INVALID_FILE;  /* Looks like an invalid central directory. */
+    return FS_SUCCESS;
+}
+
+/*
+Local headers go straight to the stream unless there's compressed data waiting to be written, in
+which case they need to wait their turn.
+*/
+static fs_result fs_zip_writer_begin_entry(fs_zip* pZip, fs_stream* pStream, fs_zip_write_entry* pEntry, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    if (pZip->batchItemCount > 0) {
+        return fs_zip_writer_queue_item(pZip, FS_ZIP_WRITE_ITEM_LOCAL_HEADER, pEntry, 0, pAllocationCallbacks);
     }
 
-    pInfo->pPath   = (const char*)(pCentralDirectoryRecord + 46);
-    pInfo->pathLen = filePathLen;
+    pEntry->localHeaderOffset = pZip->writeCursor;
+    return fs_zip_writer_write_local_header(pZip, pStream, pEntry);
+}
 
-    /* We can determine if the entry is a directory by checking if the path ends in a slash. */
-    if (pInfo->pathLen > 0 && (pInfo->pPath[pInfo->pathLen-1] == '/' || pInfo->pPath[pInfo->pathLen-1] == '\\')) {
-        pInfo->directory = FS_TRUE;
+/* Puts everything of the file being written that isn't in a chunk yet into a new chunk. */
+static fs_result fs_zip_writer_add_chunk(fs_zip* pZip, fs_zip_write_entry* pEntry, fs_bool32 isFinal, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_zip_write_chunk* pChunk;
+
+    if (pZip->writeResult != FS_SUCCESS) {
+        return pZip->writeResult;
     }
 
-    /* Compression method. */
-    pInfo->compressionMethod = ((fs_uint16)pCentralDirectoryRecord[11] << 8) | pCentralDirectoryRecord[10];
+    if (pZip->batchChunkCount == pZip->batchChunkCap) {
+        size_t newCap = (pZip->batchChunkCap == 0) ? 64 : (pZip->batchChunkCap * 2);
+        fs_zip_write_chunk* pNewChunks;
 
-    /* Get the size of the file. */
-    pInfo->compressedSize   = ((fs_uint32)pCentralDirectoryRecord[23] << 24) | ((fs_uint32)pCentralDirectoryRecord[22] << 16) | ((fs_uint32)pCentralDirectoryRecord[21] << 8) | (fs_uint32)pCentralDirectoryRecord[20];
-    pInfo->uncompressedSize = ((fs_uint32)pCentralDirectoryRecord[27] << 24) | ((fs_uint32)pCentralDirectoryRecord[26] << 16) | ((fs_uint32)pCentralDirectoryRecord[25] << 8) | (fs_uint32)pCentralDirectoryRecord[24];
+        pNewChunks = (fs_zip_write_chunk*)fs_realloc(pZip->pBatchChunks, sizeof(*pZip->pBatchChunks) * newCap, pAllocationCallbacks);
+        if (pNewChunks == NULL) {
+            pZip->writeResult = FS_OUT_OF_MEMORY;
+            return FS_OUT_OF_MEMORY;
+        }
 
-    /* File offset. */
-    pInfo->fileOffset = ((fs_uint32)pCentralDirectoryRecord[45] << 24) | ((fs_uint32)pCentralDirectoryRecord[44] << 16) | ((fs_uint32)pCentralDirectoryRecord[43] << 8) | pCentralDirectoryRecord[42];
+        pZip->pBatchChunks  = pNewChunks;
+        pZip->batchChunkCap = newCap;
+    }
 
+    pChunk = &pZip->pBatchChunks[pZip->batchChunkCount];
+    pChunk->inputOffset    = pZip->batchChunkOffset;
+    pChunk->inputSize      = pZip->batchInputSize - pZip->batchChunkOffset;
+    pChunk->dictionarySize = FS_ZIP_MIN(pZip->batchChunkOffset - pZip->batchFileOffset, (size_t)FS_ZIP_DEFLATE_WINDOW_SIZE);
+    pChunk->isFinal        = isFinal;
+    pChunk->outputOffset   = 0;
+    pChunk->outputSize     = 0;
+    pChunk->result         = FS_SUCCESS;
+    pZip->batchChunkCount += 1;
 
-    /*
-    Load Zip64 data if necessary. It's in the extra data. The extra data is made up of a
-    number of blocks. Each block has a 2 byte ID and a 2 byte size. When reading from
-    each block, we need to make sure we don't try reading beyond the reported size of
-    the extra data.
-    
-    The Zip64 data will be stored in a block with the ID of 0x0001. The presence of each
-    member inside this block is conditional to whether or not it's set to 0xFFFFFFFF in
-    the main part of the central directory record.
-    */
-    if (pInfo->compressedSize == 0xFFFFFFFF || pInfo->uncompressedSize == 0xFFFFFFFF || pInfo->fileOffset == 0xFFFFFFFF) {
-        fs_uint16 extraDataSize   = ((fs_uint16)pCentralDirectoryRecord[31] << 8) | pCentralDirectoryRecord[30];
-        fs_uint16 extraDataOffset = 0;
+    pZip->batchChunkOffset = pZip->batchInputSize;
 
-        const unsigned char* pExtraData = (const unsigned char*)(pCentralDirectoryRecord + 46 + filePathLen);
+    return fs_zip_writer_queue_item(pZip, FS_ZIP_WRITE_ITEM_CHUNK, pEntry, pZip->batchChunkCount - 1, pAllocationCallbacks);
+}
 
-        /* For each chunk in the extra data. */
-        for (;;) {
-            fs_uint16 chunkID;
-            fs_uint16 chunkSize;
+typedef struct
+{
+    fs_zip* pZip;
+    fs_zip_deflate_compressor* pCompressor;
+    size_t iChunkBeg;
+    size_t iChunkEnd;
+} fs_zip_compress_job;
 
-            if (extraDataOffset == extraDataSize) {
-                break;  /* We're done. */
-            }
+static int fs_zip_compress_job_run(void* pUserData)
+{
+    fs_zip_compress_job* pJob = (fs_zip_compress_job*)pUserData;
+    fs_zip* pZip = pJob->pZip;
+    size_t iChunk;
 
-            if (extraDataOffset > extraDataSize) {
-                return FS_INVALID_FILE;  /* We've somehow read past the extra data. Abort. */
-            }
+    for (iChunk = pJob->iChunkBeg; iChunk < pJob->iChunkEnd; iChunk += 1) {
+        fs_zip_write_chunk* pChunk = &pZip->pBatchChunks[iChunk];
 
-            if ((extraDataSize - extraDataOffset) < 4) {
-                return FS_INVALID_FILE;  /* Not enough data in the extra data to read the chunk header. */
-            }
+        pChunk->result = fs_zip_deflate_compress(pJob->pCompressor, pZip->compressionLevel, pZip->pBatchInput + pChunk->inputOffset, pChunk->dictionarySize, pChunk->inputSize, pChunk->isFinal, pZip->pBatchOutput + pChunk->outputOffset, fs_zip_deflate_compress_bound(pChunk->inputSize), &pChunk->outputSize);
+    }
 
-            chunkID   = ((fs_uint16)pExtraData[extraDataOffset+1] << 8) | pExtraData[extraDataOffset+0];
-            chunkSize = ((fs_uint16)pExtraData[extraDataOffset+3] << 8) | pExtraData[extraDataOffset+2];
+    return 0;
+}
 
-            /* Increment the offset to make it easy to parse the data in the next section. */
-            extraDataOffset += 4;
+/*
+Compresses every chunk in the batch and then writes out all of the queued items. The chunks are
+split between the threads so that each one gets roughly the same amount of data. If a file is still
+being written, the end of its data is moved to the start of the batch so that it can be used as the
+dictionary of its next chunk.
+*/
+static fs_result fs_zip_writer_run_batch(fs_zip* pZip, fs_stream* pStream, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_zip_compress_job jobs[FS_ZIP_MAX_THREAD_COUNT];
+    size_t jobCount;
+    size_t iJob;
+    size_t iChunk;
+    size_t iItem;
+    size_t outputSize;
+    size_t totalInputSize;
+    size_t runningInputSize;
+    size_t carryOffset;
+
+    if (pZip->writeResult == FS_SUCCESS && pZip->batchChunkCount > 0) {
+        outputSize     = 0;
+        totalInputSize = 0;
+        for (iChunk = 0; iChunk < pZip->batchChunkCount; iChunk += 1) {
+            pZip->pBatchChunks[iChunk].outputOffset = outputSize;
+            outputSize     += fs_zip_deflate_compress_bound(pZip->pBatchChunks[iChunk].inputSize);
+            totalInputSize += pZip->pBatchChunks[iChunk].inputSize;
+        }
 
-            if ((extraDataSize - extraDataOffset) < chunkSize) {
-                return FS_INVALID_FILE;  /* Not enough data in the extra data to read the chunk. */
+        if (outputSize > pZip->batchOutputCap) {
+            fs_free(pZip->pBatchOutput, pAllocationCallbacks);
+
+            pZip->pBatchOutput = (fs_uint8*)fs_malloc(outputSize, pAllocationCallbacks);
+            if (pZip->pBatchOutput == NULL) {
+                pZip->batchOutputCap = 0;
+                pZip->writeResult = FS_OUT_OF_MEMORY;
+            } else {
+                pZip->batchOutputCap = outputSize;
             }
+        }
 
-            if (chunkID == 0x0001) {
-                /* Zip64 data. */
-                fs_uint32 chunkLocalOffset = 0;
+        if (pZip->writeResult == FS_SUCCESS) {
+            jobCount = FS_ZIP_MIN(pZip->compressThreadCount, pZip->batchChunkCount);
 
-                if (pInfo->uncompressedSize == 0xFFFFFFFF) {
-                    if (chunkLocalOffset + 8 > chunkSize) {
-                        return FS_INVALID_FILE;  /* Not enough data in the chunk. */
-                    }
+            /* Every job gets at least one chunk, and then keeps taking chunks until it has its share of the data. */
+            iChunk = 0;
+            runningInputSize = 0;
+            for (iJob = 0; iJob < jobCount; iJob += 1) {
+                size_t targetInputSize = (totalInputSize / jobCount) * (iJob + 1);
 
-                    pInfo->uncompressedSize = ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+7] << 56) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+6] << 48) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+5] << 40) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+4] << 32) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+3] << 24) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+2] << 16) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+1] << 8) | (fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+0];
-                    chunkLocalOffset += 8;
-                }
+                jobs[iJob].pZip        = pZip;
+                jobs[iJob].pCompressor = &pZip->pCompressors[iJob];
+                jobs[iJob].iChunkBeg   = iChunk;
 
-                if (pInfo->compressedSize == 0xFFFFFFFF) {
-                    if (chunkLocalOffset + 8 > chunkSize) {
-                        return FS_INVALID_FILE;  /* Not enough data in the chunk. */
-                    }
+                do {
+                    runningInputSize += pZip->pBatchChunks[iChunk].inputSize;
+                    iChunk += 1;
+                } while (iChunk < pZip->batchChunkCount - (jobCount - iJob - 1) && runningInputSize < targetInputSize);
 
-                    pInfo->compressedSize = ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+7] << 56) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+6] << 48) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+5] << 40) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+4] << 32) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+3] << 24) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+2] << 16) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+1] << 8) | (fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+0];
-                    chunkLocalOffset += 8;
+                if (iJob == jobCount - 1) {
+                    iChunk = pZip->batchChunkCount;
                 }
 
-                if (pInfo->fileOffset == 0xFFFFFFFF) {
-                    if (chunkLocalOffset + 8 > chunkSize) {
-                        return FS_INVALID_FILE;  /* Not enough data in the chunk. */
-                    }
+                jobs[iJob].iChunkEnd = iChunk;
+            }
 
-                    pInfo->fileOffset = ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+7] << 56) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+6] << 48) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+5] << 40) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+4] << 32) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+3] << 24) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+2] << 16) | ((fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+1] << 8) | (fs_uint64)pExtraData[extraDataOffset+chunkLocalOffset+0];
-                    chunkLocalOffset += 8; (void)chunkLocalOffset;
+            fs_zip_run_jobs(fs_zip_compress_job_run, jobs, sizeof(jobs[0]), jobCount, pAllocationCallbacks);
+
+            for (iChunk = 0; iChunk < pZip->batchChunkCount; iChunk += 1) {
+                if (pZip->pBatchChunks[iChunk].result != FS_SUCCESS) {
+                    pZip->writeResult = pZip->pBatchChunks[iChunk].result;
+                    break;
                 }
             }
+        }
+    }
 
-            extraDataOffset += chunkSize;
+    for (iItem = 0; iItem < pZip->batchItemCount && pZip->writeResult == FS_SUCCESS; iItem += 1) {
+        fs_zip_write_item* pItem = &pZip->pBatchItems[iItem];
+
+        if (pItem->type == FS_ZIP_WRITE_ITEM_LOCAL_HEADER) {
+            pItem->pEntry->localHeaderOffset = pZip->writeCursor;
+            fs_zip_writer_write_local_header(pZip, pStream, pItem->pEntry);
+        } else if (pItem->type == FS_ZIP_WRITE_ITEM_CHUNK) {
+            const fs_zip_write_chunk* pChunk = &pZip->pBatchChunks[pItem->iChunk];
+
+            if (fs_zip_writer_write(pZip, pStream, pZip->pBatchOutput + pChunk->outputOffset, pChunk->outputSize) == FS_SUCCESS) {
+                pItem->pEntry->compressedSize += pChunk->outputSize;
+            }
+        } else {
+            fs_zip_writer_write_data_descriptor(pZip, pStream, pItem->pEntry);
         }
     }
 
-    return FS_SUCCESS;
-}
+    if (pZip->isWritingFile) {
+        carryOffset = 0;
+        if (pZip->batchChunkOffset > FS_ZIP_DEFLATE_WINDOW_SIZE) {
+            carryOffset = pZip->batchChunkOffset - FS_ZIP_DEFLATE_WINDOW_SIZE;
+        }
+        if (carryOffset < pZip->batchFileOffset) {
+            carryOffset = pZip->batchFileOffset;
+        }
 
-static const char* fs_zip_get_file_path_by_record_offset(fs_zip* pZip, size_t offset, size_t* pLength)
-{
-    fs_uint16 length;
-    const char* pCentralDirectoryRecord;
+        FS_ZIP_MOVE_MEMORY(pZip->pBatchInput, pZip->pBatchInput + carryOffset, pZip->batchInputSize - carryOffset);
+        pZip->batchInputSize   -= carryOffset;
+        pZip->batchFileOffset   = 0;
+        pZip->batchChunkOffset -= carryOffset;
+    } else {
+        pZip->batchInputSize   = 0;
+        pZip->batchFileOffset  = 0;
+        pZip->batchChunkOffset = 0;
+    }
 
-    FS_ZIP_ASSERT(pLength != NULL);
+    pZip->batchChunkCount = 0;
+    pZip->batchItemCount  = 0;
 
-    *pLength = 0;
+    return pZip->writeResult;
+}
 
-    pCentralDirectoryRecord = (const char*)FS_ZIP_OFFSET_PTR(pZip->pCentralDirectory, offset);
+static fs_result fs_zip_writer_compress(fs_zip* pZip, fs_stream* pStream, fs_zip_write_entry* pEntry, const void* pData, size_t dataSize, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    while (dataSize > 0 && pZip->writeResult == FS_SUCCESS) {
+        size_t bytesToCopy;
 
-    /* Check that we're not going to overflow the central directory. */
-    if (offset + 46 > pZip->centralDirectorySize) {   /* 46 is the offset of the file path. */
-        return NULL;    /* Look like an invalid central directory. */
-    }
+        if (pZip->batchInputSize == pZip->batchInputCap) {
+            if (fs_zip_writer_run_batch(pZip, pStream, pAllocationCallbacks) != FS_SUCCESS) {
+                break;
+            }
+        }
 
-    /* Grab the length of the file. */
-    length = ((fs_uint16)pCentralDirectoryRecord[29] << 8) | pCentralDirectoryRecord[28];
+        bytesToCopy = FS_ZIP_MIN(dataSize, pZip->batchInputCap - pZip->batchInputSize);
+        bytesToCopy = FS_ZIP_MIN(bytesToCopy, FS_ZIP_COMPRESS_CHUNK_SIZE_IN_BYTES - (pZip->batchInputSize - pZip->batchChunkOffset));
 
-    /* Now we can move to the file path, again making sure we have enough room for the file path. */
-    if (offset + 46 + length > pZip->centralDirectorySize) {
-        return NULL;    /* Looks like an invalid central directory. */
+        FS_ZIP_COPY_MEMORY(pZip->pBatchInput + pZip->batchInputSize, pData, bytesToCopy);
+        pZip->batchInputSize += bytesToCopy;
+        pData     = FS_ZIP_OFFSET_PTR(pData, bytesToCopy);
+        dataSize -= bytesToCopy;
+
+        if (pZip->batchInputSize - pZip->batchChunkOffset == FS_ZIP_COMPRESS_CHUNK_SIZE_IN_BYTES) {
+            fs_zip_writer_add_chunk(pZip, pEntry, FS_FALSE, pAllocationCallbacks);
+        }
     }
 
-    /* We now how enough information to get the file path. */
-    *pLength = length;
-    return pCentralDirectoryRecord + 46;
+    return pZip->writeResult;
 }
 
-static fs_result fs_zip_find_file_by_path(fs_zip* pZip, const fs_allocation_callbacks* pAllocationCallbacks, const char* pFilePath, size_t filePathLen, size_t* pFileIndex)
+static fs_result fs_zip_writer_write_central_directory(fs_zip* pZip, fs_stream* pStream, size_t entryCount)
 {
     fs_result result;
-    fs_path_iterator pathIterator;
-    fs_zip_cd_node* pCurrentNode;
-    char  pFilePathCleanStack[1024];
-    char* pFilePathCleanHeap = NULL;
-    char* pFilePathClean;
-    int filePathCleanLen;
+    fs_uint64 cdOffset;
+    fs_uint64 cdSize;
+    fs_uint8 record[56];
+    size_t iEntry;
+
+    cdOffset = pZip->writeCursor;
+
+    for (iEntry = 0; iEntry < entryCount; iEntry += 1) {
+        const fs_zip_write_entry* pEntry = pZip->ppWriteEntries[iEntry];
+        size_t pathLen = pEntry->pathLen + (pEntry->directory ? 1 : 0);
+        fs_uint8 extra[28];
+        size_t extraSize = 0;
+
+        /* Anything that doesn't fit in 32 bits, or is exactly 0xFFFFFFFF, goes into the ZIP64 extra field, in this specific order. */
+        if (pEntry->uncompressedSize >= 0xFFFFFFFF || pEntry->compressedSize >= 0xFFFFFFFF || pEntry->localHeaderOffset >= 0xFFFFFFFF) {
+            extraSize = 4;
+
+            if (pEntry->uncompressedSize >= 0xFFFFFFFF) {
+                fs_zip_write_le64(extra + extraSize, pEntry->uncompressedSize);
+                extraSize += 8;
+            }
 
-    FS_ZIP_ASSERT(pZip       != NULL);
-    FS_ZIP_ASSERT(pFilePath  != NULL);
-    FS_ZIP_ASSERT(pFileIndex != NULL);
+            if (pEntry->compressedSize >= 0xFFFFFFFF) {
+                fs_zip_write_le64(extra + extraSize, pEntry->compressedSize);
+                extraSize += 8;
+            }
 
-    if (filePathLen == 0) {
-        return FS_INVALID_ARGS; /* The path is empty. */
-    }
+            if (pEntry->localHeaderOffset >= 0xFFFFFFFF) {
+                fs_zip_write_le64(extra + extraSize, pEntry->localHeaderOffset);
+                extraSize += 8;
+            }
 
-    /* Skip past the root item if any. */
-    if (pFilePath[0] == '/' || pFilePath[0] == '\\') {
-        pFilePath += 1;
-        if (filePathLen > 0 && filePathLen != FS_NULL_TERMINATED) {
-            filePathLen -= 1;
+            fs_zip_write_le16(extra + 0, 0x0001);
+            fs_zip_write_le16(extra + 2, (fs_uint16)(extraSize - 4));
         }
-    }
-
-    /* The path must be clean of any special directories. We'll have to clean the path with fs_path_normalize(). */
-    filePathCleanLen = fs_path_normalize(pFilePathCleanStack, sizeof(pFilePathCleanStack), pFilePath, filePathLen, FS_NO_ABOVE_ROOT_NAVIGATION);
-    if (filePathCleanLen < 0) {
-        return FS_DOES_NOT_EXIST;
-    }
 
-    if (filePathCleanLen > (int)sizeof(pFilePathCleanStack)) {
-        pFilePathCleanHeap = (char*)fs_malloc(filePathCleanLen + 1, pAllocationCallbacks);
-        if (pFilePathCleanHeap == NULL) {
-            return FS_OUT_OF_MEMORY;
+        fs_zip_write_le32(record +  0, FS_ZIP_CD_FILE_HEADER_SIGNATURE);
+        fs_zip_write_le16(record +  4, FS_ZIP_VERSION_ZIP64);  /* Version made by. */
+        fs_zip_write_le16(record +  6, (extraSize > 0) ? FS_ZIP_VERSION_ZIP64 : FS_ZIP_VERSION_DEFAULT);
+        fs_zip_write_le16(record +  8, (fs_uint16)(FS_ZIP_FLAG_UTF8 | (pEntry->directory ? 0 : FS_ZIP_FLAG_DATA_DESCRIPTOR)));
+        fs_zip_write_le16(record + 10, pEntry->compressionMethod);
+        fs_zip_write_le16(record + 12, pZip->writeDosTime);
+        fs_zip_write_le16(record + 14, pZip->writeDosDate);
+        fs_zip_write_le32(record + 16, pEntry->crc32);
+        fs_zip_write_le32(record + 20, (pEntry->compressedSize   >= 0xFFFFFFFF) ? 0xFFFFFFFF : (fs_uint32)pEntry->compressedSize);
+        fs_zip_write_le32(record + 24, (pEntry->uncompressedSize >= 0xFFFFFFFF) ? 0xFFFFFFFF : (fs_uint32)pEntry->uncompressedSize);
+        fs_zip_write_le16(record + 28, (fs_uint16)pathLen);
+        fs_zip_write_le16(record + 30, (fs_uint16)extraSize);
+        fs_zip_write_le16(record + 32, 0);  /* Comment length. */
+        fs_zip_write_le16(record + 34, 0);  /* Disk number. */
+        fs_zip_write_le16(record + 36, 0);  /* Internal attributes. */
+        fs_zip_write_le32(record + 38, pEntry->directory ? 0x10 : 0);   /* External attributes. 0x10 is the MS-DOS directory attribute. */
+        fs_zip_write_le32(record + 42, (pEntry->localHeaderOffset >= 0xFFFFFFFF) ? 0xFFFFFFFF : (fs_uint32)pEntry->localHeaderOffset);
+
+        result = fs_zip_writer_write(pZip, pStream, record, 46);
+        if (result == FS_SUCCESS) {
+            result = fs_zip_writer_write(pZip, pStream, pEntry->pPath, pathLen);
+        }
+        if (result == FS_SUCCESS && extraSize > 0) {
+            result = fs_zip_writer_write(pZip, pStream, extra, extraSize);
         }
 
-        fs_path_normalize(pFilePathCleanHeap, filePathCleanLen + 1, pFilePath, filePathLen, FS_NO_ABOVE_ROOT_NAVIGATION); /* <-- This should never fail. */
-        pFilePathClean = pFilePathCleanHeap;
-    } else {
-        pFilePathClean = pFilePathCleanStack;
-    }
-
-    /* Start at the root node. */
-    pCurrentNode = pZip->pCDRootNode;
-
-    result = fs_result_from_errno(fs_path_first(pFilePathClean, (size_t)filePathCleanLen, &pathIterator));
-    if (result == FS_SUCCESS) {
-        /* Reset the error code for safety. The loop below will be setting it to a proper value. */
-        for (;;) {
-            fs_zip_cd_node* pChildNode;
-            
-            pChildNode = fs_zip_cd_node_find_child(pCurrentNode, pathIterator.pFullPath + pathIterator.segmentOffset, pathIterator.segmentLength);
-            if (pChildNode == NULL) {
-                result = FS_DOES_NOT_EXIST;
-                break;
-            }
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+    }
 
-            pCurrentNode = pChildNode;
+    cdSize = pZip->writeCursor - cdOffset;
 
-            result = fs_result_from_errno(fs_path_next(&pathIterator));
-            if (result != FS_SUCCESS) {
-                /* We've reached the end. The file we're on must be the file index. */
-                *pFileIndex = pCurrentNode->iFile;
+    /*
+    The ZIP64 end of central directory record and its locator are only needed if something doesn't fit
+    in the regular record. The maximum value of each field is reserved to mean that the real value is in
+    the ZIP64 record, so anything equal to it needs the ZIP64 record as well.
+    */
+    if (entryCount >= 0xFFFF || cdSize >= 0xFFFFFFFF || cdOffset >= 0xFFFFFFFF) {
+        fs_uint64 eocd64Offset = pZip->writeCursor;
+
+        fs_zip_write_le32(record +  0, FS_ZIP_EOCD64_SIGNATURE);
+        fs_zip_write_le64(record +  4, 44);     /* Size of the remaining record. */
+        fs_zip_write_le16(record + 12, FS_ZIP_VERSION_ZIP64);
+        fs_zip_write_le16(record + 14, FS_ZIP_VERSION_ZIP64);
+        fs_zip_write_le32(record + 16, 0);      /* This disk. */
+        fs_zip_write_le32(record + 20, 0);      /* The disk with the central directory. */
+        fs_zip_write_le64(record + 24, entryCount);
+        fs_zip_write_le64(record + 32, entryCount);
+        fs_zip_write_le64(record + 40, cdSize);
+        fs_zip_write_le64(record + 48, cdOffset);
+
+        result = fs_zip_writer_write(pZip, pStream, record, 56);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
 
-                result = FS_SUCCESS;
-                break;
-            }
+        fs_zip_write_le32(record +  0, FS_ZIP_EOCD64_LOCATOR_SIGNATURE);
+        fs_zip_write_le32(record +  4, 0);      /* The disk with the ZIP64 end of central directory record. */
+        fs_zip_write_le64(record +  8, eocd64Offset);
+        fs_zip_write_le32(record + 16, 1);      /* Total number of disks. */
+
+        result = fs_zip_writer_write(pZip, pStream, record, 20);
+        if (result != FS_SUCCESS) {
+            return result;
         }
-    } else {
-        result = FS_DOES_NOT_EXIST;
     }
 
-    fs_free(pFilePathCleanHeap, pAllocationCallbacks);
-    return result;
+    fs_zip_write_le32(record +  0, FS_ZIP_EOCD_SIGNATURE);
+    fs_zip_write_le16(record +  4, 0);  /* This disk. */
+    fs_zip_write_le16(record +  6, 0);  /* The disk with the central directory. */
+    fs_zip_write_le16(record +  8, (entryCount >= 0xFFFF) ? 0xFFFF : (fs_uint16)entryCount);
+    fs_zip_write_le16(record + 10, (entryCount >= 0xFFFF) ? 0xFFFF : (fs_uint16)entryCount);
+    fs_zip_write_le32(record + 12, (cdSize   >= 0xFFFFFFFF) ? 0xFFFFFFFF : (fs_uint32)cdSize);
+    fs_zip_write_le32(record + 16, (cdOffset >= 0xFFFFFFFF) ? 0xFFFFFFFF : (fs_uint32)cdOffset);
+    fs_zip_write_le16(record + 20, 0);  /* Comment length. */
+
+    return fs_zip_writer_write(pZip, pStream, record, 22);
 }
 
-static fs_result fs_zip_get_file_info_by_path(fs_zip* pZip, const fs_allocation_callbacks* pAllocationCallbacks, const char* pFilePath, size_t filePathLen, fs_zip_file_info* pInfo)
+static void fs_zip_writer_uninit(fs* pFS, fs_zip* pZip)
 {
-    fs_result result;
-    size_t iFile;
+    size_t entryCount;
+    size_t iEntry;
 
-    FS_ZIP_ASSERT(pZip      != NULL);
-    FS_ZIP_ASSERT(pFilePath != NULL);
-    FS_ZIP_ASSERT(pInfo     != NULL);
+    /*
+    If a file is still being written its entry will be the last one. Its sizes aren't known so it's left
+    out of the central directory. There's no way to report an error from here so if the central directory
+    fails to be written the archive will just be corrupt.
+    */
+    entryCount = pZip->writeEntryCount;
+    if (pZip->isWritingFile) {
+        entryCount -= 1;
+    }
 
-    result = fs_zip_find_file_by_path(pZip, pAllocationCallbacks, pFilePath, filePathLen, &iFile);
-    if (result != FS_SUCCESS) {
-        return result;  /* Most likely the file could not be found. */
+    if (pZip->batchItemCount > 0) {
+        fs_zip_writer_run_batch(pZip, fs_get_stream(pFS), fs_get_allocation_callbacks(pFS));
     }
 
-    return fs_zip_get_file_info_by_record_offset(pZip, pZip->pIndex[iFile].offsetInBytes, pInfo);
+    fs_zip_writer_write_central_directory(pZip, fs_get_stream(pFS), entryCount);
+
+    for (iEntry = 0; iEntry < pZip->writeEntryCount; iEntry += 1) {
+        fs_free(pZip->ppWriteEntries[iEntry], fs_get_allocation_callbacks(pFS));
+    }
+
+    fs_free(pZip->ppWriteEntries, fs_get_allocation_callbacks(pFS));
+    fs_free(pZip->pWriteEntryTable, fs_get_allocation_callbacks(pFS));
+    fs_free(pZip->pCompressors, fs_get_allocation_callbacks(pFS));
+    fs_free(pZip->pBatchInput, fs_get_allocation_callbacks(pFS));
+    fs_free(pZip->pBatchOutput, fs_get_allocation_callbacks(pFS));
+    fs_free(pZip->pBatchChunks, fs_get_allocation_callbacks(pFS));
+    fs_free(pZip->pBatchItems, fs_get_allocation_callbacks(pFS));
 }
 
-static int fs_zip_qsort_compare(void* pUserData, const void* a, const void* b)
+/*
+Cleans a path of an archive that's being written. The result has no leading slash and no trailing slash.
+The returned path will be either pPathCleanStack or a heap allocation which needs to be freed by the caller
+with fs_free().
+*/
+static fs_result fs_zip_writer_clean_path(const char* pPath, char* pPathCleanStack, size_t pathCleanStackCap, const fs_allocation_callbacks* pAllocationCallbacks, char** ppPathClean, size_t* pPathCleanLen)
 {
-    fs_zip* pZip = (fs_zip*)pUserData;
-    const fs_zip_index* pZipIndex0 = (const fs_zip_index*)a;
-    const fs_zip_index* pZipIndex1 = (const fs_zip_index*)b;
-    size_t fileNameLen0;
-    const char* pFileName0;
-    size_t fileNameLen1;
-    const char* pFileName1;
-    int compareResult;
+    int pathCleanLen;
 
-    FS_ZIP_ASSERT(pZip != NULL);
+    /* Skip past the root item if any. */
+    if (pPath[0] == '/' || pPath[0] == '\\') {
+        pPath += 1;
+    }
 
-    pFileName0 = fs_zip_get_file_path_by_record_offset(pZip, pZipIndex0->offsetInBytes, &fileNameLen0);
-    if (pFileName0 == NULL) {
-        pFileName0 = "";    /* File couldn't be found. Just treat it as an empty string. */
+    pathCleanLen = fs_path_normalize(pPathCleanStack, pathCleanStackCap, pPath, FS_NULL_TERMINATED, FS_NO_ABOVE_ROOT_NAVIGATION);
+    if (pathCleanLen < 0) {
+        return FS_INVALID_ARGS;
     }
 
-    pFileName1 = fs_zip_get_file_path_by_record_offset(pZip, pZipIndex1->offsetInBytes, &fileNameLen1);
-    if (pFileName1 == NULL) {
-        pFileName1 = "";    /* File couldn't be found. Just treat it as an empty string. */
+    /* Zip stores the length of the path in 16 bits, with room for the trailing slash of directories. */
+    if (pathCleanLen >= 0xFFFF) {
+        return FS_PATH_TOO_LONG;
     }
 
-    compareResult = strncmp(pFileName0, pFileName1, FS_ZIP_MIN(fileNameLen0, fileNameLen1));
-    if (compareResult == 0 && fileNameLen0 != fileNameLen1) {
-        /* The strings are the same up to the length of the shorter string. The shorter string is considered to be less than the longer string. */
-        compareResult = (fileNameLen0 < fileNameLen1) ? -1 : 1;
+    if (pathCleanLen >= (int)pathCleanStackCap) {
+        *ppPathClean = (char*)fs_malloc(pathCleanLen + 1, pAllocationCallbacks);
+        if (*ppPathClean == NULL) {
+            return FS_OUT_OF_MEMORY;
+        }
+
+        fs_path_normalize(*ppPathClean, pathCleanLen + 1, pPath, FS_NULL_TERMINATED, FS_NO_ABOVE_ROOT_NAVIGATION); /* <-- This should never fail. */
+    } else {
+        *ppPathClean = pPathCleanStack;
     }
 
-    return compareResult;
+    *pPathCleanLen = (size_t)pathCleanLen;
+    return FS_SUCCESS;
 }
 
-static void fs_zip_cd_node_build(fs_zip* pZip, fs_zip_cd_node** ppRunningChildrenPointer, fs_zip_cd_node* pNode)
+static fs_result fs_zip_writer_mkdir(fs* pFS, fs_zip* pZip, const char* pPath)
 {
-    size_t iFile;
-    size_t iChild;
-
-    FS_ZIP_ASSERT(pZip  != NULL);
-    FS_ZIP_ASSERT(pNode != NULL);
-    FS_ZIP_ASSERT(pNode->_descendantRangeEnd <= pZip->fileCount);
-    FS_ZIP_ASSERT(ppRunningChildrenPointer != NULL);
+    fs_result result;
+    char  pPathCleanStack[1024];
+    char* pPathClean;
+    size_t pathCleanLen;
+    size_t parentPathLen;
+    fs_zip_write_entry* pEntry;
 
-    pNode->childCount = 0;
-    pNode->pChildren  = *ppRunningChildrenPointer;
+    result = fs_zip_writer_clean_path(pPath, pPathCleanStack, sizeof(pPathCleanStack), fs_get_allocation_callbacks(pFS), &pPathClean, &pathCleanLen);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
 
-    /*
-    We need to loop through our file range and add any direct children first. Then once that's
-    done, we iterate over each child node and fill them out recursively.
-    */
-    for (iFile = pNode->_descendantRangeBeg; iFile < pNode->_descendantRangeEnd; iFile += 1) {
-        const char* pFullFilePath;
-        size_t fullFilePathLen;
-        const char* pShortFilePath;
-        size_t shortFilePathLen;
-        fs_path_iterator shortFilePathIterator;
+    /* The parent directory needs to exist so the core library knows to create each level. */
+    parentPathLen = pathCleanLen;
+    while (parentPathLen > 0 && pPathClean[parentPathLen - 1] != '/') {
+        parentPathLen -= 1;
+    }
 
-        pFullFilePath = fs_zip_get_file_path_by_record_offset(pZip, pZip->pIndex[iFile].offsetInBytes, &fullFilePathLen);
-        if (pFullFilePath == NULL) {
-            continue;   /* Should never happen. Just ignore the file if we couldn't find it by the given offset. */
-        }
+    if (parentPathLen > 0) {
+        parentPathLen -= 1;    /* Exclude the separator. */
+    }
 
-        /* If the full file path length is equal to the descendant prefix length, it means it's a leaf node. */
-        FS_ZIP_ASSERT(fullFilePathLen >= pNode->_descendantPrefixLen);
-        if (fullFilePathLen == pNode->_descendantPrefixLen) {
-            continue;
+    if (pathCleanLen == 0 || fs_zip_writer_find_entry(pZip, pPathClean, pathCleanLen) != NULL) {
+        result = FS_ALREADY_EXISTS;
+    } else if (parentPathLen > 0 && fs_zip_writer_find_entry(pZip, pPathClean, parentPathLen) == NULL) {
+        result = FS_DOES_NOT_EXIST;
+    } else if (pZip->isWritingFile) {
+        result = FS_BUSY;   /* The directory would end up in the middle of the data of the file being written. */
+    } else {
+        result = fs_zip_writer_add_entry(pZip, pPathClean, pathCleanLen, FS_TRUE, FS_ZIP_COMPRESSION_METHOD_STORE, fs_get_allocation_callbacks(pFS), &pEntry);
+        if (result == FS_SUCCESS) {
+            result = fs_zip_writer_begin_entry(pZip, fs_get_stream(pFS), pEntry, fs_get_allocation_callbacks(pFS));
         }
+    }
 
-        /* The short file path is simply the full file path without the descendant prefix. */
-        pShortFilePath   = pFullFilePath   + pNode->_descendantPrefixLen;
-        shortFilePathLen = fullFilePathLen - pNode->_descendantPrefixLen;
+    if (pPathClean != pPathCleanStack) {
+        fs_free(pPathClean, fs_get_allocation_callbacks(pFS));
+    }
 
-        /* Make sure we're not sitting on a path separator. */
-        if (pShortFilePath[0] == '\\' || pShortFilePath[0] == '/') {
-            pShortFilePath   += 1;
-            shortFilePathLen -= 1;
-        }
+    return result;
+}
 
-        /*
-        Now we need to check if we need to add a child. Because this main file listing is sorted,
-        we need only check the last child item. If it's not equal, we have a new child item.
-        */
-        if (fs_path_first(pShortFilePath, shortFilePathLen, &shortFilePathIterator) == FS_SUCCESS) {
-            if (pNode->childCount == 0 || pNode->pChildren[pNode->childCount-1].nameLen != shortFilePathIterator.segmentLength || strncmp(pNode->pChildren[pNode->childCount-1].pName, shortFilePathIterator.pFullPath + shortFilePathIterator.segmentOffset, FS_ZIP_MIN(pNode->pChildren[pNode->childCount-1].nameLen, shortFilePathIterator.segmentLength)) != 0) {
-                /* Child doesn't exist. Need to add it to the list. */
-                pNode->pChildren[pNode->childCount].iFile                = iFile;
-                pNode->pChildren[pNode->childCount].pName                = shortFilePathIterator.pFullPath + shortFilePathIterator.segmentOffset;
-                pNode->pChildren[pNode->childCount].nameLen              = shortFilePathIterator.segmentLength;
-                pNode->pChildren[pNode->childCount]._descendantRangeBeg  = iFile;
-                pNode->pChildren[pNode->childCount]._descendantRangeEnd  = pNode->_descendantRangeEnd;
-                pNode->pChildren[pNode->childCount]._descendantPrefixLen = (fullFilePathLen - shortFilePathLen) + shortFilePathIterator.segmentLength;
+static fs_result fs_zip_writer_info(fs* pFS, fs_zip* pZip, const char* pPath, fs_file_info* pInfo)
+{
+    fs_result result;
+    char  pPathCleanStack[1024];
+    char* pPathClean;
+    size_t pathCleanLen;
+    fs_zip_write_entry* pEntry;
 
-                /* Update the end range for the previous child if we have one. */
-                if (pNode->childCount > 0) {
-                    pNode->pChildren[pNode->childCount-1]._descendantRangeEnd = iFile;
-                }
+    result = fs_zip_writer_clean_path(pPath, pPathCleanStack, sizeof(pPathCleanStack), fs_get_allocation_callbacks(pFS), &pPathClean, &pathCleanLen);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
 
-                pNode->childCount         += 1;
-                *ppRunningChildrenPointer += 1;
-            }
+    if (pathCleanLen == 0) {
+        pInfo->size      = 0;
+        pInfo->directory = FS_TRUE;    /* The root directory. */
+    } else {
+        pEntry = fs_zip_writer_find_entry(pZip, pPathClean, pathCleanLen);
+        if (pEntry != NULL) {
+            pInfo->size      = pEntry->uncompressedSize;
+            pInfo->directory = pEntry->directory;
         } else {
-            /*
-            Couldn't get the first segment. This probably means we found an explicit directory
-            listing. We just ignore it.
-            */
-            if (pNode->childCount > 0) {
-                pNode->pChildren[pNode->childCount-1]._descendantRangeEnd = iFile;
-            }
+            result = FS_DOES_NOT_EXIST;
         }
     }
 
-    /* We've initialized each of the child nodes. We now need to recursively process them. */
-    for (iChild = 0; iChild < pNode->childCount; iChild += 1) {
-        fs_zip_cd_node_build(pZip, ppRunningChildrenPointer, &pNode->pChildren[iChild]);
+    if (pPathClean != pPathCleanStack) {
+        fs_free(pPathClean, fs_get_allocation_callbacks(pFS));
     }
-}
 
+    return result;
+}
 
 static fs_result fs_init_zip(fs* pFS, const void* pBackendConfig, fs_stream* pStream)
 {
@@ -1260,9 +4933,41 @@ static fs_result fs_init_zip(fs* pFS, const void* pBackendConfig, fs_stream* pSt
     fs_uint64 cdSizeInBytes64;
     fs_uint32 cdOffset32;
     fs_uint64 cdOffset64;
-
-    /* No need for a backend config. Maybe use this later for passwords if we ever add support for that? */
-    (void)pBackendConfig;
+    int threadCount = 1;
+    fs_bool32 usePathHashTable = FS_FALSE;
+    size_t seekPointInterval = 0;
+    fs_bool32 verifyChecksums = FS_FALSE;
+    size_t uncompressedCacheSize = 0;
+    size_t compressedCacheSize = 0;
+    fs_bool32 adaptiveReadSize = FS_FALSE;
+    fs_bool32 write = FS_FALSE;
+    int compressionLevel = 0;
+    fs* pIndexFS = NULL;
+    const char* pIndexFilePath = NULL;
+    fs_zip_index_file_key indexFileKey;
+    fs_bool32 isIndexLoaded = FS_FALSE;
+
+    FS_ZIP_ZERO_OBJECT(&indexFileKey);
+
+    if (pBackendConfig != NULL) {
+        const fs_zip_config* pZipConfig = (const fs_zip_config*)pBackendConfig;
+
+        threadCount       = pZipConfig->threadCount;
+        usePathHashTable  = pZipConfig->usePathHashTable;
+        seekPointInterval = pZipConfig->seekPointInterval;
+        verifyChecksums   = pZipConfig->verifyChecksums;
+        uncompressedCacheSize = pZipConfig->uncompressedCacheSize;
+        compressedCacheSize   = pZipConfig->compressedCacheSize;
+        adaptiveReadSize      = pZipConfig->adaptiveReadSize;
+        write                 = pZipConfig->write;
+        compressionLevel      = pZipConfig->compressionLevel;
+        pIndexFS          = pZipConfig->pIndexFS;
+        pIndexFilePath    = pZipConfig->pIndexFilePath;
+
+        indexFileKey.archiveModifiedTime = pZipConfig->archiveModifiedTime;
+    } else {
+        indexFileKey.archiveModifiedTime = 0;
+    }
 
     if (pStream == NULL) {
         return FS_INVALID_OPERATION;    /* Most likely the FS is being opened without a stream. */
@@ -1270,6 +4975,56 @@ static fs_result fs_init_zip(fs* pFS, const void* pBackendConfig, fs_stream* pSt
     
     pZip = (fs_zip*)fs_get_backend_data(pFS);
     FS_ZIP_ASSERT(pZip != NULL);
+
+    /*
+    When writing, there's nothing to load. The archive is written from wherever the stream currently is.
+    The cache sizes still need to be set since they determine the size of each file's write buffer.
+    */
+    if (write) {
+        pZip->isWriting             = FS_TRUE;
+        pZip->writeCursor           = 0;
+        pZip->writeResult           = FS_SUCCESS;
+        pZip->crc32Proc             = fs_zip_crc32;
+        pZip->uncompressedCacheSize = 0;
+        pZip->compressedCacheSize   = (compressedCacheSize > 0) ? compressedCacheSize : FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES;
+
+        #if defined(FS_ZIP_SUPPORTS_PCLMUL)
+        {
+            if (fs_zip_has_pclmul()) {
+                pZip->crc32Proc = fs_zip_crc32_pclmul;
+            }
+        }
+        #endif
+
+        /* With no modified time we use the earliest DOS time so the output is the same every time. */
+        fs_zip_dos_date_time_from_unix_time(indexFileKey.archiveModifiedTime, &pZip->writeDosTime, &pZip->writeDosDate);
+
+        /*
+        When compressing, each thread needs its own compressor. The batch has room for a chunk for each
+        thread, plus the window of the previous batch which is used as the dictionary of the first chunk.
+        */
+        if (compressionLevel > 0) {
+            size_t iCompressor;
+
+            pZip->compressionLevel    = FS_ZIP_MIN(compressionLevel, (int)FS_ZIP_DEFLATE_MAX_LEVEL);
+            pZip->compressThreadCount = (size_t)FS_ZIP_MIN(FS_ZIP_MAX(threadCount, 1), FS_ZIP_MAX_THREAD_COUNT);
+            pZip->batchInputCap       = FS_ZIP_DEFLATE_WINDOW_SIZE + (FS_ZIP_COMPRESS_CHUNK_SIZE_IN_BYTES * pZip->compressThreadCount);
+
+            pZip->pCompressors = (fs_zip_deflate_compressor*)fs_malloc(sizeof(*pZip->pCompressors) * pZip->compressThreadCount, fs_get_allocation_callbacks(pFS));
+            pZip->pBatchInput  = (fs_uint8*)fs_malloc(pZip->batchInputCap, fs_get_allocation_callbacks(pFS));
+            if (pZip->pCompressors == NULL || pZip->pBatchInput == NULL) {
+                fs_free(pZip->pCompressors, fs_get_allocation_callbacks(pFS));
+                fs_free(pZip->pBatchInput, fs_get_allocation_callbacks(pFS));
+                return FS_OUT_OF_MEMORY;
+            }
+
+            for (iCompressor = 0; iCompressor < pZip->compressThreadCount; iCompressor += 1) {
+                fs_zip_deflate_compressor_init(&pZip->pCompressors[iCompressor]);
+            }
+        }
+
+        return FS_SUCCESS;
+    }
     
     /*
     The correct way to load a Zip file is to read from the central directory. The end of the
@@ -1524,6 +5279,25 @@ static fs_result fs_init_zip(fs* pFS, const void* pBackendConfig, fs_stream* pSt
         cdOffset64 = cdOffset32;
     }
 
+    /* The index file needs to know the size of the archive so it can tell if it's out of date. */
+    if (pIndexFilePath != NULL) {
+        fs_int64 archiveSize;
+
+        result = fs_stream_seek(pStream, 0, FS_SEEK_END);
+        if (result == FS_SUCCESS) {
+            result = fs_stream_tell(pStream, &archiveSize);
+        }
+
+        if (result != FS_SUCCESS) {
+            return FS_INVALID_FILE;
+        }
+
+        indexFileKey.archiveSize            = (fs_uint64)archiveSize;
+        indexFileKey.centralDirectoryOffset = cdOffset64;
+        indexFileKey.centralDirectorySize   = cdSizeInBytes64;
+        indexFileKey.fileCount              = pZip->fileCount;
+    }
+
     /* We need to seek to the start of the central directory and read it's contents. */
     result = fs_stream_seek(pStream, cdOffset64, FS_SEEK_SET);
     if (result != FS_SUCCESS) {
@@ -1559,233 +5333,93 @@ static fs_result fs_init_zip(fs* pFS, const void* pBackendConfig, fs_stream* pSt
         return FS_INVALID_FILE;
     }
 
-    /* Build the index. It needs to be sorted by name. We'll treat this as case-sensitive. */
-    {
-        fs_memory_stream cdStream;
-        size_t iFile;
-        size_t nodeUpperBoundCount;
+    /*
+    Build the index. If we've been given an index file we'll try loading that first, and if it's not
+    there or doesn't match the archive we build the index as normal and write out a new index file.
+    Failing to write the index file is not an error.
+    */
+    if (pIndexFilePath != NULL) {
+        indexFileKey.centralDirectoryCRC = fs_zip_crc32(0, pZip->pCentralDirectory, pZip->centralDirectorySize);
+        isIndexLoaded = (fs_zip_load_index_file(pZip, pIndexFS, pIndexFilePath, &indexFileKey, fs_get_allocation_callbacks(pFS)) == FS_SUCCESS);
+    }
 
-        result = fs_memory_stream_init_readonly(pZip->pCentralDirectory, pZip->centralDirectorySize, &cdStream);
+    if (!isIndexLoaded) {
+        result = fs_zip_build_index(pZip, threadCount, fs_get_allocation_callbacks(pFS));
         if (result != FS_SUCCESS) {
             fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
             return result;
         }
 
-        for (iFile = 0; iFile < pZip->fileCount; iFile += 1) {
-            size_t fileOffset;
-            fs_uint16 fileNameLen;
-            fs_uint16 extraLen;
-            fs_uint16 commentLen;
-
-            result = fs_memory_stream_tell(&cdStream, &fileOffset);
-            if (result != FS_SUCCESS) {
-                fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
-                return result;
-            }
-
-            pZip->pIndex[iFile].offsetInBytes = fileOffset;
-
-
-            /*
-            We need to seek to the next item. To do this we need to retrieve the lengths of the
-            variable-length fields. These start from offset 28.
-            */
-            result = fs_memory_stream_seek(&cdStream, 28, FS_SEEK_CUR);
-            if (result != FS_SUCCESS) {
-                fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
-                return result;
-            }
-
-            result = fs_memory_stream_read(&cdStream, &fileNameLen, 2, NULL);
-            if (result != FS_SUCCESS) {
-                fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
-                return result;
-            }
-
-            result = fs_memory_stream_read(&cdStream, &extraLen, 2, NULL);
-            if (result != FS_SUCCESS) {
-                fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
-                return result;
-            }
-
-            result = fs_memory_stream_read(&cdStream, &commentLen, 2, NULL);
-            if (result != FS_SUCCESS) {
-                fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
-                return result;
-            }
-
-            /* We have the necessary information we need to move past this record. */
-            result = fs_memory_stream_seek(&cdStream, fileOffset + 46 + fileNameLen + extraLen + commentLen, FS_SEEK_SET);
-            if (result != FS_SUCCESS) {
-                fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
-                return result;
-            }
-        }
-
-        /*
-        TODO: Look at some real-world Zip archives from various archivers (7zip, Windows, etc.) and
-        check how the sorting looks before our explicit sort. If most real-world archives are already
-        mostly sorted, it might be more efficient to just do a simple insertion sort.
-        */
-        fs_sort(pZip->pIndex, pZip->fileCount, sizeof(fs_zip_index), fs_zip_qsort_compare, pZip);
-
-        /* Testing. */
-        #if 0
-        {
-            size_t i;
-            for (i = 0; i < pZip->fileCount; i += 1) {
-                size_t nameLen;
-                const char* pName = fs_zip_get_file_path_by_record_offset(pZip, pZip->pIndex[i].offsetInBytes, &nameLen);
-
-                printf("File name = %.*s\n", (int)nameLen, pName);
-            }
+        if (pIndexFilePath != NULL) {
+            fs_zip_save_index_file(pZip, pIndexFS, pIndexFilePath, &indexFileKey, fs_get_allocation_callbacks(pFS));
         }
-        #endif
-
-        /*
-        We're going to build an accelerated data structure for the central directory. Nothing over
-        the top - just a simple tree based on directory names.
-
-        It's just a graph. Each node in the graph is either a directory or a file. Leaf nodes can
-        possibly be files or an empty directory which means a flag is required to indicate whether
-        or not the node is a directory. Sub-folders and files are just child nodes. Children are
-        sorted by name to allow for fast lookups.
-
-        The items in the central directory has already been sorted thanks to the index that we
-        constructed above. If we just iterate linearly based on that index everything should be
-        sorted naturally.
-
-        The graph is constructed in two passes. The first pass simply counts the number of nodes so
-        we can allocate a single block of memory. The second pass fills the data.
-        */
-
-        /*
-        The first pass is just to count the number of nodes so we can allocate some memory in one
-        chunk. We start the count at one to accommodate for the root node. This pass is not
-        necessarily calculating an exact count, but instead it calculates an upper bound count. The
-        reason for this is how directories are handled. Sometimes they are listed explicitly, but I
-        have seen cases where they're not. If we could guarantee all folders were explicitly listed
-        we would be able to avoid this pass.
-
-        We can take advantage of the fact that the file listing has been sorted. For each entry we
-        just compare the path with the previous one, and for every segment in the new path that's
-        different we increment the counter (it should always be at least one since the file name
-        itself should always be different).
-        */
-        {
-            const char* pPrevPath;
-            size_t prevPathLen;
-            
-            /* Consider the root directory to be the previous path. */
-            pPrevPath = "";
-            prevPathLen = 0;
-
-            /* Start the count at 1 to account for the root node. */
-            nodeUpperBoundCount = 1;
-
-            for (iFile = 0; iFile < pZip->fileCount; iFile += 1) {
-                const char* pFilePath;
-                size_t filePathLen;
-
-                pFilePath = fs_zip_get_file_path_by_record_offset(pZip, pZip->pIndex[iFile].offsetInBytes, &filePathLen);
-                if (pFilePath == NULL) {
-                    continue;   /* Just skip the file if we can't get the name. Should never happen. */
-                }
-
-                /*
-                Now that we have the file path all we need to do is compare is to the previous path
-                and increment the counter for every segment in the current path that is different
-                to the previous path. We'll need to use a path iterator for each of these.
-                */
-                {
-                    fs_path_iterator nextIterator;
-                    fs_path_iterator prevIterator;
-
-                    fs_path_first(pFilePath, filePathLen, &nextIterator);   /* <-- This should never fail. */
-
-                    if (fs_path_first(pPrevPath, prevPathLen, &prevIterator) == FS_SUCCESS) {
-                        /*
-                        First just move the next iterator forward until we reach the end of the previous
-                        iterator, or if the segments differ between the two.
-                        */
-                        for (;;) {
-                            if (fs_path_iterators_compare(&nextIterator, &prevIterator) != 0) {
-                                break;  /* Iterators don't match. */
-                            }
-
-                            /* Getting here means the segments match. We need to move to the next one. */
-                            if (fs_path_next(&nextIterator) != FS_SUCCESS) {
-                                break;  /* We reached the end of the next iterator before the previous. The only difference will be the file name. */
-                            }
-
-                            if (fs_path_next(&prevIterator) != FS_SUCCESS) {
-                                break;  /* We reached the end of the prev iterator. Get out of the loop. */
-                            }
-                        }
-                    }
-
-                    /* Increment the counter to account for the segment that the next iterator is currently sitting on. */
-                    nodeUpperBoundCount += 1;
+    }
 
-                    /* Now we need to increment the counter for every new segment. */
-                    while (fs_path_next(&nextIterator) == FS_SUCCESS) {
-                        nodeUpperBoundCount += 1;
-                    }
-                }
+    /* The path hash table is optional so if we fail to build it we just fall back to the node graph. */
+    pZip->pPathHashHeap    = NULL;
+    pZip->pPathHashNodes   = NULL;
+    pZip->pPathHashTable   = NULL;
+    pZip->pathHashTableCap = 0;
+
+    if (usePathHashTable) {
+        if (fs_zip_build_path_hash_table(pZip, fs_get_allocation_callbacks(pFS)) != FS_SUCCESS) {
+            fs_free(pZip->pPathHashHeap, fs_get_allocation_callbacks(pFS));
+            pZip->pPathHashHeap  = NULL;
+            pZip->pPathHashNodes = NULL;
+            pZip->pPathHashTable = NULL;
+        }
+    }
 
-                /* Getting here means we're done with the count for this item. Move to the next one. */
-                pPrevPath = pFilePath;
-                prevPathLen = filePathLen;
-            }
+    /*
+    If the stream can give us a direct pointer to the archive data, stored files can be mapped without
+    copying. The archive isn't mapped until a stored file is actually mapped since most archives are
+    only ever read, and mapping a large archive up front isn't free. This is optional so failure to
+    create the lock is not an error.
+    */
+    pZip->pArchiveData                 = NULL;
+    pZip->archiveDataSize              = 0;
+    pZip->hasTriedMappingArchive       = FS_FALSE;
+    pZip->isArchiveDataLockInitialized = (fs_mtx_init(&pZip->archiveDataLock, fs_mtx_plain) == FS_SUCCESS);
+
+    /* Seek points are optional. If we can't create the lock we just run without them. */
+    pZip->seekPointInterval = 0;
+    pZip->pSeekIndexes      = NULL;
+
+    if (seekPointInterval > 0) {
+        if (fs_mtx_init(&pZip->seekIndexLock, fs_mtx_plain) == FS_SUCCESS) {
+            pZip->seekPointInterval = seekPointInterval;
         }
+    }
 
-        /*
-        Now that we've got the count we can go ahead and resize our heap allocation. It's important
-        to remember to update our pointers here.
-        */
-        {
-            void* pNewHeap = fs_realloc(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR) + (sizeof(*pZip->pIndex) * pZip->fileCount) + (sizeof(*pZip->pCDRootNode) * nodeUpperBoundCount), fs_get_allocation_callbacks(pFS));
-            if (pNewHeap == NULL) {
-                fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
-                return FS_OUT_OF_MEMORY;
-            }
+    pZip->verifyChecksums = verifyChecksums;
+    pZip->crc32Proc       = fs_zip_crc32;
 
-            pZip->pHeap = pNewHeap;
-            pZip->pCentralDirectory =                  FS_ZIP_OFFSET_PTR(pZip->pHeap, 0);
-            pZip->pIndex            = (fs_zip_index*  )FS_ZIP_OFFSET_PTR(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR));
-            pZip->pCDRootNode       = (fs_zip_cd_node*)FS_ZIP_OFFSET_PTR(pZip->pHeap, FS_ZIP_ALIGN(pZip->centralDirectorySize, FS_SIZEOF_PTR) + (sizeof(*pZip->pIndex) * pZip->fileCount));
+    /*
+    The uncompressed cache doubles as the window for DEFLATE64 which means it needs to be at least 64KB,
+    and the decompressor requires it to be a power of two when it's used as a ring buffer.
+    */
+    pZip->uncompressedCacheSize = 0;
+    if (uncompressedCacheSize > 0) {
+        pZip->uncompressedCacheSize = FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES;
+        while (pZip->uncompressedCacheSize < uncompressedCacheSize) {
+            pZip->uncompressedCacheSize *= 2;
         }
+    }
 
-        /*
-        Memory has been allocated so we can now fill it out. This is slightly tricky because we want
-        to do it in a single pass with a single memory allocation. Each node will hold a pointer to
-        an array which will contain their children. The size of this array is unknown at this point
-        so we need to come up with a system that allows us to fill each node in order.
-
-        Fortunately our file listing is sorted which gives us a good start. We want to fill out
-        higher level nodes first and then move down to leaf nodes. We're going to run through the
-        file listing in sorted order. For the current file path, we need to look at it's directory
-        structure. For each segment of the directory there will be a node. For each of these
-        segments we'll run an inner loop that adds child nodes for each file that shares the same
-        prefix.
-
-        To put simply, for each node, we need to attach all of it's children before the child nodes
-        themselves have been filled with their children. We can do this recursively. The first node
-        we're filling is the root node.
-        */
-        {
-            fs_zip_cd_node* pRunningChildrenPointer = &pZip->pCDRootNode[1];
+    pZip->compressedCacheSize = compressedCacheSize;
+    if (pZip->compressedCacheSize == 0) {
+        pZip->compressedCacheSize = FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES;
+    }
 
-            /* The root node needs to be set up first. */
-            pZip->pCDRootNode->pName                = "";
-            pZip->pCDRootNode->nameLen              = 0;
-            pZip->pCDRootNode->_descendantRangeBeg  = 0;
-            pZip->pCDRootNode->_descendantRangeEnd  = pZip->fileCount;
-            pZip->pCDRootNode->_descendantPrefixLen = 0;
+    pZip->adaptiveReadSize = adaptiveReadSize;
 
-            fs_zip_cd_node_build(pZip, &pRunningChildrenPointer, pZip->pCDRootNode);
+    #if defined(FS_ZIP_SUPPORTS_PCLMUL)
+    {
+        if (fs_zip_has_pclmul()) {
+            pZip->crc32Proc = fs_zip_crc32_pclmul;
         }
     }
+    #endif
 
     return FS_SUCCESS;
 }
@@ -1795,6 +5429,26 @@ static void fs_uninit_zip(fs* pFS)
     fs_zip* pZip = (fs_zip*)fs_get_backend_data(pFS);
     FS_ZIP_ASSERT(pZip != NULL);
 
+    if (pZip->isWriting) {
+        fs_zip_writer_uninit(pFS, pZip);
+        return;
+    }
+
+    if (pZip->seekPointInterval > 0) {
+        while (pZip->pSeekIndexes != NULL) {
+            fs_zip_seek_index* pNext = pZip->pSeekIndexes->pNext;
+            fs_zip_seek_index_free(pZip->pSeekIndexes, fs_get_allocation_callbacks(pFS));
+            pZip->pSeekIndexes = pNext;
+        }
+
+        fs_mtx_destroy(&pZip->seekIndexLock);
+    }
+
+    if (pZip->isArchiveDataLockInitialized) {
+        fs_mtx_destroy(&pZip->archiveDataLock);
+    }
+
+    fs_free(pZip->pPathHashHeap, fs_get_allocation_callbacks(pFS));
     fs_free(pZip->pHeap, fs_get_allocation_callbacks(pFS));
     return;
 }
@@ -1810,6 +5464,10 @@ static fs_result fs_info_zip(fs* pFS, const char* pPath, int openMode, fs_file_i
     pZip = (fs_zip*)fs_get_backend_data(pFS);
     FS_ZIP_ASSERT(pZip != NULL);
 
+    if (pZip->isWriting) {
+        return fs_zip_writer_info(pFS, pZip, pPath, pInfo);
+    }
+
     result = fs_zip_get_file_info_by_path(pZip, fs_get_allocation_callbacks(pFS), pPath, (size_t)-1, &info);
     if (result != FS_SUCCESS) {
         return result;  /* Probably not found. */
@@ -1821,6 +5479,21 @@ static fs_result fs_info_zip(fs* pFS, const char* pPath, int openMode, fs_file_i
     return FS_SUCCESS;
 }
 
+static fs_result fs_mkdir_zip(fs* pFS, const char* pPath)
+{
+    fs_zip* pZip;
+
+    pZip = (fs_zip*)fs_get_backend_data(pFS);
+    FS_ZIP_ASSERT(pZip != NULL);
+
+    /* Directories can only be added when writing an archive. */
+    if (!pZip->isWriting) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    return fs_zip_writer_mkdir(pFS, pZip, pPath);
+}
+
 
 typedef struct fs_iterator_zip
 {
@@ -1832,7 +5505,7 @@ typedef struct fs_iterator_zip
 
 typedef struct fs_file_zip
 {
-    fs_stream* pStream;                         /* Duplicated from the main file system stream. Freed with fs_stream_delete_duplicate(). */
+    fs_stream* pStream;                         /* Duplicated (or shared) from the main file system stream. Owned by the core library which frees it when the file is closed. */
     fs_zip_file_info info;
     fs_uint64 absoluteCursorUncompressed;
     fs_uint64 absoluteCursorCompressed;         /* The position of the cursor in the compressed data. */
@@ -1845,14 +5518,279 @@ typedef struct fs_file_zip
     size_t compressedCacheSize;                 /* The number of valid bytes in the compressed cache. Can be less than the capacity, but never more. Will be less when holding the tail end fo the file data. */
     size_t compressedCacheCursor;               /* The cursor within the compressed cache. The compressed cache size minus the cursor defines how much data remains in the compressed cache. */
     unsigned char* pCompressedCache;            /* Only used for compressed files. */
+    size_t compressedReadSize;                  /* The number of bytes to read from the archive when the compressed cache is refilled. Only less than the capacity in adaptive mode. */
+    fs_zip_seek_index* pSeekIndex;              /* Only used for compressed files when seek points are enabled. Owned by the file while it's open. */
+    fs_bool32 verifyChecksum;                   /* Whether or not the CRC-32 is checked when the end of the file is reached. */
+    fs_uint32 crc32;                            /* The running CRC-32 of the first crc32Cursor bytes of uncompressed data. */
+    fs_uint64 crc32Cursor;                      /* The number of bytes from the start of the file that have gone into crc32. */
+    fs_zip_write_entry* pWriteEntry;            /* Only used when writing. The uncompressed cache is used to buffer data before it goes to the stream. */
 } fs_file_zip;
 
+/*
+Takes ownership of the seek index for the given file, or allocates a new one if the file has not been
+opened before. This can return null if we run out of memory in which case seek points will not be used.
+*/
+static fs_zip_seek_index* fs_zip_seek_index_acquire(fs_zip* pZip, fs_uint64 localHeaderOffset, size_t windowSize, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_zip_seek_index* pSeekIndex = NULL;
+    fs_zip_seek_index** ppPrev;
+
+    FS_ZIP_ASSERT(pZip->seekPointInterval > 0);
+
+    fs_mtx_lock(&pZip->seekIndexLock);
+    {
+        for (ppPrev = &pZip->pSeekIndexes; *ppPrev != NULL; ppPrev = &(*ppPrev)->pNext) {
+            if ((*ppPrev)->localHeaderOffset == localHeaderOffset) {
+                pSeekIndex = *ppPrev;
+                *ppPrev = pSeekIndex->pNext;
+                break;
+            }
+        }
+    }
+    fs_mtx_unlock(&pZip->seekIndexLock);
+
+    if (pSeekIndex != NULL) {
+        pSeekIndex->pNext = NULL;
+        return pSeekIndex;
+    }
+
+    pSeekIndex = (fs_zip_seek_index*)fs_malloc(sizeof(*pSeekIndex), pAllocationCallbacks);
+    if (pSeekIndex == NULL) {
+        return NULL;
+    }
+
+    FS_ZIP_ZERO_OBJECT(pSeekIndex);
+    pSeekIndex->localHeaderOffset = localHeaderOffset;
+    pSeekIndex->windowSize        = windowSize;
+
+    return pSeekIndex;
+}
+
+/* Gives the seek index back to the fs_zip object so the next time the file is opened it can make use of it. */
+static void fs_zip_seek_index_release(fs_zip* pZip, fs_zip_seek_index* pSeekIndex, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_zip_seek_index** ppPrev;
+    fs_zip_seek_index* pDiscard = NULL;
+
+    if (pSeekIndex == NULL) {
+        return;
+    }
+
+    if (pSeekIndex->count == 0) {
+        fs_zip_seek_index_free(pSeekIndex, pAllocationCallbacks);
+        return;
+    }
+
+    fs_mtx_lock(&pZip->seekIndexLock);
+    {
+        /* If the same file was opened more than once there might already be an index for it. Keep the one with the most points. */
+        for (ppPrev = &pZip->pSeekIndexes; *ppPrev != NULL; ppPrev = &(*ppPrev)->pNext) {
+            if ((*ppPrev)->localHeaderOffset == pSeekIndex->localHeaderOffset) {
+                if ((*ppPrev)->count >= pSeekIndex->count) {
+                    pDiscard = pSeekIndex;
+                } else {
+                    pDiscard = *ppPrev;
+                    *ppPrev  = pDiscard->pNext;
+                }
+
+                break;
+            }
+        }
+
+        if (pDiscard != pSeekIndex) {
+            pSeekIndex->pNext  = pZip->pSeekIndexes;
+            pZip->pSeekIndexes = pSeekIndex;
+        }
+    }
+    fs_mtx_unlock(&pZip->seekIndexLock);
+
+    fs_zip_seek_index_free(pDiscard, pAllocationCallbacks);
+}
+
+static void fs_zip_seek_index_add_point(fs_zip* pZip, fs_file_zip* pZipFile, fs_uint64 uncompressedOffset, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_zip_seek_index* pSeekIndex = pZipFile->pSeekIndex;
+    fs_zip_seek_point* pSeekPoint;
+    fs_uint64 prevOffset;
+
+    FS_ZIP_ASSERT(pSeekIndex != NULL);
+
+    /* The uncompressed cache must be full, otherwise it won't contain the entire window. This will be the case for everything except the end of the file. */
+    if (pZipFile->uncompressedCacheSize != pZipFile->uncompressedCacheCap || pZipFile->uncompressedCacheCap != pSeekIndex->windowSize) {
+        return;
+    }
+
+    prevOffset = (pSeekIndex->count > 0) ? pSeekIndex->ppPoints[pSeekIndex->count - 1]->uncompressedOffset : 0;
+    if (uncompressedOffset < prevOffset + pZip->seekPointInterval) {
+        return; /* Too close to the previous point, or we've already been past this point. */
+    }
+
+    if (pSeekIndex->count == pSeekIndex->cap) {
+        size_t newCap = (pSeekIndex->cap == 0) ? 16 : pSeekIndex->cap * 2;
+        fs_zip_seek_point** ppNewPoints = (fs_zip_seek_point**)fs_realloc(pSeekIndex->ppPoints, sizeof(*ppNewPoints) * newCap, pAllocationCallbacks);
+        if (ppNewPoints == NULL) {
+            return; /* Out of memory. Not an error because seek points are optional. */
+        }
+
+        pSeekIndex->ppPoints = ppNewPoints;
+        pSeekIndex->cap      = newCap;
+    }
+
+    pSeekPoint = (fs_zip_seek_point*)fs_malloc(sizeof(*pSeekPoint) + pSeekIndex->windowSize, pAllocationCallbacks);
+    if (pSeekPoint == NULL) {
+        return;
+    }
+
+    /* Anything still sitting in the compressed cache has not been consumed by the decompressor so needs to be read again when resuming. */
+    pSeekPoint->uncompressedOffset = uncompressedOffset;
+    pSeekPoint->compressedOffset   = pZipFile->absoluteCursorCompressed - (pZipFile->compressedCacheSize - pZipFile->compressedCacheCursor);
+    pSeekPoint->decompressor       = pZipFile->decompressor;
+    FS_ZIP_COPY_MEMORY(FS_ZIP_OFFSET_PTR(pSeekPoint, sizeof(*pSeekPoint)), pZipFile->pUncompressedCache, pSeekIndex->windowSize);
+
+    pSeekIndex->ppPoints[pSeekIndex->count] = pSeekPoint;
+    pSeekIndex->count += 1;
+}
+
+/* Finds the last seek point at or before the given offset. Returns null if there isn't one. */
+static const fs_zip_seek_point* fs_zip_seek_index_find(const fs_zip_seek_index* pSeekIndex, fs_uint64 uncompressedOffset)
+{
+    size_t iBeg = 0;
+    size_t iEnd = pSeekIndex->count;
+
+    while (iBeg < iEnd) {
+        size_t iMid = iBeg + ((iEnd - iBeg) / 2);
+
+        if (pSeekIndex->ppPoints[iMid]->uncompressedOffset <= uncompressedOffset) {
+            iBeg = iMid + 1;
+        } else {
+            iEnd = iMid;
+        }
+    }
+
+    if (iBeg == 0) {
+        return NULL;
+    }
+
+    return pSeekIndex->ppPoints[iBeg - 1];
+}
+
+static size_t fs_zip_get_uncompressed_cache_size(fs_zip* pZip, fs_uint16 compressionMethod)
+{
+    if (pZip->uncompressedCacheSize > 0) {
+        return pZip->uncompressedCacheSize;
+    }
+
+    if (compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE) {
+        return FS_ZIP_DEFLATE32_UNCOMPRESSED_CACHE_SIZE_IN_BYTES;
+    } else {
+        return FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES;
+    }
+}
+
 static size_t fs_file_alloc_size_zip(fs* pFS)
 {
-    (void)pFS;
+    fs_zip* pZip = (fs_zip*)fs_get_backend_data(pFS);
+    FS_ZIP_ASSERT(pZip != NULL);
 
     /* Allocate enough space for the largest possible uncompressed cache (DEFLATE64). */
-    return sizeof(fs_file_zip) + FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES + FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES;
+    return sizeof(fs_file_zip) + fs_zip_get_uncompressed_cache_size(pZip, FS_ZIP_COMPRESSION_METHOD_DEFLATE64) + pZip->compressedCacheSize;
+}
+
+/*
+In adaptive mode the compressed cache is refilled with small reads to begin with, and the read size is
+doubled each time the cache is refilled until it reaches the capacity. Anything that moves the cursor
+of the compressed data around, such as seeking, resets it back to the start.
+*/
+static void fs_file_zip_reset_compressed_read_size(fs_zip* pZip, fs_file_zip* pZipFile)
+{
+    if (pZip->adaptiveReadSize) {
+        pZipFile->compressedReadSize = FS_ZIP_MIN(FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES, pZipFile->compressedCacheCap);
+    } else {
+        pZipFile->compressedReadSize = pZipFile->compressedCacheCap;
+    }
+}
+
+/*
+Reads from an absolute position in the archive. If the stream supports positional reads we'll use that so we
+don't need to seek, and so that files sharing the same stream don't need to coordinate. Otherwise we fall back
+to a seek followed by a read.
+*/
+static fs_result fs_zip_stream_read_at(fs_stream* pStream, fs_uint64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    fs_result result;
+
+    result = fs_stream_read_at(pStream, (fs_int64)offset, pDst, bytesToRead, pBytesRead);
+    if (result != FS_NOT_IMPLEMENTED) {
+        return result;
+    }
+
+    result = fs_stream_seek(pStream, (fs_int64)offset, FS_SEEK_SET);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    return fs_stream_read(pStream, pDst, bytesToRead, pBytesRead);
+}
+
+static fs_result fs_file_open_zip_write(fs* pFS, fs_zip* pZip, fs_file_zip* pZipFile, const char* pPath)
+{
+    fs_result result;
+    char  pPathCleanStack[1024];
+    char* pPathClean;
+    size_t pathCleanLen;
+    fs_zip_write_entry* pEntry;
+
+    result = fs_zip_writer_clean_path(pPath, pPathCleanStack, sizeof(pPathCleanStack), fs_get_allocation_callbacks(pFS), &pPathClean, &pathCleanLen);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    if (pathCleanLen == 0) {
+        result = FS_IS_DIRECTORY;
+    } else if (fs_zip_writer_find_entry(pZip, pPathClean, pathCleanLen) != NULL) {
+        result = FS_ALREADY_EXISTS; /* Files can't be replaced or appended to once they've been written. */
+    } else if (pZip->isWritingFile) {
+        result = FS_BUSY;
+    } else {
+        result = fs_zip_writer_add_entry(pZip, pPathClean, pathCleanLen, FS_FALSE, (pZip->compressionLevel > 0) ? FS_ZIP_COMPRESSION_METHOD_DEFLATE : FS_ZIP_COMPRESSION_METHOD_STORE, fs_get_allocation_callbacks(pFS), &pEntry);
+        if (result == FS_SUCCESS) {
+            result = fs_zip_writer_begin_entry(pZip, fs_get_stream(pFS), pEntry, fs_get_allocation_callbacks(pFS));
+        }
+    }
+
+    if (pPathClean != pPathCleanStack) {
+        fs_free(pPathClean, fs_get_allocation_callbacks(pFS));
+    }
+
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    pZip->isWritingFile    = FS_TRUE;
+    pZip->batchFileOffset  = pZip->batchInputSize;
+    pZip->batchChunkOffset = pZip->batchInputSize;
+
+    FS_ZIP_ZERO_OBJECT(&pZipFile->info);
+    pZipFile->info.compressionMethod     = pEntry->compressionMethod;
+    pZipFile->pWriteEntry                = pEntry;
+    pZipFile->absoluteCursorUncompressed = 0;
+    pZipFile->absoluteCursorCompressed   = 0;
+    pZipFile->verifyChecksum             = FS_FALSE;
+    pZipFile->crc32                      = 0;
+    pZipFile->crc32Cursor                = 0;
+
+    /* The whole allocation after the struct is used as the write buffer of stored files. Compressed files go through the batch instead. */
+    pZipFile->uncompressedCacheCap    = fs_file_alloc_size_zip(pFS) - sizeof(fs_file_zip);
+    pZipFile->uncompressedCacheSize   = 0;
+    pZipFile->uncompressedCacheCursor = 0;
+    pZipFile->pUncompressedCache      = (unsigned char*)FS_ZIP_OFFSET_PTR(pZipFile, sizeof(fs_file_zip));
+    pZipFile->compressedCacheCap      = 0;
+    pZipFile->compressedCacheSize     = 0;
+    pZipFile->compressedCacheCursor   = 0;
+    pZipFile->pCompressedCache        = NULL;
+    pZipFile->compressedReadSize      = 0;
+
+    return FS_SUCCESS;
 }
 
 static fs_result fs_file_open_zip(fs* pFS, fs_stream* pStream, const char* pPath, int openMode, fs_file* pFile)
@@ -1860,6 +5798,7 @@ static fs_result fs_file_open_zip(fs* pFS, fs_stream* pStream, const char* pPath
     fs_zip* pZip;
     fs_file_zip* pZipFile;
     fs_result result;
+    fs_uint64 localHeaderOffset;
 
     pZip = (fs_zip*)fs_get_backend_data(pFS);
     FS_ZIP_ASSERT(pZip != NULL);
@@ -1867,12 +5806,22 @@ static fs_result fs_file_open_zip(fs* pFS, fs_stream* pStream, const char* pPath
     pZipFile = (fs_file_zip*)fs_file_get_backend_data(pFile);
     FS_ZIP_ASSERT(pZipFile != NULL);
 
-    /* Write mode is currently unsupported. */
+    pZipFile->pStream     = pStream;
+    pZipFile->pSeekIndex  = NULL;
+    pZipFile->pWriteEntry = NULL;
+
+    /* Archives being written can only have files written to them, and existing archives can only be read. */
     if ((openMode & FS_WRITE) != 0) {
-        return FS_INVALID_OPERATION;
-    }
+        if (!pZip->isWriting || (openMode & FS_READ) != 0) {
+            return FS_INVALID_OPERATION;
+        }
 
-    pZipFile->pStream = pStream;
+        return fs_file_open_zip_write(pFS, pZip, pZipFile, pPath);
+    } else {
+        if (pZip->isWriting) {
+            return FS_INVALID_OPERATION;
+        }
+    }
 
     /* We need to find the file info by it's path. */
     result = fs_zip_get_file_info_by_path(pZip, fs_get_allocation_callbacks(pFS), pPath, (size_t)-1, &pZipFile->info);
@@ -1894,13 +5843,14 @@ static fs_result fs_file_open_zip(fs* pFS, fs_stream* pStream, const char* pPath
 
     /* Make double sure the cursor is at the start. */
     pZipFile->absoluteCursorUncompressed = 0;
+
+    /* The checksum can only be verified if every byte of the file goes through it in order. See fs_file_zip_update_crc32(). */
+    pZipFile->verifyChecksum = pZip->verifyChecksums;
+    pZipFile->crc32          = 0;
+    pZipFile->crc32Cursor    = 0;
     
     /* Use larger uncompressed cache for DEFLATE64 to handle extended back-reference distances. We can make use of that memory for STORE as well. */
-    if (pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE) {
-        pZipFile->uncompressedCacheCap = FS_ZIP_DEFLATE32_UNCOMPRESSED_CACHE_SIZE_IN_BYTES;
-    } else {
-        pZipFile->uncompressedCacheCap = FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES;
-    }
+    pZipFile->uncompressedCacheCap = fs_zip_get_uncompressed_cache_size(pZip, pZipFile->info.compressionMethod);
 
     FS_ZIP_ASSERT(pZipFile->uncompressedCacheCap > 0);
 
@@ -1908,28 +5858,28 @@ static fs_result fs_file_open_zip(fs* pFS, fs_stream* pStream, const char* pPath
     We allocated memory for a compressed cache, even when the file is not compressed. Make use
     of this memory if the file is not compressed.
     
-    For DEFLATE (not DEFLATE64), we can use the extra 32KB from the unused DEFLATE64 cache space
-    to increase the compressed cache size, reducing the number of read operations needed.
+    For DEFLATE (not DEFLATE64), we can use any space left over from the DEFLATE64 cache to increase
+    the compressed cache size, reducing the number of read operations needed.
     */
     if (pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_STORE) {
         /*
         STORE. Since we're not using compression we can make use of the memory we preemptively allocated for the
         compressed cache for the uncompressed cache instead.
         */
-        pZipFile->uncompressedCacheCap += FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES;
+        pZipFile->uncompressedCacheCap += pZip->compressedCacheSize;
         pZipFile->compressedCacheCap    = 0;
     } else if (pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE) {
         /*
         DEFLATE. We allocated a full 64kb buffer for the uncompressed cache in case the file ended up being compressed
-        with DEFLATE64. Since we don't need much space for regular DEFLATE, we'll give the extra 32KB to the compressed
-        cache.
+        with DEFLATE64. If regular DEFLATE has been configured to use less than that, we'll give the extra to the
+        compressed cache.
         */
-        pZipFile->compressedCacheCap = FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES + (FS_ZIP_DEFLATE64_UNCOMPRESSED_CACHE_SIZE_IN_BYTES - FS_ZIP_DEFLATE32_UNCOMPRESSED_CACHE_SIZE_IN_BYTES);
+        pZipFile->compressedCacheCap = pZip->compressedCacheSize + (fs_zip_get_uncompressed_cache_size(pZip, FS_ZIP_COMPRESSION_METHOD_DEFLATE64) - pZipFile->uncompressedCacheCap);
     } else {
         /*
         DEFLATE64. We need the full 64KB cache so we'll have to use the standard size for the compressed cache.
         */
-        pZipFile->compressedCacheCap = FS_ZIP_COMPRESSED_CACHE_SIZE_IN_BYTES;
+        pZipFile->compressedCacheCap = pZip->compressedCacheSize;
         FS_ZIP_ASSERT(pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE64);
     }
 
@@ -1939,6 +5889,8 @@ static fs_result fs_file_open_zip(fs* pFS, fs_stream* pStream, const char* pPath
     pZipFile->pUncompressedCache = (unsigned char*)FS_ZIP_OFFSET_PTR(pZipFile, sizeof(fs_file_zip));
     pZipFile->pCompressedCache   = (unsigned char*)FS_ZIP_OFFSET_PTR(pZipFile, sizeof(fs_file_zip) + pZipFile->uncompressedCacheCap);
 
+    fs_file_zip_reset_compressed_read_size(pZip, pZipFile);
+
     /*
     We need to move the file offset forward so that it's pointing to the first byte of the actual
     data. It's currently sitting at the top of the local header which isn't really useful for us.
@@ -1946,24 +5898,19 @@ static fs_result fs_file_open_zip(fs* pFS, fs_stream* pStream, const char* pPath
     the local header.
     */
     {
-        fs_uint16 fileNameLen;
-        fs_uint16 extraLen;
+        fs_uint8 lengths[4];    /* File name length and extra data length. */
+        fs_uint32 fileNameLen;
+        fs_uint32 extraLen;
 
-        result = fs_stream_seek(pZipFile->pStream, pZipFile->info.fileOffset + 26, FS_SEEK_SET);
+        result = fs_zip_stream_read_at(pZipFile->pStream, pZipFile->info.fileOffset + 26, lengths, sizeof(lengths), NULL);
         if (result != FS_SUCCESS) {
             return result;
         }
 
-        result = fs_stream_read(pZipFile->pStream, &fileNameLen, 2, NULL);
-        if (result != FS_SUCCESS) {
-            return result;
-        }
-
-        result = fs_stream_read(pZipFile->pStream, &extraLen, 2, NULL);
-        if (result != FS_SUCCESS) {
-            return result;
-        }
+        fileNameLen = FS_ZIP_READ_LE16(lengths + 0);
+        extraLen    = FS_ZIP_READ_LE16(lengths + 2);
 
+        localHeaderOffset = pZipFile->info.fileOffset;
         pZipFile->info.fileOffset += (fs_uint32)30 + fileNameLen + extraLen;
     }
 
@@ -1975,18 +5922,146 @@ static fs_result fs_file_open_zip(fs* pFS, fs_stream* pStream, const char* pPath
         if (result != FS_SUCCESS) {
             return result;
         }
+
+        /*
+        The local header offset is used to identify the file for the purpose of seek points. Note that
+        the file offset has been moved past the local header at this point.
+        */
+        if (pZip->seekPointInterval > 0) {
+            pZipFile->pSeekIndex = fs_zip_seek_index_acquire(pZip, localHeaderOffset, pZipFile->uncompressedCacheCap, fs_get_allocation_callbacks(pFS));
+        }
+    }
+
+
+    return FS_SUCCESS;
+}
+
+static fs_result fs_file_zip_flush_write_buffer(fs_zip* pZip, fs_file_zip* pZipFile, fs_stream* pStream)
+{
+    fs_result result;
+
+    if (pZipFile->uncompressedCacheSize == 0) {
+        return FS_SUCCESS;
+    }
+
+    result = fs_zip_writer_write(pZip, pStream, pZipFile->pUncompressedCache, pZipFile->uncompressedCacheSize);
+    if (result != FS_SUCCESS) {
+        return result;
     }
 
+    pZipFile->info.compressedSize += pZipFile->uncompressedCacheSize;
+    pZipFile->uncompressedCacheSize = 0;
 
     return FS_SUCCESS;
 }
 
+static void fs_file_close_zip_write(fs_zip* pZip, fs_file_zip* pZipFile, fs_stream* pStream, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_zip_write_entry* pEntry = pZipFile->pWriteEntry;
+
+    /* There's no way to report an error from here. Any error will be remembered and the archive will be left without a central directory. */
+    if (pEntry->compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE) {
+        /* The compressed size is added up as each chunk is written. */
+        pEntry->crc32            = pZipFile->crc32;
+        pEntry->uncompressedSize = pZipFile->info.uncompressedSize;
+
+        if (fs_zip_writer_add_chunk(pZip, pEntry, FS_TRUE, pAllocationCallbacks) == FS_SUCCESS) {
+            fs_zip_writer_queue_item(pZip, FS_ZIP_WRITE_ITEM_DATA_DESCRIPTOR, pEntry, 0, pAllocationCallbacks);
+        }
+    } else if (fs_file_zip_flush_write_buffer(pZip, pZipFile, pStream) == FS_SUCCESS) {
+        pEntry->crc32            = pZipFile->crc32;
+        pEntry->compressedSize   = pZipFile->info.compressedSize;
+        pEntry->uncompressedSize = pZipFile->info.uncompressedSize;
+
+        fs_zip_writer_write_data_descriptor(pZip, pStream, pEntry);
+    }
+
+    pZip->isWritingFile = FS_FALSE;
+}
+
 static void fs_file_close_zip(fs_file* pFile)
 {
-    /* Nothing to do. */
-    (void)pFile;
+    fs_file_zip* pZipFile;
+
+    pZipFile = (fs_file_zip*)fs_file_get_backend_data(pFile);
+    FS_ZIP_ASSERT(pZipFile != NULL);
+
+    if (pZipFile->pWriteEntry != NULL) {
+        fs_file_close_zip_write((fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile)), pZipFile, fs_get_stream(fs_file_get_fs(pFile)), fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
+        return;
+    }
+
+    /* Hand the seek index back to the archive so it can be reused next time the file is opened. */
+    if (pZipFile->pSeekIndex != NULL) {
+        fs_zip_seek_index_release((fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile)), pZipFile->pSeekIndex, fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
+        pZipFile->pSeekIndex = NULL;
+    }
+}
+
+
+/* Maps the archive the first time it's needed. Multiple files can be mapped at the same time so this needs to be locked. */
+static fs_result fs_zip_map_archive(fs* pFS, fs_zip* pZip, const fs_uint8** ppArchiveData, size_t* pArchiveDataSize)
+{
+    if (!pZip->isArchiveDataLockInitialized) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    fs_mtx_lock(&pZip->archiveDataLock);
+    {
+        if (!pZip->hasTriedMappingArchive) {
+            const void* pArchiveData;
+            size_t archiveDataSize;
+
+            if (fs_stream_map(fs_get_stream(pFS), &pArchiveData, &archiveDataSize) == FS_SUCCESS) {
+                pZip->pArchiveData    = (const fs_uint8*)pArchiveData;
+                pZip->archiveDataSize = archiveDataSize;
+            }
+
+            pZip->hasTriedMappingArchive = FS_TRUE;
+        }
+
+        *ppArchiveData    = pZip->pArchiveData;
+        *pArchiveDataSize = pZip->archiveDataSize;
+    }
+    fs_mtx_unlock(&pZip->archiveDataLock);
+
+    return (*ppArchiveData != NULL) ? FS_SUCCESS : FS_NOT_IMPLEMENTED;
 }
 
+static fs_result fs_file_map_zip(fs_file* pFile, const void** ppData, size_t* pDataSize)
+{
+    fs_zip* pZip;
+    fs_file_zip* pZipFile;
+    const fs_uint8* pArchiveData;
+    size_t archiveDataSize;
+
+    pZip = (fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile));
+    FS_ZIP_ASSERT(pZip != NULL);
+
+    pZipFile = (fs_file_zip*)fs_file_get_backend_data(pFile);
+    FS_ZIP_ASSERT(pZipFile != NULL);
+
+    /*
+    We can only give out a direct pointer for stored files, and only if the archive itself can be mapped.
+    In all other cases the core library will fall back to decompressing into memory.
+    */
+    if (pZipFile->pWriteEntry != NULL || pZipFile->info.compressionMethod != FS_ZIP_COMPRESSION_METHOD_STORE) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    if (fs_zip_map_archive(fs_file_get_fs(pFile), pZip, &pArchiveData, &archiveDataSize) != FS_SUCCESS) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    if (pZipFile->info.fileOffset > archiveDataSize || pZipFile->info.uncompressedSize > archiveDataSize - pZipFile->info.fileOffset) {
+        return FS_INVALID_FILE;  /* The file data goes beyond the end of the archive. */
+    }
+
+    *ppData    = pArchiveData + (size_t)pZipFile->info.fileOffset;
+    *pDataSize = (size_t)pZipFile->info.uncompressedSize;
+
+    return FS_SUCCESS;
+}
 
 static fs_result fs_file_read_zip_store(fs* pFS, fs_file_zip* pZipFile, void* pDst, size_t bytesToRead, size_t* pBytesRead)
 {
@@ -2029,19 +6104,14 @@ static fs_result fs_file_read_zip_store(fs* pFS, fs_file_zip* pZipFile, void* pD
         load into the uncompressed cache and then read from that.
         */
         size_t bytesRemainingToRead = bytesToRead - bytesRead;
-        size_t bytesToReadFromArchive;
-
-        result = fs_stream_seek(pZipFile->pStream, pZipFile->info.fileOffset + (pZipFile->absoluteCursorUncompressed + bytesRead), FS_SEEK_SET);
-        if (result != FS_SUCCESS) {
-            return result;
-        }
+        size_t bytesToReadFromArchive;
 
         if (bytesRemainingToRead > pZipFile->uncompressedCacheCap) {
             size_t bytesReadFromArchive;
 
             bytesToReadFromArchive = (bytesRemainingToRead / pZipFile->uncompressedCacheCap) * pZipFile->uncompressedCacheCap;
 
-            result = fs_stream_read(pZipFile->pStream, FS_ZIP_OFFSET_PTR(pDst, bytesRead), bytesToReadFromArchive, &bytesReadFromArchive);
+            result = fs_zip_stream_read_at(pZipFile->pStream, pZipFile->info.fileOffset + (pZipFile->absoluteCursorUncompressed + bytesRead), FS_ZIP_OFFSET_PTR(pDst, bytesRead), bytesToReadFromArchive, &bytesReadFromArchive);
             if (result != FS_SUCCESS) {
                 return result;
             }
@@ -2057,7 +6127,7 @@ static fs_result fs_file_read_zip_store(fs* pFS, fs_file_zip* pZipFile, void* pD
         if (bytesRemainingToRead > 0) {
             FS_ZIP_ASSERT(bytesRemainingToRead < pZipFile->uncompressedCacheCap);
 
-            result = fs_stream_read(pZipFile->pStream, pZipFile->pUncompressedCache, (size_t)FS_ZIP_MIN(pZipFile->uncompressedCacheCap, (pZipFile->info.uncompressedSize - (pZipFile->absoluteCursorUncompressed + bytesRead))), &pZipFile->uncompressedCacheSize); /* Safe cast to size_t because reading will be clamped to bytesToRead. */
+            result = fs_zip_stream_read_at(pZipFile->pStream, pZipFile->info.fileOffset + (pZipFile->absoluteCursorUncompressed + bytesRead), pZipFile->pUncompressedCache, (size_t)FS_ZIP_MIN(pZipFile->uncompressedCacheCap, (pZipFile->info.uncompressedSize - (pZipFile->absoluteCursorUncompressed + bytesRead))), &pZipFile->uncompressedCacheSize); /* Safe cast to size_t because reading will be clamped to bytesToRead. */
             if (result != FS_SUCCESS) {
                 return result;
             }
@@ -2078,6 +6148,127 @@ static fs_result fs_file_read_zip_store(fs* pFS, fs_file_zip* pZipFile, void* pD
     return FS_SUCCESS;
 }
 
+/*
+Decompresses into the given output buffer, reading more compressed data as required. This will stop
+when the output buffer is full or the end of the compressed data has been reached. The output buffer
+is either the uncompressed cache, which is used as a ring buffer, or the caller's own buffer when
+FS_ZIP_DEFLATE_FLAG_USING_NON_WRAPPING_OUTPUT_BUF is specified. On input, pOutputBufferSize is the
+number of bytes available at pOutputBufferNext. On output it's the number of bytes decompressed.
+*/
+static fs_result fs_file_zip_decompress(fs_file_zip* pZipFile, fs_uint8* pOutputBufferStart, fs_uint8* pOutputBufferNext, size_t* pOutputBufferSize, int flags)
+{
+    fs_result result;
+    size_t outputBufferCap = *pOutputBufferSize;
+    size_t outputBufferSize = 0;
+
+    *pOutputBufferSize = 0;
+
+    for (;;) {
+        fs_result decompressResult;
+        size_t compressedBytesRead;
+        size_t compressedBytesToRead;
+        int decompressFlags = FS_ZIP_DEFLATE_FLAG_HAS_MORE_INPUT | flags;    /* The default stance is that we have more input available. */
+        
+        /* Add DEFLATE64 flag if this is a DEFLATE64 compressed file */
+        if (pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE64) {
+            decompressFlags |= FS_ZIP_DEFLATE_FLAG_DEFLATE64;
+        }
+
+        /* If we've already read the entire compressed file we need to set the flag to indicate there is no more input. */
+        if (pZipFile->absoluteCursorCompressed == pZipFile->info.compressedSize) {
+            decompressFlags &= ~FS_ZIP_DEFLATE_FLAG_HAS_MORE_INPUT;
+        }
+
+        /*
+        We need only lock while we read the compressed data into our cache. We don't need to keep
+        the archive locked while we do the decompression phase.
+
+        We need only read more input data from the stream if we've run out of data in the
+        compressed cache.
+        */
+        if (pZipFile->compressedCacheSize == 0) {
+            FS_ZIP_ASSERT(pZipFile->compressedCacheCursor == 0); /* The cursor should never go past the size. */
+
+            /*
+            Read the compressed data into the compressed cache. The number of compressed bytes we
+            read needs to be clamped to the number of bytes remaining in the file and the number
+            of bytes remaining in the compressed cache.
+            */
+            compressedBytesToRead = (size_t)FS_ZIP_MIN(pZipFile->compressedReadSize - pZipFile->compressedCacheCursor, (pZipFile->info.compressedSize - pZipFile->absoluteCursorCompressed));
+
+            /* In adaptive mode we're reading sequentially if we get here so the next read can be bigger. */
+            if (pZipFile->compressedReadSize < pZipFile->compressedCacheCap) {
+                pZipFile->compressedReadSize = FS_ZIP_MIN(pZipFile->compressedReadSize * 2, pZipFile->compressedCacheCap);
+            }
+
+            result = fs_zip_stream_read_at(pZipFile->pStream, pZipFile->info.fileOffset + pZipFile->absoluteCursorCompressed, pZipFile->pCompressedCache + pZipFile->compressedCacheCursor, compressedBytesToRead, &compressedBytesRead);
+            /*
+            We'll inspect the result later after we've escaped from the locked section just to
+            keep the lock as small as possible.
+            */
+
+            pZipFile->absoluteCursorCompressed += compressedBytesRead;
+
+            /* If we've reached the end of the compressed data, we need to set a flag which we later pass through to the decompressor. */
+            if (result == FS_AT_END && compressedBytesRead < compressedBytesToRead) {
+                decompressFlags &= ~FS_ZIP_DEFLATE_FLAG_HAS_MORE_INPUT;
+            }
+
+            if (result != FS_SUCCESS && result != FS_AT_END) {
+                return result;  /* Failed to read the compressed data. */
+            }
+
+            pZipFile->compressedCacheSize += compressedBytesRead;
+        }
+
+
+        /*
+        At this point we should have the compressed data. Here is where we decompress it into
+        the output buffer. We need to set up a few parameters here. The input buffer needs to
+        start from the current cursor position of the compressed cache. The input size is the
+        number of bytes in the compressed cache between the cursor and the end of the compressed
+        cache.
+        */
+        {
+            size_t inputBufferSize = pZipFile->compressedCacheSize - pZipFile->compressedCacheCursor;
+            size_t outputBufferSizeThisIteration = outputBufferCap - outputBufferSize;
+
+            decompressResult = fs_zip_deflate_decompress(&pZipFile->decompressor, pZipFile->pCompressedCache + pZipFile->compressedCacheCursor, &inputBufferSize, pOutputBufferStart, pOutputBufferNext + outputBufferSize, &outputBufferSizeThisIteration, decompressFlags);
+            if (decompressResult < 0) {
+                return decompressResult; /* Failed to decompress the data. Return the specific error code. */
+            }
+
+            /* Move our input cursors forward since we've just consumed some input. */
+            pZipFile->compressedCacheCursor += inputBufferSize;
+
+            /* We've just generated some uncompressed data. */
+            outputBufferSize += outputBufferSizeThisIteration;
+            *pOutputBufferSize = outputBufferSize;
+
+            /*
+            If the compressed cache has been fully exhausted we need to reset it so more data
+            can be read from the stream.
+            */
+            if (pZipFile->compressedCacheCursor == pZipFile->compressedCacheSize) {
+                pZipFile->compressedCacheCursor = 0;
+                pZipFile->compressedCacheSize   = 0;
+            }
+
+            /*
+            We need to inspect the result of the decompression to determine how to continue. If
+            we've reached the end we need only break from the loop.
+            */
+            if (decompressResult == FS_NEEDS_MORE_INPUT) {
+                continue;   /* Do another round of reading and decompression. */
+            } else {
+                break;      /* We've reached the end of the compressed data or the output buffer is full. */
+            }
+        }
+    }
+
+    return FS_SUCCESS;
+}
+
 static fs_result fs_file_read_zip_deflate(fs* pFS, fs_file_zip* pZipFile, void* pDst, size_t bytesToRead, size_t* pBytesRead)
 {
     fs_result result;
@@ -2087,8 +6278,6 @@ static fs_result fs_file_read_zip_deflate(fs* pFS, fs_file_zip* pZipFile, void*
     FS_ZIP_ASSERT(pZipFile != NULL);
     FS_ZIP_ASSERT(pBytesRead != NULL);
 
-    (void)pFS;
-
     uncompressedBytesRemainingInFile = pZipFile->info.uncompressedSize - pZipFile->absoluteCursorUncompressed;
     if (uncompressedBytesRemainingInFile == 0) {
         return FS_AT_END;   /* Nothing left to read. Must return FS_AT_END. */
@@ -2110,6 +6299,7 @@ static fs_result fs_file_read_zip_deflate(fs* pFS, fs_file_zip* pZipFile, void*
         /* Read from the uncompressed cache first. */
         size_t bytesRemainingInCache = pZipFile->uncompressedCacheSize - pZipFile->uncompressedCacheCursor;
         size_t bytesToReadFromCache = bytesToRead - uncompressedBytesRead;
+        size_t uncompressedBytesDecompressed;
         if (bytesToReadFromCache > bytesRemainingInCache) {
             bytesToReadFromCache = bytesRemainingInCache;
         }
@@ -2124,164 +6314,262 @@ static fs_result fs_file_read_zip_deflate(fs* pFS, fs_file_zip* pZipFile, void*
             break;
         }
 
-        
-        /*
-        Getting here means we've exhausted the uncompressed cache but still have more data to read. We
-        now need to refill the uncompressed cache and read from it again.
 
-        This needs to be run in a loop because we may need to read multiple times to get enough input
-        data to fill the entire uncompressed output cache, which must be at least 32KB.
+        /*
+        If the caller's buffer already holds at least a cache's worth of output, it has everything
+        the decompressor could possibly need for back references, so if there's also at least another
+        cache's worth of room left we can decompress straight into it and skip the copy out of the
+        cache. Afterwards, the tail end of the output is copied back into the cache so it can carry on
+        as the window for later reads.
         */
-        pZipFile->uncompressedCacheCursor = 0;
-        pZipFile->uncompressedCacheSize   = 0;
+        if (uncompressedBytesRead >= pZipFile->uncompressedCacheCap && (bytesToRead - uncompressedBytesRead) >= pZipFile->uncompressedCacheCap) {
+            uncompressedBytesDecompressed = bytesToRead - uncompressedBytesRead;
 
-        for (;;) {
-            fs_result decompressResult;
-            size_t compressedBytesRead;
-            size_t compressedBytesToRead;
-            int decompressFlags = FS_ZIP_DEFLATE_FLAG_HAS_MORE_INPUT;    /* The default stance is that we have more input available. */
-            
-            /* Add DEFLATE64 flag if this is a DEFLATE64 compressed file */
-            if (pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE64) {
-                decompressFlags |= FS_ZIP_DEFLATE_FLAG_DEFLATE64;
+            result = fs_file_zip_decompress(pZipFile, (fs_uint8*)pDst, (fs_uint8*)FS_ZIP_OFFSET_PTR(pDst, uncompressedBytesRead), &uncompressedBytesDecompressed, FS_ZIP_DEFLATE_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+            if (result != FS_SUCCESS) {
+                return result;
             }
 
-            /* If we've already read the entire compressed file we need to set the flag to indicate there is no more input. */
-            if (pZipFile->absoluteCursorCompressed == pZipFile->info.compressedSize) {
-                decompressFlags &= ~FS_ZIP_DEFLATE_FLAG_HAS_MORE_INPUT;
+            if (uncompressedBytesDecompressed == 0) {
+                return FS_INVALID_FILE; /* The compressed data ended before the file did. */
             }
 
-            /*
-            We need only lock while we read the compressed data into our cache. We don't need to keep
-            the archive locked while we do the decompression phase.
+            uncompressedBytesRead += uncompressedBytesDecompressed;
 
-            We need only read more input data from the stream if we've run out of data in the
-            compressed cache.
-            */
-            if (pZipFile->compressedCacheSize == 0) {
-                FS_ZIP_ASSERT(pZipFile->compressedCacheCursor == 0); /* The cursor should never go past the size. */
+            FS_ZIP_COPY_MEMORY(pZipFile->pUncompressedCache, FS_ZIP_OFFSET_PTR(pDst, uncompressedBytesRead - pZipFile->uncompressedCacheCap), pZipFile->uncompressedCacheCap);
+            pZipFile->uncompressedCacheSize   = pZipFile->uncompressedCacheCap;
+            pZipFile->uncompressedCacheCursor = pZipFile->uncompressedCacheCap;
 
-                /* Make sure we're positioned correctly in the stream before we read. */
-                result = fs_stream_seek(pZipFile->pStream, pZipFile->info.fileOffset + pZipFile->absoluteCursorCompressed, FS_SEEK_SET);
-                if (result != FS_SUCCESS) {
-                    return result;
-                }
+            continue;
+        }
 
-                /*
-                Read the compressed data into the compressed cache. The number of compressed bytes we
-                read needs to be clamped to the number of bytes remaining in the file and the number
-                of bytes remaining in the compressed cache.
-                */
-                compressedBytesToRead = (size_t)FS_ZIP_MIN(pZipFile->compressedCacheCap - pZipFile->compressedCacheCursor, (pZipFile->info.compressedSize - pZipFile->absoluteCursorCompressed));
+        
+        /*
+        Getting here means we've exhausted the uncompressed cache but still have more data to read. We
+        now need to refill the uncompressed cache and read from it again.
 
-                result = fs_stream_read(pZipFile->pStream, pZipFile->pCompressedCache + pZipFile->compressedCacheCursor, compressedBytesToRead, &compressedBytesRead);
-                /*
-                We'll inspect the result later after we've escaped from the locked section just to
-                keep the lock as small as possible.
-                */
+        Before the cache is refilled is the moment to record a seek point since the cache currently
+        holds the window the decompressor will need for back references.
+        */
+        if (pZipFile->pSeekIndex != NULL) {
+            fs_zip_seek_index_add_point((fs_zip*)fs_get_backend_data(pFS), pZipFile, pZipFile->absoluteCursorUncompressed + uncompressedBytesRead, fs_get_allocation_callbacks(pFS));
+        }
 
-                pZipFile->absoluteCursorCompressed += compressedBytesRead;
+        uncompressedBytesDecompressed = pZipFile->uncompressedCacheCap;
 
-                /* If we've reached the end of the compressed data, we need to set a flag which we later pass through to the decompressor. */
-                if (result == FS_AT_END && compressedBytesRead < compressedBytesToRead) {
-                    decompressFlags &= ~FS_ZIP_DEFLATE_FLAG_HAS_MORE_INPUT;
-                }
+        result = fs_file_zip_decompress(pZipFile, pZipFile->pUncompressedCache, pZipFile->pUncompressedCache, &uncompressedBytesDecompressed, 0);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
 
-                if (result != FS_SUCCESS && result != FS_AT_END) {
-                    return result;  /* Failed to read the compressed data. */
-                }
+        pZipFile->uncompressedCacheCursor = 0;
+        pZipFile->uncompressedCacheSize   = uncompressedBytesDecompressed;
+    }
 
-                pZipFile->compressedCacheSize += compressedBytesRead;
-            }
+    pZipFile->absoluteCursorUncompressed += uncompressedBytesRead;
 
+    /* We're done. */
+    *pBytesRead = uncompressedBytesRead;
+    return FS_SUCCESS;
+}
 
-            /*
-            At this point we should have the compressed data. Here is where we decompress it into
-            the uncompressed cache. We need to set up a few parameters here. The input buffer needs
-            to start from the current cursor position of the compressed cache. The input size is the
-            number of bytes in the compressed cache between the cursor and the end of the compressed
-            cache. The output buffer is from the current cursor position in the uncompressed cache.
-            */
-            {
-                size_t inputBufferSize = pZipFile->compressedCacheSize - pZipFile->compressedCacheCursor;
-                size_t outputBufferSize = pZipFile->uncompressedCacheCap - pZipFile->uncompressedCacheSize;
+/*
+Feeds data that has just been read into the running CRC-32. Only data that carries on from what has
+already been added is used, which means re-reading data after seeking backwards is fine. Seeking
+forward must feed the data that was skipped over through here as well, otherwise the CRC-32 will
+never cover the whole file. See fs_file_seek_zip() and fs_file_zip_update_crc32_stored().
+*/
+static void fs_file_zip_update_crc32(fs_zip* pZip, fs_file_zip* pZipFile, const void* pData, fs_uint64 offset, size_t dataSize)
+{
+    size_t bytesToSkip;
 
-                decompressResult = fs_zip_deflate_decompress(&pZipFile->decompressor, pZipFile->pCompressedCache + pZipFile->compressedCacheCursor, &inputBufferSize, pZipFile->pUncompressedCache, pZipFile->pUncompressedCache + pZipFile->uncompressedCacheSize, &outputBufferSize, decompressFlags);
-                if (decompressResult < 0) {
-                    return decompressResult; /* Failed to decompress the data. Return the specific error code. */
-                }
+    if (offset > pZipFile->crc32Cursor || offset + dataSize <= pZipFile->crc32Cursor) {
+        return; /* Nothing new. */
+    }
 
-                /* Move our input cursors forward since we've just consumed some input. */
-                pZipFile->compressedCacheCursor += inputBufferSize;
+    bytesToSkip = (size_t)(pZipFile->crc32Cursor - offset);
 
-                /* We've just generated some uncompressed data, so push out the size of the uncompressed cache to accommodate it. */
-                pZipFile->uncompressedCacheSize += outputBufferSize;
+    pZipFile->crc32        = pZip->crc32Proc(pZipFile->crc32, (const fs_uint8*)pData + bytesToSkip, dataSize - bytesToSkip);
+    pZipFile->crc32Cursor += dataSize - bytesToSkip;
+}
 
-                /*
-                If the compressed cache has been fully exhausted we need to reset it so more data
-                can be read from the stream.
-                */
-                if (pZipFile->compressedCacheCursor == pZipFile->compressedCacheSize) {
-                    pZipFile->compressedCacheCursor = 0;
-                    pZipFile->compressedCacheSize   = 0;
-                }
+/*
+Seeking forward in a stored file just moves the cursor so the data that was skipped over hasn't gone
+into the CRC-32. This reads it back from the archive up to the given offset. It's done on the next
+read rather than when seeking so that seeking to the end to get the size of a file stays cheap.
+*/
+static fs_result fs_file_zip_update_crc32_stored(fs_zip* pZip, fs_file_zip* pZipFile, fs_uint64 offset)
+{
+    while (pZipFile->crc32Cursor < offset) {
+        fs_uint8 temp[4096];
+        size_t bytesToRead;
+        size_t bytesRead;
+        fs_result result;
 
-                /*
-                We need to inspect the result of the decompression to determine how to continue. If
-                we've reached the end we need only break from the inner loop.
-                */
-                if (decompressResult == FS_NEEDS_MORE_INPUT) {
-                    continue;   /* Do another round of reading and decompression. */
-                } else {
-                    break;      /* We've reached the end of the compressed data or the output buffer is full. */
-                }
-            }
+        bytesToRead = (size_t)FS_ZIP_MIN((fs_uint64)sizeof(temp), offset - pZipFile->crc32Cursor);    /* Safe cast because it's clamped to sizeof(temp). */
+
+        result = fs_zip_stream_read_at(pZipFile->pStream, pZipFile->info.fileOffset + pZipFile->crc32Cursor, temp, bytesToRead, &bytesRead);
+        if (result != FS_SUCCESS) {
+            return result;
         }
-    }
 
-    pZipFile->absoluteCursorUncompressed += uncompressedBytesRead;
+        if (bytesRead == 0) {
+            return FS_INVALID_FILE; /* The archive is shorter than the central directory says it is. */
+        }
+
+        fs_file_zip_update_crc32(pZip, pZipFile, temp, pZipFile->crc32Cursor, bytesRead);
+    }
 
-    /* We're done. */
-    *pBytesRead = uncompressedBytesRead;
     return FS_SUCCESS;
 }
 
 static fs_result fs_file_read_zip(fs_file* pFile, void* pDst, size_t bytesToRead, size_t* pBytesRead)
 {
     fs_file_zip* pZipFile;
+    fs_result result;
+    fs_uint64 offset;
 
     pZipFile = (fs_file_zip*)fs_file_get_backend_data(pFile);
     FS_ZIP_ASSERT(pZipFile != NULL);
 
+    if (pZipFile->pWriteEntry != NULL) {
+        return FS_INVALID_OPERATION;    /* Files being written can't be read back. */
+    }
+
+    offset = pZipFile->absoluteCursorUncompressed;
+
+    if (pZipFile->verifyChecksum && pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_STORE && offset > pZipFile->crc32Cursor) {
+        result = fs_file_zip_update_crc32_stored((fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile)), pZipFile, offset);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+    }
+
     if (pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_STORE) {
-        return fs_file_read_zip_store(fs_file_get_fs(pFile), pZipFile, pDst, bytesToRead, pBytesRead);
+        result = fs_file_read_zip_store(fs_file_get_fs(pFile), pZipFile, pDst, bytesToRead, pBytesRead);
     } else if (pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE || 
                pZipFile->info.compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE64) {
-        return fs_file_read_zip_deflate(fs_file_get_fs(pFile), pZipFile, pDst, bytesToRead, pBytesRead);
+        result = fs_file_read_zip_deflate(fs_file_get_fs(pFile), pZipFile, pDst, bytesToRead, pBytesRead);
     } else {
         return FS_INVALID_FILE;  /* Should never get here. */
     }
+
+    /*
+    The data is checksummed from the output buffer rather than inside the store and deflate paths since
+    it's guaranteed to be hot in the cache at this point. Once the whole file has been checksummed, any
+    read that ends at the end of the file will report a mismatch, including those that would otherwise
+    return FS_AT_END. The data will still have been output.
+    */
+    if (pZipFile->verifyChecksum) {
+        if (result == FS_SUCCESS) {
+            fs_file_zip_update_crc32((fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile)), pZipFile, pDst, offset, *pBytesRead);
+        }
+
+        if ((result == FS_SUCCESS || result == FS_AT_END) && pZipFile->absoluteCursorUncompressed == pZipFile->info.uncompressedSize && pZipFile->crc32Cursor == pZipFile->info.uncompressedSize && pZipFile->crc32 != pZipFile->info.crc32) {
+            result = FS_CHECKSUM_MISMATCH;
+        }
+    }
+
+    return result;
 }
 
 static fs_result fs_file_write_zip(fs_file* pFile, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
 {
-    /* Write not supported. */
-    (void)pFile;
-    (void)pSrc;
-    (void)bytesToWrite;
-    (void)pBytesWritten;
-    return FS_NOT_IMPLEMENTED;
+    fs_zip* pZip;
+    fs_file_zip* pZipFile;
+    fs_stream* pStream;
+    fs_result result;
+    size_t bytesWritten;
+
+    pZip = (fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile));
+    FS_ZIP_ASSERT(pZip != NULL);
+
+    pZipFile = (fs_file_zip*)fs_file_get_backend_data(pFile);
+    FS_ZIP_ASSERT(pZipFile != NULL);
+
+    if (pZipFile->pWriteEntry == NULL) {
+        return FS_NOT_IMPLEMENTED;  /* Files in existing archives can't be written to. */
+    }
+
+    pStream = fs_get_stream(fs_file_get_fs(pFile));
+    bytesWritten = 0;
+
+    pZipFile->crc32 = pZip->crc32Proc(pZipFile->crc32, pSrc, bytesToWrite);
+
+    if (pZipFile->pWriteEntry->compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE) {
+        result = fs_zip_writer_compress(pZip, pStream, pZipFile->pWriteEntry, pSrc, bytesToWrite, fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
+        if (result == FS_SUCCESS) {
+            bytesWritten = bytesToWrite;
+        }
+    }
+
+    /*
+    Small writes are gathered in the write buffer so we're not going to the stream for every one of
+    them. If the buffer is empty and there's at least a buffer's worth of data we can skip the copy.
+    */
+    while (bytesWritten < bytesToWrite && pZip->writeResult == FS_SUCCESS) {
+        size_t bytesRemaining = bytesToWrite - bytesWritten;
+
+        if (pZipFile->uncompressedCacheSize == 0 && bytesRemaining >= pZipFile->uncompressedCacheCap) {
+            result = fs_zip_writer_write(pZip, pStream, FS_ZIP_OFFSET_PTR(pSrc, bytesWritten), bytesRemaining);
+            if (result != FS_SUCCESS) {
+                break;
+            }
+
+            pZipFile->info.compressedSize += bytesRemaining;
+            bytesWritten += bytesRemaining;
+        } else {
+            size_t bytesToCopy = FS_ZIP_MIN(bytesRemaining, pZipFile->uncompressedCacheCap - pZipFile->uncompressedCacheSize);
+
+            FS_ZIP_COPY_MEMORY(pZipFile->pUncompressedCache + pZipFile->uncompressedCacheSize, FS_ZIP_OFFSET_PTR(pSrc, bytesWritten), bytesToCopy);
+            pZipFile->uncompressedCacheSize += bytesToCopy;
+            bytesWritten += bytesToCopy;
+
+            if (pZipFile->uncompressedCacheSize == pZipFile->uncompressedCacheCap) {
+                result = fs_file_zip_flush_write_buffer(pZip, pZipFile, pStream);
+                if (result != FS_SUCCESS) {
+                    break;
+                }
+            }
+        }
+    }
+
+    /*
+    If anything failed the archive is now broken and nothing more will be written to it so there's no
+    point trying to keep track of exactly how much made it to the stream.
+    */
+    if (pZip->writeResult != FS_SUCCESS) {
+        return pZip->writeResult;
+    }
+
+    pZipFile->info.uncompressedSize      += bytesWritten;
+    pZipFile->absoluteCursorUncompressed += bytesWritten;
+
+    if (pBytesWritten != NULL) {
+        *pBytesWritten = bytesWritten;
+    }
+
+    return FS_SUCCESS;
 }
 
 static fs_result fs_file_seek_zip(fs_file* pFile, fs_int64 offset, fs_seek_origin origin)
 {
+    fs_zip* pZip;
     fs_file_zip* pZipFile;
     fs_int64 newSeekTarget;
     fs_uint64 newAbsoluteCursor;
 
+    pZip = (fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile));
+    FS_ZIP_ASSERT(pZip != NULL);
+
     pZipFile = (fs_file_zip*)fs_file_get_backend_data(pFile);
     FS_ZIP_ASSERT(pZipFile != NULL);
 
+    /* Data goes straight to the stream when writing so there's no going back. */
+    if (pZipFile->pWriteEntry != NULL) {
+        return FS_INVALID_OPERATION;
+    }
+
     if (origin == FS_SEEK_SET) {
         newSeekTarget = 0;
     } else if (origin == FS_SEEK_CUR) {
@@ -2312,6 +6600,11 @@ static fs_result fs_file_seek_zip(fs_file* pFile, fs_int64 offset, fs_seek_origi
         /* Moving forward. */
         fs_uint64 delta = newAbsoluteCursor - pZipFile->absoluteCursorUncompressed;
         if (delta <= (pZipFile->uncompressedCacheSize - pZipFile->uncompressedCacheCursor)) {
+            /* The data being skipped over is sitting in the cache so we can checksum it now. */
+            if (pZipFile->verifyChecksum) {
+                fs_file_zip_update_crc32(pZip, pZipFile, pZipFile->pUncompressedCache + pZipFile->uncompressedCacheCursor, pZipFile->absoluteCursorUncompressed, (size_t)delta);
+            }
+
             pZipFile->uncompressedCacheCursor += (size_t)delta; /* Safe cast. */
             pZipFile->absoluteCursorUncompressed = newAbsoluteCursor;
             return FS_SUCCESS;
@@ -2330,26 +6623,71 @@ static fs_result fs_file_seek_zip(fs_file* pFile, fs_int64 offset, fs_seek_origi
         }
     }
 
-    /* Getting here means we're seeking beyond the uncompressed cache. Just clear it. The next read will read in fresh data. */
-    pZipFile->uncompressedCacheSize   = 0;
-    pZipFile->uncompressedCacheCursor = 0;
-
     /*
-    Seeking is more complicated for compressed files. We need to actually read to the seek point.
-    There is no seek table to accelerate this.
+    Getting here means we're seeking beyond the uncompressed cache. Just clear it. The next read will read in fresh data.
+
+    Seeking is more complicated for compressed files. We need to actually read to the seek point. If we have a seek
+    point at or before the target we can resume the decompressor from there rather than decompressing everything
+    in between.
     */
     if (pZipFile->info.compressionMethod != FS_ZIP_COMPRESSION_METHOD_STORE) {
-        pZipFile->compressedCacheCursor = 0;
-        pZipFile->compressedCacheSize   = 0;
+        const fs_zip_seek_point* pSeekPoint = NULL;
+
+        fs_uint64 seekPointTarget = newAbsoluteCursor;
+
+        /*
+        When moving forward, the rest of the uncompressed cache is skipped. The cursor needs to account for this so it
+        stays in sync with the output of the decompressor. The skipped data needs to go into the checksum.
+        */
+        if (newAbsoluteCursor > pZipFile->absoluteCursorUncompressed) {
+            if (pZipFile->verifyChecksum) {
+                fs_file_zip_update_crc32(pZip, pZipFile, pZipFile->pUncompressedCache + pZipFile->uncompressedCacheCursor, pZipFile->absoluteCursorUncompressed, pZipFile->uncompressedCacheSize - pZipFile->uncompressedCacheCursor);
+            }
+
+            pZipFile->absoluteCursorUncompressed += (pZipFile->uncompressedCacheSize - pZipFile->uncompressedCacheCursor);
+        }
 
         /*
-        When seeking backwards we need to move everything back to the start and then just
-        read-and-discard until we reach the end.
+        While the checksum is being computed, a seek point past the end of what has been checksummed can't be used
+        because the data in between would never go into the checksum. Decompressing it is needed either way.
         */
-        if (pZipFile->absoluteCursorUncompressed > newAbsoluteCursor) {
+        if (pZipFile->verifyChecksum && seekPointTarget > pZipFile->crc32Cursor) {
+            seekPointTarget = pZipFile->crc32Cursor;
+        }
+
+        pZipFile->uncompressedCacheSize   = 0;
+        pZipFile->uncompressedCacheCursor = 0;
+
+        if (pZipFile->pSeekIndex != NULL) {
+            pSeekPoint = fs_zip_seek_index_find(pZipFile->pSeekIndex, seekPointTarget);
+
+            /* Only use the seek point if it gets us further along than where we currently are. */
+            if (pSeekPoint != NULL && pSeekPoint->uncompressedOffset <= pZipFile->absoluteCursorUncompressed && pZipFile->absoluteCursorUncompressed <= newAbsoluteCursor) {
+                pSeekPoint = NULL;
+            }
+        }
+
+        if (pSeekPoint != NULL) {
+            pZipFile->absoluteCursorUncompressed = pSeekPoint->uncompressedOffset;
+            pZipFile->absoluteCursorCompressed   = pSeekPoint->compressedOffset;
+            pZipFile->decompressor               = pSeekPoint->decompressor;
+            FS_ZIP_COPY_MEMORY(pZipFile->pUncompressedCache, FS_ZIP_OFFSET_PTR(pSeekPoint, sizeof(*pSeekPoint)), pZipFile->pSeekIndex->windowSize);
+
+            pZipFile->compressedCacheCursor = 0;
+            pZipFile->compressedCacheSize   = 0;
+            fs_file_zip_reset_compressed_read_size(pZip, pZipFile);
+        } else if (pZipFile->absoluteCursorUncompressed > newAbsoluteCursor) {
+            /*
+            When seeking backwards we need to move everything back to the start and then just
+            read-and-discard until we reach the end.
+            */
             pZipFile->absoluteCursorUncompressed = 0;
             pZipFile->absoluteCursorCompressed   = 0;
 
+            pZipFile->compressedCacheCursor = 0;
+            pZipFile->compressedCacheSize   = 0;
+            fs_file_zip_reset_compressed_read_size(pZip, pZipFile);
+
             /* The decompressor needs to be reset. */
             fs_zip_deflate_decompressor_init(&pZipFile->decompressor);
         }
@@ -2368,7 +6706,7 @@ static fs_result fs_file_seek_zip(fs_file* pFile, fs_int64 offset, fs_seek_origi
             
             bytesRead = 0;
             result = fs_file_read_zip(pFile, temp, (size_t)bytesToRead, &bytesRead);    /* Safe cast to size_t because the bytes to read will be clamped to sizeof(temp). */
-            if (result != FS_SUCCESS) {
+            if (result != FS_SUCCESS && result != FS_CHECKSUM_MISMATCH) {   /* A checksum mismatch will be reported by the next read. */
                 return result;
             }
 
@@ -2376,6 +6714,9 @@ static fs_result fs_file_seek_zip(fs_file* pFile, fs_int64 offset, fs_seek_origi
                 return FS_BAD_SEEK;  /* Trying to seek beyond the end of the file. */
             }
         }
+    } else {
+        pZipFile->uncompressedCacheSize   = 0;
+        pZipFile->uncompressedCacheCursor = 0;
     }
 
     /* Make sure the absolute cursor is set to the new position. */
@@ -2397,9 +6738,30 @@ static fs_result fs_file_tell_zip(fs_file* pFile, fs_int64* pCursor)
 
 static fs_result fs_file_flush_zip(fs_file* pFile)
 {
-    /* Nothing to do. */
-    (void)pFile;
-    return FS_SUCCESS;
+    fs_file_zip* pZipFile = (fs_file_zip*)fs_file_get_backend_data(pFile);
+
+    FS_ZIP_ASSERT(pZipFile != NULL);
+
+    /* Only files being written have anything to flush. */
+    if (pZipFile->pWriteEntry == NULL) {
+        return FS_SUCCESS;
+    }
+
+    /*
+    For compressed files, whatever hasn't been put into a chunk yet is put into one now and the batch is
+    compressed. The compressor pads each chunk to a byte boundary so this costs a few bytes.
+    */
+    if (pZipFile->pWriteEntry->compressionMethod == FS_ZIP_COMPRESSION_METHOD_DEFLATE) {
+        fs_zip* pZip = (fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile));
+
+        if (pZip->batchInputSize > pZip->batchChunkOffset) {
+            fs_zip_writer_add_chunk(pZip, pZipFile->pWriteEntry, FS_FALSE, fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
+        }
+
+        return fs_zip_writer_run_batch(pZip, fs_get_stream(fs_file_get_fs(pFile)), fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
+    }
+
+    return fs_file_zip_flush_write_buffer((fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile)), pZipFile, fs_get_stream(fs_file_get_fs(pFile)));
 }
 
 static fs_result fs_file_info_zip(fs_file* pFile, fs_file_info* pInfo)
@@ -2426,8 +6788,21 @@ static fs_result fs_file_duplicate_zip(fs_file* pFile, fs_file* pDuplicatedFile)
     pDuplicatedZipFile = (fs_file_zip*)fs_file_get_backend_data(pDuplicatedFile);
     FS_ZIP_ASSERT(pDuplicatedZipFile != NULL);
 
-    /* We should be able to do this with a simple memcpy. */
+    /* Only one file can be written at a time. */
+    if (pZipFile->pWriteEntry != NULL) {
+        return FS_INVALID_OPERATION;
+    }
+
+    /* We should be able to do this with a simple memcpy, but the cache pointers need to be updated to point to the new file's memory. */
     FS_ZIP_COPY_MEMORY(pDuplicatedZipFile, pZipFile, fs_file_alloc_size_zip(fs_file_get_fs(pFile)));
+    pDuplicatedZipFile->pUncompressedCache = (unsigned char*)FS_ZIP_OFFSET_PTR(pDuplicatedZipFile, sizeof(fs_file_zip));
+    pDuplicatedZipFile->pCompressedCache   = (unsigned char*)FS_ZIP_OFFSET_PTR(pDuplicatedZipFile, sizeof(fs_file_zip) + pDuplicatedZipFile->uncompressedCacheCap);
+
+    /* The seek index is owned by the original file so the duplicate needs its own. */
+    if (pZipFile->pSeekIndex != NULL) {
+        fs_zip* pZip = (fs_zip*)fs_get_backend_data(fs_file_get_fs(pFile));
+        pDuplicatedZipFile->pSeekIndex = fs_zip_seek_index_acquire(pZip, pZipFile->pSeekIndex->localHeaderOffset, pZipFile->pSeekIndex->windowSize, fs_get_allocation_callbacks(fs_file_get_fs(pFile)));
+    }
 
     return FS_SUCCESS;
 }
@@ -2485,6 +6860,11 @@ FS_API fs_iterator* fs_first_zip(fs* pFS, const char* pDirectoryPath, size_t dir
     pZip = (fs_zip*)fs_get_backend_data(pFS);
     FS_ZIP_ASSERT(pZip != NULL);
 
+    /* Archives that are being written can't be iterated. */
+    if (pZip->isWriting) {
+        return NULL;
+    }
+
     if (pDirectoryPath == NULL) {
         pDirectoryPath = "";
     }
@@ -2523,21 +6903,30 @@ FS_API fs_iterator* fs_first_zip(fs* pFS, const char* pDirectoryPath, size_t dir
     we just iterate over each segment in the path and get the children one after the other.
     */
     if (fs_result_from_errno(fs_path_first(pDirectoryPathClean, directoryPathCleanLen, &directoryPathIterator)) == FS_SUCCESS) {
-        for (;;) {
-            /* Try finding the child node. If this cannot be found, the directory does not exist. */
-            fs_zip_cd_node* pChildNode;
-
-            pChildNode = fs_zip_cd_node_find_child(pCurrentNode, directoryPathIterator.pFullPath + directoryPathIterator.segmentOffset, directoryPathIterator.segmentLength);
-            if (pChildNode == NULL) {
+        if (pZip->pPathHashTable != NULL) {
+            /* We have a hash table so we can find the node with a single lookup. */
+            pCurrentNode = fs_zip_find_node_by_path_hash(pZip, pDirectoryPathClean, (size_t)directoryPathCleanLen);
+            if (pCurrentNode == NULL) {
                 fs_free(pDirectoryPathCleanHeap, fs_get_allocation_callbacks(pFS));
                 return NULL;    /* Does not exist. */
             }
+        } else {
+            for (;;) {
+                /* Try finding the child node. If this cannot be found, the directory does not exist. */
+                fs_zip_cd_node* pChildNode;
 
-            pCurrentNode = pChildNode;
+                pChildNode = fs_zip_cd_node_find_child(pCurrentNode, directoryPathIterator.pFullPath + directoryPathIterator.segmentOffset, directoryPathIterator.segmentLength);
+                if (pChildNode == NULL) {
+                    fs_free(pDirectoryPathCleanHeap, fs_get_allocation_callbacks(pFS));
+                    return NULL;    /* Does not exist. */
+                }
+
+                pCurrentNode = pChildNode;
             
-            /* Go to the next segment if we have one. */
-            if (fs_result_from_errno(fs_path_next(&directoryPathIterator)) != FS_SUCCESS) {
-                break;  /* Nothing left in the directory path. We have what we're looking for. */
+                /* Go to the next segment if we have one. */
+                if (fs_result_from_errno(fs_path_next(&directoryPathIterator)) != FS_SUCCESS) {
+                    break;  /* Nothing left in the directory path. We have what we're looking for. */
+                }
             }
         }
     } else {
@@ -2616,7 +7005,7 @@ fs_backend fs_zip_backend =
     fs_uninit_zip,
     NULL,   /* remove */
     NULL,   /* rename */
-    NULL,   /* mkdir */
+    fs_mkdir_zip,
     fs_info_zip,
     fs_file_alloc_size_zip,
     fs_file_open_zip,
@@ -2631,7 +7020,12 @@ fs_backend fs_zip_backend =
     fs_file_duplicate_zip,
     fs_first_zip,
     fs_next_zip,
-    fs_free_iterator_zip
+    fs_free_iterator_zip,
+    NULL,   /* file_read_at */
+    NULL,   /* file_write_at */
+    fs_file_map_zip,
+    NULL,   /* file_unmap */
+    NULL    /* first_ex */
 };
 const fs_backend* FS_ZIP = &fs_zip_backend;
 /* END fs_zip.c */
@@ -32,7 +32,143 @@ use the Zip backend which you do by passing in FS_ZIP, which is declared in this
 well, you'll get a pointer to a new fs object representing the Zip archive and you can use it to
 open files from within it just like any other file.
 
-You can pass in NULL for the backend config in fs_init().
+You can pass in NULL for the backend config in fs_init(). Otherwise you can pass in a pointer to a
+fs_zip_config object:
+
+    fs_zip_config zipConfig = fs_zip_config_init();
+    zipConfig.threadCount = 4;
+
+    fs_config fsConfig = fs_config_init(FS_ZIP, &zipConfig, fs_file_get_stream(pZipArchiveFile));
+
+The threadCount option controls how many threads are used to build the index of the central directory
+when the archive is opened. This is only worth it for archives with a very large number of files. For
+small archives everything will be done on the calling thread regardless of this setting.
+
+Building the index requires parsing and sorting the entire central directory every time the archive
+is opened. For archives with a large number of files you can have the index saved to a separate file
+so that subsequent opens can just load it:
+
+    fs_file_info archiveInfo;
+    fs_file_get_info(pZipArchiveFile, &archiveInfo);
+
+    zipConfig.pIndexFilePath      = "archive.zip.fsidx";
+    zipConfig.archiveModifiedTime = archiveInfo.lastModifiedTime;
+
+The index file is tied to the size of the archive, the modified time and a CRC-32 of the central
+directory. If any of these change, or the index file does not exist, the index will be rebuilt and
+the index file rewritten. The modified time is optional, but without it a change to the archive is
+only detected through the size and the CRC. Failing to write the index file is not an error.
+
+By default, looking up a file does a binary search at each level of the directory structure. If you
+have a lot of lookups against deep directory structures you can enable a hash table of full paths so
+that each lookup is a single probe:
+
+    zipConfig.usePathHashTable = FS_TRUE;
+
+This uses an extra 8 bytes per file and directory, plus 8 bytes for each slot in the table.
+
+Seeking within a compressed file normally requires decompressing everything between the start of
+the file (or the current position when seeking forward) and the seek target. If you do a lot of
+random access into large compressed files you can have seek points recorded while the file is being
+read:
+
+    zipConfig.seekPointInterval = 1024*1024;
+
+A seek point is recorded at most once every seekPointInterval bytes of uncompressed data. Seeking will
+then resume decompression from the nearest seek point before the target. Seek points are only
+recorded for parts of the file that have actually been read, and are kept for the lifetime of the
+archive so they can be used again when the file is reopened. Each seek point holds a copy of the
+uncompressed cache (64KB by default) which is used as the decompressor's window, plus the state of
+the decompressor including its Huffman tables, which is about another 20KB on 64-bit builds.
+
+Seek points are only kept in memory and are not stored in the index file. Their size means the index
+file would grow by tens of kilobytes per seek point, and the decompressor state is an internal layout
+which differs between 32-bit and 64-bit builds, so it can't be shared between builds the way the rest
+of the index file can. They are rebuilt as files are read again after the archive is reopened.
+
+The CRC-32 of each file is not checked by default. To have it checked you can do this:
+
+    zipConfig.verifyChecksums = FS_TRUE;
+
+The CRC-32 is computed as the data is read, and once the end of the file has been reached it will be
+compared against the value stored in the archive. If they don't match, reads that reach the end of
+the file will return FS_CHECKSUM_MISMATCH. The data will still have been output. Seeking does not get
+in the way of the check. Data that is skipped over by seeking forward is still checksummed: compressed
+files need to decompress it anyway, and for stored files it's read from the archive on the next read.
+This means that while a file is being checked, seek points past the data that has been checksummed so
+far are not used, and reading after seeking forward in a stored file costs as much as reading the
+data that was skipped.
+
+Each opened file has a cache of compressed data read from the archive, and a cache of uncompressed
+data which is also used as the window for the decompressor. By default these are 4KB and 64KB. If
+the archive is on slow storage a 4KB compressed cache will result in a lot of small reads so you may
+want to make it bigger:
+
+    zipConfig.compressedCacheSize   = 256*1024;
+    zipConfig.uncompressedCacheSize = 256*1024;
+
+The uncompressed cache will be rounded up to a power of two and cannot be less than 64KB. A bigger
+uncompressed cache means fewer calls into the decompressor for small reads, but note that each seek
+point is a copy of it. Stored files use the memory of both caches as a single read cache. Each opened
+file costs the sum of these two sizes.
+
+A big compressed cache is wasteful if you're only reading a little bit of data after each seek. You
+can enable adaptive mode which will start with small reads from the archive and double the size each
+time the compressed cache is refilled, up to compressedCacheSize. Seeking resets it.
+
+    zipConfig.adaptiveReadSize = FS_TRUE;
+
+New archives can be created by setting the write option. The stream needs to be writable, and the
+archive is written from wherever the stream currently is:
+
+    fs_file* pNewArchiveFile;
+    fs_file_open(pFS, "new.zip", FS_WRITE | FS_TRUNCATE, &pNewArchiveFile);
+
+    fs_zip_config zipConfig = fs_zip_config_init();
+    zipConfig.write = FS_TRUE;
+
+    fs_config fsConfig = fs_config_init(FS_ZIP, &zipConfig, fs_file_get_stream(pNewArchiveFile));
+
+    fs* pZip;
+    fs_init(&fsConfig, &pZip);
+
+    fs_file* pFileInsideZip;
+    fs_file_open(pZip, "dir/file.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFileInsideZip);
+    fs_file_write(pFileInsideZip, pData, dataSize, NULL);
+    fs_file_close(pFileInsideZip);
+
+    ...
+
+    fs_uninit(pZip);    // Writes the central directory.
+    fs_file_close(pNewArchiveFile);
+
+File data is written straight to the stream as it comes in which means only one file can be written at
+a time. Trying to open another file, or create a directory, while a file is being written will fail
+with FS_BUSY. Files that have already been written can't be opened again, and none of the files in the
+archive can be read until it has been uninitialized and opened again normally. Parent directories are
+added as entries automatically unless FS_NO_CREATE_DIRS is used. The archiveModifiedTime option is
+used as the modified time of each entry, and if it's 0 the earliest possible time is used so that
+building the same archive twice gives the same output.
+
+The central directory is written by fs_uninit(). Neither that nor fs_file_close() can return an error,
+so if the stream fails at that point the archive will be left corrupt. Use fs_file_flush() before
+closing a file if you need to know that its data made it to the stream. ZIP64 records are used
+automatically when a size or offset is 0xFFFFFFFF bytes or more, or when there are 65535 or more
+entries.
+
+Files are stored without compression by default. Set the compressionLevel option to a value from 1 to 9
+to compress them with DEFLATE, where 1 is the fastest and 9 gives the smallest output:
+
+    zipConfig.write            = FS_TRUE;
+    zipConfig.compressionLevel = 6;
+    zipConfig.threadCount      = 8;
+
+Compression is done in parallel using threadCount threads. The data of each file is split into 128KB
+chunks, with each chunk using the end of the previous one as its dictionary so very little is lost
+compared to compressing the file in one go. Small files are gathered together into the same batch so
+they're compressed in parallel as well. The data is held in memory until a full batch of chunks is
+ready so it won't necessarily be in the stream straight after fs_file_write(). Use fs_file_flush()
+if you need it to be, but note that this adds a few bytes of padding to the file's compressed data.
 */
 #ifndef fs_zip_h
 #define fs_zip_h
@@ -42,6 +178,24 @@ extern "C" {
 #endif
 
 /* BEG fs_zip.h */
+typedef struct fs_zip_config
+{
+    int threadCount;                /* The number of threads to use when building the index, or when compressing files. Set to 0 or 1 to do everything on the calling thread. */
+    fs* pIndexFS;                   /* The file system to load and save the index file with. Can be NULL to use the native file system. */
+    const char* pIndexFilePath;     /* The path of the index file. Set to NULL to disable the index file. */
+    fs_uint64 archiveModifiedTime;  /* The modified time of the archive. Used to detect when the index file is out of date. Optional. */
+    fs_bool32 usePathHashTable;     /* Build a hash table of every path in the archive for faster lookups at the cost of some extra memory. */
+    size_t seekPointInterval;       /* The minimum number of uncompressed bytes between seek points in compressed files. Set to 0 to disable seek points. */
+    fs_bool32 verifyChecksums;      /* Check the CRC-32 of each file when it has been read to the end. Reading will return FS_CHECKSUM_MISMATCH on failure. */
+    size_t uncompressedCacheSize;   /* The size of the uncompressed cache of each file. Rounded up to a power of two, with a minimum of 64KB. Set to 0 to use the default. */
+    size_t compressedCacheSize;     /* The size of the compressed cache of each file. This is the maximum number of bytes read from the archive at a time. Set to 0 to use the default of 4KB. */
+    fs_bool32 adaptiveReadSize;     /* Start with small reads from the archive and grow them up to compressedCacheSize while a file is read sequentially. */
+    fs_bool32 write;                /* Create a new archive by writing to the stream instead of reading an existing one. */
+    int compressionLevel;           /* The DEFLATE compression level from 1 to 9 to use for files when writing. Set to 0 to store files without compression. */
+} fs_zip_config;
+
+FS_API fs_zip_config fs_zip_config_init(void);
+
 extern const fs_backend* FS_ZIP;
 /* END fs_zip.h */
 
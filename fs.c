@@ -830,6 +830,7 @@ code. These are the differences:
     * c89thrd_error is FS_ERROR
     * c89thrd_busy is FS_BUSY
     * c89thrd_pthread_* is fs_pthread_*
+    * fs_rwlock has no c89thread equivalent.
 
 Parameter ordering is the same as c89thread to make amalgamation easier.
 */
@@ -1154,6 +1155,400 @@ FS_API fs_result fs_mtx_unlock(fs_mtx* mutex)
 }
 #endif
 /* END fs_thread_mtx.c */
+
+/* BEG fs_thread_rwlock.c */
+#if defined(FS_WIN32) && !defined(FS_USE_PTHREAD)
+FS_API fs_result fs_rwlock_init(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    InitializeSRWLock((PSRWLOCK)rwlock);
+
+    return FS_SUCCESS;
+}
+
+FS_API void fs_rwlock_destroy(fs_rwlock* rwlock)
+{
+    /* SRW locks don't need to be destroyed. */
+    (void)rwlock;
+}
+
+FS_API fs_result fs_rwlock_lock_read(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    AcquireSRWLockShared((PSRWLOCK)rwlock);
+
+    return FS_SUCCESS;
+}
+
+FS_API fs_result fs_rwlock_unlock_read(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    ReleaseSRWLockShared((PSRWLOCK)rwlock);
+
+    return FS_SUCCESS;
+}
+
+FS_API fs_result fs_rwlock_lock_write(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    AcquireSRWLockExclusive((PSRWLOCK)rwlock);
+
+    return FS_SUCCESS;
+}
+
+FS_API fs_result fs_rwlock_unlock_write(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    ReleaseSRWLockExclusive((PSRWLOCK)rwlock);
+
+    return FS_SUCCESS;
+}
+#else
+FS_API fs_result fs_rwlock_init(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    #ifdef FS_USE_MANUAL_RWLOCK
+    {
+        if (fs_result_from_pthread(pthread_mutex_init(&rwlock->mutex, NULL)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        if (fs_result_from_pthread(pthread_cond_init(&rwlock->cond, NULL)) != FS_SUCCESS) {
+            pthread_mutex_destroy(&rwlock->mutex);
+            return FS_ERROR;
+        }
+
+        rwlock->readerCount        = 0;
+        rwlock->writerCount        = 0;
+        rwlock->waitingWriterCount = 0;
+
+        return FS_SUCCESS;
+    }
+    #else
+    {
+        if (fs_result_from_pthread(pthread_rwlock_init((pthread_rwlock_t*)rwlock, NULL)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        return FS_SUCCESS;
+    }
+    #endif
+}
+
+FS_API void fs_rwlock_destroy(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return;
+    }
+
+    #ifdef FS_USE_MANUAL_RWLOCK
+    {
+        pthread_cond_destroy(&rwlock->cond);
+        pthread_mutex_destroy(&rwlock->mutex);
+    }
+    #else
+    {
+        pthread_rwlock_destroy((pthread_rwlock_t*)rwlock);
+    }
+    #endif
+}
+
+FS_API fs_result fs_rwlock_lock_read(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    #ifdef FS_USE_MANUAL_RWLOCK
+    {
+        if (fs_result_from_pthread(pthread_mutex_lock(&rwlock->mutex)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        while (rwlock->writerCount > 0 || rwlock->waitingWriterCount > 0) {
+            pthread_cond_wait(&rwlock->cond, &rwlock->mutex);
+        }
+
+        rwlock->readerCount += 1;
+
+        pthread_mutex_unlock(&rwlock->mutex);
+
+        return FS_SUCCESS;
+    }
+    #else
+    {
+        if (fs_result_from_pthread(pthread_rwlock_rdlock((pthread_rwlock_t*)rwlock)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        return FS_SUCCESS;
+    }
+    #endif
+}
+
+FS_API fs_result fs_rwlock_unlock_read(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    #ifdef FS_USE_MANUAL_RWLOCK
+    {
+        if (fs_result_from_pthread(pthread_mutex_lock(&rwlock->mutex)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        if (rwlock->readerCount == 0) {
+            pthread_mutex_unlock(&rwlock->mutex);
+            return FS_ERROR;    /* Not locked for reading. */
+        }
+
+        rwlock->readerCount -= 1;
+
+        /* Only a writer can be waiting on a reader. */
+        if (rwlock->readerCount == 0 && rwlock->waitingWriterCount > 0) {
+            pthread_cond_broadcast(&rwlock->cond);
+        }
+
+        pthread_mutex_unlock(&rwlock->mutex);
+
+        return FS_SUCCESS;
+    }
+    #else
+    {
+        if (fs_result_from_pthread(pthread_rwlock_unlock((pthread_rwlock_t*)rwlock)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        return FS_SUCCESS;
+    }
+    #endif
+}
+
+FS_API fs_result fs_rwlock_lock_write(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    #ifdef FS_USE_MANUAL_RWLOCK
+    {
+        if (fs_result_from_pthread(pthread_mutex_lock(&rwlock->mutex)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        rwlock->waitingWriterCount += 1;
+
+        while (rwlock->writerCount > 0 || rwlock->readerCount > 0) {
+            pthread_cond_wait(&rwlock->cond, &rwlock->mutex);
+        }
+
+        rwlock->waitingWriterCount -= 1;
+        rwlock->writerCount = 1;
+
+        pthread_mutex_unlock(&rwlock->mutex);
+
+        return FS_SUCCESS;
+    }
+    #else
+    {
+        if (fs_result_from_pthread(pthread_rwlock_wrlock((pthread_rwlock_t*)rwlock)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        return FS_SUCCESS;
+    }
+    #endif
+}
+
+FS_API fs_result fs_rwlock_unlock_write(fs_rwlock* rwlock)
+{
+    if (rwlock == NULL) {
+        return FS_ERROR;
+    }
+
+    #ifdef FS_USE_MANUAL_RWLOCK
+    {
+        if (fs_result_from_pthread(pthread_mutex_lock(&rwlock->mutex)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        if (rwlock->writerCount == 0) {
+            pthread_mutex_unlock(&rwlock->mutex);
+            return FS_ERROR;    /* Not locked for writing. */
+        }
+
+        rwlock->writerCount = 0;
+
+        /* Both readers and writers could be waiting. */
+        pthread_cond_broadcast(&rwlock->cond);
+
+        pthread_mutex_unlock(&rwlock->mutex);
+
+        return FS_SUCCESS;
+    }
+    #else
+    {
+        if (fs_result_from_pthread(pthread_rwlock_unlock((pthread_rwlock_t*)rwlock)) != FS_SUCCESS) {
+            return FS_ERROR;
+        }
+
+        return FS_SUCCESS;
+    }
+    #endif
+}
+#endif
+/* END fs_thread_rwlock.c */
+
+/* BEG fs_thread_thrd.c */
+/*
+The start routine for pthread and Win32 threads have a different signature to our own so we need to go
+through a trampoline. The start data is allocated on the heap and is freed by the new thread, which is
+why it carries its own copy of the allocation callbacks.
+*/
+typedef struct
+{
+    fs_thrd_start_t func;
+    void* arg;
+    fs_allocation_callbacks allocationCallbacks;
+} fs_thrd_start_data;
+
+#if defined(FS_WIN32) && !defined(FS_USE_PTHREAD)
+static DWORD WINAPI fs_thrd_entry_proc_win32(LPVOID pData)
+{
+    fs_thrd_start_data startData = *(fs_thrd_start_data*)pData;
+    fs_free(pData, &startData.allocationCallbacks);
+
+    return (DWORD)startData.func(startData.arg);
+}
+
+FS_API fs_result fs_thrd_create(fs_thrd* thr, fs_thrd_start_t func, void* arg, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    HANDLE hThread;
+    fs_thrd_start_data* pStartData;
+
+    if (thr == NULL) {
+        return FS_ERROR;
+    }
+
+    *thr = NULL;
+
+    if (func == NULL) {
+        return FS_ERROR;
+    }
+
+    pStartData = (fs_thrd_start_data*)fs_malloc(sizeof(*pStartData), pAllocationCallbacks);
+    if (pStartData == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    pStartData->func = func;
+    pStartData->arg  = arg;
+    pStartData->allocationCallbacks = fs_allocation_callbacks_init_copy(pAllocationCallbacks);
+
+    hThread = CreateThread(NULL, 0, fs_thrd_entry_proc_win32, pStartData, 0, NULL);
+    if (hThread == NULL) {
+        fs_free(pStartData, pAllocationCallbacks);
+        return fs_result_from_GetLastError();
+    }
+
+    *thr = (fs_thrd)hThread;
+
+    return FS_SUCCESS;
+}
+
+FS_API fs_result fs_thrd_join(fs_thrd thr, int* res)
+{
+    DWORD exitCode;
+
+    if (WaitForSingleObject((HANDLE)thr, INFINITE) != WAIT_OBJECT_0) {
+        return FS_ERROR;
+    }
+
+    if (res != NULL) {
+        if (GetExitCodeThread((HANDLE)thr, &exitCode)) {
+            *res = (int)exitCode;
+        } else {
+            *res = 0;
+        }
+    }
+
+    CloseHandle((HANDLE)thr);
+
+    return FS_SUCCESS;
+}
+#else
+static void* fs_thrd_entry_proc_pthread(void* pData)
+{
+    fs_thrd_start_data startData = *(fs_thrd_start_data*)pData;
+    fs_free(pData, &startData.allocationCallbacks);
+
+    return (void*)(fs_intptr)startData.func(startData.arg);
+}
+
+FS_API fs_result fs_thrd_create(fs_thrd* thr, fs_thrd_start_t func, void* arg, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_result result;
+    fs_thrd_start_data* pStartData;
+
+    if (thr == NULL || func == NULL) {
+        return FS_ERROR;
+    }
+
+    pStartData = (fs_thrd_start_data*)fs_malloc(sizeof(*pStartData), pAllocationCallbacks);
+    if (pStartData == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    pStartData->func = func;
+    pStartData->arg  = arg;
+    pStartData->allocationCallbacks = fs_allocation_callbacks_init_copy(pAllocationCallbacks);
+
+    result = fs_result_from_pthread(pthread_create((pthread_t*)thr, NULL, fs_thrd_entry_proc_pthread, pStartData));
+    if (result != FS_SUCCESS) {
+        fs_free(pStartData, pAllocationCallbacks);
+        return result;
+    }
+
+    return FS_SUCCESS;
+}
+
+FS_API fs_result fs_thrd_join(fs_thrd thr, int* res)
+{
+    fs_result result;
+    void* pExitCode;
+
+    result = fs_result_from_pthread(pthread_join((pthread_t)thr, &pExitCode));
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    if (res != NULL) {
+        *res = (int)(fs_intptr)pExitCode;
+    }
+
+    return FS_SUCCESS;
+}
+#endif
+/* END fs_thread_thrd.c */
 /* END fs_thread.c */
 
 
@@ -1347,6 +1742,90 @@ FS_API fs_result fs_stream_tell(fs_stream* pStream, fs_int64* pCursor)
     return pStream->pVTable->tell(pStream, pCursor);
 }
 
+FS_API fs_result fs_stream_read_at(fs_stream* pStream, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    size_t bytesRead;
+    fs_result result;
+
+    if (pBytesRead != NULL) {
+        *pBytesRead = 0;
+    }
+
+    if (pStream == NULL || offset < 0) {
+        return FS_INVALID_ARGS;
+    }
+
+    if (pStream->pVTable->read_at == NULL) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    bytesRead = 0;
+    result = pStream->pVTable->read_at(pStream, offset, pDst, bytesToRead, &bytesRead);
+
+    if (pBytesRead != NULL) {
+        *pBytesRead = bytesRead;
+    } else {
+        /* Same as fs_stream_read(). If the caller can't see the number of bytes read it needs to be exact. */
+        if (result == FS_SUCCESS && bytesRead != bytesToRead) {
+            result = FS_ERROR;
+        }
+    }
+
+    return result;
+}
+
+FS_API fs_result fs_stream_write_at(fs_stream* pStream, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    size_t bytesWritten;
+    fs_result result;
+
+    if (pBytesWritten != NULL) {
+        *pBytesWritten = 0;
+    }
+
+    if (pStream == NULL || offset < 0) {
+        return FS_INVALID_ARGS;
+    }
+
+    if (pStream->pVTable->write_at == NULL) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    bytesWritten = 0;
+    result = pStream->pVTable->write_at(pStream, offset, pSrc, bytesToWrite, &bytesWritten);
+
+    if (pBytesWritten != NULL) {
+        *pBytesWritten = bytesWritten;
+    } else {
+        if (result == FS_SUCCESS && bytesWritten != bytesToWrite) {
+            result = FS_ERROR;
+        }
+    }
+
+    return result;
+}
+
+FS_API fs_result fs_stream_map(fs_stream* pStream, const void** ppData, size_t* pDataSize)
+{
+    if (ppData != NULL) {
+        *ppData = NULL;
+    }
+
+    if (pDataSize != NULL) {
+        *pDataSize = 0;
+    }
+
+    if (pStream == NULL || ppData == NULL || pDataSize == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    if (pStream->pVTable->map == NULL) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    return pStream->pVTable->map(pStream, ppData, pDataSize);
+}
+
 FS_API fs_result fs_stream_duplicate(fs_stream* pStream, const fs_allocation_callbacks* pAllocationCallbacks, fs_stream** ppDuplicatedStream)
 {
     fs_result result;
@@ -1402,7 +1881,175 @@ FS_API void fs_stream_delete_duplicate(fs_stream* pDuplicatedStream, const fs_al
 }
 
 
+/*
+A shared stream is a lightweight stand-in for a duplicated stream. It has its own cursor, but all
+reading is done with positional reads on the source stream. It's used for giving each file opened
+from an archive its own stream without needing to duplicate the archive's stream which, for a file
+stream, would mean opening another file descriptor. The source stream must outlive the shared stream.
+*/
+typedef struct fs_stream_shared
+{
+    fs_stream base;
+    fs_stream* pSource;
+    fs_int64 cursor;
+} fs_stream_shared;
+
+static fs_result fs_stream_shared_read(fs_stream* pStream, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    fs_stream_shared* pSharedStream = (fs_stream_shared*)pStream;
+    fs_result result;
+
+    result = fs_stream_read_at(pSharedStream->pSource, pSharedStream->cursor, pDst, bytesToRead, pBytesRead);
+    pSharedStream->cursor += (fs_int64)*pBytesRead;
+
+    return result;
+}
+
+static fs_result fs_stream_shared_seek(fs_stream* pStream, fs_int64 offset, fs_seek_origin origin)
+{
+    fs_stream_shared* pSharedStream = (fs_stream_shared*)pStream;
+    fs_int64 newCursor;
+
+    if (origin == FS_SEEK_SET) {
+        newCursor = offset;
+    } else if (origin == FS_SEEK_CUR) {
+        newCursor = pSharedStream->cursor + offset;
+    } else {
+        /*
+        We need the size of the source stream for this which we can only get by seeking it. Positional
+        reads don't use the source's cursor so this won't affect any other shared streams. This is not
+        used by any of the standard archive backends when reading files so it should be rare.
+        */
+        fs_result result;
+        fs_int64 sourceCursor;
+        fs_int64 sourceSize;
+
+        result = fs_stream_tell(pSharedStream->pSource, &sourceCursor);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        result = fs_stream_seek(pSharedStream->pSource, 0, FS_SEEK_END);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        result = fs_stream_tell(pSharedStream->pSource, &sourceSize);
+        fs_stream_seek(pSharedStream->pSource, sourceCursor, FS_SEEK_SET);
+
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        newCursor = sourceSize + offset;
+    }
+
+    if (newCursor < 0) {
+        return FS_BAD_SEEK;
+    }
+
+    pSharedStream->cursor = newCursor;
+
+    return FS_SUCCESS;
+}
+
+static fs_result fs_stream_shared_tell(fs_stream* pStream, fs_int64* pCursor)
+{
+    *pCursor = ((fs_stream_shared*)pStream)->cursor;
+    return FS_SUCCESS;
+}
+
+static size_t fs_stream_shared_duplicate_alloc_size(fs_stream* pStream)
+{
+    (void)pStream;
+    return sizeof(fs_stream_shared);
+}
+
+static fs_result fs_stream_shared_duplicate(fs_stream* pStream, fs_stream* pDuplicatedStream)
+{
+    *(fs_stream_shared*)pDuplicatedStream = *(fs_stream_shared*)pStream;
+    return FS_SUCCESS;
+}
+
+static fs_result fs_stream_shared_read_at(fs_stream* pStream, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    return fs_stream_read_at(((fs_stream_shared*)pStream)->pSource, offset, pDst, bytesToRead, pBytesRead);
+}
+
+static fs_result fs_stream_shared_map(fs_stream* pStream, const void** ppData, size_t* pDataSize)
+{
+    return fs_stream_map(((fs_stream_shared*)pStream)->pSource, ppData, pDataSize);
+}
+
+static fs_stream_vtable fs_stream_shared_vtable =
+{
+    fs_stream_shared_read,
+    NULL,   /* write */
+    fs_stream_shared_seek,
+    fs_stream_shared_tell,
+    fs_stream_shared_duplicate_alloc_size,
+    fs_stream_shared_duplicate,
+    NULL,   /* uninit */
+    fs_stream_shared_read_at,
+    NULL,   /* write_at */
+    fs_stream_shared_map
+};
+
+static fs_bool32 fs_stream_supports_read_at(fs_stream* pStream)
+{
+    fs_result result;
+    char dummy;
+    size_t bytesRead;
+
+    if (pStream == NULL || pStream->pVTable->read_at == NULL) {
+        return FS_FALSE;
+    }
+
+    /*
+    The vtable might implement read_at, but it could still fail at runtime depending on the type of the
+    underlying object (a pipe can't do a positional read, for example). Do an empty read to find out.
+    */
+    result = fs_stream_read_at(pStream, 0, &dummy, 0, &bytesRead);
+
+    return result == FS_SUCCESS || result == FS_AT_END;
+}
+
+/*
+Creates a stream for the exclusive use of a single file. If the source stream supports positional reads
+this will be a shared stream, otherwise it'll be a full duplicate. Delete with fs_stream_delete_duplicate().
+*/
+static fs_result fs_stream_duplicate_or_share(fs_stream* pStream, fs_bool32 canShare, const fs_allocation_callbacks* pAllocationCallbacks, fs_stream** ppDuplicatedStream)
+{
+    fs_stream_shared* pSharedStream;
+
+    if (!canShare) {
+        return fs_stream_duplicate(pStream, pAllocationCallbacks, ppDuplicatedStream);
+    }
+
+    FS_ASSERT(ppDuplicatedStream != NULL);
+
+    pSharedStream = (fs_stream_shared*)fs_malloc(sizeof(*pSharedStream), pAllocationCallbacks);
+    if (pSharedStream == NULL) {
+        *ppDuplicatedStream = NULL;
+        return FS_OUT_OF_MEMORY;
+    }
+
+    fs_stream_init(&fs_stream_shared_vtable, &pSharedStream->base);
+    pSharedStream->pSource = pStream;
+    pSharedStream->cursor  = 0;
+
+    *ppDuplicatedStream = &pSharedStream->base;
+
+    return FS_SUCCESS;
+}
+
+
 FS_API fs_result fs_stream_read_to_end(fs_stream* pStream, fs_format format, const fs_allocation_callbacks* pAllocationCallbacks, void** ppData, size_t* pDataSize)
+{
+    return fs_stream_read_to_end_ex(pStream, format, 0, pAllocationCallbacks, ppData, pDataSize);
+}
+
+FS_API fs_result fs_stream_read_to_end_ex(fs_stream* pStream, fs_format format, fs_uint64 sizeHint, const fs_allocation_callbacks* pAllocationCallbacks, void** ppData, size_t* pDataSize)
 {
     fs_result result = FS_SUCCESS;
     size_t dataSize = 0;
@@ -1420,18 +2067,29 @@ FS_API fs_result fs_stream_read_to_end(fs_stream* pStream, fs_format format, con
         return FS_INVALID_ARGS;
     }
 
-    /* Read in a loop into a dynamically increasing buffer. */
-    for (;;) {
-        size_t chunkSize = 4096;
-        size_t bytesRead;
+    /*
+    When we have a size hint we can allocate the whole buffer up front. The extra byte is so we can detect the end
+    of the stream without needing to grow the buffer, and it doubles as room for the null terminator in text mode.
+    If the hint cannot be represented as a size_t we just ignore it and let the buffer grow as normal.
+    */
+    if (sizeHint > 0 && (fs_uint64)(size_t)sizeHint == sizeHint && (size_t)sizeHint < FS_SIZE_MAX) {
+        dataCap = (size_t)sizeHint + 1;
 
-        /* Prevent a size_t overflow. Should never happen in practice because the system would reach an out-of-memory state before hitting this, but checking anyway for completeness. */
-        if (FS_SIZE_MAX - dataSize < chunkSize) {
-            fs_free(pData, pAllocationCallbacks);
-            return FS_TOO_BIG;
+        pData = fs_malloc(dataCap, pAllocationCallbacks);
+        if (pData == NULL) {
+            return FS_OUT_OF_MEMORY;
         }
+    }
+
+    /*
+    Read in a loop into a dynamically increasing buffer. Each read fills whatever space is left in the buffer, and
+    the buffer is doubled in size when it fills up. We only stop when the stream tells us there's nothing left to
+    read, rather than on a short read, since reads are allowed to return less than requested before the end.
+    */
+    for (;;) {
+        size_t bytesRead;
 
-        if (dataSize + chunkSize > dataCap) {
+        if (dataSize == dataCap) {
             void* pNewData;
             size_t newCap;
 
@@ -1447,7 +2105,7 @@ FS_API fs_result fs_stream_read_to_end(fs_stream* pStream, fs_format format, con
             }
 
             if (newCap == 0) {
-                newCap = chunkSize;
+                newCap = 4096;
             }
 
             pNewData = fs_realloc(pData, newCap, pAllocationCallbacks);
@@ -1460,11 +2118,10 @@ FS_API fs_result fs_stream_read_to_end(fs_stream* pStream, fs_format format, con
             dataCap = newCap;
         }
 
-        /* At this point there should be enough data in the buffer for the next chunk. */
-        result = fs_stream_read(pStream, FS_OFFSET_PTR(pData, dataSize), chunkSize, &bytesRead);
+        result = fs_stream_read(pStream, FS_OFFSET_PTR(pData, dataSize), dataCap - dataSize, &bytesRead);
         dataSize += bytesRead;
 
-        if (result != FS_SUCCESS || bytesRead < chunkSize) {
+        if (result != FS_SUCCESS || bytesRead == 0) {
             break;
         }
     }
@@ -1584,54 +2241,96 @@ static fs_result fs_backend_info(const fs_backend* pBackend, fs* pFS, const char
 {
     FS_ASSERT(pBackend != NULL);
 
-    if (pBackend->info == NULL) {
+    if (pBackend->info == NULL) {
+        return FS_NOT_IMPLEMENTED;
+    } else {
+        return pBackend->info(pFS, pPath, openMode, pInfo);
+    }
+}
+
+static size_t fs_backend_file_alloc_size(const fs_backend* pBackend, fs* pFS)
+{
+    FS_ASSERT(pBackend != NULL);
+
+    if (pBackend->file_alloc_size == NULL) {
+        return 0;
+    } else {
+        return pBackend->file_alloc_size(pFS);
+    }
+}
+
+static fs_result fs_backend_file_open(const fs_backend* pBackend, fs* pFS, fs_stream* pStream, const char* pFilePath, int openMode, fs_file* pFile)
+{
+    FS_ASSERT(pBackend != NULL);
+
+    if (pBackend->file_open == NULL) {
+        return FS_NOT_IMPLEMENTED;
+    } else {
+        return pBackend->file_open(pFS, pStream, pFilePath, openMode, pFile);
+    }
+}
+
+static void fs_backend_file_close(const fs_backend* pBackend, fs_file* pFile)
+{
+    FS_ASSERT(pBackend != NULL);
+
+    if (pBackend->file_close == NULL) {
+        return;
+    } else {
+        pBackend->file_close(pFile);
+    }
+}
+
+static fs_result fs_backend_file_read(const fs_backend* pBackend, fs_file* pFile, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    FS_ASSERT(pBackend != NULL);
+
+    if (pBackend->file_read == NULL) {
         return FS_NOT_IMPLEMENTED;
     } else {
-        return pBackend->info(pFS, pPath, openMode, pInfo);
+        return pBackend->file_read(pFile, pDst, bytesToRead, pBytesRead);
     }
 }
 
-static size_t fs_backend_file_alloc_size(const fs_backend* pBackend, fs* pFS)
+static fs_result fs_backend_file_read_at(const fs_backend* pBackend, fs_file* pFile, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
 {
     FS_ASSERT(pBackend != NULL);
 
-    if (pBackend->file_alloc_size == NULL) {
-        return 0;
+    if (pBackend->file_read_at == NULL) {
+        return FS_NOT_IMPLEMENTED;
     } else {
-        return pBackend->file_alloc_size(pFS);
+        return pBackend->file_read_at(pFile, offset, pDst, bytesToRead, pBytesRead);
     }
 }
 
-static fs_result fs_backend_file_open(const fs_backend* pBackend, fs* pFS, fs_stream* pStream, const char* pFilePath, int openMode, fs_file* pFile)
+static fs_result fs_backend_file_write_at(const fs_backend* pBackend, fs_file* pFile, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
 {
     FS_ASSERT(pBackend != NULL);
 
-    if (pBackend->file_open == NULL) {
+    if (pBackend->file_write_at == NULL) {
         return FS_NOT_IMPLEMENTED;
     } else {
-        return pBackend->file_open(pFS, pStream, pFilePath, openMode, pFile);
+        return pBackend->file_write_at(pFile, offset, pSrc, bytesToWrite, pBytesWritten);
     }
 }
 
-static void fs_backend_file_close(const fs_backend* pBackend, fs_file* pFile)
+static fs_result fs_backend_file_map(const fs_backend* pBackend, fs_file* pFile, const void** ppData, size_t* pDataSize)
 {
     FS_ASSERT(pBackend != NULL);
 
-    if (pBackend->file_close == NULL) {
-        return;
+    if (pBackend->file_map == NULL) {
+        return FS_NOT_IMPLEMENTED;
     } else {
-        pBackend->file_close(pFile);
+        return pBackend->file_map(pFile, ppData, pDataSize);
     }
 }
 
-static fs_result fs_backend_file_read(const fs_backend* pBackend, fs_file* pFile, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+static void fs_backend_file_unmap(const fs_backend* pBackend, fs_file* pFile, const void* pData, size_t dataSize)
 {
     FS_ASSERT(pBackend != NULL);
 
-    if (pBackend->file_read == NULL) {
-        return FS_NOT_IMPLEMENTED;
-    } else {
-        return pBackend->file_read(pFile, pDst, bytesToRead, pBytesRead);
+    if (pBackend->file_unmap != NULL) {
+        pBackend->file_unmap(pFile, pData, dataSize);
     }
 }
 
@@ -1712,16 +2411,21 @@ static fs_result fs_backend_file_duplicate(const fs_backend* pBackend, fs_file*
     }
 }
 
-static fs_iterator* fs_backend_first(const fs_backend* pBackend, fs* pFS, const char* pDirectoryPath, size_t directoryPathLen)
+static fs_iterator* fs_backend_first(const fs_backend* pBackend, fs* pFS, const char* pDirectoryPath, size_t directoryPathLen, int mode)
 {
     FS_ASSERT(pBackend != NULL);
 
-    if (pBackend->first == NULL) {
+    if (pBackend->first == NULL && pBackend->first_ex == NULL) {
         return NULL;
     } else {
         fs_iterator* pIterator;
         
-        pIterator = pBackend->first(pFS, pDirectoryPath, directoryPathLen);
+        /* first_ex is optional. Backends that don't have it can't do anything with the mode anyway. */
+        if (pBackend->first_ex != NULL) {
+            pIterator = pBackend->first_ex(pFS, pDirectoryPath, directoryPathLen, mode);
+        } else {
+            pIterator = pBackend->first(pFS, pDirectoryPath, directoryPathLen);
+        }
         
         /* Just make double sure the FS information is set in case the backend doesn't do it. */
         if (pIterator != NULL) {
@@ -1803,6 +2507,25 @@ typedef struct fs_opened_archive
     char pPath[1];
 } fs_opened_archive;
 
+typedef struct fs_opened_archive_slot
+{
+    size_t offset;      /* Offset of the entry in pOpenedArchives, plus one. Zero means the slot is empty. */
+    fs_uint32 hash;
+} fs_opened_archive_slot;
+
+typedef struct fs_resolution_cache_entry
+{
+    fs_uint32 hash;
+    int openMode;
+    fs_bool32 isInfo;                   /* Whether or not the lookup was done by fs_info(). Info can succeed for directories where opening cannot. */
+    const fs_backend* pBackend;         /* Set to null for negative entries, meaning the path could not be found in any archive. */
+    const void* pBackendConfig;
+    size_t pathLen;
+    size_t archivePathLen;
+    size_t innerPathOffset;             /* The offset of the path inside the archive, relative to the start of the full path. */
+    /* [path][null-terminator][archive path][null-terminator] */
+} fs_resolution_cache_entry;
+
 typedef struct fs_mount_point
 {
     size_t pathOff;                     /* Points to a null terminated string containing the mounted path starting from the first byte after this struct. */
@@ -1820,6 +2543,7 @@ struct fs
 {
     const fs_backend* pBackend;
     fs_stream* pStream;
+    fs_bool32 isStreamShareable;    /* When set, pStream supports positional reads and files can share it rather than duplicating it. */
     fs_allocation_callbacks allocationCallbacks;
     void* pArchiveTypes;    /* One heap allocation containing all extension registrations. Needs to be parsed in order to enumerate them. Structure is [const fs_backend*][extension][null-terminator][padding (aligned to FS_SIZEOF_PTR)] */
     size_t archiveTypesAllocSize;
@@ -1828,9 +2552,14 @@ struct fs
     fs_on_refcount_changed_proc onRefCountChanged;
     void* pRefCountChangedUserData;
     fs_mtx archiveLock;     /* For use with fs_open_archive() and fs_close_archive(). */
-    void* pOpenedArchives;  /* One heap allocation. Structure is [fs*][refcount (size_t)][path][null-terminator][padding (aligned to FS_SIZEOF_PTR)] */
+    void* pOpenedArchives;  /* One heap allocation. Structure is [fs*][path][null-terminator][padding (aligned to FS_SIZEOF_PTR)] */
     size_t openedArchivesSize;
     size_t openedArchivesCap;
+    size_t openedArchivesCount;
+    fs_opened_archive_slot* pOpenedArchivesIndex;   /* Open-addressed hash table for finding an entry in pOpenedArchives by path. Capacity is always a power of two. */
+    size_t openedArchivesIndexCap;
+    fs_resolution_cache_entry** ppResolutionCache;  /* Maps a path to the archive it was found in when opening transparently. Protected by archiveLock. */
+    size_t resolutionCacheSize;
     size_t archiveGCThreshold;
     fs_mount_list* pReadMountPoints;
     fs_mount_list* pWriteMountPoints;
@@ -1842,8 +2571,11 @@ struct fs_file
 {
     fs_stream stream; /* Files are streams. This must be the first member so it can be cast. */
     fs* pFS;
-    fs_stream* pStreamForBackend;   /* The stream for use by the backend. Different to `stream`. This is a duplicate of the stream used by `pFS` so the backend can do reading. */
+    fs_stream* pStreamForBackend;   /* The stream for use by the backend. Different to `stream`. This is a duplicate (or a shared view if it supports positional reads) of the stream used by `pFS` so the backend can do reading. */
     size_t backendDataSize;
+    const void* pMappedData;        /* Set by fs_file_map(). */
+    size_t mappedDataSize;
+    fs_bool32 isMappingEmulated;    /* When set, pMappedData is a heap allocation rather than a mapping from the backend. */
 };
 
 typedef enum fs_mount_priority
@@ -2117,6 +2849,7 @@ typedef struct fs_registered_backend_iterator
 } fs_registered_backend_iterator;
 
 static fs_result fs_file_open_or_info(fs* pFS, const char* pFilePath, int openMode, fs_file** ppFile, fs_file_info* pInfo);
+static void fs_resolution_cache_clear(fs* pFS);
 static fs_result fs_next_registered_backend(fs_registered_backend_iterator* pIterator);
 
 static fs_result fs_first_registered_backend(fs* pFS, fs_registered_backend_iterator* pIterator)
@@ -2150,9 +2883,82 @@ static fs_result fs_next_registered_backend(fs_registered_backend_iterator* pIte
 
 
 
+static fs_uint32 fs_hash_path(const char* pPath, size_t pathLen)
+{
+    /* FNV-1a. This only needs to be good enough for a small hash table of paths. */
+    fs_uint32 hash = 2166136261U;
+    size_t i;
+
+    for (i = 0; i < pathLen; i += 1) {
+        hash ^= (fs_uint32)(unsigned char)pPath[i];
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+static size_t fs_opened_archive_sizeof(const fs_opened_archive* pOpenedArchive)
+{
+    return FS_ALIGN(sizeof(pOpenedArchive->pArchive) + strlen(pOpenedArchive->pPath) + 1, FS_SIZEOF_PTR);
+}
+
+static void fs_opened_archive_index_insert(fs_opened_archive_slot* pIndex, size_t indexCap, size_t offset, fs_uint32 hash)
+{
+    size_t mask = indexCap - 1;
+    size_t iSlot;
+
+    FS_ASSERT(indexCap > 0 && (indexCap & mask) == 0);
+
+    for (iSlot = hash & mask; pIndex[iSlot].offset != 0; iSlot = (iSlot + 1) & mask) {
+        /* Keep probing until we find an empty slot. */
+    }
+
+    pIndex[iSlot].offset = offset + 1;
+    pIndex[iSlot].hash   = hash;
+}
+
+static fs_result fs_opened_archive_index_reserve(fs* pFS, size_t count)
+{
+    fs_opened_archive_slot* pNewIndex;
+    size_t newIndexCap;
+    size_t iSlot;
+
+    FS_ASSERT(pFS != NULL);
+
+    /* We keep the load factor at or below 50% so probe sequences stay short. */
+    if (count * 2 <= pFS->openedArchivesIndexCap) {
+        return FS_SUCCESS;
+    }
+
+    newIndexCap = (pFS->openedArchivesIndexCap > 0) ? pFS->openedArchivesIndexCap : 16;
+    while (newIndexCap < count * 2) {
+        newIndexCap *= 2;
+    }
+
+    pNewIndex = (fs_opened_archive_slot*)fs_calloc(newIndexCap * sizeof(*pNewIndex), fs_get_allocation_callbacks(pFS));
+    if (pNewIndex == NULL) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    /* The hashes are stored in the old index so we don't need to rehash any strings when rebuilding. */
+    for (iSlot = 0; iSlot < pFS->openedArchivesIndexCap; iSlot += 1) {
+        if (pFS->pOpenedArchivesIndex[iSlot].offset != 0) {
+            fs_opened_archive_index_insert(pNewIndex, newIndexCap, pFS->pOpenedArchivesIndex[iSlot].offset - 1, pFS->pOpenedArchivesIndex[iSlot].hash);
+        }
+    }
+
+    fs_free(pFS->pOpenedArchivesIndex, fs_get_allocation_callbacks(pFS));
+    pFS->pOpenedArchivesIndex   = pNewIndex;
+    pFS->openedArchivesIndexCap = newIndexCap;
+
+    return FS_SUCCESS;
+}
+
 static fs_opened_archive* fs_find_opened_archive(fs* pFS, const char* pArchivePath, size_t archivePathLen)
 {
-    size_t cursor;
+    fs_uint32 hash;
+    size_t mask;
+    size_t iSlot;
 
     if (pFS == NULL) {
         return NULL;
@@ -2161,20 +2967,27 @@ static fs_opened_archive* fs_find_opened_archive(fs* pFS, const char* pArchivePa
     FS_ASSERT(pArchivePath != NULL);
     FS_ASSERT(archivePathLen != 0);
 
+    if (pFS->openedArchivesIndexCap == 0) {
+        return NULL;    /* Nothing has been opened yet. */
+    }
+
     if (archivePathLen == FS_NULL_TERMINATED) {
         archivePathLen = strlen(pArchivePath);
     }
 
-    cursor = 0;
-    while (cursor < pFS->openedArchivesSize) {
-        fs_opened_archive* pOpenedArchive = (fs_opened_archive*)FS_OFFSET_PTR(pFS->pOpenedArchives, cursor);
+    hash = fs_hash_path(pArchivePath, archivePathLen);
+    mask = pFS->openedArchivesIndexCap - 1;
 
-        if (strlen(pOpenedArchive->pPath) == archivePathLen && fs_strncmp(pOpenedArchive->pPath, pArchivePath, archivePathLen) == 0) {
-            return pOpenedArchive;
+    for (iSlot = hash & mask; pFS->pOpenedArchivesIndex[iSlot].offset != 0; iSlot = (iSlot + 1) & mask) {
+        if (pFS->pOpenedArchivesIndex[iSlot].hash == hash) {
+            fs_opened_archive* pOpenedArchive = (fs_opened_archive*)FS_OFFSET_PTR(pFS->pOpenedArchives, pFS->pOpenedArchivesIndex[iSlot].offset - 1);
+
+            if (fs_strncmp(pOpenedArchive->pPath, pArchivePath, archivePathLen) == 0 && pOpenedArchive->pPath[archivePathLen] == '\0') {
+                return pOpenedArchive;
+            }
         }
 
         /* Getting here means this archive is not the one we're looking for. */
-        cursor += FS_ALIGN(sizeof(pOpenedArchive->pArchive) + strlen(pOpenedArchive->pPath) + 1, FS_SIZEOF_PTR);
     }
 
     /* If we get here it means we couldn't find the archive by it's name. */
@@ -2211,6 +3024,7 @@ static fs_opened_archive* fs_find_opened_archive_by_fs(fs* pFS, fs* pArchive)
 
 static fs_result fs_add_opened_archive(fs* pFS, fs* pArchive, const char* pArchivePath, size_t archivePathLen)
 {
+    fs_result result;
     size_t openedArchiveSize;
     fs_opened_archive* pOpenedArchive;
 
@@ -2242,6 +3056,12 @@ static fs_result fs_add_opened_archive(fs* pFS, fs* pArchive, const char* pArchi
         pFS->openedArchivesCap = newOpenedArchivesCap;
     }
 
+    /* Make sure the index has room before we commit anything so we don't need to roll back the entry on failure. */
+    result = fs_opened_archive_index_reserve(pFS, pFS->openedArchivesCount + 1);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
     /* If we get here we should have enough room in the buffer to store the new archive details. */
     FS_ASSERT(pFS->openedArchivesSize + openedArchiveSize <= pFS->openedArchivesCap);
 
@@ -2249,7 +3069,10 @@ static fs_result fs_add_opened_archive(fs* pFS, fs* pArchive, const char* pArchi
     pOpenedArchive->pArchive = pArchive;
     fs_strncpy(pOpenedArchive->pPath, pArchivePath, archivePathLen);
 
-    pFS->openedArchivesSize += openedArchiveSize;
+    fs_opened_archive_index_insert(pFS->pOpenedArchivesIndex, pFS->openedArchivesIndexCap, pFS->openedArchivesSize, fs_hash_path(pArchivePath, archivePathLen));
+
+    pFS->openedArchivesSize  += openedArchiveSize;
+    pFS->openedArchivesCount += 1;
 
     return FS_SUCCESS;
 }
@@ -2258,14 +3081,57 @@ static fs_result fs_remove_opened_archive(fs* pFS, fs_opened_archive* pOpenedArc
 {
     /* This is a simple matter of doing a memmove() to move memory down. pOpenedArchive should be an offset of pFS->pOpenedArchives. */
     size_t openedArchiveSize;
+    size_t offset;
+    size_t mask;
+    size_t iSlot;
+    size_t jSlot;
 
-    openedArchiveSize = FS_ALIGN(sizeof(pOpenedArchive->pArchive) + strlen(pOpenedArchive->pPath) + 1, FS_SIZEOF_PTR);
+    openedArchiveSize = fs_opened_archive_sizeof(pOpenedArchive);
+    offset = (size_t)((fs_uintptr)pOpenedArchive - (fs_uintptr)pFS->pOpenedArchives);
 
     FS_ASSERT(((fs_uintptr)pOpenedArchive + openedArchiveSize) >  ((fs_uintptr)pFS->pOpenedArchives));
     FS_ASSERT(((fs_uintptr)pOpenedArchive + openedArchiveSize) <= ((fs_uintptr)pFS->pOpenedArchives + pFS->openedArchivesSize));
+    FS_ASSERT(pFS->openedArchivesIndexCap > 0);
+
+    /*
+    Everything after the removed entry is about to be moved down which means the offsets in the index need
+    to be updated. We do this in the same pass where we look for the slot of the entry being removed.
+    */
+    mask  = pFS->openedArchivesIndexCap - 1;
+    iSlot = pFS->openedArchivesIndexCap;
+    for (jSlot = 0; jSlot < pFS->openedArchivesIndexCap; jSlot += 1) {
+        if (pFS->pOpenedArchivesIndex[jSlot].offset == offset + 1) {
+            iSlot = jSlot;
+        } else if (pFS->pOpenedArchivesIndex[jSlot].offset > offset + 1) {
+            pFS->pOpenedArchivesIndex[jSlot].offset -= openedArchiveSize;
+        }
+    }
+
+    FS_ASSERT(iSlot < pFS->openedArchivesIndexCap);
+
+    /* Backward shift deletion. Any entry in the same probe sequence needs to be pulled back so lookups don't terminate early on the hole. */
+    jSlot = iSlot;
+    for (;;) {
+        size_t homeSlot;
+
+        jSlot = (jSlot + 1) & mask;
+        if (pFS->pOpenedArchivesIndex[jSlot].offset == 0) {
+            break;
+        }
+
+        homeSlot = pFS->pOpenedArchivesIndex[jSlot].hash & mask;
+        if ((jSlot > iSlot && (homeSlot <= iSlot || homeSlot > jSlot)) || (jSlot < iSlot && (homeSlot <= iSlot && homeSlot > jSlot))) {
+            pFS->pOpenedArchivesIndex[iSlot] = pFS->pOpenedArchivesIndex[jSlot];
+            iSlot = jSlot;
+        }
+    }
+
+    pFS->pOpenedArchivesIndex[iSlot].offset = 0;
+    pFS->pOpenedArchivesIndex[iSlot].hash   = 0;
 
     FS_MOVE_MEMORY(pOpenedArchive, FS_OFFSET_PTR(pOpenedArchive, openedArchiveSize), (size_t)((((fs_uintptr)pFS->pOpenedArchives + pFS->openedArchivesSize)) - ((fs_uintptr)pOpenedArchive + openedArchiveSize)));
-    pFS->openedArchivesSize -= openedArchiveSize;
+    pFS->openedArchivesSize  -= openedArchiveSize;
+    pFS->openedArchivesCount -= 1;
 
     return FS_SUCCESS;
 }
@@ -2604,6 +3470,7 @@ FS_API fs_result fs_init(const fs_config* pConfig, fs** ppFS)
 
     pFS->pBackend              = pBackend;
     pFS->pStream               = pConfig->pStream; /* <-- This is allowed to be null, which will be the case for standard OS file system APIs. Streams are used for things like archives like Zip files, or in-memory file systems. */
+    pFS->isStreamShareable     = fs_stream_supports_read_at(pConfig->pStream);
     pFS->refCount              = 1;
     pFS->allocationCallbacks   = fs_allocation_callbacks_init_copy(pConfig->pAllocationCallbacks);
     pFS->backendDataSize       = backendDataSizeInBytes;
@@ -2664,6 +3531,19 @@ FS_API fs_result fs_init(const fs_config* pConfig, fs** ppFS)
         return result;
     }
 
+    /* The resolution cache is optional. When enabled it's just an array of slots, each of which holds one heap-allocated entry. */
+    if (pConfig->resolutionCacheSize > 0) {
+        pFS->ppResolutionCache = (fs_resolution_cache_entry**)fs_calloc(pConfig->resolutionCacheSize * sizeof(*pFS->ppResolutionCache), fs_get_allocation_callbacks(pFS));
+        if (pFS->ppResolutionCache == NULL) {
+            fs_mtx_destroy(&pFS->refLock);
+            fs_mtx_destroy(&pFS->archiveLock);
+            fs_free(pFS, fs_get_allocation_callbacks(pFS));
+            return FS_OUT_OF_MEMORY;
+        }
+
+        pFS->resolutionCacheSize = pConfig->resolutionCacheSize;
+    }
+
     /* We're now ready to initialize the backend. */
     result = fs_backend_init(pBackend, pFS, pConfig->pBackendConfig, pConfig->pStream);
     if (result != FS_NOT_IMPLEMENTED) {
@@ -2680,6 +3560,7 @@ FS_API fs_result fs_init(const fs_config* pConfig, fs** ppFS)
             fs_mtx_destroy(&pFS->refLock);
             fs_mtx_destroy(&pFS->archiveLock);
 
+            fs_free(pFS->ppResolutionCache, fs_get_allocation_callbacks(pFS));
             fs_free(pFS, fs_get_allocation_callbacks(pFS));
             return result;
         }
@@ -2752,6 +3633,13 @@ FS_API void fs_uninit(fs* pFS)
     fs_free(pFS->pOpenedArchives, &pFS->allocationCallbacks);
     pFS->pOpenedArchives = NULL;
 
+    fs_free(pFS->pOpenedArchivesIndex, &pFS->allocationCallbacks);
+    pFS->pOpenedArchivesIndex = NULL;
+
+    fs_resolution_cache_clear(pFS);
+    fs_free(pFS->ppResolutionCache, &pFS->allocationCallbacks);
+    pFS->ppResolutionCache = NULL;
+
     fs_mtx_destroy(&pFS->refLock);
     fs_mtx_destroy(&pFS->archiveLock);
 
@@ -2792,6 +3680,8 @@ FS_API fs_result fs_remove(fs* pFS, const char* pFilePath, int options)
         fs_string_free(&realFilePath, fs_get_allocation_callbacks(pFS));
     }
 
+    fs_resolution_cache_clear(pFS);
+
     return result;
 }
 
@@ -2839,6 +3729,8 @@ FS_API fs_result fs_rename(fs* pFS, const char* pOldPath, const char* pNewPath,
         fs_string_free(&realNewPath, fs_get_allocation_callbacks(pFS));
     }
 
+    fs_resolution_cache_clear(pFS);
+
     return result;
 }
 
@@ -2888,6 +3780,7 @@ FS_API fs_result fs_mkdir(fs* pFS, const char* pPath, int options)
     result = fs_backend_mkdir(pBackend, pFS, fs_string_cstr(&realPath));
     if (result != FS_DOES_NOT_EXIST) {
         fs_string_free(&realPath, fs_get_allocation_callbacks(pFS));
+        fs_resolution_cache_clear(pFS);
         return result; /* Either success or some other error. */
     }
 
@@ -2966,6 +3859,7 @@ FS_API fs_result fs_mkdir(fs* pFS, const char* pPath, int options)
         if (result != FS_SUCCESS) {
             fs_free(pRunningPathHeap, fs_get_allocation_callbacks(pFS));
             fs_string_free(&realPath, fs_get_allocation_callbacks(pFS));
+            fs_resolution_cache_clear(pFS);
             return result;
         }
 
@@ -2980,6 +3874,7 @@ FS_API fs_result fs_mkdir(fs* pFS, const char* pPath, int options)
 
     fs_free(pRunningPathHeap, fs_get_allocation_callbacks(pFS));
     fs_string_free(&realPath, fs_get_allocation_callbacks(pFS));
+    fs_resolution_cache_clear(pFS);
 
     return FS_SUCCESS;
 }
@@ -3077,17 +3972,20 @@ FS_API fs_uint32 fs_unref(fs* pFS)
         return 0;
     }
 
-    if (pFS->refCount == 1) {
-        #if !defined(FS_ENABLE_OPENED_FILES_ASSERT)
-        {
-            FS_ASSERT(!"ref/funref mismatch. Ensure all fs_ref() calls are matched with fs_unref() calls.");
-        }
-        #endif
-        return pFS->refCount;
-    }
-
     fs_mtx_lock(&pFS->refLock);
     {
+        /* The count needs to be checked under the lock because files can be opened and closed on other threads. */
+        if (pFS->refCount == 1) {
+            fs_mtx_unlock(&pFS->refLock);
+
+            #if !defined(FS_ENABLE_OPENED_FILES_ASSERT)
+            {
+                FS_ASSERT(!"ref/funref mismatch. Ensure all fs_ref() calls are matched with fs_unref() calls.");
+            }
+            #endif
+            return 1;
+        }
+
         oldRefCount = pFS->refCount;
         newRefCount = pFS->refCount - 1;
 
@@ -3200,54 +4098,295 @@ static fs_result fs_file_stream_tell(fs_stream* pStream, fs_int64* pCursor)
     return fs_file_tell((fs_file*)pStream, pCursor);
 }
 
-static size_t fs_file_stream_alloc_size(fs_stream* pStream)
+/*
+The stream versions of the positional functions only use native backend support. Streams promise that
+read_at is thread-safe which the emulated path in fs_file_read_at() cannot guarantee.
+*/
+static fs_result fs_file_stream_read_at(fs_stream* pStream, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    fs_file* pFile = (fs_file*)pStream;
+    fs_result result;
+
+    result = fs_backend_file_read_at(fs_get_backend_or_default(fs_file_get_fs(pFile)), pFile, offset, pDst, bytesToRead, pBytesRead);
+
+    /* Same rule as fs_file_read(). We can only return FS_AT_END if nothing was read. */
+    if (result == FS_AT_END && *pBytesRead > 0) {
+        result = FS_SUCCESS;
+    }
+
+    return result;
+}
+
+static fs_result fs_file_stream_write_at(fs_stream* pStream, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    fs_file* pFile = (fs_file*)pStream;
+
+    return fs_backend_file_write_at(fs_get_backend_or_default(fs_file_get_fs(pFile)), pFile, offset, pSrc, bytesToWrite, pBytesWritten);
+}
+
+static fs_result fs_file_stream_map(fs_stream* pStream, const void** ppData, size_t* pDataSize)
+{
+    fs_file* pFile = (fs_file*)pStream;
+    fs_result result;
+
+    /* Streams only expose real mappings. We don't want to be reading an entire archive into memory. */
+    if (pFile->pMappedData == NULL) {
+        const void* pData;
+        size_t dataSize;
+
+        result = fs_backend_file_map(fs_get_backend_or_default(fs_file_get_fs(pFile)), pFile, &pData, &dataSize);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        pFile->pMappedData       = pData;
+        pFile->mappedDataSize    = dataSize;
+        pFile->isMappingEmulated = FS_FALSE;
+    } else if (pFile->isMappingEmulated) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    *ppData    = pFile->pMappedData;
+    *pDataSize = pFile->mappedDataSize;
+
+    return FS_SUCCESS;
+}
+
+static size_t fs_file_stream_alloc_size(fs_stream* pStream)
+{
+    return fs_file_duplicate_alloc_size(fs_file_get_fs((fs_file*)pStream));
+}
+
+static fs_result fs_file_stream_duplicate(fs_stream* pStream, fs_stream* pDuplicatedStream)
+{
+    fs_result result;
+    fs_file* pStreamFile = (fs_file*)pStream;
+    fs_file* pDuplicatedStreamFile = (fs_file*)pDuplicatedStream;
+
+    FS_ASSERT(pStreamFile != NULL);
+    FS_ASSERT(pDuplicatedStreamFile != NULL);
+
+    /* The stream will already have been initialized at a higher level in fs_stream_duplicate(). */
+    fs_file_preinit_no_stream(pDuplicatedStreamFile, fs_file_get_fs(pStreamFile), pStreamFile->backendDataSize);
+
+    result = fs_backend_file_duplicate(fs_get_backend_or_default(pStreamFile->pFS), pStreamFile, pDuplicatedStreamFile);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    return FS_SUCCESS;
+}
+
+static void fs_file_stream_uninit(fs_stream* pStream)
+{
+    /* We need to uninitialize the file, but *not* free it. Freeing will be done at a higher level in fs_stream_delete_duplicate(). */
+    fs_file_uninit((fs_file*)pStream);
+}
+
+static fs_stream_vtable fs_file_stream_vtable =
+{
+    fs_file_stream_read,
+    fs_file_stream_write,
+    fs_file_stream_seek,
+    fs_file_stream_tell,
+    fs_file_stream_alloc_size,
+    fs_file_stream_duplicate,
+    fs_file_stream_uninit,
+    fs_file_stream_read_at,
+    fs_file_stream_write_at,
+    fs_file_stream_map
+};
+
+
+
+
+static const fs_backend* fs_file_get_backend(fs_file* pFile)
+{
+    return fs_get_backend_or_default(fs_file_get_fs(pFile));
+}
+
+static fs_uint32 fs_resolution_cache_hash(const char* pPath, size_t pathLen, int openMode, fs_bool32 isInfo)
+{
+    return fs_hash_path(pPath, pathLen) ^ ((fs_uint32)openMode * 2654435761U) ^ (fs_uint32)isInfo;
+}
+
+static fs_resolution_cache_entry* fs_resolution_cache_find_nolock(fs* pFS, const char* pPath, size_t pathLen, int openMode, fs_bool32 isInfo, size_t* pSlot)
+{
+    fs_uint32 hash;
+    size_t iSlot;
+    fs_resolution_cache_entry* pEntry;
+
+    FS_ASSERT(pFS != NULL);
+    FS_ASSERT(pFS->resolutionCacheSize > 0);
+
+    hash  = fs_resolution_cache_hash(pPath, pathLen, openMode, isInfo);
+    iSlot = hash % pFS->resolutionCacheSize;
+
+    if (pSlot != NULL) {
+        *pSlot = iSlot;
+    }
+
+    pEntry = pFS->ppResolutionCache[iSlot];
+    if (pEntry == NULL) {
+        return NULL;
+    }
+
+    if (pEntry->hash != hash || pEntry->openMode != openMode || pEntry->isInfo != isInfo || pEntry->pathLen != pathLen) {
+        return NULL;
+    }
+
+    if (fs_strncmp((const char*)FS_OFFSET_PTR(pEntry, sizeof(*pEntry)), pPath, pathLen) != 0) {
+        return NULL;
+    }
+
+    return pEntry;
+}
+
+static void fs_resolution_cache_insert(fs* pFS, const char* pPath, int openMode, fs_bool32 isInfo, const fs_backend* pBackend, const void* pBackendConfig, const char* pArchivePath, size_t archivePathLen, size_t innerPathOffset)
+{
+    fs_resolution_cache_entry* pEntry;
+    size_t pathLen;
+    size_t iSlot;
+
+    FS_ASSERT(pFS != NULL);
+
+    if (pFS->resolutionCacheSize == 0) {
+        return;
+    }
+
+    pathLen = strlen(pPath);
+
+    if (pArchivePath == NULL) {
+        archivePathLen = 0;
+    }
+
+    /* The cache is only an optimization so if we fail to allocate we just silently skip caching this path. */
+    pEntry = (fs_resolution_cache_entry*)fs_malloc(sizeof(*pEntry) + pathLen + 1 + archivePathLen + 1, fs_get_allocation_callbacks(pFS));
+    if (pEntry == NULL) {
+        return;
+    }
+
+    pEntry->hash            = fs_resolution_cache_hash(pPath, pathLen, openMode, isInfo);
+    pEntry->openMode        = openMode;
+    pEntry->isInfo          = isInfo;
+    pEntry->pBackend        = pBackend;
+    pEntry->pBackendConfig  = pBackendConfig;
+    pEntry->pathLen         = pathLen;
+    pEntry->archivePathLen  = archivePathLen;
+    pEntry->innerPathOffset = innerPathOffset;
+    fs_strncpy((char*)FS_OFFSET_PTR(pEntry, sizeof(*pEntry)), pPath, pathLen);
+    fs_strncpy((char*)FS_OFFSET_PTR(pEntry, sizeof(*pEntry) + pathLen + 1), (pArchivePath != NULL) ? pArchivePath : "", archivePathLen);
+
+    fs_mtx_lock(&pFS->archiveLock);
+    {
+        /* Each path maps to exactly one slot. Whatever was in there before is evicted which keeps the cache bounded. */
+        iSlot = pEntry->hash % pFS->resolutionCacheSize;
+
+        fs_free(pFS->ppResolutionCache[iSlot], fs_get_allocation_callbacks(pFS));
+        pFS->ppResolutionCache[iSlot] = pEntry;
+    }
+    fs_mtx_unlock(&pFS->archiveLock);
+}
+
+static void fs_resolution_cache_remove(fs* pFS, const char* pPath, int openMode, fs_bool32 isInfo)
+{
+    size_t iSlot;
+
+    FS_ASSERT(pFS != NULL);
+
+    if (pFS->resolutionCacheSize == 0) {
+        return;
+    }
+
+    fs_mtx_lock(&pFS->archiveLock);
+    {
+        if (fs_resolution_cache_find_nolock(pFS, pPath, strlen(pPath), openMode, isInfo, &iSlot) != NULL) {
+            fs_free(pFS->ppResolutionCache[iSlot], fs_get_allocation_callbacks(pFS));
+            pFS->ppResolutionCache[iSlot] = NULL;
+        }
+    }
+    fs_mtx_unlock(&pFS->archiveLock);
+}
+
+static void fs_resolution_cache_clear(fs* pFS)
 {
-    return fs_file_duplicate_alloc_size(fs_file_get_fs((fs_file*)pStream));
+    size_t iSlot;
+
+    if (pFS == NULL || pFS->resolutionCacheSize == 0) {
+        return;
+    }
+
+    fs_mtx_lock(&pFS->archiveLock);
+    {
+        for (iSlot = 0; iSlot < pFS->resolutionCacheSize; iSlot += 1) {
+            fs_free(pFS->ppResolutionCache[iSlot], fs_get_allocation_callbacks(pFS));
+            pFS->ppResolutionCache[iSlot] = NULL;
+        }
+    }
+    fs_mtx_unlock(&pFS->archiveLock);
 }
 
-static fs_result fs_file_stream_duplicate(fs_stream* pStream, fs_stream* pDuplicatedStream)
+static fs_bool32 fs_open_or_info_from_resolution_cache(fs* pFS, const char* pFilePath, int openMode, fs_file** ppFile, fs_file_info* pInfo, fs_result* pResult)
 {
     fs_result result;
-    fs_file* pStreamFile = (fs_file*)pStream;
-    fs_file* pDuplicatedStreamFile = (fs_file*)pDuplicatedStream;
+    fs_resolution_cache_entry* pEntry;
+    const fs_backend* pBackend;
+    const void* pBackendConfig;
+    size_t innerPathOffset;
+    fs_string archivePath;
+    fs* pArchive;
 
-    FS_ASSERT(pStreamFile != NULL);
-    FS_ASSERT(pDuplicatedStreamFile != NULL);
+    FS_ASSERT(pFS != NULL);
+    FS_ASSERT(pFS->resolutionCacheSize > 0);
 
-    /* The stream will already have been initialized at a higher level in fs_stream_duplicate(). */
-    fs_file_preinit_no_stream(pDuplicatedStreamFile, fs_file_get_fs(pStreamFile), pStreamFile->backendDataSize);
+    fs_mtx_lock(&pFS->archiveLock);
+    {
+        pEntry = fs_resolution_cache_find_nolock(pFS, pFilePath, strlen(pFilePath), openMode, ppFile == NULL, NULL);
+        if (pEntry == NULL) {
+            fs_mtx_unlock(&pFS->archiveLock);
+            return FS_FALSE;    /* Not cached. The caller needs to go down the slow path. */
+        }
 
-    result = fs_backend_file_duplicate(fs_get_backend_or_default(pStreamFile->pFS), pStreamFile, pDuplicatedStreamFile);
-    if (result != FS_SUCCESS) {
-        return result;
-    }
+        if (pEntry->pBackend == NULL) {
+            fs_mtx_unlock(&pFS->archiveLock);
+            *pResult = FS_DOES_NOT_EXIST;   /* Negative entry. We already know this path can't be found in any archive. */
+            return FS_TRUE;
+        }
 
-    return FS_SUCCESS;
-}
+        /* We need a copy of the archive path because the entry could be evicted by another thread as soon as we release the lock. */
+        result = fs_string_alloc(pEntry->archivePathLen, fs_get_allocation_callbacks(pFS), &archivePath);
+        if (result != FS_SUCCESS) {
+            fs_mtx_unlock(&pFS->archiveLock);
+            *pResult = result;
+            return FS_TRUE;
+        }
 
-static void fs_file_stream_uninit(fs_stream* pStream)
-{
-    /* We need to uninitialize the file, but *not* free it. Freeing will be done at a higher level in fs_stream_delete_duplicate(). */
-    fs_file_uninit((fs_file*)pStream);
-}
+        fs_string_append_preallocated(&archivePath, (const char*)FS_OFFSET_PTR(pEntry, sizeof(*pEntry) + pEntry->pathLen + 1), pEntry->archivePathLen);
 
-static fs_stream_vtable fs_file_stream_vtable =
-{
-    fs_file_stream_read,
-    fs_file_stream_write,
-    fs_file_stream_seek,
-    fs_file_stream_tell,
-    fs_file_stream_alloc_size,
-    fs_file_stream_duplicate,
-    fs_file_stream_uninit
-};
+        pBackend        = pEntry->pBackend;
+        pBackendConfig  = pEntry->pBackendConfig;
+        innerPathOffset = pEntry->innerPathOffset;
+    }
+    fs_mtx_unlock(&pFS->archiveLock);
 
+    result = fs_open_archive_ex(pFS, pBackend, pBackendConfig, fs_string_cstr(&archivePath), FS_NULL_TERMINATED, FS_NO_INCREMENT_REFCOUNT | FS_OPAQUE | openMode, &pArchive);
+    fs_string_free(&archivePath, fs_get_allocation_callbacks(pFS));
 
+    if (result == FS_SUCCESS) {
+        result = fs_file_open_or_info(pArchive, pFilePath + innerPathOffset, openMode, ppFile, pInfo);
+        if (result != FS_SUCCESS || ppFile == NULL) {
+            if (fs_refcount(pArchive) == 1) { fs_gc_archives(pFS, FS_GC_POLICY_THRESHOLD); }
+        }
+    }
 
+    if (result != FS_SUCCESS) {
+        /* The cached resolution is stale. Drop it and let the caller do a full scan. */
+        fs_resolution_cache_remove(pFS, pFilePath, openMode, ppFile == NULL);
+        return FS_FALSE;
+    }
 
-static const fs_backend* fs_file_get_backend(fs_file* pFile)
-{
-    return fs_get_backend_or_default(fs_file_get_fs(pFile));
+    *pResult = FS_SUCCESS;
+    return FS_TRUE;
 }
 
 static fs_result fs_open_or_info_from_archive(fs* pFS, const char* pFilePath, int openMode, fs_file** ppFile, fs_file_info* pInfo)
@@ -3259,6 +4398,7 @@ static fs_result fs_open_or_info_from_archive(fs* pFS, const char* pFilePath, in
     fs_result result;
     fs_path_iterator iFilePathSeg;
     fs_path_iterator iFilePathSegLast;
+    fs_bool32 isEveryArchiveChecked = FS_TRUE;  /* Set to false when an archive couldn't be checked, in which case a negative result can't be cached. */
 
     FS_ASSERT(pFS != NULL);
 
@@ -3275,6 +4415,13 @@ static fs_result fs_open_or_info_from_archive(fs* pFS, const char* pFilePath, in
         return FS_DOES_NOT_EXIST;
     }
 
+    /* If we've resolved this path before we can skip the scan below. Only transparent lookups are cached. */
+    if (pFS->resolutionCacheSize > 0 && !FS_IS_VERBOSE(openMode)) {
+        if (fs_open_or_info_from_resolution_cache(pFS, pFilePath, openMode, ppFile, pInfo, &result)) {
+            return result;
+        }
+    }
+
     /*
     We need to iterate over each segment in the path and then iterate over each file in that folder and
     check for archives. If we find an archive we simply try loading from that. Note that if the path
@@ -3351,6 +4498,10 @@ static fs_result fs_open_or_info_from_archive(fs* pFS, const char* pFilePath, in
 
         /* If the path has an extension of an archive, but we still manage to get here, it means the archive doesn't exist. */
         if (isArchive) {
+            if (!FS_IS_VERBOSE(openMode) && isEveryArchiveChecked) {
+                fs_resolution_cache_insert(pFS, pFilePath, openMode, ppFile == NULL, NULL, NULL, NULL, 0, 0);
+            }
+
             return FS_DOES_NOT_EXIST;
         }
 
@@ -3376,7 +4527,7 @@ static fs_result fs_open_or_info_from_archive(fs* pFS, const char* pFilePath, in
             */
             fs_iterator* pIterator;
 
-            for (pIterator = fs_backend_first(fs_get_backend_or_default(pFS), pFS, iFilePathSeg.pFullPath, iFilePathSeg.segmentOffset + iFilePathSeg.segmentLength); pIterator != NULL; pIterator = fs_backend_next(fs_get_backend_or_default(pFS), pIterator)) {
+            for (pIterator = fs_backend_first(fs_get_backend_or_default(pFS), pFS, iFilePathSeg.pFullPath, iFilePathSeg.segmentOffset + iFilePathSeg.segmentLength, FS_NAMES_ONLY); pIterator != NULL; pIterator = fs_backend_next(fs_get_backend_or_default(pFS), pIterator)) {
                 for (result = fs_first_registered_backend(pFS, &iBackend); result == FS_SUCCESS; result = fs_next_registered_backend(&iBackend)) {
                     if (fs_path_extension_equal(pIterator->pName, pIterator->nameLen, iBackend.pExtension, iBackend.extensionLen)) {
                         /* Looks like an archive. We can load this one up and try opening from it. */
@@ -3397,9 +4548,13 @@ static fs_result fs_open_or_info_from_archive(fs* pFS, const char* pFilePath, in
 
                         /* At this point we've constructed the archive name and we can now open it. */
                         result = fs_open_archive_ex(pFS, pBackend, pBackendConfig, fs_string_cstr(&archivePath), FS_NULL_TERMINATED, FS_NO_INCREMENT_REFCOUNT | FS_OPAQUE | openMode, &pArchive);
-                        fs_string_free(&archivePath, fs_get_allocation_callbacks(pFS));
-
                         if (result != FS_SUCCESS) { /* <-- This is checking the result of fs_open_archive_ex(). */
+                            /* Errors other than FS_DOES_NOT_EXIST could be temporary, like running out of memory, so the file could still be in there. */
+                            if (result != FS_DOES_NOT_EXIST) {
+                                isEveryArchiveChecked = FS_FALSE;
+                            }
+
+                            fs_string_free(&archivePath, fs_get_allocation_callbacks(pFS));
                             continue;   /* Failed to open this archive. Keep looking. */
                         }
 
@@ -3409,10 +4564,18 @@ static fs_result fs_open_or_info_from_archive(fs* pFS, const char* pFilePath, in
                         */
                         result = fs_file_open_or_info(pArchive, iFilePathSeg.pFullPath + iFilePathSeg.segmentOffset + iFilePathSeg.segmentLength + 1, openMode, ppFile, pInfo);  /* +1 to skip the separator. */
                         if (result != FS_SUCCESS) {
+                            if (result != FS_DOES_NOT_EXIST) {
+                                isEveryArchiveChecked = FS_FALSE;
+                            }
+
+                            fs_string_free(&archivePath, fs_get_allocation_callbacks(pFS));
                             if (fs_refcount(pArchive) == 1) { fs_gc_archives(pFS, FS_GC_POLICY_THRESHOLD); }
                             continue;  /* Failed to open the file. Keep looking. */
                         }
 
+                        fs_resolution_cache_insert(pFS, pFilePath, openMode, ppFile == NULL, pBackend, pBackendConfig, fs_string_cstr(&archivePath), fs_string_len(&archivePath), iFilePathSeg.segmentOffset + iFilePathSeg.segmentLength + 1);
+                        fs_string_free(&archivePath, fs_get_allocation_callbacks(pFS));
+
                         /* The iterator is no longer required. */
                         fs_backend_free_iterator(fs_get_backend_or_default(pFS), pIterator);
                         pIterator = NULL;
@@ -3441,6 +4604,10 @@ static fs_result fs_open_or_info_from_archive(fs* pFS, const char* pFilePath, in
     } while (fs_path_next(&iFilePathSeg) == FS_SUCCESS);
     
     /* Getting here means we reached the end of the path and never did find the file. */
+    if (!FS_IS_VERBOSE(openMode) && isEveryArchiveChecked) {
+        fs_resolution_cache_insert(pFS, pFilePath, openMode, ppFile == NULL, NULL, NULL, NULL, 0, 0);
+    }
+
     return FS_DOES_NOT_EXIST;
 }
 
@@ -3522,10 +4689,16 @@ static fs_result fs_file_alloc_and_open_or_info(fs* pFS, const char* pFilePath,
 
     /*
     Take a copy of the file system's stream if necessary. We only need to do this if we're opening the file, and if
-    the owner `fs` object `pFS` itself has a stream.
+    the owner `fs` object `pFS` itself has a stream. If the stream supports positional reads we don't need a real
+    copy and can instead just share it which avoids things like opening a new file descriptor for every file.
+
+    A copy of a stream that's being written to is never useful. Files can't be duplicated in write mode, and memory
+    streams would copy everything written so far. In write mode the backend will therefore only be given a shared
+    read-only view of the stream, and only if that's possible. Backends that write to the stream, such as the Zip
+    backend when building an archive, do so sequentially through fs_get_stream().
     */
-    if (pFS != NULL && ppFile != NULL && pFS->pStream != NULL) {
-        result = fs_stream_duplicate(pFS->pStream, fs_get_allocation_callbacks(pFS), &(*ppFile)->pStreamForBackend);
+    if (pFS != NULL && ppFile != NULL && pFS->pStream != NULL && ((openMode & FS_WRITE) == 0 || pFS->isStreamShareable)) {
+        result = fs_stream_duplicate_or_share(pFS->pStream, pFS->isStreamShareable, fs_get_allocation_callbacks(pFS), &(*ppFile)->pStreamForBackend);
         if (result != FS_SUCCESS) {
             fs_file_free(ppFile);
             return result;
@@ -3689,6 +4862,9 @@ static fs_result fs_file_open_or_info(fs* pFS, const char* pFilePath, int openMo
                 result = fs_file_alloc_and_open_or_info(pFS, fs_string_cstr(&fileRealPath), openMode, ppFile, pInfo);
                 fs_string_free(&fileRealPath, fs_get_allocation_callbacks(pFS));
 
+                /* Opening in write mode may have created a file or directory which would invalidate any cached lookups. */
+                fs_resolution_cache_clear(pFS);
+
                 if (result != FS_SUCCESS) {
                     return result;
                 }
@@ -3703,7 +4879,10 @@ static fs_result fs_file_open_or_info(fs* pFS, const char* pFilePath, int openMo
             opening a file using `fopen()`.
             */
             if ((openMode & FS_ONLY_MOUNTS) == 0) {
-                return fs_file_alloc_and_open_or_info(pFS, pFilePath, openMode, ppFile, pInfo);
+                result = fs_file_alloc_and_open_or_info(pFS, pFilePath, openMode, ppFile, pInfo);
+                fs_resolution_cache_clear(pFS);
+
+                return result;
             } else {
                 /*
                 Getting here means only the mount points can be used to open the file (cannot open straight from
@@ -3789,6 +4968,7 @@ FS_API fs_result fs_file_open(fs* pFS, const char* pFilePath, int openMode, fs_f
 
 static void fs_file_uninit(fs_file* pFile)
 {
+    fs_file_unmap(pFile);
     fs_backend_file_close(fs_get_backend_or_default(fs_file_get_fs(pFile)), pFile);
 }
 
@@ -3799,20 +4979,201 @@ FS_API void fs_file_close(fs_file* pFile)
     FS_ASSERT(pBackend != NULL);
     (void)pBackend;
 
-    if (pFile == NULL) {
-        return;
+    if (pFile == NULL) {
+        return;
+    }
+
+    fs_file_uninit(pFile);
+
+    if (pFile->pStreamForBackend != NULL) {
+        fs_stream_delete_duplicate(pFile->pStreamForBackend, fs_get_allocation_callbacks(pFile->pFS));
+    }
+
+    fs_file_free(&pFile);
+}
+
+FS_API fs_result fs_file_read(fs_file* pFile, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    fs_result result;
+    size_t bytesRead;
+    const fs_backend* pBackend;
+
+    if (pBytesRead != NULL) {
+        *pBytesRead = 0;
+    }
+
+    if (pFile == NULL || pDst == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    pBackend = fs_file_get_backend(pFile);
+    FS_ASSERT(pBackend != NULL);
+
+    bytesRead = 0;  /* <-- Just in case the backend doesn't clear this to zero. */
+    result = fs_backend_file_read(pBackend, pFile, pDst, bytesToRead, &bytesRead);
+
+    if (pBytesRead != NULL) {
+        *pBytesRead = bytesRead;
+    }
+
+    if (result != FS_SUCCESS) {
+        /* We can only return FS_AT_END if the number of bytes read was 0. */
+        if (result == FS_AT_END) {
+            if (bytesRead > 0) {
+                result = FS_SUCCESS;
+            }
+        }
+
+        return result;
+    }
+
+    /*
+    If pBytesRead is null it means the caller will never be able to tell exactly how many bytes were read. In this
+    case, if we didn't read the exact number of bytes that were requested we'll need to return an error.
+    */
+    if (pBytesRead == NULL) {
+        if (bytesRead != bytesToRead) {
+            return FS_ERROR;
+        }
+    }
+
+    return FS_SUCCESS;
+}
+
+FS_API fs_result fs_file_write(fs_file* pFile, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    fs_result result;
+    size_t bytesWritten;
+    const fs_backend* pBackend;
+
+    if (pBytesWritten != NULL) {
+        *pBytesWritten = 0;
+    }
+
+    if (pFile == NULL || pSrc == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    pBackend = fs_file_get_backend(pFile);
+    FS_ASSERT(pBackend != NULL);
+
+    bytesWritten = 0;  /* <-- Just in case the backend doesn't clear this to zero. */
+    result = fs_backend_file_write(pBackend, pFile, pSrc, bytesToWrite, &bytesWritten);
+
+    if (pBytesWritten != NULL) {
+        *pBytesWritten = bytesWritten;
+    }
+
+    /*
+    As with reading, if the caller passes in null for pBytesWritten we need to return an error if
+    the exact number of bytes couldn't be written.
+    */
+    if (pBytesWritten == NULL) {
+        if (bytesWritten != bytesToWrite) {
+            return FS_ERROR;
+        }
+    }
+
+    return result;
+}
+
+FS_API fs_result fs_file_writef(fs_file* pFile, const char* fmt, ...)
+{
+    va_list args;
+    fs_result result;
+
+    va_start(args, fmt);
+    result = fs_file_writefv(pFile, fmt, args);
+    va_end(args);
+
+    return result;
+}
+
+FS_API fs_result fs_file_writefv(fs_file* pFile, const char* fmt, va_list args)
+{
+    return fs_stream_writefv(fs_file_get_stream(pFile), fmt, args);
+}
+
+FS_API fs_result fs_file_seek(fs_file* pFile, fs_int64 offset, fs_seek_origin origin)
+{
+    const fs_backend* pBackend;
+
+    if (pFile == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    pBackend = fs_file_get_backend(pFile);
+    FS_ASSERT(pBackend != NULL);
+
+    return fs_backend_file_seek(pBackend, pFile, offset, origin);
+}
+
+FS_API fs_result fs_file_tell(fs_file* pFile, fs_int64* pOffset)
+{
+    const fs_backend* pBackend;
+
+    if (pOffset == NULL) {
+        return FS_INVALID_ARGS;  /* Doesn't make sense to be calling this without an output parameter. */
+    }
+
+    *pOffset = 0;
+
+    if (pFile == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    pBackend = fs_file_get_backend(pFile);
+    FS_ASSERT(pBackend != NULL);
+
+    return fs_backend_file_tell(pBackend, pFile, pOffset);
+}
+
+static fs_result fs_file_read_at_emulated(fs_file* pFile, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    fs_result result;
+    fs_int64 cursor;
+
+    result = fs_file_tell(pFile, &cursor);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    result = fs_file_seek(pFile, offset, FS_SEEK_SET);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    result = fs_backend_file_read(fs_file_get_backend(pFile), pFile, pDst, bytesToRead, pBytesRead);
+
+    /* Always restore the cursor, even if reading failed. */
+    fs_file_seek(pFile, cursor, FS_SEEK_SET);
+
+    return result;
+}
+
+static fs_result fs_file_write_at_emulated(fs_file* pFile, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    fs_result result;
+    fs_int64 cursor;
+
+    result = fs_file_tell(pFile, &cursor);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    result = fs_file_seek(pFile, offset, FS_SEEK_SET);
+    if (result != FS_SUCCESS) {
+        return result;
     }
 
-    fs_file_uninit(pFile);
+    result = fs_backend_file_write(fs_file_get_backend(pFile), pFile, pSrc, bytesToWrite, pBytesWritten);
 
-    if (pFile->pStreamForBackend != NULL) {
-        fs_stream_delete_duplicate(pFile->pStreamForBackend, fs_get_allocation_callbacks(pFile->pFS));
-    }
+    fs_file_seek(pFile, cursor, FS_SEEK_SET);
 
-    fs_file_free(&pFile);
+    return result;
 }
 
-FS_API fs_result fs_file_read(fs_file* pFile, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+FS_API fs_result fs_file_read_at(fs_file* pFile, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
 {
     fs_result result;
     size_t bytesRead;
@@ -3822,22 +5183,26 @@ FS_API fs_result fs_file_read(fs_file* pFile, void* pDst, size_t bytesToRead, si
         *pBytesRead = 0;
     }
 
-    if (pFile == NULL || pDst == NULL) {
+    if (pFile == NULL || pDst == NULL || offset < 0) {
         return FS_INVALID_ARGS;
     }
 
     pBackend = fs_file_get_backend(pFile);
     FS_ASSERT(pBackend != NULL);
 
-    bytesRead = 0;  /* <-- Just in case the backend doesn't clear this to zero. */
-    result = fs_backend_file_read(pBackend, pFile, pDst, bytesToRead, &bytesRead);
+    bytesRead = 0;
+    result = fs_backend_file_read_at(pBackend, pFile, offset, pDst, bytesToRead, &bytesRead);
+    if (result == FS_NOT_IMPLEMENTED) {
+        bytesRead = 0;
+        result = fs_file_read_at_emulated(pFile, offset, pDst, bytesToRead, &bytesRead);
+    }
 
     if (pBytesRead != NULL) {
         *pBytesRead = bytesRead;
     }
 
+    /* The rest is the same as fs_file_read(). */
     if (result != FS_SUCCESS) {
-        /* We can only return FS_AT_END if the number of bytes read was 0. */
         if (result == FS_AT_END) {
             if (bytesRead > 0) {
                 result = FS_SUCCESS;
@@ -3847,10 +5212,6 @@ FS_API fs_result fs_file_read(fs_file* pFile, void* pDst, size_t bytesToRead, si
         return result;
     }
 
-    /*
-    If pBytesRead is null it means the caller will never be able to tell exactly how many bytes were read. In this
-    case, if we didn't read the exact number of bytes that were requested we'll need to return an error.
-    */
     if (pBytesRead == NULL) {
         if (bytesRead != bytesToRead) {
             return FS_ERROR;
@@ -3860,7 +5221,7 @@ FS_API fs_result fs_file_read(fs_file* pFile, void* pDst, size_t bytesToRead, si
     return FS_SUCCESS;
 }
 
-FS_API fs_result fs_file_write(fs_file* pFile, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+FS_API fs_result fs_file_write_at(fs_file* pFile, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
 {
     fs_result result;
     size_t bytesWritten;
@@ -3870,24 +5231,24 @@ FS_API fs_result fs_file_write(fs_file* pFile, const void* pSrc, size_t bytesToW
         *pBytesWritten = 0;
     }
 
-    if (pFile == NULL || pSrc == NULL) {
+    if (pFile == NULL || pSrc == NULL || offset < 0) {
         return FS_INVALID_ARGS;
     }
 
     pBackend = fs_file_get_backend(pFile);
     FS_ASSERT(pBackend != NULL);
 
-    bytesWritten = 0;  /* <-- Just in case the backend doesn't clear this to zero. */
-    result = fs_backend_file_write(pBackend, pFile, pSrc, bytesToWrite, &bytesWritten);
+    bytesWritten = 0;
+    result = fs_backend_file_write_at(pBackend, pFile, offset, pSrc, bytesToWrite, &bytesWritten);
+    if (result == FS_NOT_IMPLEMENTED) {
+        bytesWritten = 0;
+        result = fs_file_write_at_emulated(pFile, offset, pSrc, bytesToWrite, &bytesWritten);
+    }
 
     if (pBytesWritten != NULL) {
         *pBytesWritten = bytesWritten;
     }
 
-    /*
-    As with reading, if the caller passes in null for pBytesWritten we need to return an error if
-    the exact number of bytes couldn't be written.
-    */
     if (pBytesWritten == NULL) {
         if (bytesWritten != bytesToWrite) {
             return FS_ERROR;
@@ -3897,57 +5258,6 @@ FS_API fs_result fs_file_write(fs_file* pFile, const void* pSrc, size_t bytesToW
     return result;
 }
 
-FS_API fs_result fs_file_writef(fs_file* pFile, const char* fmt, ...)
-{
-    va_list args;
-    fs_result result;
-
-    va_start(args, fmt);
-    result = fs_file_writefv(pFile, fmt, args);
-    va_end(args);
-
-    return result;
-}
-
-FS_API fs_result fs_file_writefv(fs_file* pFile, const char* fmt, va_list args)
-{
-    return fs_stream_writefv(fs_file_get_stream(pFile), fmt, args);
-}
-
-FS_API fs_result fs_file_seek(fs_file* pFile, fs_int64 offset, fs_seek_origin origin)
-{
-    const fs_backend* pBackend;
-
-    if (pFile == NULL) {
-        return FS_INVALID_ARGS;
-    }
-
-    pBackend = fs_file_get_backend(pFile);
-    FS_ASSERT(pBackend != NULL);
-
-    return fs_backend_file_seek(pBackend, pFile, offset, origin);
-}
-
-FS_API fs_result fs_file_tell(fs_file* pFile, fs_int64* pOffset)
-{
-    const fs_backend* pBackend;
-
-    if (pOffset == NULL) {
-        return FS_INVALID_ARGS;  /* Doesn't make sense to be calling this without an output parameter. */
-    }
-
-    *pOffset = 0;
-
-    if (pFile == NULL) {
-        return FS_INVALID_ARGS;
-    }
-
-    pBackend = fs_file_get_backend(pFile);
-    FS_ASSERT(pBackend != NULL);
-
-    return fs_backend_file_tell(pBackend, pFile, pOffset);
-}
-
 FS_API fs_result fs_file_flush(fs_file* pFile)
 {
     const fs_backend* pBackend;
@@ -4024,6 +5334,96 @@ FS_API fs_result fs_file_duplicate(fs_file* pFile, fs_file** ppDuplicate)
     return result;
 }
 
+FS_API fs_result fs_file_map(fs_file* pFile, const void** ppData, size_t* pDataSize)
+{
+    fs_result result;
+    const void* pData = NULL;
+    size_t dataSize = 0;
+    fs_bool32 isEmulated = FS_FALSE;
+
+    if (ppData != NULL) {
+        *ppData = NULL;
+    }
+
+    if (pDataSize != NULL) {
+        *pDataSize = 0;
+    }
+
+    if (pFile == NULL || ppData == NULL || pDataSize == NULL) {
+        return FS_INVALID_ARGS;
+    }
+
+    /* Only a single mapping is supported at a time. */
+    if (pFile->pMappedData != NULL) {
+        *ppData    = pFile->pMappedData;
+        *pDataSize = pFile->mappedDataSize;
+        return FS_SUCCESS;
+    }
+
+    result = fs_backend_file_map(fs_file_get_backend(pFile), pFile, &pData, &dataSize);
+    if (result == FS_NOT_IMPLEMENTED) {
+        /* The backend can't do mapping. Fall back to reading the whole file into memory. */
+        fs_file_info info;
+        void* pHeapData;
+
+        result = fs_file_get_info(pFile, &info);
+        if (result != FS_SUCCESS) {
+            return result;
+        }
+
+        if ((fs_uint64)(size_t)info.size != info.size) {
+            return FS_TOO_BIG;
+        }
+
+        dataSize = (size_t)info.size;
+
+        if (dataSize > 0) {
+            pHeapData = fs_malloc(dataSize, fs_get_allocation_callbacks(pFile->pFS));
+            if (pHeapData == NULL) {
+                return FS_OUT_OF_MEMORY;
+            }
+
+            result = fs_file_read_at(pFile, 0, pHeapData, dataSize, NULL);
+            if (result != FS_SUCCESS) {
+                fs_free(pHeapData, fs_get_allocation_callbacks(pFile->pFS));
+                return result;
+            }
+
+            pData = pHeapData;
+        }
+
+        isEmulated = FS_TRUE;
+    } else if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    pFile->pMappedData       = pData;
+    pFile->mappedDataSize    = dataSize;
+    pFile->isMappingEmulated = isEmulated;
+
+    *ppData    = pData;
+    *pDataSize = dataSize;
+
+    return FS_SUCCESS;
+}
+
+FS_API void fs_file_unmap(fs_file* pFile)
+{
+    if (pFile == NULL || pFile->pMappedData == NULL) {
+        return;
+    }
+
+    if (pFile->isMappingEmulated) {
+        fs_free((void*)pFile->pMappedData, fs_get_allocation_callbacks(pFile->pFS));
+    } else {
+        fs_backend_file_unmap(fs_file_get_backend(pFile), pFile, pFile->pMappedData, pFile->mappedDataSize);
+    }
+
+    pFile->pMappedData       = NULL;
+    pFile->mappedDataSize    = 0;
+    pFile->isMappingEmulated = FS_FALSE;
+}
+
 FS_API void* fs_file_get_backend_data(fs_file* pFile)
 {
     if (pFile == NULL) {
@@ -4093,27 +5493,6 @@ static void fs_iterator_internal_resolve_public_members(fs_iterator_internal* pI
     pIterator->base.info    = pIterator->ppItems[pIterator->itemIndex]->info;
 }
 
-static fs_iterator_item* fs_iterator_internal_find(fs_iterator_internal* pIterator, const char* pName, size_t nameLen)
-{
-    /*
-    We cannot use ppItems here because this function will be called before that has been set up. Instead we need
-    to use a cursor and run through each item linearly. This is unsorted.
-    */
-    size_t iItem;
-    size_t cursor = 0;
-
-    for (iItem = 0; iItem < pIterator->itemCount; iItem += 1) {
-        fs_iterator_item* pItem = (fs_iterator_item*)FS_OFFSET_PTR(pIterator, sizeof(fs_iterator_internal) + cursor);
-        if (pItem->nameLen == nameLen && fs_strncmp(fs_iterator_item_name(pItem), pName, pItem->nameLen) == 0) {
-            return pItem;
-        }
-
-        cursor += fs_iterator_item_sizeof(pItem->nameLen);
-    }
-
-    return NULL;
-}
-
 static fs_iterator_internal* fs_iterator_internal_append(fs_iterator_internal* pIterator, fs_iterator* pOther, fs* pFS, int mode)
 {
     size_t newItemSize;
@@ -4131,15 +5510,11 @@ static fs_iterator_internal* fs_iterator_internal_append(fs_iterator_internal* p
     (void)mode;
 
 
-    /* Check if the item already exists. If so, skip it. */
-    if (pIterator != NULL) {
-        pNewItem = fs_iterator_internal_find(pIterator, pOther->pName, pOther->nameLen);
-        if (pNewItem != NULL) {
-            return pIterator;   /* Already exists. Skip it. */
-        }
-    }
-
-    /* At this point we're ready to append the item. */
+    /*
+    We don't check for duplicates here because doing a search for every item makes gathering quadratic which is
+    way too slow for big directories. Instead duplicates are removed after sorting. See
+    fs_iterator_internal_remove_duplicates().
+    */
     newItemSize = fs_iterator_item_sizeof(pOther->nameLen);
     if (pIterator == NULL || pIterator->dataSize + newItemSize + sizeof(fs_iterator_item*) > pIterator->allocSize) {
         fs_iterator_internal* pNewIterator;
@@ -4207,9 +5582,34 @@ static int fs_iterator_item_compare(void* pUserData, const void* pA, const void*
     return compareResult;
 }
 
-static void fs_iterator_internal_sort(fs_iterator_internal* pIterator)
+static void fs_iterator_internal_sort(fs_iterator_internal* pIterator, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_sort_ex(pIterator->ppItems, pIterator->itemCount, sizeof(fs_iterator_item*), fs_iterator_item_compare, NULL, pAllocationCallbacks);
+}
+
+static void fs_iterator_internal_remove_duplicates(fs_iterator_internal* pIterator)
 {
-    fs_sort(pIterator->ppItems, pIterator->itemCount, sizeof(fs_iterator_item*), fs_iterator_item_compare, NULL);
+    /*
+    This must be called after sorting. Items are appended in priority order, and since the sort is stable the
+    highest priority item will always be the first in a run of items with the same name. We keep that one and
+    drop the rest. The item data itself is left in place. Only the pointer list is compacted.
+    */
+    size_t iItem;
+    size_t itemCount;
+
+    if (pIterator->itemCount == 0) {
+        return;
+    }
+
+    itemCount = 1;
+    for (iItem = 1; iItem < pIterator->itemCount; iItem += 1) {
+        if (fs_iterator_item_compare(NULL, &pIterator->ppItems[itemCount - 1], &pIterator->ppItems[iItem]) != 0) {
+            pIterator->ppItems[itemCount] = pIterator->ppItems[iItem];
+            itemCount += 1;
+        }
+    }
+
+    pIterator->itemCount = itemCount;
 }
 
 static fs_iterator_internal* fs_iterator_internal_gather(fs_iterator_internal* pIterator, const fs_backend* pBackend, fs* pFS, const char* pDirectoryPath, size_t directoryPathLen, int mode)
@@ -4220,7 +5620,7 @@ static fs_iterator_internal* fs_iterator_internal_gather(fs_iterator_internal* p
     FS_ASSERT(pBackend != NULL);
 
     /* Regular files take priority. */
-    for (pInnerIterator = fs_backend_first(pBackend, pFS, pDirectoryPath, directoryPathLen); pInnerIterator != NULL; pInnerIterator = fs_backend_next(pBackend, pInnerIterator)) {
+    for (pInnerIterator = fs_backend_first(pBackend, pFS, pDirectoryPath, directoryPathLen, mode); pInnerIterator != NULL; pInnerIterator = fs_backend_next(pBackend, pInnerIterator)) {
         pIterator = fs_iterator_internal_append(pIterator, pInnerIterator, pFS, mode);
     }
 
@@ -4339,7 +5739,7 @@ static fs_iterator_internal* fs_iterator_internal_gather(fs_iterator_internal* p
                 To do this we opaquely iterate over each file in the currently iterated file path. If any of these
                 files are recognized as archives, we'll load up that archive and then try iterating from there.
                 */
-                for (pInnerIterator = fs_backend_first(pBackend, pFS, iDirPathSeg.pFullPath, iDirPathSeg.segmentOffset + iDirPathSeg.segmentLength); pInnerIterator != NULL; pInnerIterator = fs_backend_next(pBackend, pInnerIterator)) {
+                for (pInnerIterator = fs_backend_first(pBackend, pFS, iDirPathSeg.pFullPath, iDirPathSeg.segmentOffset + iDirPathSeg.segmentLength, FS_NAMES_ONLY); pInnerIterator != NULL; pInnerIterator = fs_backend_next(pBackend, pInnerIterator)) {
                     for (backendIteratorResult = fs_first_registered_backend(pFS, &iBackend); backendIteratorResult == FS_SUCCESS; backendIteratorResult = fs_next_registered_backend(&iBackend)) {
                         if (fs_path_extension_equal(pInnerIterator->pName, pInnerIterator->nameLen, iBackend.pExtension, iBackend.extensionLen)) {
                             /* Looks like an archive. We can load this one up and try iterating from it. */
@@ -4507,7 +5907,8 @@ FS_API fs_iterator* fs_first_ex(fs* pFS, const char* pDirectoryPath, size_t dire
     }
 
     /* We want to sort items in the iterator to make it consistent across platforms. */
-    fs_iterator_internal_sort(pIterator);
+    fs_iterator_internal_sort(pIterator, fs_get_allocation_callbacks(pFS));
+    fs_iterator_internal_remove_duplicates(pIterator);
 
     /* Post-processing setup. */
     pIterator->base.pFS  = pFS;
@@ -5094,6 +6495,8 @@ FS_API fs_result fs_mount(fs* pFS, const char* pActualPath, const char* pVirtual
         }
     }
 
+    fs_resolution_cache_clear(pFS);
+
     return FS_SUCCESS;
 }
 
@@ -5119,6 +6522,8 @@ FS_API fs_result fs_unmount(fs* pFS, const char* pActualPath, int options)
         }
     }
 
+    fs_resolution_cache_clear(pFS);
+
     return FS_SUCCESS;
 }
 
@@ -5290,6 +6695,8 @@ FS_API fs_result fs_mount_fs(fs* pFS, fs* pOtherFS, const char* pVirtualPath, in
     pNewMountPoint->pArchive = fs_ref(pOtherFS);
     pNewMountPoint->closeArchiveOnUnmount = FS_FALSE;
 
+    fs_resolution_cache_clear(pFS);
+
     return FS_SUCCESS;
 }
 
@@ -5319,13 +6726,29 @@ FS_API fs_result fs_unmount_fs(fs* pFS, fs* pOtherFS, int options)
         }
     }
 
+    fs_resolution_cache_clear(pFS);
+
     return FS_SUCCESS;
 }
 
 
 FS_API fs_result fs_file_read_to_end(fs_file* pFile, fs_format format, void** ppData, size_t* pDataSize)
 {
-    return fs_stream_read_to_end(fs_file_get_stream(pFile), format, fs_get_allocation_callbacks(fs_file_get_fs(pFile)), ppData, pDataSize);
+    fs_file_info info;
+    fs_int64 cursor;
+    fs_uint64 sizeHint = 0;
+
+    /*
+    If we know the size of the file we can read the whole thing with a single allocation. This is only a hint so
+    it's not an error if the backend can't tell us the size or the cursor.
+    */
+    if (pFile != NULL && fs_file_get_info(pFile, &info) == FS_SUCCESS && fs_file_tell(pFile, &cursor) == FS_SUCCESS) {
+        if (cursor >= 0 && (fs_uint64)cursor < info.size) {
+            sizeHint = info.size - (fs_uint64)cursor;
+        }
+    }
+
+    return fs_stream_read_to_end_ex(fs_file_get_stream(pFile), format, sizeHint, fs_get_allocation_callbacks(fs_file_get_fs(pFile)), ppData, pDataSize);
 }
 
 FS_API fs_result fs_file_open_and_read(fs* pFS, const char* pFilePath, fs_format format, void** ppData, size_t* pDataSize)
@@ -6188,6 +7611,10 @@ FS_API fs_result fs_deserialize(fs* pFS, const char* pDirectoryPath, int options
 #include <dirent.h>
 #include <sys/stat.h>
 
+#if !defined(FS_NO_MMAP)
+#include <sys/mman.h>
+#endif
+
 /* Some standard libraries hide lstat() in strict ANSI modes despite providing the function. */
 #if !defined(FS_NO_LSTAT)
     #if defined(__cplusplus)
@@ -6437,6 +7864,72 @@ static fs_result fs_file_read_posix(fs_file* pFile, void* pDst, size_t bytesToRe
     return FS_SUCCESS;
 }
 
+/*
+Like ftruncate(), pread() and pwrite() are not available with `-std=c89` unless the application opts in with a
+feature macro. When they're not available the backend simply won't support positional reads and writes natively
+and they'll be emulated at a higher level. Archives will fall back to duplicating their stream for each file.
+*/
+#if !defined(FS_HAS_PREAD) && ((defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200809L) || (defined(_XOPEN_SOURCE) && _XOPEN_SOURCE >= 500))
+    #define FS_HAS_PREAD
+#endif
+#if !defined(FS_HAS_PREAD) && !defined(__STRICT_ANSI__)
+    #define FS_HAS_PREAD
+#endif
+
+#if defined(FS_HAS_PREAD)
+static fs_result fs_file_read_at_posix(fs_file* pFile, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    fs_file_posix* pFilePosix = (fs_file_posix*)fs_file_get_backend_data(pFile);
+    ssize_t bytesRead;
+
+    #if !defined(_FILE_OFFSET_BITS) || _FILE_OFFSET_BITS != 64
+    {
+        if (offset > 2147483647) {
+            return FS_BAD_SEEK;    /* Offset is too large. */
+        }
+    }
+    #endif
+
+    bytesRead = pread(pFilePosix->fd, pDst, bytesToRead, (off_t)offset);
+    if (bytesRead < 0) {
+        return fs_result_from_errno(errno);
+    }
+
+    *pBytesRead = (size_t)bytesRead;
+
+    if (*pBytesRead == 0) {
+        return FS_AT_END;
+    }
+
+    return FS_SUCCESS;
+}
+
+static fs_result fs_file_write_at_posix(fs_file* pFile, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    fs_file_posix* pFilePosix = (fs_file_posix*)fs_file_get_backend_data(pFile);
+    ssize_t bytesWritten;
+
+    #if !defined(_FILE_OFFSET_BITS) || _FILE_OFFSET_BITS != 64
+    {
+        if (offset > 2147483647) {
+            return FS_BAD_SEEK;    /* Offset is too large. */
+        }
+    }
+    #endif
+
+    bytesWritten = pwrite(pFilePosix->fd, pSrc, bytesToWrite, (off_t)offset);
+    if (bytesWritten < 0) {
+        return fs_result_from_errno(errno);
+    }
+
+    *pBytesWritten = (size_t)bytesWritten;
+    return FS_SUCCESS;
+}
+#else
+#define fs_file_read_at_posix  NULL
+#define fs_file_write_at_posix NULL
+#endif
+
 static fs_result fs_file_write_posix(fs_file* pFile, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
 {
     fs_file_posix* pFilePosix = (fs_file_posix*)fs_file_get_backend_data(pFile);
@@ -6608,16 +8101,82 @@ static fs_result fs_file_duplicate_posix(fs_file* pFile, fs_file* pDuplicate)
         return result;
     }
 
-    if (st1.st_ino != st2.st_ino || st1.st_dev != st2.st_dev) {
-        fs_file_close_posix(pDuplicate);
-        return FS_INVALID_OPERATION;    /* It looks like the files have changed. */
+    if (st1.st_ino != st2.st_ino || st1.st_dev != st2.st_dev) {
+        fs_file_close_posix(pDuplicate);
+        return FS_INVALID_OPERATION;    /* It looks like the files have changed. */
+    }
+
+    return FS_SUCCESS;
+}
+
+#if !defined(FS_NO_MMAP)
+static fs_result fs_file_map_posix(fs_file* pFile, const void** ppData, size_t* pDataSize)
+{
+    fs_file_posix* pFilePosix = (fs_file_posix*)fs_file_get_backend_data(pFile);
+    struct stat info;
+    void* pData;
+
+    if (fstat(pFilePosix->fd, &info) < 0) {
+        return fs_result_from_errno(errno);
+    }
+
+    /* Things like pipes can't be mapped. Let the caller fall back to reading. */
+    if (!S_ISREG(info.st_mode)) {
+        return FS_NOT_IMPLEMENTED;
+    }
+
+    if ((fs_uint64)(size_t)info.st_size != (fs_uint64)info.st_size) {
+        return FS_TOO_BIG;
+    }
+
+    /* mmap() does not allow empty mappings. */
+    if (info.st_size == 0) {
+        *ppData    = NULL;
+        *pDataSize = 0;
+        return FS_SUCCESS;
+    }
+
+    pData = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, pFilePosix->fd, 0);
+    if (pData == MAP_FAILED) {
+        return fs_result_from_errno(errno);
     }
 
+    *ppData    = pData;
+    *pDataSize = (size_t)info.st_size;
+
     return FS_SUCCESS;
 }
 
+static void fs_file_unmap_posix(fs_file* pFile, const void* pData, size_t dataSize)
+{
+    (void)pFile;
+    munmap((void*)pData, dataSize);
+}
+#else
+#define fs_file_map_posix   NULL
+#define fs_file_unmap_posix NULL
+#endif
+
+
+/*
+The iterator is allocated once with enough room for the directory path and the longest possible file name
+so we don't need to reallocate it for each entry. If for some reason we get a name longer than NAME_MAX
+we'll just grow it.
+*/
+#if defined(NAME_MAX)
+    #define FS_POSIX_MAX_FILE_NAME_LEN NAME_MAX
+#else
+    #define FS_POSIX_MAX_FILE_NAME_LEN 255
+#endif
 
-#define FS_POSIX_MIN_ITERATOR_ALLOCATION_SIZE 1024
+/*
+With d_type we can get the type of an entry straight from readdir() which lets us avoid a stat() when only
+the names are needed. It's not available in strict ANSI mode, and not all file systems support it, in which
+case DT_UNKNOWN is returned and we fall back to stat().
+*/
+#if !defined(FS_NO_DIRENT_TYPE) && defined(DT_DIR) && defined(DT_LNK) && defined(DT_UNKNOWN)
+    #define FS_HAS_DIRENT_TYPE
+#endif
 
 typedef struct fs_iterator_posix
 {
@@ -6625,27 +8184,90 @@ typedef struct fs_iterator_posix
     DIR* pDir;
     char* pFullFilePath;        /* Points to the end of the structure. */
     size_t directoryPathLen;    /* The length of the directory section. */
+    size_t fileNameCap;         /* The number of bytes available for the file name, not including the null terminator. */
+    int mode;
 } fs_iterator_posix;
 
 static void fs_free_iterator_posix(fs_iterator* pIterator);
 
-static fs_iterator* fs_first_posix(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen)
+/* Moves to the next entry. Returns null and frees the iterator when there are no more entries or an error occurs. */
+static fs_iterator_posix* fs_iterator_posix_read_next(fs_iterator_posix* pIteratorPosix)
 {
-    fs_iterator_posix* pIteratorPosix;
     struct dirent* info;
     struct stat statInfo;
     size_t fileNameLen;
 
+    info = readdir(pIteratorPosix->pDir);
+    if (info == NULL) {
+        fs_free_iterator_posix((fs_iterator*)pIteratorPosix);
+        return NULL;    /* The end of the directory. */
+    }
+
+    fileNameLen = strlen(info->d_name);
+
+    /* This should never happen in practice, but if we get a name that won't fit we'll need to grow the iterator. */
+    if (fileNameLen > pIteratorPosix->fileNameCap) {
+        fs_iterator_posix* pNewIteratorPosix = (fs_iterator_posix*)fs_realloc(pIteratorPosix, sizeof(*pIteratorPosix) + pIteratorPosix->directoryPathLen + 1 + fileNameLen + 1, fs_get_allocation_callbacks(pIteratorPosix->iterator.pFS));    /* +1 for null terminator. */
+        if (pNewIteratorPosix == NULL) {
+            fs_free_iterator_posix((fs_iterator*)pIteratorPosix);
+            return NULL;
+        }
+
+        pIteratorPosix = pNewIteratorPosix;
+        pIteratorPosix->pFullFilePath = (char*)pIteratorPosix + sizeof(*pIteratorPosix);
+        pIteratorPosix->fileNameCap   = fileNameLen;
+    }
+
+    /* Copy over the file name. The separating slash will have already been set. */
+    fs_strcpy(pIteratorPosix->pFullFilePath + pIteratorPosix->directoryPathLen + 1, info->d_name);
+
+    /* The pFileName member of the base iterator needs to be set to the file name. */
+    pIteratorPosix->iterator.pName   = pIteratorPosix->pFullFilePath + pIteratorPosix->directoryPathLen + 1;
+    pIteratorPosix->iterator.nameLen = fileNameLen;
+
+    /* If we only need names we can avoid the stat() if we know the type of the entry. */
+    #if defined(FS_HAS_DIRENT_TYPE)
+    {
+        #if defined(FS_NO_LSTAT)
+        fs_bool32 isTypeKnown = info->d_type != DT_UNKNOWN && info->d_type != DT_LNK;    /* stat() follows links so we can't know what it points to without it. */
+        #else
+        fs_bool32 isTypeKnown = info->d_type != DT_UNKNOWN;
+        #endif
+
+        if ((pIteratorPosix->mode & FS_NAMES_ONLY) != 0 && isTypeKnown) {
+            memset(&pIteratorPosix->iterator.info, 0, sizeof(pIteratorPosix->iterator.info));
+            pIteratorPosix->iterator.info.directory = info->d_type == DT_DIR;
+            pIteratorPosix->iterator.info.symlink   = info->d_type == DT_LNK;
+
+            return pIteratorPosix;
+        }
+    }
+    #endif
+
+    /* We can now get the file information. */
+    if (fs_stat_path_posix(pIteratorPosix->pFullFilePath, &statInfo) != 0) {
+        fs_free_iterator_posix((fs_iterator*)pIteratorPosix);
+        return NULL;
+    }
+
+    pIteratorPosix->iterator.info = fs_file_info_from_stat_posix(&statInfo);
+
+    return pIteratorPosix;
+}
+
+static fs_iterator* fs_first_ex_posix(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen, int mode)
+{
+    fs_iterator_posix* pIteratorPosix;
+
     /*
     Our input string isn't necessarily null terminated so we'll need to make a copy. This isn't
     the end of the world because we need to keep a copy of it anyway for when we need to stat
     the file for information like it's size.
 
     To do this we're going to allocate memory for our iterator which will include space for the
-    directory path. Then we copy the directory path into the allocated memory and point the
-    pFullFilePath member of the iterator to it. Then we call opendir(). Once that's done we
-    can go to the first file and reallocate the iterator to make room for the file name portion,
-    including the separating slash. Then we copy the file name portion over to the buffer.
+    directory path and the file name. Then we copy the directory path into the allocated memory
+    and point the pFullFilePath member of the iterator to it. Then we call opendir(). Each time
+    we move to an entry we copy the file name over to the buffer, just after the separating slash.
     */
 
     if (directoryPathLen == 0 || pDirectoryPath[0] == '\0') {
@@ -6661,16 +8283,19 @@ static fs_iterator* fs_first_posix(fs* pFS, const char* pDirectoryPath, size_t d
 
     /*
     Now that we know the length of the directory we can allocate space for the iterator. The
-    directory path will be placed at the end of the structure.
+    directory path and file name will be placed at the end of the structure.
     */
-    pIteratorPosix = (fs_iterator_posix*)fs_malloc(FS_MAX(sizeof(*pIteratorPosix) + directoryPathLen + 1, FS_POSIX_MIN_ITERATOR_ALLOCATION_SIZE), fs_get_allocation_callbacks(pFS));    /* +1 for null terminator. */
+    pIteratorPosix = (fs_iterator_posix*)fs_malloc(sizeof(*pIteratorPosix) + directoryPathLen + 1 + FS_POSIX_MAX_FILE_NAME_LEN + 1, fs_get_allocation_callbacks(pFS));    /* +1 for the separator and +1 for null terminator. */
     if (pIteratorPosix == NULL) {
         return NULL;
     }
 
     /* Point pFullFilePath to the end of structure to where the path is located. */
-    pIteratorPosix->pFullFilePath = (char*)pIteratorPosix + sizeof(*pIteratorPosix);
+    pIteratorPosix->iterator.pFS     = pFS;
+    pIteratorPosix->pFullFilePath    = (char*)pIteratorPosix + sizeof(*pIteratorPosix);
     pIteratorPosix->directoryPathLen = directoryPathLen;
+    pIteratorPosix->fileNameCap      = FS_POSIX_MAX_FILE_NAME_LEN;
+    pIteratorPosix->mode             = mode;
 
     /* We can now copy over the directory path. This will null terminate the path which will allow us to call opendir(). */
     fs_strncpy_s(pIteratorPosix->pFullFilePath, directoryPathLen + 1, pDirectoryPath, directoryPathLen);
@@ -6682,97 +8307,20 @@ static fs_iterator* fs_first_posix(fs* pFS, const char* pDirectoryPath, size_t d
         return NULL;
     }
 
-    /* We now need to get information about the first file. */
-    info = readdir(pIteratorPosix->pDir);
-    if (info == NULL) {
-        closedir(pIteratorPosix->pDir);
-        fs_free(pIteratorPosix, fs_get_allocation_callbacks(pFS));
-        return NULL;
-    }
-
-    fileNameLen = strlen(info->d_name);
-
-    /*
-    Now that we have the file name we need to append it to the full file path in the iterator. To do
-    this we need to reallocate the iterator to account for the length of the file name, including the
-    separating slash.
-    */
-    {
-        fs_iterator_posix* pNewIteratorPosix= (fs_iterator_posix*)fs_realloc(pIteratorPosix, FS_MAX(sizeof(*pIteratorPosix) + directoryPathLen + 1 + fileNameLen + 1, FS_POSIX_MIN_ITERATOR_ALLOCATION_SIZE), fs_get_allocation_callbacks(pFS));    /* +1 for null terminator. */
-        if (pNewIteratorPosix == NULL) {
-            closedir(pIteratorPosix->pDir);
-            fs_free(pIteratorPosix, fs_get_allocation_callbacks(pFS));
-            return NULL;
-        }
-
-        pIteratorPosix = pNewIteratorPosix;
-    }
-
-    /* Memory has been allocated. Copy over the separating slash and file name. */
-    pIteratorPosix->pFullFilePath = (char*)pIteratorPosix + sizeof(*pIteratorPosix);
+    /* The separating slash only needs to be set once. File names are placed straight after it. */
     pIteratorPosix->pFullFilePath[directoryPathLen] = '/';
-    fs_strcpy(pIteratorPosix->pFullFilePath + directoryPathLen + 1, info->d_name);
-
-    /* The pFileName member of the base iterator needs to be set to the file name. */
-    pIteratorPosix->iterator.pName   = pIteratorPosix->pFullFilePath + directoryPathLen + 1;
-    pIteratorPosix->iterator.nameLen = fileNameLen;
-
-    /* We can now get the file information. */
-    if (fs_stat_path_posix(pIteratorPosix->pFullFilePath, &statInfo) != 0) {
-        closedir(pIteratorPosix->pDir);
-        fs_free(pIteratorPosix, fs_get_allocation_callbacks(pFS));
-        return NULL;
-    }
 
-    pIteratorPosix->iterator.info = fs_file_info_from_stat_posix(&statInfo);
+    return (fs_iterator*)fs_iterator_posix_read_next(pIteratorPosix);
+}
 
-    return (fs_iterator*)pIteratorPosix;
+static fs_iterator* fs_first_posix(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen)
+{
+    return fs_first_ex_posix(pFS, pDirectoryPath, directoryPathLen, 0);
 }
 
 static fs_iterator* fs_next_posix(fs_iterator* pIterator)
 {
-    fs_iterator_posix* pIteratorPosix = (fs_iterator_posix*)pIterator;
-    struct dirent* info;
-    struct stat statInfo;
-    size_t fileNameLen;
-
-    /* We need to get information about the next file. */
-    info = readdir(pIteratorPosix->pDir);
-    if (info == NULL) {
-        fs_free_iterator_posix((fs_iterator*)pIteratorPosix);
-        return NULL;    /* The end of the directory. */
-    }
-
-    fileNameLen = strlen(info->d_name);
-
-    /* We need to reallocate the iterator to account for the new file name. */
-    {
-        fs_iterator_posix* pNewIteratorPosix = (fs_iterator_posix*)fs_realloc(pIteratorPosix, FS_MAX(sizeof(*pIteratorPosix) + pIteratorPosix->directoryPathLen + 1 + fileNameLen + 1, FS_POSIX_MIN_ITERATOR_ALLOCATION_SIZE), fs_get_allocation_callbacks(pIterator->pFS));    /* +1 for null terminator. */
-        if (pNewIteratorPosix == NULL) {
-            fs_free_iterator_posix((fs_iterator*)pIteratorPosix);
-            return NULL;
-        }
-
-        pIteratorPosix = pNewIteratorPosix;
-    }
-
-    /* Memory has been allocated. Copy over the file name. */
-    pIteratorPosix->pFullFilePath = (char*)pIteratorPosix + sizeof(*pIteratorPosix);
-    fs_strcpy(pIteratorPosix->pFullFilePath + pIteratorPosix->directoryPathLen + 1, info->d_name);
-
-    /* The pFileName member of the base iterator needs to be set to the file name. */
-    pIteratorPosix->iterator.pName   = pIteratorPosix->pFullFilePath + pIteratorPosix->directoryPathLen + 1;
-    pIteratorPosix->iterator.nameLen = fileNameLen;
-
-    /* We can now get the file information. */
-    if (fs_stat_path_posix(pIteratorPosix->pFullFilePath, &statInfo) != 0) {
-        fs_free_iterator_posix((fs_iterator*)pIteratorPosix);
-        return NULL;
-    }
-
-    pIteratorPosix->iterator.info = fs_file_info_from_stat_posix(&statInfo);
-
-    return (fs_iterator*)pIteratorPosix;
+    return (fs_iterator*)fs_iterator_posix_read_next((fs_iterator_posix*)pIterator);
 }
 
 static void fs_free_iterator_posix(fs_iterator* pIterator)
@@ -6805,7 +8353,12 @@ static fs_backend fs_posix_backend =
     fs_file_duplicate_posix,
     fs_first_posix,
     fs_next_posix,
-    fs_free_iterator_posix
+    fs_free_iterator_posix,
+    fs_file_read_at_posix,
+    fs_file_write_at_posix,
+    fs_file_map_posix,
+    fs_file_unmap_posix,
+    fs_first_ex_posix
 };
 
 const fs_backend* FS_BACKEND_POSIX = &fs_posix_backend;
@@ -7766,7 +9319,12 @@ static fs_backend fs_win32_backend =
     fs_file_duplicate_win32,
     fs_first_win32,
     fs_next_win32,
-    fs_free_iterator_win32
+    fs_free_iterator_win32,
+    NULL,   /* file_read_at */
+    NULL,   /* file_write_at */
+    NULL,   /* file_map */
+    NULL,   /* file_unmap */
+    NULL    /* first_ex. FindFirstFile() gives us everything in one go so there's nothing to skip with FS_NAMES_ONLY. */
 };
 
 const fs_backend* FS_BACKEND_WIN32 = &fs_win32_backend;
@@ -9210,6 +10768,57 @@ static fs_result fs_memory_stream_tell_internal(fs_stream* pStream, fs_int64* pC
     return FS_SUCCESS;
 }
 
+static fs_result fs_memory_stream_read_at_internal(fs_stream* pStream, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead)
+{
+    fs_memory_stream* pMemoryStream = (fs_memory_stream*)pStream;
+    size_t dataSize;
+    size_t bytesRead;
+
+    dataSize = *pMemoryStream->pDataSize;
+
+    if ((fs_uint64)offset >= dataSize) {
+        return FS_AT_END;
+    }
+
+    bytesRead = FS_MIN(dataSize - (size_t)offset, bytesToRead);
+    FS_COPY_MEMORY(pDst, FS_OFFSET_PTR(*pMemoryStream->ppData, (size_t)offset), bytesRead);
+
+    *pBytesRead = bytesRead;
+
+    return FS_SUCCESS;
+}
+
+static fs_result fs_memory_stream_write_at_internal(fs_stream* pStream, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    fs_memory_stream* pMemoryStream = (fs_memory_stream*)pStream;
+    fs_result result;
+    size_t cursor;
+
+    /* Memory streams are not thread-safe anyway so we can just temporarily move the cursor. */
+    cursor = pMemoryStream->cursor;
+
+    result = fs_memory_stream_seek(pMemoryStream, offset, FS_SEEK_SET);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    result = fs_memory_stream_write(pMemoryStream, pSrc, bytesToWrite, pBytesWritten);
+
+    pMemoryStream->cursor = cursor;
+
+    return result;
+}
+
+static fs_result fs_memory_stream_map_internal(fs_stream* pStream, const void** ppData, size_t* pDataSize)
+{
+    fs_memory_stream* pMemoryStream = (fs_memory_stream*)pStream;
+
+    *ppData    = *pMemoryStream->ppData;
+    *pDataSize = *pMemoryStream->pDataSize;
+
+    return FS_SUCCESS;
+}
+
 static size_t fs_memory_stream_duplicate_alloc_size_internal(fs_stream* pStream)
 {
     (void)pStream;
@@ -9265,7 +10874,10 @@ static fs_stream_vtable fs_gStreamVTableMemory =
     fs_memory_stream_tell_internal,
     fs_memory_stream_duplicate_alloc_size_internal,
     fs_memory_stream_duplicate_internal,
-    fs_memory_stream_uninit_internal
+    fs_memory_stream_uninit_internal,
+    fs_memory_stream_read_at_internal,
+    fs_memory_stream_write_at_internal,
+    fs_memory_stream_map_internal
 };
 
 
@@ -9587,24 +11199,34 @@ static FS_INLINE void fs_swap(void* a, void* b, size_t sz)
     char* _a = (char*)a;
     char* _b = (char*)b;
 
+    /* Swap in chunks through a small temporary buffer rather than byte-by-byte. The compiler can turn these copies into wide moves. */
     while (sz > 0) {
-        char temp = *_a;
-        *_a++ = *_b;
-        *_b++ = temp;
-        sz -= 1;
+        char temp[64];
+        size_t chunkSize = FS_MIN(sz, sizeof(temp));
+
+        FS_COPY_MEMORY(temp, _a, chunkSize);
+        FS_COPY_MEMORY(_a, _b, chunkSize);
+        FS_COPY_MEMORY(_b, temp, chunkSize);
+
+        _a += chunkSize;
+        _b += chunkSize;
+        sz -= chunkSize;
     }
 }
 
-FS_API void fs_sort(void* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData)
+#ifndef FS_SORT_INSERTION_THRESHOLD
+#define FS_SORT_INSERTION_THRESHOLD 16
+#endif
+
+static void fs_sort_insertion(char* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData)
 {
-    /* Simple insert sort for now. Will improve on this later. */
     size_t i;
     size_t j;
 
     for (i = 1; i < count; i += 1) {
         for (j = i; j > 0; j -= 1) {
-            void* pA = (char*)pBase + (j - 1) * stride;
-            void* pB = (char*)pBase + j * stride;
+            void* pA = pBase + (j - 1) * stride;
+            void* pB = pBase + j * stride;
 
             if (compareProc(pUserData, pA, pB) <= 0) {
                 break;
@@ -9615,6 +11237,208 @@ FS_API void fs_sort(void* pBase, size_t count, size_t stride, int (*compareProc)
     }
 }
 
+static void fs_sort_reverse(char* pBase, size_t count, size_t stride)
+{
+    char* pLo;
+    char* pHi;
+
+    if (count < 2) {
+        return;
+    }
+
+    pLo = pBase;
+    pHi = pBase + (count - 1) * stride;
+    while (pLo < pHi) {
+        fs_swap(pLo, pHi, stride);
+        pLo += stride;
+        pHi -= stride;
+    }
+}
+
+static void fs_sort_rotate(char* pBase, size_t leftCount, size_t rightCount, size_t stride)
+{
+    /* Swaps the left and right blocks by doing three reversals. */
+    fs_sort_reverse(pBase,                      leftCount,              stride);
+    fs_sort_reverse(pBase + leftCount * stride, rightCount,             stride);
+    fs_sort_reverse(pBase,                      leftCount + rightCount, stride);
+}
+
+static void fs_sort_merge_in_place(char* pBase, size_t leftCount, size_t rightCount, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData)
+{
+    /*
+    This is the fallback for when the temporary buffer is too small. It splits the larger run in half,
+    finds the matching cut in the other run with a binary search, rotates the middle two blocks into
+    place and then recurses on each side. It's slower than the buffered merge, but it's still stable and
+    doesn't need any memory.
+    */
+    size_t leftCut;
+    size_t rightCut;
+    size_t lo;
+    size_t hi;
+    char* pMid;
+
+    if (leftCount == 0 || rightCount == 0) {
+        return;
+    }
+
+    if (leftCount + rightCount == 2) {
+        if (compareProc(pUserData, pBase + stride, pBase) < 0) {
+            fs_swap(pBase, pBase + stride, stride);
+        }
+
+        return;
+    }
+
+    pMid = pBase + leftCount * stride;
+
+    if (leftCount > rightCount) {
+        /* Find the first item in the right run that is not less than the pivot (lower bound). */
+        leftCut = leftCount / 2;
+        lo = 0;
+        hi = rightCount;
+        while (lo < hi) {
+            size_t m = lo + (hi - lo) / 2;
+            if (compareProc(pUserData, pMid + m * stride, pBase + leftCut * stride) < 0) {
+                lo = m + 1;
+            } else {
+                hi = m;
+            }
+        }
+
+        rightCut = lo;
+    } else {
+        /* Find the first item in the left run that is greater than the pivot (upper bound). */
+        rightCut = rightCount / 2;
+        lo = 0;
+        hi = leftCount;
+        while (lo < hi) {
+            size_t m = lo + (hi - lo) / 2;
+            if (compareProc(pUserData, pMid + rightCut * stride, pBase + m * stride) < 0) {
+                hi = m;
+            } else {
+                lo = m + 1;
+            }
+        }
+
+        leftCut = lo;
+    }
+
+    fs_sort_rotate(pBase + leftCut * stride, leftCount - leftCut, rightCut, stride);
+
+    fs_sort_merge_in_place(pBase,                                  leftCut,              rightCut,              stride, compareProc, pUserData);
+    fs_sort_merge_in_place(pBase + (leftCut + rightCut) * stride, leftCount - leftCut, rightCount - rightCut, stride, compareProc, pUserData);
+}
+
+static void fs_sort_merge(char* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData, char* pTemp, size_t tempSize)
+{
+    size_t mid;
+    char* pLeft;
+    char* pLeftEnd;
+    char* pRight;
+    char* pRightEnd;
+    char* pDst;
+
+    if (count <= FS_SORT_INSERTION_THRESHOLD) {
+        fs_sort_insertion(pBase, count, stride, compareProc, pUserData);
+        return;
+    }
+
+    mid = count / 2;
+
+    fs_sort_merge(pBase,                mid,         stride, compareProc, pUserData, pTemp, tempSize);
+    fs_sort_merge(pBase + mid * stride, count - mid, stride, compareProc, pUserData, pTemp, tempSize);
+
+    /* If the two halves are already in order there's nothing to merge. This makes already sorted input linear. */
+    if (compareProc(pUserData, pBase + (mid - 1) * stride, pBase + mid * stride) <= 0) {
+        return;
+    }
+
+    /* If the left half doesn't fit in the temporary buffer we need to merge in place. */
+    if (mid * stride > tempSize) {
+        fs_sort_merge_in_place(pBase, mid, count - mid, stride, compareProc, pUserData);
+        return;
+    }
+
+    /*
+    Move the left half out of the way and then merge back into place. The right half never needs to be
+    moved because the write cursor can never overtake the read cursor of the right half.
+    */
+    FS_COPY_MEMORY(pTemp, pBase, mid * stride);
+
+    pLeft     = pTemp;
+    pLeftEnd  = pTemp + mid * stride;
+    pRight    = pBase + mid * stride;
+    pRightEnd = pBase + count * stride;
+    pDst      = pBase;
+
+    while (pLeft < pLeftEnd && pRight < pRightEnd) {
+        /* Only take from the right when it's strictly less so that equal items keep their order. */
+        if (compareProc(pUserData, pRight, pLeft) < 0) {
+            FS_COPY_MEMORY(pDst, pRight, stride);
+            pRight += stride;
+        } else {
+            FS_COPY_MEMORY(pDst, pLeft, stride);
+            pLeft += stride;
+        }
+
+        pDst += stride;
+    }
+
+    /* Anything remaining in the right half is already in place. */
+    if (pLeft < pLeftEnd) {
+        FS_COPY_MEMORY(pDst, pLeft, (size_t)(pLeftEnd - pLeft));
+    }
+}
+
+static void fs_sort_internal(void* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData, fs_bool32 allowAllocation, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    /*
+    This is a stable merge sort. It wants a temporary buffer the size of half the list. Small lists will
+    use a stack buffer, otherwise we'll try allocating one when allowed to. When we can't allocate, or the
+    allocation fails, we keep the stack buffer and merge any runs that don't fit into it in place, which
+    is slower but still stable.
+    */
+    char  pTempStack[4096];
+    char* pTempHeap = NULL;
+    char* pTemp;
+    size_t tempSize;
+
+    if (pBase == NULL || count < 2 || stride == 0 || compareProc == NULL) {
+        return;
+    }
+
+    if (count <= FS_SORT_INSERTION_THRESHOLD) {
+        fs_sort_insertion((char*)pBase, count, stride, compareProc, pUserData);
+        return;
+    }
+
+    pTemp    = pTempStack;
+    tempSize = sizeof(pTempStack);
+
+    if ((count / 2) * stride > sizeof(pTempStack) && allowAllocation) {
+        pTempHeap = (char*)fs_malloc((count / 2) * stride, pAllocationCallbacks);
+        if (pTempHeap != NULL) {
+            pTemp    = pTempHeap;
+            tempSize = (count / 2) * stride;
+        }
+    }
+
+    fs_sort_merge((char*)pBase, count, stride, compareProc, pUserData, pTemp, tempSize);
+
+    fs_free(pTempHeap, pAllocationCallbacks);
+}
+
+FS_API void fs_sort_ex(void* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_sort_internal(pBase, count, stride, compareProc, pUserData, FS_TRUE, pAllocationCallbacks);
+}
+
+FS_API void fs_sort(void* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData)
+{
+    /* This version never allocates. Use fs_sort_ex() if you want large lists to use a heap allocated buffer. */
+    fs_sort_internal(pBase, count, stride, compareProc, pUserData, FS_FALSE, NULL);
+}
+
 FS_API void* fs_binary_search(const void* pKey, const void* pList, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData)
 {
     size_t iStart;
@@ -268,6 +268,20 @@ if (result != FS_SUCCESS) {
 In the example above, opening the file will fail because `FS_OPAQUE` is telling the library to
 treat archives as if they're totally opaque which means the files within cannot be accessed.
 
+If you rely on transparent mode for a lot of lookups, you can have the library remember how each
+path was resolved by setting `resolutionCacheSize` in the config:
+
+```c
+fsConfig.resolutionCacheSize = 1024;
+```
+
+With this set, the library will remember which archive a path was found in, and which paths could
+not be found in any archive, so that repeated lookups of the same path skip the directory scan. The
+cache is cleared when the `fs` object mounts, unmounts, removes, renames, creates directories or
+opens a file for writing. Changes made to the file system by anything other than the `fs` object
+itself are not detected, so you should only enable this when the underlying files will not be
+changing while the `fs` object is in use.
+
 Up to this point the handling of archives has been done automatically via `fs_file_open()`, however
 the library allows you to manage archives manually. To do this you just initialize a `fs` object to
 represent the archive:
@@ -1076,6 +1090,7 @@ typedef unsigned int  fs_bool32;
         #include <pthread.h>
         typedef pthread_t       fs_pthread_t;
         typedef pthread_mutex_t fs_pthread_mutex_t;
+        typedef pthread_cond_t  fs_pthread_cond_t;
     #else
         /*
         If you have opted into not including pthread.h in the header section, you need to
@@ -1084,6 +1099,7 @@ typedef unsigned int  fs_bool32;
         */
         typedef fs_uintptr      fs_pthread_t;
         typedef union           fs_pthread_mutex_t { char __data[40]; fs_uint64 __alignment; } fs_pthread_mutex_t;
+        typedef union           fs_pthread_cond_t  { char __data[48]; fs_uint64 __alignment; } fs_pthread_cond_t;
     #endif
 #endif
 /* END fs_thread_basic_types.h */
@@ -1209,14 +1225,81 @@ FS_API fs_result fs_mtx_unlock(fs_mtx* mutex);
 /* END fs_thread_mtx.h */
 
 
+/* BEG fs_thread_rwlock.h */
+/*
+Reader-writer lock. Any number of threads can hold the lock for reading at the same time, but a
+thread holding it for writing has it to itself. These are not recursive. A thread that already
+holds the lock must not try to lock it again, even for reading, because a waiting writer will
+block new readers.
+*/
+#if defined(FS_WIN32)
+    typedef struct
+    {
+        void* ptr;  /* SRWLOCK */
+    } fs_rwlock;
+#else
+    /* As with recursive mutexes, old compilers and `-std=c89` don't get pthread_rwlock_t. */
+    #if !defined(FS_USE_MANUAL_RWLOCK) && !defined(__STDC_VERSION__)
+        #define FS_USE_MANUAL_RWLOCK
+    #endif
+
+    #if !defined(FS_USE_MANUAL_RWLOCK) && (!defined(__USE_UNIX98) && !defined(__USE_XOPEN2K))
+        #define FS_USE_MANUAL_RWLOCK
+    #endif
+
+    #ifdef FS_USE_MANUAL_RWLOCK
+        typedef struct
+        {
+            fs_pthread_mutex_t mutex;   /* Guards the counters below. */
+            fs_pthread_cond_t cond;     /* Signalled whenever the lock is released. */
+            int readerCount;            /* The number of threads holding the lock for reading. */
+            int writerCount;            /* Set to 1 while a thread holds the lock for writing. */
+            int waitingWriterCount;     /* New readers wait while there are writers waiting so that writers aren't starved. */
+        } fs_rwlock;
+    #elif !defined(FS_NO_PTHREAD_IN_HEADER)
+        typedef pthread_rwlock_t fs_rwlock;
+    #else
+        typedef union fs_rwlock { char __data[56]; fs_uint64 __alignment; } fs_rwlock;
+    #endif
+#endif
+
+FS_API fs_result fs_rwlock_init(fs_rwlock* rwlock);
+FS_API void fs_rwlock_destroy(fs_rwlock* rwlock);
+FS_API fs_result fs_rwlock_lock_read(fs_rwlock* rwlock);
+FS_API fs_result fs_rwlock_unlock_read(fs_rwlock* rwlock);
+FS_API fs_result fs_rwlock_lock_write(fs_rwlock* rwlock);
+FS_API fs_result fs_rwlock_unlock_write(fs_rwlock* rwlock);
+/* END fs_thread_rwlock.h */
+
+
+/* BEG fs_thread_thrd.h */
+/*
+Basic thread support. This is only used internally for things like building indexes across multiple
+threads. It's exposed publicly so backends can make use of it.
+*/
+typedef struct fs_allocation_callbacks fs_allocation_callbacks;
+
+#if defined(FS_WIN32) && !defined(FS_USE_PTHREAD)
+    typedef void* fs_thrd;  /* HANDLE, CreateThread() */
+#else
+    typedef fs_pthread_t fs_thrd;
+#endif
+
+typedef int (* fs_thrd_start_t)(void*);
+
+FS_API fs_result fs_thrd_create(fs_thrd* thr, fs_thrd_start_t func, void* arg, const fs_allocation_callbacks* pAllocationCallbacks);
+FS_API fs_result fs_thrd_join(fs_thrd thr, int* res);
+/* END fs_thread_thrd.h */
+
+
 /* BEG fs_allocation_callbacks.h */
-typedef struct fs_allocation_callbacks
+struct fs_allocation_callbacks
 {
     void* pUserData;
     void* (* onMalloc )(size_t sz, void* pUserData);
     void* (* onRealloc)(void* p, size_t sz, void* pUserData);
     void  (* onFree   )(void* p, void* pUserData);
-} fs_allocation_callbacks;
+};
 
 FS_API void* fs_malloc(size_t sz, const fs_allocation_callbacks* pAllocationCallbacks);
 FS_API void* fs_calloc(size_t sz, const fs_allocation_callbacks* pAllocationCallbacks);
@@ -1239,6 +1322,14 @@ To implement a custom stream, such as a memory stream, or a file stream, you nee
 The stream vtable can support both reading and writing, but it doesn't need to support both at
 the same time. If one is not supported, simply leave the relevant `read` or `write` callback as
 `NULL`, or have them return FS_NOT_IMPLEMENTED.
+
+A stream can optionally support positional reads with `read_at`. This reads from an absolute offset
+and does not use or change the cursor. When the stream used to initialize an `fs` object supports
+positional reads, files opened from that `fs` object will share it rather than duplicating it, which
+for file streams means no extra file descriptor is opened for each file.
+
+A stream can also optionally support `map` which returns a pointer to the entire contents of the
+stream. Archive backends can use this to give direct access to uncompressed data without copying.
 */
 
 typedef enum fs_seek_origin
@@ -1262,6 +1353,9 @@ struct fs_stream_vtable
     fs_result (* duplicate           )(fs_stream* pStream, fs_stream* pDuplicatedStream);   /* Optional. Duplicate the stream. */
     void      (* uninit              )(fs_stream* pStream);                                 /* Optional. Uninitialize the stream. */
     /* END fs_stream_vtable_duplicate */
+    fs_result (* read_at             )(fs_stream* pStream, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead);  /* Optional. Read from an absolute offset without using or changing the cursor. Must be safe to call from multiple threads at the same time. */
+    fs_result (* write_at            )(fs_stream* pStream, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten);    /* Optional. Write to an absolute offset without using or changing the cursor. */
+    fs_result (* map                 )(fs_stream* pStream, const void** ppData, size_t* pDataSize);   /* Optional. Retrieve a pointer to the entire contents of the stream without copying. The pointer must remain valid until the stream is uninitialized or written to. */
 };
 
 struct fs_stream
@@ -1275,6 +1369,33 @@ FS_API fs_result fs_stream_write(fs_stream* pStream, const void* pSrc, size_t by
 FS_API fs_result fs_stream_seek(fs_stream* pStream, fs_int64 offset, fs_seek_origin origin);
 FS_API fs_result fs_stream_tell(fs_stream* pStream, fs_int64* pCursor);
 
+/*
+Reads from an absolute offset without using or changing the cursor.
+
+Returns FS_NOT_IMPLEMENTED if the stream does not support positional reads, in which case you'll
+need to use `fs_stream_seek()` and `fs_stream_read()` instead. Like `fs_stream_read()`, this will
+return FS_AT_END if the offset is at or beyond the end of the stream.
+*/
+FS_API fs_result fs_stream_read_at(fs_stream* pStream, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead);
+
+/*
+Writes to an absolute offset without using or changing the cursor.
+
+Returns FS_NOT_IMPLEMENTED if the stream does not support positional writes.
+*/
+FS_API fs_result fs_stream_write_at(fs_stream* pStream, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten);
+
+/*
+Retrieves a read-only pointer to the entire contents of the stream without copying.
+
+This is only supported by streams that can provide this cheaply, such as read-only memory streams
+and files whose backend supports memory mapping. It returns FS_NOT_IMPLEMENTED otherwise. It will
+never fall back to reading the stream into memory.
+
+The pointer remains valid until the stream is uninitialized or written to. This is not thread-safe.
+*/
+FS_API fs_result fs_stream_map(fs_stream* pStream, const void** ppData, size_t* pDataSize);
+
 /* BEG fs_stream_writef.h */
 FS_API fs_result fs_stream_writef(fs_stream* pStream, const char* fmt, ...) FS_ATTRIBUTE_FORMAT(2, 3);
 FS_API fs_result fs_stream_writef_ex(fs_stream* pStream, const fs_allocation_callbacks* pAllocationCallbacks, const char* fmt, ...) FS_ATTRIBUTE_FORMAT(3, 4);
@@ -1308,7 +1429,12 @@ The format (FS_FORMAT_TEXT or FS_FORMAT_BINARY) is used to determine whether or
 appended to the end of the data.
 
 For flexibility in case the backend does not support cursor retrieval or positioning, the data will be read
-in fixed sized chunks.
+into a buffer that grows geometrically until the end of the stream is reached.
+
+If you know roughly how much data is remaining in the stream you can pass it in as `sizeHint` with
+`fs_stream_read_to_end_ex()`. The buffer will be allocated to that size up front so the data can be read in with
+a single allocation. The hint does not need to be exact - if the stream turns out to be bigger the buffer will
+grow as normal. Set it to 0 if the size is unknown.
 */
 
 typedef enum fs_format
@@ -1318,6 +1444,7 @@ typedef enum fs_format
 } fs_format;
 
 FS_API fs_result fs_stream_read_to_end(fs_stream* pStream, fs_format format, const fs_allocation_callbacks* pAllocationCallbacks, void** ppData, size_t* pDataSize);
+FS_API fs_result fs_stream_read_to_end_ex(fs_stream* pStream, fs_format format, fs_uint64 sizeHint, const fs_allocation_callbacks* pAllocationCallbacks, void** ppData, size_t* pDataSize);
 /* END fs_stream_helpers.h */
 /* END fs_stream.h */
 
@@ -1472,6 +1599,8 @@ Open Mode Flags
 
 #define FS_NO_INCREMENT_REFCOUNT    0x8000  /* Do not use. Internal use only. Used with fs_open_archive_ex() internally. */
 
+#define FS_NAMES_ONLY               0x10000 /* Used by: fs_first() */
+
 
 /* Garbage collection policies.*/
 #define FS_GC_POLICY_THRESHOLD      0x0001  /* Only garbage collect unreferenced opened archives until the count is below the configured threshold. */
@@ -1570,6 +1699,7 @@ struct fs_config
     size_t archiveTypeCount;
     fs_on_refcount_changed_proc onRefCountChanged;
     void* pRefCountChangedUserData;
+    size_t resolutionCacheSize;     /* The number of transparent archive lookups to remember. Set to 0 to disable. */
     const fs_allocation_callbacks* pAllocationCallbacks;
 };
 
@@ -1587,7 +1717,7 @@ struct fs_backend
     fs_result    (* mkdir           )(fs* pFS, const char* pPath);                                           /* This is not recursive. Return FS_ALREADY_EXISTS if directory already exists. Return FS_DOES_NOT_EXIST if a parent directory does not exist. */
     fs_result    (* info            )(fs* pFS, const char* pPath, int openMode, fs_file_info* pInfo);        /* openMode flags can be ignored by most backends. It's primarily used by passthrough style backends. */
     size_t       (* file_alloc_size )(fs* pFS);
-    fs_result    (* file_open       )(fs* pFS, fs_stream* pStream, const char* pFilePath, int openMode, fs_file* pFile); /* Return 0 on success or an errno result code on error. Return FS_DOES_NOT_EXIST if the file does not exist. pStream will be null if the backend does not need a stream (the `pFS` object was not initialized with one). */
+    fs_result    (* file_open       )(fs* pFS, fs_stream* pStream, const char* pFilePath, int openMode, fs_file* pFile); /* Return 0 on success or an errno result code on error. Return FS_DOES_NOT_EXIST if the file does not exist. pStream will be null if the backend does not need a stream (the `pFS` object was not initialized with one). With FS_WRITE, pStream is a read-only view of the `pFS` stream, or null if it can't be shared. */
     void         (* file_close      )(fs_file* pFile);
     fs_result    (* file_read       )(fs_file* pFile, void* pDst, size_t bytesToRead, size_t* pBytesRead);   /* Return 0 on success, or FS_AT_END on end of file. Only return FS_AT_END if *pBytesRead is 0. Return an errno code on error. Implementations must support reading when already at EOF, in which case FS_AT_END should be returned and *pBytesRead should be 0. */
     fs_result    (* file_write      )(fs_file* pFile, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten);
@@ -1600,6 +1730,11 @@ struct fs_backend
     fs_iterator* (* first           )(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen);
     fs_iterator* (* next            )(fs_iterator* pIterator);  /* <-- Must return null when there are no more files. In this case, free_iterator must be called internally. */
     void         (* free_iterator   )(fs_iterator* pIterator);  /* <-- Free the `fs_iterator` object here since `first` and `next` were the ones who allocated it. Also do any uninitialization routines. */
+    fs_result    (* file_read_at    )(fs_file* pFile, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead);   /* Optional. Read from an absolute offset without changing the cursor. Must be thread-safe. Same return semantics as file_read. */
+    fs_result    (* file_write_at   )(fs_file* pFile, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten);  /* Optional. Write to an absolute offset without changing the cursor. Must be thread-safe. */
+    fs_result    (* file_map        )(fs_file* pFile, const void** ppData, size_t* pDataSize);  /* Optional. Map the whole file read-only. Return FS_NOT_IMPLEMENTED to fall back to reading the file into memory. */
+    void         (* file_unmap      )(fs_file* pFile, const void* pData, size_t dataSize);      /* Optional. Only called for mappings returned by file_map. */
+    fs_iterator* (* first_ex        )(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen, int mode);  /* Optional. The same as first, but with the iteration mode. If FS_NAMES_ONLY is set, only the name and the directory flag need to be set. When null, first is used instead. */
 };
 
 /*
@@ -2558,6 +2693,89 @@ fs_file_write()
 */
 FS_API fs_result fs_file_tell(fs_file* pFile, fs_int64* pCursor);
 
+/*
+Reads data from an absolute offset in a file without using or changing the cursor.
+
+This is useful when multiple threads want to read from the same file handle. When the backend
+supports positional reads natively (`pread()` with the POSIX backend) no locking or seeking is
+required and it is safe to call this from multiple threads at the same time.
+
+When the backend does not support positional reads it will be emulated with a seek and a read,
+after which the cursor is restored. The emulated path is not thread-safe.
+
+
+Parameters
+----------
+pFile : (in)
+    A pointer to the file to read from. Must not be NULL.
+
+offset : (in)
+    The absolute offset in bytes from the start of the file to read from. Must not be negative.
+
+pDst : (out)
+    A pointer to the buffer that will receive the read data. Must not be NULL.
+
+bytesToRead : (in)
+    The maximum number of bytes to read from the file.
+
+pBytesRead : (out, optional)
+    A pointer to a variable that will receive the number of bytes actually read. If NULL, the
+    function will return an error if not all requested bytes could be read.
+
+
+Return Value
+------------
+Same as `fs_file_read()`.
+
+
+See Also
+--------
+fs_file_read()
+fs_file_write_at()
+*/
+FS_API fs_result fs_file_read_at(fs_file* pFile, fs_int64 offset, void* pDst, size_t bytesToRead, size_t* pBytesRead);
+
+/*
+Writes data to an absolute offset in a file without using or changing the cursor.
+
+This maps to `pwrite()` with the POSIX backend. Backends without native support will emulate it
+with a seek and a write, after which the cursor is restored. The emulated path is not thread-safe.
+
+If the file was opened with `FS_APPEND`, whether or not the offset is respected depends on the
+backend. With the POSIX backend on Linux the data will be appended to the end of the file.
+
+
+Parameters
+----------
+pFile : (in)
+    A pointer to the file to write to. Must not be NULL.
+
+offset : (in)
+    The absolute offset in bytes from the start of the file to write to. Must not be negative.
+
+pSrc : (in)
+    A pointer to the buffer containing the data to write. Must not be NULL.
+
+bytesToWrite : (in)
+    The number of bytes to write to the file.
+
+pBytesWritten : (out, optional)
+    A pointer to a variable that will receive the number of bytes actually written. If NULL, the
+    function will return an error if not all requested bytes could be written.
+
+
+Return Value
+------------
+Same as `fs_file_write()`.
+
+
+See Also
+--------
+fs_file_write()
+fs_file_read_at()
+*/
+FS_API fs_result fs_file_write_at(fs_file* pFile, fs_int64 offset, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten);
+
 
 /*
 Flushes any buffered data to disk.
@@ -2644,6 +2862,66 @@ Returns FS_SUCCESS on success; any other result code otherwise.
 */
 FS_API fs_result fs_file_duplicate(fs_file* pFile, fs_file** ppDuplicate);
 
+/*
+Maps the entire contents of a file into memory for reading.
+
+With the POSIX backend this uses `mmap()` which means the data is not copied and can be shared with
+other processes through the page cache. Backends that can't map files will fall back to reading the
+entire file into a heap allocation, in which case the result is the same, just without the benefits
+of a real mapping.
+
+A file can only have one mapping at a time. Calling this again on a file that is already mapped
+will return the existing mapping. The mapping stays valid until `fs_file_unmap()` is called or the
+file is closed, whichever comes first.
+
+The returned data is read-only. Do not modify it. The file must have been opened with `FS_READ`. If
+the underlying file is truncated by another process while it's mapped, accessing the mapping may
+crash. An empty file will return FS_SUCCESS with a NULL pointer and a size of 0.
+
+
+Parameters
+----------
+pFile : (in)
+    A pointer to the file to map. Must not be NULL.
+
+ppData : (out)
+    A pointer to a variable that will receive a pointer to the mapped data. Must not be NULL.
+
+pDataSize : (out)
+    A pointer to a variable that will receive the size of the mapped data in bytes. Must not be NULL.
+
+
+Return Value
+------------
+Returns FS_SUCCESS on success; any other result code otherwise. Returns FS_TOO_BIG if the file is
+too big to fit in the address space.
+
+
+See Also
+--------
+fs_file_unmap()
+*/
+FS_API fs_result fs_file_map(fs_file* pFile, const void** ppData, size_t* pDataSize);
+
+/*
+Releases a mapping created with `fs_file_map()`.
+
+Any pointers returned by `fs_file_map()` are invalid after calling this. It is safe to call this if
+the file is not mapped. You do not need to call this before closing the file.
+
+
+Parameters
+----------
+pFile : (in)
+    A pointer to the file to unmap.
+
+
+See Also
+--------
+fs_file_map()
+*/
+FS_API void fs_file_unmap(fs_file* pFile);
+
 /*
 Retrieves the backend-specific data associated with a file.
 
@@ -2778,6 +3056,12 @@ See `fs_file_open()` for a description of the available flags that can be used i
 parameter. When `FS_WRITE` is specified, it will look at write mounts. Otherwise, it will look at
 read mounts.
 
+If you only need the name of each entry and whether or not it's a directory, you can use
+`FS_NAMES_ONLY`. This allows backends to skip the work of retrieving the full file information for
+each entry, which can make a big difference for large directories. For the POSIX backend this will
+avoid a `stat()` call for each entry where possible. When this is used, only the `directory` member
+of `info` is guaranteed to be set. Everything else may be zero.
+
 
 Parameter
 ---------
@@ -3372,8 +3656,9 @@ fs_get_allocation_callbacks() if necessary, like so:
 The format (FS_FORMAT_TEXT or FS_FORMAT_BINARY) is used to determine whether or not a null terminator should be
 appended to the end of the data.
 
-For flexibility in case the backend does not support cursor retrieval or positioning, the data will be read
-in fixed sized chunks.
+The size of the file is used to allocate the buffer up front so the data can usually be read with a single
+allocation. If the backend cannot report the size or cursor position, the data will be read into a buffer that
+grows as required.
 */
 FS_API fs_result fs_file_read_to_end(fs_file* pFile, fs_format format, void** ppData, size_t* pDataSize);
 FS_API fs_result fs_file_open_and_read(fs* pFS, const char* pFilePath, fs_format format, void** ppData, size_t* pDataSize);
@@ -3691,7 +3976,8 @@ FS_API void* fs_memory_stream_take_ownership(fs_memory_stream* pStream, size_t*
 
 
 /* BEG fs_utils.h */
-FS_API void fs_sort(void* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData);
+FS_API void fs_sort(void* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData);  /* Stable. Never allocates. */
+FS_API void fs_sort_ex(void* pBase, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData, const fs_allocation_callbacks* pAllocationCallbacks);  /* Same as fs_sort(), but large lists will use a temporary buffer allocated with pAllocationCallbacks. As with other APIs, NULL means the default allocator. */
 FS_API void* fs_binary_search(const void* pKey, const void* pList, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData);
 FS_API void* fs_linear_search(const void* pKey, const void* pList, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData);
 FS_API void* fs_sorted_search(const void* pKey, const void* pList, size_t count, size_t stride, int (*compareProc)(void*, const void*, const void*), void* pUserData);
@@ -2,3 +2,4 @@
 
 xxd -i -n fs_test_file_test1_zip test1.zip > test1.zip.c
 xxd -i -n fs_test_file_test2_zip test2.zip > test2.zip.c
+xxd -i -n fs_test_file_test3_zip test3.zip > test3.zip.c
@@ -0,0 +1,292 @@
+unsigned char fs_test_file_test3_zip[] = {
+  0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0x21, 0x5a, 0x17, 0xec, 0x3b, 0x47, 0x11, 0x0d, 0x00, 0x00, 0x00, 0x00,
+  0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x64, 0x61, 0x74, 0x61, 0x2e, 0x62,
+  0x69, 0x6e, 0xed, 0xcf, 0xe7, 0x22, 0x10, 0x0c, 0x03, 0x80, 0x51, 0xa2,
+  0x48, 0x89, 0x14, 0x2d, 0x21, 0x15, 0x65, 0xb5, 0xd0, 0x12, 0xd2, 0x90,
+  0x86, 0x6c, 0x32, 0x5b, 0xb2, 0x49, 0x4b, 0x91, 0xd1, 0x22, 0x1a, 0x28,
+  0x0d, 0x2a, 0xb2, 0x47, 0xca, 0xca, 0x28, 0xb3, 0xbd, 0x34, 0x48, 0x85,
+  0x52, 0x29, 0x94, 0x91, 0x5d, 0xbd, 0xbb, 0xef, 0xd7, 0xd7, 0x55, 0x3c,
+  0xe7, 0x0e, 0x8e, 0x80, 0xe0, 0x10, 0x21, 0xe1, 0xa1, 0xc3, 0x44, 0x44,
+  0x87, 0x8b, 0x8d, 0x18, 0x29, 0x3e, 0x4a, 0x42, 0x72, 0xb4, 0xd4, 0x98,
+  0xb1, 0xd2, 0x32, 0xe3, 0xc6, 0x4f, 0x98, 0x38, 0x49, 0x76, 0xb2, 0x9c,
+  0xbc, 0xc2, 0x14, 0xc5, 0xa9, 0xd3, 0xa6, 0x2b, 0x29, 0xcf, 0x98, 0xa9,
+  0xa2, 0xaa, 0xa6, 0xae, 0x31, 0x6b, 0xf6, 0x9c, 0xb9, 0xf3, 0x34, 0xb5,
+  0xb4, 0xe7, 0x2f, 0x58, 0xb8, 0x68, 0xb1, 0xce, 0x12, 0x5d, 0x3d, 0xfd,
+  0xa5, 0x06, 0xcb, 0x96, 0xaf, 0x58, 0x69, 0xb8, 0xca, 0x68, 0xf5, 0x9a,
+  0xb5, 0xeb, 0x8c, 0xd7, 0x9b, 0x98, 0x9a, 0x99, 0x5b, 0x58, 0x5a, 0x59,
+  0xdb, 0x6c, 0xb0, 0xb5, 0xb3, 0x77, 0x70, 0x74, 0xda, 0xb8, 0x69, 0xf3,
+  0x96, 0xad, 0xce, 0xdb, 0x5c, 0x5c, 0xdd, 0xdc, 0x3d, 0x3c, 0xbd, 0xbc,
+  0x7d, 0xb6, 0xfb, 0xee, 0xd8, 0xb9, 0x6b, 0xf7, 0x1e, 0xbf, 0xbd, 0xfb,
+  0xfc, 0x03, 0xf6, 0x07, 0x06, 0x05, 0x87, 0x1c, 0x38, 0x78, 0xe8, 0xf0,
+  0x91, 0xd0, 0xb0, 0xa3, 0xe1, 0x11, 0xc7, 0x8e, 0x9f, 0x38, 0x19, 0x19,
+  0x15, 0x7d, 0xea, 0x74, 0xcc, 0x99, 0xb3, 0xe7, 0xce, 0xc7, 0xc6, 0x5d,
+  0xb8, 0x78, 0x29, 0x3e, 0xe1, 0x72, 0x62, 0x52, 0x72, 0x4a, 0x6a, 0x5a,
+  0x7a, 0x46, 0x66, 0xd6, 0x95, 0xec, 0xab, 0xd7, 0x72, 0x72, 0xf3, 0xf2,
+  0x0b, 0xae, 0x17, 0x16, 0x15, 0x97, 0xdc, 0xb8, 0x59, 0x5a, 0x56, 0x5e,
+  0x51, 0x59, 0x75, 0xeb, 0xf6, 0x9d, 0xbb, 0xf7, 0xee, 0x3f, 0x78, 0xf8,
+  0xe8, 0xf1, 0x93, 0xea, 0xa7, 0xcf, 0x9e, 0xbf, 0xa8, 0xa9, 0x7d, 0x59,
+  0xf7, 0xea, 0xf5, 0x9b, 0xfa, 0x86, 0xc6, 0xb7, 0xef, 0x9a, 0xde, 0x7f,
+  0xf8, 0xd8, 0xfc, 0xe9, 0x73, 0x4b, 0x6b, 0xdb, 0x97, 0xaf, 0xed, 0x1d,
+  0x9d, 0x5d, 0xdf, 0xba, 0x7b, 0x7a, 0xfb, 0xfa, 0x07, 0x06, 0xbf, 0xff,
+  0xf8, 0xf9, 0xc7, 0x9f, 0x7f, 0x09, 0x50, 0xa7, 0x4e, 0x9d, 0x3a, 0x75,
+  0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9,
+  0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e,
+  0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75,
+  0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9,
+  0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e,
+  0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75,
+  0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9,
+  0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e,
+  0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75,
+  0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9,
+  0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e,
+  0x9d, 0x3a, 0x75, 0xea, 0xff, 0xaf, 0x1f, 0x8b, 0x38, 0x71, 0x3c, 0xf2,
+  0x64, 0x74, 0xd4, 0xe9, 0x53, 0x67, 0x62, 0xce, 0x9d, 0x8d, 0x3d, 0x7f,
+  0x21, 0xee, 0xd2, 0xc5, 0x84, 0xf8, 0xc4, 0xcb, 0xc9, 0x49, 0xa9, 0x29,
+  0xe9, 0x69, 0x99, 0x19, 0x57, 0xb2, 0xae, 0x66, 0xe7, 0x5c, 0xcb, 0xcb,
+  0x2d, 0xc8, 0x2f, 0xbc, 0x5e, 0x5c, 0x74, 0xa3, 0xa4, 0xf4, 0x66, 0x79,
+  0x59, 0x65, 0xc5, 0xad, 0xaa, 0x3b, 0xb7, 0xef, 0xdd, 0x7d, 0x70, 0xff,
+  0xd1, 0xc3, 0x27, 0x8f, 0x9f, 0x56, 0x3f, 0x7f, 0x56, 0xf3, 0xe2, 0x65,
+  0xed, 0xab, 0xba, 0x37, 0xaf, 0x1b, 0xea, 0xdf, 0x36, 0x36, 0xbd, 0xfb,
+  0xf0, 0xbe, 0xf9, 0xe3, 0xe7, 0x4f, 0xad, 0x2d, 0x5f, 0xda, 0xda, 0xbf,
+  0x76, 0x76, 0x7c, 0xeb, 0xea, 0xe9, 0xee, 0xeb, 0x1d, 0xe8, 0xff, 0x3e,
+  0xf8, 0xf3, 0xc7, 0x9f, 0x7f, 0xfc, 0x2d, 0x28, 0x20, 0x34, 0x64, 0xa8,
+  0xb0, 0xc8, 0xb0, 0xe1, 0xa2, 0x23, 0xc4, 0xc4, 0x47, 0x4a, 0x8c, 0x1a,
+  0x2d, 0x39, 0x46, 0x4a, 0x7a, 0xec, 0x38, 0x99, 0x09, 0xe3, 0x27, 0x4d,
+  0x9c, 0x2c, 0x2b, 0x2f, 0x37, 0x45, 0x61, 0xaa, 0xe2, 0xf4, 0x69, 0xca,
+  0x4a, 0x33, 0x67, 0xa8, 0xaa, 0xa8, 0xab, 0xcd, 0xd2, 0x98, 0x33, 0x7b,
+  0xde, 0x5c, 0x2d, 0xcd, 0xf9, 0xda, 0x0b, 0x17, 0x2c, 0x5e, 0xb4, 0x44,
+  0x47, 0x4f, 0x77, 0xa9, 0xfe, 0x32, 0x83, 0x15, 0xcb, 0x0d, 0x57, 0x1a,
+  0xad, 0x5a, 0xb3, 0x7a, 0xdd, 0xda, 0xf5, 0xc6, 0xa6, 0x26, 0xe6, 0x66,
+  0x96, 0x16, 0xd6, 0x56, 0x1b, 0x6c, 0xec, 0x6c, 0x1d, 0xec, 0x9d, 0x1c,
+  0x37, 0x6d, 0xdc, 0xb2, 0xd9, 0x79, 0xab, 0xcb, 0x36, 0x37, 0x57, 0x0f,
+  0x77, 0x2f, 0x4f, 0x1f, 0x6f, 0xdf, 0xed, 0x3b, 0x77, 0xec, 0xde, 0xe5,
+  0xb7, 0x67, 0xdf, 0xde, 0x00, 0xff, 0xc0, 0xfd, 0xc1, 0x41, 0x07, 0x42,
+  0x0e, 0x1d, 0x3c, 0x72, 0x38, 0x2c, 0x34, 0xfc, 0x28, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0xfe, 0xbb, 0x3e, 0x69, 0xfc, 0x04,
+  0x39, 0x79, 0xd9, 0xc9, 0x8a, 0x53, 0x15, 0xa6, 0x28, 0x29, 0x4f, 0x9b,
+  0xae, 0xa2, 0x3a, 0x63, 0xa6, 0xc6, 0x2c, 0x35, 0xf5, 0xb9, 0xf3, 0x66,
+  0xcf, 0xd1, 0x9e, 0xaf, 0xa9, 0xb5, 0x68, 0xf1, 0x82, 0x85, 0xba, 0x7a,
+  0x3a, 0x4b, 0x0c, 0x96, 0xe9, 0x2f, 0x5d, 0x69, 0xb8, 0x7c, 0xc5, 0xea,
+  0x35, 0xab, 0x8c, 0x8c, 0xd7, 0xaf, 0x5d, 0x67, 0x66, 0x6e, 0x62, 0x6a,
+  0x65, 0x6d, 0x61, 0x69, 0x6b, 0x67, 0xb3, 0xc1, 0xd1, 0xc9, 0xde, 0x61,
+  0xf3, 0x96, 0x8d, 0x9b, 0xb6, 0xb9, 0x6c, 0x75, 0x76, 0xf7, 0x70, 0x75,
+  0xf3, 0xf6, 0xf1, 0xf4, 0xda, 0xb1, 0x73, 0xbb, 0xef, 0x1e, 0xbf, 0x5d,
+  0xbb, 0xfd, 0x03, 0xf6, 0xee, 0x0b, 0x0a, 0xde, 0x1f, 0x78, 0xf0, 0x50,
+  0xc8, 0x81, 0xd0, 0xb0, 0xc3, 0x47, 0x22, 0x8e, 0x1d, 0x0d, 0x3f, 0x19,
+  0x79, 0xfc, 0xc4, 0xa9, 0xd3, 0x51, 0xd1, 0x67, 0xcf, 0xc5, 0x9c, 0x89,
+  0xbb, 0x70, 0x3e, 0x36, 0x3e, 0xe1, 0xe2, 0xa5, 0xa4, 0xe4, 0xcb, 0x89,
+  0x69, 0xe9, 0x29, 0xa9, 0x59, 0x57, 0x32, 0x32, 0xaf, 0xe5, 0x64, 0x5f,
+  0xcd, 0x2f, 0xc8, 0xcd, 0x2b, 0x2a, 0xbe, 0x5e, 0x78, 0xb3, 0xb4, 0xe4,
+  0x46, 0x45, 0x65, 0x59, 0xf9, 0xed, 0x3b, 0x55, 0xb7, 0xee, 0x3f, 0xb8,
+  0x7b, 0xef, 0xf1, 0x93, 0x87, 0x8f, 0x9e, 0x3d, 0xaf, 0x7e, 0x5a, 0xfb,
+  0xf2, 0x45, 0xcd, 0xeb, 0x37, 0x75, 0xaf, 0x1a, 0xdf, 0xd6, 0x37, 0xbc,
+  0xff, 0xf0, 0xae, 0xe9, 0xd3, 0xe7, 0x8f, 0xcd, 0x6d, 0x5f, 0x5a, 0x5a,
+  0x3b, 0x3a, 0xbf, 0xb6, 0x77, 0xf7, 0x74, 0x7d, 0xeb, 0x1f, 0xe8, 0xed,
+  0xfb, 0xf1, 0x73, 0xf0, 0xfb, 0x5f, 0x7f, 0xff, 0x31, 0x44, 0x48, 0x40,
+  0x70, 0x98, 0x88, 0xf0, 0x50, 0xb1, 0x11, 0xa2, 0xc3, 0x47, 0x49, 0x8c,
+  0x14, 0x97, 0x1a, 0x23, 0x39, 0x5a, 0x66, 0xdc, 0x58, 0xe9, 0x89, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0xfa, 0xef, 0xfa, 0xe5,
+  0xf4, 0xb4, 0xd4, 0x94, 0x2b, 0x59, 0x99, 0x19, 0x39, 0xd7, 0xae, 0x66,
+  0x17, 0xe4, 0xe7, 0xe5, 0x16, 0x17, 0x15, 0x5e, 0x2f, 0xbd, 0x79, 0xa3,
+  0xa4, 0xb2, 0xa2, 0xbc, 0xec, 0xce, 0xed, 0x5b, 0x55, 0x0f, 0xee, 0xdf,
+  0xbb, 0xfb, 0xe4, 0xf1, 0xa3, 0x87, 0xcf, 0x9f, 0x3d, 0xad, 0x7e, 0x59,
+  0x5b, 0xf3, 0xe2, 0xcd, 0xeb, 0x57, 0x75, 0x6f, 0x1b, 0x1b, 0xea, 0x3f,
+  0xbc, 0x6f, 0x7a, 0xf7, 0xf9, 0x53, 0xf3, 0xc7, 0x2f, 0x6d, 0xad, 0x2d,
+  0x9d, 0x1d, 0xed, 0x5f, 0x7b, 0xba, 0xbf, 0x75, 0x0d, 0xf4, 0xf7, 0xf5,
+  0xfe, 0xfc, 0xf1, 0x7d, 0xf0, 0xef, 0xbf, 0xfe, 0x14, 0x1a, 0x22, 0x28,
+  0x20, 0x32, 0x6c, 0xa8, 0xf0, 0x08, 0xb1, 0xe1, 0xa2, 0x12, 0xa3, 0xc4,
+  0x47, 0x8e, 0x91, 0x1a, 0x2d, 0x39, 0x4e, 0x46, 0x7a, 0xec, 0xa4, 0x89,
+  0x13, 0xc6, 0xcb, 0xcb, 0x4d, 0x96, 0x9d, 0xaa, 0x38, 0x45, 0x41, 0x59,
+  0x69, 0xfa, 0x34, 0x55, 0x95, 0x99, 0x33, 0x66, 0x69, 0xa8, 0xab, 0xcd,
+  0x9b, 0x3b, 0x67, 0xf6, 0x7c, 0x6d, 0x2d, 0xcd, 0xc5, 0x8b, 0x16, 0x2e,
+  0xd0, 0xd3, 0x5d, 0xa2, 0xb3, 0xcc, 0x60, 0xa9, 0xbe, 0xe1, 0xca, 0x15,
+  0xcb, 0xd7, 0xac, 0x36, 0x5a, 0xb5, 0xde, 0x78, 0xdd, 0x5a, 0x73, 0x33,
+  0x53, 0x13, 0x6b, 0x2b, 0x4b, 0x0b, 0x3b, 0xdb, 0x0d, 0x36, 0x4e, 0x8e,
+  0x0e, 0xf6, 0x5b, 0x36, 0x6f, 0xda, 0xe8, 0xb2, 0xcd, 0x79, 0xab, 0x87,
+  0xbb, 0x9b, 0xab, 0x8f, 0xb7, 0x97, 0xe7, 0xce, 0x1d, 0xbe, 0xdb, 0xfd,
+  0xf6, 0xec, 0xde, 0x15, 0xe0, 0xbf, 0x6f, 0x6f, 0x70, 0x50, 0xe0, 0xfe,
+  0x43, 0x07, 0x0f, 0x84, 0x84, 0x85, 0x1e, 0x39, 0x7c, 0x2c, 0x22, 0xfc,
+  0x68, 0xe4, 0xc9, 0x13, 0xc7, 0x4f, 0x9f, 0x8a, 0x8e, 0x3a, 0x77, 0xf6,
+  0x4c, 0xcc, 0x85, 0xb8, 0xd8, 0xf3, 0x09, 0xf1, 0x97, 0x2e, 0x26, 0x27,
+  0x25, 0x52, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xbf,
+  0xeb, 0xda, 0xf3, 0x67, 0xcf, 0x99, 0x3b, 0x4f, 0x67, 0x89, 0xae, 0xde,
+  0x82, 0x85, 0x8b, 0x16, 0x2f, 0x5f, 0xb1, 0xd2, 0x50, 0x7f, 0xa9, 0xc1,
+  0xb2, 0xb5, 0xeb, 0x8c, 0xd7, 0xaf, 0x32, 0x5a, 0xbd, 0xc6, 0xc2, 0xd2,
+  0xca, 0xda, 0xc4, 0xd4, 0xcc, 0xdc, 0xde, 0xc1, 0xd1, 0xc9, 0x66, 0x83,
+  0xad, 0xdd, 0x56, 0xe7, 0x6d, 0x2e, 0x1b, 0x37, 0x6d, 0xde, 0xe2, 0xe9,
+  0xe5, 0xed, 0xe3, 0xea, 0xe6, 0xee, 0xb1, 0x6b, 0xf7, 0x1e, 0xbf, 0xed,
+  0xbe, 0x3b, 0x76, 0xee, 0x0f, 0x0c, 0x0a, 0xde, 0xbb, 0xcf, 0x3f, 0xe0,
+  0xf0, 0x91, 0xd0, 0xb0, 0x90, 0x03, 0x07, 0x0f, 0x1d, 0x3f, 0x71, 0x32,
+  0xf2, 0x68, 0x78, 0xc4, 0xb1, 0x98, 0x33, 0x67, 0xcf, 0x45, 0x45, 0x9f,
+  0x3a, 0x7d, 0xf1, 0x52, 0x7c, 0xc2, 0xf9, 0xd8, 0xb8, 0x0b, 0x29, 0xa9,
+  0x69, 0xe9, 0x97, 0x13, 0x93, 0x92, 0xb3, 0xaf, 0x5e, 0xcb, 0xc9, 0xc8,
+  0xcc, 0xba, 0x72, 0xbd, 0xb0, 0xa8, 0x38, 0x37, 0x2f, 0xbf, 0xa0, 0xac,
+  0xbc, 0xa2, 0xb2, 0xe4, 0xc6, 0xcd, 0xd2, 0xbb, 0xf7, 0xee, 0x3f, 0xa8,
+  0xba, 0x75, 0xfb, 0x4e, 0xf5, 0xd3, 0x67, 0xcf, 0x1f, 0x3e, 0x7a, 0xfc,
+  0xa4, 0xee, 0xd5, 0xeb, 0x37, 0x2f, 0x6a, 0x6a, 0x5f, 0xbe, 0x6b, 0x7a,
+  0xff, 0xa1, 0xbe, 0xa1, 0xf1, 0x6d, 0x4b, 0x6b, 0xdb, 0x97, 0x8f, 0xcd,
+  0x9f, 0x3e, 0x77, 0x7d, 0xeb, 0xee, 0xf9, 0xda, 0xde, 0xd1, 0x39, 0xf8,
+  0xfd, 0xc7, 0xcf, 0xde, 0xbe, 0xfe, 0x81, 0x7f, 0xfe, 0xfd, 0x4f, 0x78,
+  0xe8, 0x30, 0x11, 0x01, 0xc1, 0x21, 0x42, 0x23, 0xc5, 0x47, 0x49, 0x88,
+  0x0e, 0x17, 0x1b, 0x31, 0x56, 0x5a, 0x66, 0x9c, 0xe4, 0x68, 0xa9, 0x31,
+  0xb2, 0x93, 0xe5, 0xe4, 0xc7, 0x4f, 0x98, 0x38, 0x69, 0xda, 0x74, 0x25,
+  0x65, 0x85, 0x29, 0x8a, 0x53, 0xd5, 0xd4, 0x35, 0x66, 0xcd, 0x98, 0xa9,
+  0xa2, 0xaa, 0xa9, 0x45, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0xff, 0xae, 0xdf, 0x28, 0x29, 0xbd, 0x79, 0xef, 0xee, 0x83, 0xfb,
+  0xb7, 0xaa, 0xee, 0xdc, 0x7e, 0x5a, 0xfd, 0xfc, 0xd9, 0xa3, 0x87, 0x4f,
+  0x1e, 0xbf, 0xaa, 0x7b, 0xf3, 0xba, 0xe6, 0xc5, 0xcb, 0xda, 0xa6, 0x77,
+  0x1f, 0xde, 0x37, 0xd4, 0xbf, 0x6d, 0x6c, 0x6d, 0xf9, 0xd2, 0xd6, 0xfc,
+  0xf1, 0xf3, 0xa7, 0x6f, 0x5d, 0x3d, 0xdd, 0xed, 0x5f, 0x3b, 0x3b, 0xbe,
+  0x0f, 0xfe, 0xfc, 0xd1, 0xd7, 0x3b, 0xd0, 0xff, 0xef, 0x3f, 0xbf, 0x86,
+  0x0a, 0x8b, 0x0c, 0x13, 0x14, 0x10, 0x1a, 0x22, 0x3e, 0x52, 0x62, 0xd4,
+  0x70, 0xd1, 0x11, 0x62, 0xd2, 0x63, 0xc7, 0xc9, 0x8c, 0x96, 0x1c, 0x23,
+  0x35, 0x59, 0x56, 0x5e, 0x6e, 0xc2, 0xf8, 0x49, 0x13, 0xa7, 0x4f, 0x53,
+  0x56, 0x9a, 0xa2, 0x30, 0x55, 0x51, 0x5d, 0x6d, 0x96, 0xc6, 0xcc, 0x19,
+  0xaa, 0x2a, 0x5a, 0x9a, 0xf3, 0xb5, 0xe7, 0xcc, 0x9e, 0x37, 0x77, 0x89,
+  0x8e, 0x9e, 0xee, 0xc2, 0x05, 0x8b, 0x17, 0xad, 0x58, 0x6e, 0xb8, 0x72,
+  0xa9, 0xfe, 0x32, 0x83, 0x75, 0x6b, 0xd7, 0x1b, 0x1b, 0xad, 0x5a, 0xb3,
+  0xda, 0xd2, 0xc2, 0xda, 0xca, 0xd4, 0xc4, 0xdc, 0xcc, 0xc1, 0xde, 0xc9,
+  0x71, 0x83, 0x8d, 0x9d, 0xad, 0xf3, 0x56, 0x97, 0x6d, 0x9b, 0x36, 0x6e,
+  0xd9, 0xec, 0xe5, 0xe9, 0xe3, 0xed, 0xe6, 0xea, 0xe1, 0xbe, 0x7b, 0x97,
+  0xdf, 0x1e, 0xdf, 0xed, 0x3b, 0x77, 0x04, 0xee, 0x0f, 0x0e, 0xda, 0xb7,
+  0x37, 0xc0, 0xff, 0xc8, 0xe1, 0xb0, 0xd0, 0x03, 0x21, 0x87, 0x0e, 0x9e,
+  0x38, 0x1e, 0x79, 0x32, 0xfc, 0xe8, 0xb1, 0x88, 0x33, 0x31, 0xe7, 0xce,
+  0x46, 0x47, 0x9d, 0x3e, 0x75, 0xe9, 0x62, 0x42, 0x7c, 0xec, 0xf9, 0x0b,
+  0x71, 0xa9, 0x29, 0xe9, 0x69, 0x89, 0x97, 0x93, 0x93, 0xae, 0x66, 0xe7,
+  0x5c, 0xcb, 0xcc, 0xb8, 0x92, 0x55, 0x78, 0xbd, 0xb8, 0x28, 0x2f, 0xb7,
+  0x20, 0xbf, 0xbc, 0xac, 0xb2, 0x82, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53,
+  0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d,
+  0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea,
+  0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53,
+  0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d,
+  0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea,
+  0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53,
+  0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d,
+  0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea,
+  0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53,
+  0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d,
+  0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea,
+  0xd4, 0xa9, 0x53, 0xff, 0x5d, 0x5f, 0xb7, 0x7a, 0xcd, 0x2a, 0x23, 0x2b,
+  0x6b, 0x0b, 0x4b, 0x33, 0x73, 0x13, 0x53, 0x47, 0x27, 0x7b, 0x07, 0x5b,
+  0x3b, 0x9b, 0x0d, 0xdb, 0x5c, 0xb6, 0x3a, 0x6f, 0xde, 0xb2, 0x71, 0x93,
+  0xb7, 0x8f, 0xa7, 0x97, 0xbb, 0x87, 0xab, 0xdb, 0x1e, 0xbf, 0x5d, 0xbb,
+  0x77, 0xec, 0xdc, 0xee, 0x1b, 0x14, 0xbc, 0x3f, 0xd0, 0x3f, 0x60, 0xef,
+  0xbe, 0xd0, 0xb0, 0xc3, 0x47, 0x0e, 0x1e, 0x0a, 0x39, 0x70, 0x32, 0xf2,
+  0xf8, 0x89, 0x88, 0x63, 0x47, 0xc3, 0xcf, 0x9e, 0x8b, 0x39, 0x73, 0xea,
+  0x74, 0x54, 0x74, 0x7c, 0xc2, 0xc5, 0x4b, 0x71, 0x17, 0xce, 0xc7, 0xa6,
+  0xa5, 0xa7, 0xa4, 0x26, 0x25, 0x5f, 0x4e, 0xbc, 0x96, 0x93, 0x7d, 0x35,
+  0xeb, 0x4a, 0x46, 0x66, 0x51, 0xf1, 0xf5, 0xc2, 0xfc, 0x82, 0xdc, 0xbc,
+  0x8a, 0xca, 0xb2, 0xf2, 0x9b, 0xa5, 0x25, 0x37, 0xee, 0x3f, 0xb8, 0x7b,
+  0xef, 0xf6, 0x9d, 0xaa, 0x5b, 0xcf, 0x9e, 0x57, 0x3f, 0x7d, 0xfc, 0xe4,
+  0xe1, 0xa3, 0xd7, 0x6f, 0xea, 0x5e, 0xd5, 0xbe, 0x7c, 0x51, 0xf3, 0xfe,
+  0xc3, 0xbb, 0xa6, 0xc6, 0xb7, 0xf5, 0x0d, 0x6d, 0x5f, 0x5a, 0x5a, 0x3f,
+  0x7d, 0xfe, 0xd8, 0xdc, 0xdd, 0xd3, 0xf5, 0xad, 0xa3, 0xf3, 0x6b, 0xfb,
+  0x8f, 0x9f, 0x83, 0xdf, 0xfb, 0x07, 0x7a, 0xfb, 0xfe, 0xfb, 0xf5, 0xcf,
+  0x30, 0x11, 0xe1, 0xa1, 0x43, 0x84, 0x04, 0x04, 0x47, 0x49, 0x8c, 0x14,
+  0x17, 0x1b, 0x21, 0x3a, 0x5c, 0x66, 0xdc, 0x58, 0x69, 0xa9, 0x31, 0x92,
+  0xa3, 0xe5, 0xe4, 0x65, 0x27, 0x4f, 0x9c, 0x34, 0x7e, 0x82, 0x92, 0xf2,
+  0xb4, 0xe9, 0x8a, 0x53, 0x15, 0xa6, 0x68, 0xcc, 0x52, 0x53, 0x57, 0x51,
+  0x9d, 0x31, 0x53, 0x7b, 0xbe, 0xa6, 0xd6, 0xdc, 0x79, 0xb3, 0xe7, 0xe8,
+  0xea, 0xe9, 0x2c, 0x59, 0xb4, 0x78, 0xc1, 0xc2, 0x95, 0x86, 0xcb, 0x57,
+  0x18, 0x2c, 0xd3, 0x5f, 0x6a, 0xbc, 0x7e, 0x2d, 0x75, 0xea, 0xd4, 0xa9,
+  0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e,
+  0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75,
+  0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9,
+  0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e,
+  0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75,
+  0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9,
+  0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e,
+  0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75,
+  0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9,
+  0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e,
+  0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75,
+  0xea, 0xd4, 0xa9, 0x53, 0xa7, 0xfe, 0xbb, 0x5e, 0x5b, 0xf3, 0xe2, 0xc3,
+  0xfb, 0xa6, 0x77, 0x6f, 0x1b, 0x1b, 0xea, 0xbf, 0xb4, 0xb5, 0xb6, 0x7c,
+  0xfe, 0xd4, 0xfc, 0xb1, 0xa7, 0xfb, 0x5b, 0x57, 0x67, 0x47, 0xfb, 0xd7,
+  0x9f, 0x3f, 0xbe, 0x0f, 0x0e, 0xf4, 0xf7, 0xf5, 0xfe, 0xfa, 0xef, 0x5f,
+  0x91, 0x61, 0x43, 0x85, 0x85, 0x86, 0x08, 0x0a, 0x48, 0x8c, 0x12, 0x1f,
+  0x39, 0x42, 0x6c, 0xb8, 0xe8, 0x38, 0x19, 0xe9, 0xb1, 0x63, 0xa4, 0x46,
+  0x4b, 0xca, 0xcb, 0x4d, 0x96, 0x9d, 0x34, 0x71, 0xc2, 0x78, 0x65, 0xa5,
+  0xe9, 0xd3, 0xa6, 0x2a, 0x4e, 0x51, 0x98, 0xa5, 0xa1, 0xae, 0xa6, 0xaa,
+  0x32, 0x73, 0xc6, 0x7c, 0x6d, 0x2d, 0xcd, 0x79, 0x73, 0xe7, 0xcc, 0xd6,
+  0xd3, 0x5d, 0xa2, 0xb3, 0x78, 0xd1, 0xc2, 0x05, 0x86, 0x2b, 0x57, 0x2c,
+  0x5f, 0x66, 0xb0, 0x54, 0x7f, 0xbd, 0xf1, 0xba, 0xb5, 0x6b, 0x56, 0x1b,
+  0xad, 0xb2, 0xb6, 0xb2, 0xb4, 0x30, 0x37, 0x33, 0x35, 0x71, 0x72, 0x74,
+  0xb0, 0xb7, 0xb3, 0xdd, 0x60, 0xe3, 0xb2, 0xcd, 0x79, 0xeb, 0x96, 0xcd,
+  0x9b, 0x36, 0xfa, 0x78, 0x7b, 0x79, 0x7a, 0xb8, 0xbb, 0xb9, 0xfa, 0xed,
+  0xd9, 0xbd, 0x6b, 0xe7, 0x0e, 0xdf, 0xed, 0xc1, 0x41, 0x81, 0xfb, 0x03,
+  0xfc, 0xf7, 0xed, 0x0d, 0x0b, 0x3d, 0x72, 0xf8, 0xd0, 0xc1, 0x03, 0x21,
+  0x91, 0x27, 0x4f, 0x1c, 0x3f, 0x16, 0x11, 0x7e, 0xf4, 0xdc, 0xd9, 0x33,
+  0x31, 0xa7, 0x4f, 0x45, 0x47, 0x25, 0xc4, 0x5f, 0xba, 0x78, 0x21, 0x2e,
+  0xf6, 0x7c, 0x7a, 0x5a, 0x6a, 0x4a, 0x72, 0x52, 0xe2, 0xe5, 0x9c, 0x6b,
+  0x57, 0xb3, 0xaf, 0x64, 0x65, 0x66, 0x14, 0x17, 0x15, 0x5e, 0x2f, 0xc8,
+  0xcf, 0xcb, 0xad, 0xac, 0x28, 0x2f, 0x2b, 0xbd, 0x79, 0xa3, 0xe4, 0xc1,
+  0xfd, 0x7b, 0x77, 0xef, 0xdc, 0xbe, 0x55, 0xf5, 0xfc, 0xd9, 0xd3, 0xea,
+  0x27, 0x8f, 0x1f, 0x3d, 0x7c, 0xf3, 0xfa, 0x55, 0xdd, 0x4b, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4,
+  0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7,
+  0x4e, 0x9d, 0x3a, 0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0x9d, 0x3a,
+  0x75, 0xea, 0xd4, 0xa9, 0x53, 0xa7, 0x4e, 0xfd, 0x77, 0xfd, 0x7f, 0x50,
+  0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+  0x00, 0x21, 0x5a, 0x17, 0xec, 0x3b, 0x47, 0x11, 0x0d, 0x00, 0x00, 0x00,
+  0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x64, 0x61, 0x74,
+  0x61, 0x2e, 0x62, 0x69, 0x6e, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00, 0x00,
+  0x00, 0x01, 0x00, 0x01, 0x00, 0x36, 0x00, 0x00, 0x00, 0x37, 0x0d, 0x00,
+  0x00, 0x00, 0x00
+};
+unsigned int fs_test_file_test3_zip_len = 3459;
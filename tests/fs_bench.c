@@ -0,0 +1,1357 @@
+/*
+Benchmarks for fs. These are not run as part of the test suite. Build with FS_BUILD_BENCHMARKS and
+then run `fs_bench` to run everything, or `fs_bench <name> [<name> ...]` to run specific benchmarks.
+*/
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L /* For clock_gettime(). */
+#endif
+
+#include "../fs.h"
+#include "../extras/backends/zip/fs_zip.h"
+#include "../extras/backends/mem/fs_mem.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+#define FS_BENCH_COUNTOF(x) (sizeof(x) / sizeof(x[0]))
+#define FS_BENCH_MIN(x, y)  (((x) < (y)) ? (x) : (y))
+
+
+/* BEG fs_bench.c */
+typedef int (* fs_bench_proc)(void);
+
+typedef struct
+{
+    const char* name;
+    fs_bench_proc proc;
+} fs_bench;
+
+static double fs_bench_time_in_ms(clock_t start, clock_t end)
+{
+    return ((double)(end - start) * 1000.0) / (double)CLOCKS_PER_SEC;
+}
+
+/*
+clock() measures CPU time on some platforms which is no good for measuring multi-threaded code
+because the time of every thread is added together. Use this for wall clock time instead.
+*/
+static double fs_bench_wall_time_in_ms(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return ((double)counter.QuadPart * 1000.0) / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((double)ts.tv_sec * 1000.0) + ((double)ts.tv_nsec / 1000000.0);
+#endif
+}
+
+static fs_uint32 fs_bench_rand(fs_uint32* pState)
+{
+    /* xorshift32. Good enough for shuffling benchmark data. */
+    fs_uint32 x = *pState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *pState = x;
+    return x;
+}
+/* END fs_bench.c */
+
+
+/* BEG fs_bench_zip_builder */
+/*
+Builds a synthetic Zip archive in memory. Every entry is an empty stored file. The entries are written
+to the central directory in a shuffled order so that the index sort has some real work to do.
+*/
+typedef struct
+{
+    unsigned char* pData;
+    size_t size;
+    size_t cap;
+} fs_bench_buffer;
+
+static int fs_bench_buffer_reserve(fs_bench_buffer* pBuffer, size_t extra)
+{
+    if (pBuffer->size + extra > pBuffer->cap) {
+        size_t newCap = (pBuffer->cap == 0) ? 4096 : pBuffer->cap * 2;
+        unsigned char* pNewData;
+
+        while (newCap < pBuffer->size + extra) {
+            newCap *= 2;
+        }
+
+        pNewData = (unsigned char*)fs_realloc(pBuffer->pData, newCap, NULL);
+        if (pNewData == NULL) {
+            return FS_OUT_OF_MEMORY;
+        }
+
+        pBuffer->pData = pNewData;
+        pBuffer->cap   = newCap;
+    }
+
+    return FS_SUCCESS;
+}
+
+static void fs_bench_buffer_write_le16(fs_bench_buffer* pBuffer, fs_uint32 value)
+{
+    pBuffer->pData[pBuffer->size++] = (unsigned char)((value >> 0) & 0xFF);
+    pBuffer->pData[pBuffer->size++] = (unsigned char)((value >> 8) & 0xFF);
+}
+
+static void fs_bench_buffer_write_le32(fs_bench_buffer* pBuffer, fs_uint32 value)
+{
+    fs_bench_buffer_write_le16(pBuffer, (value >>  0) & 0xFFFF);
+    fs_bench_buffer_write_le16(pBuffer, (value >> 16) & 0xFFFF);
+}
+
+static void fs_bench_buffer_write_le64(fs_bench_buffer* pBuffer, fs_uint64 value)
+{
+    fs_bench_buffer_write_le32(pBuffer, (fs_uint32)(value & 0xFFFFFFFF));
+    fs_bench_buffer_write_le32(pBuffer, (fs_uint32)(value >> 32));
+}
+
+static void fs_bench_buffer_write_bytes(fs_bench_buffer* pBuffer, const void* pData, size_t size)
+{
+    memcpy(pBuffer->pData + pBuffer->size, pData, size);
+    pBuffer->size += size;
+}
+
+static void fs_bench_zip_entry_name(size_t index, char* pName, size_t nameCap)
+{
+    fs_snprintf(pName, nameCap, "dir%03u/file%06u.txt", (unsigned int)(index % 100), (unsigned int)index);
+}
+
+static fs_result fs_bench_build_zip(size_t entryCount, fs_bench_buffer* pBuffer)
+{
+    fs_uint32* pOffsets;
+    size_t* pOrder;
+    size_t i;
+    size_t centralDirectoryOffset;
+    size_t centralDirectorySize;
+    fs_uint32 seed = 0x12345678;
+    char name[64];
+
+    memset(pBuffer, 0, sizeof(*pBuffer));
+
+    pOffsets = (fs_uint32*)fs_malloc(sizeof(*pOffsets) * (entryCount + 1), NULL);
+    pOrder   = (size_t*   )fs_malloc(sizeof(*pOrder)   * (entryCount + 1), NULL);
+    if (pOffsets == NULL || pOrder == NULL) {
+        fs_free(pOffsets, NULL);
+        fs_free(pOrder, NULL);
+        return FS_OUT_OF_MEMORY;
+    }
+
+    for (i = 0; i < entryCount; i += 1) {
+        pOrder[i] = i;
+    }
+
+    for (i = entryCount; i > 1; i -= 1) {
+        size_t j = fs_bench_rand(&seed) % i;
+        size_t temp = pOrder[i - 1];
+        pOrder[i - 1] = pOrder[j];
+        pOrder[j] = temp;
+    }
+
+    /* Local headers. */
+    for (i = 0; i < entryCount; i += 1) {
+        size_t nameLen;
+
+        fs_bench_zip_entry_name(pOrder[i], name, sizeof(name));
+        nameLen = strlen(name);
+
+        if (fs_bench_buffer_reserve(pBuffer, 30 + nameLen) != FS_SUCCESS) {
+            goto oom;
+        }
+
+        pOffsets[i] = (fs_uint32)pBuffer->size;
+
+        fs_bench_buffer_write_le32(pBuffer, 0x04034b50);
+        fs_bench_buffer_write_le16(pBuffer, 10);     /* Version needed. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Flags. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Compression method (store). */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Time. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Date. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* CRC32. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* Compressed size. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* Uncompressed size. */
+        fs_bench_buffer_write_le16(pBuffer, (fs_uint32)nameLen);
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Extra length. */
+        fs_bench_buffer_write_bytes(pBuffer, name, nameLen);
+    }
+
+    /* Central directory. */
+    centralDirectoryOffset = pBuffer->size;
+
+    for (i = 0; i < entryCount; i += 1) {
+        size_t nameLen;
+
+        fs_bench_zip_entry_name(pOrder[i], name, sizeof(name));
+        nameLen = strlen(name);
+
+        if (fs_bench_buffer_reserve(pBuffer, 46 + nameLen) != FS_SUCCESS) {
+            goto oom;
+        }
+
+        fs_bench_buffer_write_le32(pBuffer, 0x02014b50);
+        fs_bench_buffer_write_le16(pBuffer, 20);     /* Version made by. */
+        fs_bench_buffer_write_le16(pBuffer, 10);     /* Version needed. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Flags. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Compression method (store). */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Time. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Date. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* CRC32. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* Compressed size. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* Uncompressed size. */
+        fs_bench_buffer_write_le16(pBuffer, (fs_uint32)nameLen);
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Extra length. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Comment length. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Disk number start. */
+        fs_bench_buffer_write_le16(pBuffer, 0);      /* Internal attributes. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* External attributes. */
+        fs_bench_buffer_write_le32(pBuffer, pOffsets[i]);
+        fs_bench_buffer_write_bytes(pBuffer, name, nameLen);
+    }
+
+    centralDirectorySize = pBuffer->size - centralDirectoryOffset;
+
+    /* Large archives need the Zip64 end of central directory record and locator. A count of 0xFFFF in the regular record tells the reader to look for them. */
+    if (entryCount >= 0xFFFF) {
+        size_t eocd64Offset = pBuffer->size;
+
+        if (fs_bench_buffer_reserve(pBuffer, 56 + 20) != FS_SUCCESS) {
+            goto oom;
+        }
+
+        fs_bench_buffer_write_le32(pBuffer, 0x06064b50);
+        fs_bench_buffer_write_le64(pBuffer, 44);     /* Size of the remaining record. */
+        fs_bench_buffer_write_le16(pBuffer, 45);     /* Version made by. */
+        fs_bench_buffer_write_le16(pBuffer, 45);     /* Version needed. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* This disk. */
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* Disk with the central directory. */
+        fs_bench_buffer_write_le64(pBuffer, entryCount);
+        fs_bench_buffer_write_le64(pBuffer, entryCount);
+        fs_bench_buffer_write_le64(pBuffer, centralDirectorySize);
+        fs_bench_buffer_write_le64(pBuffer, centralDirectoryOffset);
+
+        fs_bench_buffer_write_le32(pBuffer, 0x07064b50);
+        fs_bench_buffer_write_le32(pBuffer, 0);      /* Disk with the Zip64 end of central directory record. */
+        fs_bench_buffer_write_le64(pBuffer, eocd64Offset);
+        fs_bench_buffer_write_le32(pBuffer, 1);      /* Total number of disks. */
+    }
+
+    /* End of central directory. */
+    if (fs_bench_buffer_reserve(pBuffer, 22) != FS_SUCCESS) {
+        goto oom;
+    }
+
+    fs_bench_buffer_write_le32(pBuffer, 0x06054b50);
+    fs_bench_buffer_write_le16(pBuffer, 0);
+    fs_bench_buffer_write_le16(pBuffer, 0);
+    fs_bench_buffer_write_le16(pBuffer, (fs_uint32)FS_BENCH_MIN(entryCount, 0xFFFF));
+    fs_bench_buffer_write_le16(pBuffer, (fs_uint32)FS_BENCH_MIN(entryCount, 0xFFFF));
+    fs_bench_buffer_write_le32(pBuffer, (fs_uint32)centralDirectorySize);
+    fs_bench_buffer_write_le32(pBuffer, (fs_uint32)centralDirectoryOffset);
+    fs_bench_buffer_write_le16(pBuffer, 0);
+
+    fs_free(pOffsets, NULL);
+    fs_free(pOrder, NULL);
+    return FS_SUCCESS;
+
+oom:
+    fs_free(pOffsets, NULL);
+    fs_free(pOrder, NULL);
+    fs_free(pBuffer->pData, NULL);
+    memset(pBuffer, 0, sizeof(*pBuffer));
+    return FS_OUT_OF_MEMORY;
+}
+
+static fs_result fs_bench_open_zip(const fs_bench_buffer* pBuffer, const fs_zip_config* pZipConfig, fs_memory_stream* pStream, fs** ppArchive)
+{
+    fs_result result;
+    fs_config archiveConfig;
+
+    result = fs_memory_stream_init_readonly(pBuffer->pData, pBuffer->size, pStream);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    archiveConfig = fs_config_init(FS_ZIP, pZipConfig, (fs_stream*)pStream);
+
+    return fs_init(&archiveConfig, ppArchive);
+}
+/* END fs_bench_zip_builder */
+
+
+/* BEG fs_bench_sort */
+typedef struct
+{
+    fs_uint32 key;
+    fs_uint32 value;
+} fs_bench_sort_item;
+
+static int fs_bench_sort_compare(void* pUserData, const void* pA, const void* pB)
+{
+    fs_uint32 a = ((const fs_bench_sort_item*)pA)->key;
+    fs_uint32 b = ((const fs_bench_sort_item*)pB)->key;
+
+    (void)pUserData;
+
+    return (a > b) - (a < b);
+}
+
+static int fs_bench_sort(void)
+{
+    size_t counts[] = { 1000, 10000, 100000, 1000000 };
+    size_t iCount;
+
+    for (iCount = 0; iCount < FS_BENCH_COUNTOF(counts); iCount += 1) {
+        size_t count = counts[iCount];
+        fs_bench_sort_item* pItems;
+        fs_uint32 seed = 0xDEADBEEF;
+        size_t i;
+        clock_t start;
+        double randomTime;
+        double sortedTime;
+
+        pItems = (fs_bench_sort_item*)fs_malloc(sizeof(*pItems) * count, NULL);
+        if (pItems == NULL) {
+            printf("  Out of memory.\n");
+            return FS_ERROR;
+        }
+
+        for (i = 0; i < count; i += 1) {
+            pItems[i].key   = fs_bench_rand(&seed);
+            pItems[i].value = (fs_uint32)i;
+        }
+
+        start = clock();
+        fs_sort(pItems, count, sizeof(*pItems), fs_bench_sort_compare, NULL);
+        randomTime = fs_bench_time_in_ms(start, clock());
+
+        /* Sorting again measures the already sorted case which is common for Zip central directories. */
+        start = clock();
+        fs_sort(pItems, count, sizeof(*pItems), fs_bench_sort_compare, NULL);
+        sortedTime = fs_bench_time_in_ms(start, clock());
+
+        printf("  %8u items: random %10.3f ms, sorted %10.3f ms\n", (unsigned int)count, randomTime, sortedTime);
+
+        fs_free(pItems, NULL);
+    }
+
+    return FS_SUCCESS;
+}
+/* END fs_bench_sort */
+
+
+/* BEG fs_bench_zip_open */
+static int fs_bench_zip_open(void)
+{
+    size_t counts[] = { 100, 1000, 10000, 50000 };
+    size_t iCount;
+
+    for (iCount = 0; iCount < FS_BENCH_COUNTOF(counts); iCount += 1) {
+        fs_result result;
+        fs_bench_buffer buffer;
+        fs_memory_stream stream;
+        fs* pArchive;
+        clock_t start;
+        double openTime;
+        int iteration;
+        int iterationCount = 10;
+
+        result = fs_bench_build_zip(counts[iCount], &buffer);
+        if (result != FS_SUCCESS) {
+            printf("  Failed to build archive: %d\n", result);
+            return FS_ERROR;
+        }
+
+        start = clock();
+        for (iteration = 0; iteration < iterationCount; iteration += 1) {
+            result = fs_bench_open_zip(&buffer, NULL, &stream, &pArchive);
+            if (result != FS_SUCCESS) {
+                printf("  Failed to open archive: %d\n", result);
+                fs_free(buffer.pData, NULL);
+                return FS_ERROR;
+            }
+
+            fs_uninit(pArchive);
+            fs_memory_stream_uninit(&stream);
+        }
+        openTime = fs_bench_time_in_ms(start, clock()) / iterationCount;
+
+        printf("  %8u entries: open %10.3f ms\n", (unsigned int)counts[iCount], openTime);
+
+        fs_free(buffer.pData, NULL);
+    }
+
+    return FS_SUCCESS;
+}
+/* END fs_bench_zip_open */
+
+
+/* BEG fs_bench_zip_open_threaded */
+static int fs_bench_zip_open_threaded(void)
+{
+    size_t counts[] = { 100000, 1000000 };
+    int threadCounts[] = { 1, 2, 4, 8 };
+    size_t iCount;
+    size_t iThreadCount;
+
+    for (iCount = 0; iCount < FS_BENCH_COUNTOF(counts); iCount += 1) {
+        fs_result result;
+        fs_bench_buffer buffer;
+        double singleThreadedTime = 0;
+
+        result = fs_bench_build_zip(counts[iCount], &buffer);
+        if (result != FS_SUCCESS) {
+            printf("  Failed to build archive: %d\n", result);
+            return FS_ERROR;
+        }
+
+        for (iThreadCount = 0; iThreadCount < FS_BENCH_COUNTOF(threadCounts); iThreadCount += 1) {
+            fs_zip_config zipConfig;
+            fs_memory_stream stream;
+            fs* pArchive;
+            double start;
+            double openTime;
+            int iteration;
+            int iterationCount = 3;
+
+            zipConfig = fs_zip_config_init();
+            zipConfig.threadCount = threadCounts[iThreadCount];
+
+            start = fs_bench_wall_time_in_ms();
+            for (iteration = 0; iteration < iterationCount; iteration += 1) {
+                result = fs_bench_open_zip(&buffer, &zipConfig, &stream, &pArchive);
+                if (result != FS_SUCCESS) {
+                    printf("  Failed to open archive: %d\n", result);
+                    fs_free(buffer.pData, NULL);
+                    return FS_ERROR;
+                }
+
+                fs_uninit(pArchive);
+                fs_memory_stream_uninit(&stream);
+            }
+            openTime = (fs_bench_wall_time_in_ms() - start) / iterationCount;
+
+            if (iThreadCount == 0) {
+                singleThreadedTime = openTime;
+            }
+
+            printf("  %8u entries, %d threads: open %10.3f ms (%.2fx)\n", (unsigned int)counts[iCount], threadCounts[iThreadCount], openTime, singleThreadedTime / openTime);
+        }
+
+        fs_free(buffer.pData, NULL);
+    }
+
+    return FS_SUCCESS;
+}
+/* END fs_bench_zip_open_threaded */
+
+
+/* BEG fs_bench_zip_info */
+static int fs_bench_zip_info(void)
+{
+    size_t counts[] = { 1000, 100000 };
+    size_t iCount;
+
+    for (iCount = 0; iCount < FS_BENCH_COUNTOF(counts); iCount += 1) {
+        fs_result result;
+        fs_bench_buffer buffer;
+        char* pNames;
+        size_t iEntry;
+        int usePathHashTable;
+
+        result = fs_bench_build_zip(counts[iCount], &buffer);
+        if (result != FS_SUCCESS) {
+            printf("  Failed to build archive: %d\n", result);
+            return FS_ERROR;
+        }
+
+        /* The names are generated up front so we're only timing the lookups. */
+        pNames = (char*)fs_malloc(counts[iCount] * 64, NULL);
+        if (pNames == NULL) {
+            printf("  Out of memory.\n");
+            fs_free(buffer.pData, NULL);
+            return FS_ERROR;
+        }
+
+        for (iEntry = 0; iEntry < counts[iCount]; iEntry += 1) {
+            fs_bench_zip_entry_name(iEntry, pNames + (iEntry * 64), 64);
+        }
+
+        for (usePathHashTable = 0; usePathHashTable < 2; usePathHashTable += 1) {
+            fs_zip_config zipConfig;
+            fs_memory_stream stream;
+            fs* pArchive;
+            clock_t start;
+            double infoTime;
+            size_t lookupCount = 0;
+            int iteration;
+            int iterationCount = 1000000 / (int)counts[iCount];
+
+            zipConfig = fs_zip_config_init();
+            zipConfig.usePathHashTable = usePathHashTable;
+
+            result = fs_bench_open_zip(&buffer, &zipConfig, &stream, &pArchive);
+            if (result != FS_SUCCESS) {
+                printf("  Failed to open archive: %d\n", result);
+                fs_free(buffer.pData, NULL);
+                return FS_ERROR;
+            }
+
+            start = clock();
+            for (iteration = 0; iteration < iterationCount; iteration += 1) {
+                for (iEntry = 0; iEntry < counts[iCount]; iEntry += 1) {
+                    const char* pName = pNames + (iEntry * 64);
+                    fs_file_info info;
+
+                    result = fs_info(pArchive, pName, FS_READ, &info);
+                    if (result != FS_SUCCESS) {
+                        printf("  Failed to find %s: %d\n", pName, result);
+                        fs_uninit(pArchive);
+                        fs_memory_stream_uninit(&stream);
+                        fs_free(pNames, NULL);
+                        fs_free(buffer.pData, NULL);
+                        return FS_ERROR;
+                    }
+
+                    lookupCount += 1;
+                }
+            }
+            infoTime = fs_bench_time_in_ms(start, clock());
+
+            printf("  %8u entries, %-10s: %8.1f ns per fs_info()\n", (unsigned int)counts[iCount], usePathHashTable ? "hash table" : "node graph", (infoTime * 1000000.0) / (double)lookupCount);
+
+            fs_uninit(pArchive);
+            fs_memory_stream_uninit(&stream);
+        }
+
+        fs_free(pNames, NULL);
+        fs_free(buffer.pData, NULL);
+    }
+
+    return FS_SUCCESS;
+}
+/* END fs_bench_zip_info */
+
+/* BEG fs_bench_zip_inflate */
+/*
+There's no compressor in the library so this is a minimal one just for generating test data. It does
+greedy LZ77 matching with hash chains and writes a single block with the fixed Huffman codes. The
+output is not as small as a real compressor, but it's a realistic mix of literals and matches.
+*/
+typedef struct
+{
+    fs_bench_buffer* pBuffer;
+    fs_uint32 bits;
+    fs_uint32 bitCount;
+} fs_bench_bit_writer;
+
+static void fs_bench_bit_writer_write(fs_bench_bit_writer* pWriter, fs_uint32 value, fs_uint32 count)
+{
+    pWriter->bits |= value << pWriter->bitCount;
+    pWriter->bitCount += count;
+
+    while (pWriter->bitCount >= 8) {
+        pWriter->pBuffer->pData[pWriter->pBuffer->size++] = (unsigned char)(pWriter->bits & 0xFF);
+        pWriter->bits    >>= 8;
+        pWriter->bitCount -= 8;
+    }
+}
+
+static void fs_bench_bit_writer_write_code(fs_bench_bit_writer* pWriter, fs_uint32 code, fs_uint32 length)
+{
+    /* Huffman codes are written starting from the most significant bit. */
+    fs_uint32 reversed = 0;
+    fs_uint32 i;
+
+    for (i = 0; i < length; i += 1) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+
+    fs_bench_bit_writer_write(pWriter, reversed, length);
+}
+
+static void fs_bench_deflate_write_symbol(fs_bench_bit_writer* pWriter, fs_uint32 symbol)
+{
+    if (symbol < 144) {
+        fs_bench_bit_writer_write_code(pWriter, 0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        fs_bench_bit_writer_write_code(pWriter, 0x190 + (symbol - 144), 9);
+    } else if (symbol < 280) {
+        fs_bench_bit_writer_write_code(pWriter, symbol - 256, 7);
+    } else {
+        fs_bench_bit_writer_write_code(pWriter, 0xC0 + (symbol - 280), 8);
+    }
+}
+
+static void fs_bench_deflate_write_match(fs_bench_bit_writer* pWriter, fs_uint32 length, fs_uint32 dist)
+{
+    static const fs_uint32 lengthBase[29]  = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const fs_uint32 lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const fs_uint32 distBase[30]    = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static const fs_uint32 distExtra[30]   = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    fs_uint32 i;
+
+    for (i = 28; lengthBase[i] > length; i -= 1) {
+    }
+
+    fs_bench_deflate_write_symbol(pWriter, 257 + i);
+    fs_bench_bit_writer_write(pWriter, length - lengthBase[i], lengthExtra[i]);
+
+    for (i = 29; distBase[i] > dist; i -= 1) {
+    }
+
+    fs_bench_bit_writer_write_code(pWriter, i, 5);
+    fs_bench_bit_writer_write(pWriter, dist - distBase[i], distExtra[i]);
+}
+
+#define FS_BENCH_DEFLATE_HASH_BITS      15
+#define FS_BENCH_DEFLATE_WINDOW_SIZE    32768
+#define FS_BENCH_DEFLATE_MAX_CHAIN      16
+
+static fs_result fs_bench_deflate(const unsigned char* pData, size_t size, fs_bench_buffer* pBuffer)
+{
+    fs_bench_bit_writer writer;
+    size_t* pHead;
+    size_t* pPrev;
+    size_t i;
+
+    /* Worst case is every byte being a 9 bit literal. */
+    if (fs_bench_buffer_reserve(pBuffer, size + (size / 8) + 16) != FS_SUCCESS) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    pHead = (size_t*)fs_malloc(sizeof(*pHead) * (1 << FS_BENCH_DEFLATE_HASH_BITS), NULL);
+    pPrev = (size_t*)fs_malloc(sizeof(*pPrev) * FS_BENCH_DEFLATE_WINDOW_SIZE, NULL);
+    if (pHead == NULL || pPrev == NULL) {
+        fs_free(pHead, NULL);
+        fs_free(pPrev, NULL);
+        return FS_OUT_OF_MEMORY;
+    }
+
+    for (i = 0; i < (1 << FS_BENCH_DEFLATE_HASH_BITS); i += 1) {
+        pHead[i] = (size_t)-1;
+    }
+
+    writer.pBuffer  = pBuffer;
+    writer.bits     = 0;
+    writer.bitCount = 0;
+
+    fs_bench_bit_writer_write(&writer, 1, 1);   /* Final block. */
+    fs_bench_bit_writer_write(&writer, 1, 2);   /* Fixed Huffman codes. */
+
+    i = 0;
+    while (i < size) {
+        size_t bestLength = 0;
+        size_t bestDist = 0;
+        size_t step;
+
+        if (i + 3 <= size) {
+            fs_uint32 hash = (((fs_uint32)pData[i] << 16) | ((fs_uint32)pData[i + 1] << 8) | pData[i + 2]) * 2654435761U >> (32 - FS_BENCH_DEFLATE_HASH_BITS);
+            size_t candidate = pHead[hash];
+            int chain;
+
+            for (chain = 0; chain < FS_BENCH_DEFLATE_MAX_CHAIN && candidate != (size_t)-1 && i - candidate <= FS_BENCH_DEFLATE_WINDOW_SIZE; chain += 1) {
+                size_t length = 0;
+                size_t maxLength = FS_BENCH_MIN(size - i, 258);
+
+                while (length < maxLength && pData[candidate + length] == pData[i + length]) {
+                    length += 1;
+                }
+
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDist   = i - candidate;
+                }
+
+                candidate = pPrev[candidate % FS_BENCH_DEFLATE_WINDOW_SIZE];
+            }
+
+            pPrev[i % FS_BENCH_DEFLATE_WINDOW_SIZE] = pHead[hash];
+            pHead[hash] = i;
+        }
+
+        if (bestLength >= 3) {
+            fs_bench_deflate_write_match(&writer, (fs_uint32)bestLength, (fs_uint32)bestDist);
+            step = bestLength;
+        } else {
+            fs_bench_deflate_write_symbol(&writer, pData[i]);
+            step = 1;
+        }
+
+        /* Only the start of each match goes into the hash chains. It makes for worse compression, but it's much faster. */
+        i += step;
+    }
+
+    fs_bench_deflate_write_symbol(&writer, 256);
+    fs_bench_bit_writer_write(&writer, 0, 7);   /* Flush the last byte. */
+
+    fs_free(pHead, NULL);
+    fs_free(pPrev, NULL);
+
+    return FS_SUCCESS;
+}
+
+static fs_uint32 fs_bench_crc32(const unsigned char* pData, size_t size)
+{
+    fs_uint32 crc = 0xFFFFFFFF;
+    size_t i;
+
+    for (i = 0; i < size; i += 1) {
+        int iBit;
+
+        crc ^= pData[i];
+        for (iBit = 0; iBit < 8; iBit += 1) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0U - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+/* Builds an archive with a single compressed file called "data.bin". */
+static fs_result fs_bench_build_deflate_zip(const unsigned char* pData, size_t size, fs_bench_buffer* pBuffer)
+{
+    fs_result result;
+    size_t compressedOffset;
+    size_t compressedSize;
+    size_t centralDirectoryOffset;
+    fs_uint32 crc;
+
+    memset(pBuffer, 0, sizeof(*pBuffer));
+
+    crc = fs_bench_crc32(pData, size);
+
+    if (fs_bench_buffer_reserve(pBuffer, 30 + 8) != FS_SUCCESS) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    fs_bench_buffer_write_le32(pBuffer, 0x04034b50);
+    fs_bench_buffer_write_le16(pBuffer, 20);     /* Version needed. */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Flags. */
+    fs_bench_buffer_write_le16(pBuffer, 8);      /* Compression method (deflate). */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Time. */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Date. */
+    fs_bench_buffer_write_le32(pBuffer, crc);
+    fs_bench_buffer_write_le32(pBuffer, 0);      /* Compressed size. Not used by the reader. */
+    fs_bench_buffer_write_le32(pBuffer, (fs_uint32)size);
+    fs_bench_buffer_write_le16(pBuffer, 8);
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Extra length. */
+    fs_bench_buffer_write_bytes(pBuffer, "data.bin", 8);
+
+    compressedOffset = pBuffer->size;
+
+    result = fs_bench_deflate(pData, size, pBuffer);
+    if (result != FS_SUCCESS) {
+        fs_free(pBuffer->pData, NULL);
+        return result;
+    }
+
+    compressedSize = pBuffer->size - compressedOffset;
+    centralDirectoryOffset = pBuffer->size;
+
+    if (fs_bench_buffer_reserve(pBuffer, 46 + 8 + 22) != FS_SUCCESS) {
+        fs_free(pBuffer->pData, NULL);
+        return FS_OUT_OF_MEMORY;
+    }
+
+    fs_bench_buffer_write_le32(pBuffer, 0x02014b50);
+    fs_bench_buffer_write_le16(pBuffer, 20);     /* Version made by. */
+    fs_bench_buffer_write_le16(pBuffer, 20);     /* Version needed. */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Flags. */
+    fs_bench_buffer_write_le16(pBuffer, 8);      /* Compression method (deflate). */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Time. */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Date. */
+    fs_bench_buffer_write_le32(pBuffer, crc);
+    fs_bench_buffer_write_le32(pBuffer, (fs_uint32)compressedSize);
+    fs_bench_buffer_write_le32(pBuffer, (fs_uint32)size);
+    fs_bench_buffer_write_le16(pBuffer, 8);
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Extra length. */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Comment length. */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Disk number start. */
+    fs_bench_buffer_write_le16(pBuffer, 0);      /* Internal attributes. */
+    fs_bench_buffer_write_le32(pBuffer, 0);      /* External attributes. */
+    fs_bench_buffer_write_le32(pBuffer, 0);      /* Local header offset. */
+    fs_bench_buffer_write_bytes(pBuffer, "data.bin", 8);
+
+    fs_bench_buffer_write_le32(pBuffer, 0x06054b50);
+    fs_bench_buffer_write_le16(pBuffer, 0);
+    fs_bench_buffer_write_le16(pBuffer, 0);
+    fs_bench_buffer_write_le16(pBuffer, 1);
+    fs_bench_buffer_write_le16(pBuffer, 1);
+    fs_bench_buffer_write_le32(pBuffer, 46 + 8);
+    fs_bench_buffer_write_le32(pBuffer, (fs_uint32)centralDirectoryOffset);
+    fs_bench_buffer_write_le16(pBuffer, 0);
+
+    return FS_SUCCESS;
+}
+
+/*
+Text is made up of random words, which is mostly short matches. Binary is a noisy signal stored as
+16-bit samples, which is mostly literals.
+*/
+static void fs_bench_generate_inflate_data(int kind, unsigned char* pData, size_t size)
+{
+    static const char* pWords[] = { "the", "of", "and", "file", "system", "archive", "directory", "read", "write", "stream", "buffer", "offset", "compressed", "texture", "model", "sound", "level", "config", "0", "1", "16", "256", "{", "}", "=", ";", "\n", "    " };
+    fs_uint32 seed = 0x12345678;
+    size_t i = 0;
+
+    if (kind == 0) {
+        while (i < size) {
+            const char* pWord = pWords[fs_bench_rand(&seed) % FS_BENCH_COUNTOF(pWords)];
+
+            while (*pWord != '\0' && i < size) {
+                pData[i++] = (unsigned char)*pWord++;
+            }
+
+            if (i < size) {
+                pData[i++] = ' ';
+            }
+        }
+    } else {
+        fs_uint32 sample = 0;
+
+        while (i + 1 < size) {
+            sample = (sample + (fs_bench_rand(&seed) % 512) - 256 + ((32768 - (sample & 0xFFFF)) >> 6)) & 0xFFFF;
+            pData[i++] = (unsigned char)(sample & 0xFF);
+            pData[i++] = (unsigned char)(sample >> 8);
+        }
+
+        if (i < size) {
+            pData[i] = 0;
+        }
+    }
+}
+
+/* Reads the whole of data.bin a number of times and returns the throughput in MB/s, or a negative value on failure. */
+static double fs_bench_zip_inflate_run(const fs_bench_buffer* pBuffer, const unsigned char* pData, size_t dataSize, unsigned char* pReadBuffer, size_t readBufferSize, fs_bool32 verifyChecksums)
+{
+    fs_result result;
+    fs_zip_config zipConfig;
+    fs_memory_stream stream;
+    fs* pArchive;
+    double startTime;
+    double inflateTime;
+    int iteration;
+    int iterationCount = 4;
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.verifyChecksums = verifyChecksums;
+
+    result = fs_bench_open_zip(pBuffer, &zipConfig, &stream, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("  Failed to open archive: %d\n", result);
+        return -1;
+    }
+
+    startTime = fs_bench_wall_time_in_ms();
+    for (iteration = 0; iteration < iterationCount && result == FS_SUCCESS; iteration += 1) {
+        fs_file* pFile;
+        size_t totalBytesRead = 0;
+
+        result = fs_file_open(pArchive, "data.bin", FS_READ, &pFile);
+        if (result != FS_SUCCESS) {
+            break;
+        }
+
+        for (;;) {
+            size_t bytesRead;
+
+            result = fs_file_read(pFile, pReadBuffer, readBufferSize, &bytesRead);
+            if (result != FS_SUCCESS) {
+                break;
+            }
+
+            /* Make sure the output is actually correct. Only check the first iteration so it doesn't affect the timing too much. */
+            if (iteration == 0 && memcmp(pReadBuffer, pData + totalBytesRead, bytesRead) != 0) {
+                printf("  Decompressed data does not match.\n");
+                result = FS_ERROR;
+                break;
+            }
+
+            totalBytesRead += bytesRead;
+        }
+
+        fs_file_close(pFile);
+
+        if (result == FS_AT_END && totalBytesRead == dataSize) {
+            result = FS_SUCCESS;
+        } else if (result == FS_AT_END || result == FS_SUCCESS) {
+            printf("  Decompressed size does not match.\n");
+            result = FS_ERROR;
+        } else if (result == FS_CHECKSUM_MISMATCH) {
+            printf("  Checksum does not match.\n");
+        }
+    }
+    inflateTime = fs_bench_wall_time_in_ms() - startTime;
+
+    fs_uninit(pArchive);
+    fs_memory_stream_uninit(&stream);
+
+    if (result != FS_SUCCESS) {
+        return -1;
+    }
+
+    return ((double)dataSize * iterationCount / (1024.0 * 1024.0)) / (inflateTime / 1000.0);
+}
+
+static int fs_bench_zip_inflate(void)
+{
+    const char* pKindNames[] = { "text", "binary" };
+    size_t dataSize = 16 * 1024 * 1024;
+    size_t readBufferSize = 4 * 1024 * 1024;
+    unsigned char* pData;
+    unsigned char* pReadBuffer;
+    int kind;
+
+    pData = (unsigned char*)fs_malloc(dataSize, NULL);
+    pReadBuffer = (unsigned char*)fs_malloc(readBufferSize, NULL);
+    if (pData == NULL || pReadBuffer == NULL) {
+        printf("  Out of memory.\n");
+        fs_free(pData, NULL);
+        fs_free(pReadBuffer, NULL);
+        return FS_ERROR;
+    }
+
+    for (kind = 0; kind < 2; kind += 1) {
+        fs_result result;
+        fs_bench_buffer buffer;
+        double speed;
+        double speedVerified;
+        double speedBulk;
+
+        fs_bench_generate_inflate_data(kind, pData, dataSize);
+
+        result = fs_bench_build_deflate_zip(pData, dataSize, &buffer);
+        if (result != FS_SUCCESS) {
+            printf("  Failed to build archive: %d\n", result);
+            break;
+        }
+
+        /*
+        The first two runs use 64KB reads, with the second having CRC-32 verification enabled to show how
+        much it costs. The last run uses large reads which are decompressed straight into the buffer.
+        */
+        speed         = fs_bench_zip_inflate_run(&buffer, pData, dataSize, pReadBuffer, 65536, FS_FALSE);
+        speedVerified = fs_bench_zip_inflate_run(&buffer, pData, dataSize, pReadBuffer, 65536, FS_TRUE);
+        speedBulk     = fs_bench_zip_inflate_run(&buffer, pData, dataSize, pReadBuffer, readBufferSize, FS_FALSE);
+
+        if (speed >= 0 && speedVerified >= 0 && speedBulk >= 0) {
+            printf("  %-6s: %5.1f%% of original size, %8.1f MB/s, %8.1f MB/s with CRC-32, %8.1f MB/s with 4MB reads\n", pKindNames[kind], (buffer.size * 100.0) / (double)dataSize, speed, speedVerified, speedBulk);
+        }
+
+        fs_free(buffer.pData, NULL);
+
+        if (speed < 0 || speedVerified < 0 || speedBulk < 0) {
+            break;
+        }
+    }
+
+    fs_free(pData, NULL);
+    fs_free(pReadBuffer, NULL);
+
+    return (kind == 2) ? FS_SUCCESS : FS_ERROR;
+}
+/* END fs_bench_zip_inflate */
+
+/* BEG fs_bench_zip_deflate */
+/*
+Writes data to a new archive with compression and returns the throughput in MB/s, or a negative value
+on failure. The data is written either as a single file, or split into many small files.
+*/
+static double fs_bench_zip_deflate_run(const unsigned char* pData, size_t dataSize, size_t fileSize, int compressionLevel, int threadCount, size_t* pArchiveSize)
+{
+    fs_result result;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs_memory_stream stream;
+    fs* pArchive;
+    double startTime;
+    double deflateTime;
+    size_t offset;
+    void* pArchiveData;
+
+    result = fs_memory_stream_init_write(NULL, &stream);
+    if (result != FS_SUCCESS) {
+        return -1;
+    }
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.write            = FS_TRUE;
+    zipConfig.compressionLevel = compressionLevel;
+    zipConfig.threadCount      = threadCount;
+
+    archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+    startTime = fs_bench_wall_time_in_ms();
+
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("  Failed to initialize archive: %d\n", result);
+        fs_memory_stream_uninit(&stream);
+        return -1;
+    }
+
+    for (offset = 0; offset < dataSize && result == FS_SUCCESS; offset += fileSize) {
+        fs_file* pFile;
+        char name[32];
+
+        fs_snprintf(name, sizeof(name), "%u.bin", (unsigned int)(offset / fileSize));
+
+        result = fs_file_open(pArchive, name, FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result == FS_SUCCESS) {
+            result = fs_file_write(pFile, pData + offset, FS_BENCH_MIN(fileSize, dataSize - offset), NULL);
+            fs_file_close(pFile);
+        }
+    }
+
+    fs_uninit(pArchive);
+    deflateTime = fs_bench_wall_time_in_ms() - startTime;
+
+    pArchiveData = fs_memory_stream_take_ownership(&stream, pArchiveSize);
+    fs_memory_stream_uninit(&stream);
+    fs_free(pArchiveData, NULL);
+
+    if (result != FS_SUCCESS) {
+        printf("  Failed to write archive: %d\n", result);
+        return -1;
+    }
+
+    return ((double)dataSize / (1024.0 * 1024.0)) / (deflateTime / 1000.0);
+}
+
+static int fs_bench_zip_deflate(void)
+{
+    const char* pKindNames[] = { "text", "binary" };
+    const int levels[] = { 1, 6, 9 };
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    size_t dataSize = 16 * 1024 * 1024;
+    unsigned char* pData;
+    int kind;
+
+    pData = (unsigned char*)fs_malloc(dataSize, NULL);
+    if (pData == NULL) {
+        printf("  Out of memory.\n");
+        return FS_ERROR;
+    }
+
+    /* The same data as the inflate benchmark, compressed as a single file and then as 4KB files. */
+    for (kind = 0; kind < 2; kind += 1) {
+        size_t iLevel;
+        size_t iThreadCount;
+        size_t archiveSize;
+        double speed;
+
+        fs_bench_generate_inflate_data(kind, pData, dataSize);
+
+        for (iLevel = 0; iLevel < FS_BENCH_COUNTOF(levels); iLevel += 1) {
+            printf("  %-6s level %d:", pKindNames[kind], levels[iLevel]);
+
+            for (iThreadCount = 0; iThreadCount < FS_BENCH_COUNTOF(threadCounts); iThreadCount += 1) {
+                speed = fs_bench_zip_deflate_run(pData, dataSize, dataSize, levels[iLevel], threadCounts[iThreadCount], &archiveSize);
+                if (speed < 0) {
+                    fs_free(pData, NULL);
+                    return FS_ERROR;
+                }
+
+                printf(" %7.1f MB/s (%d threads)", speed, threadCounts[iThreadCount]);
+            }
+
+            printf(", %5.1f%% of original size\n", (archiveSize * 100.0) / (double)dataSize);
+        }
+
+        printf("  %-6s level 6, 4KB files:", pKindNames[kind]);
+        for (iThreadCount = 0; iThreadCount < FS_BENCH_COUNTOF(threadCounts); iThreadCount += 1) {
+            speed = fs_bench_zip_deflate_run(pData, dataSize, 4096, 6, threadCounts[iThreadCount], &archiveSize);
+            if (speed < 0) {
+                fs_free(pData, NULL);
+                return FS_ERROR;
+            }
+
+            printf(" %7.1f MB/s (%d threads)", speed, threadCounts[iThreadCount]);
+        }
+        printf("\n");
+    }
+
+    fs_free(pData, NULL);
+
+    return FS_SUCCESS;
+}
+/* END fs_bench_zip_deflate */
+
+
+/* BEG fs_bench_mem_read_threaded */
+#define FS_BENCH_MEM_FILE_COUNT 1024
+#define FS_BENCH_MEM_FILE_SIZE  16384
+
+typedef struct
+{
+    fs* pFS;
+    int passCount;
+    fs_result result;
+} fs_bench_mem_read_job;
+
+static int fs_bench_mem_read_thread(void* pUserData)
+{
+    fs_bench_mem_read_job* pJob = (fs_bench_mem_read_job*)pUserData;
+    unsigned char buffer[4096];
+    char path[32];
+    int iPass;
+    int iFile;
+
+    pJob->result = FS_SUCCESS;
+
+    for (iPass = 0; iPass < pJob->passCount; iPass += 1) {
+        for (iFile = 0; iFile < FS_BENCH_MEM_FILE_COUNT; iFile += 1) {
+            fs_result result;
+            fs_file* pFile;
+            fs_file_info info;
+            size_t bytesRead;
+
+            fs_snprintf(path, sizeof(path), "/data/%d.bin", iFile);
+
+            result = fs_info(pJob->pFS, path, FS_READ | FS_IGNORE_MOUNTS, &info);
+            if (result == FS_SUCCESS) {
+                result = fs_file_open(pJob->pFS, path, FS_READ | FS_IGNORE_MOUNTS, &pFile);
+            }
+
+            if (result != FS_SUCCESS) {
+                pJob->result = result;
+                return 1;
+            }
+
+            do {
+                result = fs_file_read(pFile, buffer, sizeof(buffer), &bytesRead);
+            } while (result == FS_SUCCESS);
+
+            fs_file_close(pFile);
+        }
+    }
+
+    return 0;
+}
+
+static int fs_bench_mem_read_threaded(void)
+{
+    const int threadCounts[] = { 1, 2, 4, 8, 16, 32 };
+    const int totalPassCount = 64;
+    fs_config fsConfig;
+    fs* pFS;
+    fs_result result;
+    unsigned char* pData;
+    size_t iThreadCount;
+    double singleThreadedTime = 0;
+    int iFile;
+
+    fsConfig = fs_config_init(FS_MEM, NULL, NULL);
+
+    result = fs_init(&fsConfig, &pFS);
+    if (result != FS_SUCCESS) {
+        printf("  Failed to initialize file system: %d\n", result);
+        return FS_ERROR;
+    }
+
+    pData = (unsigned char*)fs_calloc(FS_BENCH_MEM_FILE_SIZE, NULL);
+    if (pData == NULL) {
+        fs_uninit(pFS);
+        return FS_ERROR;
+    }
+
+    result = fs_mkdir(pFS, "/data", FS_IGNORE_MOUNTS);
+    for (iFile = 0; iFile < FS_BENCH_MEM_FILE_COUNT && result == FS_SUCCESS; iFile += 1) {
+        fs_file* pFile;
+        char path[32];
+
+        fs_snprintf(path, sizeof(path), "/data/%d.bin", iFile);
+
+        result = fs_file_open(pFS, path, FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result == FS_SUCCESS) {
+            result = fs_file_write(pFile, pData, FS_BENCH_MEM_FILE_SIZE, NULL);
+            fs_file_close(pFile);
+        }
+    }
+
+    fs_free(pData, NULL);
+
+    if (result != FS_SUCCESS) {
+        printf("  Failed to create files: %d\n", result);
+        fs_uninit(pFS);
+        return FS_ERROR;
+    }
+
+    /* The same total amount of work is split between the threads. Each pass does an info, open and full read of every file. */
+    for (iThreadCount = 0; iThreadCount < FS_BENCH_COUNTOF(threadCounts); iThreadCount += 1) {
+        fs_bench_mem_read_job jobs[32];
+        fs_thrd threads[32];
+        int threadCount = threadCounts[iThreadCount];
+        int iThread;
+        double start;
+        double readTime;
+
+        start = fs_bench_wall_time_in_ms();
+
+        for (iThread = 0; iThread < threadCount; iThread += 1) {
+            jobs[iThread].pFS       = pFS;
+            jobs[iThread].passCount = totalPassCount / threadCount;
+            jobs[iThread].result    = FS_SUCCESS;
+
+            if (fs_thrd_create(&threads[iThread], fs_bench_mem_read_thread, &jobs[iThread], fs_get_allocation_callbacks(pFS)) != FS_SUCCESS) {
+                /* Fall back to doing the work on this thread. */
+                fs_bench_mem_read_thread(&jobs[iThread]);
+                threads[iThread] = (fs_thrd)0;
+            }
+        }
+
+        for (iThread = 0; iThread < threadCount; iThread += 1) {
+            if (threads[iThread] != (fs_thrd)0) {
+                fs_thrd_join(threads[iThread], NULL);
+            }
+
+            if (jobs[iThread].result != FS_SUCCESS) {
+                result = jobs[iThread].result;
+            }
+        }
+
+        readTime = fs_bench_wall_time_in_ms() - start;
+
+        if (result != FS_SUCCESS) {
+            printf("  Failed to read files: %d\n", result);
+            fs_uninit(pFS);
+            return FS_ERROR;
+        }
+
+        if (iThreadCount == 0) {
+            singleThreadedTime = readTime;
+        }
+
+        printf("  %2d threads: %10.3f ms, %8.1f MB/s (%.2fx)\n", threadCount, readTime, ((double)totalPassCount * FS_BENCH_MEM_FILE_COUNT * FS_BENCH_MEM_FILE_SIZE / (1024.0 * 1024.0)) / (readTime / 1000.0), singleThreadedTime / readTime);
+    }
+
+    fs_uninit(pFS);
+
+    return FS_SUCCESS;
+}
+/* END fs_bench_mem_read_threaded */
+
+
+/* BEG fs_bench_mem_tree */
+static int fs_bench_mem_tree(void)
+{
+    size_t counts[] = { 10000, 100000, 1000000 };
+    size_t iCount;
+
+    /* Builds a tree of empty files spread over directories of 1000 files each and then tears it down. */
+    for (iCount = 0; iCount < FS_BENCH_COUNTOF(counts); iCount += 1) {
+        fs_config fsConfig;
+        fs* pFS;
+        fs_result result;
+        size_t iFile;
+        double start;
+        double buildTime;
+        double uninitTime;
+
+        fsConfig = fs_config_init(FS_MEM, NULL, NULL);
+
+        result = fs_init(&fsConfig, &pFS);
+        if (result != FS_SUCCESS) {
+            printf("  Failed to initialize file system: %d\n", result);
+            return FS_ERROR;
+        }
+
+        start = fs_bench_wall_time_in_ms();
+
+        for (iFile = 0; iFile < counts[iCount] && result == FS_SUCCESS; iFile += 1) {
+            fs_file* pFile;
+            char path[64];
+
+            if ((iFile % 1000) == 0) {
+                fs_snprintf(path, sizeof(path), "/dir%u", (unsigned int)(iFile / 1000));
+
+                result = fs_mkdir(pFS, path, FS_IGNORE_MOUNTS);
+                if (result != FS_SUCCESS) {
+                    break;
+                }
+            }
+
+            fs_snprintf(path, sizeof(path), "/dir%u/file%u.txt", (unsigned int)(iFile / 1000), (unsigned int)iFile);
+
+            result = fs_file_open(pFS, path, FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+            if (result == FS_SUCCESS) {
+                fs_file_close(pFile);
+            }
+        }
+
+        buildTime = fs_bench_wall_time_in_ms() - start;
+
+        start = fs_bench_wall_time_in_ms();
+        fs_uninit(pFS);
+        uninitTime = fs_bench_wall_time_in_ms() - start;
+
+        if (result != FS_SUCCESS) {
+            printf("  Failed to create files: %d\n", result);
+            return FS_ERROR;
+        }
+
+        printf("  %8u files: build %10.3f ms, uninit %10.3f ms\n", (unsigned int)counts[iCount], buildTime, uninitTime);
+    }
+
+    return FS_SUCCESS;
+}
+/* END fs_bench_mem_tree */
+
+
+int main(int argc, char** argv)
+{
+    fs_bench benchmarks[] =
+    {
+        { "sort",              fs_bench_sort              },
+        { "zip_open",          fs_bench_zip_open          },
+        { "zip_open_threaded", fs_bench_zip_open_threaded },
+        { "zip_info",          fs_bench_zip_info          },
+        { "zip_inflate",       fs_bench_zip_inflate       },
+        { "zip_deflate",       fs_bench_zip_deflate       },
+        { "mem_read_threaded", fs_bench_mem_read_threaded },
+        { "mem_tree",          fs_bench_mem_tree          }
+    };
+    size_t iBench;
+    int iarg;
+    int result = 0;
+
+    for (iBench = 0; iBench < FS_BENCH_COUNTOF(benchmarks); iBench += 1) {
+        int isSelected = (argc < 2);
+
+        for (iarg = 1; iarg < argc; iarg += 1) {
+            if (strcmp(argv[iarg], benchmarks[iBench].name) == 0) {
+                isSelected = 1;
+                break;
+            }
+        }
+
+        if (!isSelected) {
+            continue;
+        }
+
+        printf("%s\n", benchmarks[iBench].name);
+        if (benchmarks[iBench].proc() != FS_SUCCESS) {
+            result = 1;
+        }
+    }
+
+    return result;
+}
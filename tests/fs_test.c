@@ -5,10 +5,12 @@
 
 #include "files/test1.zip.c"
 #include "files/test2.zip.c"
+#include "files/test3.zip.c"
 
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
+#include <time.h>
 
 const fs_backend* fs_test_get_backend(int argc, char** argv)
 {
@@ -720,6 +722,133 @@ int fs_test_binary_search(fs_test* pTest)
 /* END binary_search */
 
 
+/* BEG sort */
+typedef struct
+{
+    int key;
+    int index;
+    char padding[72];   /* Pushes the stride past the size of the internal swap buffer. */
+} fs_test_sort_item;
+
+static int fs_test_sort_compare(void* pUserData, const void* pA, const void* pB)
+{
+    int a = ((const fs_test_sort_item*)pA)->key;
+    int b = ((const fs_test_sort_item*)pB)->key;
+
+    (void)pUserData;
+
+    return (a > b) - (a < b);
+}
+
+static void* fs_test_sort_malloc(size_t sz, void* pUserData)
+{
+    *(int*)pUserData += 1;
+    return malloc(sz);
+}
+
+static void* fs_test_sort_realloc(void* p, size_t sz, void* pUserData)
+{
+    (void)pUserData;
+    return realloc(p, sz);
+}
+
+static void fs_test_sort_free(void* p, void* pUserData)
+{
+    (void)pUserData;
+    free(p);
+}
+
+static int fs_test_sort_internal(fs_test* pTest, size_t count, int presorted, fs_bool32 useSortEx, const fs_allocation_callbacks* pAllocationCallbacks)
+{
+    fs_test_sort_item* pItems;
+    size_t i;
+    int result = FS_SUCCESS;
+
+    pItems = (fs_test_sort_item*)fs_malloc(sizeof(*pItems) * (count + 1), NULL);
+    if (pItems == NULL) {
+        printf("%s: Out of memory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Use lots of duplicate keys so we can check stability. */
+    for (i = 0; i < count; i += 1) {
+        pItems[i].key   = presorted ? (int)(i / 3) : (int)((i * 7919) % 13);
+        pItems[i].index = (int)i;
+    }
+
+    /* With fs_sort(), anything that doesn't fit in the stack buffer is merged in place. */
+    if (!useSortEx) {
+        fs_sort(pItems, count, sizeof(*pItems), fs_test_sort_compare, NULL);
+    } else {
+        fs_sort_ex(pItems, count, sizeof(*pItems), fs_test_sort_compare, NULL, pAllocationCallbacks);
+    }
+
+    for (i = 1; i < count; i += 1) {
+        if (pItems[i - 1].key > pItems[i].key) {
+            printf("%s: List of %d items is not sorted at index %d.\n", pTest->name, (int)count, (int)i);
+            result = FS_ERROR;
+            break;
+        }
+
+        if (pItems[i - 1].key == pItems[i].key && pItems[i - 1].index > pItems[i].index) {
+            printf("%s: List of %d items is not stable at index %d.\n", pTest->name, (int)count, (int)i);
+            result = FS_ERROR;
+            break;
+        }
+    }
+
+    fs_free(pItems, NULL);
+    return result;
+}
+
+int fs_test_sort(fs_test* pTest)
+{
+    /* Sizes are chosen to hit the insertion sort path, the stack temp buffer, and the heap or in-place merge. */
+    size_t counts[] = { 0, 1, 2, 16, 17, 64, 1000, 5000 };
+    size_t i;
+    int errorCount = 0;
+    int allocationCount = 0;
+    fs_allocation_callbacks allocationCallbacks;
+
+    allocationCallbacks.pUserData = &allocationCount;
+    allocationCallbacks.onMalloc  = fs_test_sort_malloc;
+    allocationCallbacks.onRealloc = fs_test_sort_realloc;
+    allocationCallbacks.onFree    = fs_test_sort_free;
+
+    for (i = 0; i < FS_COUNTOF(counts); i += 1) {
+        if (fs_test_sort_internal(pTest, counts[i], 0, FS_FALSE, NULL) != FS_SUCCESS) {
+            errorCount += 1;
+        }
+
+        if (fs_test_sort_internal(pTest, counts[i], 1, FS_FALSE, NULL) != FS_SUCCESS) {
+            errorCount += 1;
+        }
+
+        /* NULL callbacks means the default allocator, not that allocation is disabled. */
+        if (fs_test_sort_internal(pTest, counts[i], 0, FS_TRUE, NULL) != FS_SUCCESS) {
+            errorCount += 1;
+        }
+
+        if (fs_test_sort_internal(pTest, counts[i], 0, FS_TRUE, &allocationCallbacks) != FS_SUCCESS) {
+            errorCount += 1;
+        }
+
+        if (fs_test_sort_internal(pTest, counts[i], 1, FS_TRUE, &allocationCallbacks) != FS_SUCCESS) {
+            errorCount += 1;
+        }
+    }
+
+    /* The larger lists don't fit in the stack buffer so fs_sort_ex() should have gone through our callbacks. */
+    if (allocationCount == 0) {
+        printf("%s: fs_sort_ex() did not use the supplied allocation callbacks.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END sort */
+
+
 /* BEG test_state */
 typedef struct
 {
@@ -1519,6 +1648,243 @@ int fs_test_system_read_noexist(fs_test* pTest)
 }
 /* END system_read_noexist */
 
+/* BEG positional */
+static int fs_test_positional_internal(fs_test* pTest, fs* pFS, const char* pFilePath)
+{
+    fs_result result;
+    fs_file* pFile;
+    size_t bytesRead;
+    size_t bytesWritten;
+    fs_int64 cursor;
+    char data[8];
+    const char pExpected[] = { 'b', 'X', 'Y', 'e' };
+    int errorCount = 0;
+
+    result = fs_test_open_and_write_file(pTest, pFS, pFilePath, FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, "abcdefgh", 8);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    result = fs_file_open(pFS, pFilePath, FS_READ | FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Move the cursor somewhere other than the start so we can check that it's not changed. */
+    fs_file_seek(pFile, 5, FS_SEEK_SET);
+
+    result = fs_file_write_at(pFile, 2, "XY", 2, &bytesWritten);
+    if (result != FS_SUCCESS || bytesWritten != 2) {
+        printf("%s: Failed to write at offset.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    result = fs_file_read_at(pFile, 1, data, 4, &bytesRead);
+    if (result != FS_SUCCESS || bytesRead != 4 || memcmp(data, pExpected, sizeof(pExpected)) != 0) {
+        printf("%s: Unexpected data when reading at offset.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* A read that goes past the end should be clamped. */
+    result = fs_file_read_at(pFile, 6, data, sizeof(data), &bytesRead);
+    if (result != FS_SUCCESS || bytesRead != 2 || data[0] != 'g' || data[1] != 'h') {
+        printf("%s: Unexpected result when reading past the end.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* Without an output variable the read needs to be exact. */
+    result = fs_file_read_at(pFile, 6, data, sizeof(data), NULL);
+    if (result == FS_SUCCESS) {
+        printf("%s: Expected an error for a short read without pBytesRead.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    result = fs_file_read_at(pFile, 8, data, sizeof(data), &bytesRead);
+    if (result != FS_AT_END || bytesRead != 0) {
+        printf("%s: Expected FS_AT_END when reading at the end of the file.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    result = fs_file_read_at(pFile, -1, data, sizeof(data), &bytesRead);
+    if (result != FS_INVALID_ARGS) {
+        printf("%s: Expected FS_INVALID_ARGS for a negative offset.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_file_tell(pFile, &cursor);
+    if (cursor != 5) {
+        printf("%s: Positional reads and writes changed the cursor. Expected 5, got %d.\n", pTest->name, (int)cursor);
+        errorCount += 1;
+    }
+
+    /* Normal reading should continue from where the cursor was left. */
+    result = fs_file_read(pFile, data, 1, NULL);
+    if (result != FS_SUCCESS || data[0] != 'f') {
+        printf("%s: Unexpected data when reading from the cursor.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_file_close(pFile);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END positional */
+
+/* BEG system_read_write_at */
+int fs_test_system_read_write_at(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    char pFilePath[256];
+
+    fs_path_append(pFilePath, sizeof(pFilePath), pTestState->pTempDir, (size_t)-1, "positional", (size_t)-1);
+
+    return fs_test_positional_internal(pTest, pTestState->pFS, pFilePath);
+}
+/* END system_read_write_at */
+
+/* BEG map */
+static int fs_test_map_internal(fs_test* pTest, fs* pFS, const char* pFilePath, const char* pEmptyFilePath)
+{
+    fs_result result;
+    fs_file* pFile;
+    const void* pData;
+    const void* pDataAgain;
+    size_t dataSize;
+    size_t dataSizeAgain;
+    int errorCount = 0;
+
+    result = fs_test_open_and_write_file(pTest, pFS, pFilePath, FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, "0123456789", 10);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    result = fs_file_open(pFS, pFilePath, FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    result = fs_file_map(pFile, &pData, &dataSize);
+    if (result != FS_SUCCESS || pData == NULL || dataSize != 10 || memcmp(pData, "0123456789", 10) != 0) {
+        printf("%s: Unexpected result when mapping file.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    /* Mapping again should return the same mapping. */
+    result = fs_file_map(pFile, &pDataAgain, &dataSizeAgain);
+    if (result != FS_SUCCESS || pDataAgain != pData || dataSizeAgain != dataSize) {
+        printf("%s: Expected the existing mapping to be returned.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_file_unmap(pFile);
+    fs_file_unmap(pFile);   /* Unmapping twice should be harmless. */
+
+    /* Map again, but this time let fs_file_close() clean up. */
+    result = fs_file_map(pFile, &pData, &dataSize);
+    if (result != FS_SUCCESS || dataSize != 10) {
+        printf("%s: Failed to map file after unmapping.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_file_close(pFile);
+
+
+    /* Empty files. */
+    result = fs_test_open_and_write_file(pTest, pFS, pEmptyFilePath, FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, "", 0);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    result = fs_file_open(pFS, pEmptyFilePath, FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open empty file.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    result = fs_file_map(pFile, &pData, &dataSize);
+    if (result != FS_SUCCESS || pData != NULL || dataSize != 0) {
+        printf("%s: Unexpected result when mapping an empty file.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_file_close(pFile);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END map */
+
+/* BEG system_map */
+int fs_test_system_map(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    char pFilePath[256];
+    char pEmptyFilePath[256];
+
+    fs_path_append(pFilePath,      sizeof(pFilePath),      pTestState->pTempDir, (size_t)-1, "mapped",       (size_t)-1);
+    fs_path_append(pEmptyFilePath, sizeof(pEmptyFilePath), pTestState->pTempDir, (size_t)-1, "mapped_empty", (size_t)-1);
+
+    return fs_test_map_internal(pTest, pTestState->pFS, pFilePath, pEmptyFilePath);
+}
+/* END system_map */
+
+/* BEG system_read_to_end */
+int fs_test_system_read_to_end(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_result result;
+    char pFilePath[256];
+    unsigned char pSrcData[10000];  /* Deliberately not a power of two or a multiple of the initial capacity. */
+    fs_file* pFile;
+    void* pData;
+    size_t dataSize;
+    size_t i;
+    int errorCount = 0;
+
+    for (i = 0; i < sizeof(pSrcData); i += 1) {
+        pSrcData[i] = (unsigned char)(i * 31);
+    }
+
+    fs_path_append(pFilePath, sizeof(pFilePath), pTestState->pTempDir, (size_t)-1, "read_to_end", (size_t)-1);
+
+    result = fs_test_open_and_write_file(pTest, pTestState->pFS, pFilePath, FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, pSrcData, sizeof(pSrcData));
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    result = fs_file_open(pTestState->pFS, pFilePath, FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* The size hint is derived from the size of the file and needs to account for the cursor. */
+    fs_file_seek(pFile, 1000, FS_SEEK_SET);
+
+    result = fs_file_read_to_end(pFile, FS_FORMAT_BINARY, &pData, &dataSize);
+    if (result != FS_SUCCESS || dataSize != sizeof(pSrcData) - 1000 || memcmp(pData, pSrcData + 1000, dataSize) != 0) {
+        printf("%s: Unexpected data when reading a file to the end.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_free(pData, fs_get_allocation_callbacks(pTestState->pFS));
+
+    /* Reading again from the end should give back an empty buffer. */
+    result = fs_file_read_to_end(pFile, FS_FORMAT_BINARY, &pData, &dataSize);
+    if (result != FS_SUCCESS || dataSize != 0) {
+        printf("%s: Expected no data when reading to the end from the end of the file.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_free(pData, fs_get_allocation_callbacks(pTestState->pFS));
+    fs_file_close(pFile);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END system_read_to_end */
+
 /* BEG system_duplicate */
 int fs_test_system_duplicate(fs_test* pTest)
 {
@@ -2438,45 +2804,308 @@ int fs_test_mounts_iteration_prefix_bug(fs_test* pTest)
 }
 /* END mounts_iteration */
 
-/* BEG unmount */
-int fs_test_unmount(fs_test* pTest)
+/* BEG mounts_iteration_names_only */
+int fs_test_mounts_iteration_names_only(fs_test* pTest)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
     fs_result result;
-    char pDir1Path[256];
-    char pDir2Path[256];
-    char pDir3Path[256];
-
-    fs_path_append(pDir1Path, sizeof(pDir1Path), pTestState->pTempDir, (size_t)-1, "dir1", (size_t)-1);
-    fs_path_append(pDir2Path, sizeof(pDir2Path), pTestState->pTempDir, (size_t)-1, "dir2", (size_t)-1);
-    fs_path_append(pDir3Path, sizeof(pDir3Path), pTestState->pTempDir, (size_t)-1, "dir3", (size_t)-1);
+    fs_iterator* pIterator;
+    const char* pExpectedNames[] = {
+        "file1",
+        "file2",
+        "dir1",
+        "dir2",
+        "file_with_a_long_name_0123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789"
+    };
+    fs_bool32 pFound[5] = { FS_FALSE, FS_FALSE, FS_FALSE, FS_FALSE, FS_FALSE };
+    size_t i;
 
-    result = fs_unmount(pTestState->pFS, pDir1Path, FS_READ | FS_WRITE);
+    /* This uses the directory set up by the previous test. The long name makes sure names are copied in full. */
+    result = fs_test_open_and_write_file(pTest, pTestState->pFS, "iteration/file_with_a_long_name_0123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789", FS_WRITE, NULL, 0);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to unmount %s.\n", pTest->name, pDir1Path);
+        printf("%s: Failed to create file.\n", pTest->name);
         return FS_ERROR;
     }
 
-    result = fs_unmount(pTestState->pFS, pDir2Path, FS_READ);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to unmount %s.\n", pTest->name, pDir2Path);
-        return FS_ERROR;
-    }
+    for (pIterator = fs_first(pTestState->pFS, "iteration", FS_READ | FS_OPAQUE | FS_NAMES_ONLY); pIterator != NULL; pIterator = fs_next(pIterator)) {
+        fs_bool32 found = FS_FALSE;
 
-    result = fs_unmount(pTestState->pFS, pDir3Path, FS_READ);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to unmount %s.\n", pTest->name, pDir3Path);
-        return FS_ERROR;
+        for (i = 0; i < FS_COUNTOF(pExpectedNames); i += 1) {
+            if (strlen(pExpectedNames[i]) == pIterator->nameLen && fs_strncmp(pExpectedNames[i], pIterator->pName, pIterator->nameLen) == 0) {
+                found = FS_TRUE;
+                pFound[i] = FS_TRUE;
+                break;
+            }
+        }
+
+        if (!found) {
+            printf("%s: Unexpected file found: %.*s\n", pTest->name, (int)pIterator->nameLen, pIterator->pName);
+            fs_free_iterator(pIterator);
+            return FS_ERROR;
+        }
+
+        /* The directory flag must still be reliable without the full file information. */
+        if ((pIterator->info.directory != 0) != (pIterator->pName[0] == 'd')) {
+            printf("%s: Entry incorrectly identified: %.*s\n", pTest->name, (int)pIterator->nameLen, pIterator->pName);
+            fs_free_iterator(pIterator);
+            return FS_ERROR;
+        }
     }
 
-    result = fs_unmount(pTestState->pFS, pTestState->pTempDir, FS_READ | FS_WRITE);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to unmount %s.\n", pTest->name, pTestState->pTempDir);
-        return FS_ERROR;
+    for (i = 0; i < FS_COUNTOF(pExpectedNames); i += 1) {
+        if (!pFound[i]) {
+            printf("%s: Missing entry: %s\n", pTest->name, pExpectedNames[i]);
+            return FS_ERROR;
+        }
     }
 
-    /* Finally we need to delete the temp folder recursively to clean everything up. */
-    result = fs_test_system_remove_directory(pTest, pTestState->pTempDir);
+    return FS_SUCCESS;
+}
+/* END mounts_iteration_names_only */
+
+/* BEG iteration_first_ex */
+/*
+The iteration mode is given to backends through the optional first_ex callback. Backends that only
+have first need to keep working, and backends that have first_ex need to be given the mode.
+*/
+typedef struct
+{
+    fs_iterator iterator;
+    int index;
+} fs_test_first_ex_iterator;
+
+static const char* fs_test_first_ex_names[] = { "a", "b" };
+static int fs_test_first_ex_first_count;
+static int fs_test_first_ex_last_mode;
+
+static fs_result fs_test_first_ex_backend_init(fs* pFS, const void* pBackendConfig, fs_stream* pStream)
+{
+    (void)pFS;
+    (void)pBackendConfig;
+    (void)pStream;
+    return FS_SUCCESS;
+}
+
+static fs_iterator* fs_test_first_ex_backend_first(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen)
+{
+    fs_test_first_ex_iterator* pIterator;
+
+    (void)pDirectoryPath;
+    (void)directoryPathLen;
+
+    fs_test_first_ex_first_count += 1;
+
+    pIterator = (fs_test_first_ex_iterator*)fs_calloc(sizeof(*pIterator), fs_get_allocation_callbacks(pFS));
+    if (pIterator == NULL) {
+        return NULL;
+    }
+
+    pIterator->iterator.pFS     = pFS;
+    pIterator->iterator.pName   = fs_test_first_ex_names[0];
+    pIterator->iterator.nameLen = 1;
+
+    return (fs_iterator*)pIterator;
+}
+
+static fs_iterator* fs_test_first_ex_backend_first_ex(fs* pFS, const char* pDirectoryPath, size_t directoryPathLen, int mode)
+{
+    fs_iterator* pIterator;
+
+    pIterator = fs_test_first_ex_backend_first(pFS, pDirectoryPath, directoryPathLen);
+    fs_test_first_ex_first_count -= 1;  /* Only count direct calls to first. */
+    fs_test_first_ex_last_mode = mode;
+
+    return pIterator;
+}
+
+static void fs_test_first_ex_backend_free_iterator(fs_iterator* pIterator)
+{
+    fs_free(pIterator, fs_get_allocation_callbacks(pIterator->pFS));
+}
+
+static fs_iterator* fs_test_first_ex_backend_next(fs_iterator* pIterator)
+{
+    fs_test_first_ex_iterator* pTestIterator = (fs_test_first_ex_iterator*)pIterator;
+
+    pTestIterator->index += 1;
+    if (pTestIterator->index == (int)FS_COUNTOF(fs_test_first_ex_names)) {
+        fs_test_first_ex_backend_free_iterator(pIterator);
+        return NULL;
+    }
+
+    pTestIterator->iterator.pName = fs_test_first_ex_names[pTestIterator->index];
+
+    return pIterator;
+}
+
+static fs_result fs_test_iteration_first_ex_internal(fs_test* pTest, fs_bool32 hasFirstEx)
+{
+    fs_result result;
+    fs_backend backend;
+    fs_config config;
+    fs* pFS;
+    fs_iterator* pIterator;
+    int entryCount = 0;
+
+    FS_ZERO_OBJECT(&backend);
+    backend.init          = fs_test_first_ex_backend_init;
+    backend.first         = fs_test_first_ex_backend_first;
+    backend.next          = fs_test_first_ex_backend_next;
+    backend.free_iterator = fs_test_first_ex_backend_free_iterator;
+
+    if (hasFirstEx) {
+        backend.first_ex = fs_test_first_ex_backend_first_ex;
+    }
+
+    config = fs_config_init(&backend, NULL, NULL);
+
+    result = fs_init(&config, &pFS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the file system (%d).\n", pTest->name, result);
+        return FS_ERROR;
+    }
+
+    fs_test_first_ex_first_count = 0;
+    fs_test_first_ex_last_mode   = 0;
+
+    for (pIterator = fs_first(pFS, "dir", FS_READ | FS_OPAQUE | FS_NAMES_ONLY); pIterator != NULL; pIterator = fs_next(pIterator)) {
+        entryCount += 1;
+    }
+
+    fs_uninit(pFS);
+
+    if (entryCount != (int)FS_COUNTOF(fs_test_first_ex_names)) {
+        printf("%s: Expected %d entries, but got %d.\n", pTest->name, (int)FS_COUNTOF(fs_test_first_ex_names), entryCount);
+        return FS_ERROR;
+    }
+
+    if (hasFirstEx) {
+        if (fs_test_first_ex_first_count != 0 || (fs_test_first_ex_last_mode & FS_NAMES_ONLY) == 0) {
+            printf("%s: The mode was not given to first_ex.\n", pTest->name);
+            return FS_ERROR;
+        }
+    } else {
+        if (fs_test_first_ex_first_count != 1) {
+            printf("%s: first was not used when first_ex is null.\n", pTest->name);
+            return FS_ERROR;
+        }
+    }
+
+    return FS_SUCCESS;
+}
+
+int fs_test_iteration_first_ex(fs_test* pTest)
+{
+    if (fs_test_iteration_first_ex_internal(pTest, FS_FALSE) != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    if (fs_test_iteration_first_ex_internal(pTest, FS_TRUE) != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END iteration_first_ex */
+
+/* BEG mounts_iteration_priority */
+int fs_test_mounts_iteration_priority(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_result result;
+    fs_iterator* pIterator;
+    char pLowPath[256];
+    char pHighPath[256];
+    int xCount = 0;
+    int onlyLowCount = 0;
+    int errorCount = 0;
+
+    /* The same file name exists in two mounts. Only the one from the highest priority mount should be returned. */
+    result = fs_test_open_and_write_file(pTest, pTestState->pFS, "priority/low/x", FS_WRITE, "1", 1);
+    if (result == FS_SUCCESS) {
+        result = fs_test_open_and_write_file(pTest, pTestState->pFS, "priority/low/onlylow", FS_WRITE, "1", 1);
+    }
+    if (result == FS_SUCCESS) {
+        result = fs_test_open_and_write_file(pTest, pTestState->pFS, "priority/high/x", FS_WRITE, "22", 2);
+    }
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to create files.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    fs_path_append(pLowPath,  sizeof(pLowPath),  pTestState->pTempDir, (size_t)-1, "dir/priority/low",  (size_t)-1);
+    fs_path_append(pHighPath, sizeof(pHighPath), pTestState->pTempDir, (size_t)-1, "dir/priority/high", (size_t)-1);
+
+    fs_mount(pTestState->pFS, pLowPath,  "prio", FS_READ);
+    fs_mount(pTestState->pFS, pHighPath, "prio", FS_READ);   /* <-- Most recent mount has the highest priority. */
+
+    for (pIterator = fs_first(pTestState->pFS, "prio", FS_READ | FS_OPAQUE); pIterator != NULL; pIterator = fs_next(pIterator)) {
+        if (pIterator->nameLen == 1 && pIterator->pName[0] == 'x') {
+            xCount += 1;
+
+            if (pIterator->info.size != 2) {
+                printf("%s: Expected the entry from the highest priority mount.\n", pTest->name);
+                errorCount += 1;
+            }
+        } else if (fs_strncmp(pIterator->pName, "onlylow", pIterator->nameLen) == 0) {
+            onlyLowCount += 1;
+        } else {
+            printf("%s: Unexpected file found: %.*s\n", pTest->name, (int)pIterator->nameLen, pIterator->pName);
+            errorCount += 1;
+        }
+    }
+
+    if (xCount != 1 || onlyLowCount != 1) {
+        printf("%s: Expected each entry exactly once. Got x=%d, onlylow=%d.\n", pTest->name, xCount, onlyLowCount);
+        errorCount += 1;
+    }
+
+    fs_unmount(pTestState->pFS, pHighPath, 0);
+    fs_unmount(pTestState->pFS, pLowPath,  0);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END mounts_iteration_priority */
+
+/* BEG unmount */
+int fs_test_unmount(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_result result;
+    char pDir1Path[256];
+    char pDir2Path[256];
+    char pDir3Path[256];
+
+    fs_path_append(pDir1Path, sizeof(pDir1Path), pTestState->pTempDir, (size_t)-1, "dir1", (size_t)-1);
+    fs_path_append(pDir2Path, sizeof(pDir2Path), pTestState->pTempDir, (size_t)-1, "dir2", (size_t)-1);
+    fs_path_append(pDir3Path, sizeof(pDir3Path), pTestState->pTempDir, (size_t)-1, "dir3", (size_t)-1);
+
+    result = fs_unmount(pTestState->pFS, pDir1Path, FS_READ | FS_WRITE);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to unmount %s.\n", pTest->name, pDir1Path);
+        return FS_ERROR;
+    }
+
+    result = fs_unmount(pTestState->pFS, pDir2Path, FS_READ);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to unmount %s.\n", pTest->name, pDir2Path);
+        return FS_ERROR;
+    }
+
+    result = fs_unmount(pTestState->pFS, pDir3Path, FS_READ);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to unmount %s.\n", pTest->name, pDir3Path);
+        return FS_ERROR;
+    }
+
+    result = fs_unmount(pTestState->pFS, pTestState->pTempDir, FS_READ | FS_WRITE);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to unmount %s.\n", pTest->name, pTestState->pTempDir);
+        return FS_ERROR;
+    }
+
+    /* Finally we need to delete the temp folder recursively to clean everything up. */
+    result = fs_test_system_remove_directory(pTest, pTestState->pTempDir);
     if (result != FS_SUCCESS) {
         printf("%s: Failed to remove temp directory.\n", pTest->name);
         return FS_ERROR;
@@ -3277,1085 +3906,4435 @@ int fs_test_archives_duplicate(fs_test* pTest)
 }
 /* END archives_duplicate */
 
-/* BEG archives_uninit */
-int fs_test_archives_uninit(fs_test* pTest)
+/* BEG archives_registry */
+#define FS_TEST_REGISTRY_ARCHIVE_COUNT  40
+
+int fs_test_archives_registry(fs_test* pTest)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
     fs_result result;
+    fs_file* pFiles[FS_TEST_REGISTRY_ARCHIVE_COUNT];
+    fs_file* pFile;
+    char pPath[64];
+    int iArchive;
 
-    /* Clean up the entire temp folder. */
-    result = fs_test_system_remove_directory(pTest, pTestState->pTempDir);
+    /*
+    This tests the lookup of opened archives. We want enough archives open at the same time that the
+    internal index needs to grow a few times, and then we want to remove them in a non-sequential order
+    to make sure lookups still find the remaining archives.
+    */
+    result = fs_mkdir(pTestState->pFS, "registry", 0);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to remove temp directory.\n", pTest->name);
+        printf("%s: Failed to create registry directory.\n", pTest->name);
         return FS_ERROR;
     }
 
-    fs_uninit(pTestState->pFS);
-    return FS_SUCCESS;
-}
-/* END archive_uninit */
+    for (iArchive = 0; iArchive < FS_TEST_REGISTRY_ARCHIVE_COUNT; iArchive += 1) {
+        fs_snprintf(pPath, sizeof(pPath), "registry/archive%d.zip", iArchive);
 
-/* BEG mem_init */
-int fs_test_mem_init(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs_result result;
-    fs_config fsConfig;
-    fs* pFS;
-    fs_file_info info;
+        result = fs_test_open_and_write_file(pTest, pTestState->pFS, pPath, FS_WRITE, fs_test_file_test1_zip, sizeof(fs_test_file_test1_zip));
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to create %s.\n", pTest->name, pPath);
+            return FS_ERROR;
+        }
+    }
 
-    /* Initialize fs_mem backend. */
-    fsConfig = fs_config_init(FS_MEM, NULL, NULL);
+    for (iArchive = 0; iArchive < FS_TEST_REGISTRY_ARCHIVE_COUNT; iArchive += 1) {
+        fs_snprintf(pPath, sizeof(pPath), "registry/archive%d.zip/b", iArchive);
 
-    result = fs_init(&fsConfig, &pFS);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to initialize fs_mem file system.\n", pTest->name);
-        return FS_ERROR;
+        result = fs_file_open(pTestState->pFS, pPath, FS_READ | FS_VERBOSE, &pFiles[iArchive]);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open %s.\n", pTest->name, pPath);
+            return FS_ERROR;
+        }
     }
 
-    pTestState->pFS = pFS;
+    /* Every archive should be distinct, and opening a file from an already opened archive should reuse it. */
+    for (iArchive = 0; iArchive < FS_TEST_REGISTRY_ARCHIVE_COUNT; iArchive += 1) {
+        fs_snprintf(pPath, sizeof(pPath), "registry/archive%d.zip/a", iArchive);
 
-    /* Verify root directory exists and is accessible. */
-    result = fs_info(pFS, "/", FS_IGNORE_MOUNTS, &info);
-    if (result != FS_SUCCESS || !info.directory) {
-        printf("%s: Root directory is not accessible.\n", pTest->name);
-        return FS_ERROR;
+        if (iArchive > 0 && fs_file_get_fs(pFiles[iArchive]) == fs_file_get_fs(pFiles[iArchive - 1])) {
+            printf("%s: Two different archives resolved to the same file system.\n", pTest->name);
+            return FS_ERROR;
+        }
+
+        result = fs_file_open(pTestState->pFS, pPath, FS_READ | FS_VERBOSE, &pFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open %s.\n", pTest->name, pPath);
+            return FS_ERROR;
+        }
+
+        if (fs_file_get_fs(pFile) != fs_file_get_fs(pFiles[iArchive])) {
+            printf("%s: Opened archive was not reused for %s.\n", pTest->name, pPath);
+            fs_file_close(pFile);
+            return FS_ERROR;
+        }
+
+        fs_file_close(pFile);
+    }
+
+    /* Close every second file and collect the archives so they are removed from the middle of the registry. */
+    for (iArchive = 0; iArchive < FS_TEST_REGISTRY_ARCHIVE_COUNT; iArchive += 2) {
+        fs_file_close(pFiles[iArchive]);
+        pFiles[iArchive] = NULL;
+    }
+
+    fs_gc_archives(pTestState->pFS, FS_GC_POLICY_FULL);
+
+    for (iArchive = 1; iArchive < FS_TEST_REGISTRY_ARCHIVE_COUNT; iArchive += 2) {
+        fs_snprintf(pPath, sizeof(pPath), "registry/archive%d.zip/a", iArchive);
+
+        result = fs_file_open(pTestState->pFS, pPath, FS_READ | FS_VERBOSE, &pFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open %s after garbage collection.\n", pTest->name, pPath);
+            return FS_ERROR;
+        }
+
+        if (fs_file_get_fs(pFile) != fs_file_get_fs(pFiles[iArchive])) {
+            printf("%s: Opened archive was lost from the registry for %s.\n", pTest->name, pPath);
+            fs_file_close(pFile);
+            return FS_ERROR;
+        }
+
+        fs_file_close(pFile);
+        fs_file_close(pFiles[iArchive]);
+        pFiles[iArchive] = NULL;
     }
 
+    fs_gc_archives(pTestState->pFS, FS_GC_POLICY_FULL);
+
     return FS_SUCCESS;
 }
-/* END mem_init */
+/* END archives_registry */
 
-/* BEG mem_mkdir */
-int fs_test_mem_mkdir(fs_test* pTest)
+/* BEG archives_resolution_cache */
+/* A Zip backend that can be made to fail initialization, like it would when running out of memory. */
+static fs_backend fs_test_resolution_cache_flaky_zip_backend;
+static fs_bool32 fs_test_resolution_cache_flaky_zip_should_fail;
+
+static fs_result fs_test_resolution_cache_flaky_zip_init(fs* pFS, const void* pBackendConfig, fs_stream* pStream)
+{
+    if (fs_test_resolution_cache_flaky_zip_should_fail) {
+        return FS_OUT_OF_MEMORY;
+    }
+
+    return FS_ZIP->init(pFS, pBackendConfig, pStream);
+}
+
+static int fs_test_archives_resolution_cache_transient_error(fs_test* pTest, const char* pCachePath)
 {
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
+    fs_config config;
+    fs_archive_type pArchiveTypes[1];
+    fs* pFS;
     fs_file_info info;
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
 
-    /* Create nested directory structure. */
-    result = fs_mkdir(pFS, "/testdir", FS_WRITE | FS_IGNORE_MOUNTS);
+    fs_test_resolution_cache_flaky_zip_backend      = *FS_ZIP;
+    fs_test_resolution_cache_flaky_zip_backend.init = fs_test_resolution_cache_flaky_zip_init;
+
+    pArchiveTypes[0] = fs_archive_type_init(&fs_test_resolution_cache_flaky_zip_backend, "zip");
+
+    config = fs_config_init(pTestState->pBackend, NULL, NULL);
+    config.pArchiveTypes       = pArchiveTypes;
+    config.archiveTypeCount    = FS_COUNTOF(pArchiveTypes);
+    config.resolutionCacheSize = 16;
+
+    result = fs_init(&config, &pFS);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to create /testdir.\n", pTest->name);
+        printf("%s: Failed to initialize file system.\n", pTest->name);
         return FS_ERROR;
     }
 
-    result = fs_mkdir(pFS, "/testdir/subdir1", FS_WRITE | FS_IGNORE_MOUNTS);
+    result = fs_mount(pFS, pCachePath, "", FS_READ | FS_WRITE);
+    if (result == FS_SUCCESS) {
+        result = fs_test_open_and_write_file(pTest, pFS, "test1.zip", FS_WRITE, fs_test_file_test1_zip, sizeof(fs_test_file_test1_zip));
+    }
+
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to create /testdir/subdir1.\n", pTest->name);
+        fs_uninit(pFS);
         return FS_ERROR;
     }
 
-    result = fs_mkdir(pFS, "/testdir/subdir2", FS_WRITE | FS_IGNORE_MOUNTS);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to create /testdir/subdir2.\n", pTest->name);
+    /* The archive can't be opened this time, but that doesn't mean the file isn't in there. */
+    fs_test_resolution_cache_flaky_zip_should_fail = FS_TRUE;
+    result = fs_info(pFS, "b", FS_READ, &info);
+    fs_test_resolution_cache_flaky_zip_should_fail = FS_FALSE;
+
+    if (result == FS_SUCCESS) {
+        printf("%s: Found a file in an archive that failed to open.\n", pTest->name);
+        fs_uninit(pFS);
         return FS_ERROR;
     }
 
-    result = fs_mkdir(pFS, "/testdir/subdir1/nested", FS_WRITE | FS_IGNORE_MOUNTS);
+    result = fs_info(pFS, "b", FS_READ, &info);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to create /testdir/subdir1/nested.\n", pTest->name);
+        printf("%s: A failure to open an archive was cached as the file not existing.\n", pTest->name);
+        fs_uninit(pFS);
         return FS_ERROR;
     }
 
-    /* Verify directories exist and have correct properties. */
-    result = fs_info(pFS, "/testdir", FS_IGNORE_MOUNTS, &info);
-    if (result != FS_SUCCESS || !info.directory) {
-        printf("%s: /testdir does not exist or is not a directory.\n", pTest->name);
-        return FS_ERROR;
-    }
-
-    result = fs_info(pFS, "/testdir/subdir1/nested", FS_IGNORE_MOUNTS, &info);
-    if (result != FS_SUCCESS || !info.directory) {
-        printf("%s: Nested directory does not exist or is not a directory.\n", pTest->name);
-        return FS_ERROR;
-    }
-
-    /* Test duplicate directory creation fails. */
-    result = fs_mkdir(pFS, "/testdir", FS_WRITE | FS_IGNORE_MOUNTS);
-    if (result == FS_SUCCESS) {
-        printf("%s: Duplicate directory creation should have failed.\n", pTest->name);
-        return FS_ERROR;
-    }
-
-    /* Test error condition: Try to mkdir with file as parent (requires a file to exist first). */
-    /* Create a temporary file for this test. */
-    {
-        fs_file* pFile;
-        result = fs_file_open(pFS, "/testdir/temp_file_for_mkdir_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
-        if (result == FS_SUCCESS) {
-            fs_file_close(pFile);
-            
-            /* Now try to mkdir with this file as parent. */
-            result = fs_mkdir(pFS, "/testdir/temp_file_for_mkdir_test.txt/subdir", FS_WRITE | FS_IGNORE_MOUNTS);
-            if (result == FS_SUCCESS) {
-                printf("%s: Creating directory with file as parent should have failed.\n", pTest->name);
-                return FS_ERROR;
-            }
-            
-            /* Clean up the temp file. */
-            fs_remove(pFS, "/testdir/temp_file_for_mkdir_test.txt", FS_WRITE | FS_IGNORE_MOUNTS);
-        }
-    }
-
-    return FS_SUCCESS;
-}
-/* END mem_mkdir */
-
-/* BEG mem_write */
-int fs_test_mem_write(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_gc_archives(pFS, FS_GC_POLICY_FULL);
+    fs_remove(pFS, "test1.zip", 0);
 
-    /* This is just a container test - actual write tests are in sub-tests. */
-    (void)pTestState;
+    fs_uninit(pFS);
     return FS_SUCCESS;
 }
-/* END mem_write */
 
-/* BEG mem_write_new */
-int fs_test_mem_write_new(fs_test* pTest)
+int fs_test_archives_resolution_cache(fs_test* pTest)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
-    const char* testContent = "Hello, Memory File System!";
+    fs_config config;
+    fs_archive_type pArchiveTypes[1];
+    fs* pFS;
     fs_file_info info;
+    char pCachePath[256];
+    int iAttempt;
 
-    result = fs_test_open_and_write_file(pTest, pFS, "/testdir/test_new.txt", FS_WRITE | FS_IGNORE_MOUNTS, testContent, strlen(testContent));
+    pArchiveTypes[0] = fs_archive_type_init(FS_ZIP, "zip");
+
+    config = fs_config_init(pTestState->pBackend, NULL, NULL);
+    config.pArchiveTypes       = pArchiveTypes;
+    config.archiveTypeCount    = FS_COUNTOF(pArchiveTypes);
+    config.resolutionCacheSize = 16;
+
+    result = fs_init(&config, &pFS);
     if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize file system.\n", pTest->name);
         return FS_ERROR;
     }
 
-    /* Verify file exists and has correct size. */
-    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
+    fs_path_append(pCachePath, sizeof(pCachePath), pTestState->pTempDir, (size_t)-1, "cache", (size_t)-1);
+
+    result = fs_mkdir(NULL, pCachePath, 0);
     if (result != FS_SUCCESS) {
-        printf("%s: Created file does not exist.\n", pTest->name);
+        printf("%s: Failed to create cache directory.\n", pTest->name);
+        fs_uninit(pFS);
         return FS_ERROR;
     }
 
-    if (info.directory || (unsigned int)info.size != strlen(testContent)) {
-        printf("%s: Created file has incorrect properties (directory=%d, size=%u, expected=%u).\n", pTest->name, info.directory, (unsigned int)info.size, (unsigned int)strlen(testContent));
+    result = fs_mount(pFS, pCachePath, "", FS_READ | FS_WRITE);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to mount cache directory.\n", pTest->name);
+        fs_uninit(pFS);
         return FS_ERROR;
     }
 
-    /* Test error condition: Try to create file in non-existent directory - should fail. */
-    {
-        fs_file* pFile;
-        result = fs_file_open(pFS, "/completely_nonexistent_dir/file.txt", FS_WRITE | FS_IGNORE_MOUNTS | FS_NO_CREATE_DIRS, &pFile);
-        if (result == FS_SUCCESS) {
-            fs_file_close(pFile);
-            printf("%s: Creating file in non-existent directory should have failed (result=%d).\n", pTest->name, result);
+    /* There are no archives yet so this should fail, and it should keep failing when served from the cache. */
+    for (iAttempt = 0; iAttempt < 2; iAttempt += 1) {
+        result = fs_info(pFS, "b", FS_READ, &info);
+        if (result != FS_DOES_NOT_EXIST) {
+            printf("%s: Expected FS_DOES_NOT_EXIST before the archive exists.\n", pTest->name);
+            fs_uninit(pFS);
             return FS_ERROR;
         }
+    }
 
-        /* Verify the expected error is FS_DOES_NOT_EXIST. */
-        if (result != FS_DOES_NOT_EXIST) {
-            printf("%s: Expected FS_DOES_NOT_EXIST (%d) but got %d when creating file in non-existent directory.\n", pTest->name, FS_DOES_NOT_EXIST, result);
+    /* Writing the archive through the fs object must invalidate the negative entry. */
+    result = fs_test_open_and_write_file(pTest, pFS, "test1.zip", FS_WRITE, fs_test_file_test1_zip, sizeof(fs_test_file_test1_zip));
+    if (result != FS_SUCCESS) {
+        fs_uninit(pFS);
+        return FS_ERROR;
+    }
+
+    for (iAttempt = 0; iAttempt < 2; iAttempt += 1) {
+        result = fs_info(pFS, "b", FS_READ, &info);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to find file in archive after it was created.\n", pTest->name);
+            fs_uninit(pFS);
             return FS_ERROR;
         }
     }
 
-    return FS_SUCCESS;
-}
-/* END mem_write_new */
-
-/* BEG mem_write_overwrite */
-int fs_test_mem_write_overwrite(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
-    fs_result result;
-    const char* originalContent = "Hello, Memory File System!";
-    const char* newContent = "Overwritten content!";
-    fs_file_info info;
+    /* Renaming the archive must not break lookups. */
+    result = fs_rename(pFS, "test1.zip", "test2.zip", 0);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to rename archive.\n", pTest->name);
+        fs_uninit(pFS);
+        return FS_ERROR;
+    }
 
-    /* First write the original content to ensure we have a baseline. */
-    result = fs_test_open_and_write_file(pTest, pFS, "/testdir/overwrite_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, originalContent, strlen(originalContent));
+    result = fs_info(pFS, "b", FS_READ, &info);
     if (result != FS_SUCCESS) {
+        printf("%s: Failed to find file in archive after it was renamed.\n", pTest->name);
+        fs_uninit(pFS);
         return FS_ERROR;
     }
 
-    /* Overwrite the file with new content. */
-    result = fs_test_open_and_write_file(pTest, pFS, "/testdir/overwrite_test.txt", FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, newContent, strlen(newContent));
+    /* Removing the archive must invalidate the positive entry. */
+    fs_gc_archives(pFS, FS_GC_POLICY_FULL);
+
+    result = fs_remove(pFS, "test2.zip", 0);
     if (result != FS_SUCCESS) {
+        printf("%s: Failed to remove archive.\n", pTest->name);
+        fs_uninit(pFS);
         return FS_ERROR;
     }
 
-    /* Verify file has new size. */
-    result = fs_info(pFS, "/testdir/overwrite_test.txt", FS_IGNORE_MOUNTS, &info);
-    if (result != FS_SUCCESS || (unsigned int)info.size != strlen(newContent)) {
-        printf("%s: Overwritten file has incorrect size (got=%u, expected=%u).\n", pTest->name, (unsigned int)info.size, (unsigned int)strlen(newContent));
+    result = fs_info(pFS, "b", FS_READ, &info);
+    if (result != FS_DOES_NOT_EXIST) {
+        printf("%s: Expected FS_DOES_NOT_EXIST after the archive was removed.\n", pTest->name);
+        fs_uninit(pFS);
         return FS_ERROR;
     }
 
-    return FS_SUCCESS;
+    fs_uninit(pFS);
+
+    return fs_test_archives_resolution_cache_transient_error(pTest, pCachePath);
 }
-/* END mem_write_overwrite */
+/* END archives_resolution_cache */
 
-/* BEG mem_write_append */
-int fs_test_mem_write_append(fs_test* pTest)
+/* BEG archives_shared_stream */
+int fs_test_archives_shared_stream(fs_test* pTest)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
-    fs_file* pFile;
-    const char* appendContent = " Appended!";
-    size_t originalSize;
-    fs_file_info info;
-    size_t bytesWritten;
+    const char* pPaths[]   = { "test1.zip/a", "test1.zip/b", "test1.zip/dir1/c" };
+    const char  pExpected[] = { 'a', 'b', 'c' };
+    fs_file* pFiles[3];
+    fs* pArchive;
+    size_t iFile;
+    int errorCount = 0;
 
-    /* Get current file size. */
-    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
-    if (result != FS_SUCCESS) {
-        printf("%s: Cannot get file info for append test.\n", pTest->name);
-        return FS_ERROR;
+    for (iFile = 0; iFile < FS_COUNTOF(pFiles); iFile += 1) {
+        result = fs_file_open(pTestState->pFS, pPaths[iFile], FS_READ | FS_VERBOSE, &pFiles[iFile]);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open %s.\n", pTest->name, pPaths[iFile]);
+
+            while (iFile > 0) {
+                iFile -= 1;
+                fs_file_close(pFiles[iFile]);
+            }
+
+            return FS_ERROR;
+        }
     }
-    originalSize = (size_t)info.size;
 
-    /* Open file in append mode. */
-    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_WRITE | FS_APPEND | FS_IGNORE_MOUNTS, &pFile);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to open file in append mode.\n", pTest->name);
-        return FS_ERROR;
+    pArchive = fs_file_get_fs(pFiles[0]);
+
+    /* With pread() available the archive's file stream should be shared rather than duplicated for each file. */
+    #if defined(FS_HAS_PREAD)
+    {
+        if (pTestState->pBackend == FS_BACKEND_POSIX && !pArchive->isStreamShareable) {
+            printf("%s: Expected the archive stream to support positional reads.\n", pTest->name);
+            errorCount += 1;
+        }
     }
+    #endif
 
-    /* Write additional content. */
-    result = fs_file_write(pFile, appendContent, strlen(appendContent), &bytesWritten);
-    if (result != FS_SUCCESS || bytesWritten != strlen(appendContent)) {
-        printf("%s: Failed to write in append mode.\n", pTest->name);
-        fs_file_close(pFile);
-        return FS_ERROR;
+    for (iFile = 0; iFile < FS_COUNTOF(pFiles); iFile += 1) {
+        if (pArchive->isStreamShareable && pFiles[iFile]->pStreamForBackend->pVTable != &fs_stream_shared_vtable) {
+            printf("%s: Expected %s to use a shared stream.\n", pTest->name, pPaths[iFile]);
+            errorCount += 1;
+        }
     }
 
-    fs_file_close(pFile);
+    /* Read in reverse order so each read happens somewhere other than where the previous one left off. */
+    for (iFile = FS_COUNTOF(pFiles); iFile > 0; iFile -= 1) {
+        char data[4];
+        size_t bytesRead;
 
-    /* Verify total size. */
-    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
-    if (result != FS_SUCCESS || (unsigned int)info.size != originalSize + strlen(appendContent)) {
-        printf("%s: Appended file has incorrect size (got=%u, expected=%u).\n", pTest->name, (unsigned int)info.size, (unsigned int)(originalSize + strlen(appendContent)));
-        return FS_ERROR;
+        result = fs_file_read(pFiles[iFile - 1], data, sizeof(data), &bytesRead);
+        if (result != FS_SUCCESS || bytesRead != 1 || data[0] != pExpected[iFile - 1]) {
+            printf("%s: Unexpected data when reading %s.\n", pTest->name, pPaths[iFile - 1]);
+            errorCount += 1;
+        }
     }
 
-    return FS_SUCCESS;
+    for (iFile = 0; iFile < FS_COUNTOF(pFiles); iFile += 1) {
+        fs_file_close(pFiles[iFile]);
+    }
+
+    /* Positional reads on a memory stream. These should not touch the cursor. */
+    {
+        const char pData[] = { 'a', 'b', 'c', 'd' };
+        fs_memory_stream stream;
+        fs_int64 cursor;
+        char data[4];
+        size_t bytesRead;
+
+        fs_memory_stream_init_readonly(pData, sizeof(pData), &stream);
+
+        result = fs_stream_read_at(&stream.base, 2, data, sizeof(data), &bytesRead);
+        if (result != FS_SUCCESS || bytesRead != 2 || data[0] != 'c' || data[1] != 'd') {
+            printf("%s: Unexpected result from a partial positional read.\n", pTest->name);
+            errorCount += 1;
+        }
+
+        result = fs_stream_read_at(&stream.base, 4, data, sizeof(data), &bytesRead);
+        if (result != FS_AT_END || bytesRead != 0) {
+            printf("%s: Expected FS_AT_END when reading at the end of the stream.\n", pTest->name);
+            errorCount += 1;
+        }
+
+        result = fs_stream_read_at(&stream.base, 1, data, 2, NULL);
+        if (result != FS_SUCCESS || data[0] != 'b' || data[1] != 'c') {
+            printf("%s: Unexpected result from an exact positional read.\n", pTest->name);
+            errorCount += 1;
+        }
+
+        fs_stream_tell(&stream.base, &cursor);
+        if (cursor != 0) {
+            printf("%s: Positional reads moved the cursor.\n", pTest->name);
+            errorCount += 1;
+        }
+    }
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_write_append */
+/* END archives_shared_stream */
 
-/* BEG mem_write_exclusive */
-int fs_test_mem_write_exclusive(fs_test* pTest)
+/* BEG archives_map */
+int fs_test_archives_map(fs_test* pTest)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
-    fs_file* pFile;
-    const char* content = "Exclusive content";
-    size_t bytesWritten;
+    const char* pPaths[]          = { "test1.zip/a", "test1.zip/dir1/d", "/test2.zip/archives/test1.zip/a" };
+    const char  pExpected[]       = { 'a', 'd', 'a' };
+    const fs_bool32 pEmulated[]   = { FS_FALSE, FS_FALSE, FS_TRUE };  /* The nested archive is compressed so it cannot be mapped directly. */
+    size_t iFile;
+    int errorCount = 0;
 
-    /* Try to create exclusive file that already exists - should fail. */
-    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_WRITE | FS_EXCLUSIVE | FS_IGNORE_MOUNTS, &pFile);
-    if (result == FS_SUCCESS) {
-        fs_file_close(pFile);
-        printf("%s: Exclusive open of existing file should have failed.\n", pTest->name);
-        return FS_ERROR;
-    }
+    for (iFile = 0; iFile < FS_COUNTOF(pPaths); iFile += 1) {
+        fs_file* pFile;
+        const void* pData;
+        size_t dataSize;
+
+        result = fs_file_open(pTestState->pFS, pPaths[iFile], FS_READ | FS_VERBOSE, &pFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open %s (%d).\n", pTest->name, pPaths[iFile], result);
+            errorCount += 1;
+            continue;
+        }
+
+        result = fs_file_map(pFile, &pData, &dataSize);
+        if (result != FS_SUCCESS || dataSize != 1 || ((const char*)pData)[0] != pExpected[iFile]) {
+            printf("%s: Unexpected data when mapping %s.\n", pTest->name, pPaths[iFile]);
+            errorCount += 1;
+        }
+
+        /* Stored files should come straight out of the mapped archive when the system backend supports mapping. */
+        #if !defined(FS_NO_MMAP)
+        {
+            if (result == FS_SUCCESS && pTestState->pBackend == FS_BACKEND_POSIX && pFile->isMappingEmulated != pEmulated[iFile]) {
+                printf("%s: Expected %s to be %s.\n", pTest->name, pPaths[iFile], pEmulated[iFile] ? "emulated" : "mapped directly");
+                errorCount += 1;
+            }
+        }
+        #else
+        {
+            (void)pEmulated;
+        }
+        #endif
 
-    /* Create new file with exclusive flag - should succeed. */
-    result = fs_file_open(pFS, "/testdir/exclusive_test.txt", FS_WRITE | FS_EXCLUSIVE | FS_IGNORE_MOUNTS, &pFile);
-    if (result != FS_SUCCESS) {
-        printf("%s: Exclusive creation of new file failed.\n", pTest->name);
-        return FS_ERROR;
-    }
-    result = fs_file_write(pFile, content, strlen(content), &bytesWritten);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to write to exclusive file.\n", pTest->name);
         fs_file_close(pFile);
-        return FS_ERROR;
     }
 
-    fs_file_close(pFile);
-
-    return FS_SUCCESS;
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_write_exclusive */
+/* END archives_map */
 
-/* BEG mem_write_truncate */
-int fs_test_mem_write_truncate(fs_test* pTest)
+/* BEG archives_index_file */
+fs_result fs_test_archives_open_with_config(fs_test* pTest, const fs_zip_config* pZipConfig)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
-    fs_file* pFile;
-    fs_int64 cursor;
-    const char* newContent = "Truncated and rewritten";
-    size_t bytesWritten;
-    fs_file_info info;
+    fs_file* pArchiveFile;
+    fs_config archiveConfig;
+    fs* pArchive;
+    const char* pPaths[] = { "a", "b", "dir1", "dir1/a", "dir1/b", "dir1/c", "dir1/d" };
+    const char* pMissingPaths[] = { "c", "dir", "dir1/e", "dir1/a/a", "dir1a" };
+    const char* pRootNames[] = { "a", "b", "dir1" };
+    size_t iPath;
+    fs_iterator* pIterator;
+    int errorCount = 0;
 
-    /* Open existing file with truncate flag. */
-    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, &pFile);
+    result = fs_file_open(pTestState->pFS, "test1.zip", FS_READ | FS_OPAQUE, &pArchiveFile);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to open file with truncate flag.\n", pTest->name);
+        printf("%s: Failed to open test1.zip.\n", pTest->name);
         return FS_ERROR;
     }
 
-    /* File should be empty now. */
-    result = fs_file_tell(pFile, &cursor);
-    if (result != FS_SUCCESS || cursor != 0) {
-        printf("%s: File cursor should be at 0 after truncate.\n", pTest->name);
-        fs_file_close(pFile);
+    archiveConfig = fs_config_init(FS_ZIP, pZipConfig, fs_file_get_stream(pArchiveFile));
+
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the archive (%d).\n", pTest->name, result);
+        fs_file_close(pArchiveFile);
         return FS_ERROR;
     }
 
-    /* Write new content. */
-    result = fs_file_write(pFile, newContent, strlen(newContent), &bytesWritten);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to write after truncate.\n", pTest->name);
-        fs_file_close(pFile);
-        return FS_ERROR;
+    /* The archive should not be mapped until a stored file is mapped. */
+    if (pArchiveFile->pMappedData != NULL) {
+        printf("%s: The archive was mapped when it was initialized.\n", pTest->name);
+        errorCount += 1;
     }
 
-    fs_file_close(pFile);
+    for (iPath = 0; iPath < FS_COUNTOF(pPaths); iPath += 1) {
+        fs_file_info info;
 
-    /* Verify final size. */
-    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
-    if (result != FS_SUCCESS || info.size != strlen(newContent)) {
-        printf("%s: Truncated file has incorrect size.\n", pTest->name);
-        return FS_ERROR;
+        result = fs_info(pArchive, pPaths[iPath], FS_READ, &info);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to find %s.\n", pTest->name, pPaths[iPath]);
+            errorCount += 1;
+        }
     }
 
-    return FS_SUCCESS;
+    for (iPath = 0; iPath < FS_COUNTOF(pMissingPaths); iPath += 1) {
+        fs_file_info info;
+
+        result = fs_info(pArchive, pMissingPaths[iPath], FS_READ, &info);
+        if (result != FS_DOES_NOT_EXIST) {
+            printf("%s: Expected FS_DOES_NOT_EXIST for %s.\n", pTest->name, pMissingPaths[iPath]);
+            errorCount += 1;
+        }
+    }
+
+    iPath = 0;
+    for (pIterator = fs_first(pArchive, "", FS_READ); pIterator != NULL; pIterator = fs_next(pIterator)) {
+        if (iPath >= FS_COUNTOF(pRootNames) || strcmp(pIterator->pName, pRootNames[iPath]) != 0) {
+            printf("%s: Unexpected item %s when iterating the archive.\n", pTest->name, pIterator->pName);
+            errorCount += 1;
+        }
+
+        iPath += 1;
+    }
+
+    if (iPath != FS_COUNTOF(pRootNames)) {
+        printf("%s: Unexpected number of items when iterating the archive.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    iPath = 0;
+    for (pIterator = fs_first(pArchive, "dir1", FS_READ); pIterator != NULL; pIterator = fs_next(pIterator)) {
+        iPath += 1;
+    }
+
+    if (iPath != 4) {
+        printf("%s: Unexpected number of items when iterating dir1.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_uninit(pArchive);
+    fs_file_close(pArchiveFile);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_write_truncate */
 
-/* BEG mem_write_seek */
-int fs_test_mem_write_seek(fs_test* pTest)
+fs_result fs_test_archives_index_file_reserved(fs_test* pTest, fs_uint32* pReserved, fs_uint32 newReserved)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
-    fs_file* pFile;
-    size_t bytesWritten;
+    fs_file* pIndexFile;
+    fs_uint8 reserved[4];
 
-    /* Create a file for seek testing. */
-    result = fs_test_open_and_write_file(pTest, pFS, "/testdir/seek_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, "0123456789", 10);
+    /* The header has a reserved field at offset 44 which is not used for validation. We use it to tell whether or not the file has been rewritten. */
+    result = fs_file_open(pTestState->pFS, "test1.zip.fsidx", FS_READ | FS_WRITE, &pIndexFile);
     if (result != FS_SUCCESS) {
+        printf("%s: Failed to open the index file.\n", pTest->name);
         return FS_ERROR;
     }
 
-    /* Open for read/write and test seeking. */
-    result = fs_file_open(pFS, "/testdir/seek_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    fs_file_seek(pIndexFile, 44, FS_SEEK_SET);
+    result = fs_file_read(pIndexFile, reserved, sizeof(reserved), NULL);
+    if (result == FS_SUCCESS) {
+        *pReserved = (fs_uint32)reserved[0] | ((fs_uint32)reserved[1] << 8) | ((fs_uint32)reserved[2] << 16) | ((fs_uint32)reserved[3] << 24);
+
+        reserved[0] = (fs_uint8)((newReserved >>  0) & 0xFF);
+        reserved[1] = (fs_uint8)((newReserved >>  8) & 0xFF);
+        reserved[2] = (fs_uint8)((newReserved >> 16) & 0xFF);
+        reserved[3] = (fs_uint8)((newReserved >> 24) & 0xFF);
+
+        fs_file_seek(pIndexFile, 44, FS_SEEK_SET);
+        result = fs_file_write(pIndexFile, reserved, sizeof(reserved), NULL);
+    }
+
+    fs_file_close(pIndexFile);
+
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to open file for seek test.\n", pTest->name);
+        printf("%s: Failed to access the reserved field of the index file.\n", pTest->name);
         return FS_ERROR;
     }
 
-    /* Seek to position 5 and write. */
-    result = fs_file_seek(pFile, 5, FS_SEEK_SET);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to seek to position 5.\n", pTest->name);
-        fs_file_close(pFile);
+    return FS_SUCCESS;
+}
+
+int fs_test_archives_index_file(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_zip_config zipConfig;
+    fs_file_info info;
+    fs_uint64 indexFileSize;
+    fs_uint32 reserved;
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.pIndexFS            = pTestState->pFS;
+    zipConfig.pIndexFilePath      = "test1.zip.fsidx";
+    zipConfig.archiveModifiedTime = 1234;
+
+    /* The first open will build the index and write out the index file. */
+    if (fs_test_archives_open_with_config(pTest, &zipConfig) != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    result = fs_file_write(pFile, "ABC", 3, &bytesWritten);
-    if (result != FS_SUCCESS || bytesWritten != 3) {
-        printf("%s: Failed to write at seek position.\n", pTest->name);
-        fs_file_close(pFile);
+    if (fs_info(pTestState->pFS, "test1.zip.fsidx", FS_READ, &info) != FS_SUCCESS || info.size == 0) {
+        printf("%s: The index file was not written.\n", pTest->name);
         return FS_ERROR;
     }
 
-    fs_file_close(pFile);
+    indexFileSize = info.size;
 
-    /* Verify the result by reading back. */
-    result = fs_test_open_and_read_file(pTest, pFS, "/testdir/seek_test.txt", FS_READ | FS_IGNORE_MOUNTS, "01234ABC89", 10);
-    if (result != FS_SUCCESS) {
+    /* The second open should load the index file without rewriting it. */
+    if (fs_test_archives_index_file_reserved(pTest, &reserved, 0xFFFFFFFF) != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    /* Test invalid seek (negative position). */
-    result = fs_file_open(pFS, "/testdir/seek_test.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to open file for seek test.\n", pTest->name);
+    if (fs_test_archives_open_with_config(pTest, &zipConfig) != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    result = fs_file_seek(pFile, -10, FS_SEEK_SET);
-    if (result == FS_SUCCESS) {
-        printf("%s: Seeking to negative position should have failed.\n", pTest->name);
-        fs_file_close(pFile);
+    if (fs_test_archives_index_file_reserved(pTest, &reserved, 0xFFFFFFFF) != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    fs_file_close(pFile);
+    if (reserved != 0xFFFFFFFF) {
+        printf("%s: The index file was rewritten when it should have been loaded.\n", pTest->name);
+        return FS_ERROR;
+    }
 
-    /* Test edge case: Seek beyond file end and write (sparse file behavior). */
-    result = fs_file_open(pFS, "/testdir/sparse_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to create file for sparse test.\n", pTest->name);
+    /* A different modified time means the archive has changed so the index file should be rewritten. */
+    zipConfig.archiveModifiedTime = 5678;
+
+    if (fs_test_archives_open_with_config(pTest, &zipConfig) != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    /* Seek to position 100 (beyond end of empty file). */
-    result = fs_file_seek(pFile, 100, FS_SEEK_SET);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to seek beyond file end.\n", pTest->name);
-        fs_file_close(pFile);
+    if (fs_test_archives_index_file_reserved(pTest, &reserved, 0) != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    /* Write at position 100 - should create a sparse-like effect. */
-    result = fs_file_write(pFile, "test", 4, &bytesWritten);
-    if (result != FS_SUCCESS || bytesWritten != 4) {
-        printf("%s: Failed to write at seek position 100.\n", pTest->name);
-        fs_file_close(pFile);
+    if (reserved != 0) {
+        printf("%s: The index file was not rewritten after the archive changed.\n", pTest->name);
         return FS_ERROR;
     }
-    fs_file_close(pFile);
 
-    /* Verify file size is now 104. */
+    /* A truncated index file should be rejected and rebuilt. */
     {
-        fs_file_info info;
-        result = fs_info(pFS, "/testdir/sparse_test.txt", FS_IGNORE_MOUNTS, &info);
-        if (result != FS_SUCCESS || info.size != 104) {
-            printf("%s: File size should be 104 after sparse write, got %u.\n", pTest->name, (unsigned int)info.size);
+        fs_file* pIndexFile;
+
+        if (fs_file_open(pTestState->pFS, "test1.zip.fsidx", FS_READ | FS_WRITE, &pIndexFile) != FS_SUCCESS) {
+            printf("%s: Failed to open the index file for truncation.\n", pTest->name);
             return FS_ERROR;
         }
+
+        fs_file_seek(pIndexFile, (fs_int64)indexFileSize - 1, FS_SEEK_SET);
+        fs_file_truncate(pIndexFile);
+        fs_file_close(pIndexFile);
     }
 
-    return FS_SUCCESS;
-}
-/* END mem_write_seek */
+    if (fs_test_archives_open_with_config(pTest, &zipConfig) != FS_SUCCESS) {
+        return FS_ERROR;
+    }
 
-/* BEG mem_write_truncate2 */
-int fs_test_mem_write_truncate2(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
-    fs_result result;
-    fs_file* pFile;
-    fs_file_info info;
+    if (fs_info(pTestState->pFS, "test1.zip.fsidx", FS_READ, &info) != FS_SUCCESS || info.size != indexFileSize) {
+        printf("%s: The truncated index file was not rebuilt.\n", pTest->name);
+        return FS_ERROR;
+    }
 
-    /* Open the seek test file and truncate it using fs_file_truncate(). */
-    result = fs_file_open(pFS, "/testdir/seek_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to open file for truncate test.\n", pTest->name);
+    /*
+    An index file that points a directory node at a file that doesn't exist must be rejected. This is
+    done by setting the file index of the first node with children, other than the root, to something
+    out of range. The header is 64 bytes, followed by 4 bytes per file and then 20 bytes per node.
+    */
+    {
+        fs_file* pIndexFile;
+        fs_uint8* pIndexData;
+        size_t indexDataSize;
+        size_t fileCount;
+        size_t nodeCount;
+        size_t iNode;
+        fs_bool32 isCorrupted = FS_FALSE;
+
+        if (fs_file_open_and_read(pTestState->pFS, "test1.zip.fsidx", FS_FORMAT_BINARY, (void**)&pIndexData, &indexDataSize) != FS_SUCCESS) {
+            printf("%s: Failed to read the index file for corruption.\n", pTest->name);
+            return FS_ERROR;
+        }
+
+        fileCount = (size_t)pIndexData[48] | ((size_t)pIndexData[49] << 8);
+        nodeCount = (size_t)pIndexData[56] | ((size_t)pIndexData[57] << 8);
+
+        for (iNode = 1; iNode < nodeCount; iNode += 1) {
+            fs_uint8* pNode = pIndexData + 64 + (fileCount * 4) + (iNode * 20);
+
+            if (pNode[12] != 0) {
+                pNode[0] = 0xFF;
+                pNode[1] = 0xFF;
+                pNode[2] = 0xFF;
+                pNode[3] = 0xFF;
+                isCorrupted = FS_TRUE;
+                break;
+            }
+        }
+
+        /* Tag the reserved field so we can tell whether or not the index file was rewritten. */
+        pIndexData[44] = 0xFF;
+        pIndexData[45] = 0xFF;
+        pIndexData[46] = 0xFF;
+        pIndexData[47] = 0xFF;
+
+        if (fs_file_open(pTestState->pFS, "test1.zip.fsidx", FS_WRITE | FS_TRUNCATE, &pIndexFile) == FS_SUCCESS) {
+            fs_file_write(pIndexFile, pIndexData, indexDataSize, NULL);
+            fs_file_close(pIndexFile);
+        } else {
+            isCorrupted = FS_FALSE;
+        }
+
+        fs_free(pIndexData, NULL);
+
+        if (!isCorrupted) {
+            printf("%s: Failed to corrupt the index file.\n", pTest->name);
+            return FS_ERROR;
+        }
+    }
+
+    if (fs_test_archives_open_with_config(pTest, &zipConfig) != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    /* Seek to position 5 and truncate there. */
-    result = fs_file_seek(pFile, 5, FS_SEEK_SET);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to seek for truncate test.\n", pTest->name);
-        fs_file_close(pFile);
+    if (fs_test_archives_index_file_reserved(pTest, &reserved, 0) != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    result = fs_file_truncate(pFile);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to truncate file.\n", pTest->name);
-        fs_file_close(pFile);
+    if (reserved != 0) {
+        printf("%s: The corrupted index file was not rejected and rebuilt.\n", pTest->name);
         return FS_ERROR;
     }
 
-    fs_file_close(pFile);
+    return FS_SUCCESS;
+}
+/* END archives_index_file */
 
-    /* Verify truncated size. */
-    result = fs_info(pFS, "/testdir/seek_test.txt", FS_IGNORE_MOUNTS, &info);
-    if (result != FS_SUCCESS || info.size != 5) {
-        printf("%s: Truncated file has incorrect size (got=%u, expected=5).\n", pTest->name, (unsigned int)info.size);
+/* BEG archives_path_hash_table */
+int fs_test_archives_path_hash_table(fs_test* pTest)
+{
+    fs_zip_config zipConfig;
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.usePathHashTable = FS_TRUE;
+
+    return fs_test_archives_open_with_config(pTest, &zipConfig);
+}
+/* END archives_path_hash_table */
+
+/* BEG archives_seek_points */
+static fs_uint8 fs_test_archives_seek_points_expected_byte(size_t i)
+{
+    /* This is how the data in test3.zip was generated. */
+    return (fs_uint8)(((i % 251) ^ ((i >> 15) & 0xFF)) & 0xFF);
+}
+
+fs_result fs_test_archives_seek_points_check(fs_test* pTest, fs_file* pFile, fs_int64 offset, fs_seek_origin origin, size_t expectedCursor)
+{
+    fs_result result;
+    fs_uint8 data[256];
+    size_t bytesRead;
+    size_t i;
+
+    result = fs_file_seek(pFile, offset, origin);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to seek to %d.\n", pTest->name, (int)expectedCursor);
         return FS_ERROR;
     }
 
+    result = fs_file_read(pFile, data, sizeof(data), &bytesRead);
+    if (result != FS_SUCCESS || bytesRead != sizeof(data)) {
+        printf("%s: Failed to read after seeking to %d.\n", pTest->name, (int)expectedCursor);
+        return FS_ERROR;
+    }
+
+    for (i = 0; i < bytesRead; i += 1) {
+        if (data[i] != fs_test_archives_seek_points_expected_byte(expectedCursor + i)) {
+            printf("%s: Incorrect data after seeking to %d.\n", pTest->name, (int)expectedCursor);
+            return FS_ERROR;
+        }
+    }
+
     return FS_SUCCESS;
 }
-/* END mem_write_truncate2 */
 
-/* BEG mem_write_flush */
-int fs_test_mem_write_flush(fs_test* pTest)
+fs_result fs_test_archives_seek_points_run(fs_test* pTest, fs* pArchive)
 {
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
     fs_file* pFile;
-    size_t bytesWritten;
+    fs_file* pDuplicate;
+    fs_uint8 data[4096];
+    size_t totalBytesRead = 0;
+    size_t i;
+    int errorCount = 0;
 
-    /* For memory backend, flush is essentially a no-op, but we should test it doesn't fail. */
-    result = fs_file_open(pFS, "/testdir/flush_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    result = fs_file_open(pArchive, "data.bin", FS_READ, &pFile);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to open file for flush test.\n", pTest->name);
+        printf("%s: Failed to open data.bin.\n", pTest->name);
         return FS_ERROR;
     }
 
-    result = fs_file_write(pFile, "test", 4, &bytesWritten);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to write for flush test.\n", pTest->name);
-        fs_file_close(pFile);
-        return FS_ERROR;
+    /* Jump forward beyond the uncompressed cache before anything else has been read. */
+    if (fs_test_archives_seek_points_check(pTest, pFile, 100000, FS_SEEK_SET, 100000) != FS_SUCCESS) {
+        errorCount += 1;
     }
 
-    result = fs_file_flush(pFile);
+    /* Read the whole file which is where the seek points will be recorded. */
+    fs_file_seek(pFile, 0, FS_SEEK_SET);
+    for (;;) {
+        size_t bytesRead;
+
+        result = fs_file_read(pFile, data, sizeof(data), &bytesRead);
+        if (result != FS_SUCCESS) {
+            break;
+        }
+
+        for (i = 0; i < bytesRead; i += 1) {
+            if (data[i] != fs_test_archives_seek_points_expected_byte(totalBytesRead + i)) {
+                printf("%s: Incorrect data at %d.\n", pTest->name, (int)(totalBytesRead + i));
+                errorCount += 1;
+                break;
+            }
+        }
+
+        totalBytesRead += bytesRead;
+    }
+
+    if (totalBytesRead != 262144) {
+        printf("%s: Unexpected file size %d.\n", pTest->name, (int)totalBytesRead);
+        errorCount += 1;
+    }
+
+    /* Now seek around the file, both backwards and forwards. */
+    if (fs_test_archives_seek_points_check(pTest, pFile, 70000,  FS_SEEK_SET, 70000)  != FS_SUCCESS) { errorCount += 1; }
+    if (fs_test_archives_seek_points_check(pTest, pFile, 10,     FS_SEEK_SET, 10)     != FS_SUCCESS) { errorCount += 1; }
+    if (fs_test_archives_seek_points_check(pTest, pFile, 200000, FS_SEEK_SET, 200000) != FS_SUCCESS) { errorCount += 1; }
+    if (fs_test_archives_seek_points_check(pTest, pFile, 65536,  FS_SEEK_SET, 65536)  != FS_SUCCESS) { errorCount += 1; }
+    if (fs_test_archives_seek_points_check(pTest, pFile, 131072, FS_SEEK_SET, 131072) != FS_SUCCESS) { errorCount += 1; }
+    if (fs_test_archives_seek_points_check(pTest, pFile, -256,   FS_SEEK_END, 261888) != FS_SUCCESS) { errorCount += 1; }
+    if (fs_test_archives_seek_points_check(pTest, pFile, 131071, FS_SEEK_SET, 131071) != FS_SUCCESS) { errorCount += 1; }
+
+    /* A duplicated file should be able to seek independently. */
+    result = fs_file_duplicate(pFile, &pDuplicate);
+    if (result == FS_SUCCESS) {
+        if (fs_test_archives_seek_points_check(pTest, pDuplicate, 150000, FS_SEEK_SET, 150000) != FS_SUCCESS) { errorCount += 1; }
+        if (fs_test_archives_seek_points_check(pTest, pDuplicate, 1000,   FS_SEEK_SET, 1000)   != FS_SUCCESS) { errorCount += 1; }
+        fs_file_close(pDuplicate);
+    } else {
+        printf("%s: Failed to duplicate data.bin.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_file_close(pFile);
+
+    /* When the file is reopened the seek points from earlier should be used straight away. */
+    result = fs_file_open(pArchive, "data.bin", FS_READ, &pFile);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to flush file.\n", pTest->name);
-        fs_file_close(pFile);
+        printf("%s: Failed to reopen data.bin.\n", pTest->name);
         return FS_ERROR;
     }
 
+    if (fs_test_archives_seek_points_check(pTest, pFile, 250000, FS_SEEK_SET, 250000) != FS_SUCCESS) { errorCount += 1; }
+    if (fs_test_archives_seek_points_check(pTest, pFile, 66000,  FS_SEEK_SET, 66000)  != FS_SUCCESS) { errorCount += 1; }
+    if (fs_test_archives_seek_points_check(pTest, pFile, 0,      FS_SEEK_SET, 0)      != FS_SUCCESS) { errorCount += 1; }
+
     fs_file_close(pFile);
 
-    return FS_SUCCESS;
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_write_flush */
 
-/* BEG mem_read */
-int fs_test_mem_read(fs_test* pTest)
+int fs_test_archives_seek_points(fs_test* pTest)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
+    fs_file* pArchiveFile;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    size_t iInterval;
+    size_t pIntervals[] = { 0, 65536, 1 };
+    int errorCount = 0;
 
-    /* Read back the truncated content from the seek test. */
-    result = fs_test_open_and_read_file(pTest, pFS, "/testdir/seek_test.txt", FS_READ | FS_IGNORE_MOUNTS, "01234", 5);
+    result = fs_test_open_and_write_file(pTest, pTestState->pFS, "test3.zip", FS_WRITE, fs_test_file_test3_zip, sizeof(fs_test_file_test3_zip));
     if (result != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    /* Test reading the overwrite test file. */
-    result = fs_test_open_and_read_file(pTest, pFS, "/testdir/overwrite_test.txt", FS_READ | FS_IGNORE_MOUNTS, "Overwritten content!", 20);
+    result = fs_file_open(pTestState->pFS, "test3.zip", FS_READ | FS_OPAQUE, &pArchiveFile);
     if (result != FS_SUCCESS) {
+        printf("%s: Failed to open test3.zip.\n", pTest->name);
         return FS_ERROR;
     }
 
-    /* Test reading the exclusive test file. */
-    result = fs_test_open_and_read_file(pTest, pFS, "/testdir/exclusive_test.txt", FS_READ | FS_IGNORE_MOUNTS, "Exclusive content", 17);
-    if (result != FS_SUCCESS) {
-        return FS_ERROR;
-    }
+    /* An interval of 0 disables seek points which is the baseline the other intervals should match. */
+    for (iInterval = 0; iInterval < FS_COUNTOF(pIntervals); iInterval += 1) {
+        zipConfig = fs_zip_config_init();
+        zipConfig.seekPointInterval = pIntervals[iInterval];
 
-    /* Test error condition: Try to open directory as file - should fail. */
-    {
-        fs_file* pFile;
-        result = fs_file_open(pFS, "/testdir", FS_READ | FS_IGNORE_MOUNTS, &pFile);
-        if (result == FS_SUCCESS) {
-            fs_file_close(pFile);
-            printf("%s: Opening directory as file should have failed.\n", pTest->name);
-            return FS_ERROR;
-        }
-    }
+        archiveConfig = fs_config_init(FS_ZIP, &zipConfig, fs_file_get_stream(pArchiveFile));
 
-    /* Test edge case: Zero-byte file operations. */
-    {
-        fs_file* pFile;
-        fs_file_info info;
-        char buffer[10];
-        size_t bytesRead;
-        
-        /* Create empty file. */
-        result = fs_file_open(pFS, "/testdir/empty.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        result = fs_init(&archiveConfig, &pArchive);
         if (result != FS_SUCCESS) {
-            printf("%s: Failed to create empty file.\n", pTest->name);
-            return FS_ERROR;
-        }
-        fs_file_close(pFile);
-
-        /* Verify empty file has size 0. */
-        result = fs_info(pFS, "/testdir/empty.txt", FS_IGNORE_MOUNTS, &info);
-        if (result != FS_SUCCESS || info.size != 0) {
-            printf("%s: Empty file should have size 0, got %u.\n", pTest->name, (unsigned int)info.size);
-            return FS_ERROR;
+            printf("%s: Failed to initialize the archive (%d).\n", pTest->name, result);
+            errorCount += 1;
+            continue;
         }
 
-        /* Read from empty file. */
-        result = fs_file_open(pFS, "/testdir/empty.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
-        if (result != FS_SUCCESS) {
-            printf("%s: Failed to open empty file for reading.\n", pTest->name);
-            return FS_ERROR;
+        if (fs_test_archives_seek_points_run(pTest, pArchive) != FS_SUCCESS) {
+            printf("%s: Failed with a seek point interval of %d.\n", pTest->name, (int)pIntervals[iInterval]);
+            errorCount += 1;
         }
 
-        result = fs_file_read(pFile, buffer, sizeof(buffer), &bytesRead);
-        if (result != FS_AT_END || bytesRead != 0) {
-            printf("%s: Reading from empty file should return FS_AT_END with 0 bytes.\n", pTest->name);
-            fs_file_close(pFile);
-            return FS_ERROR;
-        }
-        fs_file_close(pFile);
+        fs_uninit(pArchive);
     }
 
-    return FS_SUCCESS;
+    fs_file_close(pArchiveFile);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_read */
+/* END archives_seek_points */
 
-/* BEG mem_read_readonly */
-int fs_test_mem_read_readonly(fs_test* pTest)
+/* BEG archives_large_reads */
+int fs_test_archives_large_reads(fs_test* pTest)
 {
     fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
+    fs_file* pArchiveFile;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
     fs_file* pFile;
-    size_t bytesWritten;
+    fs_uint8* pData;
+    size_t dataSize = 262144;
+    size_t bytesRead;
+    size_t i;
+    size_t iRead;
+    int errorCount = 0;
 
-    /* Open file in read-only mode. */
-    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    /*
+    Reads that are big enough are decompressed straight into the output buffer. Each pair is an
+    offset and a size, and they're done in order so some of them will carry on from the previous one.
+    */
+    size_t reads[][2] =
+    {
+        { 0,      262144 },
+        { 1000,   200000 },
+        { 201000, 61144  },
+        { 70000,  4096   },
+        { 74096,  150000 },
+        { 224096, 38048  }
+    };
+
+    result = fs_test_open_and_write_file(pTest, pTestState->pFS, "test3.zip", FS_WRITE | FS_TRUNCATE, fs_test_file_test3_zip, sizeof(fs_test_file_test3_zip));
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to open file in read-only mode.\n", pTest->name);
         return FS_ERROR;
     }
 
-    /* Try to write - should fail. */
-    result = fs_file_write(pFile, "test", 4, &bytesWritten);
-    if (result == FS_SUCCESS) {
-        printf("%s: Writing to read-only file should have failed.\n", pTest->name);
-        fs_file_close(pFile);
+    result = fs_file_open(pTestState->pFS, "test3.zip", FS_READ | FS_OPAQUE, &pArchiveFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open test3.zip.\n", pTest->name);
         return FS_ERROR;
     }
 
-    fs_file_close(pFile);
-
-    return FS_SUCCESS;
-}
-/* END mem_read_readonly */
+    /* Checksums are verified to make sure the data going through the direct path is correct. */
+    zipConfig = fs_zip_config_init();
+    zipConfig.verifyChecksums = FS_TRUE;
 
-/* BEG mem_read_noexist */
-int fs_test_mem_read_noexist(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
-    fs_result result;
-    fs_file* pFile;
+    archiveConfig = fs_config_init(FS_ZIP, &zipConfig, fs_file_get_stream(pArchiveFile));
 
-    /* Try to open non-existent file. */
-    result = fs_file_open(pFS, "/testdir/nonexistent.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
-    if (result == FS_SUCCESS) {
-        fs_file_close(pFile);
-        printf("%s: Opening non-existent file should have failed.\n", pTest->name);
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the archive (%d).\n", pTest->name, result);
+        fs_file_close(pArchiveFile);
         return FS_ERROR;
     }
 
-    /* Check that the error is the expected one. */
-    if (result != FS_DOES_NOT_EXIST) {
-        printf("%s: Expected FS_DOES_NOT_EXIST but got %d.\n", pTest->name, result);
+    pData = (fs_uint8*)fs_malloc(dataSize, NULL);
+    if (pData == NULL) {
+        fs_uninit(pArchive);
+        fs_file_close(pArchiveFile);
         return FS_ERROR;
     }
 
-    return FS_SUCCESS;
-}
-/* END mem_read_noexist */
+    result = fs_file_open(pArchive, "data.bin", FS_READ, &pFile);
+    if (result == FS_SUCCESS) {
+        for (iRead = 0; iRead < FS_COUNTOF(reads); iRead += 1) {
+            size_t offset = reads[iRead][0];
+            size_t size   = reads[iRead][1];
 
-/* BEG mem_duplicate */
-int fs_test_mem_duplicate(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
-    fs_result result;
-    fs_file* pFile;
-    fs_file* pDuplicate;
-    char buffer1[32], buffer2[32];
-    size_t bytesRead1, bytesRead2;
+            result = fs_file_seek(pFile, (fs_int64)offset, FS_SEEK_SET);
+            if (result == FS_SUCCESS) {
+                result = fs_file_read(pFile, pData, size, &bytesRead);
+            }
 
-    /* Open a file. */
-    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to open file for duplication test.\n", pTest->name);
-        return FS_ERROR;
-    }
+            if (result != FS_SUCCESS || bytesRead != size) {
+                printf("%s: Failed to read %d bytes from %d (%d).\n", pTest->name, (int)size, (int)offset, result);
+                errorCount += 1;
+                continue;
+            }
 
-    /* Duplicate the file handle. */
-    result = fs_file_duplicate(pFile, &pDuplicate);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to duplicate file handle.\n", pTest->name);
-        fs_file_close(pFile);
-        return FS_ERROR;
-    }
+            for (i = 0; i < size; i += 1) {
+                if (pData[i] != fs_test_archives_seek_points_expected_byte(offset + i)) {
+                    printf("%s: Incorrect data at %d.\n", pTest->name, (int)(offset + i));
+                    errorCount += 1;
+                    break;
+                }
+            }
+        }
 
-    /* Read from both handles. */
-    
-    result = fs_file_read(pFile, buffer1, sizeof(buffer1), &bytesRead1);
-    if (result != FS_SUCCESS && result != FS_AT_END) {
-        printf("%s: Failed to read from original file handle.\n", pTest->name);
         fs_file_close(pFile);
-        fs_file_close(pDuplicate);
-        return FS_ERROR;
+    } else {
+        printf("%s: Failed to open data.bin.\n", pTest->name);
+        errorCount += 1;
     }
 
-    /* Reset cursor on duplicate and read. */
-    result = fs_file_seek(pDuplicate, 0, FS_SEEK_SET);
+    fs_free(pData, NULL);
+    fs_uninit(pArchive);
+    fs_file_close(pArchiveFile);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END archives_large_reads */
+
+/* BEG archives_checksums */
+fs_result fs_test_archives_checksums_read(fs_test* pTest, fs* pArchive, const char* pPath, fs_bool32 skipAhead)
+{
+    fs_result result;
+    fs_file* pFile;
+    fs_uint8 data[4096];
+    size_t bytesRead;
+
+    result = fs_file_open(pArchive, pPath, FS_READ, &pFile);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to seek duplicate handle.\n", pTest->name);
-        fs_file_close(pFile);
-        fs_file_close(pDuplicate);
-        return FS_ERROR;
+        printf("%s: Failed to open %s.\n", pTest->name, pPath);
+        return result;
     }
 
-    result = fs_file_read(pDuplicate, buffer2, sizeof(buffer2), &bytesRead2);
-    if (result != FS_SUCCESS && result != FS_AT_END) {
-        printf("%s: Failed to read from duplicate file handle.\n", pTest->name);
-        fs_file_close(pFile);
-        fs_file_close(pDuplicate);
-        return FS_ERROR;
+    if (skipAhead) {
+        fs_file_seek(pFile, 1000, FS_SEEK_SET);
     }
 
-    /* Compare the reads. */
-    if (bytesRead1 != bytesRead2 || memcmp(buffer1, buffer2, bytesRead1) != 0) {
-        printf("%s: Original and duplicate file handles returned different content.\n", pTest->name);
-        fs_file_close(pFile);
-        fs_file_close(pDuplicate);
-        return FS_ERROR;
-    }
+    do {
+        result = fs_file_read(pFile, data, sizeof(data), &bytesRead);
+    } while (result == FS_SUCCESS);
 
     fs_file_close(pFile);
-    fs_file_close(pDuplicate);
 
-    /* Test edge case: Multiple file handles to same file. */
+    return (result == FS_AT_END) ? FS_SUCCESS : result;
+}
+
+int fs_test_archives_checksums(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_result result;
+    fs_file* pArchiveFile;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    fs_uint8* pCorruptData;
+    size_t i;
+    size_t iRun;
+    int errorCount = 0;
+
+    /* Each run reads a file with and without a corrupted CRC in the central directory. test1.zip is STORE and test3.zip is DEFLATE. */
+    struct
     {
-        fs_file* pFile1;
-        fs_file* pFile2;
-        char readBuffer[10];
-        size_t bytesRead;
-        size_t bytesWritten;
-        
-        result = fs_file_open(pFS, "/testdir/multihandle.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile1);
+        const fs_uint8* pArchiveData;
+        size_t archiveDataSize;
+        const char* pFilePath;
+        fs_bool32 corrupt;
+        fs_bool32 verifyChecksums;
+        fs_bool32 skipAhead;
+        fs_result expectedResult;
+    } runs[] =
+    {
+        { fs_test_file_test1_zip, sizeof(fs_test_file_test1_zip), "dir1/c",   FS_FALSE, FS_TRUE,  FS_FALSE, FS_SUCCESS           },
+        { fs_test_file_test1_zip, sizeof(fs_test_file_test1_zip), "dir1/c",   FS_TRUE,  FS_TRUE,  FS_FALSE, FS_CHECKSUM_MISMATCH },
+        { fs_test_file_test1_zip, sizeof(fs_test_file_test1_zip), "dir1/c",   FS_TRUE,  FS_FALSE, FS_FALSE, FS_SUCCESS           },
+        { fs_test_file_test3_zip, sizeof(fs_test_file_test3_zip), "data.bin", FS_FALSE, FS_TRUE,  FS_FALSE, FS_SUCCESS           },
+        { fs_test_file_test3_zip, sizeof(fs_test_file_test3_zip), "data.bin", FS_TRUE,  FS_TRUE,  FS_FALSE, FS_CHECKSUM_MISMATCH },
+        { fs_test_file_test3_zip, sizeof(fs_test_file_test3_zip), "data.bin", FS_TRUE,  FS_FALSE, FS_FALSE, FS_SUCCESS           },
+        { fs_test_file_test3_zip, sizeof(fs_test_file_test3_zip), "data.bin", FS_TRUE,  FS_TRUE,  FS_TRUE,  FS_CHECKSUM_MISMATCH }  /* Seeking forward still decompresses the data in between. */
+    };
+
+    for (iRun = 0; iRun < FS_COUNTOF(runs); iRun += 1) {
+        pCorruptData = NULL;
+
+        if (runs[iRun].corrupt) {
+            pCorruptData = (fs_uint8*)fs_malloc(runs[iRun].archiveDataSize, NULL);
+            if (pCorruptData == NULL) {
+                return FS_ERROR;
+            }
+
+            FS_COPY_MEMORY(pCorruptData, runs[iRun].pArchiveData, runs[iRun].archiveDataSize);
+
+            /* Flip a bit in the CRC of every central directory record. */
+            for (i = 0; i + 46 <= runs[iRun].archiveDataSize; i += 1) {
+                if (pCorruptData[i] == 0x50 && pCorruptData[i + 1] == 0x4B && pCorruptData[i + 2] == 0x01 && pCorruptData[i + 3] == 0x02) {
+                    pCorruptData[i + 16] ^= 0x01;
+                }
+            }
+        }
+
+        result = fs_test_open_and_write_file(pTest, pTestState->pFS, "checksums.zip", FS_WRITE | FS_TRUNCATE, (pCorruptData != NULL) ? pCorruptData : runs[iRun].pArchiveData, runs[iRun].archiveDataSize);
+        fs_free(pCorruptData, NULL);
+
         if (result != FS_SUCCESS) {
-            printf("%s: Failed to open file for multi-handle test.\n", pTest->name);
             return FS_ERROR;
         }
 
-        result = fs_file_open(pFS, "/testdir/multihandle.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile2);
+        result = fs_file_open(pTestState->pFS, "checksums.zip", FS_READ | FS_OPAQUE, &pArchiveFile);
         if (result != FS_SUCCESS) {
-            printf("%s: Failed to open second handle to same file.\n", pTest->name);
-            fs_file_close(pFile1);
+            printf("%s: Failed to open checksums.zip.\n", pTest->name);
             return FS_ERROR;
         }
 
-        /* Write with first handle. */
-        result = fs_file_write(pFile1, "handle1", 7, &bytesWritten);
+        zipConfig = fs_zip_config_init();
+        zipConfig.verifyChecksums = runs[iRun].verifyChecksums;
+
+        archiveConfig = fs_config_init(FS_ZIP, &zipConfig, fs_file_get_stream(pArchiveFile));
+
+        result = fs_init(&archiveConfig, &pArchive);
         if (result != FS_SUCCESS) {
-            printf("%s: Failed to write with first handle.\n", pTest->name);
-            fs_file_close(pFile1);
-            fs_file_close(pFile2);
-            return FS_ERROR;
+            printf("%s: Failed to initialize the archive (%d).\n", pTest->name, result);
+            fs_file_close(pArchiveFile);
+            errorCount += 1;
+            continue;
         }
 
-        /* Read with second handle should see the data. */
-        result = fs_file_read(pFile2, readBuffer, 7, &bytesRead);
-        if (result != FS_SUCCESS || bytesRead != 7 || memcmp(readBuffer, "handle1", 7) != 0) {
-            printf("%s: Second handle should see data written by first handle.\n", pTest->name);
-            fs_file_close(pFile1);
-            fs_file_close(pFile2);
-            return FS_ERROR;
+        result = fs_test_archives_checksums_read(pTest, pArchive, runs[iRun].pFilePath, runs[iRun].skipAhead);
+        if (result != runs[iRun].expectedResult) {
+            printf("%s: Run %d returned %d when %d was expected.\n", pTest->name, (int)iRun, result, runs[iRun].expectedResult);
+            errorCount += 1;
         }
 
-        fs_file_close(pFile1);
-        fs_file_close(pFile2);
+        fs_uninit(pArchive);
+        fs_file_close(pArchiveFile);
     }
 
-    return FS_SUCCESS;
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_duplicate */
+/* END archives_checksums */
 
-/* BEG mem_iteration */
-int fs_test_mem_iteration(fs_test* pTest)
+/* BEG archives_checksums_seek */
+static fs_result fs_test_archives_checksums_seek_read(fs_test* pTest, fs* pArchive, int mode)
 {
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
-    fs_iterator* pIterator;
-    int fileCount = 0;
-    int dirCount = 0;
-    int expectedFiles = 0;
-    fs_file_info info;
-    char fullPath[512];
-    const char* expectedFileNames[] = {
-        "/testdir/test_new.txt",
-        "/testdir/overwrite_test.txt", 
-        "/testdir/exclusive_test.txt",
-        "/testdir/seek_test.txt",
-        "/testdir/flush_test.txt"
-    };
-    int i;
-    
-    /* Count expected files by checking what exists */
-    for (i = 0; i < 5; i += 1) {
-        result = fs_info(pFS, expectedFileNames[i], FS_IGNORE_MOUNTS, &info);
-        if (result == FS_SUCCESS && !info.directory) {
-            expectedFiles += 1;
+    fs_file* pFile;
+    fs_uint8 data[4096];
+    size_t bytesRead;
+
+    result = fs_file_open(pArchive, "data.bin", FS_READ, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open data.bin.\n", pTest->name);
+        return result;
+    }
+
+    /*
+    Mode 0 reads the whole file. The other modes read a little bit and then seek forward, either within
+    the uncompressed cache, past the end of it, or to just before the end of the file.
+    */
+    if (mode != 0) {
+        result = fs_file_read(pFile, data, 100, &bytesRead);
+        if (result == FS_SUCCESS) {
+            if (mode == 1) {
+                result = fs_file_seek(pFile, 1000, FS_SEEK_CUR);
+            } else if (mode == 2) {
+                result = fs_file_seek(pFile, 150000, FS_SEEK_SET);
+            } else {
+                result = fs_file_seek(pFile, -10, FS_SEEK_END);
+            }
         }
     }
 
-    /* Iterate through /testdir. */
-    pIterator = fs_first(pFS, "/testdir", FS_IGNORE_MOUNTS);
-    if (pIterator == NULL) {
-        printf("%s: Failed to start directory iteration.\n", pTest->name);
+    while (result == FS_SUCCESS) {
+        result = fs_file_read(pFile, data, sizeof(data), &bytesRead);
+    }
+
+    fs_file_close(pFile);
+
+    return (result == FS_AT_END) ? FS_SUCCESS : result;
+}
+
+int fs_test_archives_checksums_seek(fs_test* pTest)
+{
+    fs_result result;
+    fs_memory_stream stream;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    fs_file* pFile;
+    fs_uint8* pData;
+    size_t dataSize = 200000;
+    void* pArchiveData;
+    size_t archiveDataSize;
+    size_t i;
+    int compressionLevels[] = { 0, 6 };
+    int iLevel;
+    int corrupt;
+    int mode;
+    int errorCount = 0;
+
+    pData = (fs_uint8*)fs_malloc(dataSize, NULL);
+    if (pData == NULL) {
         return FS_ERROR;
     }
 
-    while (pIterator != NULL) {
-        if (pIterator->info.directory) {
-            dirCount += 1;
-        } else {
-            fileCount += 1;
+    for (i = 0; i < dataSize; i += 1) {
+        pData[i] = fs_test_archives_seek_points_expected_byte(i);
+    }
+
+    /* Level 0 gives us a stored file, and anything else gives us a deflated one. */
+    for (iLevel = 0; iLevel < (int)FS_COUNTOF(compressionLevels); iLevel += 1) {
+        if (fs_memory_stream_init_write(NULL, &stream) != FS_SUCCESS) {
+            errorCount += 1;
+            break;
         }
-        
-        /* Verify we can get info for each item. */
-        fs_snprintf(fullPath, sizeof(fullPath), "/testdir/%s", pIterator->pName);
-        
-        result = fs_info(pFS, fullPath, FS_IGNORE_MOUNTS, &info);
+
+        zipConfig = fs_zip_config_init();
+        zipConfig.write            = FS_TRUE;
+        zipConfig.compressionLevel = compressionLevels[iLevel];
+
+        archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+        result = fs_init(&archiveConfig, &pArchive);
+        if (result == FS_SUCCESS) {
+            result = fs_file_open(pArchive, "data.bin", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+            if (result == FS_SUCCESS) {
+                result = fs_file_write(pFile, pData, dataSize, NULL);
+                fs_file_close(pFile);
+            }
+
+            fs_uninit(pArchive);
+        }
+
+        pArchiveData = fs_memory_stream_take_ownership(&stream, &archiveDataSize);
+        fs_memory_stream_uninit(&stream);
+
+        if (result != FS_SUCCESS || pArchiveData == NULL) {
+            printf("%s: Failed to write the archive at level %d (%d).\n", pTest->name, compressionLevels[iLevel], result);
+            fs_free(pArchiveData, NULL);
+            errorCount += 1;
+            continue;
+        }
+
+        for (corrupt = 0; corrupt < 2; corrupt += 1) {
+            fs_result expectedResult = corrupt ? FS_CHECKSUM_MISMATCH : FS_SUCCESS;
+
+            /* Flip a bit in the CRC of the central directory record. Flipping it again on the next pass restores it. */
+            if (corrupt) {
+                for (i = 0; i + 46 <= archiveDataSize; i += 1) {
+                    fs_uint8* pRecord = (fs_uint8*)pArchiveData + i;
+                    if (pRecord[0] == 0x50 && pRecord[1] == 0x4B && pRecord[2] == 0x01 && pRecord[3] == 0x02) {
+                        pRecord[16] ^= 0x01;
+                    }
+                }
+            }
+
+            fs_memory_stream_init_readonly(pArchiveData, archiveDataSize, &stream);
+
+            /* Seek points are enabled so that seeking forward past the checksummed data can't skip over it with a seek point. */
+            zipConfig = fs_zip_config_init();
+            zipConfig.verifyChecksums   = FS_TRUE;
+            zipConfig.seekPointInterval = 16384;
+
+            archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+            result = fs_init(&archiveConfig, &pArchive);
+            if (result != FS_SUCCESS) {
+                printf("%s: Failed to open the archive at level %d (%d).\n", pTest->name, compressionLevels[iLevel], result);
+                errorCount += 1;
+                continue;
+            }
+
+            /* Mode 0 runs first so the seek points have all been created by the time the other modes run. */
+            for (mode = 0; mode < 4; mode += 1) {
+                result = fs_test_archives_checksums_seek_read(pTest, pArchive, mode);
+                if (result != expectedResult) {
+                    printf("%s: Level %d, %s, mode %d returned %d when %d was expected.\n", pTest->name, compressionLevels[iLevel], corrupt ? "corrupt" : "valid", mode, result, expectedResult);
+                    errorCount += 1;
+                }
+            }
+
+            fs_uninit(pArchive);
+        }
+
+        fs_free(pArchiveData, NULL);
+    }
+
+    fs_free(pData, NULL);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END archives_checksums_seek */
+
+/* BEG archives_cache_sizes */
+fs_result fs_test_archives_cache_sizes_read(fs_test* pTest, fs* pArchive, size_t offset, size_t size)
+{
+    fs_result result;
+    fs_file* pFile;
+    fs_uint8 data[3000];
+    size_t totalBytesRead;
+    size_t bytesRead;
+    size_t i;
+
+    result = fs_file_open(pArchive, "data.bin", FS_READ, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open data.bin.\n", pTest->name);
+        return result;
+    }
+
+    result = fs_file_seek(pFile, (fs_int64)offset, FS_SEEK_SET);
+
+    totalBytesRead = 0;
+    while (result == FS_SUCCESS && totalBytesRead < size) {
+        result = fs_file_read(pFile, data, FS_MIN(sizeof(data), size - totalBytesRead), &bytesRead);
         if (result != FS_SUCCESS) {
-            printf("%s: Failed to get info for iterated item %s.\n", pTest->name, pIterator->pName);
-            return FS_ERROR;
+            break;
         }
 
-        if (info.directory != pIterator->info.directory) {
-            printf("%s: Iterator and info disagree on directory status for %s.\n", pTest->name, pIterator->pName);
-            return FS_ERROR;
+        for (i = 0; i < bytesRead; i += 1) {
+            if (data[i] != fs_test_archives_seek_points_expected_byte(offset + totalBytesRead + i)) {
+                printf("%s: Incorrect data at %d.\n", pTest->name, (int)(offset + totalBytesRead + i));
+                result = FS_ERROR;
+                break;
+            }
         }
 
-        pIterator = fs_next(pIterator);
+        totalBytesRead += bytesRead;
     }
 
-    /* We should have found at least 1 directory and some files. */
-    if (dirCount < 1) {
-        printf("%s: Expected at least 1 directory, found %d.\n", pTest->name, dirCount);
+    fs_file_close(pFile);
+
+    return result;
+}
+
+int fs_test_archives_cache_sizes(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_result result;
+    fs_file* pArchiveFile;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    size_t iRun;
+    int errorCount = 0;
+
+    /* The uncompressed cache is rounded up so the odd sizes make sure that works. */
+    struct
+    {
+        size_t uncompressedCacheSize;
+        size_t compressedCacheSize;
+        fs_bool32 adaptiveReadSize;
+    } runs[] =
+    {
+        { 0,          0,          FS_FALSE },
+        { 0,          0,          FS_TRUE  },
+        { 1,          1,          FS_FALSE },
+        { 100000,     1000,       FS_TRUE  },
+        { 256 * 1024, 256 * 1024, FS_FALSE },
+        { 256 * 1024, 256 * 1024, FS_TRUE  }
+    };
+
+    /* test1.zip is STORE and test3.zip is DEFLATE. */
+    result = fs_test_open_and_write_file(pTest, pTestState->pFS, "test1.zip", FS_WRITE | FS_TRUNCATE, fs_test_file_test1_zip, sizeof(fs_test_file_test1_zip));
+    if (result != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    if (fileCount < expectedFiles) {
-        printf("%s: Expected at least %d files, found %d.\n", pTest->name, expectedFiles, fileCount);
+    result = fs_test_open_and_write_file(pTest, pTestState->pFS, "test3.zip", FS_WRITE | FS_TRUNCATE, fs_test_file_test3_zip, sizeof(fs_test_file_test3_zip));
+    if (result != FS_SUCCESS) {
         return FS_ERROR;
     }
 
-    /* Test error condition: Try to iterate a file as directory. */
-    /* Create a temporary file for this test. */
-    {
-        fs_file* pFile;
-        result = fs_file_open(pFS, "/testdir/temp_file_for_iteration_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    for (iRun = 0; iRun < FS_COUNTOF(runs); iRun += 1) {
+        zipConfig = fs_zip_config_init();
+        zipConfig.verifyChecksums       = FS_TRUE;
+        zipConfig.uncompressedCacheSize = runs[iRun].uncompressedCacheSize;
+        zipConfig.compressedCacheSize   = runs[iRun].compressedCacheSize;
+        zipConfig.adaptiveReadSize      = runs[iRun].adaptiveReadSize;
+
+        /* STORE. */
+        result = fs_file_open(pTestState->pFS, "test1.zip", FS_READ | FS_OPAQUE, &pArchiveFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open test1.zip.\n", pTest->name);
+            return FS_ERROR;
+        }
+
+        archiveConfig = fs_config_init(FS_ZIP, &zipConfig, fs_file_get_stream(pArchiveFile));
+
+        result = fs_init(&archiveConfig, &pArchive);
         if (result == FS_SUCCESS) {
-            fs_file_close(pFile);
-            
-            /* Now try to iterate this file as a directory. */
-            pIterator = fs_first(pFS, "/testdir/temp_file_for_iteration_test.txt", FS_IGNORE_MOUNTS);
-            if (pIterator != NULL) {
-                printf("%s: Iterating a file as directory should have failed.\n", pTest->name);
-                return FS_ERROR;
+            result = fs_test_archives_checksums_read(pTest, pArchive, "dir1/c", FS_FALSE);
+            if (result != FS_SUCCESS) {
+                printf("%s: Run %d failed to read dir1/c (%d).\n", pTest->name, (int)iRun, result);
+                errorCount += 1;
             }
-            
-            /* Clean up the temp file. */
-            fs_remove(pFS, "/testdir/temp_file_for_iteration_test.txt", FS_WRITE | FS_IGNORE_MOUNTS);
+
+            fs_uninit(pArchive);
+        } else {
+            printf("%s: Failed to initialize the archive (%d).\n", pTest->name, result);
+            errorCount += 1;
+        }
+
+        fs_file_close(pArchiveFile);
+
+        /* DEFLATE. The whole file is read to verify the checksum, and then a section in the middle after a seek. */
+        result = fs_file_open(pTestState->pFS, "test3.zip", FS_READ | FS_OPAQUE, &pArchiveFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open test3.zip.\n", pTest->name);
+            return FS_ERROR;
+        }
+
+        archiveConfig = fs_config_init(FS_ZIP, &zipConfig, fs_file_get_stream(pArchiveFile));
+
+        result = fs_init(&archiveConfig, &pArchive);
+        if (result == FS_SUCCESS) {
+            result = fs_test_archives_cache_sizes_read(pTest, pArchive, 0, 262144);
+            if (result == FS_SUCCESS) {
+                result = fs_test_archives_cache_sizes_read(pTest, pArchive, 100000, 5000);
+            }
+
+            if (result != FS_SUCCESS) {
+                printf("%s: Run %d failed to read data.bin (%d).\n", pTest->name, (int)iRun, result);
+                errorCount += 1;
+            }
+
+            fs_uninit(pArchive);
+        } else {
+            printf("%s: Failed to initialize the archive (%d).\n", pTest->name, result);
+            errorCount += 1;
         }
+
+        fs_file_close(pArchiveFile);
     }
 
-    return FS_SUCCESS;
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_iteration */
+/* END archives_cache_sizes */
 
-/* BEG mem_rename */
-int fs_test_mem_rename(fs_test* pTest)
+/* BEG archives_write */
+int fs_test_archives_write(fs_test* pTest)
 {
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
+    fs_memory_stream stream;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    fs_file* pFile;
+    fs_file* pOtherFile;
     fs_file_info info;
+    fs_uint8* pData;
+    size_t dataSize = 200000;
+    void* pArchiveData;
+    size_t archiveDataSize;
+    size_t bytesRead;
+    size_t i;
+    int errorCount = 0;
 
-    /* Rename a file. */
-    result = fs_rename(pFS, "/testdir/test_new.txt", "/testdir/renamed_file.txt", FS_WRITE | FS_IGNORE_MOUNTS);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to rename file.\n", pTest->name);
+    pData = (fs_uint8*)fs_malloc(dataSize, NULL);
+    if (pData == NULL) {
         return FS_ERROR;
     }
 
-    /* Verify old name doesn't exist. */
-    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
-    if (result == FS_SUCCESS) {
-        printf("%s: Old file name still exists after rename.\n", pTest->name);
-        return FS_ERROR;
+    for (i = 0; i < dataSize; i += 1) {
+        pData[i] = fs_test_archives_seek_points_expected_byte(i);
     }
 
-    /* Verify new name exists. */
-    result = fs_info(pFS, "/testdir/renamed_file.txt", FS_IGNORE_MOUNTS, &info);
+    result = fs_memory_stream_init_write(NULL, &stream);
     if (result != FS_SUCCESS) {
-        printf("%s: New file name doesn't exist after rename.\n", pTest->name);
+        fs_free(pData, NULL);
         return FS_ERROR;
     }
 
-    /* Rename a directory. */
-    result = fs_rename(pFS, "/testdir/subdir2", "/testdir/renamed_dir", FS_WRITE | FS_IGNORE_MOUNTS);
+    zipConfig = fs_zip_config_init();
+    zipConfig.write = FS_TRUE;
+
+    archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+    result = fs_init(&archiveConfig, &pArchive);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to rename directory.\n", pTest->name);
+        printf("%s: Failed to initialize the archive for writing (%d).\n", pTest->name, result);
+        fs_memory_stream_uninit(&stream);
+        fs_free(pData, NULL);
         return FS_ERROR;
     }
 
-    /* Verify directory rename worked. */
-    result = fs_info(pFS, "/testdir/renamed_dir", FS_IGNORE_MOUNTS, &info);
+    /* A small file at the root. */
+    result = fs_file_open(pArchive, "hello.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result == FS_SUCCESS) {
+        fs_file_write(pFile, "Hello, World!", 13, NULL);
+        fs_file_close(pFile);
+    } else {
+        printf("%s: Failed to open hello.txt for writing (%d).\n", pTest->name, result);
+        errorCount += 1;
+    }
+
+    /* A bigger file in a sub-directory, written in pieces of different sizes. The parent directories are created automatically. */
+    result = fs_file_open(pArchive, "dir/sub/data.bin", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result == FS_SUCCESS) {
+        fs_file_write(pFile, pData, 1000, NULL);
+        fs_file_write(pFile, pData + 1000, 150000, NULL);
+        fs_file_write(pFile, pData + 151000, dataSize - 151000, NULL);
+
+        /* Only one file can be written at a time. */
+        result = fs_file_open(pArchive, "other.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pOtherFile);
+        if (result != FS_BUSY) {
+            printf("%s: Opening a second file for writing returned %d when FS_BUSY was expected.\n", pTest->name, result);
+            errorCount += 1;
+
+            if (result == FS_SUCCESS) {
+                fs_file_close(pOtherFile);
+            }
+        }
+
+        fs_file_close(pFile);
+    } else {
+        printf("%s: Failed to open dir/sub/data.bin for writing (%d).\n", pTest->name, result);
+        errorCount += 1;
+    }
+
+    /* Files can't be written twice. */
+    result = fs_file_open(pArchive, "/dir/sub/data.bin", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_ALREADY_EXISTS) {
+        printf("%s: Opening an existing file for writing returned %d when FS_ALREADY_EXISTS was expected.\n", pTest->name, result);
+        errorCount += 1;
+
+        if (result == FS_SUCCESS) {
+            fs_file_close(pFile);
+        }
+    }
+
+    result = fs_info(pArchive, "dir/sub", FS_IGNORE_MOUNTS, &info);
     if (result != FS_SUCCESS || !info.directory) {
-        printf("%s: Renamed directory doesn't exist or is not a directory.\n", pTest->name);
+        printf("%s: dir/sub was not added as a directory (%d).\n", pTest->name, result);
+        errorCount += 1;
+    }
+
+    fs_uninit(pArchive);
+
+
+    /* Now read everything back. */
+    pArchiveData = fs_memory_stream_take_ownership(&stream, &archiveDataSize);
+    fs_memory_stream_uninit(&stream);
+
+    fs_memory_stream_init_readonly(pArchiveData, archiveDataSize, &stream);
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.verifyChecksums = FS_TRUE;
+
+    archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the written archive for reading (%d).\n", pTest->name, result);
+        fs_free(pArchiveData, NULL);
+        fs_free(pData, NULL);
         return FS_ERROR;
     }
 
-    /* Test error condition: Try to rename root directory - should fail. */
-    result = fs_rename(pFS, "/", "/newroot", FS_WRITE | FS_IGNORE_MOUNTS);
+    result = fs_file_open(pArchive, "hello.txt", FS_READ, &pFile);
     if (result == FS_SUCCESS) {
-        printf("%s: Renaming root directory should have failed.\n", pTest->name);
-        return FS_ERROR;
+        char hello[32];
+
+        result = fs_file_read(pFile, hello, sizeof(hello), &bytesRead);
+        if (result != FS_SUCCESS || bytesRead != 13 || memcmp(hello, "Hello, World!", 13) != 0) {
+            printf("%s: Incorrect data read from hello.txt (%d).\n", pTest->name, result);
+            errorCount += 1;
+        }
+
+        fs_file_close(pFile);
+    } else {
+        printf("%s: Failed to open hello.txt for reading (%d).\n", pTest->name, result);
+        errorCount += 1;
     }
 
-    return FS_SUCCESS;
+    result = fs_file_open(pArchive, "dir/sub/data.bin", FS_READ, &pFile);
+    if (result == FS_SUCCESS) {
+        fs_uint8* pReadData = (fs_uint8*)fs_malloc(dataSize + 1, NULL);
+
+        if (pReadData != NULL) {
+            result = fs_file_read(pFile, pReadData, dataSize + 1, &bytesRead);
+            if (result != FS_SUCCESS || bytesRead != dataSize || memcmp(pReadData, pData, dataSize) != 0) {
+                printf("%s: Incorrect data read from dir/sub/data.bin (%d).\n", pTest->name, result);
+                errorCount += 1;
+            }
+
+            /* The checksum is reported on the read that hits the end. */
+            result = fs_file_read(pFile, pReadData, 1, &bytesRead);
+            if (result != FS_AT_END) {
+                printf("%s: Reading the end of dir/sub/data.bin returned %d when FS_AT_END was expected.\n", pTest->name, result);
+                errorCount += 1;
+            }
+
+            fs_free(pReadData, NULL);
+        }
+
+        fs_file_close(pFile);
+    } else {
+        printf("%s: Failed to open dir/sub/data.bin for reading (%d).\n", pTest->name, result);
+        errorCount += 1;
+    }
+
+    result = fs_info(pArchive, "dir", FS_READ, &info);
+    if (result != FS_SUCCESS || !info.directory) {
+        printf("%s: dir is not a directory in the written archive (%d).\n", pTest->name, result);
+        errorCount += 1;
+    }
+
+    fs_uninit(pArchive);
+    fs_free(pArchiveData, NULL);
+    fs_free(pData, NULL);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_rename */
+/* END archives_write */
 
-/* BEG mem_remove */
-int fs_test_mem_remove(fs_test* pTest)
+/* BEG archives_write_zip64_boundary */
+static fs_result fs_test_archives_write_zip64_boundary_internal(fs_test* pTest, size_t entryCount)
 {
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
     fs_result result;
+    fs_memory_stream stream;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    fs_file* pFile;
     fs_file_info info;
+    void* pArchiveData;
+    size_t archiveDataSize;
+    const fs_uint8* pLocator;
+    fs_bool32 hasZip64Locator;
+    char path[32];
+    size_t iEntry;
+    int errorCount = 0;
+
+    result = fs_memory_stream_init_write(NULL, &stream);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.write = FS_TRUE;
+
+    archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the archive for writing (%d).\n", pTest->name, result);
+        fs_memory_stream_uninit(&stream);
+        return FS_ERROR;
+    }
+
+    for (iEntry = 0; iEntry < entryCount; iEntry += 1) {
+        fs_snprintf(path, sizeof(path), "%d", (int)iEntry);
+
+        result = fs_file_open(pArchive, path, FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open %s for writing (%d).\n", pTest->name, path, result);
+            errorCount += 1;
+            break;
+        }
+
+        fs_file_write(pFile, path, 1, NULL);
+        fs_file_close(pFile);
+    }
+
+    fs_uninit(pArchive);
+
+    pArchiveData = fs_memory_stream_take_ownership(&stream, &archiveDataSize);
+    fs_memory_stream_uninit(&stream);
+
+    if (pArchiveData == NULL) {
+        return FS_ERROR;
+    }
+
+    /*
+    The ZIP64 locator sits right before the 22 byte end of central directory record. It must be there
+    when the entry count is 65535 or more since 0xFFFF in the regular record means "see the ZIP64 record".
+    */
+    pLocator = (const fs_uint8*)pArchiveData + archiveDataSize - 22 - 20;
+    hasZip64Locator = (archiveDataSize >= 42 && pLocator[0] == 0x50 && pLocator[1] == 0x4B && pLocator[2] == 0x06 && pLocator[3] == 0x07);
+
+    if (hasZip64Locator != (entryCount >= 0xFFFF)) {
+        printf("%s: The ZIP64 end of central directory locator was %s for %d entries.\n", pTest->name, hasZip64Locator ? "written" : "not written", (int)entryCount);
+        errorCount += 1;
+    }
+
+    /* Now make sure it can be opened again and that the first and last entries can be found. */
+    fs_memory_stream_init_readonly(pArchiveData, archiveDataSize, &stream);
+
+    archiveConfig = fs_config_init(FS_ZIP, NULL, &stream.base);
+
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result == FS_SUCCESS) {
+        fs_snprintf(path, sizeof(path), "%d", (int)(entryCount - 1));
+
+        if (fs_info(pArchive, "0", FS_READ, &info) != FS_SUCCESS || info.size != 1 || fs_info(pArchive, path, FS_READ, &info) != FS_SUCCESS || info.size != 1) {
+            printf("%s: Failed to find the first and last entries of an archive with %d entries.\n", pTest->name, (int)entryCount);
+            errorCount += 1;
+        }
+
+        fs_uninit(pArchive);
+    } else {
+        printf("%s: Failed to open an archive with %d entries (%d).\n", pTest->name, (int)entryCount, result);
+        errorCount += 1;
+    }
+
+    fs_free(pArchiveData, NULL);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+
+int fs_test_archives_write_zip64_boundary(fs_test* pTest)
+{
+    size_t entryCounts[] = { 65534, 65535, 65536 };
+    size_t i;
+    int errorCount = 0;
+
+    for (i = 0; i < FS_COUNTOF(entryCounts); i += 1) {
+        if (fs_test_archives_write_zip64_boundary_internal(pTest, entryCounts[i]) != FS_SUCCESS) {
+            errorCount += 1;
+        }
+    }
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END archives_write_zip64_boundary */
+
+/* BEG archives_write_compressed */
+static void fs_test_archives_write_compressed_make_data(fs_uint8* pText, size_t textSize, fs_uint8* pRandom, size_t randomSize)
+{
+    static const char* pWords[8] = { "alpha ", "bravo ", "charlie ", "delta ", "echo ", "foxtrot ", "golf ", "hotel\n" };
+    fs_uint32 seed = 12345;
+    size_t i;
+
+    /* Text made from a small number of words for data that compresses well, and noise for data that doesn't. */
+    for (i = 0; i < textSize; ) {
+        const char* pWord;
+
+        seed = (seed * 1103515245) + 12345;
+        pWord = pWords[(seed >> 16) & 7];
+
+        while (*pWord != '\0' && i < textSize) {
+            pText[i++] = (fs_uint8)*pWord++;
+        }
+    }
+
+    for (i = 0; i < randomSize; i += 1) {
+        seed = (seed * 1103515245) + 12345;
+        pRandom[i] = (fs_uint8)(seed >> 24);
+    }
+}
+
+static fs_result fs_test_archives_write_compressed_build(fs_test* pTest, int compressionLevel, int threadCount, const fs_uint8* pText, size_t textSize, const fs_uint8* pRandom, size_t randomSize, void** ppArchiveData, size_t* pArchiveDataSize)
+{
+    fs_result result;
+    fs_memory_stream stream;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    fs_file* pFile;
+    char path[64];
+    int iFile;
+    int errorCount = 0;
+
+    *ppArchiveData    = NULL;
+    *pArchiveDataSize = 0;
+
+    result = fs_memory_stream_init_write(NULL, &stream);
+    if (result != FS_SUCCESS) {
+        return result;
+    }
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.write            = FS_TRUE;
+    zipConfig.compressionLevel = compressionLevel;
+    zipConfig.threadCount      = threadCount;
+
+    archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the archive for writing (%d).\n", pTest->name, result);
+        fs_memory_stream_uninit(&stream);
+        return result;
+    }
+
+    /* The text is big enough to be split into many chunks. It's flushed part way through which forces a chunk boundary. */
+    result = fs_file_open(pArchive, "text.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result == FS_SUCCESS) {
+        fs_file_write(pFile, pText, 1000, NULL);
+        fs_file_write(pFile, pText + 1000, 300000, NULL);
+
+        result = fs_file_flush(pFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to flush text.txt (%d).\n", pTest->name, result);
+            errorCount += 1;
+        }
+
+        fs_file_write(pFile, pText + 301000, textSize - 301000, NULL);
+        fs_file_close(pFile);
+    } else {
+        printf("%s: Failed to open text.txt for writing (%d).\n", pTest->name, result);
+        errorCount += 1;
+    }
+
+    /* Lots of small files which end up being compressed together in the same batch, with a directory in the middle. */
+    for (iFile = 0; iFile < 100; iFile += 1) {
+        fs_snprintf(path, sizeof(path), "small/%d.txt", iFile);
+
+        if (iFile == 50) {
+            fs_mkdir(pArchive, "small/dir", FS_IGNORE_MOUNTS);
+        }
+
+        result = fs_file_open(pArchive, path, FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result == FS_SUCCESS) {
+            fs_file_write(pFile, pText + iFile, (size_t)iFile * 10, NULL);
+            fs_file_close(pFile);
+        } else {
+            printf("%s: Failed to open %s for writing (%d).\n", pTest->name, path, result);
+            errorCount += 1;
+        }
+    }
+
+    result = fs_file_open(pArchive, "random.bin", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result == FS_SUCCESS) {
+        fs_file_write(pFile, pRandom, randomSize, NULL);
+        fs_file_close(pFile);
+    } else {
+        printf("%s: Failed to open random.bin for writing (%d).\n", pTest->name, result);
+        errorCount += 1;
+    }
+
+    fs_uninit(pArchive);
+
+    *ppArchiveData = fs_memory_stream_take_ownership(&stream, pArchiveDataSize);
+    fs_memory_stream_uninit(&stream);
+
+    if (*ppArchiveData == NULL) {
+        return FS_ERROR;
+    }
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+
+static fs_result fs_test_archives_write_compressed_check_file(fs_test* pTest, fs* pArchive, const char* pPath, const fs_uint8* pExpectedData, size_t expectedDataSize)
+{
+    fs_result result;
+    fs_file* pFile;
+    fs_uint8* pReadData;
+    size_t bytesRead;
+
+    result = fs_file_open(pArchive, pPath, FS_READ, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open %s for reading (%d).\n", pTest->name, pPath, result);
+        return result;
+    }
+
+    pReadData = (fs_uint8*)fs_malloc(expectedDataSize + 1, NULL);
+    if (pReadData == NULL) {
+        fs_file_close(pFile);
+        return FS_OUT_OF_MEMORY;
+    }
+
+    /* With checksums enabled the read that hits the end fails if the CRC is wrong. */
+    result = fs_file_read(pFile, pReadData, expectedDataSize + 1, &bytesRead);
+    if ((result != FS_SUCCESS && result != FS_AT_END) || bytesRead != expectedDataSize || (expectedDataSize > 0 && memcmp(pReadData, pExpectedData, expectedDataSize) != 0)) {
+        printf("%s: Incorrect data read from %s (%d).\n", pTest->name, pPath, result);
+        result = FS_ERROR;
+    } else {
+        result = fs_file_read(pFile, pReadData, 1, &bytesRead);
+        if (result == FS_AT_END) {
+            result = FS_SUCCESS;
+        } else {
+            printf("%s: Reading the end of %s returned %d when FS_AT_END was expected.\n", pTest->name, pPath, result);
+            result = FS_ERROR;
+        }
+    }
+
+    fs_free(pReadData, NULL);
+    fs_file_close(pFile);
+
+    return result;
+}
+
+int fs_test_archives_write_compressed(fs_test* pTest)
+{
+    static const int runs[][2] =
+    {
+        /* Level, thread count. */
+        {1, 1},
+        {1, 4},
+        {6, 1},
+        {6, 3},
+        {9, 2}
+    };
+    fs_result result;
+    fs_memory_stream stream;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    fs_file_info info;
+    fs_uint8* pText;
+    fs_uint8* pRandom;
+    size_t textSize = 700000;
+    size_t randomSize = 150000;
+    void* pArchiveData;
+    size_t archiveDataSize;
+    void* pPrevArchiveData = NULL;
+    size_t prevArchiveDataSize = 0;
+    char path[64];
+    size_t iRun;
+    int iFile;
+    int errorCount = 0;
+
+    pText   = (fs_uint8*)fs_malloc(textSize, NULL);
+    pRandom = (fs_uint8*)fs_malloc(randomSize, NULL);
+    if (pText == NULL || pRandom == NULL) {
+        fs_free(pText, NULL);
+        fs_free(pRandom, NULL);
+        return FS_ERROR;
+    }
+
+    fs_test_archives_write_compressed_make_data(pText, textSize, pRandom, randomSize);
+
+    for (iRun = 0; iRun < sizeof(runs) / sizeof(runs[0]); iRun += 1) {
+        result = fs_test_archives_write_compressed_build(pTest, runs[iRun][0], runs[iRun][1], pText, textSize, pRandom, randomSize, &pArchiveData, &archiveDataSize);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to write the archive at level %d with %d threads (%d).\n", pTest->name, runs[iRun][0], runs[iRun][1], result);
+            errorCount += 1;
+
+            if (pArchiveData == NULL) {
+                break;
+            }
+        }
+
+        /* The text should compress to well under half its size, whereas the noise can't be compressed at all. */
+        if (archiveDataSize >= (textSize / 2) + randomSize) {
+            printf("%s: The archive written at level %d is %d bytes which is too big for the data to have been compressed.\n", pTest->name, runs[iRun][0], (int)archiveDataSize);
+            errorCount += 1;
+        }
+
+        /* The output doesn't depend on the number of threads. */
+        if (pPrevArchiveData != NULL && runs[iRun - 1][0] == runs[iRun][0]) {
+            if (archiveDataSize != prevArchiveDataSize || memcmp(pArchiveData, pPrevArchiveData, archiveDataSize) != 0) {
+                printf("%s: The archive written at level %d with %d threads is different to the one written with %d threads.\n", pTest->name, runs[iRun][0], runs[iRun][1], runs[iRun - 1][1]);
+                errorCount += 1;
+            }
+        }
+
+        fs_free(pPrevArchiveData, NULL);
+        pPrevArchiveData    = pArchiveData;
+        prevArchiveDataSize = archiveDataSize;
+
+        /* Now read everything back. */
+        fs_memory_stream_init_readonly(pArchiveData, archiveDataSize, &stream);
+
+        zipConfig = fs_zip_config_init();
+        zipConfig.verifyChecksums = FS_TRUE;
+
+        archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+        result = fs_init(&archiveConfig, &pArchive);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to initialize the archive written at level %d for reading (%d).\n", pTest->name, runs[iRun][0], result);
+            errorCount += 1;
+            continue;
+        }
+
+        if (fs_test_archives_write_compressed_check_file(pTest, pArchive, "text.txt", pText, textSize) != FS_SUCCESS) {
+            errorCount += 1;
+        }
+
+        if (fs_test_archives_write_compressed_check_file(pTest, pArchive, "random.bin", pRandom, randomSize) != FS_SUCCESS) {
+            errorCount += 1;
+        }
+
+        for (iFile = 0; iFile < 100; iFile += 1) {
+            fs_snprintf(path, sizeof(path), "small/%d.txt", iFile);
+
+            if (fs_test_archives_write_compressed_check_file(pTest, pArchive, path, pText + iFile, (size_t)iFile * 10) != FS_SUCCESS) {
+                errorCount += 1;
+                break;
+            }
+        }
+
+        result = fs_info(pArchive, "small/dir", FS_READ, &info);
+        if (result != FS_SUCCESS || !info.directory) {
+            printf("%s: small/dir is not a directory in the archive written at level %d (%d).\n", pTest->name, runs[iRun][0], result);
+            errorCount += 1;
+        }
+
+        fs_uninit(pArchive);
+    }
+
+    fs_free(pPrevArchiveData, NULL);
+    fs_free(pText, NULL);
+    fs_free(pRandom, NULL);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END archives_write_compressed */
+
+/* BEG archives_inflate_patterns */
+/*
+Round trips data through the compressor and decompressor that's shaped to hit specific parts of the
+decompressor's fast path: runs of literals which are decoded in pairs, matches with distances under
+8 which overlap their own output, runs with a distance of 1, matches that cross the wrapping point of
+the uncompressed cache, and output that ends within 8 bytes of the end of the output buffer.
+*/
+#define FS_TEST_INFLATE_PATTERN_COUNT   4
+
+static fs_uint32 fs_test_archives_inflate_patterns_rand(fs_uint32* pSeed)
+{
+    *pSeed = (*pSeed * 1103515245) + 12345;
+    return *pSeed >> 16;
+}
+
+static void fs_test_archives_inflate_patterns_make_data(int pattern, fs_uint8* pData, size_t dataSize)
+{
+    fs_uint32 seed = 1234 + (fs_uint32)pattern;
+    size_t i = 0;
+
+    while (i < dataSize) {
+        size_t length;
+        size_t j;
+
+        if (pattern == 0) {
+            /* Literals. A small alphabet with no structure means there's only the occasional match. */
+            pData[i++] = (fs_uint8)('0' + (fs_test_archives_inflate_patterns_rand(&seed) % 64));
+        } else if (pattern == 1) {
+            /* A short random sequence repeated with a period of 2 to 7, followed by a few literals. */
+            fs_uint8 sequence[8];
+            size_t period = 2 + (fs_test_archives_inflate_patterns_rand(&seed) % 6);
+
+            for (j = 0; j < period; j += 1) {
+                sequence[j] = (fs_uint8)fs_test_archives_inflate_patterns_rand(&seed);
+            }
+
+            length = 3 + (fs_test_archives_inflate_patterns_rand(&seed) % 300);
+            for (j = 0; j < length && i < dataSize; j += 1) {
+                pData[i++] = sequence[j % period];
+            }
+
+            length = fs_test_archives_inflate_patterns_rand(&seed) % 4;
+            for (j = 0; j < length && i < dataSize; j += 1) {
+                pData[i++] = (fs_uint8)fs_test_archives_inflate_patterns_rand(&seed);
+            }
+        } else if (pattern == 2) {
+            /* Runs of a single byte. Some are longer than the longest match so they need more than one. */
+            fs_uint8 value = (fs_uint8)fs_test_archives_inflate_patterns_rand(&seed);
+
+            length = 1 + (fs_test_archives_inflate_patterns_rand(&seed) % 600);
+            for (j = 0; j < length && i < dataSize; j += 1) {
+                pData[i++] = value;
+            }
+        } else {
+            /* Copies from anywhere in the window, mixed with literals, so matches end up crossing the wrapping point of the cache. */
+            if (i < 32768 || (fs_test_archives_inflate_patterns_rand(&seed) % 4) == 0) {
+                pData[i++] = (fs_uint8)fs_test_archives_inflate_patterns_rand(&seed);
+            } else {
+                size_t dist = 1 + ((fs_test_archives_inflate_patterns_rand(&seed) << 1) % 32768);
+
+                length = 3 + (fs_test_archives_inflate_patterns_rand(&seed) % 256);
+                for (j = 0; j < length && i < dataSize; j += 1) {
+                    pData[i] = pData[i - dist];
+                    i += 1;
+                }
+            }
+        }
+    }
+}
+
+static fs_result fs_test_archives_inflate_patterns_check(fs_test* pTest, fs* pArchive, const char* pPath, const fs_uint8* pExpectedData, size_t expectedDataSize, size_t readSize, fs_uint8* pReadData)
+{
+    fs_result result;
+    fs_file* pFile;
+    size_t totalBytesRead = 0;
+    size_t bytesRead;
+
+    result = fs_file_open(pArchive, pPath, FS_READ, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open %s (%d).\n", pTest->name, pPath, result);
+        return result;
+    }
+
+    for (;;) {
+        result = fs_file_read(pFile, pReadData + totalBytesRead, readSize, &bytesRead);
+        if (result != FS_SUCCESS) {
+            break;
+        }
+
+        totalBytesRead += bytesRead;
+        if (totalBytesRead > expectedDataSize) {
+            break;
+        }
+    }
+
+    fs_file_close(pFile);
+
+    if (result != FS_AT_END || totalBytesRead != expectedDataSize || memcmp(pReadData, pExpectedData, expectedDataSize) != 0) {
+        printf("%s: Incorrect data read from %s with reads of %d bytes (%d).\n", pTest->name, pPath, (int)readSize, result);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+
+/*
+The compressor only writes DEFLATE, so DEFLATE64 entries are put together by hand. The stream uses the
+fixed Huffman codes and has two matches of 60000 bytes which is only possible with the 16 extra bits
+of length symbol 285 in DEFLATE64. Those are longer than any DEFLATE match and must not be handled by
+the fast path, which only leaves room for 258 bytes.
+*/
+#define FS_TEST_INFLATE_DEFLATE64_MATCH_LENGTH  60000
+#define FS_TEST_INFLATE_DEFLATE64_SIZE          (40 + FS_TEST_INFLATE_DEFLATE64_MATCH_LENGTH*2 + 60)
+
+typedef struct
+{
+    fs_uint8* pData;
+    size_t size;
+    fs_uint32 bitBuffer;
+    fs_uint32 bitCount;
+} fs_test_bit_writer;
+
+static void fs_test_bit_writer_write(fs_test_bit_writer* pWriter, fs_uint32 value, fs_uint32 bitCount)
+{
+    pWriter->bitBuffer |= value << pWriter->bitCount;
+    pWriter->bitCount  += bitCount;
+
+    while (pWriter->bitCount >= 8) {
+        pWriter->pData[pWriter->size++] = (fs_uint8)pWriter->bitBuffer;
+        pWriter->bitBuffer >>= 8;
+        pWriter->bitCount   -= 8;
+    }
+}
+
+/* Huffman codes are stored starting from the most significant bit. */
+static void fs_test_bit_writer_write_code(fs_test_bit_writer* pWriter, fs_uint32 code, fs_uint32 bitCount)
+{
+    fs_uint32 i;
+
+    for (i = 0; i < bitCount; i += 1) {
+        fs_test_bit_writer_write(pWriter, (code >> (bitCount - 1 - i)) & 1, 1);
+    }
+}
+
+static void fs_test_bit_writer_write_fixed_literal(fs_test_bit_writer* pWriter, fs_uint32 symbol)
+{
+    if (symbol < 144) {
+        fs_test_bit_writer_write_code(pWriter, 0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        fs_test_bit_writer_write_code(pWriter, 0x190 + (symbol - 144), 9);
+    } else if (symbol < 280) {
+        fs_test_bit_writer_write_code(pWriter, symbol - 256, 7);
+    } else {
+        fs_test_bit_writer_write_code(pWriter, 0xC0 + (symbol - 280), 8);
+    }
+}
+
+static fs_uint32 fs_test_crc32(const fs_uint8* pData, size_t dataSize)
+{
+    fs_uint32 crc = 0xFFFFFFFF;
+    size_t i;
+    int iBit;
+
+    for (i = 0; i < dataSize; i += 1) {
+        crc ^= pData[i];
+        for (iBit = 0; iBit < 8; iBit += 1) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+static void fs_test_write_le16(fs_uint8* p, fs_uint32 value)
+{
+    p[0] = (fs_uint8)(value >> 0);
+    p[1] = (fs_uint8)(value >> 8);
+}
+
+static void fs_test_write_le32(fs_uint8* p, fs_uint32 value)
+{
+    p[0] = (fs_uint8)(value >>  0);
+    p[1] = (fs_uint8)(value >>  8);
+    p[2] = (fs_uint8)(value >> 16);
+    p[3] = (fs_uint8)(value >> 24);
+}
+
+static int fs_test_archives_inflate_patterns_deflate64(fs_test* pTest, fs_uint8* pReadData)
+{
+    fs_uint8 archive[1024];
+    fs_uint8 compressed[512];
+    fs_uint8* pExpected;
+    fs_test_bit_writer writer;
+    size_t archiveSize;
+    size_t centralDirectoryOffset;
+    size_t i;
+    fs_uint32 crc;
+    fs_memory_stream stream;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    fs_result result;
+    size_t readSizes[] = { 1000, 4093, 0 };     /* 0 means the whole file, plus an extra 0 to 8 bytes. */
+    size_t iReadSize;
+    size_t extra;
+    int iMatch;
+    int errorCount = 0;
+
+    pExpected = (fs_uint8*)fs_malloc(FS_TEST_INFLATE_DEFLATE64_SIZE, NULL);
+    if (pExpected == NULL) {
+        return 1;
+    }
+
+    /* The stream. A final block with fixed Huffman codes. */
+    memset(&writer, 0, sizeof(writer));
+    writer.pData = compressed;
+
+    fs_test_bit_writer_write(&writer, 1, 1);
+    fs_test_bit_writer_write(&writer, 1, 2);
+
+    for (i = 0; i < 40; i += 1) {
+        pExpected[i] = (fs_uint8)('a' + (i % 26));
+        fs_test_bit_writer_write_fixed_literal(&writer, pExpected[i]);
+    }
+
+    for (; i < 40 + FS_TEST_INFLATE_DEFLATE64_MATCH_LENGTH*2; i += 1) {
+        pExpected[i] = pExpected[39];
+    }
+
+    for (iMatch = 0; iMatch < 2; iMatch += 1) {
+        fs_test_bit_writer_write_fixed_literal(&writer, 285);                                       /* Base length of 3 with 16 extra bits in DEFLATE64. */
+        fs_test_bit_writer_write(&writer, FS_TEST_INFLATE_DEFLATE64_MATCH_LENGTH - 3, 16);
+        fs_test_bit_writer_write_code(&writer, 0, 5);                                               /* A distance of 1. */
+    }
+
+    for (; i < FS_TEST_INFLATE_DEFLATE64_SIZE; i += 1) {
+        pExpected[i] = (fs_uint8)('A' + (i % 26));
+        fs_test_bit_writer_write_fixed_literal(&writer, pExpected[i]);
+    }
+
+    fs_test_bit_writer_write_fixed_literal(&writer, 256);
+    fs_test_bit_writer_write(&writer, 0, 7);    /* Flush the last partial byte. */
+
+    crc = fs_test_crc32(pExpected, FS_TEST_INFLATE_DEFLATE64_SIZE);
+
+    /* Local file header. */
+    memset(archive, 0, sizeof(archive));
+    fs_test_write_le32(archive +  0, 0x04034B50);
+    fs_test_write_le16(archive +  4, 21);
+    fs_test_write_le16(archive +  8, 9);        /* DEFLATE64. */
+    fs_test_write_le32(archive + 14, crc);
+    fs_test_write_le32(archive + 18, (fs_uint32)writer.size);
+    fs_test_write_le32(archive + 22, FS_TEST_INFLATE_DEFLATE64_SIZE);
+    fs_test_write_le16(archive + 26, 5);
+    memcpy(archive + 30, "a.bin", 5);
+    memcpy(archive + 35, compressed, writer.size);
+
+    /* Central directory. */
+    centralDirectoryOffset = 35 + writer.size;
+    fs_test_write_le32(archive + centralDirectoryOffset +  0, 0x02014B50);
+    fs_test_write_le16(archive + centralDirectoryOffset +  4, 21);
+    fs_test_write_le16(archive + centralDirectoryOffset +  6, 21);
+    fs_test_write_le16(archive + centralDirectoryOffset + 10, 9);
+    fs_test_write_le32(archive + centralDirectoryOffset + 16, crc);
+    fs_test_write_le32(archive + centralDirectoryOffset + 20, (fs_uint32)writer.size);
+    fs_test_write_le32(archive + centralDirectoryOffset + 24, FS_TEST_INFLATE_DEFLATE64_SIZE);
+    fs_test_write_le16(archive + centralDirectoryOffset + 28, 5);
+    memcpy(archive + centralDirectoryOffset + 46, "a.bin", 5);
+
+    /* End of central directory. */
+    archiveSize = centralDirectoryOffset + 46 + 5;
+    fs_test_write_le32(archive + archiveSize +  0, 0x06054B50);
+    fs_test_write_le16(archive + archiveSize +  8, 1);
+    fs_test_write_le16(archive + archiveSize + 10, 1);
+    fs_test_write_le32(archive + archiveSize + 12, 46 + 5);
+    fs_test_write_le32(archive + archiveSize + 16, (fs_uint32)centralDirectoryOffset);
+    archiveSize += 22;
+
+    fs_memory_stream_init_readonly(archive, archiveSize, &stream);
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.verifyChecksums = FS_TRUE;
+
+    archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the DEFLATE64 archive (%d).\n", pTest->name, result);
+        fs_memory_stream_uninit(&stream);
+        fs_free(pExpected, NULL);
+        return 1;
+    }
+
+    for (iReadSize = 0; iReadSize < FS_COUNTOF(readSizes); iReadSize += 1) {
+        if (readSizes[iReadSize] > 0) {
+            if (fs_test_archives_inflate_patterns_check(pTest, pArchive, "a.bin", pExpected, FS_TEST_INFLATE_DEFLATE64_SIZE, readSizes[iReadSize], pReadData) != FS_SUCCESS) {
+                errorCount += 1;
+            }
+        } else {
+            for (extra = 0; extra <= 8; extra += 1) {
+                if (fs_test_archives_inflate_patterns_check(pTest, pArchive, "a.bin", pExpected, FS_TEST_INFLATE_DEFLATE64_SIZE, FS_TEST_INFLATE_DEFLATE64_SIZE + extra, pReadData) != FS_SUCCESS) {
+                    errorCount += 1;
+                }
+            }
+        }
+    }
+
+    fs_uninit(pArchive);
+    fs_memory_stream_uninit(&stream);
+    fs_free(pExpected, NULL);
+
+    return errorCount;
+}
+
+int fs_test_archives_inflate_patterns(fs_test* pTest)
+{
+    fs_result result;
+    fs_memory_stream stream;
+    fs_zip_config zipConfig;
+    fs_config archiveConfig;
+    fs* pArchive;
+    fs_file* pFile;
+    fs_uint8* pData[FS_TEST_INFLATE_PATTERN_COUNT];
+    size_t dataSize[FS_TEST_INFLATE_PATTERN_COUNT] = { 150000, 150000, 150000, 300000 };
+    fs_uint8* pReadData;
+    void* pArchiveData;
+    size_t archiveDataSize;
+    size_t compressedCacheSizes[] = { 0, 100 };    /* A tiny compressed cache means the input runs out in all sorts of places. */
+    size_t readSizes[] = { 1000, 4093, 1, 0 };     /* 0 means the whole file, plus an extra 0 to 8 bytes. */
+    char path[32];
+    int iPattern;
+    size_t iCache;
+    size_t iReadSize;
+    size_t extra;
+    int errorCount = 0;
+
+    for (iPattern = 0; iPattern < FS_TEST_INFLATE_PATTERN_COUNT; iPattern += 1) {
+        pData[iPattern] = NULL;
+    }
+
+    pReadData = (fs_uint8*)fs_malloc(300000 + 16 + 4096, NULL);
+    if (pReadData == NULL) {
+        return FS_ERROR;
+    }
+
+    result = fs_memory_stream_init_write(NULL, &stream);
+    if (result != FS_SUCCESS) {
+        fs_free(pReadData, NULL);
+        return FS_ERROR;
+    }
+
+    zipConfig = fs_zip_config_init();
+    zipConfig.write            = FS_TRUE;
+    zipConfig.compressionLevel = 6;
+
+    archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+    result = fs_init(&archiveConfig, &pArchive);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the archive for writing (%d).\n", pTest->name, result);
+        fs_memory_stream_uninit(&stream);
+        fs_free(pReadData, NULL);
+        return FS_ERROR;
+    }
+
+    for (iPattern = 0; iPattern < FS_TEST_INFLATE_PATTERN_COUNT; iPattern += 1) {
+        pData[iPattern] = (fs_uint8*)fs_malloc(dataSize[iPattern], NULL);
+        if (pData[iPattern] == NULL) {
+            errorCount += 1;
+            continue;
+        }
+
+        fs_test_archives_inflate_patterns_make_data(iPattern, pData[iPattern], dataSize[iPattern]);
+
+        fs_snprintf(path, sizeof(path), "%d.bin", iPattern);
+        result = fs_file_open(pArchive, path, FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result == FS_SUCCESS) {
+            fs_file_write(pFile, pData[iPattern], dataSize[iPattern], NULL);
+            fs_file_close(pFile);
+        } else {
+            printf("%s: Failed to open %s for writing (%d).\n", pTest->name, path, result);
+            errorCount += 1;
+        }
+    }
+
+    fs_uninit(pArchive);
+
+    pArchiveData = fs_memory_stream_take_ownership(&stream, &archiveDataSize);
+    fs_memory_stream_uninit(&stream);
+
+    for (iCache = 0; iCache < FS_COUNTOF(compressedCacheSizes) && pArchiveData != NULL && errorCount == 0; iCache += 1) {
+        fs_memory_stream_init_readonly(pArchiveData, archiveDataSize, &stream);
+
+        zipConfig = fs_zip_config_init();
+        zipConfig.verifyChecksums     = FS_TRUE;
+        zipConfig.compressedCacheSize = compressedCacheSizes[iCache];
+
+        archiveConfig = fs_config_init(FS_ZIP, &zipConfig, &stream.base);
+
+        result = fs_init(&archiveConfig, &pArchive);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to initialize the archive for reading (%d).\n", pTest->name, result);
+            errorCount += 1;
+            break;
+        }
+
+        for (iPattern = 0; iPattern < FS_TEST_INFLATE_PATTERN_COUNT; iPattern += 1) {
+            fs_snprintf(path, sizeof(path), "%d.bin", iPattern);
+
+            for (iReadSize = 0; iReadSize < FS_COUNTOF(readSizes); iReadSize += 1) {
+                /* Reading one byte at a time is slow so only do it for the file that's all about the cache wrapping around. */
+                if (readSizes[iReadSize] == 1 && iPattern != 3) {
+                    continue;
+                }
+
+                if (readSizes[iReadSize] > 0) {
+                    if (fs_test_archives_inflate_patterns_check(pTest, pArchive, path, pData[iPattern], dataSize[iPattern], readSizes[iReadSize], pReadData) != FS_SUCCESS) {
+                        errorCount += 1;
+                    }
+                } else {
+                    for (extra = 0; extra <= 8; extra += 1) {
+                        if (fs_test_archives_inflate_patterns_check(pTest, pArchive, path, pData[iPattern], dataSize[iPattern], dataSize[iPattern] + extra, pReadData) != FS_SUCCESS) {
+                            errorCount += 1;
+                        }
+                    }
+                }
+            }
+        }
+
+        fs_uninit(pArchive);
+    }
+
+    errorCount += fs_test_archives_inflate_patterns_deflate64(pTest, pReadData);
+
+    for (iPattern = 0; iPattern < FS_TEST_INFLATE_PATTERN_COUNT; iPattern += 1) {
+        fs_free(pData[iPattern], NULL);
+    }
+
+    fs_free(pArchiveData, NULL);
+    fs_free(pReadData, NULL);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END archives_inflate_patterns */
+
+/* BEG archives_uninit */
+int fs_test_archives_uninit(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_result result;
+
+    /* Clean up the entire temp folder. */
+    result = fs_test_system_remove_directory(pTest, pTestState->pTempDir);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to remove temp directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    fs_uninit(pTestState->pFS);
+    return FS_SUCCESS;
+}
+/* END archive_uninit */
+
+/* BEG mem_init */
+int fs_test_mem_init(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs_result result;
+    fs_config fsConfig;
+    fs* pFS;
+    fs_file_info info;
+
+    /* Initialize fs_mem backend. */
+    fsConfig = fs_config_init(FS_MEM, NULL, NULL);
+
+    result = fs_init(&fsConfig, &pFS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize fs_mem file system.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    pTestState->pFS = pFS;
+
+    /* Verify root directory exists and is accessible. */
+    result = fs_info(pFS, "/", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS || !info.directory) {
+        printf("%s: Root directory is not accessible.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_init */
+
+/* BEG mem_mkdir */
+int fs_test_mem_mkdir(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file_info info;
+
+    /* Create nested directory structure. */
+    result = fs_mkdir(pFS, "/testdir", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to create /testdir.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    result = fs_mkdir(pFS, "/testdir/subdir1", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to create /testdir/subdir1.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    result = fs_mkdir(pFS, "/testdir/subdir2", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to create /testdir/subdir2.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    result = fs_mkdir(pFS, "/testdir/subdir1/nested", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to create /testdir/subdir1/nested.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Verify directories exist and have correct properties. */
+    result = fs_info(pFS, "/testdir", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS || !info.directory) {
+        printf("%s: /testdir does not exist or is not a directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    result = fs_info(pFS, "/testdir/subdir1/nested", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS || !info.directory) {
+        printf("%s: Nested directory does not exist or is not a directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Test duplicate directory creation fails. */
+    result = fs_mkdir(pFS, "/testdir", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result == FS_SUCCESS) {
+        printf("%s: Duplicate directory creation should have failed.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Test error condition: Try to mkdir with file as parent (requires a file to exist first). */
+    /* Create a temporary file for this test. */
+    {
+        fs_file* pFile;
+        result = fs_file_open(pFS, "/testdir/temp_file_for_mkdir_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result == FS_SUCCESS) {
+            fs_file_close(pFile);
+            
+            /* Now try to mkdir with this file as parent. */
+            result = fs_mkdir(pFS, "/testdir/temp_file_for_mkdir_test.txt/subdir", FS_WRITE | FS_IGNORE_MOUNTS);
+            if (result == FS_SUCCESS) {
+                printf("%s: Creating directory with file as parent should have failed.\n", pTest->name);
+                return FS_ERROR;
+            }
+            
+            /* Clean up the temp file. */
+            fs_remove(pFS, "/testdir/temp_file_for_mkdir_test.txt", FS_WRITE | FS_IGNORE_MOUNTS);
+        }
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_mkdir */
+
+/* BEG mem_write */
+int fs_test_mem_write(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+
+    /* This is just a container test - actual write tests are in sub-tests. */
+    (void)pTestState;
+    return FS_SUCCESS;
+}
+/* END mem_write */
+
+/* BEG mem_write_new */
+int fs_test_mem_write_new(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    const char* testContent = "Hello, Memory File System!";
+    fs_file_info info;
+
+    result = fs_test_open_and_write_file(pTest, pFS, "/testdir/test_new.txt", FS_WRITE | FS_IGNORE_MOUNTS, testContent, strlen(testContent));
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    /* Verify file exists and has correct size. */
+    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS) {
+        printf("%s: Created file does not exist.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    if (info.directory || (unsigned int)info.size != strlen(testContent)) {
+        printf("%s: Created file has incorrect properties (directory=%d, size=%u, expected=%u).\n", pTest->name, info.directory, (unsigned int)info.size, (unsigned int)strlen(testContent));
+        return FS_ERROR;
+    }
+
+    /* Test error condition: Try to create file in non-existent directory - should fail. */
+    {
+        fs_file* pFile;
+        result = fs_file_open(pFS, "/completely_nonexistent_dir/file.txt", FS_WRITE | FS_IGNORE_MOUNTS | FS_NO_CREATE_DIRS, &pFile);
+        if (result == FS_SUCCESS) {
+            fs_file_close(pFile);
+            printf("%s: Creating file in non-existent directory should have failed (result=%d).\n", pTest->name, result);
+            return FS_ERROR;
+        }
+
+        /* Verify the expected error is FS_DOES_NOT_EXIST. */
+        if (result != FS_DOES_NOT_EXIST) {
+            printf("%s: Expected FS_DOES_NOT_EXIST (%d) but got %d when creating file in non-existent directory.\n", pTest->name, FS_DOES_NOT_EXIST, result);
+            return FS_ERROR;
+        }
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_write_new */
+
+/* BEG mem_write_overwrite */
+int fs_test_mem_write_overwrite(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    const char* originalContent = "Hello, Memory File System!";
+    const char* newContent = "Overwritten content!";
+    fs_file_info info;
+
+    /* First write the original content to ensure we have a baseline. */
+    result = fs_test_open_and_write_file(pTest, pFS, "/testdir/overwrite_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, originalContent, strlen(originalContent));
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    /* Overwrite the file with new content. */
+    result = fs_test_open_and_write_file(pTest, pFS, "/testdir/overwrite_test.txt", FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, newContent, strlen(newContent));
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    /* Verify file has new size. */
+    result = fs_info(pFS, "/testdir/overwrite_test.txt", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS || (unsigned int)info.size != strlen(newContent)) {
+        printf("%s: Overwritten file has incorrect size (got=%u, expected=%u).\n", pTest->name, (unsigned int)info.size, (unsigned int)strlen(newContent));
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_write_overwrite */
+
+/* BEG mem_write_append */
+int fs_test_mem_write_append(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    const char* appendContent = " Appended!";
+    size_t originalSize;
+    fs_file_info info;
+    size_t bytesWritten;
+
+    /* Get current file size. */
+    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS) {
+        printf("%s: Cannot get file info for append test.\n", pTest->name);
+        return FS_ERROR;
+    }
+    originalSize = (size_t)info.size;
+
+    /* Open file in append mode. */
+    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_WRITE | FS_APPEND | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file in append mode.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Write additional content. */
+    result = fs_file_write(pFile, appendContent, strlen(appendContent), &bytesWritten);
+    if (result != FS_SUCCESS || bytesWritten != strlen(appendContent)) {
+        printf("%s: Failed to write in append mode.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+
+    /* Verify total size. */
+    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS || (unsigned int)info.size != originalSize + strlen(appendContent)) {
+        printf("%s: Appended file has incorrect size (got=%u, expected=%u).\n", pTest->name, (unsigned int)info.size, (unsigned int)(originalSize + strlen(appendContent)));
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_write_append */
+
+/* BEG mem_write_exclusive */
+int fs_test_mem_write_exclusive(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    const char* content = "Exclusive content";
+    size_t bytesWritten;
+
+    /* Try to create exclusive file that already exists - should fail. */
+    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_WRITE | FS_EXCLUSIVE | FS_IGNORE_MOUNTS, &pFile);
+    if (result == FS_SUCCESS) {
+        fs_file_close(pFile);
+        printf("%s: Exclusive open of existing file should have failed.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Create new file with exclusive flag - should succeed. */
+    result = fs_file_open(pFS, "/testdir/exclusive_test.txt", FS_WRITE | FS_EXCLUSIVE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Exclusive creation of new file failed.\n", pTest->name);
+        return FS_ERROR;
+    }
+    result = fs_file_write(pFile, content, strlen(content), &bytesWritten);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to write to exclusive file.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+
+    return FS_SUCCESS;
+}
+/* END mem_write_exclusive */
+
+/* BEG mem_write_truncate */
+int fs_test_mem_write_truncate(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    fs_int64 cursor;
+    const char* newContent = "Truncated and rewritten";
+    size_t bytesWritten;
+    fs_file_info info;
+
+    /* Open existing file with truncate flag. */
+    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file with truncate flag.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* File should be empty now. */
+    result = fs_file_tell(pFile, &cursor);
+    if (result != FS_SUCCESS || cursor != 0) {
+        printf("%s: File cursor should be at 0 after truncate.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    /* Write new content. */
+    result = fs_file_write(pFile, newContent, strlen(newContent), &bytesWritten);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to write after truncate.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+
+    /* Verify final size. */
+    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS || info.size != strlen(newContent)) {
+        printf("%s: Truncated file has incorrect size.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_write_truncate */
+
+/* BEG mem_write_seek */
+int fs_test_mem_write_seek(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    size_t bytesWritten;
+
+    /* Create a file for seek testing. */
+    result = fs_test_open_and_write_file(pTest, pFS, "/testdir/seek_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, "0123456789", 10);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    /* Open for read/write and test seeking. */
+    result = fs_file_open(pFS, "/testdir/seek_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file for seek test.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Seek to position 5 and write. */
+    result = fs_file_seek(pFile, 5, FS_SEEK_SET);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to seek to position 5.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    result = fs_file_write(pFile, "ABC", 3, &bytesWritten);
+    if (result != FS_SUCCESS || bytesWritten != 3) {
+        printf("%s: Failed to write at seek position.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+
+    /* Verify the result by reading back. */
+    result = fs_test_open_and_read_file(pTest, pFS, "/testdir/seek_test.txt", FS_READ | FS_IGNORE_MOUNTS, "01234ABC89", 10);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    /* Test invalid seek (negative position). */
+    result = fs_file_open(pFS, "/testdir/seek_test.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file for seek test.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    result = fs_file_seek(pFile, -10, FS_SEEK_SET);
+    if (result == FS_SUCCESS) {
+        printf("%s: Seeking to negative position should have failed.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+
+    /* Test edge case: Seek beyond file end and write (sparse file behavior). */
+    result = fs_file_open(pFS, "/testdir/sparse_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to create file for sparse test.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Seek to position 100 (beyond end of empty file). */
+    result = fs_file_seek(pFile, 100, FS_SEEK_SET);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to seek beyond file end.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    /* Write at position 100 - should create a sparse-like effect. */
+    result = fs_file_write(pFile, "test", 4, &bytesWritten);
+    if (result != FS_SUCCESS || bytesWritten != 4) {
+        printf("%s: Failed to write at seek position 100.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+    fs_file_close(pFile);
+
+    /* Verify file size is now 104. */
+    {
+        fs_file_info info;
+        result = fs_info(pFS, "/testdir/sparse_test.txt", FS_IGNORE_MOUNTS, &info);
+        if (result != FS_SUCCESS || info.size != 104) {
+            printf("%s: File size should be 104 after sparse write, got %u.\n", pTest->name, (unsigned int)info.size);
+            return FS_ERROR;
+        }
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_write_seek */
+
+/* BEG mem_read_write_at */
+int fs_test_mem_read_write_at(fs_test* pTest)
+{
+    /* The memory backend has no native positional functions so this tests the emulated path. */
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+
+    return fs_test_positional_internal(pTest, pTestState->pFS, "/testdir/positional.txt");
+}
+/* END mem_read_write_at */
+
+/* BEG mem_map */
+int fs_test_mem_map(fs_test* pTest)
+{
+    /* The memory backend hands out a pointer straight to the content of the file. */
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+
+    return fs_test_map_internal(pTest, pTestState->pFS, "/testdir/mapped.txt", "/testdir/mapped_empty.txt");
+}
+/* END mem_map */
+
+/* BEG mem_write_truncate2 */
+int fs_test_mem_write_truncate2(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    fs_file_info info;
+
+    /* Open the seek test file and truncate it using fs_file_truncate(). */
+    result = fs_file_open(pFS, "/testdir/seek_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file for truncate test.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Seek to position 5 and truncate there. */
+    result = fs_file_seek(pFile, 5, FS_SEEK_SET);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to seek for truncate test.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    result = fs_file_truncate(pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to truncate file.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+
+    /* Verify truncated size. */
+    result = fs_info(pFS, "/testdir/seek_test.txt", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS || info.size != 5) {
+        printf("%s: Truncated file has incorrect size (got=%u, expected=5).\n", pTest->name, (unsigned int)info.size);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_write_truncate2 */
+
+/* BEG mem_write_flush */
+int fs_test_mem_write_flush(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    size_t bytesWritten;
+
+    /* For memory backend, flush is essentially a no-op, but we should test it doesn't fail. */
+    result = fs_file_open(pFS, "/testdir/flush_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file for flush test.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    result = fs_file_write(pFile, "test", 4, &bytesWritten);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to write for flush test.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    result = fs_file_flush(pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to flush file.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+
+    return FS_SUCCESS;
+}
+/* END mem_write_flush */
+
+/* BEG mem_read */
+int fs_test_mem_read(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+
+    /* Read back the truncated content from the seek test. */
+    result = fs_test_open_and_read_file(pTest, pFS, "/testdir/seek_test.txt", FS_READ | FS_IGNORE_MOUNTS, "01234", 5);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    /* Test reading the overwrite test file. */
+    result = fs_test_open_and_read_file(pTest, pFS, "/testdir/overwrite_test.txt", FS_READ | FS_IGNORE_MOUNTS, "Overwritten content!", 20);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    /* Test reading the exclusive test file. */
+    result = fs_test_open_and_read_file(pTest, pFS, "/testdir/exclusive_test.txt", FS_READ | FS_IGNORE_MOUNTS, "Exclusive content", 17);
+    if (result != FS_SUCCESS) {
+        return FS_ERROR;
+    }
+
+    /* Test error condition: Try to open directory as file - should fail. */
+    {
+        fs_file* pFile;
+        result = fs_file_open(pFS, "/testdir", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+        if (result == FS_SUCCESS) {
+            fs_file_close(pFile);
+            printf("%s: Opening directory as file should have failed.\n", pTest->name);
+            return FS_ERROR;
+        }
+    }
+
+    /* Test edge case: Zero-byte file operations. */
+    {
+        fs_file* pFile;
+        fs_file_info info;
+        char buffer[10];
+        size_t bytesRead;
+        
+        /* Create empty file. */
+        result = fs_file_open(pFS, "/testdir/empty.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to create empty file.\n", pTest->name);
+            return FS_ERROR;
+        }
+        fs_file_close(pFile);
+
+        /* Verify empty file has size 0. */
+        result = fs_info(pFS, "/testdir/empty.txt", FS_IGNORE_MOUNTS, &info);
+        if (result != FS_SUCCESS || info.size != 0) {
+            printf("%s: Empty file should have size 0, got %u.\n", pTest->name, (unsigned int)info.size);
+            return FS_ERROR;
+        }
+
+        /* Read from empty file. */
+        result = fs_file_open(pFS, "/testdir/empty.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open empty file for reading.\n", pTest->name);
+            return FS_ERROR;
+        }
+
+        result = fs_file_read(pFile, buffer, sizeof(buffer), &bytesRead);
+        if (result != FS_AT_END || bytesRead != 0) {
+            printf("%s: Reading from empty file should return FS_AT_END with 0 bytes.\n", pTest->name);
+            fs_file_close(pFile);
+            return FS_ERROR;
+        }
+        fs_file_close(pFile);
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_read */
+
+/* BEG mem_read_readonly */
+int fs_test_mem_read_readonly(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    size_t bytesWritten;
+
+    /* Open file in read-only mode. */
+    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file in read-only mode.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Try to write - should fail. */
+    result = fs_file_write(pFile, "test", 4, &bytesWritten);
+    if (result == FS_SUCCESS) {
+        printf("%s: Writing to read-only file should have failed.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+
+    return FS_SUCCESS;
+}
+/* END mem_read_readonly */
+
+/* BEG mem_read_noexist */
+int fs_test_mem_read_noexist(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+
+    /* Try to open non-existent file. */
+    result = fs_file_open(pFS, "/testdir/nonexistent.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    if (result == FS_SUCCESS) {
+        fs_file_close(pFile);
+        printf("%s: Opening non-existent file should have failed.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Check that the error is the expected one. */
+    if (result != FS_DOES_NOT_EXIST) {
+        printf("%s: Expected FS_DOES_NOT_EXIST but got %d.\n", pTest->name, result);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_read_noexist */
+
+/* BEG mem_duplicate */
+int fs_test_mem_duplicate(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    fs_file* pDuplicate;
+    char buffer1[32], buffer2[32];
+    size_t bytesRead1, bytesRead2;
+
+    /* Open a file. */
+    result = fs_file_open(pFS, "/testdir/test_new.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file for duplication test.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Duplicate the file handle. */
+    result = fs_file_duplicate(pFile, &pDuplicate);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to duplicate file handle.\n", pTest->name);
+        fs_file_close(pFile);
+        return FS_ERROR;
+    }
+
+    /* Read from both handles. */
+    
+    result = fs_file_read(pFile, buffer1, sizeof(buffer1), &bytesRead1);
+    if (result != FS_SUCCESS && result != FS_AT_END) {
+        printf("%s: Failed to read from original file handle.\n", pTest->name);
+        fs_file_close(pFile);
+        fs_file_close(pDuplicate);
+        return FS_ERROR;
+    }
+
+    /* Reset cursor on duplicate and read. */
+    result = fs_file_seek(pDuplicate, 0, FS_SEEK_SET);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to seek duplicate handle.\n", pTest->name);
+        fs_file_close(pFile);
+        fs_file_close(pDuplicate);
+        return FS_ERROR;
+    }
+
+    result = fs_file_read(pDuplicate, buffer2, sizeof(buffer2), &bytesRead2);
+    if (result != FS_SUCCESS && result != FS_AT_END) {
+        printf("%s: Failed to read from duplicate file handle.\n", pTest->name);
+        fs_file_close(pFile);
+        fs_file_close(pDuplicate);
+        return FS_ERROR;
+    }
+
+    /* Compare the reads. */
+    if (bytesRead1 != bytesRead2 || memcmp(buffer1, buffer2, bytesRead1) != 0) {
+        printf("%s: Original and duplicate file handles returned different content.\n", pTest->name);
+        fs_file_close(pFile);
+        fs_file_close(pDuplicate);
+        return FS_ERROR;
+    }
+
+    fs_file_close(pFile);
+    fs_file_close(pDuplicate);
+
+    /* Test edge case: Multiple file handles to same file. */
+    {
+        fs_file* pFile1;
+        fs_file* pFile2;
+        char readBuffer[10];
+        size_t bytesRead;
+        size_t bytesWritten;
+        
+        result = fs_file_open(pFS, "/testdir/multihandle.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile1);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open file for multi-handle test.\n", pTest->name);
+            return FS_ERROR;
+        }
+
+        result = fs_file_open(pFS, "/testdir/multihandle.txt", FS_READ | FS_IGNORE_MOUNTS, &pFile2);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to open second handle to same file.\n", pTest->name);
+            fs_file_close(pFile1);
+            return FS_ERROR;
+        }
+
+        /* Write with first handle. */
+        result = fs_file_write(pFile1, "handle1", 7, &bytesWritten);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to write with first handle.\n", pTest->name);
+            fs_file_close(pFile1);
+            fs_file_close(pFile2);
+            return FS_ERROR;
+        }
+
+        /* Read with second handle should see the data. */
+        result = fs_file_read(pFile2, readBuffer, 7, &bytesRead);
+        if (result != FS_SUCCESS || bytesRead != 7 || memcmp(readBuffer, "handle1", 7) != 0) {
+            printf("%s: Second handle should see data written by first handle.\n", pTest->name);
+            fs_file_close(pFile1);
+            fs_file_close(pFile2);
+            return FS_ERROR;
+        }
+
+        fs_file_close(pFile1);
+        fs_file_close(pFile2);
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_duplicate */
+
+/* BEG mem_iteration */
+int fs_test_mem_iteration(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_iterator* pIterator;
+    int fileCount = 0;
+    int dirCount = 0;
+    int expectedFiles = 0;
+    fs_file_info info;
+    char fullPath[512];
+    const char* expectedFileNames[] = {
+        "/testdir/test_new.txt",
+        "/testdir/overwrite_test.txt", 
+        "/testdir/exclusive_test.txt",
+        "/testdir/seek_test.txt",
+        "/testdir/flush_test.txt"
+    };
+    int i;
+    
+    /* Count expected files by checking what exists */
+    for (i = 0; i < 5; i += 1) {
+        result = fs_info(pFS, expectedFileNames[i], FS_IGNORE_MOUNTS, &info);
+        if (result == FS_SUCCESS && !info.directory) {
+            expectedFiles += 1;
+        }
+    }
+
+    /* Iterate through /testdir. */
+    pIterator = fs_first(pFS, "/testdir", FS_IGNORE_MOUNTS);
+    if (pIterator == NULL) {
+        printf("%s: Failed to start directory iteration.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    while (pIterator != NULL) {
+        if (pIterator->info.directory) {
+            dirCount += 1;
+        } else {
+            fileCount += 1;
+        }
+        
+        /* Verify we can get info for each item. */
+        fs_snprintf(fullPath, sizeof(fullPath), "/testdir/%s", pIterator->pName);
+        
+        result = fs_info(pFS, fullPath, FS_IGNORE_MOUNTS, &info);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to get info for iterated item %s.\n", pTest->name, pIterator->pName);
+            return FS_ERROR;
+        }
+
+        if (info.directory != pIterator->info.directory) {
+            printf("%s: Iterator and info disagree on directory status for %s.\n", pTest->name, pIterator->pName);
+            return FS_ERROR;
+        }
+
+        pIterator = fs_next(pIterator);
+    }
+
+    /* We should have found at least 1 directory and some files. */
+    if (dirCount < 1) {
+        printf("%s: Expected at least 1 directory, found %d.\n", pTest->name, dirCount);
+        return FS_ERROR;
+    }
+
+    if (fileCount < expectedFiles) {
+        printf("%s: Expected at least %d files, found %d.\n", pTest->name, expectedFiles, fileCount);
+        return FS_ERROR;
+    }
+
+    /* Test error condition: Try to iterate a file as directory. */
+    /* Create a temporary file for this test. */
+    {
+        fs_file* pFile;
+        result = fs_file_open(pFS, "/testdir/temp_file_for_iteration_test.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result == FS_SUCCESS) {
+            fs_file_close(pFile);
+            
+            /* Now try to iterate this file as a directory. */
+            pIterator = fs_first(pFS, "/testdir/temp_file_for_iteration_test.txt", FS_IGNORE_MOUNTS);
+            if (pIterator != NULL) {
+                printf("%s: Iterating a file as directory should have failed.\n", pTest->name);
+                return FS_ERROR;
+            }
+            
+            /* Clean up the temp file. */
+            fs_remove(pFS, "/testdir/temp_file_for_iteration_test.txt", FS_WRITE | FS_IGNORE_MOUNTS);
+        }
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_iteration */
+
+/* BEG mem_rename */
+int fs_test_mem_rename(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file_info info;
+
+    /* Rename a file. */
+    result = fs_rename(pFS, "/testdir/test_new.txt", "/testdir/renamed_file.txt", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to rename file.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Verify old name doesn't exist. */
+    result = fs_info(pFS, "/testdir/test_new.txt", FS_IGNORE_MOUNTS, &info);
+    if (result == FS_SUCCESS) {
+        printf("%s: Old file name still exists after rename.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Verify new name exists. */
+    result = fs_info(pFS, "/testdir/renamed_file.txt", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS) {
+        printf("%s: New file name doesn't exist after rename.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Rename a directory. */
+    result = fs_rename(pFS, "/testdir/subdir2", "/testdir/renamed_dir", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to rename directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Verify directory rename worked. */
+    result = fs_info(pFS, "/testdir/renamed_dir", FS_IGNORE_MOUNTS, &info);
+    if (result != FS_SUCCESS || !info.directory) {
+        printf("%s: Renamed directory doesn't exist or is not a directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Test error condition: Try to rename root directory - should fail. */
+    result = fs_rename(pFS, "/", "/newroot", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result == FS_SUCCESS) {
+        printf("%s: Renaming root directory should have failed.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_rename */
+
+/* BEG mem_remove */
+int fs_test_mem_remove(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file_info info;
+
+    /* Remove a file. */
+    result = fs_remove(pFS, "/testdir/flush_test.txt", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to remove file.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Verify file is gone. */
+    result = fs_info(pFS, "/testdir/flush_test.txt", FS_IGNORE_MOUNTS, &info);
+    if (result == FS_SUCCESS) {
+        printf("%s: File still exists after removal.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Try to remove non-empty directory - should fail. */
+    result = fs_remove(pFS, "/testdir/subdir1", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result == FS_SUCCESS) {
+        printf("%s: Removing non-empty directory should have failed.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Remove nested directory first. */
+    result = fs_remove(pFS, "/testdir/subdir1/nested", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to remove nested directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Now remove the parent directory. */
+    result = fs_remove(pFS, "/testdir/subdir1", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to remove empty directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Remove the renamed empty directory. */
+    result = fs_remove(pFS, "/testdir/renamed_dir", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to remove renamed directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    /* Test error condition: Try to remove root directory - should fail. */
+    result = fs_remove(pFS, "/", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result == FS_SUCCESS) {
+        printf("%s: Removing root directory should have failed.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_remove */
+
+/* BEG mem_edge_cases */
+int fs_test_mem_edge_cases(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    
+    /* This test function previously contained various edge case tests */
+    /* that have been moved to their more appropriate test functions. */
+    /* Keeping this function for now to maintain test structure. */
+    (void)pTestState;
+    
+    return FS_SUCCESS;
+}
+/* END mem_edge_cases */
+
+/* BEG mem_stress_test */
+int fs_test_mem_stress_test(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    char filename[64];
+    char content[32];
+    int i;
+
+    /* Create many files in one directory. */
+    for (i = 0; i < 50; i += 1) {
+        fs_snprintf(filename, sizeof(filename), "/testdir/stress_%03d.txt", i);
+        fs_snprintf(content, sizeof(content), "File number %d content", i);
+        
+        result = fs_test_open_and_write_file(pTest, pFS, filename, FS_WRITE | FS_IGNORE_MOUNTS, content, strlen(content));
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to create stress test file %d.\n", pTest->name, i);
+            return FS_ERROR;
+        }
+    }
+
+    /* Verify all files exist and have correct content. */
+    for (i = 0; i < 50; i += 1) {
+        fs_snprintf(filename, sizeof(filename), "/testdir/stress_%03d.txt", i);
+        fs_snprintf(content, sizeof(content), "File number %d content", i);
+        
+        result = fs_test_open_and_read_file(pTest, pFS, filename, FS_READ | FS_IGNORE_MOUNTS, content, strlen(content));
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to verify stress test file %d.\n", pTest->name, i);
+            return FS_ERROR;
+        }
+    }
+
+    /* Create deep directory structure. */
+    {
+        char deepPath[256] = "/testdir";
+        for (i = 0; i < 10; i += 1) {
+            fs_snprintf(deepPath, sizeof(deepPath), "%s/level%d", deepPath, i);
+            
+            result = fs_mkdir(pFS, deepPath, FS_WRITE | FS_IGNORE_MOUNTS);
+            if (result != FS_SUCCESS) {
+                printf("%s: Failed to create deep directory level %d.\n", pTest->name, i);
+                return FS_ERROR;
+            }
+        }
+
+        /* Create a file in the deepest directory. */
+        fs_strncat_s(deepPath, sizeof(deepPath), "/deep_file.txt", sizeof(deepPath) - strlen(deepPath) - 1);
+        result = fs_test_open_and_write_file(pTest, pFS, deepPath, FS_WRITE | FS_IGNORE_MOUNTS, "deep content", 12);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to create file in deep directory.\n", pTest->name);
+            return FS_ERROR;
+        }
+
+        /* Verify the deep file. */
+        result = fs_test_open_and_read_file(pTest, pFS, deepPath, FS_READ | FS_IGNORE_MOUNTS, "deep content", 12);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to read file from deep directory.\n", pTest->name);
+            return FS_ERROR;
+        }
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_stress_test */
+
+/* BEG mem_large_directory */
+int fs_test_mem_large_directory(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+    fs_result result;
+    fs_file* pFile;
+    fs_file_info info;
+    fs_iterator* pIterator;
+    char path[64];
+    char newPath[64];
+    int fileCount = 2000;
+    int iterationCount;
+    int i;
+
+    /* Enough files that the directory switches over to a hash table for finding children. */
+    result = fs_mkdir(pFS, "/testdir/large", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to create directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    for (i = 0; i < fileCount; i += 1) {
+        fs_snprintf(path, sizeof(path), "/testdir/large/file_%d", i);
+
+        result = fs_file_open(pFS, path, FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to create file %d.\n", pTest->name, i);
+            return FS_ERROR;
+        }
+
+        fs_file_close(pFile);
+    }
+
+    /* Remove every third file and rename every fifth file that remains. */
+    for (i = 0; i < fileCount; i += 1) {
+        fs_snprintf(path, sizeof(path), "/testdir/large/file_%d", i);
+
+        if ((i % 3) == 0) {
+            result = fs_remove(pFS, path, FS_WRITE | FS_IGNORE_MOUNTS);
+            if (result != FS_SUCCESS) {
+                printf("%s: Failed to remove file %d.\n", pTest->name, i);
+                return FS_ERROR;
+            }
+        } else if ((i % 5) == 0) {
+            fs_snprintf(newPath, sizeof(newPath), "/testdir/large/renamed_%d", i);
+
+            result = fs_rename(pFS, path, newPath, FS_WRITE | FS_IGNORE_MOUNTS);
+            if (result != FS_SUCCESS) {
+                printf("%s: Failed to rename file %d.\n", pTest->name, i);
+                return FS_ERROR;
+            }
+        }
+    }
+
+    /* Every name must resolve to exactly what's left. */
+    for (i = 0; i < fileCount; i += 1) {
+        fs_snprintf(path,    sizeof(path),    "/testdir/large/file_%d",    i);
+        fs_snprintf(newPath, sizeof(newPath), "/testdir/large/renamed_%d", i);
+
+        result = fs_info(pFS, path, FS_IGNORE_MOUNTS, &info);
+        if ((result == FS_SUCCESS) != ((i % 3) != 0 && (i % 5) != 0)) {
+            printf("%s: Unexpected result looking up \"%s\".\n", pTest->name, path);
+            return FS_ERROR;
+        }
+
+        result = fs_info(pFS, newPath, FS_IGNORE_MOUNTS, &info);
+        if ((result == FS_SUCCESS) != ((i % 3) != 0 && (i % 5) == 0)) {
+            printf("%s: Unexpected result looking up \"%s\".\n", pTest->name, newPath);
+            return FS_ERROR;
+        }
+    }
+
+    /* Iteration must see each remaining file exactly once. */
+    iterationCount = 0;
+    for (pIterator = fs_first(pFS, "/testdir/large", FS_IGNORE_MOUNTS); pIterator != NULL; pIterator = fs_next(pIterator)) {
+        iterationCount += 1;
+    }
+
+    if (iterationCount != fileCount - ((fileCount + 2) / 3)) {
+        printf("%s: Expected %d files when iterating, but got %d.\n", pTest->name, fileCount - ((fileCount + 2) / 3), iterationCount);
+        return FS_ERROR;
+    }
+
+    /* Clean up so the directory can be removed. */
+    for (i = 0; i < fileCount; i += 1) {
+        if ((i % 3) == 0) {
+            continue;
+        }
+
+        if ((i % 5) == 0) {
+            fs_snprintf(path, sizeof(path), "/testdir/large/renamed_%d", i);
+        } else {
+            fs_snprintf(path, sizeof(path), "/testdir/large/file_%d", i);
+        }
+
+        result = fs_remove(pFS, path, FS_WRITE | FS_IGNORE_MOUNTS);
+        if (result != FS_SUCCESS) {
+            printf("%s: Failed to remove \"%s\".\n", pTest->name, path);
+            return FS_ERROR;
+        }
+    }
+
+    result = fs_remove(pFS, "/testdir/large", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to remove directory.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_large_directory */
+
+/* BEG mem_chunked */
+static int fs_test_mem_chunked_compare(fs_test* pTest, fs_file* pFile, const unsigned char* pExpected, size_t expectedSize)
+{
+    fs_result result;
+    fs_file_info info;
+    unsigned char buffer[256];
+    size_t bytesRead;
+
+    result = fs_file_get_info(pFile, &info);
+    if (result != FS_SUCCESS || info.size != expectedSize) {
+        printf("%s: Expected a size of %u.\n", pTest->name, (unsigned int)expectedSize);
+        return FS_ERROR;
+    }
+
+    /* Read from an offset that doesn't line up with a chunk. */
+    result = fs_file_read_at(pFile, 3, buffer, sizeof(buffer), &bytesRead);
+    if (result != FS_SUCCESS || bytesRead != expectedSize - 3 || memcmp(buffer, pExpected + 3, bytesRead) != 0) {
+        printf("%s: Content does not match.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    return FS_SUCCESS;
+}
+
+int fs_test_mem_chunked(fs_test* pTest)
+{
+    fs_result result;
+    fs_mem_config memConfig;
+    fs_config fsConfig;
+    fs* pFS;
+    fs_file* pFile;
+    unsigned char expected[256];
+    unsigned char data[100];
+    const void* pMappedData;
+    size_t mappedDataSize;
+    size_t expectedSize = 0;
+    int errorCount = 0;
+    size_t i;
+
+    /* A tiny chunk size so that everything crosses chunk boundaries. */
+    memConfig = fs_mem_config_init();
+    memConfig.chunkSize = 16;
+
+    fsConfig = fs_config_init(FS_MEM, &memConfig, NULL);
+
+    result = fs_init(&fsConfig, &pFS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize fs_mem file system.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    for (i = 0; i < sizeof(data); i += 1) {
+        data[i] = (unsigned char)(i + 1);
+    }
+
+    FS_ZERO_MEMORY(expected, sizeof(expected));
+
+    result = fs_file_open(pFS, "/chunked.bin", FS_READ | FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to open file.\n", pTest->name);
+        fs_uninit(pFS);
+        return FS_ERROR;
+    }
+
+    /* Appends in pieces that don't line up with the chunks. */
+    for (i = 0; i < 5; i += 1) {
+        result = fs_file_write(pFile, data, 13, NULL);
+        if (result != FS_SUCCESS) {
+            errorCount += 1;
+        }
+
+        FS_COPY_MEMORY(expected + expectedSize, data, 13);
+        expectedSize += 13;
+    }
+
+    if (errorCount > 0 || fs_test_mem_chunked_compare(pTest, pFile, expected, expectedSize) != FS_SUCCESS) {
+        printf("%s: Appending failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* A partial overwrite across two chunks. */
+    result = fs_file_write_at(pFile, 10, data + 50, 20, NULL);
+    FS_COPY_MEMORY(expected + 10, data + 50, 20);
+
+    if (result != FS_SUCCESS || fs_test_mem_chunked_compare(pTest, pFile, expected, expectedSize) != FS_SUCCESS) {
+        printf("%s: Overwriting failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* A write well past the end leaves a hole which must read as zeros. */
+    result = fs_file_write_at(pFile, 200, data, 7, NULL);
+    FS_COPY_MEMORY(expected + 200, data, 7);
+    expectedSize = 207;
+
+    if (result != FS_SUCCESS || fs_test_mem_chunked_compare(pTest, pFile, expected, expectedSize) != FS_SUCCESS) {
+        printf("%s: Writing past the end failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* Shrinking and then growing again must not bring back the old content. */
+    result = fs_file_seek(pFile, 40, FS_SEEK_SET);
+    if (result == FS_SUCCESS) {
+        result = fs_file_truncate(pFile);
+    }
+    if (result == FS_SUCCESS) {
+        result = fs_file_seek(pFile, 150, FS_SEEK_SET);
+    }
+    if (result == FS_SUCCESS) {
+        result = fs_file_truncate(pFile);
+    }
+
+    FS_ZERO_MEMORY(expected + 40, sizeof(expected) - 40);
+    expectedSize = 150;
+
+    if (result != FS_SUCCESS || fs_test_mem_chunked_compare(pTest, pFile, expected, expectedSize) != FS_SUCCESS) {
+        printf("%s: Truncating failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /*
+    Spread across chunks so the backend returns FS_NOT_IMPLEMENTED and mapping falls back to reading
+    into memory. This is what covers the fallback in fs_file_map() now that FS_MEM supports mapping.
+    */
+    result = fs_file_map(pFile, &pMappedData, &mappedDataSize);
+    if (result != FS_SUCCESS || mappedDataSize != expectedSize || memcmp(pMappedData, expected, expectedSize) != 0 || !pFile->isMappingEmulated) {
+        printf("%s: Mapping a file spread across chunks failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_file_close(pFile);
+
+    /* A file that fits in one chunk is mapped straight from the chunk. */
+    result = fs_test_open_and_write_file(pTest, pFS, "/small.bin", FS_WRITE | FS_IGNORE_MOUNTS, data, 16);
+    if (result == FS_SUCCESS) {
+        result = fs_file_open(pFS, "/small.bin", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+        if (result == FS_SUCCESS) {
+            result = fs_file_map(pFile, &pMappedData, &mappedDataSize);
+            if (result != FS_SUCCESS || mappedDataSize != 16 || memcmp(pMappedData, data, 16) != 0 || pFile->isMappingEmulated) {
+                result = FS_ERROR;
+            }
+
+            fs_file_close(pFile);
+        }
+    }
+
+    if (result != FS_SUCCESS) {
+        printf("%s: Mapping a file in a single chunk failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* Truncating when opening should drop all of the chunks. */
+    result = fs_file_open(pFS, "/chunked.bin", FS_READ | FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, &pFile);
+    if (result == FS_SUCCESS) {
+        result = fs_file_write_at(pFile, 20, data, 4, NULL);
+
+        FS_ZERO_MEMORY(expected, sizeof(expected));
+        FS_COPY_MEMORY(expected + 20, data, 4);
+
+        if (result != FS_SUCCESS || fs_test_mem_chunked_compare(pTest, pFile, expected, 24) != FS_SUCCESS) {
+            result = FS_ERROR;
+        }
+
+        fs_file_close(pFile);
+    }
+
+    if (result != FS_SUCCESS) {
+        printf("%s: Truncating on open failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_uninit(pFS);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END mem_chunked */
+
+/* BEG mem_snapshot */
+static size_t fs_test_mem_snapshot_count(fs* pFS, const char* pDirectoryPath)
+{
+    fs_iterator* pIterator;
+    size_t count = 0;
+
+    for (pIterator = fs_first(pFS, pDirectoryPath, FS_IGNORE_MOUNTS); pIterator != NULL; pIterator = fs_next(pIterator)) {
+        count += 1;
+    }
+
+    return count;
+}
+
+static int fs_test_mem_snapshot_internal(fs_test* pTest, size_t chunkSize)
+{
+    fs_result result;
+    fs_mem_config memConfig;
+    fs_config fsConfig;
+    fs* pFS;
+    fs* pSnapshot1;
+    fs* pSnapshot2;
+    fs_iterator* pIterator;
+    fs_file* pFile;
+    fs_file_info info;
+    unsigned char data[40];
+    unsigned char modified[40];
+    unsigned char buffer[40];
+    size_t bytesRead;
+    int errorCount = 0;
+    size_t i;
+
+    memConfig = fs_mem_config_init();
+    memConfig.chunkSize = chunkSize;
+
+    fsConfig = fs_config_init(FS_MEM, &memConfig, NULL);
+
+    result = fs_init(&fsConfig, &pFS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize fs_mem file system.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    for (i = 0; i < sizeof(data); i += 1) {
+        data[i] = (unsigned char)(i + 1);
+    }
+
+    FS_COPY_MEMORY(modified, data, sizeof(data));
+    FS_COPY_MEMORY(modified + 20, "XYZ", 3);
+
+    result = fs_mkdir(pFS, "/dir", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result == FS_SUCCESS) {
+        result = fs_test_open_and_write_file(pTest, pFS, "/dir/a.bin", FS_WRITE | FS_IGNORE_MOUNTS, data, sizeof(data));
+    }
+    if (result == FS_SUCCESS) {
+        result = fs_test_open_and_write_file(pTest, pFS, "/b.txt", FS_WRITE | FS_IGNORE_MOUNTS, "hello", 5);
+    }
+    if (result == FS_SUCCESS) {
+        result = fs_test_open_and_write_file(pTest, pFS, "/gone.txt", FS_WRITE | FS_IGNORE_MOUNTS, "gone", 4);
+    }
+    if (result == FS_SUCCESS) {
+        result = fs_file_open(pFS, "/dir/a.bin", FS_READ | FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    }
+
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to set up the file system.\n", pTest->name);
+        fs_uninit(pFS);
+        return FS_ERROR;
+    }
+
+    result = fs_mem_snapshot(pFS, &pSnapshot1);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to take a snapshot.\n", pTest->name);
+        fs_file_close(pFile);
+        fs_uninit(pFS);
+        return FS_ERROR;
+    }
+
+    /* An iterator started before the directory is copied keeps seeing the old content. */
+    pIterator = fs_first(pFS, "/dir", FS_IGNORE_MOUNTS);
+
+    /* A file that was already open is copied on its first write, and must see its own change. */
+    result = fs_file_write_at(pFile, 20, "XYZ", 3, NULL);
+    if (result == FS_SUCCESS) {
+        result = fs_file_read_at(pFile, 0, buffer, sizeof(buffer), &bytesRead);
+    }
+
+    if (result != FS_SUCCESS || bytesRead != sizeof(modified) || memcmp(buffer, modified, sizeof(modified)) != 0) {
+        printf("%s: Writing to a file opened before the snapshot failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_file_close(pFile);
+
+    result = fs_mkdir(pFS, "/dir/sub", FS_WRITE | FS_IGNORE_MOUNTS);
+    if (result == FS_SUCCESS) {
+        result = fs_rename(pFS, "/b.txt", "/dir/c.txt", FS_WRITE | FS_IGNORE_MOUNTS);
+    }
+    if (result == FS_SUCCESS) {
+        result = fs_remove(pFS, "/gone.txt", FS_WRITE | FS_IGNORE_MOUNTS);
+    }
+
+    if (result != FS_SUCCESS) {
+        printf("%s: Modifying the file system after a snapshot failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* The original sees every change. */
+    if (fs_test_open_and_read_file(pTest, pFS, "/dir/a.bin", FS_READ | FS_IGNORE_MOUNTS, modified, sizeof(modified)) != FS_SUCCESS ||
+        fs_test_open_and_read_file(pTest, pFS, "/dir/c.txt", FS_READ | FS_IGNORE_MOUNTS, "hello", 5) != FS_SUCCESS ||
+        fs_info(pFS, "/b.txt", FS_IGNORE_MOUNTS, &info) != FS_DOES_NOT_EXIST ||
+        fs_info(pFS, "/gone.txt", FS_IGNORE_MOUNTS, &info) != FS_DOES_NOT_EXIST ||
+        fs_test_mem_snapshot_count(pFS, "/dir") != 3) {
+        printf("%s: The original file system does not have the expected content.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* The snapshot sees none of them. */
+    if (fs_test_open_and_read_file(pTest, pSnapshot1, "/dir/a.bin", FS_READ | FS_IGNORE_MOUNTS, data, sizeof(data)) != FS_SUCCESS ||
+        fs_test_open_and_read_file(pTest, pSnapshot1, "/b.txt", FS_READ | FS_IGNORE_MOUNTS, "hello", 5) != FS_SUCCESS ||
+        fs_test_open_and_read_file(pTest, pSnapshot1, "/gone.txt", FS_READ | FS_IGNORE_MOUNTS, "gone", 4) != FS_SUCCESS ||
+        fs_info(pSnapshot1, "/dir/c.txt", FS_IGNORE_MOUNTS, &info) != FS_DOES_NOT_EXIST ||
+        fs_test_mem_snapshot_count(pSnapshot1, "/dir") != 1) {
+        printf("%s: The snapshot does not have the expected content.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    if (pIterator == NULL || strcmp(pIterator->pName, "a.bin") != 0) {
+        printf("%s: Iterating a directory while it was being copied failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    pIterator = fs_next(pIterator);
+    if (pIterator != NULL) {
+        printf("%s: Iterating a directory while it was being copied returned too many entries.\n", pTest->name);
+        fs_free_iterator(pIterator);
+        errorCount += 1;
+    }
+
+    /* Snapshots are read-only. */
+    if (fs_mkdir(pSnapshot1, "/new", FS_WRITE | FS_IGNORE_MOUNTS) != FS_ACCESS_DENIED ||
+        fs_remove(pSnapshot1, "/b.txt", FS_WRITE | FS_IGNORE_MOUNTS) != FS_ACCESS_DENIED ||
+        fs_rename(pSnapshot1, "/b.txt", "/d.txt", FS_WRITE | FS_IGNORE_MOUNTS) != FS_ACCESS_DENIED ||
+        fs_file_open(pSnapshot1, "/b.txt", FS_WRITE | FS_IGNORE_MOUNTS, &pFile) == FS_SUCCESS) {
+        printf("%s: Modifying a snapshot did not fail.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    /* A second snapshot, after which the original is truncated and uninitialized first. */
+    result = fs_mem_snapshot(pFS, &pSnapshot2);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to take a second snapshot.\n", pTest->name);
+        fs_uninit(pSnapshot1);
+        fs_uninit(pFS);
+        return FS_ERROR;
+    }
+
+    result = fs_test_open_and_write_file(pTest, pFS, "/dir/c.txt", FS_WRITE | FS_TRUNCATE | FS_IGNORE_MOUNTS, "bye", 3);
+    if (result != FS_SUCCESS || fs_test_open_and_read_file(pTest, pFS, "/dir/c.txt", FS_READ | FS_IGNORE_MOUNTS, "bye", 3) != FS_SUCCESS) {
+        printf("%s: Truncating a file after a second snapshot failed.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_uninit(pFS);
+
+    if (fs_test_open_and_read_file(pTest, pSnapshot2, "/dir/c.txt", FS_READ | FS_IGNORE_MOUNTS, "hello", 5) != FS_SUCCESS ||
+        fs_test_open_and_read_file(pTest, pSnapshot2, "/dir/a.bin", FS_READ | FS_IGNORE_MOUNTS, modified, sizeof(modified)) != FS_SUCCESS ||
+        fs_test_open_and_read_file(pTest, pSnapshot1, "/dir/a.bin", FS_READ | FS_IGNORE_MOUNTS, data, sizeof(data)) != FS_SUCCESS) {
+        printf("%s: A snapshot changed after the original was uninitialized.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_uninit(pSnapshot1);
+    fs_uninit(pSnapshot2);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+
+int fs_test_mem_snapshot(fs_test* pTest)
+{
+    int errorCount = 0;
+
+    if (fs_test_mem_snapshot_internal(pTest, 0) != FS_SUCCESS) {
+        errorCount += 1;
+    }
+
+    /* Chunked files only copy the chunks that are written to. */
+    if (fs_test_mem_snapshot_internal(pTest, 16) != FS_SUCCESS) {
+        errorCount += 1;
+    }
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END mem_snapshot */
+
+/* BEG mem_uninit */
+int fs_test_mem_uninit(fs_test* pTest)
+{
+    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
+    fs* pFS = pTestState->pFS;
+
+    if (pFS != NULL) {
+        fs_uninit(pFS);
+        pTestState->pFS = NULL;
+    }
+
+    return FS_SUCCESS;
+}
+/* END mem_uninit */
+
+/* BEG mem_rwlock */
+/*
+Checks that fs_rwlock lets readers in together and keeps them away from a writer. This runs against
+whichever implementation the build uses. FS_USE_MANUAL_RWLOCK is defined automatically for C89
+builds, and the fs_test_manual_rwlock target forces it for the rest.
+*/
+#define FS_TEST_RWLOCK_READER_COUNT     4
+#define FS_TEST_RWLOCK_TIMEOUT          10  /* In seconds. Only used to fail instead of hanging forever. */
+
+typedef struct
+{
+    fs_rwlock lock;
+    fs_mtx counterLock;
+    int readersInside;                  /* Protected by counterLock. The number of readers that have taken the lock. */
+    int writersInside;                  /* Protected by counterLock. The number of writers that have taken the lock. */
+    int errorCount;                     /* Protected by counterLock. */
+} fs_test_rwlock_state;
+
+static int fs_test_rwlock_get_count(fs_test_rwlock_state* pState, int* pCount)
+{
+    int count;
+
+    fs_mtx_lock(&pState->counterLock);
+    count = *pCount;
+    fs_mtx_unlock(&pState->counterLock);
+
+    return count;
+}
+
+static void fs_test_rwlock_increment(fs_test_rwlock_state* pState, int* pCount)
+{
+    fs_mtx_lock(&pState->counterLock);
+    *pCount += 1;
+    fs_mtx_unlock(&pState->counterLock);
+}
+
+/*
+Keeps the CPU busy for a little while so that other threads get a chance to run even on a single
+core. There's no portable way to sleep in C89.
+*/
+static void fs_test_rwlock_spin(void)
+{
+    clock_t startTime = clock();
+
+    while (clock() - startTime < CLOCKS_PER_SEC / 20) {
+        /* Spin. */
+    }
+}
+
+static int fs_test_rwlock_reader_together(void* pUserData)
+{
+    fs_test_rwlock_state* pState = (fs_test_rwlock_state*)pUserData;
+    time_t startTime = time(NULL);
+
+    fs_rwlock_lock_read(&pState->lock);
+    {
+        fs_test_rwlock_increment(pState, &pState->readersInside);
+
+        /* Stay inside until every reader is. This can only finish if the readers share the lock. */
+        while (fs_test_rwlock_get_count(pState, &pState->readersInside) < FS_TEST_RWLOCK_READER_COUNT) {
+            if (time(NULL) - startTime > FS_TEST_RWLOCK_TIMEOUT) {
+                fs_test_rwlock_increment(pState, &pState->errorCount);
+                break;
+            }
+        }
+    }
+    fs_rwlock_unlock_read(&pState->lock);
+
+    return 0;
+}
+
+static int fs_test_rwlock_reader(void* pUserData)
+{
+    fs_test_rwlock_state* pState = (fs_test_rwlock_state*)pUserData;
+
+    fs_rwlock_lock_read(&pState->lock);
+    fs_test_rwlock_increment(pState, &pState->readersInside);
+    fs_rwlock_unlock_read(&pState->lock);
+
+    return 0;
+}
+
+static int fs_test_rwlock_writer(void* pUserData)
+{
+    fs_test_rwlock_state* pState = (fs_test_rwlock_state*)pUserData;
+
+    fs_rwlock_lock_write(&pState->lock);
+    fs_test_rwlock_increment(pState, &pState->writersInside);
+    fs_rwlock_unlock_write(&pState->lock);
+
+    return 0;
+}
+
+static int fs_test_mem_rwlock_threads(fs_test_rwlock_state* pState, fs_thrd_start_t func, int threadCount, fs_thrd* pThreads)
+{
+    int iThread;
+
+    for (iThread = 0; iThread < threadCount; iThread += 1) {
+        if (fs_thrd_create(&pThreads[iThread], func, pState, NULL) != FS_SUCCESS) {
+            break;
+        }
+    }
+
+    return iThread;
+}
+
+static void fs_test_mem_rwlock_join(fs_thrd* pThreads, int threadCount)
+{
+    int iThread;
+
+    for (iThread = 0; iThread < threadCount; iThread += 1) {
+        fs_thrd_join(pThreads[iThread], NULL);
+    }
+}
+
+int fs_test_mem_rwlock(fs_test* pTest)
+{
+    fs_test_rwlock_state state;
+    fs_thrd threads[FS_TEST_RWLOCK_READER_COUNT];
+    int threadCount;
+    int readersInside;
+    int writersInside;
+
+    memset(&state, 0, sizeof(state));
+
+    if (fs_rwlock_init(&state.lock) != FS_SUCCESS) {
+        printf("%s: Failed to initialize the lock.\n", pTest->name);
+        return FS_ERROR;
+    }
+
+    if (fs_mtx_init(&state.counterLock, fs_mtx_plain) != FS_SUCCESS) {
+        printf("%s: Failed to initialize the mutex.\n", pTest->name);
+        fs_rwlock_destroy(&state.lock);
+        return FS_ERROR;
+    }
+
+    /* Readers need to be able to hold the lock at the same time. */
+    threadCount = fs_test_mem_rwlock_threads(&state, fs_test_rwlock_reader_together, FS_TEST_RWLOCK_READER_COUNT, threads);
+    fs_test_mem_rwlock_join(threads, threadCount);
+
+    if (threadCount != FS_TEST_RWLOCK_READER_COUNT || state.errorCount > 0) {
+        printf("%s: Readers did not share the lock.\n", pTest->name);
+        state.errorCount += 1;
+    }
+
+    /* Readers need to stay out while a writer has the lock. */
+    state.readersInside = 0;
+
+    fs_rwlock_lock_write(&state.lock);
+    {
+        threadCount = fs_test_mem_rwlock_threads(&state, fs_test_rwlock_reader, FS_TEST_RWLOCK_READER_COUNT, threads);
+        fs_test_rwlock_spin();
+
+        readersInside = fs_test_rwlock_get_count(&state, &state.readersInside);
+    }
+    fs_rwlock_unlock_write(&state.lock);
+
+    fs_test_mem_rwlock_join(threads, threadCount);
+
+    if (readersInside != 0 || state.readersInside != threadCount) {
+        printf("%s: A reader took the lock while a writer had it.\n", pTest->name);
+        state.errorCount += 1;
+    }
+
+    /* A writer needs to stay out while a reader has the lock. */
+    fs_rwlock_lock_read(&state.lock);
+    {
+        threadCount = fs_test_mem_rwlock_threads(&state, fs_test_rwlock_writer, 1, threads);
+        fs_test_rwlock_spin();
+
+        writersInside = fs_test_rwlock_get_count(&state, &state.writersInside);
+    }
+    fs_rwlock_unlock_read(&state.lock);
+
+    fs_test_mem_rwlock_join(threads, threadCount);
+
+    if (writersInside != 0 || state.writersInside != threadCount) {
+        printf("%s: A writer took the lock while a reader had it.\n", pTest->name);
+        state.errorCount += 1;
+    }
+
+    /* Writers need to stay out while another writer has the lock. */
+    state.writersInside = 0;
+
+    fs_rwlock_lock_write(&state.lock);
+    {
+        threadCount = fs_test_mem_rwlock_threads(&state, fs_test_rwlock_writer, 1, threads);
+        fs_test_rwlock_spin();
+
+        writersInside = fs_test_rwlock_get_count(&state, &state.writersInside);
+    }
+    fs_rwlock_unlock_write(&state.lock);
+
+    fs_test_mem_rwlock_join(threads, threadCount);
+
+    if (writersInside != 0 || state.writersInside != threadCount) {
+        printf("%s: A writer took the lock while another writer had it.\n", pTest->name);
+        state.errorCount += 1;
+    }
+
+    fs_mtx_destroy(&state.counterLock);
+    fs_rwlock_destroy(&state.lock);
+
+    return (state.errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END mem_rwlock */
+
+/* BEG mem_threaded */
+/*
+Readers on several threads open, read and get info about files while a writer on another thread
+keeps rewriting one of them and adding and removing others. Each write replaces the whole content of
+the shared file in one call, so a reader should always see it with every byte the same.
+*/
+#define FS_TEST_MEM_THREADED_READER_COUNT   4
+#define FS_TEST_MEM_THREADED_FILE_COUNT     8
+#define FS_TEST_MEM_THREADED_FILE_SIZE      4096
+#define FS_TEST_MEM_THREADED_ITERATIONS     500
+
+typedef struct
+{
+    fs* pFS;
+    fs_mtx lock;
+    int errorCount;                     /* Protected by lock. */
+    int iReader;
+} fs_test_mem_threaded_state;
+
+static void fs_test_mem_threaded_error(fs_test_mem_threaded_state* pState, const char* pMessage)
+{
+    fs_mtx_lock(&pState->lock);
+    {
+        if (pState->errorCount == 0) {
+            printf("Memory Threaded: %s\n", pMessage);
+        }
+
+        pState->errorCount += 1;
+    }
+    fs_mtx_unlock(&pState->lock);
+}
+
+static fs_bool32 fs_test_mem_threaded_is_uniform(const fs_uint8* pData, size_t dataSize)
+{
+    size_t i;
+
+    for (i = 1; i < dataSize; i += 1) {
+        if (pData[i] != pData[0]) {
+            return FS_FALSE;
+        }
+    }
+
+    return FS_TRUE;
+}
+
+static int fs_test_mem_threaded_reader(void* pUserData)
+{
+    fs_test_mem_threaded_state* pState = (fs_test_mem_threaded_state*)pUserData;
+    fs_uint8 data[FS_TEST_MEM_THREADED_FILE_SIZE];
+    char path[64];
+    int iIteration;
+    int iFile;
+    fs_file* pFile;
+    fs_file_info info;
+    size_t bytesRead;
+
+    fs_mtx_lock(&pState->lock);
+    iFile = pState->iReader++;
+    fs_mtx_unlock(&pState->lock);
+
+    for (iIteration = 0; iIteration < FS_TEST_MEM_THREADED_ITERATIONS; iIteration += 1) {
+        /* One of the files that never changes. */
+        iFile = (iFile + 1) % FS_TEST_MEM_THREADED_FILE_COUNT;
+        fs_snprintf(path, sizeof(path), "/threaded/file%d", iFile);
+
+        if (fs_info(pState->pFS, path, FS_READ | FS_IGNORE_MOUNTS, &info) != FS_SUCCESS || info.size != FS_TEST_MEM_THREADED_FILE_SIZE) {
+            fs_test_mem_threaded_error(pState, "Incorrect info for a file that isn't being written.");
+        }
+
+        if (fs_file_open(pState->pFS, path, FS_READ | FS_IGNORE_MOUNTS, &pFile) == FS_SUCCESS) {
+            if (fs_file_read(pFile, data, sizeof(data), &bytesRead) != FS_SUCCESS || bytesRead != sizeof(data) || data[0] != (fs_uint8)('A' + iFile) || !fs_test_mem_threaded_is_uniform(data, sizeof(data))) {
+                fs_test_mem_threaded_error(pState, "Incorrect data read from a file that isn't being written.");
+            }
+
+            fs_file_close(pFile);
+        } else {
+            fs_test_mem_threaded_error(pState, "Failed to open a file that isn't being written.");
+        }
+
+        /* The file that's being written. */
+        if (fs_file_open(pState->pFS, "/threaded/shared", FS_READ | FS_IGNORE_MOUNTS, &pFile) == FS_SUCCESS) {
+            if (fs_file_read(pFile, data, sizeof(data), &bytesRead) != FS_SUCCESS || bytesRead != sizeof(data) || !fs_test_mem_threaded_is_uniform(data, sizeof(data))) {
+                fs_test_mem_threaded_error(pState, "Read part of a write to the shared file.");
+            }
+
+            fs_file_close(pFile);
+        } else {
+            fs_test_mem_threaded_error(pState, "Failed to open the shared file.");
+        }
+    }
+
+    return 0;
+}
+
+static int fs_test_mem_threaded_writer(void* pUserData)
+{
+    fs_test_mem_threaded_state* pState = (fs_test_mem_threaded_state*)pUserData;
+    fs_uint8 data[FS_TEST_MEM_THREADED_FILE_SIZE];
+    char path[64];
+    int iIteration;
+    fs_file* pSharedFile;
+    fs_file* pFile;
+
+    if (fs_file_open(pState->pFS, "/threaded/shared", FS_WRITE | FS_IGNORE_MOUNTS, &pSharedFile) != FS_SUCCESS) {
+        fs_test_mem_threaded_error(pState, "Failed to open the shared file for writing.");
+        return 0;
+    }
+
+    for (iIteration = 0; iIteration < FS_TEST_MEM_THREADED_ITERATIONS; iIteration += 1) {
+        memset(data, iIteration & 0xFF, sizeof(data));
+
+        if (fs_file_seek(pSharedFile, 0, FS_SEEK_SET) != FS_SUCCESS || fs_file_write(pSharedFile, data, sizeof(data), NULL) != FS_SUCCESS) {
+            fs_test_mem_threaded_error(pState, "Failed to write the shared file.");
+        }
+
+        /* Changes to the tree. */
+        fs_snprintf(path, sizeof(path), "/threaded/temp%d", iIteration);
+        if (fs_file_open(pState->pFS, path, FS_WRITE | FS_IGNORE_MOUNTS, &pFile) == FS_SUCCESS) {
+            fs_file_write(pFile, data, 16, NULL);
+            fs_file_close(pFile);
+        } else {
+            fs_test_mem_threaded_error(pState, "Failed to create a file.");
+        }
 
-    /* Remove a file. */
-    result = fs_remove(pFS, "/testdir/flush_test.txt", FS_WRITE | FS_IGNORE_MOUNTS);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to remove file.\n", pTest->name);
-        return FS_ERROR;
+        if ((iIteration % 2) == 1) {
+            fs_snprintf(path, sizeof(path), "/threaded/temp%d", iIteration - 1);
+            if (fs_remove(pState->pFS, path, FS_IGNORE_MOUNTS) != FS_SUCCESS) {
+                fs_test_mem_threaded_error(pState, "Failed to remove a file.");
+            }
+        }
     }
 
-    /* Verify file is gone. */
-    result = fs_info(pFS, "/testdir/flush_test.txt", FS_IGNORE_MOUNTS, &info);
-    if (result == FS_SUCCESS) {
-        printf("%s: File still exists after removal.\n", pTest->name);
-        return FS_ERROR;
-    }
+    fs_file_close(pSharedFile);
 
-    /* Try to remove non-empty directory - should fail. */
-    result = fs_remove(pFS, "/testdir/subdir1", FS_WRITE | FS_IGNORE_MOUNTS);
-    if (result == FS_SUCCESS) {
-        printf("%s: Removing non-empty directory should have failed.\n", pTest->name);
-        return FS_ERROR;
-    }
+    return 0;
+}
 
-    /* Remove nested directory first. */
-    result = fs_remove(pFS, "/testdir/subdir1/nested", FS_WRITE | FS_IGNORE_MOUNTS);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to remove nested directory.\n", pTest->name);
-        return FS_ERROR;
-    }
+int fs_test_mem_threaded(fs_test* pTest)
+{
+    fs_result result;
+    fs_config fsConfig;
+    fs_test_mem_threaded_state state;
+    fs_uint8 data[FS_TEST_MEM_THREADED_FILE_SIZE];
+    char path[64];
+    fs_thrd threads[FS_TEST_MEM_THREADED_READER_COUNT + 1];
+    int threadCount = 0;
+    int iThread;
+    int iFile;
+    size_t fileCount = 0;
+    fs_iterator* pIterator;
 
-    /* Now remove the parent directory. */
-    result = fs_remove(pFS, "/testdir/subdir1", FS_WRITE | FS_IGNORE_MOUNTS);
-    if (result != FS_SUCCESS) {
-        printf("%s: Failed to remove empty directory.\n", pTest->name);
-        return FS_ERROR;
-    }
+    memset(&state, 0, sizeof(state));
 
-    /* Remove the renamed empty directory. */
-    result = fs_remove(pFS, "/testdir/renamed_dir", FS_WRITE | FS_IGNORE_MOUNTS);
+    fsConfig = fs_config_init(FS_MEM, NULL, NULL);
+
+    result = fs_init(&fsConfig, &state.pFS);
     if (result != FS_SUCCESS) {
-        printf("%s: Failed to remove renamed directory.\n", pTest->name);
+        printf("%s: Failed to initialize fs_mem file system.\n", pTest->name);
         return FS_ERROR;
     }
 
-    /* Test error condition: Try to remove root directory - should fail. */
-    result = fs_remove(pFS, "/", FS_WRITE | FS_IGNORE_MOUNTS);
-    if (result == FS_SUCCESS) {
-        printf("%s: Removing root directory should have failed.\n", pTest->name);
+    if (fs_mtx_init(&state.lock, fs_mtx_plain) != FS_SUCCESS) {
+        fs_uninit(state.pFS);
         return FS_ERROR;
     }
 
-    return FS_SUCCESS;
-}
-/* END mem_remove */
-
-/* BEG mem_edge_cases */
-int fs_test_mem_edge_cases(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    
-    /* This test function previously contained various edge case tests */
-    /* that have been moved to their more appropriate test functions. */
-    /* Keeping this function for now to maintain test structure. */
-    (void)pTestState;
-    
-    return FS_SUCCESS;
-}
-/* END mem_edge_cases */
+    fs_mkdir(state.pFS, "/threaded", FS_IGNORE_MOUNTS);
 
-/* BEG mem_stress_test */
-int fs_test_mem_stress_test(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
-    fs_result result;
-    char filename[64];
-    char content[32];
-    int i;
+    for (iFile = 0; iFile < FS_TEST_MEM_THREADED_FILE_COUNT; iFile += 1) {
+        memset(data, 'A' + iFile, sizeof(data));
+        fs_snprintf(path, sizeof(path), "/threaded/file%d", iFile);
 
-    /* Create many files in one directory. */
-    for (i = 0; i < 50; i += 1) {
-        fs_snprintf(filename, sizeof(filename), "/testdir/stress_%03d.txt", i);
-        fs_snprintf(content, sizeof(content), "File number %d content", i);
-        
-        result = fs_test_open_and_write_file(pTest, pFS, filename, FS_WRITE | FS_IGNORE_MOUNTS, content, strlen(content));
-        if (result != FS_SUCCESS) {
-            printf("%s: Failed to create stress test file %d.\n", pTest->name, i);
-            return FS_ERROR;
+        if (fs_test_open_and_write_file(pTest, state.pFS, path, FS_WRITE | FS_IGNORE_MOUNTS, data, sizeof(data)) != FS_SUCCESS) {
+            state.errorCount += 1;
         }
     }
 
-    /* Verify all files exist and have correct content. */
-    for (i = 0; i < 50; i += 1) {
-        fs_snprintf(filename, sizeof(filename), "/testdir/stress_%03d.txt", i);
-        fs_snprintf(content, sizeof(content), "File number %d content", i);
-        
-        result = fs_test_open_and_read_file(pTest, pFS, filename, FS_READ | FS_IGNORE_MOUNTS, content, strlen(content));
-        if (result != FS_SUCCESS) {
-            printf("%s: Failed to verify stress test file %d.\n", pTest->name, i);
-            return FS_ERROR;
-        }
+    memset(data, 0, sizeof(data));
+    if (fs_test_open_and_write_file(pTest, state.pFS, "/threaded/shared", FS_WRITE | FS_IGNORE_MOUNTS, data, sizeof(data)) != FS_SUCCESS) {
+        state.errorCount += 1;
     }
 
-    /* Create deep directory structure. */
-    {
-        char deepPath[256] = "/testdir";
-        for (i = 0; i < 10; i += 1) {
-            fs_snprintf(deepPath, sizeof(deepPath), "%s/level%d", deepPath, i);
-            
-            result = fs_mkdir(pFS, deepPath, FS_WRITE | FS_IGNORE_MOUNTS);
-            if (result != FS_SUCCESS) {
-                printf("%s: Failed to create deep directory level %d.\n", pTest->name, i);
-                return FS_ERROR;
+    if (state.errorCount == 0) {
+        if (fs_thrd_create(&threads[threadCount], fs_test_mem_threaded_writer, &state, NULL) == FS_SUCCESS) {
+            threadCount += 1;
+        }
+
+        for (iThread = 0; iThread < FS_TEST_MEM_THREADED_READER_COUNT; iThread += 1) {
+            if (fs_thrd_create(&threads[threadCount], fs_test_mem_threaded_reader, &state, NULL) == FS_SUCCESS) {
+                threadCount += 1;
             }
         }
 
-        /* Create a file in the deepest directory. */
-        fs_strncat_s(deepPath, sizeof(deepPath), "/deep_file.txt", sizeof(deepPath) - strlen(deepPath) - 1);
-        result = fs_test_open_and_write_file(pTest, pFS, deepPath, FS_WRITE | FS_IGNORE_MOUNTS, "deep content", 12);
-        if (result != FS_SUCCESS) {
-            printf("%s: Failed to create file in deep directory.\n", pTest->name);
-            return FS_ERROR;
+        for (iThread = 0; iThread < threadCount; iThread += 1) {
+            fs_thrd_join(threads[iThread], NULL);
         }
 
-        /* Verify the deep file. */
-        result = fs_test_open_and_read_file(pTest, pFS, deepPath, FS_READ | FS_IGNORE_MOUNTS, "deep content", 12);
-        if (result != FS_SUCCESS) {
-            printf("%s: Failed to read file from deep directory.\n", pTest->name);
-            return FS_ERROR;
+        if (threadCount != FS_TEST_MEM_THREADED_READER_COUNT + 1) {
+            printf("%s: Failed to create threads.\n", pTest->name);
+            state.errorCount += 1;
         }
     }
 
-    return FS_SUCCESS;
-}
-/* END mem_stress_test */
-
-/* BEG mem_uninit */
-int fs_test_mem_uninit(fs_test* pTest)
-{
-    fs_test_state* pTestState = (fs_test_state*)pTest->pUserData;
-    fs* pFS = pTestState->pFS;
+    /* Every other temp file was removed. That leaves half of them, the fixed files and the shared file. */
+    for (pIterator = fs_first(state.pFS, "/threaded", FS_IGNORE_MOUNTS); pIterator != NULL; pIterator = fs_next(pIterator)) {
+        fileCount += 1;
+    }
 
-    if (pFS != NULL) {
-        fs_uninit(pFS);
-        pTestState->pFS = NULL;
+    if (state.errorCount == 0 && fileCount != FS_TEST_MEM_THREADED_ITERATIONS/2 + FS_TEST_MEM_THREADED_FILE_COUNT + 1) {
+        printf("%s: Expected %d files after the writer finished, but found %d.\n", pTest->name, FS_TEST_MEM_THREADED_ITERATIONS/2 + FS_TEST_MEM_THREADED_FILE_COUNT + 1, (int)fileCount);
+        state.errorCount += 1;
     }
 
-    return FS_SUCCESS;
+    fs_mtx_destroy(&state.lock);
+    fs_uninit(state.pFS);
+
+    return (state.errorCount == 0) ? FS_SUCCESS : FS_ERROR;
 }
-/* END mem_uninit */
+/* END mem_threaded */
 
 /* Helper function to set up source directory structure for serialization test */
 static fs_result fs_test_serialization_set_up_src(fs_test* pTest, fs* pFS)
@@ -4932,6 +8911,76 @@ static int fs_test_stream_read_to_end_error(fs_test* pTest)
 }
 
 
+typedef struct
+{
+    int mallocCount;
+    int reallocCount;
+} fs_test_allocation_counts;
+
+static void* fs_test_counting_malloc(size_t sz, void* pUserData)
+{
+    ((fs_test_allocation_counts*)pUserData)->mallocCount += 1;
+    return malloc(sz);
+}
+
+static void* fs_test_counting_realloc(void* p, size_t sz, void* pUserData)
+{
+    ((fs_test_allocation_counts*)pUserData)->reallocCount += 1;
+    return realloc(p, sz);
+}
+
+static void fs_test_counting_free(void* p, void* pUserData)
+{
+    (void)pUserData;
+    free(p);
+}
+
+static int fs_test_stream_read_to_end_size_hint(fs_test* pTest)
+{
+    fs_result result;
+    unsigned char pSrcData[10000];
+    fs_uint64 pHints[] = { 0, 10, sizeof(pSrcData), sizeof(pSrcData) * 2 };
+    size_t iHint;
+    size_t i;
+    int errorCount = 0;
+
+    for (i = 0; i < sizeof(pSrcData); i += 1) {
+        pSrcData[i] = (unsigned char)(i * 31);
+    }
+
+    /* Whatever the hint, the data should be the same. Only an exact hint is guaranteed to avoid reallocations. */
+    for (iHint = 0; iHint < FS_COUNTOF(pHints); iHint += 1) {
+        fs_test_allocation_counts counts = { 0, 0 };
+        fs_allocation_callbacks allocationCallbacks;
+        fs_memory_stream stream;
+        void* pData;
+        size_t dataSize;
+
+        allocationCallbacks.pUserData = &counts;
+        allocationCallbacks.onMalloc  = fs_test_counting_malloc;
+        allocationCallbacks.onRealloc = fs_test_counting_realloc;
+        allocationCallbacks.onFree    = fs_test_counting_free;
+
+        fs_memory_stream_init_readonly(pSrcData, sizeof(pSrcData), &stream);
+
+        result = fs_stream_read_to_end_ex(&stream.base, FS_FORMAT_TEXT, pHints[iHint], &allocationCallbacks, &pData, &dataSize);
+        if (result != FS_SUCCESS || dataSize != sizeof(pSrcData) || memcmp(pData, pSrcData, dataSize) != 0 || ((char*)pData)[dataSize] != '\0') {
+            printf("%s: Unexpected data when reading to the end with a size hint of %d.\n", pTest->name, (int)pHints[iHint]);
+            errorCount += 1;
+        }
+
+        if (pHints[iHint] == sizeof(pSrcData) && (counts.mallocCount + counts.reallocCount) != 1) {
+            printf("%s: Expected a single allocation with an exact size hint. Got %d.\n", pTest->name, counts.mallocCount + counts.reallocCount);
+            errorCount += 1;
+        }
+
+        fs_free(pData, &allocationCallbacks);
+    }
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+
+
 static int fs_test_memory_stream_seek(fs_test* pTest)
 {
     fs_result result;
@@ -5085,6 +9134,177 @@ static int fs_test_memory_stream_remove_bounds(fs_test* pTest)
     return FS_SUCCESS;
 }
 
+/* BEG stream_write_open */
+/*
+This tests what a backend is given as its stream when a file is opened for writing on an fs object that
+was initialized with a stream. A copy of a stream that's being written to is never useful so a backend
+should be given a shared read-only view when the stream supports positional reads, and nothing at all
+otherwise. Opening for reading still needs a stream of its own.
+*/
+typedef struct
+{
+    fs_stream base;
+    size_t bytesWritten;
+} fs_test_sink_stream;
+
+static fs_result fs_test_sink_stream_write(fs_stream* pStream, const void* pSrc, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    (void)pSrc;
+    ((fs_test_sink_stream*)pStream)->bytesWritten += bytesToWrite;
+    *pBytesWritten = bytesToWrite;
+    return FS_SUCCESS;
+}
+
+static fs_result fs_test_sink_stream_seek(fs_stream* pStream, fs_int64 offset, fs_seek_origin origin)
+{
+    (void)pStream;
+    (void)offset;
+    (void)origin;
+    return FS_NOT_IMPLEMENTED;
+}
+
+static fs_result fs_test_sink_stream_tell(fs_stream* pStream, fs_int64* pCursor)
+{
+    *pCursor = (fs_int64)((fs_test_sink_stream*)pStream)->bytesWritten;
+    return FS_SUCCESS;
+}
+
+static fs_stream_vtable fs_test_sink_stream_vtable =
+{
+    NULL,   /* read */
+    fs_test_sink_stream_write,
+    fs_test_sink_stream_seek,
+    fs_test_sink_stream_tell,
+    NULL,   /* duplicate_alloc_size */
+    NULL,   /* duplicate */
+    NULL,   /* uninit */
+    NULL,   /* read_at */
+    NULL,   /* write_at */
+    NULL    /* map */
+};
+
+static fs_stream* fs_test_stream_write_open_last_stream;
+
+static fs_result fs_test_stream_write_open_backend_init(fs* pFS, const void* pBackendConfig, fs_stream* pStream)
+{
+    (void)pFS;
+    (void)pBackendConfig;
+    (void)pStream;
+    return FS_SUCCESS;
+}
+
+static fs_result fs_test_stream_write_open_backend_file_open(fs* pFS, fs_stream* pStream, const char* pFilePath, int openMode, fs_file* pFile)
+{
+    (void)pFS;
+    (void)pFilePath;
+    (void)openMode;
+    (void)pFile;
+    fs_test_stream_write_open_last_stream = pStream;
+    return FS_SUCCESS;
+}
+
+static fs_backend fs_test_stream_write_open_backend;
+
+static fs_result fs_test_stream_write_open_internal(fs_test* pTest, fs_stream* pStream, fs_bool32 isShareable, fs_result expectedReadResult)
+{
+    fs_result result;
+    fs_config config;
+    fs* pFS;
+    fs_file* pFile;
+    int errorCount = 0;
+
+    FS_ZERO_OBJECT(&fs_test_stream_write_open_backend);
+    fs_test_stream_write_open_backend.init      = fs_test_stream_write_open_backend_init;
+    fs_test_stream_write_open_backend.file_open = fs_test_stream_write_open_backend_file_open;
+
+    config = fs_config_init(&fs_test_stream_write_open_backend, NULL, pStream);
+
+    result = fs_init(&config, &pFS);
+    if (result != FS_SUCCESS) {
+        printf("%s: Failed to initialize the file system (%d).\n", pTest->name, result);
+        return FS_ERROR;
+    }
+
+    fs_test_stream_write_open_last_stream = pStream;
+
+    result = fs_file_open(pFS, "file", FS_WRITE | FS_IGNORE_MOUNTS, &pFile);
+    if (result == FS_SUCCESS) {
+        if (isShareable) {
+            /* A shared stream is read-only so writing to it must fail without touching the original stream. */
+            if (fs_test_stream_write_open_last_stream == NULL || fs_test_stream_write_open_last_stream == pStream || fs_stream_write(fs_test_stream_write_open_last_stream, "x", 1, NULL) == FS_SUCCESS) {
+                printf("%s: The backend was not given a shared read-only stream when opening for writing.\n", pTest->name);
+                errorCount += 1;
+            }
+        } else {
+            if (fs_test_stream_write_open_last_stream != NULL) {
+                printf("%s: The backend was given a stream when opening for writing when it should not have been.\n", pTest->name);
+                errorCount += 1;
+            }
+        }
+
+        fs_file_close(pFile);
+    } else {
+        printf("%s: Failed to open a file for writing (%d).\n", pTest->name, result);
+        errorCount += 1;
+    }
+
+    result = fs_file_open(pFS, "file", FS_READ | FS_IGNORE_MOUNTS, &pFile);
+    if (result != expectedReadResult) {
+        printf("%s: Opening a file for reading returned %d when %d was expected.\n", pTest->name, result, expectedReadResult);
+        errorCount += 1;
+    }
+
+    if (result == FS_SUCCESS) {
+        if (fs_test_stream_write_open_last_stream == NULL) {
+            printf("%s: The backend was not given a stream when opening for reading.\n", pTest->name);
+            errorCount += 1;
+        }
+
+        fs_file_close(pFile);
+    }
+
+    fs_uninit(pFS);
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+
+static int fs_test_stream_write_open(fs_test* pTest)
+{
+    fs_memory_stream memoryStream;
+    fs_test_sink_stream sinkStream;
+    int errorCount = 0;
+
+    /* A memory stream supports positional reads so it can be shared. */
+    fs_memory_stream_init_readonly("data", 4, &memoryStream);
+
+    if (fs_test_stream_write_open_internal(pTest, &memoryStream.base, FS_TRUE, FS_SUCCESS) != FS_SUCCESS) {
+        errorCount += 1;
+    }
+
+    if (memoryStream.readonly.dataSize != 4) {
+        printf("%s: The original stream was modified.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    fs_memory_stream_uninit(&memoryStream);
+
+    /* A write-only stream can't be shared or duplicated. Opening for writing must still work. */
+    FS_ZERO_OBJECT(&sinkStream);
+    fs_stream_init(&fs_test_sink_stream_vtable, &sinkStream.base);
+
+    if (fs_test_stream_write_open_internal(pTest, &sinkStream.base, FS_FALSE, FS_NOT_IMPLEMENTED) != FS_SUCCESS) {
+        errorCount += 1;
+    }
+
+    if (sinkStream.bytesWritten != 0) {
+        printf("%s: The core library wrote to the file system's stream.\n", pTest->name);
+        errorCount += 1;
+    }
+
+    return (errorCount == 0) ? FS_SUCCESS : FS_ERROR;
+}
+/* END stream_write_open */
+
 
 int main(int argc, char** argv)
 {
@@ -5116,6 +9336,9 @@ int main(int argc, char** argv)
     fs_test test_system_read;                       /* Tests FS_READ. Also acts as the parent test for other reading related tests. */
     fs_test test_system_read_readonly;              /* Tests that writing to a read-only file fails. */
     fs_test test_system_read_noexist;               /* Tests that reading a non-existent file fails cleanly. */
+    fs_test test_system_read_write_at;              /* Tests positional reads and writes with fs_file_read_at() and fs_file_write_at(). */
+    fs_test test_system_map;                        /* Tests mapping a file with fs_file_map(). */
+    fs_test test_system_read_to_end;                /* Tests reading an entire file or stream with and without a size hint. */
     fs_test test_system_duplicate;                  /* Tests fs_file_duplicate(). */
     fs_test test_system_rename;                     /* Tests fs_rename(). Make sure this is done before the remove test. */
     fs_test test_system_symlink_info;
@@ -5128,6 +9351,9 @@ int main(int argc, char** argv)
     fs_test test_mounts_rename;                     /* Tests renaming files with mounts. */
     fs_test test_mounts_remove;                     /* Tests removing files with mounts. */
     fs_test test_mounts_iteration;                  /* Tests iterating directories with mounts. */
+    fs_test test_mounts_iteration_names_only;       /* Tests iterating directories with FS_NAMES_ONLY. */
+    fs_test test_iteration_first_ex;                /* Tests that backends without first_ex can still be iterated, and that first_ex is given the mode. */
+    fs_test test_mounts_iteration_priority;         /* Tests that duplicate entries across mounts are only returned once. */
     fs_test test_mounts_iteration_prefix_bug;
     fs_test test_unmount;                           /* This needs to be the last mount test. */
     fs_test test_archives;                          /* The top-level test for archives. This will set up the `fs` object and the folder and file structure in preparation for subsequent tests. */
@@ -5142,6 +9368,21 @@ int main(int argc, char** argv)
     fs_test test_archives_recursive;                /* Tests archives inside archives. */
     fs_test test_archives_validation;               /* Tests validation of malformed archives. */
     fs_test test_archives_duplicate;                /* Tests duplication of files inside archives. */
+    fs_test test_archives_registry;                 /* Tests lookup of opened archives as they are added and removed. */
+    fs_test test_archives_resolution_cache;         /* Tests caching and invalidation of transparent archive lookups. */
+    fs_test test_archives_shared_stream;            /* Tests that files opened from an archive share its stream with positional reads. */
+    fs_test test_archives_map;                      /* Tests that stored files can be mapped directly from the archive. */
+    fs_test test_archives_index_file;               /* Tests saving and loading of the Zip index file. */
+    fs_test test_archives_path_hash_table;          /* Tests path lookups through the Zip path hash table. */
+    fs_test test_archives_seek_points;              /* Tests seeking within compressed files with seek points. */
+    fs_test test_archives_large_reads;              /* Tests reads that are decompressed straight into the output buffer. */
+    fs_test test_archives_checksums;                /* Tests CRC-32 verification of files in Zip archives. */
+    fs_test test_archives_checksums_seek;           /* Tests CRC-32 verification when seeking forward before reading to the end. */
+    fs_test test_archives_cache_sizes;              /* Tests configurable and adaptive cache sizes of files in Zip archives. */
+    fs_test test_archives_write;                    /* Tests writing a new Zip archive and reading it back. */
+    fs_test test_archives_write_zip64_boundary;     /* Tests that ZIP64 records are written at exactly 65535 entries. */
+    fs_test test_archives_write_compressed;         /* Tests writing compressed files at different levels and thread counts. */
+    fs_test test_archives_inflate_patterns;         /* Tests the decompressor's fast path with data shaped to hit each of its special cases. */
     fs_test test_archives_uninit;                   /* This needs to be the last archive test. */
     fs_test test_mem;                               /* The top-level test for memory backend. This will set up the fs_mem object in preparation for subsequent tests. */
     fs_test test_mem_init;                          /* Initializes the memory backend. */
@@ -5153,6 +9394,8 @@ int main(int argc, char** argv)
     fs_test test_mem_write_exclusive;               /* Tests FS_WRITE | FS_EXCLUSIVE in memory. */
     fs_test test_mem_write_truncate;                /* Tests FS_WRITE | FS_TRUNCATE in memory. */
     fs_test test_mem_write_seek;                    /* Tests seeking while writing in memory. */
+    fs_test test_mem_read_write_at;                 /* Tests emulated positional reads and writes. */
+    fs_test test_mem_map;                           /* Tests mapping directly from the memory backend. The fallback is covered by test_mem_chunked. */
     fs_test test_mem_write_truncate2;               /* Tests fs_file_truncate() in memory. */
     fs_test test_mem_write_flush;                   /* Tests fs_file_flush() in memory. */
     fs_test test_mem_read;                          /* Tests FS_READ in memory. Also acts as the parent test for other reading related tests. */
@@ -5163,14 +9406,22 @@ int main(int argc, char** argv)
     fs_test test_mem_rename;                        /* Tests fs_rename() in memory. Make sure this is done before the remove test. */
     fs_test test_mem_remove;                        /* Tests fs_remove() in memory. This will delete test files. */
     fs_test test_mem_stress_test;                   /* Tests stress scenarios like many files and deep directories in memory. */
+    fs_test test_mem_large_directory;               /* Tests finding, removing and renaming children of a directory with many files in memory. */
+    fs_test test_mem_chunked;                       /* Tests storing files as chunks in memory, including the fs_file_map() fallback. */
+    fs_test test_mem_snapshot;                      /* Tests copy-on-write snapshots of a file system in memory. */
+    fs_test test_mem_rwlock;                        /* Tests fs_rwlock, which the memory backend uses for thread safety, across threads. */
+    fs_test test_mem_threaded;                      /* Tests concurrent readers and a writer on the memory backend. */
     fs_test test_mem_uninit;                        /* Needs to be last since this is where the fs_uninit() function is called for memory backend. */
     fs_test test_memory_stream;
     fs_test test_stream_read_to_end_error;
+    fs_test test_stream_read_to_end_size_hint;
     fs_test test_memory_stream_duplicate;
     fs_test test_memory_stream_seek;
     fs_test test_memory_stream_write_bounds;
     fs_test test_memory_stream_remove_bounds;
+    fs_test test_stream_write_open;
     fs_test test_binary_search;
+    fs_test test_sort;
     fs_test test_serialization;
     fs_test test_serialization_endian;
     fs_test test_serialization_offsets;
@@ -5234,6 +9485,9 @@ int main(int argc, char** argv)
     fs_test_init(&test_system_read,                    "Read",                           fs_test_system_read,                    &test_system_state,   &test_system);
     fs_test_init(&test_system_read_readonly,           "Read Read-Only",                 fs_test_system_read_readonly,           &test_system_state,   &test_system_read);
     fs_test_init(&test_system_read_noexist,            "Read Non-Existent",              fs_test_system_read_noexist,            &test_system_state,   &test_system_read);
+    fs_test_init(&test_system_read_write_at,           "Read/Write At",                  fs_test_system_read_write_at,           &test_system_state,   &test_system_read);
+    fs_test_init(&test_system_map,                     "Map",                            fs_test_system_map,                     &test_system_state,   &test_system_read);
+    fs_test_init(&test_system_read_to_end,             "Read To End",                    fs_test_system_read_to_end,             &test_system_state,   &test_system_read);
     fs_test_init(&test_system_duplicate,               "Duplicate",                      fs_test_system_duplicate,               &test_system_state,   &test_system);
     fs_test_init(&test_system_rename,                  "Rename",                         fs_test_system_rename,                  &test_system_state,   &test_system);
     fs_test_init(&test_system_symlink_info,            "Symbolic Link Info",             fs_test_system_symlink_info,            &test_system_state,   &test_system);
@@ -5250,6 +9504,9 @@ int main(int argc, char** argv)
     fs_test_init(&test_mounts_rename,                  "Mounts Rename",                  fs_test_mounts_rename,                  &test_mounts_state,   &test_mounts);
     fs_test_init(&test_mounts_remove,                  "Mounts Remove",                  fs_test_mounts_remove,                  &test_mounts_state,   &test_mounts);
     fs_test_init(&test_mounts_iteration,               "Mounts Iteration",               fs_test_mounts_iteration,               &test_mounts_state,   &test_mounts);
+    fs_test_init(&test_mounts_iteration_names_only,    "Mounts Iteration Names Only",    fs_test_mounts_iteration_names_only,    &test_mounts_state,   &test_mounts);
+    fs_test_init(&test_iteration_first_ex,             "Iteration First Ex",             fs_test_iteration_first_ex,             NULL,                 &test_mounts);
+    fs_test_init(&test_mounts_iteration_priority,      "Mounts Iteration Priority",      fs_test_mounts_iteration_priority,      &test_mounts_state,   &test_mounts);
     fs_test_init(&test_mounts_iteration_prefix_bug,    "Mounts Iteration Prefix Bug",    fs_test_mounts_iteration_prefix_bug,    &test_mounts_state,   &test_mounts);
     fs_test_init(&test_unmount,                        "Unmount",                        fs_test_unmount,                        &test_mounts_state,   &test_mounts);
 
@@ -5268,6 +9525,21 @@ int main(int argc, char** argv)
     fs_test_init(&test_archives_recursive,             "Archives Recursive",             fs_test_archives_recursive,             &test_archives_state, &test_archives);
     fs_test_init(&test_archives_validation,            "Archives Validation",            fs_test_archives_validation,            &test_archives_state, &test_archives);
     fs_test_init(&test_archives_duplicate,             "Archives Duplicate",             fs_test_archives_duplicate,             &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_registry,              "Archives Registry",              fs_test_archives_registry,              &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_resolution_cache,      "Archives Resolution Cache",      fs_test_archives_resolution_cache,      &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_shared_stream,         "Archives Shared Stream",         fs_test_archives_shared_stream,         &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_map,                   "Archives Map",                   fs_test_archives_map,                   &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_index_file,            "Archives Index File",            fs_test_archives_index_file,            &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_path_hash_table,       "Archives Path Hash Table",       fs_test_archives_path_hash_table,       &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_seek_points,           "Archives Seek Points",           fs_test_archives_seek_points,           &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_large_reads,           "Archives Large Reads",           fs_test_archives_large_reads,           &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_checksums,             "Archives Checksums",             fs_test_archives_checksums,             &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_checksums_seek,        "Archives Checksums Seek",        fs_test_archives_checksums_seek,        &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_cache_sizes,           "Archives Cache Sizes",           fs_test_archives_cache_sizes,           &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_write,                 "Archives Write",                 fs_test_archives_write,                 &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_write_zip64_boundary,  "Archives Write ZIP64 Boundary",  fs_test_archives_write_zip64_boundary,  &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_write_compressed,      "Archives Write Compressed",      fs_test_archives_write_compressed,      &test_archives_state, &test_archives);
+    fs_test_init(&test_archives_inflate_patterns,      "Archives Inflate Patterns",      fs_test_archives_inflate_patterns,      &test_archives_state, &test_archives);
     fs_test_init(&test_archives_uninit,                "Archives Uninitialization",      fs_test_archives_uninit,                &test_archives_state, &test_archives);
 
     /*
@@ -5285,6 +9557,8 @@ int main(int argc, char** argv)
     fs_test_init(&test_mem_write_exclusive,            "Memory Write Exclusive",         fs_test_mem_write_exclusive,            &test_mem_state,       &test_mem_write);
     fs_test_init(&test_mem_write_truncate,             "Memory Write Truncate",          fs_test_mem_write_truncate,             &test_mem_state,       &test_mem_write);
     fs_test_init(&test_mem_write_seek,                 "Memory Write Seek",              fs_test_mem_write_seek,                 &test_mem_state,       &test_mem_write);
+    fs_test_init(&test_mem_read_write_at,              "Memory Read/Write At",           fs_test_mem_read_write_at,              &test_mem_state,       &test_mem_write);
+    fs_test_init(&test_mem_map,                        "Memory Map",                     fs_test_mem_map,                        &test_mem_state,       &test_mem_write);
     fs_test_init(&test_mem_write_truncate2,            "Memory fs_file_truncate()",      fs_test_mem_write_truncate2,            &test_mem_state,       &test_mem_write);
     fs_test_init(&test_mem_write_flush,                "Memory Write Flush",             fs_test_mem_write_flush,                &test_mem_state,       &test_mem_write);
     fs_test_init(&test_mem_read,                       "Memory Read",                    fs_test_mem_read,                       &test_mem_state,       &test_mem);
@@ -5295,16 +9569,24 @@ int main(int argc, char** argv)
     fs_test_init(&test_mem_rename,                     "Memory Rename",                  fs_test_mem_rename,                     &test_mem_state,       &test_mem);
     fs_test_init(&test_mem_remove,                     "Memory Remove",                  fs_test_mem_remove,                     &test_mem_state,       &test_mem);
     fs_test_init(&test_mem_stress_test,                "Memory Stress Test",             fs_test_mem_stress_test,                &test_mem_state,       &test_mem);
+    fs_test_init(&test_mem_large_directory,            "Memory Large Directory",         fs_test_mem_large_directory,            &test_mem_state,       &test_mem);
+    fs_test_init(&test_mem_chunked,                    "Memory Chunked",                 fs_test_mem_chunked,                    &test_mem_state,       &test_mem);
+    fs_test_init(&test_mem_snapshot,                   "Memory Snapshot",                fs_test_mem_snapshot,                   &test_mem_state,       &test_mem);
+    fs_test_init(&test_mem_rwlock,                     "Memory Reader-Writer Lock",      fs_test_mem_rwlock,                     NULL,                  &test_mem);
+    fs_test_init(&test_mem_threaded,                   "Memory Threaded",                fs_test_mem_threaded,                   NULL,                  &test_mem);
     fs_test_init(&test_mem_uninit,                     "Memory Uninitialization",        fs_test_mem_uninit,                     &test_mem_state,       &test_mem);
 
     fs_test_init(&test_memory_stream,                  "Memory Stream",                  NULL,                                   NULL,                  &test_root);
     fs_test_init(&test_stream_read_to_end_error,       "Stream Read To End Error",       fs_test_stream_read_to_end_error,       NULL,                  &test_memory_stream);
+    fs_test_init(&test_stream_read_to_end_size_hint,   "Stream Read To End Size Hint",   fs_test_stream_read_to_end_size_hint,   NULL,                  &test_memory_stream);
     fs_test_init(&test_memory_stream_duplicate,        "Memory Stream Duplicate",        fs_test_memory_stream_duplicate,        NULL,                  &test_memory_stream);
     fs_test_init(&test_memory_stream_seek,             "Memory Stream Seek",             fs_test_memory_stream_seek,             NULL,                  &test_memory_stream);
     fs_test_init(&test_memory_stream_write_bounds,     "Memory Stream Write Bounds",     fs_test_memory_stream_write_bounds,     NULL,                  &test_memory_stream);
     fs_test_init(&test_memory_stream_remove_bounds,    "Memory Stream Remove Bounds",    fs_test_memory_stream_remove_bounds,    NULL,                  &test_memory_stream);
+    fs_test_init(&test_stream_write_open,              "Stream Write Open",              fs_test_stream_write_open,              NULL,                  &test_memory_stream);
 
     fs_test_init(&test_binary_search,                  "Binary Search",                  fs_test_binary_search,                  NULL,                  &test_root);
+    fs_test_init(&test_sort,                           "Sort",                           fs_test_sort,                           NULL,                  &test_root);
 
     /*
     Serialization Tests.